@@ -1,6 +1,16 @@
 #include "AnimCompress.h"
 #include "AnimationCompression.h"
 #include "AnimEncoding.h"
+#include "log.h"
+#include <fstream>
+#include <atomic>
+#include <mutex>
+
+bool GAnimCompressionReport = false;
+std::string GAnimCompressionReportFilename = "AnimCompressionReport.csv";
+
+/** Sequences compressed with the report enabled so far in this run, numbering the report rows */
+static std::atomic<int32> GNumReportedSequences(0);
 
 // Writes the specified data to Seq->CompresedByteStream with four-byte alignment.
 #define AC_UnalignedWriteToStream( Src, Len )										\
@@ -96,29 +106,156 @@ FCompressionMemorySummary::FCompressionMemorySummary(bool bInEnabled)
 
 }
 
-void FCompressionMemorySummary::GatherPreCompressionStats(UAnimSequence* Seq, int32 ProgressNumerator, int32 ProgressDenominator)
+void FCompressionMemorySummary::GatherPreCompressionStats(UAnimSequence* Seq, int32 CompressedSizeBefore, int32 ProgressNumerator, int32 ProgressDenominator)
 {
+	if (bEnabled)
+	{
+		bUsed = true;
+		TotalRaw += Seq->GetApproxRawSize();
+		TotalBeforeCompressed += CompressedSizeBefore;
+
+		FSequenceCompressionReport Report;
+		Report.SequenceIndex = GNumReportedSequences++;
+		Report.SequenceName = Seq->SequenceName;
+		Report.NumFrames = Seq->NumFrames;
+		Report.NumTracks = Seq->GetRawAnimationData().size();
+		Report.RawSize = Seq->GetApproxRawSize();
+		Report.CompressedSizeBefore = CompressedSizeBefore;
+		Report.CompressedSizeDefault = CompressedSizeBefore;
+		Report.CompressedSizeAfter = CompressedSizeBefore;
+		SequenceReports.push_back(Report);
+	}
+}
 
+void FCompressionMemorySummary::GatherDefaultCompressionStats(UAnimSequence* Seq)
+{
+	if (bEnabled && SequenceReports.size() > 0)
+	{
+		SequenceReports.back().CompressedSizeDefault = Seq->GetApproxCompressedSize();
+	}
 }
 
 void FCompressionMemorySummary::GatherPostCompressionStats(UAnimSequence* Seq, std::vector<FBoneData>& BoneData)
 {
+	if (bEnabled)
+	{
+		TotalAfterCompressed += Seq->GetApproxCompressedSize();
+
+		// the matching row was opened by GatherPreCompressionStats
+		FSequenceCompressionReport* Report = SequenceReports.size() > 0 ? &SequenceReports.back() : nullptr;
+		if (Report)
+		{
+			Report->CompressedSizeAfter = Seq->GetApproxCompressedSize();
+		}
 
+		if (Seq->NumFrames > 1)
+		{
+			// determine the error added by the compression
+			AnimationErrorStats ErrorStats;
+			FAnimationUtils::ComputeCompressionError(Seq, BoneData, ErrorStats);
+
+			if (Report)
+			{
+				Report->ErrorStats = ErrorStats;
+				Report->MaxErrorBoneName = IsValidIndex(BoneData, ErrorStats.MaxErrorBone) ? BoneData[ErrorStats.MaxErrorBone].Name : std::string();
+			}
+
+			ErrorTotal += ErrorStats.AverageError;
+			ErrorCount += 1.0f;
+			AverageError = ErrorTotal / ErrorCount;
+
+			if (ErrorStats.MaxError > MaxError)
+			{
+				MaxError = ErrorStats.MaxError;
+				MaxErrorTime = ErrorStats.MaxErrorTime;
+				MaxErrorBone = ErrorStats.MaxErrorBone;
+				MaxErrorBoneName = IsValidIndex(BoneData, ErrorStats.MaxErrorBone) ? BoneData[ErrorStats.MaxErrorBone].Name : std::string();
+			}
+		}
+	}
 }
 
 FCompressionMemorySummary::~FCompressionMemorySummary()
 {
+	if (bEnabled && bUsed)
+	{
+		const int32 TotalBeforeSaving = TotalRaw - TotalBeforeCompressed;
+		const int32 TotalAfterSaving = TotalRaw - TotalAfterCompressed;
+		const float OldCompressionRatio = (TotalBeforeCompressed > 0.f) ? (static_cast<float>(TotalRaw) / TotalBeforeCompressed) : 0.f;
+		const float NewCompressionRatio = (TotalAfterCompressed > 0.f) ? (static_cast<float>(TotalRaw) / TotalAfterCompressed) : 0.f;
+
+		X_LOG("Compression Summary:\n");
+		X_LOG("  Raw: %d KB\n", TotalRaw / 1024);
+		X_LOG("  Before: %d KB, saved %d KB, ratio %.2f\n", TotalBeforeCompressed / 1024, TotalBeforeSaving / 1024, OldCompressionRatio);
+		X_LOG("  After: %d KB, saved %d KB, ratio %.2f\n", TotalAfterCompressed / 1024, TotalAfterSaving / 1024, NewCompressionRatio);
+		X_LOG("  Average error: %f\n", AverageError);
+		X_LOG("  Max error: %f at %f s on bone %d (%s)\n", MaxError, MaxErrorTime, MaxErrorBone, MaxErrorBoneName.c_str());
+
+		for (const FSequenceCompressionReport& Report : SequenceReports)
+		{
+			X_LOG("  Sequence %d %s: %d frames, %d tracks, raw %d B, compressed %d -> default %d -> %d B, error avg %f max %f at %f s (%s)\n",
+				Report.SequenceIndex, Report.SequenceName.c_str(), Report.NumFrames, Report.NumTracks, Report.RawSize, Report.CompressedSizeBefore, Report.CompressedSizeDefault, Report.CompressedSizeAfter,
+				Report.ErrorStats.AverageError, Report.ErrorStats.MaxError, Report.ErrorStats.MaxErrorTime, Report.MaxErrorBoneName.c_str());
+		}
+	}
+}
+
+bool FCompressionMemorySummary::WriteReport(const std::string& Filename, bool bAppend) const
+{
+	std::ofstream Out(Filename, std::ios::out | (bAppend ? std::ios::app : std::ios::trunc));
+	if (!Out.is_open())
+	{
+		X_LOG("Failed to write the compression report %s\n", Filename.c_str());
+		return false;
+	}
+
+	if (!bAppend)
+	{
+		Out << "Index,Sequence,NumFrames,NumTracks,RawBytes,CompressedBytesBefore,CompressedBytesDefault,CompressedBytesAfter,AverageError,MaxError,MaxErrorTime,MaxErrorBone\n";
+	}
+	for (const FSequenceCompressionReport& Report : SequenceReports)
+	{
+		Out << Report.SequenceIndex << ','
+			<< Report.SequenceName << ','
+			<< Report.NumFrames << ','
+			<< Report.NumTracks << ','
+			<< Report.RawSize << ','
+			<< Report.CompressedSizeBefore << ','
+			<< Report.CompressedSizeDefault << ','
+			<< Report.CompressedSizeAfter << ','
+			<< Report.ErrorStats.AverageError << ','
+			<< Report.ErrorStats.MaxError << ','
+			<< Report.ErrorStats.MaxErrorTime << ','
+			<< Report.MaxErrorBoneName << '\n';
+	}
+	return true;
+}
+
+bool FCompressionMemorySummary::AppendToReport(const std::string& Filename) const
+{
+	static std::mutex ReportMutex;
+	static bool bStarted = false;
 
+	std::lock_guard<std::mutex> Lock(ReportMutex);
+	const bool bResult = WriteReport(Filename, bStarted);
+	bStarted = bStarted || bResult;
+	return bResult;
 }
 
 void FAnimCompressContext::GatherPreCompressionStats(UAnimSequence* Seq)
 {
+	const int32 SizeBefore = CompressedSizeBefore != INDEX_NONE ? CompressedSizeBefore : Seq->GetApproxCompressedSize();
+	CompressionSummary.GatherPreCompressionStats(Seq, SizeBefore, AnimIndex, MaxAnimations);
+}
 
+void FAnimCompressContext::GatherDefaultCompressionStats(UAnimSequence* Seq)
+{
+	CompressionSummary.GatherDefaultCompressionStats(Seq);
 }
 
 void FAnimCompressContext::GatherPostCompressionStats(UAnimSequence* Seq, std::vector<FBoneData>& BoneData)
 {
-
+	CompressionSummary.GatherPostCompressionStats(Seq, BoneData);
 }
 
 bool UAnimCompress::Reduce(class UAnimSequence* AnimSeq, bool bOutput)
@@ -2,17 +2,53 @@
 
 #include "AnimationUtils.h"
 
+/** When set, every sequence compressed after import or a raw data change is logged and added to the compression report */
+extern bool GAnimCompressionReport;
+
+/** Csv file the compression report is written to, started over by the first sequence compressed in a run */
+extern std::string GAnimCompressionReportFilename;
+
+/** One row of the per-sequence compression report. */
+struct FSequenceCompressionReport
+{
+	/** Order in which the sequence went through the compressor in this run. */
+	int32 SequenceIndex;
+	std::string SequenceName;
+	int32 NumFrames;
+	int32 NumTracks;
+	int32 RawSize;
+	/** Compressed data the sequence had before this compression, 0 the first time it is compressed */
+	int32 CompressedSizeBefore;
+	/** Size with the default bitwise compressor alone, before key removal */
+	int32 CompressedSizeDefault;
+	int32 CompressedSizeAfter;
+	AnimationErrorStats ErrorStats;
+	std::string MaxErrorBoneName;
+};
+
 class FCompressionMemorySummary
 {
 public:
 	FCompressionMemorySummary(bool bInEnabled);
 
-	void GatherPreCompressionStats(UAnimSequence* Seq, int32 ProgressNumerator, int32 ProgressDenominator);
+	/** Opens the report row of Seq, CompressedSizeBefore being the size of the data it had before its stream was reset */
+	void GatherPreCompressionStats(UAnimSequence* Seq, int32 CompressedSizeBefore, int32 ProgressNumerator, int32 ProgressDenominator);
+
+	/** Records the size Seq has with the default compressor, before alternate compressors try to beat it */
+	void GatherDefaultCompressionStats(UAnimSequence* Seq);
 
 	void GatherPostCompressionStats(UAnimSequence* Seq, std::vector<FBoneData>& BoneData);
 
 	~FCompressionMemorySummary();
 
+	/** Writes one csv line per compressed sequence (sizes in bytes, errors in world units). Meant to be diffed between builds. */
+	bool WriteReport(const std::string& Filename, bool bAppend = false) const;
+
+	/** Adds the rows of this summary to Filename, which is started over with a header the first time in a run */
+	bool AppendToReport(const std::string& Filename) const;
+
+	const std::vector<FSequenceCompressionReport>& GetSequenceReports() const { return SequenceReports; }
+
 private:
 	bool bEnabled;
 	bool bUsed;
@@ -28,6 +64,8 @@ private:
 	int32 MaxErrorBone;
 	std::string MaxErrorBoneName;
 	std::string MaxErrorAnimName;
+
+	std::vector<FSequenceCompressionReport> SequenceReports;
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -40,11 +78,15 @@ struct FAnimCompressContext
 	uint32						MaxAnimations;
 	bool						bAllowAlternateCompressor;
 	bool						bOutput;
+	/** Size of the compressed data the sequence had before its stream was reset for this compression, INDEX_NONE to read it from the sequence */
+	int32						CompressedSizeBefore;
 
-	FAnimCompressContext(bool bInAllowAlternateCompressor, bool bInOutput, uint32 InMaxAnimations = 1) : CompressionSummary(bInOutput), AnimIndex(0), MaxAnimations(InMaxAnimations), bAllowAlternateCompressor(bInAllowAlternateCompressor), bOutput(bInOutput) {}
+	FAnimCompressContext(bool bInAllowAlternateCompressor, bool bInOutput, uint32 InMaxAnimations = 1) : CompressionSummary(bInOutput), AnimIndex(0), MaxAnimations(InMaxAnimations), bAllowAlternateCompressor(bInAllowAlternateCompressor), bOutput(bInOutput), CompressedSizeBefore(INDEX_NONE) {}
 
 	void GatherPreCompressionStats(UAnimSequence* Seq);
 
+	void GatherDefaultCompressionStats(UAnimSequence* Seq);
+
 	void GatherPostCompressionStats(UAnimSequence* Seq, std::vector<FBoneData>& BoneData);
 };
 
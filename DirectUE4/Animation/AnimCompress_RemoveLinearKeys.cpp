@@ -0,0 +1,468 @@
+#include "AnimCompress_RemoveLinearKeys.h"
+#include "AnimationCompression.h"
+#include "AnimEncoding.h"
+#include "AnimationUtils.h"
+#include "Skeleton.h"
+
+#include <algorithm>
+
+/**
+* Everything the key filters need to measure the error a candidate key introduces at the end effectors of one bone.
+* World tables are laid out as [BoneIndex * NumFrames + FrameIndex].
+*/
+struct FEffectorErrorContext
+{
+	int32 NumFrames;
+	int32 BoneIndex;
+	int32 ParentBoneIndex;
+	const std::vector<FBoneData>& BoneData;
+	const std::vector<FTransform>& RawWorldBones;
+	const std::vector<FTransform>& NewWorldBones;
+	/** Current (partially reduced) local transform of the bone at every frame */
+	const std::vector<FTransform>& LocalAtoms;
+	float MaxEffectorDiff;
+	float EffectorDiffSocket;
+
+	FEffectorErrorContext(
+		int32 InNumFrames,
+		int32 InBoneIndex,
+		const std::vector<FBoneData>& InBoneData,
+		const std::vector<FTransform>& InRawWorldBones,
+		const std::vector<FTransform>& InNewWorldBones,
+		const std::vector<FTransform>& InLocalAtoms,
+		float InMaxEffectorDiff,
+		float InEffectorDiffSocket)
+		: NumFrames(InNumFrames)
+		, BoneIndex(InBoneIndex)
+		, ParentBoneIndex(InBoneData[InBoneIndex].GetParent())
+		, BoneData(InBoneData)
+		, RawWorldBones(InRawWorldBones)
+		, NewWorldBones(InNewWorldBones)
+		, LocalAtoms(InLocalAtoms)
+		, MaxEffectorDiff(InMaxEffectorDiff)
+		, EffectorDiffSocket(InEffectorDiffSocket)
+	{}
+
+	/** @return true if using LocalAtom for this bone at FrameIndex keeps every end effector below it within tolerance */
+	bool IsWithinEffectorTolerance(const FTransform& LocalAtom, int32 FrameIndex, float ErrorScale) const
+	{
+		const FTransform NewBoneWorld = (ParentBoneIndex != INDEX_NONE) ? LocalAtom * NewWorldBones[ParentBoneIndex * NumFrames + FrameIndex] : LocalAtom;
+		const FTransform& RawBoneWorld = RawWorldBones[BoneIndex * NumFrames + FrameIndex];
+
+		const std::vector<int32>& EndEffectors = BoneData[BoneIndex].EndEffectors;
+		for (uint32 EffectorIndex = 0; EffectorIndex < EndEffectors.size(); ++EffectorIndex)
+		{
+			const int32 EffectorBoneIndex = EndEffectors[EffectorIndex];
+			const FBoneData& Effector = BoneData[EffectorBoneIndex];
+			const bool bUseSocketTolerance = Effector.bHasSocket || Effector.bKeyEndEffector;
+			const FVector DummyBone(bUseSocketTolerance ? END_EFFECTOR_DUMMY_BONE_LENGTH_SOCKET : END_EFFECTOR_DUMMY_BONE_LENGTH);
+			const float Tolerance = bUseSocketTolerance ? EffectorDiffSocket : MaxEffectorDiff;
+
+			// the dummy bone tip in raw world space, carried through this bone's new world transform
+			const FVector RawEffector = RawWorldBones[EffectorBoneIndex * NumFrames + FrameIndex].TransformPosition(DummyBone);
+			const FVector NewEffector = NewBoneWorld.TransformPosition(RawBoneWorld.InverseTransformPosition(RawEffector));
+
+			if ((NewEffector - RawEffector).Size() * ErrorScale > Tolerance)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+};
+
+static inline FVector InterpolateKey(const FVector& A, const FVector& B, float Alpha)
+{
+	return FMath::Lerp(A, B, Alpha);
+}
+
+static inline FQuat InterpolateKey(const FQuat& A, const FQuat& B, float Alpha)
+{
+	// same blend as the runtime codecs
+	FQuat BlendedQuat = FQuat::FastLerp(A, B, Alpha);
+	BlendedQuat.Normalize();
+	return BlendedQuat;
+}
+
+static inline float KeyError(const FVector& A, const FVector& B)
+{
+	return (A - B).Size();
+}
+
+static inline float KeyError(const FQuat& A, const FQuat& B)
+{
+	return FQuat::ErrorAutoNormalize(A, B);
+}
+
+static void ApplyRotationKey(FTransform& Atom, const FQuat& Key) { Atom.SetRotation(Key); }
+static void ApplyTranslationKey(FTransform& Atom, const FVector& Key) { Atom.SetTranslation(Key); }
+static void ApplyScaleKey(FTransform& Atom, const FVector& Key) { Atom.SetScale3D(Key); }
+
+template <typename T>
+static T SampleTrack(const std::vector<T>& Keys, const std::vector<float>& Times, float Time)
+{
+	if (Keys.size() == 1 || Time <= Times[0])
+	{
+		return Keys[0];
+	}
+	if (Time >= Times.back())
+	{
+		return Keys.back();
+	}
+	const int32 HighKey = std::upper_bound(Times.begin(), Times.end(), Time) - Times.begin();
+	const int32 LowKey = HighKey - 1;
+	const float Alpha = (Time - Times[LowKey]) / (Times[HighKey] - Times[LowKey]);
+	return InterpolateKey(Keys[LowKey], Keys[HighKey], Alpha);
+}
+
+static bool HasKeyAtTime(const std::vector<float>* Times, float Time)
+{
+	if (Times == nullptr)
+	{
+		return false;
+	}
+	std::vector<float>::const_iterator It = std::lower_bound(Times->begin(), Times->end(), Time - KINDA_SMALL_NUMBER);
+	return It != Times->end() && FMath::Abs(*It - Time) <= KINDA_SMALL_NUMBER;
+}
+
+static FTransform GetRawLocalTransform(const FRawAnimSequenceTrack& RawTrack, const FTransform& RefPose, int32 FrameIndex)
+{
+	FTransform Result = RefPose;
+	if (RawTrack.PosKeys.size() > 0)
+	{
+		Result.SetTranslation(RawTrack.PosKeys[FMath::Min<int32>(FrameIndex, RawTrack.PosKeys.size() - 1)]);
+	}
+	if (RawTrack.RotKeys.size() > 0)
+	{
+		Result.SetRotation(RawTrack.RotKeys[FMath::Min<int32>(FrameIndex, RawTrack.RotKeys.size() - 1)]);
+	}
+	if (RawTrack.ScaleKeys.size() > 0)
+	{
+		Result.SetScale3D(RawTrack.ScaleKeys[FMath::Min<int32>(FrameIndex, RawTrack.ScaleKeys.size() - 1)]);
+	}
+	return Result;
+}
+
+/**
+* Checks whether the keys between LowKey and HighKey can be rebuilt by interpolating the two,
+* both locally (MaxDelta) and at every end effector of the bone.
+*/
+template <typename T>
+static bool CanSpanKeys(
+	const std::vector<T>& Keys,
+	const std::vector<float>& Times,
+	int32 LowKey,
+	int32 HighKey,
+	void(*ApplyKey)(FTransform&, const T&),
+	const FEffectorErrorContext& Context,
+	const std::vector<float>* ParentTimes,
+	float ParentScale,
+	float MaxDelta)
+{
+	const float Range = Times[HighKey] - Times[LowKey];
+	for (int32 TestKey = LowKey + 1; TestKey < HighKey; ++TestKey)
+	{
+		const float Alpha = (Times[TestKey] - Times[LowKey]) / Range;
+		const T Interpolated = InterpolateKey(Keys[LowKey], Keys[HighKey], Alpha);
+
+		if (KeyError(Interpolated, Keys[TestKey]) > MaxDelta)
+		{
+			return false;
+		}
+
+		// keys on frames where the parent kept a key are held to a tighter tolerance
+		const float ErrorScale = HasKeyAtTime(ParentTimes, Times[TestKey]) ? ParentScale : 1.0f;
+
+		FTransform Atom = Context.LocalAtoms[TestKey];
+		ApplyKey(Atom, Interpolated);
+		if (!Context.IsWithinEffectorTolerance(Atom, TestKey, ErrorScale))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+template <typename T>
+static void FilterLinearKeysTemplate(
+	std::vector<T>& Keys,
+	std::vector<float>& Times,
+	void(*ApplyKey)(FTransform&, const T&),
+	const FEffectorErrorContext& Context,
+	const std::vector<float>* ParentTimes,
+	float ParentScale,
+	float MaxDelta)
+{
+	const int32 KeyCount = Keys.size();
+	assert(Keys.size() == Times.size());
+
+	// only full rate tracks map key indices straight onto frames, and two keys are already minimal
+	if (KeyCount < 3 || KeyCount != Context.NumFrames)
+	{
+		return;
+	}
+
+	std::vector<T> NewKeys;
+	std::vector<float> NewTimes;
+	NewKeys.reserve(KeyCount);
+	NewTimes.reserve(KeyCount);
+
+	// the first key is a given
+	NewKeys.push_back(Keys[0]);
+	NewTimes.push_back(Times[0]);
+
+	int32 LowKey = 0;
+	while (LowKey < KeyCount - 1)
+	{
+		// extend the span for as long as every key it skips can be rebuilt by interpolation
+		int32 HighKey = LowKey + 1;
+		while (HighKey + 1 < KeyCount && CanSpanKeys(Keys, Times, LowKey, HighKey + 1, ApplyKey, Context, ParentTimes, ParentScale, MaxDelta))
+		{
+			++HighKey;
+		}
+
+		NewKeys.push_back(Keys[HighKey]);
+		NewTimes.push_back(Times[HighKey]);
+		LowKey = HighKey;
+	}
+
+	Keys.swap(NewKeys);
+	Times.swap(NewTimes);
+}
+
+UAnimCompress_RemoveLinearKeys::UAnimCompress_RemoveLinearKeys()
+{
+	bNeedsSkeleton = true;
+	TranslationCompressionFormat = ACF_None;
+	RotationCompressionFormat = ACF_Float96NoW;
+	ScaleCompressionFormat = ACF_None;
+	MaxPosDiff = 0.1f;
+	MaxAngleDiff = 0.025f;
+	MaxScaleDiff = 0.00001f;
+	MaxEffectorDiff = 0.1f;
+	EffectorDiffSocket = 0.05f;
+	ParentKeyScale = 2.0f;
+	bRetarget = true;
+	bActuallyFilterLinearKeys = true;
+}
+
+void UAnimCompress_RemoveLinearKeys::DoReduction(class UAnimSequence* AnimSeq, const std::vector<class FBoneData>& BoneData)
+{
+	std::vector<FTranslationTrack> TranslationData;
+	std::vector<FRotationTrack> RotationData;
+	std::vector<FScaleTrack> ScaleData;
+	SeparateRawDataIntoTracks(AnimSeq->GetRawAnimationData(), AnimSeq->SequenceLength, TranslationData, RotationData, ScaleData);
+
+	// Remove Translation Keys from tracks marked bAnimRotationOnly
+	FilterAnimRotationOnlyKeys(TranslationData, AnimSeq);
+
+	// remove obviously redundant keys from the source data
+	FilterTrivialKeys(TranslationData, RotationData, ScaleData, TRANSLATION_ZEROING_THRESHOLD, QUATERNION_ZEROING_THRESHOLD, SCALE_ZEROING_THRESHOLD);
+
+	// now remove the keys which can be approximated with linear interpolation
+	if (bRetarget || bActuallyFilterLinearKeys)
+	{
+		ProcessAnimationTracks(AnimSeq, BoneData, TranslationData, RotationData, ScaleData);
+	}
+
+	// compress the final (possibly key-reduced) tracks into the anim sequence buffers
+	CompressUsingUnderlyingCompressor(AnimSeq, TranslationData, RotationData, ScaleData);
+}
+
+void UAnimCompress_RemoveLinearKeys::ProcessAnimationTracks(
+	class UAnimSequence* AnimSeq,
+	const std::vector<class FBoneData>& BoneData,
+	std::vector<FTranslationTrack>& PositionTracks,
+	std::vector<FRotationTrack>& RotationTracks,
+	std::vector<FScaleTrack>& ScaleTracks)
+{
+	const int32 NumBones = BoneData.size();
+	const int32 NumFrames = AnimSeq->NumFrames;
+	if (NumBones == 0 || NumFrames < 3 || AnimSeq->SequenceLength <= 0.f)
+	{
+		return;
+	}
+
+	const std::vector<FTransform>& RefPose = AnimSeq->GetSkeleton()->GetRefLocalPoses();
+	const std::vector<FRawAnimSequenceTrack>& RawAnimData = AnimSeq->GetRawAnimationData();
+	const std::vector<FTrackToSkeletonMap>& TrackToSkeletonMap = AnimSeq->GetRawTrackToSkeletonMapTable();
+	const bool bHasScale = ScaleTracks.size() > 0;
+	const float TimePerFrame = AnimSeq->SequenceLength / (float)(NumFrames - 1);
+
+	// make sure the parent key scale is properly bound to 1.0 or more
+	const float ParentScale = FMath::Max(ParentKeyScale, 1.0f);
+
+	std::vector<int32> BoneToTrack(NumBones, INDEX_NONE);
+	for (uint32 TrackIndex = 0; TrackIndex < TrackToSkeletonMap.size(); ++TrackIndex)
+	{
+		const int32 SkeletonBoneIndex = TrackToSkeletonMap[TrackIndex].BoneTreeIndex;
+		if (SkeletonBoneIndex >= 0 && SkeletonBoneIndex < NumBones)
+		{
+			BoneToTrack[SkeletonBoneIndex] = TrackIndex;
+		}
+	}
+
+	// world-space skeleton of the raw data and of the data as it is being reduced, [BoneIndex * NumFrames + FrameIndex]
+	std::vector<FTransform> RawWorldBones(NumBones * NumFrames);
+	std::vector<FTransform> NewWorldBones(NumBones * NumFrames);
+
+	for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+	{
+		const int32 TrackIndex = BoneToTrack[BoneIndex];
+		const int32 ParentBoneIndex = BoneData[BoneIndex].GetParent();
+		for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex)
+		{
+			const FTransform LocalAtom = (TrackIndex != INDEX_NONE) ? GetRawLocalTransform(RawAnimData[TrackIndex], RefPose[BoneIndex], FrameIndex) : RefPose[BoneIndex];
+			RawWorldBones[BoneIndex * NumFrames + FrameIndex] = (ParentBoneIndex != INDEX_NONE) ? LocalAtom * RawWorldBones[ParentBoneIndex * NumFrames + FrameIndex] : LocalAtom;
+		}
+	}
+
+	std::vector<FTransform> LocalAtoms(NumFrames);
+
+	// parents are always processed before their children, so NewWorldBones of the parent is final when a bone is reduced
+	for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+	{
+		const int32 TrackIndex = BoneToTrack[BoneIndex];
+		const int32 ParentBoneIndex = BoneData[BoneIndex].GetParent();
+
+		if (TrackIndex == INDEX_NONE)
+		{
+			for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex)
+			{
+				LocalAtoms[FrameIndex] = RefPose[BoneIndex];
+			}
+		}
+		else
+		{
+			FRotationTrack& RotTrack = RotationTracks[TrackIndex];
+			FTranslationTrack& TransTrack = PositionTracks[TrackIndex];
+			FScaleTrack* ScaleTrack = bHasScale ? &ScaleTracks[TrackIndex] : nullptr;
+
+			// if requested, retarget the keys so they absorb the error already introduced on the parent chain
+			if (bRetarget && ParentBoneIndex != INDEX_NONE)
+			{
+				for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex)
+				{
+					const FTransform& NewWorldParent = NewWorldBones[ParentBoneIndex * NumFrames + FrameIndex];
+					const FTransform& RawWorldChild = RawWorldBones[BoneIndex * NumFrames + FrameIndex];
+					const FTransform RelTM = RawWorldChild.GetRelativeTransform(NewWorldParent);
+
+					if ((int32)RotTrack.RotKeys.size() == NumFrames)
+					{
+						FQuat Rot = RelTM.GetRotation();
+						Rot.EnforceShortestArcWith(RotTrack.RotKeys[FrameIndex]);
+						RotTrack.RotKeys[FrameIndex] = Rot;
+					}
+					if ((int32)TransTrack.PosKeys.size() == NumFrames)
+					{
+						TransTrack.PosKeys[FrameIndex] = RelTM.GetTranslation();
+					}
+					if (ScaleTrack && (int32)ScaleTrack->ScaleKeys.size() == NumFrames)
+					{
+						ScaleTrack->ScaleKeys[FrameIndex] = RelTM.GetScale3D();
+					}
+				}
+			}
+
+			for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex)
+			{
+				const float Time = FrameIndex * TimePerFrame;
+				FTransform& Atom = LocalAtoms[FrameIndex];
+				Atom = RefPose[BoneIndex];
+				if (RotTrack.RotKeys.size() > 0)
+				{
+					Atom.SetRotation(SampleTrack(RotTrack.RotKeys, RotTrack.Times, Time));
+				}
+				if (TransTrack.PosKeys.size() > 0)
+				{
+					Atom.SetTranslation(SampleTrack(TransTrack.PosKeys, TransTrack.Times, Time));
+				}
+				if (ScaleTrack && ScaleTrack->ScaleKeys.size() > 0)
+				{
+					Atom.SetScale3D(SampleTrack(ScaleTrack->ScaleKeys, ScaleTrack->Times, Time));
+				}
+			}
+
+			if (bActuallyFilterLinearKeys)
+			{
+				const int32 ParentTrackIndex = (ParentBoneIndex != INDEX_NONE) ? BoneToTrack[ParentBoneIndex] : INDEX_NONE;
+				const FEffectorErrorContext Context(NumFrames, BoneIndex, BoneData, RawWorldBones, NewWorldBones, LocalAtoms, MaxEffectorDiff, EffectorDiffSocket);
+
+				// filter out rotations we can approximate with interpolation
+				FilterLinearKeysTemplate<FQuat>(
+					RotTrack.RotKeys,
+					RotTrack.Times,
+					ApplyRotationKey,
+					Context,
+					ParentTrackIndex != INDEX_NONE ? &RotationTracks[ParentTrackIndex].Times : nullptr,
+					ParentScale,
+					MaxAngleDiff);
+
+				for (int32 FrameIndex = 0; FrameIndex < NumFrames && RotTrack.RotKeys.size() > 0; ++FrameIndex)
+				{
+					LocalAtoms[FrameIndex].SetRotation(SampleTrack(RotTrack.RotKeys, RotTrack.Times, FrameIndex * TimePerFrame));
+				}
+
+				// filter out translations we can approximate with interpolation
+				FilterLinearKeysTemplate<FVector>(
+					TransTrack.PosKeys,
+					TransTrack.Times,
+					ApplyTranslationKey,
+					Context,
+					ParentTrackIndex != INDEX_NONE ? &PositionTracks[ParentTrackIndex].Times : nullptr,
+					ParentScale,
+					MaxPosDiff);
+
+				for (int32 FrameIndex = 0; FrameIndex < NumFrames && TransTrack.PosKeys.size() > 0; ++FrameIndex)
+				{
+					LocalAtoms[FrameIndex].SetTranslation(SampleTrack(TransTrack.PosKeys, TransTrack.Times, FrameIndex * TimePerFrame));
+				}
+
+				if (ScaleTrack)
+				{
+					// filter out scales we can approximate with interpolation
+					FilterLinearKeysTemplate<FVector>(
+						ScaleTrack->ScaleKeys,
+						ScaleTrack->Times,
+						ApplyScaleKey,
+						Context,
+						ParentTrackIndex != INDEX_NONE ? &ScaleTracks[ParentTrackIndex].Times : nullptr,
+						ParentScale,
+						MaxScaleDiff);
+
+					for (int32 FrameIndex = 0; FrameIndex < NumFrames && ScaleTrack->ScaleKeys.size() > 0; ++FrameIndex)
+					{
+						LocalAtoms[FrameIndex].SetScale3D(SampleTrack(ScaleTrack->ScaleKeys, ScaleTrack->Times, FrameIndex * TimePerFrame));
+					}
+				}
+			}
+		}
+
+		for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex)
+		{
+			NewWorldBones[BoneIndex * NumFrames + FrameIndex] = (ParentBoneIndex != INDEX_NONE) ? LocalAtoms[FrameIndex] * NewWorldBones[ParentBoneIndex * NumFrames + FrameIndex] : LocalAtoms[FrameIndex];
+		}
+	}
+}
+
+void UAnimCompress_RemoveLinearKeys::CompressUsingUnderlyingCompressor(
+	class UAnimSequence* AnimSeq,
+	const std::vector<FTranslationTrack>& TranslationData,
+	const std::vector<FRotationTrack>& RotationData,
+	const std::vector<FScaleTrack>& ScaleData)
+{
+	// bitwise compress the tracks into the anim sequence buffers, with a frame table per track
+	BitwiseCompressAnimationTracks(
+		AnimSeq,
+		static_cast<AnimationCompressionFormat>(TranslationCompressionFormat),
+		static_cast<AnimationCompressionFormat>(RotationCompressionFormat),
+		static_cast<AnimationCompressionFormat>(ScaleCompressionFormat),
+		TranslationData,
+		RotationData,
+		ScaleData,
+		true);
+
+	// record the proper runtime decompressor to use
+	AnimSeq->KeyEncodingFormat = AKF_VariableKeyLerp;
+	AnimationFormat_SetInterfaceLinks(*AnimSeq);
+}
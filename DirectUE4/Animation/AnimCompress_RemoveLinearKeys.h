@@ -0,0 +1,56 @@
+#pragma once
+
+#include "AnimCompress.h"
+
+/**
+* Keyframe reduction algorithm that simply removes keys which are linear interpolations of surrounding keys.
+* Error is measured at the end effectors (with the dummy bone offsets from AnimationCompression.h), so a key
+* on a parent bone is only dropped if every end effector below it stays within tolerance.
+* The remaining keys are written as variable-key tracks with a frame table (AKF_VariableKeyLerp).
+*/
+class UAnimCompress_RemoveLinearKeys : public UAnimCompress
+{
+public:
+	UAnimCompress_RemoveLinearKeys();
+
+	/** Maximum position difference to use when testing if an animation key may be removed. Lower values retain more keys, but yield less compression. */
+	float MaxPosDiff;
+	/** Maximum angle difference to use when testing if an animation key may be removed. Lower values retain more keys, but yield less compression. */
+	float MaxAngleDiff;
+	/** Maximum scale difference to use when testing if an animation key may be removed. Lower values retain more keys, but yield less compression. */
+	float MaxScaleDiff;
+	/**
+	* As keys are tested for removal, we monitor the effects all the way down to the end effectors.
+	* If their position changes by more than this amount as a result of removing a key, the key will be retained.
+	*/
+	float MaxEffectorDiff;
+	/** Error threshold for end effectors that have a socket attached or are matched as key end effectors. */
+	float EffectorDiffSocket;
+	/**
+	* A scale value which increases the likelihood that a bone will retain a key if it's parent also had a key at the same time position.
+	* Higher values can remove shaking artifacts from the animation, at the cost of compression.
+	*/
+	float ParentKeyScale;
+	/** true = As the animation is compressed, adjust animated nodes to compensate for compression error. */
+	uint32 bRetarget : 1;
+	/** Controls whether the final filtering step will occur, or only the retargetting after bitwise compression. */
+	uint32 bActuallyFilterLinearKeys : 1;
+
+protected:
+	virtual void DoReduction(class UAnimSequence* AnimSeq, const std::vector<class FBoneData>& BoneData) override;
+
+	/** Removes the linear keys of every track, walking the skeleton from the root down to the end effectors. */
+	void ProcessAnimationTracks(
+		class UAnimSequence* AnimSeq,
+		const std::vector<class FBoneData>& BoneData,
+		std::vector<FTranslationTrack>& PositionTracks,
+		std::vector<FRotationTrack>& RotationTracks,
+		std::vector<FScaleTrack>& ScaleTracks);
+
+	/** Bitwise compresses the tracks with a key table and sets the variable key codec on the sequence. */
+	void CompressUsingUnderlyingCompressor(
+		class UAnimSequence* AnimSeq,
+		const std::vector<FTranslationTrack>& TranslationData,
+		const std::vector<FRotationTrack>& RotationData,
+		const std::vector<FScaleTrack>& ScaleData);
+};
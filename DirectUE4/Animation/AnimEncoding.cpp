@@ -1,7 +1,10 @@
 #include "AnimEncoding.h"
 #include "AnimEncoding_ConstantKeyLerp.h"
+#include "AnimEncoding_VariableKeyLerp.h"
 #include "AnimSequence.h"
 #include "AnimationCompression.h"
+#include "log.h"
+#include <chrono>
 
 const int32 CompressedTranslationStrides[ACF_MAX] =
 {
@@ -92,27 +95,71 @@ void AnimationFormat_GetAnimationPose(
 	const BoneTrackArray& TranslationPairs,
 	const BoneTrackArray& ScalePairs,
 	const UAnimSequence& Seq, 
-	float Time)
+	float Time,
+	bool bBatched)
 {
 	// decompress the translation component using the proper method
 	assert(Seq.TranslationCodec != NULL);
 	if (TranslationPairs.size() > 0)
 	{
-		((AnimEncoding*)Seq.TranslationCodec)->GetPoseTranslations(Atoms, TranslationPairs, Seq, Time);
+		((AnimEncoding*)Seq.TranslationCodec)->GetPoseTranslations(Atoms, TranslationPairs, Seq, Time, bBatched);
 	}
 
 	// decompress the rotation component using the proper method
 	assert(Seq.RotationCodec != NULL);
-	((AnimEncoding*)Seq.RotationCodec)->GetPoseRotations(Atoms, RotationPairs, Seq, Time);
+	((AnimEncoding*)Seq.RotationCodec)->GetPoseRotations(Atoms, RotationPairs, Seq, Time, bBatched);
 
 	assert(Seq.ScaleCodec != NULL);
 	// we allow scale key to be empty
 	if (Seq.CompressedScaleOffsets.IsValid())
 	{
-		((AnimEncoding*)Seq.ScaleCodec)->GetPoseScales(Atoms, ScalePairs, Seq, Time);
+		((AnimEncoding*)Seq.ScaleCodec)->GetPoseScales(Atoms, ScalePairs, Seq, Time, bBatched);
 	}
 }
 
+void AnimationFormat_BenchmarkPoseDecompression(const UAnimSequence& Seq, int32 NumSamples)
+{
+	const int32 NumTracks = Seq.CompressedTrackOffsets.size() / 4;
+	if (NumTracks == 0 || NumSamples <= 0 || Seq.RotationCodec == NULL)
+	{
+		return;
+	}
+
+	BoneTrackArray Pairs;
+	for (int32 TrackIndex = 0; TrackIndex < NumTracks; ++TrackIndex)
+	{
+		Pairs.push_back(BoneTrackPair(TrackIndex, TrackIndex));
+	}
+	const BoneTrackArray& ScalePairs = Seq.CompressedScaleOffsets.IsValid() ? Pairs : BoneTrackArray();
+
+	FTransformArray BatchedAtoms(NumTracks);
+	FTransformArray ScalarAtoms(NumTracks);
+	double Seconds[2] = { 0.0, 0.0 };
+	float MaxDifference = 0.f;
+
+	for (int32 SampleIndex = 0; SampleIndex < NumSamples; ++SampleIndex)
+	{
+		const float Time = Seq.SequenceLength * (float)SampleIndex / (float)NumSamples;
+		for (int32 Pass = 0; Pass < 2; ++Pass)
+		{
+			FTransformArray& Atoms = (Pass == 0) ? BatchedAtoms : ScalarAtoms;
+
+			const auto Start = std::chrono::high_resolution_clock::now();
+			AnimationFormat_GetAnimationPose(Atoms, Pairs, Pairs, ScalePairs, Seq, Time, Pass == 0);
+			Seconds[Pass] += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - Start).count();
+		}
+
+		for (int32 TrackIndex = 0; TrackIndex < NumTracks; ++TrackIndex)
+		{
+			MaxDifference = FMath::Max(MaxDifference, (BatchedAtoms[TrackIndex].GetTranslation() - ScalarAtoms[TrackIndex].GetTranslation()).Size());
+			MaxDifference = FMath::Max(MaxDifference, FMath::Abs(1.f - FMath::Abs(BatchedAtoms[TrackIndex].GetRotation() | ScalarAtoms[TrackIndex].GetRotation())));
+		}
+	}
+
+	X_LOG("Pose decompression, %d tracks x %d samples: batched %.3f ms, scalar %.3f ms, max difference %f\n",
+		NumTracks, NumSamples, Seconds[0] * 1000.0, Seconds[1] * 1000.0, MaxDifference);
+}
+
 void AnimationFormat_SetInterfaceLinks(UAnimSequence& Seq)
 {
 	Seq.TranslationCodec = NULL;
@@ -196,6 +243,84 @@ void AnimationFormat_SetInterfaceLinks(UAnimSequence& Seq)
 		default:
 			assert(false);// UE_LOG(LogAnimationCompression, Fatal, TEXT("%i: unknown or unsupported Scale compression"), (int32)Seq.ScaleCompressionFormat);
 		};
+	}
+	else if (Seq.KeyEncodingFormat == AKF_VariableKeyLerp)
+	{
+		static AEFVariableKeyLerp<ACF_None>					AEFVariableKeyLerp_None;
+		static AEFVariableKeyLerp<ACF_Float96NoW>			AEFVariableKeyLerp_Float96NoW;
+		static AEFVariableKeyLerp<ACF_Fixed48NoW>			AEFVariableKeyLerp_Fixed48NoW;
+		static AEFVariableKeyLerp<ACF_IntervalFixed32NoW>	AEFVariableKeyLerp_IntervalFixed32NoW;
+		static AEFVariableKeyLerp<ACF_Fixed32NoW>			AEFVariableKeyLerp_Fixed32NoW;
+		static AEFVariableKeyLerp<ACF_Float32NoW>			AEFVariableKeyLerp_Float32NoW;
+		static AEFVariableKeyLerp<ACF_Identity>				AEFVariableKeyLerp_Identity;
+
+		// setup translation codec
+		switch (Seq.TranslationCompressionFormat)
+		{
+		case ACF_None:
+			Seq.TranslationCodec = &AEFVariableKeyLerp_None;
+			break;
+		case ACF_Float96NoW:
+			Seq.TranslationCodec = &AEFVariableKeyLerp_Float96NoW;
+			break;
+		case ACF_IntervalFixed32NoW:
+			Seq.TranslationCodec = &AEFVariableKeyLerp_IntervalFixed32NoW;
+			break;
+		case ACF_Identity:
+			Seq.TranslationCodec = &AEFVariableKeyLerp_Identity;
+			break;
+
+		default:
+			assert(false);// UE_LOG(LogAnimationCompression, Fatal, TEXT("%i: unknown or unsupported translation compression"), (int32)Seq.TranslationCompressionFormat);
+		};
+
+		// setup rotation codec
+		switch (Seq.RotationCompressionFormat)
+		{
+		case ACF_None:
+			Seq.RotationCodec = &AEFVariableKeyLerp_None;
+			break;
+		case ACF_Float96NoW:
+			Seq.RotationCodec = &AEFVariableKeyLerp_Float96NoW;
+			break;
+		case ACF_Fixed48NoW:
+			Seq.RotationCodec = &AEFVariableKeyLerp_Fixed48NoW;
+			break;
+		case ACF_IntervalFixed32NoW:
+			Seq.RotationCodec = &AEFVariableKeyLerp_IntervalFixed32NoW;
+			break;
+		case ACF_Fixed32NoW:
+			Seq.RotationCodec = &AEFVariableKeyLerp_Fixed32NoW;
+			break;
+		case ACF_Float32NoW:
+			Seq.RotationCodec = &AEFVariableKeyLerp_Float32NoW;
+			break;
+		case ACF_Identity:
+			Seq.RotationCodec = &AEFVariableKeyLerp_Identity;
+			break;
+
+		default:
+			assert(false);// UE_LOG(LogAnimationCompression, Fatal, TEXT("%i: unknown or unsupported rotation compression"), (int32)Seq.RotationCompressionFormat);
+		};
+
+		// setup Scale codec
+		switch (Seq.ScaleCompressionFormat)
+		{
+		case ACF_None:
+			Seq.ScaleCodec = &AEFVariableKeyLerp_None;
+			break;
+		case ACF_Float96NoW:
+			Seq.ScaleCodec = &AEFVariableKeyLerp_Float96NoW;
+			break;
+		case ACF_IntervalFixed32NoW:
+			Seq.ScaleCodec = &AEFVariableKeyLerp_IntervalFixed32NoW;
+			break;
+		case ACF_Identity:
+			Seq.ScaleCodec = &AEFVariableKeyLerp_Identity;
+			break;
+		default:
+			assert(false);// UE_LOG(LogAnimationCompression, Fatal, TEXT("%i: unknown or unsupported Scale compression"), (int32)Seq.ScaleCompressionFormat);
+		};
 	}
 }
 
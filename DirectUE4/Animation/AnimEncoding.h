@@ -41,10 +41,17 @@ void AnimationFormat_GetAnimationPose(
 	const BoneTrackArray& TranslationTracks,
 	const BoneTrackArray& ScaleTracks,
 	const UAnimSequence& Seq,
-	float Time);
+	float Time,
+	bool bBatched = true);
 
 void AnimationFormat_SetInterfaceLinks(UAnimSequence& Seq);
 
+/**
+* Micro benchmark of the pose decompression: decodes every track of the sequence at NumSamples times,
+* once with the batched path and once with the scalar per-track path, and logs both timings and their largest difference.
+*/
+void AnimationFormat_BenchmarkPoseDecompression(const UAnimSequence& Seq, int32 NumSamples);
+
 extern const int32 CompressedTranslationStrides[ACF_MAX];
 extern const int32 CompressedTranslationNum[ACF_MAX];
 extern const int32 CompressedRotationStrides[ACF_MAX];
@@ -62,25 +69,31 @@ public:
 		int32 TrackIndex,
 		float Time) = 0;
 
+	/** bBatched blends the keys of several tracks at once where the codec supports it, false decodes track by track */
 	virtual void GetPoseRotations(
 		FTransformArray& Atoms,
 		const BoneTrackArray& DesiredPairs,
 		const UAnimSequence& Seq,
-		float Time) = 0;
+		float Time,
+		bool bBatched) = 0;
 
 	virtual void GetPoseTranslations(
 		FTransformArray& Atoms,
 		const BoneTrackArray& DesiredPairs,
 		const UAnimSequence& Seq,
-		float Time) = 0;
+		float Time,
+		bool bBatched) = 0;
 
 	virtual void GetPoseScales(
 		FTransformArray& Atoms,
 		const BoneTrackArray& DesiredPairs,
 		const UAnimSequence& Seq,
-		float Time) = 0;
+		float Time,
+		bool bBatched) = 0;
 
 protected:
+	friend struct FKeyLerpIndexCache;
+
 	static float TimeToIndex(
 		const UAnimSequence& Seq,
 		float RelativePos,
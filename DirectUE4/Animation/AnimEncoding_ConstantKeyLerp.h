@@ -1,5 +1,168 @@
+#pragma once
+
 #include "AnimEncoding.h"
 
+/** Number of tracks whose keys are blended together by the batched pose decompression. */
+#define ANIM_DECOMPRESSION_BATCH_SIZE 8
+
+/**
+* Remembers the interpolation indices of the last few key counts that were looked up.
+* With constant key spacing the indices only depend on the key count, and the tracks of a sequence share one or two key counts.
+*/
+struct FKeyLerpIndexCache
+{
+	enum { CacheSize = 4 };
+
+	int32 NumKeys[CacheSize];
+	int32 Index0[CacheSize];
+	int32 Index1[CacheSize];
+	float Alpha[CacheSize];
+	int32 NumUsed;
+	int32 NextSlot;
+
+	FKeyLerpIndexCache() : NumUsed(0), NextSlot(0) {}
+
+	inline float TimeToIndex(const UAnimSequence& Seq, float RelativePos, int32 InNumKeys, int32& OutIndex0, int32& OutIndex1)
+	{
+		for (int32 Slot = 0; Slot < NumUsed; ++Slot)
+		{
+			if (NumKeys[Slot] == InNumKeys)
+			{
+				OutIndex0 = Index0[Slot];
+				OutIndex1 = Index1[Slot];
+				return Alpha[Slot];
+			}
+		}
+
+		const float NewAlpha = AnimEncoding::TimeToIndex(Seq, RelativePos, InNumKeys, OutIndex0, OutIndex1);
+
+		const int32 Slot = NextSlot;
+		NextSlot = (NextSlot + 1) % CacheSize;
+		NumUsed = FMath::Min<int32>(NumUsed + 1, CacheSize);
+		NumKeys[Slot] = InNumKeys;
+		Index0[Slot] = OutIndex0;
+		Index1[Slot] = OutIndex1;
+		Alpha[Slot] = NewAlpha;
+		return NewAlpha;
+	}
+};
+
+/**
+* Pairs of decoded rotation keys waiting to be blended, stored as structure of arrays so the
+* lerp and normalize of a whole batch runs as straight float loops the compiler can vectorize.
+*/
+struct FRotationLerpBatch
+{
+	float X0[ANIM_DECOMPRESSION_BATCH_SIZE], Y0[ANIM_DECOMPRESSION_BATCH_SIZE], Z0[ANIM_DECOMPRESSION_BATCH_SIZE], W0[ANIM_DECOMPRESSION_BATCH_SIZE];
+	float X1[ANIM_DECOMPRESSION_BATCH_SIZE], Y1[ANIM_DECOMPRESSION_BATCH_SIZE], Z1[ANIM_DECOMPRESSION_BATCH_SIZE], W1[ANIM_DECOMPRESSION_BATCH_SIZE];
+	float Alpha[ANIM_DECOMPRESSION_BATCH_SIZE];
+	int32 AtomIndex[ANIM_DECOMPRESSION_BATCH_SIZE];
+	int32 Num;
+
+	FRotationLerpBatch() : Num(0) {}
+
+	inline bool IsFull() const { return Num == ANIM_DECOMPRESSION_BATCH_SIZE; }
+
+	inline void Add(int32 InAtomIndex, const FQuat& R0, const FQuat& R1, float InAlpha)
+	{
+		X0[Num] = R0.X; Y0[Num] = R0.Y; Z0[Num] = R0.Z; W0[Num] = R0.W;
+		X1[Num] = R1.X; Y1[Num] = R1.Y; Z1[Num] = R1.Z; W1[Num] = R1.W;
+		Alpha[Num] = InAlpha;
+		AtomIndex[Num] = InAtomIndex;
+		++Num;
+	}
+
+	/** Same math as FQuat::FastLerp followed by FQuat::Normalize, then scatters the results to the atoms. */
+	inline void Flush(FTransformArray& Atoms)
+	{
+		float OutX[ANIM_DECOMPRESSION_BATCH_SIZE], OutY[ANIM_DECOMPRESSION_BATCH_SIZE], OutZ[ANIM_DECOMPRESSION_BATCH_SIZE], OutW[ANIM_DECOMPRESSION_BATCH_SIZE];
+		for (int32 Lane = 0; Lane < Num; ++Lane)
+		{
+			// shortest route: flip the first key when the two keys are in opposite hemispheres
+			const float Dot = X0[Lane] * X1[Lane] + Y0[Lane] * Y1[Lane] + Z0[Lane] * Z1[Lane] + W0[Lane] * W1[Lane];
+			const float Bias = Dot >= 0.f ? 1.f : -1.f;
+			const float Weight0 = Bias * (1.f - Alpha[Lane]);
+			const float Weight1 = Alpha[Lane];
+
+			const float X = X1[Lane] * Weight1 + X0[Lane] * Weight0;
+			const float Y = Y1[Lane] * Weight1 + Y0[Lane] * Weight0;
+			const float Z = Z1[Lane] * Weight1 + Z0[Lane] * Weight0;
+			const float W = W1[Lane] * Weight1 + W0[Lane] * Weight0;
+
+			const float SquareSum = X * X + Y * Y + Z * Z + W * W;
+			const bool bValid = SquareSum >= SMALL_NUMBER;
+			const float Scale = bValid ? FMath::InvSqrt(SquareSum) : 0.f;
+			OutX[Lane] = X * Scale;
+			OutY[Lane] = Y * Scale;
+			OutZ[Lane] = Z * Scale;
+			OutW[Lane] = bValid ? W * Scale : 1.f;
+		}
+
+		for (int32 Lane = 0; Lane < Num; ++Lane)
+		{
+			Atoms[AtomIndex[Lane]].SetRotation(FQuat(OutX[Lane], OutY[Lane], OutZ[Lane], OutW[Lane]));
+		}
+		Num = 0;
+	}
+};
+
+/** Pairs of decoded translation or scale keys waiting to be blended, see FRotationLerpBatch. */
+struct FVectorLerpBatch
+{
+	float X0[ANIM_DECOMPRESSION_BATCH_SIZE], Y0[ANIM_DECOMPRESSION_BATCH_SIZE], Z0[ANIM_DECOMPRESSION_BATCH_SIZE];
+	float X1[ANIM_DECOMPRESSION_BATCH_SIZE], Y1[ANIM_DECOMPRESSION_BATCH_SIZE], Z1[ANIM_DECOMPRESSION_BATCH_SIZE];
+	float Alpha[ANIM_DECOMPRESSION_BATCH_SIZE];
+	int32 AtomIndex[ANIM_DECOMPRESSION_BATCH_SIZE];
+	int32 Num;
+
+	FVectorLerpBatch() : Num(0) {}
+
+	inline bool IsFull() const { return Num == ANIM_DECOMPRESSION_BATCH_SIZE; }
+
+	inline void Add(int32 InAtomIndex, const FVector& P0, const FVector& P1, float InAlpha)
+	{
+		X0[Num] = P0.X; Y0[Num] = P0.Y; Z0[Num] = P0.Z;
+		X1[Num] = P1.X; Y1[Num] = P1.Y; Z1[Num] = P1.Z;
+		Alpha[Num] = InAlpha;
+		AtomIndex[Num] = InAtomIndex;
+		++Num;
+	}
+
+	inline void FlushTranslations(FTransformArray& Atoms)
+	{
+		float OutX[ANIM_DECOMPRESSION_BATCH_SIZE], OutY[ANIM_DECOMPRESSION_BATCH_SIZE], OutZ[ANIM_DECOMPRESSION_BATCH_SIZE];
+		Lerp(OutX, OutY, OutZ);
+		for (int32 Lane = 0; Lane < Num; ++Lane)
+		{
+			Atoms[AtomIndex[Lane]].SetTranslation(FVector(OutX[Lane], OutY[Lane], OutZ[Lane]));
+		}
+		Num = 0;
+	}
+
+	inline void FlushScales(FTransformArray& Atoms)
+	{
+		float OutX[ANIM_DECOMPRESSION_BATCH_SIZE], OutY[ANIM_DECOMPRESSION_BATCH_SIZE], OutZ[ANIM_DECOMPRESSION_BATCH_SIZE];
+		Lerp(OutX, OutY, OutZ);
+		for (int32 Lane = 0; Lane < Num; ++Lane)
+		{
+			Atoms[AtomIndex[Lane]].SetScale3D(FVector(OutX[Lane], OutY[Lane], OutZ[Lane]));
+		}
+		Num = 0;
+	}
+
+private:
+	/** Same math as FMath::Lerp, over the whole batch. */
+	inline void Lerp(float* __restrict OutX, float* __restrict OutY, float* __restrict OutZ) const
+	{
+		for (int32 Lane = 0; Lane < Num; ++Lane)
+		{
+			OutX[Lane] = X0[Lane] + Alpha[Lane] * (X1[Lane] - X0[Lane]);
+			OutY[Lane] = Y0[Lane] + Alpha[Lane] * (Y1[Lane] - Y0[Lane]);
+			OutZ[Lane] = Z0[Lane] + Alpha[Lane] * (Z1[Lane] - Z0[Lane]);
+		}
+	}
+};
+
 class AEFConstantKeyLerpShared : public AnimEncodingLegacyBase
 {
 public:
@@ -37,19 +200,22 @@ public:
 		FTransformArray& Atoms,
 		const BoneTrackArray& DesiredPairs,
 		const UAnimSequence& Seq,
-		float RelativePos);
+		float RelativePos,
+		bool bBatched);
 
 	void GetPoseTranslations(
 		FTransformArray& Atoms,
 		const BoneTrackArray& DesiredPairs,
 		const UAnimSequence& Seq,
-		float RelativePos);
+		float RelativePos,
+		bool bBatched);
 
 	void GetPoseScales(
 		FTransformArray& Atoms,
 		const BoneTrackArray& DesiredPairs,
 		const UAnimSequence& Seq,
-		float RelativePos);
+		float RelativePos,
+		bool bBatched);
 };
 
 template<int32 FORMAT>
@@ -179,10 +345,57 @@ inline void AEFConstantKeyLerp<FORMAT>::GetPoseRotations(
 	FTransformArray& Atoms,
 	const BoneTrackArray& DesiredPairs,
 	const UAnimSequence& Seq,
-	float Time)
+	float Time,
+	bool bBatched)
 {
 	const int32 PairCount = (int32)DesiredPairs.size();
 	const float RelativePos = Time / (float)Seq.SequenceLength;
+	if (bBatched)
+	{
+		const int32 RotationStreamOffset = (FORMAT == ACF_IntervalFixed32NoW) ? (sizeof(float) * 6) : 0; // offset past Min and Range data
+		const int32 KeyStride = CompressedRotationStrides[FORMAT] * CompressedRotationNum[FORMAT];
+		FKeyLerpIndexCache IndexCache;
+		FRotationLerpBatch Batch;
+
+		for (int32 PairIndex = 0; PairIndex < PairCount; ++PairIndex)
+		{
+			const BoneTrackPair& Pair = DesiredPairs[PairIndex];
+			const int32* __restrict TrackData = Seq.CompressedTrackOffsets.data() + (Pair.TrackIndex * 4);
+			const int32 RotKeysOffset = *(TrackData + 2);
+			const int32 NumRotKeys = *(TrackData + 3);
+			const uint8* __restrict RotStream = Seq.CompressedByteStream.data() + RotKeysOffset;
+
+			FQuat R0;
+			if (NumRotKeys == 1)
+			{
+				// For a rotation track of n=1 keys, the single key is packed as an FQuatFloat96NoW.
+				DecompressRotation<ACF_Float96NoW>(R0, RotStream, RotStream);
+				Atoms[Pair.AtomIndex].SetRotation(R0);
+				continue;
+			}
+
+			int32 Index0;
+			int32 Index1;
+			const float Alpha = IndexCache.TimeToIndex(Seq, RelativePos, NumRotKeys, Index0, Index1);
+
+			DecompressRotation<FORMAT>(R0, RotStream, RotStream + RotationStreamOffset + Index0 * KeyStride);
+			if (Index0 == Index1)
+			{
+				Atoms[Pair.AtomIndex].SetRotation(R0);
+				continue;
+			}
+
+			FQuat R1;
+			DecompressRotation<FORMAT>(R1, RotStream, RotStream + RotationStreamOffset + Index1 * KeyStride);
+			Batch.Add(Pair.AtomIndex, R0, R1, Alpha);
+			if (Batch.IsFull())
+			{
+				Batch.Flush(Atoms);
+			}
+		}
+		Batch.Flush(Atoms);
+		return;
+	}
 
 	for (int32 PairIndex = 0; PairIndex < PairCount; ++PairIndex)
 	{
@@ -206,10 +419,49 @@ inline void AEFConstantKeyLerp<FORMAT>::GetPoseTranslations(
 	FTransformArray& Atoms,
 	const BoneTrackArray& DesiredPairs,
 	const UAnimSequence& Seq,
-	float Time)
+	float Time,
+	bool bBatched)
 {
 	const int32 PairCount = (int32)DesiredPairs.size();
 	const float RelativePos = Time / (float)Seq.SequenceLength;
+	if (bBatched)
+	{
+		const int32 KeyStride = CompressedTranslationStrides[FORMAT] * CompressedTranslationNum[FORMAT];
+		FKeyLerpIndexCache IndexCache;
+		FVectorLerpBatch Batch;
+
+		for (int32 PairIndex = 0; PairIndex < PairCount; ++PairIndex)
+		{
+			const BoneTrackPair& Pair = DesiredPairs[PairIndex];
+			const int32* __restrict TrackData = Seq.CompressedTrackOffsets.data() + (Pair.TrackIndex * 4);
+			const int32 TransKeysOffset = *(TrackData + 0);
+			const int32 NumTransKeys = *(TrackData + 1);
+			const uint8* __restrict TransStream = Seq.CompressedByteStream.data() + TransKeysOffset;
+			const int32 TransStreamOffset = ((FORMAT == ACF_IntervalFixed32NoW) && NumTransKeys > 1) ? (sizeof(float) * 6) : 0; // offset past Min and Range data
+
+			int32 Index0;
+			int32 Index1;
+			const float Alpha = IndexCache.TimeToIndex(Seq, RelativePos, NumTransKeys, Index0, Index1);
+
+			FVector P0;
+			DecompressTranslation<FORMAT>(P0, TransStream, TransStream + TransStreamOffset + Index0 * KeyStride);
+			if (Index0 == Index1)
+			{
+				Atoms[Pair.AtomIndex].SetTranslation(P0);
+				continue;
+			}
+
+			FVector P1;
+			DecompressTranslation<FORMAT>(P1, TransStream, TransStream + TransStreamOffset + Index1 * KeyStride);
+			Batch.Add(Pair.AtomIndex, P0, P1, Alpha);
+			if (Batch.IsFull())
+			{
+				Batch.FlushTranslations(Atoms);
+			}
+		}
+		Batch.FlushTranslations(Atoms);
+		return;
+	}
 
 	//@TODO: Verify that this prefetch is helping
 	// Prefetch the desired pairs array and 2 destination spots; the loop will prefetch one 2 out each iteration
@@ -249,12 +501,50 @@ inline void AEFConstantKeyLerp<FORMAT>::GetPoseScales(
 	FTransformArray& Atoms,
 	const BoneTrackArray& DesiredPairs,
 	const UAnimSequence& Seq,
-	float Time)
+	float Time,
+	bool bBatched)
 {
 	assert(Seq.CompressedScaleOffsets.IsValid());
 
 	const int32 PairCount = (int32)DesiredPairs.size();
 	const float RelativePos = Time / (float)Seq.SequenceLength;
+	if (bBatched)
+	{
+		const int32 KeyStride = CompressedScaleStrides[FORMAT] * CompressedScaleNum[FORMAT];
+		FKeyLerpIndexCache IndexCache;
+		FVectorLerpBatch Batch;
+
+		for (int32 PairIndex = 0; PairIndex < PairCount; ++PairIndex)
+		{
+			const BoneTrackPair& Pair = DesiredPairs[PairIndex];
+			const int32 ScaleKeysOffset = Seq.CompressedScaleOffsets.GetOffsetData(Pair.TrackIndex, 0);
+			const int32 NumScaleKeys = Seq.CompressedScaleOffsets.GetOffsetData(Pair.TrackIndex, 1);
+			const uint8* __restrict ScaleStream = Seq.CompressedByteStream.data() + ScaleKeysOffset;
+			const int32 ScaleStreamOffset = ((FORMAT == ACF_IntervalFixed32NoW) && NumScaleKeys > 1) ? (sizeof(float) * 6) : 0; // offset past Min and Range data
+
+			int32 Index0;
+			int32 Index1;
+			const float Alpha = IndexCache.TimeToIndex(Seq, RelativePos, NumScaleKeys, Index0, Index1);
+
+			FVector P0;
+			DecompressScale<FORMAT>(P0, ScaleStream, ScaleStream + ScaleStreamOffset + Index0 * KeyStride);
+			if (Index0 == Index1)
+			{
+				Atoms[Pair.AtomIndex].SetScale3D(P0);
+				continue;
+			}
+
+			FVector P1;
+			DecompressScale<FORMAT>(P1, ScaleStream, ScaleStream + ScaleStreamOffset + Index1 * KeyStride);
+			Batch.Add(Pair.AtomIndex, P0, P1, Alpha);
+			if (Batch.IsFull())
+			{
+				Batch.FlushScales(Atoms);
+			}
+		}
+		Batch.FlushScales(Atoms);
+		return;
+	}
 
 	//@TODO: Verify that this prefetch is helping
 	// Prefetch the desired pairs array and 2 destination spots; the loop will prefetch one 2 out each iteration
@@ -0,0 +1,142 @@
+#include "AnimPoseCache.h"
+#include "log.h"
+#include <cstring>
+#include <tuple>
+
+bool GEnableAnimPoseCache = true;
+float GAnimPoseCacheTimeQuantum = 0.f;
+
+FAnimPoseCache GAnimPoseCache;
+
+bool FAnimPoseCache::FPoseKey::operator<(const FPoseKey& Other) const
+{
+	return std::tie(Sequence, Asset, BoneIndicesHash, NumBones, NumCurveElements, TimeBits) < std::tie(Other.Sequence, Other.Asset, Other.BoneIndicesHash, Other.NumBones, Other.NumCurveElements, Other.TimeBits);
+}
+
+static const std::vector<uint16>& GetCurveUIDToArrayIndex(const FBlendedCurve& Curve)
+{
+	static const std::vector<uint16> NoCurves;
+	return Curve.UIDToArrayIndexLUT ? *Curve.UIDToArrayIndexLUT : NoCurves;
+}
+
+bool FAnimPoseCache::FCachedPose::Matches(const FCompactPose& Pose, const FBlendedCurve& Curve) const
+{
+	return BoneIndices == Pose.GetBoneContainer().GetBoneIndicesArray() && CurveUIDToArrayIndex == GetCurveUIDToArrayIndex(Curve);
+}
+
+FAnimPoseCache::FAnimPoseCache()
+	: NumHits(0)
+	, NumMisses(0)
+	, PeakNumPoses(0)
+{
+}
+
+float FAnimPoseCache::QuantizeTime(float InTime) const
+{
+	if (GAnimPoseCacheTimeQuantum <= 0.f)
+	{
+		return InTime;
+	}
+	return (float)FMath::RoundToInt(InTime / GAnimPoseCacheTimeQuantum) * GAnimPoseCacheTimeQuantum;
+}
+
+FAnimPoseCache::FPoseKey FAnimPoseCache::MakeKey(const UAnimSequence* Sequence, float Time, const FCompactPose& Pose, const FBlendedCurve& Curve) const
+{
+	const FBoneContainer& BoneContainer = Pose.GetBoneContainer();
+
+	FPoseKey Key;
+	Key.Sequence = Sequence;
+	Key.Asset = BoneContainer.GetAsset();
+	Key.BoneIndicesHash = BoneContainer.GetBoneIndicesHash();
+	Key.NumBones = Pose.GetNumBones();
+	Key.NumCurveElements = (uint32)Curve.Elements.size();
+	std::memcpy(&Key.TimeBits, &Time, sizeof(Key.TimeBits));
+	return Key;
+}
+
+FAnimPoseCache::FShard& FAnimPoseCache::GetShard(const FPoseKey& Key)
+{
+	// instances of a crowd differ in sequence and time, the bone set is usually the same for all of them
+	uint64 Hash = (uint64)(uintptr_t)Key.Sequence * 0x9E3779B97F4A7C15ull;
+	Hash ^= (uint64)Key.TimeBits * 0xC2B2AE3D27D4EB4Full;
+	return Shards[(Hash >> 32) % NumShards];
+}
+
+bool FAnimPoseCache::FindPose(const UAnimSequence* Sequence, float Time, FCompactPose& OutPose, FBlendedCurve& OutCurve)
+{
+	const FPoseKey Key = MakeKey(Sequence, Time, OutPose, OutCurve);
+	FShard& Shard = GetShard(Key);
+
+	std::lock_guard<std::mutex> Lock(Shard.PosesMutex);
+	auto It = Shard.Poses.find(Key);
+	if (It != Shard.Poses.end())
+	{
+		for (const FCachedPose& CachedPose : It->second)
+		{
+			if (CachedPose.Matches(OutPose, OutCurve))
+			{
+				OutPose.CopyBonesFrom(CachedPose.Bones);
+				OutCurve.Elements = CachedPose.CurveElements;
+				++NumHits;
+				return true;
+			}
+		}
+	}
+
+	++NumMisses;
+	return false;
+}
+
+void FAnimPoseCache::AddPose(const UAnimSequence* Sequence, float Time, const FCompactPose& Pose, const FBlendedCurve& Curve)
+{
+	const FPoseKey Key = MakeKey(Sequence, Time, Pose, Curve);
+	FShard& Shard = GetShard(Key);
+
+	std::lock_guard<std::mutex> Lock(Shard.PosesMutex);
+	std::vector<FCachedPose>& CachedPoses = Shard.Poses[Key];
+	// another instance may have decoded the same pose meanwhile, the first one wins
+	for (const FCachedPose& CachedPose : CachedPoses)
+	{
+		if (CachedPose.Matches(Pose, Curve))
+		{
+			return;
+		}
+	}
+
+	CachedPoses.emplace_back();
+	FCachedPose& CachedPose = CachedPoses.back();
+	CachedPose.BoneIndices = Pose.GetBoneContainer().GetBoneIndicesArray();
+	CachedPose.CurveUIDToArrayIndex = GetCurveUIDToArrayIndex(Curve);
+	CachedPose.Bones = Pose.GetBones();
+	CachedPose.CurveElements = Curve.Elements;
+}
+
+void FAnimPoseCache::BeginFrame()
+{
+	uint32 NumPoses = 0;
+	for (FShard& Shard : Shards)
+	{
+		std::lock_guard<std::mutex> Lock(Shard.PosesMutex);
+		for (const auto& Pair : Shard.Poses)
+		{
+			NumPoses += (uint32)Pair.second.size();
+		}
+		Shard.Poses.clear();
+	}
+	PeakNumPoses = FMath::Max(PeakNumPoses, NumPoses);
+}
+
+void FAnimPoseCache::ResetStats()
+{
+	NumHits = 0;
+	NumMisses = 0;
+	PeakNumPoses = 0;
+}
+
+void FAnimPoseCache::LogStats() const
+{
+	const uint32 Hits = NumHits;
+	const uint32 Lookups = Hits + NumMisses;
+	X_LOG("AnimPoseCache: %u lookups, %u hits (%.1f%%), %u misses, peak %u poses per frame\n",
+		Lookups, Hits, Lookups > 0 ? 100.f * Hits / Lookups : 0.f, (uint32)NumMisses, PeakNumPoses);
+}
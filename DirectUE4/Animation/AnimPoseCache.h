@@ -0,0 +1,100 @@
+#pragma once
+
+#include "BonePose.h"
+#include "AnimCurveTypes.h"
+#include <map>
+#include <mutex>
+#include <atomic>
+
+class UAnimSequence;
+
+/** Master switch for sharing decoded sequence poses between instances, -noposecache turns it off */
+extern bool GEnableAnimPoseCache;
+
+/**
+* Sampling times are snapped to multiples of this before extraction so instances a fraction of a frame apart share a pose.
+* 0 (the default) only shares poses between instances at exactly the same time, so the cache never changes the animation.
+*/
+extern float GAnimPoseCacheTimeQuantum;
+
+/**
+* Per frame cache of decoded sequence poses.
+* Crowds often play the same sequence at the same time; the first instance to evaluate a (sequence, time, required bones)
+* combination decodes it and every later one copies the result instead of decompressing the tracks again.
+* Lookups are thread safe, so instances evaluated in parallel share poses as well; poses are spread over shards with a lock
+* each so parallel instances playing different sequences or times rarely wait on one another.
+*/
+class FAnimPoseCache
+{
+public:
+	FAnimPoseCache();
+
+	/** Time the pose at InTime is extracted at, the same for every instance sharing its cache entry */
+	float QuantizeTime(float InTime) const;
+
+	/** Copies the cached pose of Sequence at the (quantized) Time into OutPose and OutCurve, returns false on a miss */
+	bool FindPose(const UAnimSequence* Sequence, float Time, FCompactPose& OutPose, FBlendedCurve& OutCurve);
+
+	/** Stores a pose just extracted from Sequence at the (quantized) Time for the rest of the frame */
+	void AddPose(const UAnimSequence* Sequence, float Time, const FCompactPose& Pose, const FBlendedCurve& Curve);
+
+	/** Drops the poses of the last frame, animation time has moved on */
+	void BeginFrame();
+
+	/** Clears hit and miss counts */
+	void ResetStats();
+
+	uint32 GetNumHits() const { return NumHits; }
+	uint32 GetNumMisses() const { return NumMisses; }
+
+	void LogStats() const;
+
+private:
+	/** Narrows a lookup down to the poses that may match, which then compare their bones and curves in full */
+	struct FPoseKey
+	{
+		const UAnimSequence* Sequence;
+		const void* Asset;
+		uint32 BoneIndicesHash;
+		uint32 NumBones;
+		uint32 NumCurveElements;
+		/** Bit pattern of the quantized time */
+		uint32 TimeBits;
+
+		bool operator<(const FPoseKey& Other) const;
+	};
+
+	struct FCachedPose
+	{
+		/** Compact poses only match if they were built from the same required bones */
+		std::vector<FBoneIndexType> BoneIndices;
+		/** Curves are copied element by element, a pose cached with curves of other UIDs is no match */
+		std::vector<uint16> CurveUIDToArrayIndex;
+		std::vector<FTransform> Bones;
+		std::vector<FCurveElement> CurveElements;
+
+		bool Matches(const FCompactPose& Pose, const FBlendedCurve& Curve) const;
+	};
+
+	FPoseKey MakeKey(const UAnimSequence* Sequence, float Time, const FCompactPose& Pose, const FBlendedCurve& Curve) const;
+
+	struct FShard
+	{
+		/** Poses whose keys collide but whose bones or curves differ are kept side by side */
+		std::map<FPoseKey, std::vector<FCachedPose>> Poses;
+		std::mutex PosesMutex;
+	};
+
+	enum { NumShards = 16 };
+
+	FShard& GetShard(const FPoseKey& Key);
+
+	FShard Shards[NumShards];
+
+	std::atomic<uint32> NumHits;
+	std::atomic<uint32> NumMisses;
+	/** Most poses alive in a single frame since the last ResetStats */
+	uint32 PeakNumPoses;
+};
+
+extern FAnimPoseCache GAnimPoseCache;
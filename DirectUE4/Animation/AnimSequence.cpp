@@ -29,7 +29,8 @@ struct FGetBonePoseScratchArea
 
 	static FGetBonePoseScratchArea& Get()
 	{
-		static FGetBonePoseScratchArea Instance;
+		// poses are evaluated from several animation worker threads at once
+		static thread_local FGetBonePoseScratchArea Instance;
 		return Instance;
 	}
 };
@@ -231,12 +232,16 @@ bool UAnimSequence::CompressRawAnimSequenceTrack(FRawAnimSequenceTrack& RawTrack
 
 void UAnimSequence::OnRawDataChanged()
 {
+	// the compression report compares against the data this compression replaces, which is gone once the stream is reset
+	std::shared_ptr<FAnimCompressContext> CompressContext = std::make_shared<FAnimCompressContext>(false, GAnimCompressionReport);
+	CompressContext->CompressedSizeBefore = GetApproxCompressedSize();
+
 	CompressedTrackOffsets.clear();
 	CompressedScaleOffsets.Empty();
 	CompressedByteStream.clear();
 	bUseRawDataOnly = true;
 
-	RequestSyncAnimRecompression(false);
+	RequestAnimCompression(false, CompressContext);
 }
 
 void UAnimSequence::RequestAnimCompression(bool bAsyncCompression, bool bAllowAlternateCompressor /*= false*/, bool bOutput /*= false*/)
@@ -261,8 +266,35 @@ void UAnimSequence::RequestAnimCompression(bool bAsyncCompression, std::shared_p
 
 	delete AnimCompressor;
 	AnimCompressor = nullptr;
+
+	if (GAnimCompressionReport && CompressContext->bOutput)
+	{
+		CompressContext->CompressionSummary.AppendToReport(GAnimCompressionReportFilename);
+	}
 }
 
+int32 UAnimSequence::GetApproxRawSize() const
+{
+	int32 Total = sizeof(FRawAnimSequenceTrack) * RawAnimationData.size();
+	for (uint32 i = 0; i < RawAnimationData.size(); ++i)
+	{
+		const FRawAnimSequenceTrack& RawTrack = RawAnimationData[i];
+		Total +=
+			sizeof(FVector) * RawTrack.PosKeys.size() +
+			sizeof(FQuat) * RawTrack.RotKeys.size() +
+			sizeof(FVector) * RawTrack.ScaleKeys.size();
+	}
+	return Total;
+}
+
+int32 UAnimSequence::GetApproxCompressedSize() const
+{
+	const int32 BasicSize = CompressedTrackOffsets.size() * sizeof(int32)
+		+ CompressedScaleOffsets.GetMemorySize()
+		+ CompressedByteStream.size();
+	return BasicSize;
+}
+
 bool UAnimSequence::IsCompressedDataValid() const
 {
 	return CompressedByteStream.size() > 0 || RawAnimationData.size() == 0 || (TranslationCompressionFormat == ACF_Identity && RotationCompressionFormat == ACF_Identity && ScaleCompressionFormat == ACF_Identity);
@@ -141,6 +141,8 @@ public:
 	EAdditiveBasePoseType RefPoseType;
 	bool bEnableRootMotion;
 	std::string RetargetSource;
+	/** Name the sequence was imported under, the animation name and the FBX animation stack, used by the compression report */
+	std::string SequenceName;
 
 	EAnimInterpolationType Interpolation;
 
@@ -199,6 +201,12 @@ public:
 		return CompressedTrackToSkeletonMapTable[TrackIndex].BoneTreeIndex;
 	}
 	const std::vector<FRawAnimSequenceTrack>& GetRawAnimationData() const { return RawAnimationData; }
+	const std::vector<FTrackToSkeletonMap>& GetRawTrackToSkeletonMapTable() const { return TrackToSkeletonMapTable; }
+
+	/** @return	The approximate size of raw animation data. */
+	int32 GetApproxRawSize() const;
+	/** @return	The approximate size of key-reduced animation data. */
+	int32 GetApproxCompressedSize() const;
 
 	bool OnlyUseRawData() const { return bUseRawDataOnly; }
 	void SetUseRawDataOnly(bool bInUseRawDataOnly) { bUseRawDataOnly = bInUseRawDataOnly; }
@@ -1,6 +1,7 @@
 #include "AnimSingleNodeInstanceProxy.h"
 #include "AnimationRuntime.h"
 #include "AnimSingleNodeInstance.h"
+#include "AnimPoseCache.h"
 
 void FAnimNode_SingleNode::Evaluate_AnyThread(FPoseContext& Output)
 {
@@ -38,8 +39,18 @@ void FAnimNode_SingleNode::Evaluate_AnyThread(FPoseContext& Output)
 			}
 			else
 			{
-				// if SkeletalMesh isn't there, we'll need to use skeleton
-				Sequence->GetAnimationPose(Output.Pose, Output.Curve, FAnimExtractContext(Proxy->CurrentTime, Sequence->bEnableRootMotion));
+				// instances playing this sequence at the same time this frame share one decoded pose
+				const float ExtractTime = GEnableAnimPoseCache ? GAnimPoseCache.QuantizeTime(Proxy->CurrentTime) : Proxy->CurrentTime;
+				if (!GEnableAnimPoseCache || !GAnimPoseCache.FindPose(Sequence, ExtractTime, Output.Pose, Output.Curve))
+				{
+					// if SkeletalMesh isn't there, we'll need to use skeleton
+					Sequence->GetAnimationPose(Output.Pose, Output.Curve, FAnimExtractContext(ExtractTime, Sequence->bEnableRootMotion));
+
+					if (GEnableAnimPoseCache)
+					{
+						GAnimPoseCache.AddPose(Sequence, ExtractTime, Output.Pose, Output.Curve);
+					}
+				}
 			}
 		}
 // 		else if (UAnimComposite* Composite = Cast<UAnimComposite>(Proxy->CurrentAsset))
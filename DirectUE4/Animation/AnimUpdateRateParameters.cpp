@@ -0,0 +1,38 @@
+#include "AnimUpdateRateParameters.h"
+#include "World.h"
+
+bool GEnableAnimUpdateRateOptimizations = false;
+
+void FAnimUpdateRateParameters::SetScreenSize(float DeltaTime, float InMaxDistanceFactor)
+{
+	MaxDistanceFactor = InMaxDistanceFactor;
+
+	int32 DesiredEvaluationRate = 1;
+	for (float DistanceFactorThreshold : BaseVisibleDistanceFactorThesholds)
+	{
+		if (MaxDistanceFactor > DistanceFactorThreshold)
+		{
+			break;
+		}
+		DesiredEvaluationRate++;
+	}
+
+	SetTrailMode(DeltaTime, UpdateRateShift, DesiredEvaluationRate, DesiredEvaluationRate, true);
+}
+
+void FAnimUpdateRateParameters::SetTrailMode(float DeltaTime, uint8 InUpdateRateShift, int32 NewUpdateRate, int32 NewEvaluationRate, bool bNewInterpSkippedFrames)
+{
+	// time of skipped ticks piles up until the next update consumes it
+	AdditionalTime = bSkipUpdate ? AdditionalTime + ThisTickDelta : 0.f;
+	ThisTickDelta = DeltaTime;
+	UpdateRateShift = InUpdateRateShift;
+
+	UpdateRate = FMath::Max(NewUpdateRate, 1);
+	// Make sure EvaluationRate is a multiple of UpdateRate.
+	EvaluationRate = FMath::Max((NewEvaluationRate / UpdateRate) * UpdateRate, 1);
+	bInterpolateSkippedFrames = bNewInterpSkippedFrames && (EvaluationRate < MaxEvalRateForInterpolation);
+
+	const uint32 Counter = GFrameCounter + UpdateRateShift;
+	bSkipUpdate = ((Counter % UpdateRate) > 0);
+	bSkipEvaluation = ((Counter % EvaluationRate) > 0);
+}
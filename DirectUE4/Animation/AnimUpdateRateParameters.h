@@ -0,0 +1,113 @@
+#pragma once
+
+#include "UnrealMath.h"
+#include <vector>
+
+/** Master switch for animation update rate optimizations, off unless -animupdaterate turns it on as they change animation output */
+extern bool GEnableAnimUpdateRateOptimizations;
+
+/**
+* Per component throttling of animation update and evaluation (URO).
+* Components that are small on screen only tick and evaluate their animation every EvaluationRate frames; the time of the
+* skipped frames is handed to the next update so playback speed is unchanged, and the frames in between can trail the
+* displayed pose towards the last evaluated one so the lower rate isn't visible as stepping.
+*/
+struct FAnimUpdateRateParameters
+{
+public:
+	/** How often animation will be updated/ticked. 1 = every frame, 2 = every 2 frames, etc. */
+	int32 UpdateRate;
+
+	/** How often animation will be evaluated. 1 = every frame, 2 = every 2 frames, etc.
+	*  has to be a multiple of UpdateRate. */
+	int32 EvaluationRate;
+
+	/** When skipping a frame, should it be interpolated or frozen? */
+	bool bInterpolateSkippedFrames;
+
+	/** (This frame) animation update should be skipped. */
+	bool bSkipUpdate;
+
+	/** (This frame) animation evaluation should be skipped. */
+	bool bSkipEvaluation;
+
+	/** Frame offset so components updated at the same rate don't all land on the same frame. */
+	uint8 UpdateRateShift;
+
+	/** Total time of the ticks skipped since the last update, added to the DeltaTime of the next update. */
+	float AdditionalTime;
+
+	/** DeltaTime of the tick the current rates were computed for. */
+	float ThisTickDelta;
+
+	/** Largest screen size over all views, as a fraction of the screen, from the last TickUpdateRate. */
+	float MaxDistanceFactor;
+
+	/**
+	* Screen size thresholds. Each one the component is at or below adds 1 to the evaluation rate, so with { 0.24, 0.12 }
+	* components bigger than 24% of the screen evaluate every frame, 12-24% every other frame, smaller every third frame.
+	*/
+	std::vector<float> BaseVisibleDistanceFactorThesholds;
+
+	/** Rates at or above this freeze skipped frames instead of interpolating them, the pose would trail too far behind. */
+	int32 MaxEvalRateForInterpolation;
+
+public:
+	FAnimUpdateRateParameters()
+		: UpdateRate(1)
+		, EvaluationRate(1)
+		, bInterpolateSkippedFrames(false)
+		, bSkipUpdate(false)
+		, bSkipEvaluation(false)
+		, UpdateRateShift(0)
+		, AdditionalTime(0.f)
+		, ThisTickDelta(0.f)
+		, MaxDistanceFactor(0.f)
+		, MaxEvalRateForInterpolation(4)
+	{
+		BaseVisibleDistanceFactorThesholds.push_back(0.24f);
+		BaseVisibleDistanceFactorThesholds.push_back(0.12f);
+	}
+
+	/** Picks the evaluation rate for InMaxDistanceFactor and sets up skipping for the current frame. */
+	void SetScreenSize(float DeltaTime, float InMaxDistanceFactor);
+
+	/** Sets update and evaluation rates directly, EvaluationRate is rounded down to a multiple of UpdateRate. */
+	void SetTrailMode(float DeltaTime, uint8 InUpdateRateShift, int32 NewUpdateRate, int32 NewEvaluationRate, bool bNewInterpSkippedFrames);
+
+	/* Getter for bSkipUpdate */
+	bool ShouldSkipUpdate() const
+	{
+		return bSkipUpdate;
+	}
+
+	/* Getter for bSkipEvaluation */
+	bool ShouldSkipEvaluation() const
+	{
+		return bSkipEvaluation;
+	}
+
+	/* Getter for bInterpolateSkippedFrames */
+	bool ShouldInterpolateSkippedFrames() const
+	{
+		return bInterpolateSkippedFrames;
+	}
+
+	/** Called when we're about to tick animation, time that has to be added to the DeltaTime of the update */
+	float GetTimeAdjustment() const
+	{
+		return AdditionalTime;
+	}
+
+	/** Are we doing evaluation rate optimization at all this frame */
+	bool DoEvaluationRateOptimizations() const
+	{
+		return EvaluationRate > 1;
+	}
+
+	/** Weight of the last evaluated pose when a frame trails the displayed pose towards it */
+	float GetInterpolationAlpha() const
+	{
+		return 0.25f + (1.f / float(FMath::Max(EvaluationRate, 2) * 2));
+	}
+};
@@ -75,3 +75,23 @@ void FAnimationRuntime::RetargetBoneTransform(const USkeleton* MySkeleton, const
 {
 
 }
+
+void FAnimationRuntime::LerpBoneTransforms(std::vector<FTransform>& A, const std::vector<FTransform>& B, float Alpha, const std::vector<FBoneIndexType>& RequiredBonesArray)
+{
+	if (FMath::Abs(Alpha) >= 1.f - ZERO_ANIMWEIGHT_THRESH)
+	{
+		A = B;
+	}
+	else if (FMath::Abs(Alpha) > ZERO_ANIMWEIGHT_THRESH)
+	{
+		assert(A.size() == B.size());
+		FTransform* ATransformData = A.data();
+		const FTransform* BTransformData = B.data();
+
+		for (uint32 Index = 0; Index < RequiredBonesArray.size(); Index++)
+		{
+			const int32 BoneIndex = RequiredBonesArray[Index];
+			ATransformData[BoneIndex].BlendWith(BTransformData[BoneIndex], Alpha);
+		}
+	}
+}
@@ -12,5 +12,7 @@ public:
 	static enum ETypeAdvanceAnim AdvanceTime(const bool& bAllowLooping, const float& MoveDelta, float& InOutTime, const float& EndTime);
 	static void ExcludeBonesWithNoParents(const std::vector<int32>& BoneIndices, const FReferenceSkeleton& RefSkeleton, std::vector<int32>& FilteredRequiredBones);
 	static void AccumulateAdditivePose(FCompactPose& BasePose, const FCompactPose& AdditivePose, FBlendedCurve& BaseCurve, const FBlendedCurve& AdditiveCurve, float Weight, enum EAdditiveAnimationType AdditiveType);
+	/** Blends every required bone of A towards the matching bone of B by Alpha, in place. Bones not in RequiredBonesArray are left untouched. */
+	static void LerpBoneTransforms(std::vector<FTransform>& A, const std::vector<FTransform>& B, float Alpha, const std::vector<FBoneIndexType>& RequiredBonesArray);
 	static void RetargetBoneTransform(const USkeleton* MySkeleton, const std::string& RetargetSource, FTransform& BoneTransform, const int32 SkeletonBoneIndex, const FCompactPoseBoneIndex& BoneIndex, const FBoneContainer& RequiredBones, const bool bIsBakedAdditive);
 };
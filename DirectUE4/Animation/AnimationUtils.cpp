@@ -1,6 +1,47 @@
 #include "AnimationUtils.h"
 #include "AnimSequence.h"
 #include "AnimCompress.h"
+#include "AnimCompress_RemoveLinearKeys.h"
+#include "AnimEncoding.h"
+#include "AnimationCompression.h"
+#include "ParallelFor.h"
+
+float GLinearKeyRemovalMaxError = 1.0f;
+
+/** Snapshot of the compressed data of a sequence, used to roll back a compression attempt that was rejected. */
+struct FCompressedAnimDataBackup
+{
+	AnimationCompressionFormat TranslationCompressionFormat;
+	AnimationCompressionFormat RotationCompressionFormat;
+	AnimationCompressionFormat ScaleCompressionFormat;
+	AnimationKeyFormat KeyEncodingFormat;
+	std::vector<int32> CompressedTrackOffsets;
+	FCompressedOffsetData CompressedScaleOffsets;
+	std::vector<uint8> CompressedByteStream;
+
+	void SaveFrom(const UAnimSequence* Seq)
+	{
+		TranslationCompressionFormat = Seq->TranslationCompressionFormat;
+		RotationCompressionFormat = Seq->RotationCompressionFormat;
+		ScaleCompressionFormat = Seq->ScaleCompressionFormat;
+		KeyEncodingFormat = Seq->KeyEncodingFormat;
+		CompressedTrackOffsets = Seq->CompressedTrackOffsets;
+		CompressedScaleOffsets = Seq->CompressedScaleOffsets;
+		CompressedByteStream = Seq->CompressedByteStream;
+	}
+
+	void RestoreTo(UAnimSequence* Seq) const
+	{
+		Seq->TranslationCompressionFormat = TranslationCompressionFormat;
+		Seq->RotationCompressionFormat = RotationCompressionFormat;
+		Seq->ScaleCompressionFormat = ScaleCompressionFormat;
+		Seq->KeyEncodingFormat = KeyEncodingFormat;
+		Seq->CompressedTrackOffsets = CompressedTrackOffsets;
+		Seq->CompressedScaleOffsets = CompressedScaleOffsets;
+		Seq->CompressedByteStream = CompressedByteStream;
+		AnimationFormat_SetInterfaceLinks(*Seq);
+	}
+};
 
 void FAnimationUtils::BuildSkeletonMetaData(USkeleton* Skeleton, std::vector<FBoneData>& OutBoneData)
 {
@@ -41,6 +82,7 @@ void FAnimationUtils::BuildSkeletonMetaData(USkeleton* Skeleton, std::vector<FBo
 
 		// See if a Socket is attached to that bone
 		BoneData.bHasSocket = false;
+		BoneData.bKeyEndEffector = false;
 		// @todo anim: socket isn't moved to Skeleton yet, but this code needs better testing
 // 		for (int32 SocketIndex = 0; SocketIndex < Skeleton->Sockets.Num(); SocketIndex++)
 // 		{
@@ -95,13 +137,158 @@ void FAnimationUtils::BuildSkeletonMetaData(USkeleton* Skeleton, std::vector<FBo
 	}
 }
 
+/** Per frame accumulation of ComputeCompressionError, reduced once all the frames are done. */
+struct FFrameCompressionError
+{
+	float ErrorTotal;
+	int32 ErrorCount;
+	float MaxError;
+	int32 MaxErrorBone;
+
+	FFrameCompressionError()
+		: ErrorTotal(0.f)
+		, ErrorCount(0)
+		, MaxError(0.f)
+		, MaxErrorBone(0)
+	{}
+};
+
 void FAnimationUtils::ComputeCompressionError(const UAnimSequence* AnimSeq, const std::vector<FBoneData>& BoneData, AnimationErrorStats& ErrorStats)
 {
-	ErrorStats.AverageError = 0.0f;
-	ErrorStats.MaxError = 0.0f;
-	ErrorStats.MaxErrorBone = 0;
-	ErrorStats.MaxErrorTime = 0.0f;
-	int32 MaxErrorTrack = -1;
+	ErrorStats.AverageError = 0.0f;
+	ErrorStats.MaxError = 0.0f;
+	ErrorStats.MaxErrorBone = 0;
+	ErrorStats.MaxErrorTime = 0.0f;
+
+	const std::vector<FRawAnimSequenceTrack>& RawAnimData = AnimSeq->GetRawAnimationData();
+	const int32 NumRawTracks = RawAnimData.size();
+	const int32 NumCompressedTracks = AnimSeq->CompressedTrackOffsets.size() / 4;
+	const int32 NumFrames = AnimSeq->NumFrames;
+	const int32 NumBones = BoneData.size();
+
+	// nothing to compare against
+	if (NumRawTracks == 0 || NumCompressedTracks == 0 || NumFrames <= 0 || NumBones == 0 || AnimSeq->RotationCodec == NULL)
+	{
+		return;
+	}
+
+	// map the bones to their raw and compressed tracks, bones without a track stay in ref pose
+	std::vector<int32> BoneToRawTrack(NumBones, INDEX_NONE);
+	std::vector<int32> BoneToCompressedTrack(NumBones, INDEX_NONE);
+	const std::vector<FTrackToSkeletonMap>& RawTrackMap = AnimSeq->GetRawTrackToSkeletonMapTable();
+	for (int32 TrackIndex = 0; TrackIndex < NumRawTracks && TrackIndex < (int32)RawTrackMap.size(); ++TrackIndex)
+	{
+		const int32 BoneIndex = RawTrackMap[TrackIndex].BoneTreeIndex;
+		if (IsValidIndex(BoneToRawTrack, BoneIndex))
+		{
+			BoneToRawTrack[BoneIndex] = TrackIndex;
+		}
+	}
+	for (int32 TrackIndex = 0; TrackIndex < NumCompressedTracks; ++TrackIndex)
+	{
+		const int32 BoneIndex = AnimSeq->GetSkeletonIndexFromCompressedDataTrackIndex(TrackIndex);
+		if (IsValidIndex(BoneToCompressedTrack, BoneIndex))
+		{
+			BoneToCompressedTrack[BoneIndex] = TrackIndex;
+		}
+	}
+
+	const float TimeStep = NumFrames > 1 ? AnimSeq->SequenceLength / (float)(NumFrames - 1) : 0.f;
+
+	// frames are independent of each other, so each one gets its own scratch poses and its own result slot
+	std::vector<FFrameCompressionError> FrameErrors(NumFrames);
+	ParallelFor(NumFrames, [&](int32 FrameIndex)
+	{
+		std::vector<FTransform> RawTransforms(NumBones);
+		std::vector<FTransform> NewTransforms(NumBones);
+		FFrameCompressionError& FrameError = FrameErrors[FrameIndex];
+		const float Time = FrameIndex * TimeStep;
+
+		for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+		{
+			const FBoneData& Bone = BoneData[BoneIndex];
+			const FTransform RefPose(Bone.Orientation, Bone.Position, FVector(1.f));
+
+			// raw keys are sampled exactly at the frame
+			FTransform RawAtom = RefPose;
+			const int32 RawTrackIndex = BoneToRawTrack[BoneIndex];
+			if (RawTrackIndex != INDEX_NONE)
+			{
+				const FRawAnimSequenceTrack& RawTrack = RawAnimData[RawTrackIndex];
+				if (RawTrack.PosKeys.size() > 0)
+				{
+					RawAtom.SetTranslation(RawTrack.PosKeys[FMath::Min<int32>(FrameIndex, RawTrack.PosKeys.size() - 1)]);
+				}
+				if (RawTrack.RotKeys.size() > 0)
+				{
+					RawAtom.SetRotation(RawTrack.RotKeys[FMath::Min<int32>(FrameIndex, RawTrack.RotKeys.size() - 1)]);
+				}
+				if (RawTrack.ScaleKeys.size() > 0)
+				{
+					RawAtom.SetScale3D(RawTrack.ScaleKeys[FMath::Min<int32>(FrameIndex, RawTrack.ScaleKeys.size() - 1)]);
+				}
+			}
+
+			// compressed keys go through the codecs exactly like at runtime
+			FTransform NewAtom = RefPose;
+			const int32 CompressedTrackIndex = BoneToCompressedTrack[BoneIndex];
+			if (CompressedTrackIndex != INDEX_NONE)
+			{
+				AnimationFormat_GetBoneAtom(NewAtom, *AnimSeq, CompressedTrackIndex, Time);
+			}
+
+			const int32 ParentIndex = Bone.GetParent();
+			if (ParentIndex != INDEX_NONE)
+			{
+				RawTransforms[BoneIndex] = RawAtom * RawTransforms[ParentIndex];
+				NewTransforms[BoneIndex] = NewAtom * NewTransforms[ParentIndex];
+			}
+			else
+			{
+				RawTransforms[BoneIndex] = RawAtom;
+				NewTransforms[BoneIndex] = NewAtom;
+			}
+
+			if (Bone.IsEndEffector())
+			{
+				// measure the error at the tip of a virtual bone, so rotation error shows up as translation error
+				const FVector VirtualBoneOffset(Bone.bHasSocket || Bone.bKeyEndEffector ? END_EFFECTOR_DUMMY_BONE_LENGTH_SOCKET : END_EFFECTOR_DUMMY_BONE_LENGTH);
+				const FTransform DummyBone(VirtualBoneOffset);
+				const FVector RawTip = (DummyBone * RawTransforms[BoneIndex]).GetLocation();
+				const FVector NewTip = (DummyBone * NewTransforms[BoneIndex]).GetLocation();
+
+				const float Error = (RawTip - NewTip).Size();
+				FrameError.ErrorTotal += Error;
+				FrameError.ErrorCount++;
+				if (Error > FrameError.MaxError)
+				{
+					FrameError.MaxError = Error;
+					FrameError.MaxErrorBone = BoneIndex;
+				}
+			}
+		}
+	});
+
+	// reduce in frame order so the result doesn't depend on the scheduling
+	float ErrorTotal = 0.f;
+	int32 ErrorCount = 0;
+	for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex)
+	{
+		const FFrameCompressionError& FrameError = FrameErrors[FrameIndex];
+		ErrorTotal += FrameError.ErrorTotal;
+		ErrorCount += FrameError.ErrorCount;
+		if (FrameError.MaxError > ErrorStats.MaxError)
+		{
+			ErrorStats.MaxError = FrameError.MaxError;
+			ErrorStats.MaxErrorBone = FrameError.MaxErrorBone;
+			ErrorStats.MaxErrorTime = FrameIndex * TimeStep;
+		}
+	}
+
+	if (ErrorCount > 0)
+	{
+		ErrorStats.AverageError = ErrorTotal / (float)ErrorCount;
+	}
 }
 
 void FAnimationUtils::CompressAnimSequence(UAnimSequence* AnimSeq, FAnimCompressContext& CompressContext)
@@ -173,18 +360,54 @@ void FAnimationUtils::CompressAnimSequenceExplicit(
 		FAnimationUtils::BuildSkeletonMetaData(Skeleton, BoneData);
 		FAnimationUtils::ComputeCompressionError(AnimSeq, BoneData, TrueOriginalErrorStats);
 
+		// the candidates below reduce silently, the stats are gathered once around the final choice
+		CompressContext.GatherPreCompressionStats(AnimSeq);
+
 		if ((bFirstRecompressUsingCurrentOrDefault && !bTryAlternateCompressor) || (AnimSeq->CompressedByteStream.size() == 0))
 		{
 			UAnimCompress* OriginalCompressionAlgorithm = FAnimationUtils::GetDefaultAnimationCompressionAlgorithm();
 
 			//AnimSeq->CompressionScheme = OriginalCompressionAlgorithm;
-			OriginalCompressionAlgorithm->Reduce(AnimSeq, CompressContext);
+			OriginalCompressionAlgorithm->Reduce(AnimSeq, false);
 			AnimSeq->SetUseRawDataOnly(false);
 			//AfterOriginalRecompression = AnimSeq->GetApproxCompressedSize();
 
 			// figure out our current compression error
 			FAnimationUtils::ComputeCompressionError(AnimSeq, BoneData, OriginalErrorStats);
 		}
+
+		CompressContext.GatherDefaultCompressionStats(AnimSeq);
+
+		// Try removing the keys that are linear interpolations of their neighbours, on every compression and not only when
+		// alternate compressors are allowed, with its own tolerance. The result is kept only if it is smaller and stays
+		// within tolerance, otherwise the previous data is restored.
+		if (GLinearKeyRemovalMaxError > 0.0f && bTryLinearKeyRemovalCompression && AnimSeq->CompressedByteStream.size() > 0)
+		{
+			const int32 CurrentSize = AnimSeq->GetApproxCompressedSize();
+
+			FCompressedAnimDataBackup Backup;
+			Backup.SaveFrom(AnimSeq);
+
+			UAnimCompress_RemoveLinearKeys LinearKeyRemover;
+			LinearKeyRemover.Reduce(AnimSeq, false);
+
+			AnimationErrorStats NewErrorStats;
+			FAnimationUtils::ComputeCompressionError(AnimSeq, BoneData, NewErrorStats);
+
+			const float MaxAllowedError = bRaiseMaxErrorToExisting ? FMath::Max(GLinearKeyRemovalMaxError, OriginalErrorStats.MaxError) : GLinearKeyRemovalMaxError;
+			const bool bWithinTolerance = NewErrorStats.MaxError <= MaxAllowedError;
+			const bool bSmaller = AnimSeq->GetApproxCompressedSize() < CurrentSize;
+			if (bWithinTolerance && bSmaller)
+			{
+				OriginalErrorStats = NewErrorStats;
+			}
+			else
+			{
+				Backup.RestoreTo(AnimSeq);
+			}
+		}
+
+		CompressContext.GatherPostCompressionStats(AnimSeq, BoneData);
 	}
 }
 static inline UAnimCompress* ConstructDefaultCompressionAlgorithm()
@@ -9,6 +9,12 @@
 class UAnimCompress;
 struct FAnimCompressContext;
 
+/**
+* Largest end effector error, in world units, the linear key removal pass may leave in a sequence. It runs on every
+* compression, including the one after import, whether or not alternate compressors are allowed; 0 turns it off.
+*/
+extern float GLinearKeyRemovalMaxError;
+
 class FBoneData
 {
 public:
@@ -0,0 +1,344 @@
+#include "BakedAnimation.h"
+#include "UnrealTemplates.h"
+#include "log.h"
+#include <fstream>
+
+/** 'BAKA' */
+static const uint32 BakedAnimationMagic = 0x414B4142;
+/** Change this whenever the layout of the file or the way frames are baked changes */
+static const uint32 BakedAnimationVersion = 2;
+
+static void MatrixToElements(const FMatrix& InMatrix, float* OutElements)
+{
+	for (int32 Row = 0; Row < 4; ++Row)
+	{
+		for (int32 Column = 0; Column < 3; ++Column)
+		{
+			OutElements[Row * 3 + Column] = InMatrix.M[Row][Column];
+		}
+	}
+}
+
+static void ElementsToMatrix(const float* InElements, FMatrix& OutMatrix)
+{
+	for (int32 Row = 0; Row < 4; ++Row)
+	{
+		for (int32 Column = 0; Column < 3; ++Column)
+		{
+			OutMatrix.M[Row][Column] = InElements[Row * 3 + Column];
+		}
+		OutMatrix.M[Row][3] = (Row == 3) ? 1.f : 0.f;
+	}
+}
+
+FBakedAnimationReport::FBakedAnimationReport()
+	: NumBones(0)
+	, NumFrames(0)
+	, RawSize(0)
+	, BakedSize(0)
+	, MaxMatrixError(0.f)
+	, AverageMatrixError(0.f)
+	, MaxPositionError(0.f)
+	, MaxPositionErrorBone(INDEX_NONE)
+	, MaxPositionErrorFrame(INDEX_NONE)
+{
+}
+
+void FBakedAnimationReport::Log() const
+{
+	X_LOG("BakedAnimation: %d bones x %d frames, raw %u B, baked %u B (%.1f%%), matrix error avg %f max %f, position error max %f at bone %d frame %d\n",
+		NumBones, NumFrames, RawSize, BakedSize, RawSize > 0 ? 100.f * BakedSize / RawSize : 0.f,
+		AverageMatrixError, MaxMatrixError, MaxPositionError, MaxPositionErrorBone, MaxPositionErrorFrame);
+}
+
+FBakedAnimationData::FBakedAnimationData()
+	: SampleRate(30.f)
+	, NumBones(0)
+{
+}
+
+void FBakedAnimationData::Reset()
+{
+	Sequences.clear();
+	BoneRanges.clear();
+	FrameData.clear();
+	NumBones = 0;
+}
+
+int32 FBakedAnimationData::GetNumFrames(float SequenceLength, float SampleRate)
+{
+	return FMath::CeilToInt(SequenceLength * SampleRate) + 1;
+}
+
+bool FBakedAnimationData::BakeFromReferenceToLocal(int32 InNumBones, float InSampleRate, const std::vector<float>& InSequenceLengths, const std::vector<FMatrix>& InReferenceToLocal,
+	const std::vector<FVector>& InBindPoseBonePositions, FBakedAnimationReport* OutReport)
+{
+	Sequences.clear();
+	BoneRanges.clear();
+	FrameData.clear();
+	NumBones = 0;
+
+	if (InNumBones <= 0 || InSequenceLengths.size() == 0 || InSampleRate <= 0.f)
+	{
+		return false;
+	}
+
+	NumBones = InNumBones;
+	SampleRate = InSampleRate;
+	assert((int32)InBindPoseBonePositions.size() == NumBones);
+
+	int32 TotalNumFrames = 0;
+	for (const float SequenceLength : InSequenceLengths)
+	{
+		FBakedAnimSequence BakedSequence;
+		BakedSequence.SequenceLength = SequenceLength;
+		BakedSequence.NumFrames = GetNumFrames(SequenceLength, SampleRate);
+		BakedSequence.FirstFrame = TotalNumFrames;
+		TotalNumFrames += BakedSequence.NumFrames;
+		Sequences.push_back(BakedSequence);
+	}
+	assert(InReferenceToLocal.size() == (size_t)TotalNumFrames * NumBones);
+
+	// full precision samples, quantized once the range of every bone is known
+	std::vector<float> Samples(InReferenceToLocal.size() * BAKED_BONE_MATRIX_ELEMENTS);
+	for (uint32 MatrixIndex = 0; MatrixIndex < InReferenceToLocal.size(); ++MatrixIndex)
+	{
+		MatrixToElements(InReferenceToLocal[MatrixIndex], &Samples[MatrixIndex * BAKED_BONE_MATRIX_ELEMENTS]);
+	}
+
+	// per bone, per element range over all frames
+	BoneRanges.resize(NumBones);
+	for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+	{
+		FBakedBoneRange& Range = BoneRanges[BoneIndex];
+		for (int32 Element = 0; Element < BAKED_BONE_MATRIX_ELEMENTS; ++Element)
+		{
+			float MinValue = MAX_flt;
+			float MaxValue = -MAX_flt;
+			for (int32 Frame = 0; Frame < TotalNumFrames; ++Frame)
+			{
+				const float Value = Samples[(Frame * NumBones + BoneIndex) * BAKED_BONE_MATRIX_ELEMENTS + Element];
+				MinValue = FMath::Min(MinValue, Value);
+				MaxValue = FMath::Max(MaxValue, Value);
+			}
+			Range.Min[Element] = MinValue;
+			Range.Scale[Element] = (MaxValue - MinValue) / (float)MAX_uint16;
+		}
+	}
+
+	FrameData.resize(Samples.size());
+	for (uint32 SampleIndex = 0; SampleIndex < Samples.size(); ++SampleIndex)
+	{
+		const int32 BoneIndex = (SampleIndex / BAKED_BONE_MATRIX_ELEMENTS) % NumBones;
+		const int32 Element = SampleIndex % BAKED_BONE_MATRIX_ELEMENTS;
+		const FBakedBoneRange& Range = BoneRanges[BoneIndex];
+		const int32 Quantized = Range.Scale[Element] > 0.f ? FMath::RoundToInt((Samples[SampleIndex] - Range.Min[Element]) / Range.Scale[Element]) : 0;
+		FrameData[SampleIndex] = (uint16)FMath::Clamp(Quantized, 0, (int32)MAX_uint16);
+	}
+
+	if (OutReport)
+	{
+		FBakedAnimationReport& Report = *OutReport;
+		Report = FBakedAnimationReport();
+		Report.NumBones = NumBones;
+		Report.NumFrames = TotalNumFrames;
+		Report.RawSize = Samples.size() * sizeof(float);
+		Report.BakedSize = GetDataSize();
+
+		// a vertex on the bone in the bind pose, the error of its skinned position is what ends up on screen
+		double TotalError = 0.0;
+		std::vector<FMatrix> DecodedFrame;
+		for (int32 Frame = 0; Frame < TotalNumFrames; ++Frame)
+		{
+			DecodeFrame(Frame, DecodedFrame);
+			for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+			{
+				const float* SourceElements = &Samples[(Frame * NumBones + BoneIndex) * BAKED_BONE_MATRIX_ELEMENTS];
+				float DecodedElements[BAKED_BONE_MATRIX_ELEMENTS];
+				MatrixToElements(DecodedFrame[BoneIndex], DecodedElements);
+				for (int32 Element = 0; Element < BAKED_BONE_MATRIX_ELEMENTS; ++Element)
+				{
+					const float Error = FMath::Abs(DecodedElements[Element] - SourceElements[Element]);
+					Report.MaxMatrixError = FMath::Max(Report.MaxMatrixError, Error);
+					TotalError += Error;
+				}
+
+				FMatrix SourceMatrix;
+				ElementsToMatrix(SourceElements, SourceMatrix);
+				const FVector& BonePosition = InBindPoseBonePositions[BoneIndex];
+				const Vector4 SourcePosition = SourceMatrix.TransformPosition(BonePosition);
+				const Vector4 DecodedPosition = DecodedFrame[BoneIndex].TransformPosition(BonePosition);
+				const float PositionError = (FVector(SourcePosition.X, SourcePosition.Y, SourcePosition.Z) - FVector(DecodedPosition.X, DecodedPosition.Y, DecodedPosition.Z)).Size();
+				if (PositionError > Report.MaxPositionError)
+				{
+					Report.MaxPositionError = PositionError;
+					Report.MaxPositionErrorBone = BoneIndex;
+					Report.MaxPositionErrorFrame = Frame;
+				}
+			}
+		}
+		Report.AverageMatrixError = Samples.size() > 0 ? (float)(TotalError / Samples.size()) : 0.f;
+	}
+
+	return TotalNumFrames > 0;
+}
+
+void FBakedAnimationData::DecodeFrame(int32 FrameIndex, std::vector<FMatrix>& OutReferenceToLocal) const
+{
+	OutReferenceToLocal.resize(NumBones);
+
+	const uint16* FrameElements = &FrameData[FrameIndex * NumBones * BAKED_BONE_MATRIX_ELEMENTS];
+	for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+	{
+		const FBakedBoneRange& Range = BoneRanges[BoneIndex];
+		const uint16* BoneElements = FrameElements + BoneIndex * BAKED_BONE_MATRIX_ELEMENTS;
+		float Elements[BAKED_BONE_MATRIX_ELEMENTS];
+		for (int32 Element = 0; Element < BAKED_BONE_MATRIX_ELEMENTS; ++Element)
+		{
+			Elements[Element] = Range.Min[Element] + BoneElements[Element] * Range.Scale[Element];
+		}
+		ElementsToMatrix(Elements, OutReferenceToLocal[BoneIndex]);
+	}
+}
+
+void FBakedAnimationData::SampleReferenceToLocal(int32 SequenceIndex, float Time, bool bLooping, std::vector<FMatrix>& OutReferenceToLocal) const
+{
+	assert(IsValidIndex(Sequences, SequenceIndex));
+	const FBakedAnimSequence& Sequence = Sequences[SequenceIndex];
+
+	if (bLooping && Sequence.SequenceLength > 0.f)
+	{
+		Time = FMath::Fmod(Time, Sequence.SequenceLength);
+		if (Time < 0.f)
+		{
+			Time += Sequence.SequenceLength;
+		}
+	}
+	else
+	{
+		Time = FMath::Clamp(Time, 0.f, Sequence.SequenceLength);
+	}
+
+	// the last frame sits at SequenceLength, so the final interval can be shorter than the others
+	const int32 Frame0 = FMath::Min(FMath::FloorToInt(Time * SampleRate), Sequence.NumFrames - 1);
+	const int32 Frame1 = FMath::Min(Frame0 + 1, Sequence.NumFrames - 1);
+	const float Time0 = Frame0 / SampleRate;
+	const float Time1 = FMath::Min(Frame1 / SampleRate, Sequence.SequenceLength);
+	const float Alpha = (Time1 > Time0) ? FMath::Clamp((Time - Time0) / (Time1 - Time0), 0.f, 1.f) : 0.f;
+
+	OutReferenceToLocal.resize(NumBones);
+
+	const uint16* Frame0Elements = &FrameData[(Sequence.FirstFrame + Frame0) * NumBones * BAKED_BONE_MATRIX_ELEMENTS];
+	const uint16* Frame1Elements = &FrameData[(Sequence.FirstFrame + Frame1) * NumBones * BAKED_BONE_MATRIX_ELEMENTS];
+	for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+	{
+		const FBakedBoneRange& Range = BoneRanges[BoneIndex];
+		const int32 ElementOffset = BoneIndex * BAKED_BONE_MATRIX_ELEMENTS;
+		float Elements[BAKED_BONE_MATRIX_ELEMENTS];
+		for (int32 Element = 0; Element < BAKED_BONE_MATRIX_ELEMENTS; ++Element)
+		{
+			// blend in quantized space, the range is the same for both frames
+			const float Quantized = FMath::Lerp((float)Frame0Elements[ElementOffset + Element], (float)Frame1Elements[ElementOffset + Element], Alpha);
+			Elements[Element] = Range.Min[Element] + Quantized * Range.Scale[Element];
+		}
+		ElementsToMatrix(Elements, OutReferenceToLocal[BoneIndex]);
+	}
+}
+
+uint32 FBakedAnimationData::GetDataSize() const
+{
+	return FrameData.size() * sizeof(uint16) + BoneRanges.size() * sizeof(FBakedBoneRange) + Sequences.size() * sizeof(FBakedAnimSequence);
+}
+
+bool FBakedAnimationData::SaveToFile(const std::string& Filename) const
+{
+	std::ofstream Out(Filename, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!Out.is_open())
+	{
+		X_LOG("Failed to write the baked animation %s\n", Filename.c_str());
+		return false;
+	}
+
+	const uint32 NumSequences = Sequences.size();
+	const uint32 NumElements = FrameData.size();
+	Out.write((const char*)&BakedAnimationMagic, sizeof(BakedAnimationMagic));
+	Out.write((const char*)&BakedAnimationVersion, sizeof(BakedAnimationVersion));
+	Out.write((const char*)SourceHash.Hash, sizeof(SourceHash.Hash));
+	Out.write((const char*)&SampleRate, sizeof(SampleRate));
+	Out.write((const char*)&NumBones, sizeof(NumBones));
+	Out.write((const char*)&NumSequences, sizeof(NumSequences));
+	Out.write((const char*)&NumElements, sizeof(NumElements));
+	Out.write((const char*)Sequences.data(), NumSequences * sizeof(FBakedAnimSequence));
+	Out.write((const char*)BoneRanges.data(), BoneRanges.size() * sizeof(FBakedBoneRange));
+	Out.write((const char*)FrameData.data(), NumElements * sizeof(uint16));
+	return Out.good();
+}
+
+bool FBakedAnimationData::LoadFromFile(const std::string& Filename)
+{
+	Reset();
+
+	std::ifstream In(Filename, std::ios::in | std::ios::binary | std::ios::ate);
+	if (!In.is_open())
+	{
+		return false;
+	}
+	const uint64 FileSize = (uint64)In.tellg();
+	In.seekg(0, std::ios::beg);
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	In.read((char*)&Magic, sizeof(Magic));
+	In.read((char*)&Version, sizeof(Version));
+	if (!In.good() || Magic != BakedAnimationMagic || Version != BakedAnimationVersion)
+	{
+		X_LOG("%s is not a baked animation of version %u\n", Filename.c_str(), BakedAnimationVersion);
+		return false;
+	}
+
+	int32 FileNumBones = 0;
+	uint32 NumSequences = 0;
+	uint32 NumElements = 0;
+	In.read((char*)SourceHash.Hash, sizeof(SourceHash.Hash));
+	In.read((char*)&SampleRate, sizeof(SampleRate));
+	In.read((char*)&FileNumBones, sizeof(FileNumBones));
+	In.read((char*)&NumSequences, sizeof(NumSequences));
+	In.read((char*)&NumElements, sizeof(NumElements));
+
+	// the counts decide how much is allocated and read, so they have to match the file before anything else is
+	const uint64 HeaderSize = sizeof(Magic) + sizeof(Version) + sizeof(SourceHash.Hash) + sizeof(SampleRate) + sizeof(FileNumBones) + sizeof(NumSequences) + sizeof(NumElements);
+	const uint64 ElementsPerFrame = (uint64)FMath::Max(FileNumBones, 0) * BAKED_BONE_MATRIX_ELEMENTS;
+	const uint64 ExpectedFileSize = HeaderSize + (uint64)NumSequences * sizeof(FBakedAnimSequence) + (uint64)FMath::Max(FileNumBones, 0) * sizeof(FBakedBoneRange) + (uint64)NumElements * sizeof(uint16);
+	if (!In.good() || !(SampleRate > 0.f) || FileNumBones <= 0 || NumSequences == 0 || NumElements == 0 || NumElements % ElementsPerFrame != 0 || ExpectedFileSize != FileSize)
+	{
+		X_LOG("%s is a corrupt baked animation: %d bones, %u sequences, %u elements in %llu bytes\n", Filename.c_str(), FileNumBones, NumSequences, NumElements, FileSize);
+		return false;
+	}
+
+	Sequences.resize(NumSequences);
+	BoneRanges.resize(FileNumBones);
+	FrameData.resize(NumElements);
+	In.read((char*)Sequences.data(), NumSequences * sizeof(FBakedAnimSequence));
+	In.read((char*)BoneRanges.data(), BoneRanges.size() * sizeof(FBakedBoneRange));
+	In.read((char*)FrameData.data(), NumElements * sizeof(uint16));
+	if (!In.good())
+	{
+		Reset();
+		return false;
+	}
+
+	// every sequence has to stay inside the frames, playback indexes them without checking
+	const int64 TotalNumFrames = NumElements / ElementsPerFrame;
+	for (const FBakedAnimSequence& Sequence : Sequences)
+	{
+		if (Sequence.NumFrames <= 0 || Sequence.FirstFrame < 0 || (int64)Sequence.FirstFrame + Sequence.NumFrames > TotalNumFrames || !(Sequence.SequenceLength >= 0.f))
+		{
+			X_LOG("%s is a corrupt baked animation: a sequence has frames [%d, %d) of %lld\n", Filename.c_str(), Sequence.FirstFrame, Sequence.FirstFrame + Sequence.NumFrames, TotalNumFrames);
+			Reset();
+			return false;
+		}
+	}
+
+	NumBones = FileNumBones;
+	return true;
+}
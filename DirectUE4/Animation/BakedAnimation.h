@@ -0,0 +1,116 @@
+#pragma once
+
+#include "UnrealMath.h"
+#include "SecureHash.h"
+#include <vector>
+#include <string>
+
+class USkeletalMesh;
+class UAnimSequence;
+
+/** Rows of a ReferenceToLocal matrix that are baked, the last column is always (0,0,0,1) */
+#define BAKED_BONE_MATRIX_ELEMENTS 12
+
+/** One baked sequence, its frames are stored back to back in FBakedAnimationData */
+struct FBakedAnimSequence
+{
+	float SequenceLength;
+	int32 NumFrames;
+	/** Index of the sequence's first frame in the baked frames */
+	int32 FirstFrame;
+};
+
+/** Quantization range of a bone, every element is stored as Min + Quantized * Scale */
+struct FBakedBoneRange
+{
+	float Min[BAKED_BONE_MATRIX_ELEMENTS];
+	float Scale[BAKED_BONE_MATRIX_ELEMENTS];
+};
+
+/** Size and accuracy of a bake */
+struct FBakedAnimationReport
+{
+	int32 NumBones;
+	int32 NumFrames;
+	/** Bytes the frames would take as float 3x4 matrices */
+	uint32 RawSize;
+	/** Bytes of the quantized frames and ranges */
+	uint32 BakedSize;
+	/** Largest and average absolute error of a quantized matrix element */
+	float MaxMatrixError;
+	float AverageMatrixError;
+	/** Largest distance a vertex sitting on its bone is moved by quantization */
+	float MaxPositionError;
+	int32 MaxPositionErrorBone;
+	int32 MaxPositionErrorFrame;
+
+	FBakedAnimationReport();
+
+	void Log() const;
+};
+
+/**
+* Animation baked into ReferenceToLocal bone matrices, for crowds too far away to pay for full pose evaluation.
+* Sequences are sampled at a fixed rate offline; every bone matrix of every frame is quantized to 16 bit per element
+* against the bone's range over all frames. Playback only decodes and blends two frames, so every instance just needs
+* its own time. None of this touches the renderer, baking and sampling run without a device; only sampling the
+* sequences (BakedAnimationSampling.cpp) needs a mesh and its animations, the quantization and playback work on plain matrices.
+*/
+class FBakedAnimationData
+{
+public:
+	FBakedAnimationData();
+
+	/**
+	* Samples every sequence at InSampleRate frames per second (and at its last frame) for the bones of InMesh.
+	* @param	OutReport - optional, filled with the size and the quantization error of the bake
+	* @return	false if the mesh has no skeleton or nothing was baked
+	*/
+	bool Bake(USkeletalMesh* InMesh, const std::vector<UAnimSequence*>& InSequences, float InSampleRate, FBakedAnimationReport* OutReport = nullptr);
+
+	/**
+	* Quantizes ReferenceToLocal matrices that are sampled already.
+	* @param	InSequenceLengths - length of every sequence, its GetNumFrames frames follow each other in InReferenceToLocal
+	* @param	InReferenceToLocal - InNumBones matrices per frame
+	* @param	InBindPoseBonePositions - bind pose position of every bone, where the report measures the position error
+	*/
+	bool BakeFromReferenceToLocal(int32 InNumBones, float InSampleRate, const std::vector<float>& InSequenceLengths, const std::vector<FMatrix>& InReferenceToLocal,
+		const std::vector<FVector>& InBindPoseBonePositions, FBakedAnimationReport* OutReport = nullptr);
+
+	/** Frames a sequence is baked into, one every 1 / SampleRate seconds plus one at SequenceLength */
+	static int32 GetNumFrames(float SequenceLength, float SampleRate);
+
+	/** Decodes the frame pair around Time of a sequence and blends between them */
+	void SampleReferenceToLocal(int32 SequenceIndex, float Time, bool bLooping, std::vector<FMatrix>& OutReferenceToLocal) const;
+
+	/** Decodes a single baked frame */
+	void DecodeFrame(int32 FrameIndex, std::vector<FMatrix>& OutReferenceToLocal) const;
+
+	bool SaveToFile(const std::string& Filename) const;
+
+	/** Reads a blob written by SaveToFile, returns false and stays empty if it is of another version or its sizes don't add up */
+	bool LoadFromFile(const std::string& Filename);
+
+	/** Hash of the files the animation was baked from, saved with it so a stale blob can be told apart */
+	void SetSourceHash(const FSHAHash& InSourceHash) { SourceHash = InSourceHash; }
+	const FSHAHash& GetSourceHash() const { return SourceHash; }
+
+	/** Bytes taken by the baked frames and ranges */
+	uint32 GetDataSize() const;
+
+	float GetSampleRate() const { return SampleRate; }
+	int32 GetNumBones() const { return NumBones; }
+	int32 GetNumSequences() const { return Sequences.size(); }
+	const FBakedAnimSequence& GetSequence(int32 SequenceIndex) const { return Sequences[SequenceIndex]; }
+
+private:
+	void Reset();
+
+	FSHAHash SourceHash;
+	float SampleRate;
+	int32 NumBones;
+	std::vector<FBakedAnimSequence> Sequences;
+	std::vector<FBakedBoneRange> BoneRanges;
+	/** NumFrames * NumBones * BAKED_BONE_MATRIX_ELEMENTS quantized elements */
+	std::vector<uint16> FrameData;
+};
@@ -0,0 +1,62 @@
+#include "BakedAnimation.h"
+#include "SkeletalMesh.h"
+#include "AnimSequence.h"
+#include "BonePose.h"
+#include "AnimCurveTypes.h"
+
+bool FBakedAnimationData::Bake(USkeletalMesh* InMesh, const std::vector<UAnimSequence*>& InSequences, float InSampleRate, FBakedAnimationReport* OutReport)
+{
+	if (InMesh == nullptr || InMesh->Skeleton == nullptr || InSequences.size() == 0 || InSampleRate <= 0.f)
+	{
+		Reset();
+		return false;
+	}
+
+	const FReferenceSkeleton& RefSkeleton = InMesh->RefSkeleton;
+	const int32 NumMeshBones = RefSkeleton.GetNum();
+	assert((int32)InMesh->RefBasesInvMatrix.size() == NumMeshBones);
+
+	// every bone of the mesh, so compact pose indices are mesh bone indices
+	std::vector<FBoneIndexType> AllBones(NumMeshBones);
+	for (int32 BoneIndex = 0; BoneIndex < NumMeshBones; ++BoneIndex)
+	{
+		AllBones[BoneIndex] = (FBoneIndexType)BoneIndex;
+	}
+	FBoneContainer BoneContainer(AllBones, FCurveEvaluationOption(false), InMesh);
+	FCompactPose Pose;
+	Pose.SetBoneContainer(&BoneContainer);
+	FBlendedCurve Curve;
+	Curve.InitFrom(BoneContainer);
+
+	std::vector<float> SequenceLengths;
+	std::vector<FMatrix> ReferenceToLocal;
+	std::vector<FTransform> ComponentSpaceTransforms(NumMeshBones);
+	for (UAnimSequence* Sequence : InSequences)
+	{
+		SequenceLengths.push_back(Sequence->SequenceLength);
+
+		const int32 SequenceNumFrames = GetNumFrames(Sequence->SequenceLength, InSampleRate);
+		for (int32 Frame = 0; Frame < SequenceNumFrames; ++Frame)
+		{
+			const float Time = FMath::Min(Frame / InSampleRate, Sequence->SequenceLength);
+			Sequence->GetAnimationPose(Pose, Curve, FAnimExtractContext(Time, Sequence->bEnableRootMotion));
+
+			for (int32 BoneIndex = 0; BoneIndex < NumMeshBones; ++BoneIndex)
+			{
+				const FTransform& LocalTransform = Pose[FCompactPoseBoneIndex(BoneIndex)];
+				const int32 ParentIndex = RefSkeleton.GetParentIndex(BoneIndex);
+				ComponentSpaceTransforms[BoneIndex] = (ParentIndex == INDEX_NONE) ? LocalTransform : LocalTransform * ComponentSpaceTransforms[ParentIndex];
+
+				ReferenceToLocal.push_back(InMesh->RefBasesInvMatrix[BoneIndex] * ComponentSpaceTransforms[BoneIndex].ToMatrixWithScale());
+			}
+		}
+	}
+
+	std::vector<FVector> BindPoseBonePositions(NumMeshBones);
+	for (int32 BoneIndex = 0; BoneIndex < NumMeshBones; ++BoneIndex)
+	{
+		BindPoseBonePositions[BoneIndex] = InMesh->RefBasesInvMatrix[BoneIndex].Inverse().GetOrigin();
+	}
+
+	return BakeFromReferenceToLocal(NumMeshBones, InSampleRate, SequenceLengths, ReferenceToLocal, BindPoseBonePositions, OutReport);
+}
@@ -7,6 +7,7 @@ FBoneContainer::FBoneContainer()
 	, AssetSkeletalMesh(nullptr)
 	, AssetSkeleton(nullptr)
 	, RefSkeleton(nullptr)
+	, BoneIndicesHash(0)
 	, bDisableRetargeting(false)
 	, bUseRAWData(false)
 	, bUseSourceData(false)
@@ -104,6 +105,13 @@ void FBoneContainer::Initialize(const FCurveEvaluationOption& CurveEvalOption)
 		BoneSwitchArray[BoneIndex] = true;
 	}
 
+	// FNV-1a over the required bones, two containers with the same hash and asset build the same compact pose
+	BoneIndicesHash = 2166136261u;
+	for (const FBoneIndexType BoneIndex : BoneIndicesArray)
+	{
+		BoneIndicesHash = (BoneIndicesHash ^ BoneIndex) * 16777619u;
+	}
+
 	// Clear remapping table
 	SkeletonToPoseBoneIndexArray.clear();
 		
@@ -95,6 +95,7 @@ struct FBoneContainer
 	std::vector<FTransform>    CompactPoseRefPoseBones;
 	std::vector<FVirtualBoneCompactPoseData> VirtualBoneCompactPoseData;
 	std::vector<uint16> UIDToArrayIndexLUT;
+	uint32 BoneIndicesHash;
 	bool bDisableRetargeting;
 	bool bUseRAWData;
 	bool bUseSourceData;
@@ -147,6 +148,11 @@ public:
 	{
 		return BoneIndicesArray;
 	}
+	/** Hash of BoneIndicesArray, computed when the container is initialized */
+	uint32 GetBoneIndicesHash() const
+	{
+		return BoneIndicesHash;
+	}
 	const std::vector<FVirtualBoneCompactPoseData>& GetVirtualBoneCompactPoseData() const { return VirtualBoneCompactPoseData; }
 	const std::vector<bool>& GetBoneSwitchArray() const
 	{
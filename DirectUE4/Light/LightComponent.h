@@ -4,17 +4,6 @@
 #include "SceneManagement.h"
 #include "SceneView.h"
 
-enum ELightComponentType
-{
-	LightType_Directional = 0,
-	LightType_Point,
-	LightType_Spot,
-	LightType_Rect,
-	LightType_MAX,
-	LightType_NumBits = 2
-};
-
-
 
 class AActor;
 class UPrimitiveComponent;
@@ -1,5 +1,5 @@
 #include "ConvexVolume.h"
-#include "UnrealMathFPU.h"
+#include "VectorRegister.h"
 
 void FConvexVolume::Init(void)
 {
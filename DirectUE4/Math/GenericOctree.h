@@ -0,0 +1,357 @@
+#pragma once
+
+#include "UnrealMath.h"
+#include "ConvexVolume.h"
+
+#include <vector>
+
+/** Where an element lives in a TOctree. It changes as the octree splits and merges nodes, the semantics are told every time. */
+class FOctreeElementId
+{
+public:
+	FOctreeElementId()
+		: NodeIndex(INDEX_NONE)
+		, ElementIndex(INDEX_NONE)
+	{}
+
+	bool IsValidId() const { return NodeIndex != INDEX_NONE; }
+
+private:
+	template<typename, typename> friend class TOctree;
+
+	FOctreeElementId(int32 InNodeIndex, int32 InElementIndex)
+		: NodeIndex(InNodeIndex)
+		, ElementIndex(InElementIndex)
+	{}
+
+	/** Index of the node holding the element */
+	int32 NodeIndex;
+	/** Index of the element in the node's elements */
+	int32 ElementIndex;
+};
+
+/**
+* A loose octree of elements with box bounds, in the spirit of UE4's TOctree.
+* Every node's elements are within twice the node's extent of its center, so an element is stored in the deepest node whose
+* cell contains its center and whose cell size is at least the element's size; elements that don't fit the root cell at all
+* stay in the root. Leaves split once they hold more than MaxElementsPerLeaf elements, and a subtree holding fewer than
+* MinInclusiveElementsPerNode elements is merged back into its root.
+*
+* OctreeSemantics has to provide:
+*	enum { MaxElementsPerLeaf = 16 };
+*	enum { MinInclusiveElementsPerNode = 7 };
+*	enum { MaxNodeDepth = 12 };
+*	static const FBoxSphereBounds& GetBounds(const ElementType& Element);	(or FBoxSphereBounds by value)
+*	static void SetElementId(const ElementType& Element, FOctreeElementId Id);
+*/
+template<typename ElementType, typename OctreeSemantics>
+class TOctree
+{
+public:
+	/**
+	* @param InOrigin - center of the root cell
+	* @param InExtent - half the size of the root cell
+	*/
+	TOctree(const FVector& InOrigin, float InExtent)
+	{
+		Nodes.push_back(FNode());
+		Nodes[0].Center = InOrigin;
+		Nodes[0].Extent = InExtent;
+	}
+
+	/** Adds an element, its id is passed to OctreeSemantics::SetElementId */
+	void AddElement(const ElementType& Element)
+	{
+		const FBoxSphereBounds& Bounds = OctreeSemantics::GetBounds(Element);
+
+		int32 NodeIndex = 0;
+		for (;;)
+		{
+			Nodes[NodeIndex].InclusiveNumElements++;
+			const int32 ChildIndex = FindChildForBounds(NodeIndex, Bounds);
+			if (ChildIndex == INDEX_NONE)
+			{
+				break;
+			}
+			NodeIndex = ChildIndex;
+		}
+
+		FNode& Node = Nodes[NodeIndex];
+		Node.Elements.push_back(Element);
+		OctreeSemantics::SetElementId(Element, FOctreeElementId(NodeIndex, (int32)Node.Elements.size() - 1));
+
+		if (Node.FirstChild == INDEX_NONE && (int32)Node.Elements.size() > OctreeSemantics::MaxElementsPerLeaf && Node.Depth < OctreeSemantics::MaxNodeDepth)
+		{
+			SplitNode(NodeIndex);
+		}
+	}
+
+	/** Removes the element with the given id, the ids of the elements that move because of it are passed to OctreeSemantics::SetElementId */
+	void RemoveElement(FOctreeElementId Id)
+	{
+		assert(Id.IsValidId() && Id.ElementIndex < (int32)Nodes[Id.NodeIndex].Elements.size());
+
+		std::vector<ElementType>& Elements = Nodes[Id.NodeIndex].Elements;
+		if (Id.ElementIndex != (int32)Elements.size() - 1)
+		{
+			Elements[Id.ElementIndex] = Elements.back();
+			OctreeSemantics::SetElementId(Elements[Id.ElementIndex], Id);
+		}
+		Elements.pop_back();
+
+		// Inclusive counts only grow towards the root, so the nodes to merge are the ones below the first big enough ancestor
+		int32 CollapseNodeIndex = INDEX_NONE;
+		for (int32 NodeIndex = Id.NodeIndex; NodeIndex != INDEX_NONE; NodeIndex = Nodes[NodeIndex].Parent)
+		{
+			FNode& Node = Nodes[NodeIndex];
+			Node.InclusiveNumElements--;
+			if (Node.InclusiveNumElements < OctreeSemantics::MinInclusiveElementsPerNode)
+			{
+				CollapseNodeIndex = NodeIndex;
+			}
+		}
+
+		if (CollapseNodeIndex != INDEX_NONE && Nodes[CollapseNodeIndex].FirstChild != INDEX_NONE)
+		{
+			CollapseChildren(CollapseNodeIndex, CollapseNodeIndex);
+		}
+	}
+
+	/** @return the element with the given id */
+	const ElementType& GetElementById(FOctreeElementId Id) const
+	{
+		return Nodes[Id.NodeIndex].Elements[Id.ElementIndex];
+	}
+
+	int32 GetNumElements() const
+	{
+		return Nodes[0].InclusiveNumElements;
+	}
+
+	/** Calls Func(Element) for every element, in no particular order */
+	template<typename FuncType>
+	void ForEachElement(const FuncType& Func) const
+	{
+		for (const FNode& Node : Nodes)
+		{
+			for (const ElementType& Element : Node.Elements)
+			{
+				Func(Element);
+			}
+		}
+	}
+
+	/** Calls Func(Element) for every element whose bounding box intersects Box */
+	template<typename FuncType>
+	void FindElementsWithBoundsTest(const FBox& Box, const FuncType& Func) const
+	{
+		const FVector BoxCenter = Box.GetCenter();
+		const FVector BoxExtent = Box.GetExtent();
+		FindElements([&](const FVector& Center, const FVector& Extent, bool& bOutFullyContained)
+		{
+			bOutFullyContained = false;
+			return FMath::Abs(Center.X - BoxCenter.X) <= Extent.X + BoxExtent.X
+				&& FMath::Abs(Center.Y - BoxCenter.Y) <= Extent.Y + BoxExtent.Y
+				&& FMath::Abs(Center.Z - BoxCenter.Z) <= Extent.Z + BoxExtent.Z;
+		}, Func);
+	}
+
+	/** Calls Func(Element) for every element whose bounding box intersects the sphere */
+	template<typename FuncType>
+	void FindElementsInSphere(const FVector& SphereCenter, float SphereRadius, const FuncType& Func) const
+	{
+		const float RadiusSquared = FMath::Square(SphereRadius);
+		FindElements([&](const FVector& Center, const FVector& Extent, bool& bOutFullyContained)
+		{
+			bOutFullyContained = false;
+			return ComputeSquaredDistanceFromBoxToPoint(Center - Extent, Center + Extent, SphereCenter) <= RadiusSquared;
+		}, Func);
+	}
+
+	/** Calls Func(Element) for every element whose bounding box intersects the convex volume */
+	template<typename FuncType>
+	void FindElementsInConvexVolume(const FConvexVolume& Volume, const FuncType& Func) const
+	{
+		FindElements([&](const FVector& Center, const FVector& Extent, bool& bOutFullyContained)
+		{
+			return Volume.IntersectBox(Center, Extent, bOutFullyContained);
+		}, Func);
+	}
+
+private:
+	struct FNode
+	{
+		std::vector<ElementType> Elements;
+		/** Center of the node's cell */
+		FVector Center;
+		/** Half the size of the node's cell, its elements are within twice that of the center */
+		float Extent = 0.f;
+		int32 Parent = INDEX_NONE;
+		/** First of the eight consecutive children, INDEX_NONE for leaves */
+		int32 FirstChild = INDEX_NONE;
+		/** Elements in this node and all nodes below it */
+		int32 InclusiveNumElements = 0;
+		int32 Depth = 0;
+	};
+
+	/** @return the child of NodeIndex to store an element with Bounds in, INDEX_NONE if it has to stay in the node */
+	int32 FindChildForBounds(int32 NodeIndex, const FBoxSphereBounds& Bounds) const
+	{
+		const FNode& Node = Nodes[NodeIndex];
+		if (Node.FirstChild == INDEX_NONE)
+		{
+			return INDEX_NONE;
+		}
+
+		const int32 ChildIndex = Node.FirstChild
+			+ (Bounds.Origin.X > Node.Center.X ? 1 : 0)
+			+ (Bounds.Origin.Y > Node.Center.Y ? 2 : 0)
+			+ (Bounds.Origin.Z > Node.Center.Z ? 4 : 0);
+		const FNode& Child = Nodes[ChildIndex];
+		const float LooseExtent = Child.Extent * 2.f;
+		if (FMath::Abs(Bounds.Origin.X - Child.Center.X) + Bounds.BoxExtent.X <= LooseExtent
+			&& FMath::Abs(Bounds.Origin.Y - Child.Center.Y) + Bounds.BoxExtent.Y <= LooseExtent
+			&& FMath::Abs(Bounds.Origin.Z - Child.Center.Z) + Bounds.BoxExtent.Z <= LooseExtent)
+		{
+			return ChildIndex;
+		}
+		return INDEX_NONE;
+	}
+
+	/** Creates the children of a leaf and moves the elements that fit into them */
+	void SplitNode(int32 NodeIndex)
+	{
+		int32 FirstChild;
+		if (FreeChildBlocks.size() > 0)
+		{
+			FirstChild = FreeChildBlocks.back();
+			FreeChildBlocks.pop_back();
+		}
+		else
+		{
+			FirstChild = (int32)Nodes.size();
+			Nodes.resize(Nodes.size() + 8);
+		}
+
+		const float ChildExtent = Nodes[NodeIndex].Extent * 0.5f;
+		for (int32 ChildOffset = 0; ChildOffset < 8; ++ChildOffset)
+		{
+			FNode& Child = Nodes[FirstChild + ChildOffset];
+			Child.Elements.clear();
+			Child.Center = Nodes[NodeIndex].Center + FVector(
+				ChildOffset & 1 ? ChildExtent : -ChildExtent,
+				ChildOffset & 2 ? ChildExtent : -ChildExtent,
+				ChildOffset & 4 ? ChildExtent : -ChildExtent);
+			Child.Extent = ChildExtent;
+			Child.Parent = NodeIndex;
+			Child.FirstChild = INDEX_NONE;
+			Child.InclusiveNumElements = 0;
+			Child.Depth = Nodes[NodeIndex].Depth + 1;
+		}
+		Nodes[NodeIndex].FirstChild = FirstChild;
+
+		std::vector<ElementType> Elements;
+		Elements.swap(Nodes[NodeIndex].Elements);
+		for (const ElementType& Element : Elements)
+		{
+			const int32 ChildIndex = FindChildForBounds(NodeIndex, OctreeSemantics::GetBounds(Element));
+			const int32 DestNodeIndex = ChildIndex != INDEX_NONE ? ChildIndex : NodeIndex;
+			FNode& DestNode = Nodes[DestNodeIndex];
+			DestNode.Elements.push_back(Element);
+			OctreeSemantics::SetElementId(Element, FOctreeElementId(DestNodeIndex, (int32)DestNode.Elements.size() - 1));
+			if (ChildIndex != INDEX_NONE)
+			{
+				DestNode.InclusiveNumElements++;
+			}
+		}
+
+		for (int32 ChildIndex = FirstChild; ChildIndex < FirstChild + 8; ++ChildIndex)
+		{
+			if ((int32)Nodes[ChildIndex].Elements.size() > OctreeSemantics::MaxElementsPerLeaf && Nodes[ChildIndex].Depth < OctreeSemantics::MaxNodeDepth)
+			{
+				SplitNode(ChildIndex);
+			}
+		}
+	}
+
+	/** Moves all elements below NodeIndex into DestNodeIndex and frees the children of NodeIndex */
+	void CollapseChildren(int32 NodeIndex, int32 DestNodeIndex)
+	{
+		const int32 FirstChild = Nodes[NodeIndex].FirstChild;
+		for (int32 ChildIndex = FirstChild; ChildIndex < FirstChild + 8; ++ChildIndex)
+		{
+			FNode& Child = Nodes[ChildIndex];
+			if (Child.FirstChild != INDEX_NONE)
+			{
+				CollapseChildren(ChildIndex, DestNodeIndex);
+			}
+
+			std::vector<ElementType>& DestElements = Nodes[DestNodeIndex].Elements;
+			for (const ElementType& Element : Child.Elements)
+			{
+				DestElements.push_back(Element);
+				OctreeSemantics::SetElementId(Element, FOctreeElementId(DestNodeIndex, (int32)DestElements.size() - 1));
+			}
+			Child.Elements.clear();
+			Child.InclusiveNumElements = 0;
+		}
+		Nodes[NodeIndex].FirstChild = INDEX_NONE;
+		FreeChildBlocks.push_back(FirstChild);
+	}
+
+	/**
+	* Calls Func(Element) for the elements whose bounding box passes BoxTest(Center, Extent, bOutFullyContained). Nodes are tested
+	* with their loose bounds, all elements of a node fully inside are passed without testing them, the root always passes.
+	*/
+	template<typename BoxTestType, typename FuncType>
+	void FindElements(const BoxTestType& BoxTest, const FuncType& Func) const
+	{
+		struct FNodeToVisit
+		{
+			int32 NodeIndex;
+			bool bFullyContained;
+		};
+		// Every level leaves at most seven siblings behind on the stack
+		FNodeToVisit NodeStack[8 * (OctreeSemantics::MaxNodeDepth + 1)];
+		int32 NumNodesToVisit = 0;
+		NodeStack[NumNodesToVisit++] = { 0, false };
+
+		while (NumNodesToVisit > 0)
+		{
+			const FNodeToVisit Visit = NodeStack[--NumNodesToVisit];
+			const FNode& Node = Nodes[Visit.NodeIndex];
+
+			for (const ElementType& Element : Node.Elements)
+			{
+				const FBoxSphereBounds& Bounds = OctreeSemantics::GetBounds(Element);
+				bool bElementFullyContained;
+				if (Visit.bFullyContained || BoxTest(Bounds.Origin, Bounds.BoxExtent, bElementFullyContained))
+				{
+					Func(Element);
+				}
+			}
+
+			if (Node.FirstChild != INDEX_NONE)
+			{
+				for (int32 ChildIndex = Node.FirstChild; ChildIndex < Node.FirstChild + 8; ++ChildIndex)
+				{
+					const FNode& Child = Nodes[ChildIndex];
+					if (Child.InclusiveNumElements == 0)
+					{
+						continue;
+					}
+
+					bool bChildFullyContained = Visit.bFullyContained;
+					if (bChildFullyContained || BoxTest(Child.Center, FVector(Child.Extent * 2.f), bChildFullyContained))
+					{
+						NodeStack[NumNodesToVisit++] = { ChildIndex, bChildFullyContained };
+					}
+				}
+			}
+		}
+	}
+
+	std::vector<FNode> Nodes;
+	/** First children of freed groups of eight nodes, reused by SplitNode */
+	std::vector<int32> FreeChildBlocks;
+};
@@ -2,6 +2,48 @@
 
 const FTransform FTransform::Identity(FQuat(0.f, 0.f, 0.f, 1.f), FVector(0.f), FVector(1.f));
 
+#if ENABLE_VECTORIZED_TRANSFORM
+FTransform FTransform::GetRelativeTransform(const FTransform& Other) const
+{
+	// A * B(-1) = VQS(B)(-1) (VQS (A))
+	// 
+	// Scale = S(A)/S(B)
+	// Rotation = Q(B)(-1) * Q(A)
+	// Translation = 1/S(B) *[Q(B)(-1)*(T(A)-T(B))*Q(B)]
+	// where A = this, B = Other
+	FTransform Result;
+
+	if (AnyHasNegativeScale(Scale3D, Other.Scale3D))
+	{
+		// @note, if you have 0 scale with negative, you're going to lose rotation as it can't convert back to quat
+		GetRelativeTransformUsingMatrixWithScale(&Result, this, &Other);
+	}
+	else
+	{
+		// Scale = S(A)/S(B)
+		const VectorRegister VSafeScale3D = GetSafeScaleReciprocal(Other.Scale3D, SMALL_NUMBER);
+		const VectorRegister VScale3D = VectorMultiply(Scale3D, VSafeScale3D);
+
+		if (Other.IsRotationNormalized() == false)
+		{
+			return FTransform::Identity;
+		}
+
+		// Rotation = Q(B)(-1) * Q(A)
+		const VectorRegister VInverseRot = VectorQuaternionInverse(Other.Rotation);
+		const VectorRegister VR = VectorQuaternionMultiply2(VInverseRot, Rotation);
+
+		// Translation = 1/S(B) *[Q(B)(-1)*(T(A)-T(B))*Q(B)]
+		const VectorRegister DeltaTranslation = VectorSubtract(Translation, Other.Translation);
+		const VectorRegister VRotatedTranslation = VectorQuaternionRotateVector(VInverseRot, DeltaTranslation);
+		const VectorRegister VTranslation = VectorMultiply(VRotatedTranslation, VSafeScale3D);
+
+		Result = FTransform(VR, VTranslation, VScale3D);
+	}
+
+	return Result;
+}
+#else
 FTransform FTransform::GetRelativeTransform(const FTransform& Other) const
 {
 	// A * B(-1) = VQS(B)(-1) (VQS (A))
@@ -37,6 +79,7 @@ FTransform FTransform::GetRelativeTransform(const FTransform& Other) const
 
 	return Result;
 }
+#endif
 
 void FTransform::GetRelativeTransformUsingMatrixWithScale(FTransform* OutTransform, const FTransform* Base, const FTransform* Relative)
 {
@@ -45,8 +88,8 @@ void FTransform::GetRelativeTransformUsingMatrixWithScale(FTransform* OutTransfo
 	FMatrix AM = Base->ToMatrixWithScale();
 	FMatrix BM = Relative->ToMatrixWithScale();
 	// get combined scale
-	FVector SafeRecipScale3D = GetSafeScaleReciprocal(Relative->Scale3D, SMALL_NUMBER);
-	FVector DesiredScale3D = Base->Scale3D*SafeRecipScale3D;
+	FVector SafeRecipScale3D = GetSafeScaleReciprocal(Relative->GetScale3D(), SMALL_NUMBER);
+	FVector DesiredScale3D = Base->GetScale3D()*SafeRecipScale3D;
 	ConstructTransformFromMatrixWithDesiredScale(AM, BM.Inverse(), DesiredScale3D, *OutTransform);
 }
 
@@ -1,5 +1,5 @@
 #include "UnrealMath.h"
-#include "UnrealMathFPU.h"
+#include "VectorRegister.h"
 #include "Transform.h"
 
 alignas(16) const FMatrix FMatrix::Identity(FPlane(1, 0, 0, 0), FPlane(0, 1, 0, 0), FPlane(0, 0, 1, 0), FPlane(0, 0, 0, 1));
@@ -412,6 +412,12 @@ public:
 		if (Value == 0) return 32;
 		return 31 - FloorLog2(Value);
 	}
+	static inline uint32 CountTrailingZeros(uint32 Value)
+	{
+		if (Value == 0) return 32;
+		// isolate the lowest set bit, its log is the number of zeros below it
+		return FloorLog2(Value & (0u - Value));
+	}
 	static inline uint32 CeilLogTwo(uint32 Arg)
 	{
 		int32 Bitmask = ((int32)(CountLeadingZeros(Arg) << 26)) >> 31;
@@ -1436,7 +1442,7 @@ struct FMatrix
 		return Result;
 	}
 	inline FVector GetOrigin() const { return FVector(M[3][0], M[3][1], M[3][2]); }
-	inline Vector4 TransformFVector4(const Vector4& V) const;
+	Vector4 TransformFVector4(const Vector4& V) const;
 	Vector4 TransformVector(const FVector& V) const;
 
 	inline Vector4 TransformPosition(const FVector &V) const
@@ -255,7 +255,10 @@ namespace GlobalVectorConstants
 * @param Vec	Vector to store
 * @param Ptr	Aligned memory pointer
 */
-#define VectorStoreAligned( Vec, Ptr )	memcpy( Ptr, &(Vec), 16 )
+inline void VectorStoreAligned(const VectorRegister& Vec, void* Ptr)
+{
+	memcpy(Ptr, &Vec, 16);
+}
 
 /**
 * Performs non-temporal store of a vector to aligned memory without polluting the caches
@@ -271,7 +274,10 @@ namespace GlobalVectorConstants
 * @param Vec	Vector to store
 * @param Ptr	Memory pointer
 */
-#define VectorStore( Vec, Ptr )			FMemory::Memcpy( Ptr, &(Vec), 16 )
+inline void VectorStore(const VectorRegister& Vec, void* Ptr)
+{
+	memcpy(Ptr, &Vec, 16);
+}
 
 /**
 * Stores the XYZ components of a vector to unaligned memory.
@@ -279,7 +285,10 @@ namespace GlobalVectorConstants
 * @param Vec	Vector to store XYZ
 * @param Ptr	Unaligned memory pointer
 */
-#define VectorStoreFloat3( Vec, Ptr )	memcpy( Ptr, &(Vec), 12 )
+inline void VectorStoreFloat3(const VectorRegister& Vec, void* Ptr)
+{
+	memcpy(Ptr, &Vec, 12);
+}
 
 /**
 * Stores the X component of a vector to unaligned memory.
@@ -287,7 +296,10 @@ namespace GlobalVectorConstants
 * @param Vec	Vector to store X
 * @param Ptr	Unaligned memory pointer
 */
-#define VectorStoreFloat1( Vec, Ptr )	memcpy( Ptr, &(Vec), 4 )
+inline void VectorStoreFloat1(const VectorRegister& Vec, void* Ptr)
+{
+	memcpy(Ptr, &Vec, 4);
+}
 
 /**
 * Replicates one element into all four elements and returns the new vector.
@@ -1157,6 +1169,18 @@ inline uint32 VectorAnyGreaterThan(const VectorRegister& Vec1, const VectorRegis
 	return (Vec1.V[0] > Vec2.V[0]) | (Vec1.V[1] > Vec2.V[1]) | (Vec1.V[2] > Vec2.V[2]) | (Vec1.V[3] > Vec2.V[3]);
 }
 
+/**
+* Returns an integer bit-mask (0x00 - 0x0f) based on the sign-bit for each component in a vector.
+*
+* @param VecMask		Vector
+* @return				Bit 0 = sign(VecMask.x), Bit 1 = sign(VecMask.y), Bit 2 = sign(VecMask.z), Bit 3 = sign(VecMask.w)
+*/
+inline uint32 VectorMaskBits(const VectorRegister& VecMask)
+{
+	const uint32* Bits = (const uint32*)(VecMask.V);
+	return (Bits[0] >> 31) | ((Bits[1] >> 30) & 2) | ((Bits[2] >> 29) & 4) | ((Bits[3] >> 28) & 8);
+}
+
 /**
 * Resets the floating point registers so that they can be used again.
 * Some intrinsics use these for MMX purposes (e.g. VectorLoadByte4 and VectorStoreByte4).
@@ -1297,19 +1321,19 @@ inline VectorRegister VectorATan2(const VectorRegister& X, const VectorRegister&
 //TODO: Vectorize
 inline VectorRegister VectorCeil(const VectorRegister& X)
 {
-	return MakeVectorRegister(FMath::CeilToFloat(VectorGetComponent(X, 0)), FMath::CeilToFloat(VectorGetComponent(X, 1)), FMath::CeilToFloat(VectorGetComponent(X, 2)), FMath::CeilToFloat(VectorGetComponent(X, 3)));
+	return MakeVectorRegister(ceilf(VectorGetComponent(X, 0)), ceilf(VectorGetComponent(X, 1)), ceilf(VectorGetComponent(X, 2)), ceilf(VectorGetComponent(X, 3)));
 }
 
 //TODO: Vectorize
 inline VectorRegister VectorFloor(const VectorRegister& X)
 {
-	return MakeVectorRegister(FMath::FloorToFloat(VectorGetComponent(X, 0)), FMath::FloorToFloat(VectorGetComponent(X, 1)), FMath::FloorToFloat(VectorGetComponent(X, 2)), FMath::FloorToFloat(VectorGetComponent(X, 3)));
+	return MakeVectorRegister(floorf(VectorGetComponent(X, 0)), floorf(VectorGetComponent(X, 1)), floorf(VectorGetComponent(X, 2)), floorf(VectorGetComponent(X, 3)));
 }
 
 //TODO: Vectorize
 inline VectorRegister VectorTruncate(const VectorRegister& X)
 {
-	return MakeVectorRegister(FMath::TruncToFloat(VectorGetComponent(X, 0)), FMath::TruncToFloat(VectorGetComponent(X, 1)), FMath::TruncToFloat(VectorGetComponent(X, 2)), FMath::TruncToFloat(VectorGetComponent(X, 3)));
+	return MakeVectorRegister(truncf(VectorGetComponent(X, 0)), truncf(VectorGetComponent(X, 1)), truncf(VectorGetComponent(X, 2)), truncf(VectorGetComponent(X, 3)));
 }
 
 //TODO: Vectorize
@@ -1404,9 +1428,9 @@ inline void VectorStoreURGBA16N(const VectorRegister& Vec, void* Ptr)
 
 	uint16* Out = (uint16*)Ptr;
 	Out[0] = (uint16)Tmp.V[0];
-	Out[1] = (uint16)Tmp.V[0];
-	Out[2] = (uint16)Tmp.V[0];
-	Out[3] = (uint16)Tmp.V[0];
+	Out[1] = (uint16)Tmp.V[1];
+	Out[2] = (uint16)Tmp.V[2];
+	Out[3] = (uint16)Tmp.V[3];
 }
 
 //////////////////////////////////////////////////////////////////////////
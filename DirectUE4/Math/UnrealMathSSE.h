@@ -0,0 +1,1345 @@
+#pragma once
+
+#include "UnrealMath.h"
+
+// SSE2 is the baseline of this backend, the SSE4.1 instructions (dot products, blends, rounding, widening loads,
+// 32 bit integer multiply/min/max) are used when PLATFORM_ALWAYS_HAS_SSE4_1 is set and emulated otherwise.
+#if PLATFORM_ALWAYS_HAS_SSE4_1
+#include <smmintrin.h>
+#else
+#include <emmintrin.h>
+#endif
+
+/*=============================================================================
+*	Helpers:
+*============================================================================*/
+
+/**
+*	float4 vector register type, where the first float (X) is stored in the lowest 32 bits, and so on.
+*/
+typedef __m128	VectorRegister;
+typedef __m128i VectorRegisterInt;
+typedef __m128d VectorRegisterDouble;
+
+// for an __m128, we need a single set of braces (for clang)
+#define DECLARE_VECTOR_REGISTER(X, Y, Z, W) { X, Y, Z, W }
+
+/**
+* @param A0	Selects which element (0-3) from 'A' into 1st slot in the result
+* @param A1	Selects which element (0-3) from 'A' into 2nd slot in the result
+* @param B2	Selects which element (0-3) from 'B' into 3rd slot in the result
+* @param B3	Selects which element (0-3) from 'B' into 4th slot in the result
+*/
+#define SHUFFLEMASK(A0,A1,B2,B3) ( (A0) | ((A1)<<2) | ((B2)<<4) | ((B3)<<6) )
+
+/**
+* Returns a bitwise equivalent vector based on 4 DWORDs.
+*
+* @param X		1st uint32 component
+* @param Y		2nd uint32 component
+* @param Z		3rd uint32 component
+* @param W		4th uint32 component
+* @return		Bitwise equivalent vector with 4 floats
+*/
+inline VectorRegister MakeVectorRegister(uint32 X, uint32 Y, uint32 Z, uint32 W)
+{
+	return _mm_castsi128_ps(_mm_setr_epi32((int32)X, (int32)Y, (int32)Z, (int32)W));
+}
+
+/**
+* Returns a vector based on 4 FLOATs.
+*
+* @param X		1st float component
+* @param Y		2nd float component
+* @param Z		3rd float component
+* @param W		4th float component
+* @return		Vector of the 4 FLOATs
+*/
+inline VectorRegister MakeVectorRegister(float X, float Y, float Z, float W)
+{
+	return _mm_setr_ps(X, Y, Z, W);
+}
+
+/**
+* Returns a vector based on 4 int32.
+*
+* @param X		1st int32 component
+* @param Y		2nd int32 component
+* @param Z		3rd int32 component
+* @param W		4th int32 component
+* @return		Vector of the 4 int32
+*/
+inline VectorRegisterInt MakeVectorRegisterInt(int32 X, int32 Y, int32 Z, int32 W)
+{
+	return _mm_setr_epi32(X, Y, Z, W);
+}
+
+/*=============================================================================
+*	Constants:
+*============================================================================*/
+
+namespace GlobalVectorConstants
+{
+	static const VectorRegister FloatOne = MakeVectorRegister(1.0f, 1.0f, 1.0f, 1.0f);
+	static const VectorRegister FloatZero = MakeVectorRegister(0.0f, 0.0f, 0.0f, 0.0f);
+	static const VectorRegister FloatMinusOne = MakeVectorRegister(-1.0f, -1.0f, -1.0f, -1.0f);
+	static const VectorRegister Float0001 = MakeVectorRegister(0.0f, 0.0f, 0.0f, 1.0f);
+	static const VectorRegister SmallLengthThreshold = MakeVectorRegister(1.e-8f, 1.e-8f, 1.e-8f, 1.e-8f);
+	static const VectorRegister FloatOneHundredth = MakeVectorRegister(0.01f, 0.01f, 0.01f, 0.01f);
+	static const VectorRegister Float111_Minus1 = MakeVectorRegister(1.f, 1.f, 1.f, -1.f);
+	static const VectorRegister FloatMinus1_111 = MakeVectorRegister(-1.f, 1.f, 1.f, 1.f);
+	static const VectorRegister FloatOneHalf = MakeVectorRegister(0.5f, 0.5f, 0.5f, 0.5f);
+	static const VectorRegister FloatMinusOneHalf = MakeVectorRegister(-0.5f, -0.5f, -0.5f, -0.5f);
+	static const VectorRegister KindaSmallNumber = MakeVectorRegister(KINDA_SMALL_NUMBER, KINDA_SMALL_NUMBER, KINDA_SMALL_NUMBER, KINDA_SMALL_NUMBER);
+	static const VectorRegister SmallNumber = MakeVectorRegister(SMALL_NUMBER, SMALL_NUMBER, SMALL_NUMBER, SMALL_NUMBER);
+	static const VectorRegister ThreshQuatNormalized = MakeVectorRegister(THRESH_QUAT_NORMALIZED, THRESH_QUAT_NORMALIZED, THRESH_QUAT_NORMALIZED, THRESH_QUAT_NORMALIZED);
+	static const VectorRegister BigNumber = MakeVectorRegister(BIG_NUMBER, BIG_NUMBER, BIG_NUMBER, BIG_NUMBER);
+
+	static const VectorRegisterInt IntOne = MakeVectorRegisterInt(1, 1, 1, 1);
+	static const VectorRegisterInt IntZero = MakeVectorRegisterInt(0, 0, 0, 0);
+	static const VectorRegisterInt IntMinusOne = MakeVectorRegisterInt(-1, -1, -1, -1);
+
+	/** This is to speed up Quaternion Inverse. Static variable to keep sign of inverse **/
+	static const VectorRegister QINV_SIGN_MASK = MakeVectorRegister(-1.f, -1.f, -1.f, 1.f);
+
+	static const VectorRegister QMULTI_SIGN_MASK0 = MakeVectorRegister(1.f, -1.f, 1.f, -1.f);
+	static const VectorRegister QMULTI_SIGN_MASK1 = MakeVectorRegister(1.f, 1.f, -1.f, -1.f);
+	static const VectorRegister QMULTI_SIGN_MASK2 = MakeVectorRegister(-1.f, 1.f, 1.f, -1.f);
+
+	static const VectorRegister DEG_TO_RAD = MakeVectorRegister(PI / (180.f), PI / (180.f), PI / (180.f), PI / (180.f));
+	static const VectorRegister DEG_TO_RAD_HALF = MakeVectorRegister((PI / 180.f)*0.5f, (PI / 180.f)*0.5f, (PI / 180.f)*0.5f, (PI / 180.f)*0.5f);
+	static const VectorRegister RAD_TO_DEG = MakeVectorRegister((180.f) / PI, (180.f) / PI, (180.f) / PI, (180.f) / PI);
+
+	/** Bitmask to AND out the XYZ components in a vector */
+	static const VectorRegister XYZMask = MakeVectorRegister((uint32)0xffffffff, (uint32)0xffffffff, (uint32)0xffffffff, (uint32)0x00000000);
+
+	/** Bitmask to AND out the sign bit of each components in a vector */
+#define SIGN_BIT ((1 << 31))
+	static const VectorRegister SignBit = MakeVectorRegister((uint32)SIGN_BIT, (uint32)SIGN_BIT, (uint32)SIGN_BIT, (uint32)SIGN_BIT);
+	static const VectorRegister SignMask = MakeVectorRegister((uint32)(~SIGN_BIT), (uint32)(~SIGN_BIT), (uint32)(~SIGN_BIT), (uint32)(~SIGN_BIT));
+	static const VectorRegisterInt IntSignBit = MakeVectorRegisterInt(SIGN_BIT, SIGN_BIT, SIGN_BIT, SIGN_BIT);
+	static const VectorRegisterInt IntSignMask = MakeVectorRegisterInt((~SIGN_BIT), (~SIGN_BIT), (~SIGN_BIT), (~SIGN_BIT));
+#undef SIGN_BIT
+	static const VectorRegister AllMask = MakeVectorRegister(0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF);
+	static const VectorRegisterInt IntAllMask = MakeVectorRegisterInt(0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF);
+
+	/** Vector full of positive infinity */
+	static const VectorRegister FloatInfinity = MakeVectorRegister((uint32)0x7F800000, (uint32)0x7F800000, (uint32)0x7F800000, (uint32)0x7F800000);
+
+
+	static const VectorRegister Pi = MakeVectorRegister(PI, PI, PI, PI);
+	static const VectorRegister TwoPi = MakeVectorRegister(2.0f*PI, 2.0f*PI, 2.0f*PI, 2.0f*PI);
+	static const VectorRegister PiByTwo = MakeVectorRegister(0.5f*PI, 0.5f*PI, 0.5f*PI, 0.5f*PI);
+	static const VectorRegister PiByFour = MakeVectorRegister(0.25f*PI, 0.25f*PI, 0.25f*PI, 0.25f*PI);
+	static const VectorRegister OneOverPi = MakeVectorRegister(1.0f / PI, 1.0f / PI, 1.0f / PI, 1.0f / PI);
+	static const VectorRegister OneOverTwoPi = MakeVectorRegister(1.0f / (2.0f*PI), 1.0f / (2.0f*PI), 1.0f / (2.0f*PI), 1.0f / (2.0f*PI));
+
+	static const VectorRegister Float255 = MakeVectorRegister(255.0f, 255.0f, 255.0f, 255.0f);
+	static const VectorRegister Float127 = MakeVectorRegister(127.0f, 127.0f, 127.0f, 127.0f);
+	static const VectorRegister FloatNeg127 = MakeVectorRegister(-127.0f, -127.0f, -127.0f, -127.0f);
+	static const VectorRegister Float360 = MakeVectorRegister(360.f, 360.f, 360.f, 360.f);
+	static const VectorRegister Float180 = MakeVectorRegister(180.f, 180.f, 180.f, 180.f);
+
+	static const VectorRegister FloatTwo = MakeVectorRegister(2.0f, 2.0f, 2.0f, 2.0f);
+	static const uint32 AlmostTwoBits = 0x3fffffff;
+	static const VectorRegister FloatAlmostTwo = MakeVectorRegister(*(float*)&AlmostTwoBits, *(float*)&AlmostTwoBits, *(float*)&AlmostTwoBits, *(float*)&AlmostTwoBits);
+}
+
+
+
+/*=============================================================================
+*	Intrinsics:
+*============================================================================*/
+
+/**
+* Returns a vector with all zeros.
+*
+* @return		VectorRegister(0.0f, 0.0f, 0.0f, 0.0f)
+*/
+#define VectorZero()					_mm_setzero_ps()
+
+/**
+* Returns a vector with all ones.
+*
+* @return		VectorRegister(1.0f, 1.0f, 1.0f, 1.0f)
+*/
+#define VectorOne()						(GlobalVectorConstants::FloatOne)
+
+/**
+* Loads 4 FLOATs from unaligned memory.
+*
+* @param Ptr	Unaligned memory pointer to the 4 FLOATs
+* @return		VectorRegister(Ptr[0], Ptr[1], Ptr[2], Ptr[3])
+*/
+#define VectorLoad( Ptr )				_mm_loadu_ps( (const float*)(Ptr) )
+
+/**
+* Loads 3 FLOATs from unaligned memory and leaves W undefined.
+*
+* @param Ptr	Unaligned memory pointer to the 3 FLOATs
+* @return		VectorRegister(Ptr[0], Ptr[1], Ptr[2], 0)
+*/
+#define VectorLoadFloat3( Ptr )			MakeVectorRegister( ((const float*)(Ptr))[0], ((const float*)(Ptr))[1], ((const float*)(Ptr))[2], 0.0f )
+
+/**
+* Loads 3 FLOATs from unaligned memory and sets W=0.
+*
+* @param Ptr	Unaligned memory pointer to the 3 FLOATs
+* @return		VectorRegister(Ptr[0], Ptr[1], Ptr[2], 0.0f)
+*/
+#define VectorLoadFloat3_W0( Ptr )		MakeVectorRegister( ((const float*)(Ptr))[0], ((const float*)(Ptr))[1], ((const float*)(Ptr))[2], 0.0f )
+
+/**
+* Loads 3 FLOATs from unaligned memory and sets W=1.
+*
+* @param Ptr	Unaligned memory pointer to the 3 FLOATs
+* @return		VectorRegister(Ptr[0], Ptr[1], Ptr[2], 1.0f)
+*/
+#define VectorLoadFloat3_W1( Ptr )		MakeVectorRegister( ((const float*)(Ptr))[0], ((const float*)(Ptr))[1], ((const float*)(Ptr))[2], 1.0f )
+
+/**
+* Loads 4 FLOATs from aligned memory.
+*
+* @param Ptr	Aligned memory pointer to the 4 FLOATs
+* @return		VectorRegister(Ptr[0], Ptr[1], Ptr[2], Ptr[3])
+*/
+#define VectorLoadAligned( Ptr )		_mm_load_ps( (const float*)(Ptr) )
+
+/**
+* Loads 1 float from unaligned memory and replicates it to all 4 elements.
+*
+* @param Ptr	Unaligned memory pointer to the float
+* @return		VectorRegister(Ptr[0], Ptr[0], Ptr[0], Ptr[0])
+*/
+#define VectorLoadFloat1( Ptr )			_mm_load1_ps( (const float*)(Ptr) )
+
+/**
+* Creates a vector out of three FLOATs and leaves W undefined.
+*
+* @param X		1st float component
+* @param Y		2nd float component
+* @param Z		3rd float component
+* @return		VectorRegister(X, Y, Z, 0)
+*/
+#define VectorSetFloat3( X, Y, Z )		MakeVectorRegister( X, Y, Z, 0.0f )
+
+/**
+* Propagates passed in float to all registers
+*
+* @param F		Float to set
+* @return		VectorRegister(F,F,F,F)
+*/
+#define VectorSetFloat1( F )			_mm_set1_ps( F )
+
+/**
+* Creates a vector out of four FLOATs.
+*
+* @param X		1st float component
+* @param Y		2nd float component
+* @param Z		3rd float component
+* @param W		4th float component
+* @return		VectorRegister(X, Y, Z, W)
+*/
+#define VectorSet( X, Y, Z, W )			MakeVectorRegister( X, Y, Z, W )
+
+/**
+* Stores a vector to aligned memory.
+*
+* @param Vec	Vector to store
+* @param Ptr	Aligned memory pointer
+*/
+#define VectorStoreAligned( Vec, Ptr )	_mm_store_ps( (float*)(Ptr), Vec )
+
+/**
+* Performs non-temporal store of a vector to aligned memory without polluting the caches
+*
+* @param Vec	Vector to store
+* @param Ptr	Aligned memory pointer
+*/
+#define VectorStoreAlignedStreamed( Vec, Ptr )	_mm_stream_ps( (float*)(Ptr), Vec )
+
+/**
+* Stores a vector to memory (aligned or unaligned).
+*
+* @param Vec	Vector to store
+* @param Ptr	Memory pointer
+*/
+#define VectorStore( Vec, Ptr )			_mm_storeu_ps( (float*)(Ptr), Vec )
+
+/**
+* Stores the XYZ components of a vector to unaligned memory.
+*
+* @param Vec	Vector to store XYZ
+* @param Ptr	Unaligned memory pointer
+*/
+inline void VectorStoreFloat3(const VectorRegister& Vec, void* Ptr)
+{
+	float* FloatPtr = (float*)Ptr;
+	_mm_storel_pi((__m64*)FloatPtr, Vec);
+	_mm_store_ss(FloatPtr + 2, _mm_movehl_ps(Vec, Vec));
+}
+
+/**
+* Stores the X component of a vector to unaligned memory.
+*
+* @param Vec	Vector to store X
+* @param Ptr	Unaligned memory pointer
+*/
+#define VectorStoreFloat1( Vec, Ptr )	_mm_store_ss( (float*)(Ptr), Vec )
+
+/**
+* Replicates one element into all four elements and returns the new vector.
+*
+* @param Vec			Source vector
+* @param ElementIndex	Index (0-3) of the element to replicate
+* @return				VectorRegister( Vec[ElementIndex], Vec[ElementIndex], Vec[ElementIndex], Vec[ElementIndex] )
+*/
+#define VectorReplicate( Vec, ElementIndex )	_mm_shuffle_ps( Vec, Vec, SHUFFLEMASK(ElementIndex,ElementIndex,ElementIndex,ElementIndex) )
+
+/**
+* Returns the absolute value (component-wise).
+*
+* @param Vec			Source vector
+* @return				VectorRegister( abs(Vec.x), abs(Vec.y), abs(Vec.z), abs(Vec.w) )
+*/
+#define VectorAbs( Vec )				_mm_and_ps( Vec, GlobalVectorConstants::SignMask )
+
+/**
+* Returns the negated value (component-wise).
+*
+* @param Vec			Source vector
+* @return				VectorRegister( -Vec.x, -Vec.y, -Vec.z, -Vec.w )
+*/
+#define VectorNegate( Vec )				_mm_sub_ps( _mm_setzero_ps(), Vec )
+
+/**
+* Adds two vectors (component-wise) and returns the result.
+*
+* @param Vec1	1st vector
+* @param Vec2	2nd vector
+* @return		VectorRegister( Vec1.x+Vec2.x, Vec1.y+Vec2.y, Vec1.z+Vec2.z, Vec1.w+Vec2.w )
+*/
+#define VectorAdd( Vec1, Vec2 )			_mm_add_ps( Vec1, Vec2 )
+
+/**
+* Subtracts a vector from another (component-wise) and returns the result.
+*
+* @param Vec1	1st vector
+* @param Vec2	2nd vector
+* @return		VectorRegister( Vec1.x-Vec2.x, Vec1.y-Vec2.y, Vec1.z-Vec2.z, Vec1.w-Vec2.w )
+*/
+#define VectorSubtract( Vec1, Vec2 )	_mm_sub_ps( Vec1, Vec2 )
+
+/**
+* Multiplies two vectors (component-wise) and returns the result.
+*
+* @param Vec1	1st vector
+* @param Vec2	2nd vector
+* @return		VectorRegister( Vec1.x*Vec2.x, Vec1.y*Vec2.y, Vec1.z*Vec2.z, Vec1.w*Vec2.w )
+*/
+#define VectorMultiply( Vec1, Vec2 )	_mm_mul_ps( Vec1, Vec2 )
+
+/**
+* Multiplies two vectors (component-wise), adds in the third vector and returns the result.
+* No fused multiply-add, so the rounding matches the FPU backend.
+*
+* @param Vec1	1st vector
+* @param Vec2	2nd vector
+* @param Vec3	3rd vector
+* @return		VectorRegister( Vec1.x*Vec2.x + Vec3.x, Vec1.y*Vec2.y + Vec3.y, Vec1.z*Vec2.z + Vec3.z, Vec1.w*Vec2.w + Vec3.w )
+*/
+#define VectorMultiplyAdd( Vec1, Vec2, Vec3 )	_mm_add_ps( _mm_mul_ps(Vec1, Vec2), Vec3 )
+
+/**
+* Divides two vectors (component-wise) and returns the result.
+*
+* @param Vec1	1st vector
+* @param Vec2	2nd vector
+* @return		VectorRegister( Vec1.x/Vec2.x, Vec1.y/Vec2.y, Vec1.z/Vec2.z, Vec1.w/Vec2.w )
+*/
+#define VectorDivide( Vec1, Vec2 )		_mm_div_ps( Vec1, Vec2 )
+
+/**
+* Calculates the dot3 product of two vectors and returns a vector with the result in all 4 components.
+*
+* @param Vec1	1st vector
+* @param Vec2	2nd vector
+* @return		d = dot3(Vec1.xyz, Vec2.xyz), VectorRegister( d, d, d, d )
+*/
+inline VectorRegister VectorDot3(const VectorRegister& Vec1, const VectorRegister& Vec2)
+{
+#if PLATFORM_ALWAYS_HAS_SSE4_1
+	return _mm_dp_ps(Vec1, Vec2, 0x7F);
+#else
+	const VectorRegister Temp = _mm_mul_ps(Vec1, Vec2);
+	return _mm_add_ps(_mm_add_ps(VectorReplicate(Temp, 0), VectorReplicate(Temp, 1)), VectorReplicate(Temp, 2));
+#endif
+}
+
+/**
+* Calculates the dot4 product of two vectors and returns a vector with the result in all 4 components.
+*
+* @param Vec1	1st vector
+* @param Vec2	2nd vector
+* @return		d = dot4(Vec1.xyzw, Vec2.xyzw), VectorRegister( d, d, d, d )
+*/
+inline VectorRegister VectorDot4(const VectorRegister& Vec1, const VectorRegister& Vec2)
+{
+#if PLATFORM_ALWAYS_HAS_SSE4_1
+	return _mm_dp_ps(Vec1, Vec2, 0xFF);
+#else
+	VectorRegister Temp = _mm_mul_ps(Vec1, Vec2);
+	Temp = _mm_add_ps(Temp, _mm_shuffle_ps(Temp, Temp, SHUFFLEMASK(2, 3, 0, 1)));
+	return _mm_add_ps(Temp, _mm_shuffle_ps(Temp, Temp, SHUFFLEMASK(1, 0, 3, 2)));
+#endif
+}
+
+/**
+* Creates a four-part mask based on component-wise == compares of the input vectors
+*
+* @param Vec1	1st vector
+* @param Vec2	2nd vector
+* @return		VectorRegister( Vec1.x == Vec2.x ? 0xFFFFFFFF : 0, same for yzw )
+*/
+#define VectorCompareEQ( Vec1, Vec2 )	_mm_cmpeq_ps( Vec1, Vec2 )
+
+/**
+* Creates a four-part mask based on component-wise != compares of the input vectors
+*
+* @param Vec1	1st vector
+* @param Vec2	2nd vector
+* @return		VectorRegister( Vec1.x != Vec2.x ? 0xFFFFFFFF : 0, same for yzw )
+*/
+#define VectorCompareNE( Vec1, Vec2 )	_mm_cmpneq_ps( Vec1, Vec2 )
+
+/**
+* Creates a four-part mask based on component-wise > compares of the input vectors
+*
+* @param Vec1	1st vector
+* @param Vec2	2nd vector
+* @return		VectorRegister( Vec1.x > Vec2.x ? 0xFFFFFFFF : 0, same for yzw )
+*/
+#define VectorCompareGT( Vec1, Vec2 )	_mm_cmpgt_ps( Vec1, Vec2 )
+
+/**
+* Creates a four-part mask based on component-wise >= compares of the input vectors
+*
+* @param Vec1	1st vector
+* @param Vec2	2nd vector
+* @return		VectorRegister( Vec1.x >= Vec2.x ? 0xFFFFFFFF : 0, same for yzw )
+*/
+#define VectorCompareGE( Vec1, Vec2 )	_mm_cmpge_ps( Vec1, Vec2 )
+
+/**
+* Creates a four-part mask based on component-wise < compares of the input vectors
+*
+* @param Vec1	1st vector
+* @param Vec2	2nd vector
+* @return		VectorRegister( Vec1.x < Vec2.x ? 0xFFFFFFFF : 0, same for yzw )
+*/
+#define VectorCompareLT( Vec1, Vec2 )	_mm_cmplt_ps( Vec1, Vec2 )
+
+/**
+* Creates a four-part mask based on component-wise <= compares of the input vectors
+*
+* @param Vec1	1st vector
+* @param Vec2	2nd vector
+* @return		VectorRegister( Vec1.x <= Vec2.x ? 0xFFFFFFFF : 0, same for yzw )
+*/
+#define VectorCompareLE( Vec1, Vec2 )	_mm_cmple_ps( Vec1, Vec2 )
+
+/**
+* Does a bitwise vector selection based on a mask (e.g., created from VectorCompareXX)
+*
+* @param Mask  Mask (when 1: use the corresponding bit from Vec1 otherwise from Vec2)
+* @param Vec1	1st vector
+* @param Vec2	2nd vector
+* @return		VectorRegister( for each bit i: Mask[i] ? Vec1[i] : Vec2[i] )
+*/
+inline VectorRegister VectorSelect(const VectorRegister& Mask, const VectorRegister& Vec1, const VectorRegister& Vec2)
+{
+	return _mm_xor_ps(Vec2, _mm_and_ps(Mask, _mm_xor_ps(Vec1, Vec2)));
+}
+
+/**
+* Combines two vectors using bitwise OR (treating each vector as a 128 bit field)
+*
+* @param Vec1	1st vector
+* @param Vec2	2nd vector
+* @return		VectorRegister( for each bit i: Vec1[i] | Vec2[i] )
+*/
+#define VectorBitwiseOr(Vec1, Vec2)	_mm_or_ps(Vec1, Vec2)
+
+/**
+* Combines two vectors using bitwise AND (treating each vector as a 128 bit field)
+*
+* @param Vec1	1st vector
+* @param Vec2	2nd vector
+* @return		VectorRegister( for each bit i: Vec1[i] & Vec2[i] )
+*/
+#define VectorBitwiseAnd(Vec1, Vec2) _mm_and_ps(Vec1, Vec2)
+
+/**
+* Combines two vectors using bitwise XOR (treating each vector as a 128 bit field)
+*
+* @param Vec1	1st vector
+* @param Vec2	2nd vector
+* @return		VectorRegister( for each bit i: Vec1[i] ^ Vec2[i] )
+*/
+#define VectorBitwiseXor(Vec1, Vec2) _mm_xor_ps(Vec1, Vec2)
+
+/**
+* Swizzles the 4 components of a vector and returns the result.
+*
+* @param Vec		Source vector
+* @param X			Index for which component to use for X (literal 0-3)
+* @param Y			Index for which component to use for Y (literal 0-3)
+* @param Z			Index for which component to use for Z (literal 0-3)
+* @param W			Index for which component to use for W (literal 0-3)
+* @return			The swizzled vector
+*/
+#define VectorSwizzle( Vec, X, Y, Z, W )	_mm_shuffle_ps( Vec, Vec, SHUFFLEMASK(X,Y,Z,W) )
+
+/**
+* Creates a vector through selecting two components from each vector via a shuffle mask.
+*
+* @param Vec1		Source vector1
+* @param Vec2		Source vector2
+* @param X			Index for which component of Vector1 to use for X (literal 0-3)
+* @param Y			Index for which component of Vector1 to use for Y (literal 0-3)
+* @param Z			Index for which component of Vector2 to use for Z (literal 0-3)
+* @param W			Index for which component of Vector2 to use for W (literal 0-3)
+* @return			The swizzled vector
+*/
+#define VectorShuffle( Vec1, Vec2, X, Y, Z, W )	_mm_shuffle_ps( Vec1, Vec2, SHUFFLEMASK(X,Y,Z,W) )
+
+/**
+* Calculates the cross product of two vectors (XYZ components). W is set to 0.
+*
+* @param Vec1	1st vector
+* @param Vec2	2nd vector
+* @return		cross(Vec1.xyz, Vec2.xyz). W is set to 0.
+*/
+inline VectorRegister VectorCross(const VectorRegister& Vec1, const VectorRegister& Vec2)
+{
+	const VectorRegister A_YZXW = _mm_shuffle_ps(Vec1, Vec1, SHUFFLEMASK(1, 2, 0, 3));
+	const VectorRegister B_ZXYW = _mm_shuffle_ps(Vec2, Vec2, SHUFFLEMASK(2, 0, 1, 3));
+	const VectorRegister A_ZXYW = _mm_shuffle_ps(Vec1, Vec1, SHUFFLEMASK(2, 0, 1, 3));
+	const VectorRegister B_YZXW = _mm_shuffle_ps(Vec2, Vec2, SHUFFLEMASK(1, 2, 0, 3));
+	const VectorRegister Cross = _mm_sub_ps(_mm_mul_ps(A_YZXW, B_ZXYW), _mm_mul_ps(A_ZXYW, B_YZXW));
+	return _mm_and_ps(Cross, GlobalVectorConstants::XYZMask);
+}
+
+/**
+* Calculates x raised to the power of y (component-wise).
+*
+* @param Base		Base vector
+* @param Exponent	Exponent vector
+* @return			VectorRegister( Base.x^Exponent.x, Base.y^Exponent.y, Base.z^Exponent.z, Base.w^Exponent.w )
+*/
+inline VectorRegister VectorPow(const VectorRegister& Base, const VectorRegister& Exponent)
+{
+	union { VectorRegister v; float f[4]; } B, E;
+	B.v = Base;
+	E.v = Exponent;
+	return _mm_setr_ps(FMath::Pow(B.f[0], E.f[0]), FMath::Pow(B.f[1], E.f[1]), FMath::Pow(B.f[2], E.f[2]), FMath::Pow(B.f[3], E.f[3]));
+}
+
+/**
+* Returns the reciprocal square root of a vector (component-wise).
+* Computed with a real square root and divide rather than _mm_rsqrt_ps, so results match the FPU backend.
+*
+* @param Vec		Source vector
+* @return			VectorRegister( 1/sqrt(Vec.x), 1/sqrt(Vec.y), 1/sqrt(Vec.z), 1/sqrt(Vec.w) )
+*/
+#define VectorReciprocalSqrt( Vec )		_mm_div_ps( GlobalVectorConstants::FloatOne, _mm_sqrt_ps( Vec ) )
+
+/**
+* Computes an estimate of the reciprocal of a vector (component-wise) and returns the result.
+*
+* @param Vec		1st vector
+* @return			VectorRegister( (Estimate) 1.0f / Vec.x, (Estimate) 1.0f / Vec.y, (Estimate) 1.0f / Vec.z, (Estimate) 1.0f / Vec.w )
+*/
+#define VectorReciprocal( Vec )			_mm_div_ps( GlobalVectorConstants::FloatOne, Vec )
+
+/**
+* Return Reciprocal Length of the vector
+*
+* @param Vector		Vector
+* @return			VectorRegister(rlen, rlen, rlen, rlen) when rlen = 1/sqrt(dot4(V))
+*/
+inline VectorRegister VectorReciprocalLen(const VectorRegister& Vector)
+{
+	return VectorReciprocalSqrt(VectorDot4(Vector, Vector));
+}
+
+/**
+* Return the reciprocal of the square root of each component
+*
+* @param Vector		Vector
+* @return			VectorRegister(1/sqrt(Vec.X), 1/sqrt(Vec.Y), 1/sqrt(Vec.Z), 1/sqrt(Vec.W))
+*/
+#define VectorReciprocalSqrtAccurate(Vec)	VectorReciprocalSqrt(Vec)
+
+/**
+* Computes the reciprocal of a vector (component-wise) and returns the result.
+*
+* @param Vec	1st vector
+* @return		VectorRegister( 1.0f / Vec.x, 1.0f / Vec.y, 1.0f / Vec.z, 1.0f / Vec.w )
+*/
+#define VectorReciprocalAccurate(Vec)	VectorReciprocal(Vec)
+
+/**
+* Normalize vector
+*
+* @param Vector		Vector to normalize
+* @return			Normalized VectorRegister
+*/
+inline VectorRegister VectorNormalize(const VectorRegister& Vector)
+{
+	return VectorMultiply(Vector, VectorReciprocalLen(Vector));
+}
+
+/**
+* Loads XYZ and sets W=0
+*
+* @param Vector	VectorRegister
+* @return		VectorRegister(X, Y, Z, 0.0f)
+*/
+#define VectorSet_W0( Vec )		_mm_and_ps( Vec, GlobalVectorConstants::XYZMask )
+
+/**
+* Loads XYZ and sets W=1
+*
+* @param Vector	VectorRegister
+* @return		VectorRegister(X, Y, Z, 1.0f)
+*/
+#define VectorSet_W1( Vec )		_mm_or_ps( _mm_and_ps( Vec, GlobalVectorConstants::XYZMask ), GlobalVectorConstants::Float0001 )
+
+
+// 40% faster version of the Quaternion multiplication.
+#define USE_FAST_QUAT_MUL 1
+
+/**
+* Multiplies two quaternions; the order matters.
+*
+* Order matters when composing quaternions: C = VectorQuaternionMultiply2(A, B) will yield a quaternion C = A * B
+* that logically first applies B then A to any subsequent transformation (right first, then left).
+*
+* @param Quat1	Pointer to the first quaternion
+* @param Quat2	Pointer to the second quaternion
+* @return Quat1 * Quat2
+*/
+inline VectorRegister VectorQuaternionMultiply2(const VectorRegister& Quat1, const VectorRegister& Quat2)
+{
+	// R.xyzw = Q1.w * Q2.xyzw + Q1.x * Q2.wzyx * (1,-1,1,-1) + Q1.y * Q2.zwxy * (1,1,-1,-1) + Q1.z * Q2.yxwz * (-1,1,1,-1)
+	VectorRegister Result = VectorMultiply(VectorReplicate(Quat1, 3), Quat2);
+	Result = VectorMultiplyAdd(VectorMultiply(VectorReplicate(Quat1, 0), VectorSwizzle(Quat2, 3, 2, 1, 0)), GlobalVectorConstants::QMULTI_SIGN_MASK0, Result);
+	Result = VectorMultiplyAdd(VectorMultiply(VectorReplicate(Quat1, 1), VectorSwizzle(Quat2, 2, 3, 0, 1)), GlobalVectorConstants::QMULTI_SIGN_MASK1, Result);
+	Result = VectorMultiplyAdd(VectorMultiply(VectorReplicate(Quat1, 2), VectorSwizzle(Quat2, 1, 0, 3, 2)), GlobalVectorConstants::QMULTI_SIGN_MASK2, Result);
+	return Result;
+}
+
+/**
+* Multiplies two quaternions; the order matters.
+*
+* When composing quaternions: VectorQuaternionMultiply(C, A, B) will yield a quaternion C = A * B
+* that logically first applies B then A to any subsequent transformation (right first, then left).
+*
+* @param Result	Pointer to where the result Quat1 * Quat2 should be stored
+* @param Quat1	Pointer to the first quaternion (must not be the destination)
+* @param Quat2	Pointer to the second quaternion (must not be the destination)
+*/
+inline void VectorQuaternionMultiply(void* __restrict Result, const void* __restrict Quat1, const void* __restrict Quat2)
+{
+	// the pointers are not required to be aligned (FQuat is, but plain float[4] callers are not)
+	const VectorRegister Q1 = _mm_loadu_ps((const float*)Quat1);
+	const VectorRegister Q2 = _mm_loadu_ps((const float*)Quat2);
+	_mm_storeu_ps((float*)Result, VectorQuaternionMultiply2(Q1, Q2));
+}
+
+/**
+* Multiplies two 4x4 matrices.
+*
+* @param Result	Pointer to where the result should be stored
+* @param Matrix1	Pointer to the first matrix
+* @param Matrix2	Pointer to the second matrix
+*/
+inline void VectorMatrixMultiply(void* Result, const void* Matrix1, const void* Matrix2)
+{
+	const float* A = (const float*)Matrix1;
+	const float* B = (const float*)Matrix2;
+	float* R = (float*)Result;
+
+	const VectorRegister B0 = _mm_loadu_ps(B + 0);
+	const VectorRegister B1 = _mm_loadu_ps(B + 4);
+	const VectorRegister B2 = _mm_loadu_ps(B + 8);
+	const VectorRegister B3 = _mm_loadu_ps(B + 12);
+
+	// all rows are computed before storing, so Result may alias either input
+	VectorRegister Rows[4];
+	for (int32 Row = 0; Row < 4; ++Row)
+	{
+		const VectorRegister ARow = _mm_loadu_ps(A + Row * 4);
+		VectorRegister R0 = VectorMultiply(VectorReplicate(ARow, 0), B0);
+		R0 = VectorMultiplyAdd(VectorReplicate(ARow, 1), B1, R0);
+		R0 = VectorMultiplyAdd(VectorReplicate(ARow, 2), B2, R0);
+		Rows[Row] = VectorMultiplyAdd(VectorReplicate(ARow, 3), B3, R0);
+	}
+
+	_mm_storeu_ps(R + 0, Rows[0]);
+	_mm_storeu_ps(R + 4, Rows[1]);
+	_mm_storeu_ps(R + 8, Rows[2]);
+	_mm_storeu_ps(R + 12, Rows[3]);
+}
+
+/**
+* Calculate the inverse of an FMatrix.
+* Splits the matrix in four 2x2 blocks and inverts it with the block-wise (Schur complement) formula.
+*
+* @param DstMatrix		FMatrix pointer to where the result should be stored
+* @param SrcMatrix		FMatrix pointer to the Matrix to be inversed
+*/
+inline void VectorMatrixInverse(void* DstMatrix, const void* SrcMatrix)
+{
+	const float* Src = (const float*)SrcMatrix;
+	float* Dst = (float*)DstMatrix;
+
+	const VectorRegister Row0 = _mm_loadu_ps(Src + 0);
+	const VectorRegister Row1 = _mm_loadu_ps(Src + 4);
+	const VectorRegister Row2 = _mm_loadu_ps(Src + 8);
+	const VectorRegister Row3 = _mm_loadu_ps(Src + 12);
+
+	// 2x2 blocks, each stored row major as (m00, m01, m10, m11)
+	const VectorRegister A = _mm_movelh_ps(Row0, Row1);
+	const VectorRegister B = _mm_movehl_ps(Row1, Row0);
+	const VectorRegister C = _mm_movelh_ps(Row2, Row3);
+	const VectorRegister D = _mm_movehl_ps(Row3, Row2);
+
+	// 2x2 matrix products: Mul = X*Y, AdjMul = adj(X)*Y, MulAdj = X*adj(Y)
+	auto Mat2Mul = [](const VectorRegister& X, const VectorRegister& Y)
+	{
+		return _mm_add_ps(_mm_mul_ps(X, VectorSwizzle(Y, 0, 3, 0, 3)), _mm_mul_ps(VectorSwizzle(X, 1, 0, 3, 2), VectorSwizzle(Y, 2, 1, 2, 1)));
+	};
+	auto Mat2AdjMul = [](const VectorRegister& X, const VectorRegister& Y)
+	{
+		return _mm_sub_ps(_mm_mul_ps(VectorSwizzle(X, 3, 3, 0, 0), Y), _mm_mul_ps(VectorSwizzle(X, 1, 1, 2, 2), VectorSwizzle(Y, 2, 3, 0, 1)));
+	};
+	auto Mat2MulAdj = [](const VectorRegister& X, const VectorRegister& Y)
+	{
+		return _mm_sub_ps(_mm_mul_ps(X, VectorSwizzle(Y, 3, 0, 3, 0)), _mm_mul_ps(VectorSwizzle(X, 1, 0, 3, 2), VectorSwizzle(Y, 2, 1, 2, 1)));
+	};
+
+	// determinants of the blocks as (|A|, |B|, |C|, |D|)
+	const VectorRegister DetSub = _mm_sub_ps(
+		_mm_mul_ps(VectorShuffle(Row0, Row2, 0, 2, 0, 2), VectorShuffle(Row1, Row3, 1, 3, 1, 3)),
+		_mm_mul_ps(VectorShuffle(Row0, Row2, 1, 3, 1, 3), VectorShuffle(Row1, Row3, 0, 2, 0, 2)));
+	const VectorRegister DetA = VectorReplicate(DetSub, 0);
+	const VectorRegister DetB = VectorReplicate(DetSub, 1);
+	const VectorRegister DetC = VectorReplicate(DetSub, 2);
+	const VectorRegister DetD = VectorReplicate(DetSub, 3);
+
+	const VectorRegister D_C = Mat2AdjMul(D, C);
+	const VectorRegister A_B = Mat2AdjMul(A, B);
+
+	VectorRegister X_ = _mm_sub_ps(_mm_mul_ps(DetD, A), Mat2Mul(B, D_C));
+	VectorRegister W_ = _mm_sub_ps(_mm_mul_ps(DetA, D), Mat2Mul(C, A_B));
+	VectorRegister Y_ = _mm_sub_ps(_mm_mul_ps(DetB, C), Mat2MulAdj(D, A_B));
+	VectorRegister Z_ = _mm_sub_ps(_mm_mul_ps(DetC, B), Mat2MulAdj(A, D_C));
+
+	// |M| = |A|*|D| + |B|*|C| - tr(adj(A)*B * adj(D)*C)
+	VectorRegister DetM = _mm_add_ps(_mm_mul_ps(DetA, DetD), _mm_mul_ps(DetB, DetC));
+	VectorRegister Trace = _mm_mul_ps(A_B, VectorSwizzle(D_C, 0, 2, 1, 3));
+	Trace = _mm_add_ps(Trace, VectorSwizzle(Trace, 2, 3, 0, 1));
+	Trace = _mm_add_ps(Trace, VectorSwizzle(Trace, 1, 0, 3, 2));
+	DetM = _mm_sub_ps(DetM, Trace);
+
+	const VectorRegister RDetM = _mm_div_ps(MakeVectorRegister(1.f, -1.f, -1.f, 1.f), DetM);
+	X_ = _mm_mul_ps(X_, RDetM);
+	Y_ = _mm_mul_ps(Y_, RDetM);
+	Z_ = _mm_mul_ps(Z_, RDetM);
+	W_ = _mm_mul_ps(W_, RDetM);
+
+	// apply the adjugate while storing the blocks back as rows
+	_mm_storeu_ps(Dst + 0, VectorShuffle(X_, Y_, 3, 1, 3, 1));
+	_mm_storeu_ps(Dst + 4, VectorShuffle(X_, Y_, 2, 0, 2, 0));
+	_mm_storeu_ps(Dst + 8, VectorShuffle(Z_, W_, 3, 1, 3, 1));
+	_mm_storeu_ps(Dst + 12, VectorShuffle(Z_, W_, 2, 0, 2, 0));
+}
+
+/**
+* Calculate Homogeneous transform.
+*
+* @param VecP			VectorRegister
+* @param MatrixM		FMatrix pointer to the Matrix to apply transform
+* @return VectorRegister = VecP*MatrixM
+*/
+inline VectorRegister VectorTransformVector(const VectorRegister& VecP, const void* MatrixM)
+{
+	const float* M = (const float*)MatrixM;
+
+	VectorRegister Result = VectorMultiply(VectorReplicate(VecP, 0), _mm_loadu_ps(M + 0));
+	Result = VectorMultiplyAdd(VectorReplicate(VecP, 1), _mm_loadu_ps(M + 4), Result);
+	Result = VectorMultiplyAdd(VectorReplicate(VecP, 2), _mm_loadu_ps(M + 8), Result);
+	Result = VectorMultiplyAdd(VectorReplicate(VecP, 3), _mm_loadu_ps(M + 12), Result);
+	return Result;
+}
+
+/**
+* Returns the minimum values of two vectors (component-wise).
+*
+* @param Vec1	1st vector
+* @param Vec2	2nd vector
+* @return		VectorRegister( min(Vec1.x,Vec2.x), min(Vec1.y,Vec2.y), min(Vec1.z,Vec2.z), min(Vec1.w,Vec2.w) )
+*/
+#define VectorMin( Vec1, Vec2 )			_mm_min_ps( Vec1, Vec2 )
+
+/**
+* Returns the maximum values of two vectors (component-wise).
+*
+* @param Vec1	1st vector
+* @param Vec2	2nd vector
+* @return		VectorRegister( max(Vec1.x,Vec2.x), max(Vec1.y,Vec2.y), max(Vec1.z,Vec2.z), max(Vec1.w,Vec2.w) )
+*/
+#define VectorMax( Vec1, Vec2 )			_mm_max_ps( Vec1, Vec2 )
+
+/**
+* Creates a vector by combining two high components from each vector
+*
+* @param Vec1		Source vector1
+* @param Vec2		Source vector2
+* @return			The combined vector
+*/
+inline VectorRegister VectorCombineHigh(const VectorRegister& Vec1, const VectorRegister& Vec2)
+{
+	return _mm_movehl_ps(Vec2, Vec1);
+}
+
+/**
+* Creates a vector by combining two low components from each vector
+*
+* @param Vec1		Source vector1
+* @param Vec2		Source vector2
+* @return			The combined vector
+*/
+inline VectorRegister VectorCombineLow(const VectorRegister& Vec1, const VectorRegister& Vec2)
+{
+	return _mm_movelh_ps(Vec1, Vec2);
+}
+
+/**
+* Merges the XYZ components of one vector with the W component of another vector and returns the result.
+*
+* @param VecXYZ	Source vector for XYZ_
+* @param VecW		Source register for ___W (note: the fourth component is used, not the first)
+* @return			VectorRegister(VecXYZ.x, VecXYZ.y, VecXYZ.z, VecW.w)
+*/
+inline VectorRegister VectorMergeVecXYZ_VecW(const VectorRegister& VecXYZ, const VectorRegister& VecW)
+{
+#if PLATFORM_ALWAYS_HAS_SSE4_1
+	return _mm_blend_ps(VecXYZ, VecW, 0x8);
+#else
+	return _mm_or_ps(_mm_and_ps(VecXYZ, GlobalVectorConstants::XYZMask), _mm_andnot_ps(GlobalVectorConstants::XYZMask, VecW));
+#endif
+}
+
+/**
+* Loads 4 uint8s from unaligned memory and converts them into 4 FLOATs.
+* IMPORTANT: You need to call VectorResetFloatRegisters() before using scalar FLOATs after you've used this intrinsic!
+*
+* @param Ptr			Unaligned memory pointer to the 4 uint8s.
+* @return				VectorRegister( float(Ptr[0]), float(Ptr[1]), float(Ptr[2]), float(Ptr[3]) )
+*/
+inline VectorRegister VectorLoadByte4(const void* Ptr)
+{
+	const __m128i Bytes = _mm_cvtsi32_si128(*(const int32*)Ptr);
+#if PLATFORM_ALWAYS_HAS_SSE4_1
+	return _mm_cvtepi32_ps(_mm_cvtepu8_epi32(Bytes));
+#else
+	const __m128i Zero = _mm_setzero_si128();
+	return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(Bytes, Zero), Zero));
+#endif
+}
+
+/**
+* Loads 4 int8s from unaligned memory and converts them into 4 FLOATs.
+* IMPORTANT: You need to call VectorResetFloatRegisters() before using scalar FLOATs after you've used this intrinsic!
+*
+* @param Ptr			Unaligned memory pointer to the 4 int8s.
+* @return				VectorRegister( float(Ptr[0]), float(Ptr[1]), float(Ptr[2]), float(Ptr[3]) )
+*/
+inline VectorRegister VectorLoadSignedByte4(const void* Ptr)
+{
+	const __m128i Bytes = _mm_cvtsi32_si128(*(const int32*)Ptr);
+#if PLATFORM_ALWAYS_HAS_SSE4_1
+	return _mm_cvtepi32_ps(_mm_cvtepi8_epi32(Bytes));
+#else
+	// each byte ends up in the top 8 bits of its int32, the arithmetic shift brings it down with its sign
+	return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(_mm_unpacklo_epi8(Bytes, Bytes), _mm_unpacklo_epi8(Bytes, Bytes)), 24));
+#endif
+}
+
+/**
+* Loads 4 uint8s from unaligned memory and converts them into 4 FLOATs in reversed order.
+* IMPORTANT: You need to call VectorResetFloatRegisters() before using scalar FLOATs after you've used this intrinsic!
+*
+* @param Ptr			Unaligned memory pointer to the 4 uint8s.
+* @return				VectorRegister( float(Ptr[3]), float(Ptr[2]), float(Ptr[1]), float(Ptr[0]) )
+*/
+inline VectorRegister VectorLoadByte4Reverse(const void* Ptr)
+{
+	const VectorRegister Temp = VectorLoadByte4(Ptr);
+	return VectorSwizzle(Temp, 3, 2, 1, 0);
+}
+
+/**
+* Converts the 4 FLOATs in the vector to 4 uint8s, clamped to [0,255], and stores to unaligned memory.
+* IMPORTANT: You need to call VectorResetFloatRegisters() before using scalar FLOATs after you've used this intrinsic!
+*
+* @param Vec			Vector containing 4 FLOATs
+* @param Ptr			Unaligned memory pointer to store the 4 uint8s.
+*/
+inline void VectorStoreByte4(const VectorRegister& Vec, void* Ptr)
+{
+	// truncate like the scalar uint8(float) conversion, then narrow with saturation
+	const __m128i Ints = _mm_cvttps_epi32(Vec);
+	const __m128i Shorts = _mm_packs_epi32(Ints, Ints);
+	const __m128i Bytes = _mm_packus_epi16(Shorts, Shorts);
+	*(int32*)Ptr = _mm_cvtsi128_si32(Bytes);
+}
+
+/**
+* Converts the 4 FLOATs in the vector to 4 int8s, clamped to [-127, 127], and stores to unaligned memory.
+* IMPORTANT: You need to call VectorResetFloatRegisters() before using scalar FLOATs after you've used this intrinsic!
+*
+* @param Vec			Vector containing 4 FLOATs
+* @param Ptr			Unaligned memory pointer to store the 4 int8s.
+*/
+inline void VectorStoreSignedByte4(const VectorRegister& Vec, void* Ptr)
+{
+	const __m128i Ints = _mm_cvttps_epi32(Vec);
+	const __m128i Shorts = _mm_packs_epi32(Ints, Ints);
+	const __m128i Bytes = _mm_packs_epi16(Shorts, Shorts);
+	*(int32*)Ptr = _mm_cvtsi128_si32(Bytes);
+}
+
+/**
+* Loads packed RGB10A2(4 bytes) from unaligned memory and converts them into 4 FLOATs.
+* IMPORTANT: You need to call VectorResetFloatRegisters() before using scalar FLOATs after you've used this intrinsic!
+*
+* @param Ptr			Unaligned memory pointer to the RGB10A2(4 bytes).
+* @return				VectorRegister with 4 FLOATs loaded from Ptr.
+*/
+inline VectorRegister VectorLoadURGB10A2N(void* Ptr)
+{
+	const uint32 E = *(uint32*)Ptr;
+	const __m128i Shifted = _mm_setr_epi32(E, E >> 10, E >> 20, E >> 30);
+	const __m128i Masked = _mm_and_si128(Shifted, _mm_setr_epi32(0x3FF, 0x3FF, 0x3FF, 0x3));
+	return _mm_div_ps(_mm_cvtepi32_ps(Masked), MakeVectorRegister(1023.0f, 1023.0f, 1023.0f, 3.0f));
+}
+
+/**
+* Converts the 4 FLOATs in the vector RGB10A2, clamped to [0, 1023] and [0, 3], and stores to unaligned memory.
+* IMPORTANT: You need to call VectorResetFloatRegisters() before using scalar FLOATs after you've used this intrinsic!
+*
+* @param Vec			Vector containing 4 FLOATs
+* @param Ptr			Unaligned memory pointer to store the packed RGB10A2(4 bytes).
+*/
+inline void VectorStoreURGB10A2N(const VectorRegister& Vec, void* Ptr)
+{
+	VectorRegister Tmp;
+	Tmp = VectorMax(Vec, MakeVectorRegister(0.0f, 0.0f, 0.0f, 0.0f));
+	Tmp = VectorMin(Tmp, MakeVectorRegister(1.0f, 1.0f, 1.0f, 1.0f));
+	Tmp = VectorMultiply(Tmp, MakeVectorRegister(1023.0f, 1023.0f, 1023.0f, 3.0f));
+
+	alignas(16) int32 Ints[4];
+	_mm_store_si128((__m128i*)Ints, _mm_cvttps_epi32(Tmp));
+
+	uint32* Out = (uint32*)Ptr;
+	*Out =
+		((uint32)Ints[0] & 0x3FF) << 00 |
+		((uint32)Ints[1] & 0x3FF) << 10 |
+		((uint32)Ints[2] & 0x3FF) << 20 |
+		((uint32)Ints[3] & 0x003) << 30;
+}
+
+/**
+* Returns non-zero if any element in Vec1 is greater than the corresponding element in Vec2, otherwise 0.
+*
+* @param Vec1			1st source vector
+* @param Vec2			2nd source vector
+* @return				Non-zero integer if (Vec1.x > Vec2.x) || (Vec1.y > Vec2.y) || (Vec1.z > Vec2.z) || (Vec1.w > Vec2.w)
+*/
+#define VectorAnyGreaterThan( Vec1, Vec2 )		_mm_movemask_ps( _mm_cmpgt_ps(Vec1, Vec2) )
+
+/**
+* Returns an integer bit-mask (0x00 - 0x0f) based on the sign-bit for each component in a vector.
+*
+* @param VecMask		Vector
+* @return				Bit 0 = sign(VecMask.x), Bit 1 = sign(VecMask.y), Bit 2 = sign(VecMask.z), Bit 3 = sign(VecMask.w)
+*/
+#define VectorMaskBits( VecMask )			_mm_movemask_ps( VecMask )
+
+/**
+* Resets the floating point registers so that they can be used again.
+* Some intrinsics use these for MMX purposes (e.g. VectorLoadByte4 and VectorStoreByte4).
+*/
+#define VectorResetFloatRegisters()
+
+/**
+* Returns the control register.
+*
+* @return			The uint32 control register
+*/
+#define VectorGetControlRegister()		_mm_getcsr()
+
+/**
+* Returns an component from a vector.
+*
+* @param Vec				Vector register
+* @param ComponentIndex	Which component to get, X=0, Y=1, Z=2, W=3
+* @return					The component as a float
+*/
+inline float VectorGetComponent(VectorRegister Vec, uint32 ComponentIndex)
+{
+	return (((float*)&(Vec))[ComponentIndex]);
+}
+
+/**
+* Sets the control register.
+*
+* @param ControlStatus		The uint32 control status value to set
+*/
+#define	VectorSetControlRegister(ControlStatus) _mm_setcsr( ControlStatus )
+
+/**
+* Control status bit to round all floating point math results towards zero.
+*/
+#define VECTOR_ROUND_TOWARD_ZERO		_MM_ROUND_TOWARD_ZERO
+
+/**
+* Computes the sine and cosine of each component of a Vector.
+*
+* @param VSinAngles	VectorRegister Pointer to where the Sin result should be stored
+* @param VCosAngles	VectorRegister Pointer to where the Cos result should be stored
+* @param VAngles VectorRegister Pointer to the input angles
+*/
+inline void VectorSinCos(VectorRegister* VSinAngles, VectorRegister* VCosAngles, const VectorRegister* VAngles)
+{
+	union { VectorRegister v; float f[4]; } VecSin, VecCos, VecAngles;
+	VecAngles.v = *VAngles;
+
+	FMath::SinCos(&VecSin.f[0], &VecCos.f[0], VecAngles.f[0]);
+	FMath::SinCos(&VecSin.f[1], &VecCos.f[1], VecAngles.f[1]);
+	FMath::SinCos(&VecSin.f[2], &VecCos.f[2], VecAngles.f[2]);
+	FMath::SinCos(&VecSin.f[3], &VecCos.f[3], VecAngles.f[3]);
+
+	*VSinAngles = VecSin.v;
+	*VCosAngles = VecCos.v;
+}
+
+// Returns true if the vector contains a component that is either NAN or +/-infinite.
+inline bool VectorContainsNaNOrInfinite(const VectorRegister& Vec)
+{
+	// an exponent of all ones is NaN or infinity
+	const VectorRegister Exponent = _mm_and_ps(Vec, GlobalVectorConstants::FloatInfinity);
+	return _mm_movemask_ps(_mm_cmpeq_ps(Exponent, GlobalVectorConstants::FloatInfinity)) != 0;
+}
+
+/** Applies a scalar FMath function to every component, for the transcendental functions that have no SSE instruction. */
+#define VECTOR_APPLY_SCALAR_1(Func, X) \
+	MakeVectorRegister(Func(VectorGetComponent(X, 0)), Func(VectorGetComponent(X, 1)), Func(VectorGetComponent(X, 2)), Func(VectorGetComponent(X, 3)))
+
+//TODO: Vectorize
+inline VectorRegister VectorExp(const VectorRegister& X)
+{
+	return VECTOR_APPLY_SCALAR_1(FMath::Exp, X);
+}
+
+//TODO: Vectorize
+inline VectorRegister VectorExp2(const VectorRegister& X)
+{
+	return VECTOR_APPLY_SCALAR_1(FMath::Exp2, X);
+}
+
+//TODO: Vectorize
+inline VectorRegister VectorLog(const VectorRegister& X)
+{
+	return VECTOR_APPLY_SCALAR_1(FMath::Loge, X);
+}
+
+//TODO: Vectorize
+inline VectorRegister VectorLog2(const VectorRegister& X)
+{
+	return VECTOR_APPLY_SCALAR_1(FMath::Log2, X);
+}
+
+//TODO: Vectorize
+inline VectorRegister VectorSin(const VectorRegister& X)
+{
+	return VECTOR_APPLY_SCALAR_1(FMath::Sin, X);
+}
+
+//TODO: Vectorize
+inline VectorRegister VectorCos(const VectorRegister& X)
+{
+	return VECTOR_APPLY_SCALAR_1(FMath::Cos, X);
+}
+
+//TODO: Vectorize
+inline VectorRegister VectorTan(const VectorRegister& X)
+{
+	return VECTOR_APPLY_SCALAR_1(FMath::Tan, X);
+}
+
+//TODO: Vectorize
+inline VectorRegister VectorASin(const VectorRegister& X)
+{
+	return VECTOR_APPLY_SCALAR_1(FMath::Asin, X);
+}
+
+//TODO: Vectorize
+inline VectorRegister VectorACos(const VectorRegister& X)
+{
+	return VECTOR_APPLY_SCALAR_1(FMath::Acos, X);
+}
+
+//TODO: Vectorize
+inline VectorRegister VectorATan(const VectorRegister& X)
+{
+	return VECTOR_APPLY_SCALAR_1(FMath::Atan, X);
+}
+
+#undef VECTOR_APPLY_SCALAR_1
+
+//TODO: Vectorize
+inline VectorRegister VectorATan2(const VectorRegister& X, const VectorRegister& Y)
+{
+	return MakeVectorRegister(FMath::Atan2(VectorGetComponent(X, 0), VectorGetComponent(Y, 0)),
+		FMath::Atan2(VectorGetComponent(X, 1), VectorGetComponent(Y, 1)),
+		FMath::Atan2(VectorGetComponent(X, 2), VectorGetComponent(Y, 2)),
+		FMath::Atan2(VectorGetComponent(X, 3), VectorGetComponent(Y, 3)));
+}
+
+#if PLATFORM_ALWAYS_HAS_SSE4_1
+inline VectorRegister VectorCeil(const VectorRegister& X)
+{
+	return _mm_ceil_ps(X);
+}
+
+inline VectorRegister VectorFloor(const VectorRegister& X)
+{
+	return _mm_floor_ps(X);
+}
+
+inline VectorRegister VectorTruncate(const VectorRegister& X)
+{
+	return _mm_round_ps(X, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+}
+#else
+inline VectorRegister VectorTruncate(const VectorRegister& X)
+{
+	// floats of 2^23 and above (and NaNs) are already integers and would overflow the int conversion, they are kept as is
+	const VectorRegister Truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(X));
+	const VectorRegister bIsSmall = _mm_cmplt_ps(_mm_and_ps(X, GlobalVectorConstants::SignMask), _mm_set1_ps(8388608.0f));
+	return _mm_or_ps(_mm_and_ps(bIsSmall, Truncated), _mm_andnot_ps(bIsSmall, X));
+}
+
+inline VectorRegister VectorCeil(const VectorRegister& X)
+{
+	const VectorRegister Truncated = VectorTruncate(X);
+	return _mm_add_ps(Truncated, _mm_and_ps(_mm_cmplt_ps(Truncated, X), GlobalVectorConstants::FloatOne));
+}
+
+inline VectorRegister VectorFloor(const VectorRegister& X)
+{
+	const VectorRegister Truncated = VectorTruncate(X);
+	return _mm_sub_ps(Truncated, _mm_and_ps(_mm_cmpgt_ps(Truncated, X), GlobalVectorConstants::FloatOne));
+}
+#endif
+
+inline VectorRegister VectorFractional(const VectorRegister& X)
+{
+	return VectorSubtract(X, VectorTruncate(X));
+}
+
+inline VectorRegister VectorMod(const VectorRegister& X, const VectorRegister& Y)
+{
+	// X - Y * trunc(X / Y), same as fmod for the finite, non zero divisors the FPU backend is used with
+	const VectorRegister Div = VectorDivide(X, Y);
+	return VectorSubtract(X, VectorMultiply(Y, VectorTruncate(Div)));
+}
+
+inline VectorRegister VectorSign(const VectorRegister& X)
+{
+	// matches the FPU backend: 1 where X >= 0, 0 elsewhere
+	return _mm_and_ps(_mm_cmpge_ps(X, GlobalVectorConstants::FloatZero), GlobalVectorConstants::FloatOne);
+}
+
+inline VectorRegister VectorStep(const VectorRegister& X)
+{
+	// matches the FPU backend: 1 where X >= 0, -1 elsewhere
+	return VectorSelect(_mm_cmpge_ps(X, GlobalVectorConstants::FloatZero), GlobalVectorConstants::FloatOne, GlobalVectorConstants::FloatMinusOne);
+}
+
+/**
+* Loads packed RGBA16(4 bytes) from unaligned memory and converts them into 4 FLOATs.
+* IMPORTANT: You need to call VectorResetFloatRegisters() before using scalar FLOATs after you've used this intrinsic!
+*
+* @param Ptr			Unaligned memory pointer to the RGBA16(8 bytes).
+* @return				VectorRegister with 4 FLOATs loaded from Ptr.
+*/
+inline VectorRegister VectorLoadURGBA16N(void* Ptr)
+{
+	const __m128i Shorts = _mm_loadl_epi64((const __m128i*)Ptr);
+#if PLATFORM_ALWAYS_HAS_SSE4_1
+	return _mm_div_ps(_mm_cvtepi32_ps(_mm_cvtepu16_epi32(Shorts)), _mm_set1_ps(65535.0f));
+#else
+	return _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(Shorts, _mm_setzero_si128())), _mm_set1_ps(65535.0f));
+#endif
+}
+
+/**
+* Loads packed signed RGBA16(4 bytes) from unaligned memory and converts them into 4 FLOATs.
+* IMPORTANT: You need to call VectorResetFloatRegisters() before using scalar FLOATs after you've used this intrinsic!
+*
+* @param Ptr			Unaligned memory pointer to the RGBA16(8 bytes).
+* @return				VectorRegister with 4 FLOATs loaded from Ptr.
+*/
+inline VectorRegister VectorLoadSRGBA16N(void* Ptr)
+{
+	const __m128i Shorts = _mm_loadl_epi64((const __m128i*)Ptr);
+#if PLATFORM_ALWAYS_HAS_SSE4_1
+	return _mm_div_ps(_mm_cvtepi32_ps(_mm_cvtepi16_epi32(Shorts)), _mm_set1_ps(32767.0f));
+#else
+	return _mm_div_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(Shorts, Shorts), 16)), _mm_set1_ps(32767.0f));
+#endif
+}
+
+/**
+* Converts the 4 FLOATs in the vector RGBA16, clamped to [0, 65535], and stores to unaligned memory.
+* IMPORTANT: You need to call VectorResetFloatRegisters() before using scalar FLOATs after you've used this intrinsic!
+*
+* @param Vec			Vector containing 4 FLOATs
+* @param Ptr			Unaligned memory pointer to store the packed RGBA16(8 bytes).
+*/
+inline void VectorStoreURGBA16N(const VectorRegister& Vec, void* Ptr)
+{
+	VectorRegister Tmp;
+	Tmp = VectorMax(Vec, MakeVectorRegister(0.0f, 0.0f, 0.0f, 0.0f));
+	Tmp = VectorMin(Tmp, MakeVectorRegister(1.0f, 1.0f, 1.0f, 1.0f));
+	Tmp = VectorMultiplyAdd(Tmp, MakeVectorRegister(65535.0f, 65535.0f, 65535.0f, 65535.0f), MakeVectorRegister(0.5f, 0.5f, 0.5f, 0.5f));
+
+	const __m128i Ints = _mm_cvttps_epi32(Tmp);
+#if PLATFORM_ALWAYS_HAS_SSE4_1
+	_mm_storel_epi64((__m128i*)Ptr, _mm_packus_epi32(Ints, Ints));
+#else
+	// the values are in [0, 65535]: biased into the int16 range for the signed pack, then the bias is flipped back
+	const __m128i Biased = _mm_sub_epi32(Ints, _mm_set1_epi32(32768));
+	_mm_storel_epi64((__m128i*)Ptr, _mm_xor_si128(_mm_packs_epi32(Biased, Biased), _mm_set1_epi16((short)0x8000)));
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+//Integer ops
+
+//Bitwise
+/** = a & b */
+#define VectorIntAnd(A, B)		_mm_and_si128(A, B)
+/** = a | b */
+#define VectorIntOr(A, B)		_mm_or_si128(A, B)
+/** = a ^ b */
+#define VectorIntXor(A, B)		_mm_xor_si128(A, B)
+/** = (~a) & b to match _mm_andnot_si128 */
+#define VectorIntAndNot(A, B)	_mm_andnot_si128(A, B)
+/** = ~a */
+#define VectorIntNot(A)	_mm_xor_si128(A, GlobalVectorConstants::IntAllMask)
+
+//Comparison
+#define VectorIntCompareEQ(A, B)	_mm_cmpeq_epi32(A,B)
+#define VectorIntCompareNEQ(A, B)	VectorIntNot(_mm_cmpeq_epi32(A,B))
+#define VectorIntCompareGT(A, B)	_mm_cmpgt_epi32(A,B)
+#define VectorIntCompareLT(A, B)	_mm_cmplt_epi32(A,B)
+#define VectorIntCompareGE(A, B)	VectorIntNot(VectorIntCompareLT(A,B))
+#define VectorIntCompareLE(A, B)	VectorIntNot(VectorIntCompareGT(A,B))
+
+
+inline VectorRegisterInt VectorIntSelect(const VectorRegisterInt& Mask, const VectorRegisterInt& Vec1, const VectorRegisterInt& Vec2)
+{
+	return _mm_xor_si128(Vec2, _mm_and_si128(Mask, _mm_xor_si128(Vec1, Vec2)));
+}
+
+//Arithmetic
+#define VectorIntAdd(A, B)	_mm_add_epi32(A, B)
+#define VectorIntSubtract(A, B)	_mm_sub_epi32(A, B)
+#define VectorIntNegate(A) VectorIntSubtract( GlobalVectorConstants::IntZero, A)
+#if PLATFORM_ALWAYS_HAS_SSE4_1
+#define VectorIntMultiply(A, B) _mm_mullo_epi32(A, B)
+#define VectorIntMin(A, B) _mm_min_epi32(A,B)
+#define VectorIntMax(A, B) _mm_max_epi32(A,B)
+#define VectorIntAbs(A) _mm_abs_epi32(A)
+#else
+inline VectorRegisterInt VectorIntMultiply(const VectorRegisterInt& A, const VectorRegisterInt& B)
+{
+	// _mm_mul_epu32 multiplies lanes 0 and 2, the low 32 bits of the products are the same signed or not
+	const __m128i Even = _mm_mul_epu32(A, B);
+	const __m128i Odd = _mm_mul_epu32(_mm_srli_si128(A, 4), _mm_srli_si128(B, 4));
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(Even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(Odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+#define VectorIntMin(A, B) VectorIntSelect(_mm_cmplt_epi32(A, B), A, B)
+#define VectorIntMax(A, B) VectorIntSelect(_mm_cmpgt_epi32(A, B), A, B)
+
+inline VectorRegisterInt VectorIntAbs(const VectorRegisterInt& A)
+{
+	const __m128i Sign = _mm_srai_epi32(A, 31);
+	return _mm_sub_epi32(_mm_xor_si128(A, Sign), Sign);
+}
+#endif
+
+#define VectorIntSign(A) VectorIntSelect( VectorIntCompareGE(A, GlobalVectorConstants::IntZero), GlobalVectorConstants::IntOne, GlobalVectorConstants::IntMinusOne )
+
+#define VectorIntToFloat(A) _mm_cvtepi32_ps(A)
+#define VectorFloatToInt(A) _mm_cvttps_epi32(A)
+
+//Loads and stores
+
+/**
+* Stores a vector to memory (aligned or unaligned).
+*
+* @param Vec	Vector to store
+* @param Ptr	Memory pointer
+*/
+#define VectorIntStore( Vec, Ptr )			_mm_storeu_si128( (__m128i*)(Ptr), Vec )
+
+/**
+* Loads 4 int32s from unaligned memory.
+*
+* @param Ptr	Unaligned memory pointer to the 4 int32s
+* @return		VectorRegisterInt(Ptr[0], Ptr[1], Ptr[2], Ptr[3])
+*/
+#define VectorIntLoad( Ptr )				_mm_loadu_si128( (__m128i*)(Ptr) )
+
+/**
+* Stores a vector to memory (aligned).
+*
+* @param Vec	Vector to store
+* @param Ptr	Aligned Memory pointer
+*/
+#define VectorIntStoreAligned( Vec, Ptr )			_mm_store_si128( (__m128i*)(Ptr), Vec )
+
+/**
+* Loads 4 int32s from aligned memory.
+*
+* @param Ptr	Aligned memory pointer to the 4 int32s
+* @return		VectorRegisterInt(Ptr[0], Ptr[1], Ptr[2], Ptr[3])
+*/
+#define VectorIntLoadAligned( Ptr )				_mm_load_si128( (__m128i*)(Ptr) )
+
+/**
+* Loads 1 int32 from unaligned memory into all components of a vector register.
+*
+* @param Ptr	Unaligned memory pointer to the 4 int32s
+* @return		VectorRegisterInt(*Ptr, *Ptr, *Ptr, *Ptr)
+*/
+#define VectorIntLoad1( Ptr )	_mm_shuffle_epi32(_mm_cvtsi32_si128(*((int32*)Ptr)),_MM_SHUFFLE(0,0,0,0))
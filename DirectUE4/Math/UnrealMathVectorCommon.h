@@ -0,0 +1,106 @@
+#pragma once
+
+/**
+* Helpers built only on top of the VectorRegister API, so they work with any backend.
+* Included at the end of VectorRegister.h; do not include directly.
+*/
+
+/**
+* Rotate a vector using a unit Quaternion.
+*
+* @param Quat Unit Quaternion to use for rotation.
+* @param VectorW0 Vector to rotate. W component must be zero.
+* @return Vector after rotation by Quat.
+*/
+inline VectorRegister VectorQuaternionRotateVector(const VectorRegister& Quat, const VectorRegister& VectorW0)
+{
+	// Q * V * Q.Inverse
+	// T = 2(Q x V);
+	// V' = V + w(T) + (Q x T)
+	const VectorRegister QW = VectorReplicate(Quat, 3);
+	VectorRegister T = VectorCross(Quat, VectorW0);
+	T = VectorAdd(T, T);
+	const VectorRegister VTemp0 = VectorMultiplyAdd(QW, T, VectorW0);
+	const VectorRegister VTemp1 = VectorCross(Quat, T);
+	const VectorRegister Rotated = VectorAdd(VTemp0, VTemp1);
+	return Rotated;
+}
+
+/**
+* Rotate a vector using the inverse of a unit Quaternion (rotation in the opposite direction).
+*
+* @param Quat Unit Quaternion to use for rotation.
+* @param VectorW0 Vector to rotate. W component must be zero.
+* @return Vector after rotation by the inverse of Quat.
+*/
+inline VectorRegister VectorQuaternionInverseRotateVector(const VectorRegister& Quat, const VectorRegister& VectorW0)
+{
+	// Q.Inverse * V * Q
+	const VectorRegister QInv = VectorMultiply(Quat, GlobalVectorConstants::QINV_SIGN_MASK);
+	return VectorQuaternionRotateVector(QInv, VectorW0);
+}
+
+/**
+* Inverse quaternion ( -X, -Y, -Z, W)
+*/
+inline VectorRegister VectorQuaternionInverse(const VectorRegister& NormalizedQuat)
+{
+	return VectorMultiply(GlobalVectorConstants::QINV_SIGN_MASK, NormalizedQuat);
+}
+
+/**
+* Returns a normalized 4 vector = Vector / |Vector|.
+* There is no handling of vectors that are too short (0 or close to 0), DefaultValue is returned for those.
+*
+* @param Vector			Vector to normalize
+* @param DefaultValue	Returned when the squared length is under SmallLengthThreshold
+* @return				Normalized VectorRegister
+*/
+inline VectorRegister VectorNormalizeSafe(const VectorRegister& Vector, const VectorRegister& DefaultValue)
+{
+	const VectorRegister SquareSum = VectorDot4(Vector, Vector);
+	const VectorRegister NonZeroMask = VectorCompareGE(SquareSum, GlobalVectorConstants::SmallLengthThreshold);
+	const VectorRegister InvLength = VectorReciprocalSqrtAccurate(SquareSum);
+	const VectorRegister NormalizedVector = VectorMultiply(InvLength, Vector);
+	return VectorSelect(NonZeroMask, NormalizedVector, DefaultValue);
+}
+
+/**
+* Normalize quaternion ( result = (Q.Q >= 1e-8) ? (Q / |Q|) : (0, 0, 0, 1) )
+*
+* @param UnnormalizedQuat	Quaternion to normalize
+* @return					Normalized quaternion, identity when the input is too short
+*/
+inline VectorRegister VectorNormalizeQuaternion(const VectorRegister& UnnormalizedQuat)
+{
+	return VectorNormalizeSafe(UnnormalizedQuat, GlobalVectorConstants::Float0001);
+}
+
+/**
+* Linear interpolation between two vectors: A + (B - A) * Alpha, same as FMath::Lerp.
+*
+* @param A		Value returned when Alpha is 0
+* @param B		Value returned when Alpha is 1
+* @param Alpha	Blend weight, replicated in all four components
+*/
+inline VectorRegister VectorLerp(const VectorRegister& A, const VectorRegister& B, const VectorRegister& Alpha)
+{
+	return VectorMultiplyAdd(Alpha, VectorSubtract(B, A), A);
+}
+
+/**
+* A and B are quaternions.  The result is A + (|A.B| >= 0 ? 1 : -1) * B
+*/
+inline VectorRegister VectorAccumulateQuaternionShortestPath(const VectorRegister& A, const VectorRegister& B)
+{
+	// Blend rotation
+	//     To ensure the 'shortest route', we make sure the dot product between the both rotations is positive.
+	//     const float Bias = (|A.B| >= 0 ? 1 : -1)
+	//     return A + B * Bias;
+	const VectorRegister Zero = VectorZero();
+	const VectorRegister RotationDot = VectorDot4(A, B);
+	const VectorRegister QuatRotationDirMask = VectorCompareGE(RotationDot, Zero);
+	const VectorRegister NegativeB = VectorSubtract(Zero, B);
+	const VectorRegister BiasTimesB = VectorSelect(QuatRotationDirMask, B, NegativeB);
+	return VectorAdd(A, BiasTimesB);
+}
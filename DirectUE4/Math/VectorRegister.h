@@ -0,0 +1,32 @@
+#pragma once
+
+/**
+* Picks the VectorRegister backend at compile time.
+* Both backends expose the same API, so callers include this header instead of a specific backend.
+* Define PLATFORM_ENABLE_VECTORINTRINSICS to 0 to force the portable FPU version (handy to diff results).
+*/
+#ifndef PLATFORM_ENABLE_VECTORINTRINSICS
+	// SSE2 is part of x64 and of x86 builds with /arch:SSE2 or -msse2
+	#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define PLATFORM_ENABLE_VECTORINTRINSICS 1
+	#else
+		#define PLATFORM_ENABLE_VECTORINTRINSICS 0
+	#endif
+#endif
+
+#ifndef PLATFORM_ALWAYS_HAS_SSE4_1
+	// only when the compiler targets it (-msse4.1, /arch:AVX or above), the SSE backend uses SSE2 sequences otherwise
+	#if defined(__SSE4_1__) || defined(__AVX__)
+		#define PLATFORM_ALWAYS_HAS_SSE4_1 1
+	#else
+		#define PLATFORM_ALWAYS_HAS_SSE4_1 0
+	#endif
+#endif
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS
+#include "UnrealMathSSE.h"
+#else
+#include "UnrealMathFPU.h"
+#endif
+
+#include "UnrealMathVectorCommon.h"
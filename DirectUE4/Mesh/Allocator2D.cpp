@@ -520,4 +520,105 @@ namespace MeshDescriptionOp
 			}
 		}
 	}
+	uint32 FAllocator2D::CountUsedBits() const
+	{
+		uint32 NumUsedBits = 0;
+		for (uint32 i = 0; i < Pitch * Height; i++)
+		{
+			for (uint64 Word = Bits[i]; Word; Word &= Word - 1)
+			{
+				NumUsedBits++;
+			}
+		}
+		return NumUsedBits;
+	}
+
+	FSkylineAllocator2D::FSkylineAllocator2D(uint32 InWidth, uint32 InHeight)
+		: Width(InWidth)
+		, Height(InHeight)
+	{
+		Clear();
+	}
+
+	void FSkylineAllocator2D::Clear()
+	{
+		Skyline.clear();
+		Skyline.push_back({ 0, 0, Width });
+	}
+
+	bool FSkylineAllocator2D::Find(FAllocator2D::FRect& Rect) const
+	{
+		uint32 BestX = ~0u;
+		uint32 BestY = ~0u;
+
+		for (size_t i = 0; i < Skyline.size() && Skyline[i].X + Rect.W <= Width; i++)
+		{
+			// The rect rests on the highest segment under it
+			uint32 Y = 0;
+			for (size_t j = i; j < Skyline.size() && Skyline[j].X < Skyline[i].X + Rect.W; j++)
+			{
+				Y = FMath::Max(Y, Skyline[j].Y);
+			}
+
+			if (Y + Rect.H <= Height && Y < BestY)
+			{
+				BestX = Skyline[i].X;
+				BestY = Y;
+			}
+		}
+
+		if (BestY == ~0u)
+		{
+			return false;
+		}
+
+		Rect.X = BestX;
+		Rect.Y = BestY;
+		return true;
+	}
+
+	void FSkylineAllocator2D::Alloc(FAllocator2D::FRect Rect)
+	{
+		const uint32 RectEnd = Rect.X + Rect.W;
+
+		std::vector< FSkylineSegment > NewSkyline;
+		NewSkyline.reserve(Skyline.size() + 2);
+		for (const FSkylineSegment& Segment : Skyline)
+		{
+			const uint32 SegmentEnd = Segment.X + Segment.W;
+			if (SegmentEnd <= Rect.X || Segment.X >= RectEnd)
+			{
+				NewSkyline.push_back(Segment);
+				continue;
+			}
+
+			// Keep whatever sticks out on either side of the rect
+			if (Segment.X < Rect.X)
+			{
+				NewSkyline.push_back({ Segment.X, Segment.Y, Rect.X - Segment.X });
+			}
+			if (Segment.X <= Rect.X)
+			{
+				NewSkyline.push_back({ Rect.X, Rect.Y + Rect.H, Rect.W });
+			}
+			if (SegmentEnd > RectEnd)
+			{
+				NewSkyline.push_back({ RectEnd, Segment.Y, SegmentEnd - RectEnd });
+			}
+		}
+
+		// Merge neighbours at the same height
+		Skyline.clear();
+		for (const FSkylineSegment& Segment : NewSkyline)
+		{
+			if (!Skyline.empty() && Skyline.back().Y == Segment.Y)
+			{
+				Skyline.back().W += Segment.W;
+			}
+			else
+			{
+				Skyline.push_back(Segment);
+			}
+		}
+	}
 }
\ No newline at end of file
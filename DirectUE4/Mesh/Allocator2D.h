@@ -62,6 +62,9 @@ namespace MeshDescriptionOp
 		void		FlipX(FRect Rect);
 		void		FlipY(FRect Rect);
 
+		/** Number of set bits, the texels taken by everything allocated so far */
+		uint32		CountUsedBits() const;
+
 	protected:
 		bool		TestAllRows(FRect Rect, const FAllocator2D& Other, uint32& FailedLength);
 		bool		TestRow(const FRow& ThisRow, const FRow& OtherRow, FRect Rect, uint32& FailedLength);
@@ -80,6 +83,36 @@ namespace MeshDescriptionOp
 		int32		LastRowFail;
 	};
 
+	/**
+	 * Bottom-left skyline allocator for whole rects. Only the top edge of everything allocated so far is kept, so the space
+	 * under an overhang is lost, but finding a spot is linear in the number of skyline segments instead of in texels.
+	 */
+	class FSkylineAllocator2D
+	{
+	public:
+		FSkylineAllocator2D(uint32 Width, uint32 Height);
+
+		void		Clear();
+
+		/** Finds the lowest, then leftmost, spot that fits Rect.W x Rect.H and writes it to Rect.X and Rect.Y */
+		bool		Find(FAllocator2D::FRect& Rect) const;
+		void		Alloc(FAllocator2D::FRect Rect);
+
+	private:
+		struct FSkylineSegment
+		{
+			uint32 X;
+			uint32 Y;
+			uint32 W;
+		};
+
+		uint32		Width;
+		uint32		Height;
+
+		// left to right, covering [0, Width) without gaps
+		std::vector< FSkylineSegment > Skyline;
+	};
+
 	// Returns non-zero if set
 	inline uint64 FAllocator2D::GetBit(uint32 x, uint32 y) const
 	{
@@ -9,8 +9,14 @@
 #include "AssetImportData.h"
 #include "AnimTypes.h"
 #include "forsythtriangleorderoptimizer.h"
+#include "MeshOptimization.h"
+#include "MeshReduction.h"
+#include "MeshDescriptionOperations.h"
+#include "SecureHash.h"
+#include "ParallelFor.h"
 
 #include <algorithm>
+#include <fstream>
 
 // Get the geometry deformation local to a node. It is never inherited by the
 // children.
@@ -449,8 +455,40 @@ struct FBXUVs
 };
 
 
+bool FBXImporter::HashSourceFile(const char* pFileName, FSHAHash& OutHash)
+{
+	std::ifstream File(pFileName, std::ios::in | std::ios::binary | std::ios::ate);
+	if (!File.is_open())
+	{
+		return false;
+	}
+	std::vector<uint8> FileData((size_t)File.tellg());
+	File.seekg(0, std::ios::beg);
+	File.read((char*)FileData.data(), FileData.size());
+	if (!File.good())
+	{
+		return false;
+	}
+	FSHA1::HashBuffer(FileData.data(), (uint32)FileData.size(), OutHash.Hash);
+	return true;
+}
+
 UStaticMesh* FBXImporter::ImportStaticMesh(class AActor* InOwner, const char* pFileName)
 {
+	// the built render data only depends on the file and the build settings, skip the import if it's already cached
+	FSHAHash SourceHash;
+	const bool bHasSourceHash = HashSourceFile(pFileName, SourceHash);
+	if (bHasSourceHash)
+	{
+		UStaticMesh* CachedMesh = new UStaticMesh(InOwner);
+		CachedMesh->SetSourceHash(SourceHash);
+		if (CachedMesh->PostLoadFromDerivedData())
+		{
+			return CachedMesh;
+		}
+		delete CachedMesh;
+	}
+
 	FbxManager* lFbxManager = FbxManager::Create();
 
 	FbxIOSettings* lIOSetting = FbxIOSettings::Create(lFbxManager, IOSROOT);
@@ -465,6 +503,10 @@ UStaticMesh* FBXImporter::ImportStaticMesh(class AActor* InOwner, const char* pF
 	}
 
 	UStaticMesh* Mesh = new UStaticMesh(InOwner);
+	if (bHasSourceHash)
+	{
+		Mesh->SetSourceHash(SourceHash);
+	}
 	MeshDescription& MD = Mesh->GetMeshDescription();
 
 	FbxScene* lScene = FbxScene::Create(lFbxManager, "Mesh");
@@ -608,18 +650,18 @@ UStaticMesh* FBXImporter::ImportStaticMesh(class AActor* InOwner, const char* pF
 			TotalMatrixForNormal = TotalMatrixForNormal.Transpose();
 			int PolygonCount = lMesh->GetPolygonCount();
 
-			std::vector<FVector>& VertexPositions = MD.VertexAttributes().GetAttributes<FVector>(MeshAttribute::Vertex::Position);
+			TMeshAttributesRef<FVector> VertexPositions = MD.VertexAttributes().GetAttributesRef<FVector>(MeshAttribute::Vertex::Position);
 
-			std::vector<FVector>& VertexInstanceNormals = MD.VertexInstanceAttributes().GetAttributes<FVector>(MeshAttribute::VertexInstance::Normal);
-			std::vector<FVector>& VertexInstanceTangents = MD.VertexInstanceAttributes().GetAttributes<FVector>(MeshAttribute::VertexInstance::Tangent);
-			std::vector<float>& VertexInstanceBinormalSigns = MD.VertexInstanceAttributes().GetAttributes<float>(MeshAttribute::VertexInstance::BinormalSign);
-			std::vector<Vector4>& VertexInstanceColors = MD.VertexInstanceAttributes().GetAttributes<Vector4>(MeshAttribute::VertexInstance::Color);
-			std::vector<std::vector<Vector2>>& VertexInstanceUVs = MD.VertexInstanceAttributes().GetAttributesSet<Vector2>(MeshAttribute::VertexInstance::TextureCoordinate);
+			TMeshAttributesRef<FVector> VertexInstanceNormals = MD.VertexInstanceAttributes().GetAttributesRef<FVector>(MeshAttribute::VertexInstance::Normal);
+			TMeshAttributesRef<FVector> VertexInstanceTangents = MD.VertexInstanceAttributes().GetAttributesRef<FVector>(MeshAttribute::VertexInstance::Tangent);
+			TMeshAttributesRef<float> VertexInstanceBinormalSigns = MD.VertexInstanceAttributes().GetAttributesRef<float>(MeshAttribute::VertexInstance::BinormalSign);
+			TMeshAttributesRef<Vector4> VertexInstanceColors = MD.VertexInstanceAttributes().GetAttributesRef<Vector4>(MeshAttribute::VertexInstance::Color);
+			TMeshAttributesRef<Vector2> VertexInstanceUVs = MD.VertexInstanceAttributes().GetAttributesRef<Vector2>(MeshAttribute::VertexInstance::TextureCoordinate);
 
-			std::vector<bool>& EdgeHardnesses = MD.EdgeAttributes().GetAttributes<bool>(MeshAttribute::Edge::IsHard);
-			std::vector<float>& EdgeCreaseSharpnesses = MD.EdgeAttributes().GetAttributes<float>(MeshAttribute::Edge::CreaseSharpness);
+			TMeshAttributesRef<bool> EdgeHardnesses = MD.EdgeAttributes().GetAttributesRef<bool>(MeshAttribute::Edge::IsHard);
+			TMeshAttributesRef<float> EdgeCreaseSharpnesses = MD.EdgeAttributes().GetAttributesRef<float>(MeshAttribute::Edge::CreaseSharpness);
 
-			std::vector<std::string>& PolygonGroupImportedMaterialSlotNames = MD.PolygonGroupAttributes().GetAttributes<std::string>(MeshAttribute::PolygonGroup::ImportedMaterialSlotName);
+			TMeshAttributesRef<std::string> PolygonGroupImportedMaterialSlotNames = MD.PolygonGroupAttributes().GetAttributesRef<std::string>(MeshAttribute::PolygonGroup::ImportedMaterialSlotName);
 
 			int VertexCount = lMesh->GetControlPointsCount();
 			int VertexOffset = MD.Vertices().Num();
@@ -629,9 +671,9 @@ UStaticMesh* FBXImporter::ImportStaticMesh(class AActor* InOwner, const char* pF
 			std::map<int, int> PolygonGroupMapping;
 
 			int ExistingUVCount = 0;
-			for (int UVChannelIndex = 0; UVChannelIndex < (int)VertexInstanceUVs.size(); ++UVChannelIndex)
+			for (int UVChannelIndex = 0; UVChannelIndex < VertexInstanceUVs.GetNumIndices(); ++UVChannelIndex)
 			{
-				if (VertexInstanceUVs[UVChannelIndex].size() > 0)
+				if (VertexInstanceUVs.GetRawArray(UVChannelIndex).size() > 0)
 				{
 					ExistingUVCount++;
 				}
@@ -647,7 +689,13 @@ UStaticMesh* FBXImporter::ImportStaticMesh(class AActor* InOwner, const char* pF
 			NumUVs = (std::max)(1, NumUVs);
 
 			//Make sure all Vertex instance have the correct number of UVs
-			VertexInstanceUVs.resize(NumUVs);
+			VertexInstanceUVs.SetNumIndices(NumUVs);
+
+			// every element of this mesh is created one by one below, grow the containers once up front
+			MD.ReserveNewVertices(VertexCount);
+			MD.ReserveNewVertexInstances(lMesh->GetPolygonVertexCount());
+			MD.ReserveNewEdges(lMesh->GetMeshEdgeCount());
+			MD.ReserveNewPolygons(PolygonCount);
 
 			for (auto VertexIndex = 0; VertexIndex < VertexCount; ++VertexIndex)
 			{
@@ -728,7 +776,7 @@ UStaticMesh* FBXImporter::ImportStaticMesh(class AActor* InOwner, const char* pF
 							FinalUVVector.X = static_cast<float>(UVVector[0]);
 							FinalUVVector.Y = 1.f - static_cast<float>(UVVector[1]);   //flip the Y of UVs for DirectX
 						}
-						VertexInstanceUVs[UVLayerIndex][AddedVertexInstanceId] = FinalUVVector;
+						VertexInstanceUVs.Set(AddedVertexInstanceId, UVLayerIndex, FinalUVVector);
 					}
 
 					if (LayerElementVertexColor)
@@ -867,9 +915,7 @@ UStaticMesh* FBXImporter::ImportStaticMesh(class AActor* InOwner, const char* pF
 				}
 
 				int PolygonGroupID = PolygonGroupID = PolygonGroupMapping[RealMaterialIndex];
-				const int NewPolygonID = MD.CreatePolygon(PolygonGroupID, Contours);
-				MeshPolygon& Polygon = MD.GetPolygon(NewPolygonID);
-				MD.ComputePolygonTriangulation(NewPolygonID, Polygon.Triangles);
+				MD.CreatePolygon(PolygonGroupID, Contours);
 			}
 			lMesh->EndGetMeshEdgeIndexForPolygon();
 
@@ -880,6 +926,8 @@ UStaticMesh* FBXImporter::ImportStaticMesh(class AActor* InOwner, const char* pF
 	delete GeometryConverter;
 	GeometryConverter = nullptr;
 
+	MeshDescriptionOperations::ComputePolygonTriangulations(MD);
+
 	Mesh->PostLoad();
 
 	return Mesh;
@@ -934,64 +982,107 @@ void ProcessImportMeshInfluences(FSkeletalMeshImportData& ImportData)
 	std::vector<VVertex>& Wedges = ImportData.Wedges;
 	std::vector<VRawBoneInfluence>& Influences = ImportData.Influences;
 
+	// Within a vertex, heaviest influences first
 	struct FCompareVertexIndex
 	{
 		bool operator()(const VRawBoneInfluence& A, const VRawBoneInfluence& B) const
 		{
-			if (A.VertexIndex > B.VertexIndex) return false;
-			else if (A.VertexIndex < B.VertexIndex) return true;
-			else if (A.Weight < B.Weight) return false;
+			if (A.Weight < B.Weight) return false;
 			else if (A.Weight > B.Weight) return true;
 			else if (A.BoneIndex > B.BoneIndex) return false;
 			else if (A.BoneIndex < B.BoneIndex) return true;
 			else									  return  false;
 		}
 	};
-	std::sort(Influences.begin(), Influences.end(), FCompareVertexIndex());
 
-	std::vector<VRawBoneInfluence> NewInfluences;
-	int32	LastNewInfluenceIndex = 0;
-	int32	LastVertexIndex = INDEX_NONE;
-	int32	InfluenceCount = 0;
+	// Group the influences by vertex with a counting sort, so the groups can be sorted and processed on their own
+	int32 MinVertexIndex = MAX_int32;
+	int32 MaxVertexIndex = MIN_int32;
+	for (const VRawBoneInfluence& Influence : Influences)
+	{
+		MinVertexIndex = FMath::Min(MinVertexIndex, Influence.VertexIndex);
+		MaxVertexIndex = FMath::Max(MaxVertexIndex, Influence.VertexIndex);
+	}
 
-	float TotalWeight = 0.f;
-	const float MINWEIGHT = 0.01f;
+	std::vector<int32> GroupStarts;
+	if (Influences.size() > 0)
+	{
+		std::vector<int32> VertexStarts((size_t)MaxVertexIndex - MinVertexIndex + 2, 0);
+		for (const VRawBoneInfluence& Influence : Influences)
+		{
+			VertexStarts[Influence.VertexIndex - MinVertexIndex + 1]++;
+		}
+		for (uint32 i = 1; i < VertexStarts.size(); i++)
+		{
+			if (VertexStarts[i] > 0)
+			{
+				GroupStarts.push_back(VertexStarts[i - 1]);
+			}
+			VertexStarts[i] += VertexStarts[i - 1];
+		}
+		GroupStarts.push_back((int32)Influences.size());
 
-	int MaxVertexInfluence = 0;
-	float MaxIgnoredWeight = 0.0f;
+		std::vector<VRawBoneInfluence> SortedInfluences(Influences.size());
+		for (const VRawBoneInfluence& Influence : Influences)
+		{
+			SortedInfluences[VertexStarts[Influence.VertexIndex - MinVertexIndex]++] = Influence;
+		}
+		Influences.swap(SortedInfluences);
+	}
+	const int32 NumGroups = GroupStarts.empty() ? 0 : (int32)GroupStarts.size() - 1;
 
-	for (uint32 i = 0; i < Influences.size(); i++)
+	const float MINWEIGHT = 0.01f;
+
+	// Sort and normalize every vertex's influences, then keep the ones above the min weight, at most MAX_TOTAL_INFLUENCES of them.
+	// The kept ones are normalized again, except for the last vertex.
+	std::vector<int32> GroupNumKept(NumGroups);
+	ParallelFor(NumGroups, [&](int32 GroupIndex)
 	{
-		// if less than min weight, or it's more than 8, then we clear it to use weight
-		InfluenceCount++;
-		TotalWeight += Influences[i].Weight;
-		// we have all influence for the same vertex, normalize it now
-		if (i + 1 >= Influences.size() || Influences[i].VertexIndex != Influences[i + 1].VertexIndex)
+		VRawBoneInfluence* GroupInfluences = Influences.data() + GroupStarts[GroupIndex];
+		const int32 InfluenceCount = GroupStarts[GroupIndex + 1] - GroupStarts[GroupIndex];
+		std::sort(GroupInfluences, GroupInfluences + InfluenceCount, FCompareVertexIndex());
+
+		float TotalWeight = 0.f;
+		for (int32 r = 0; r < InfluenceCount; r++)
 		{
-			// Normalize the last set of influences.
-			if (InfluenceCount && (TotalWeight != 1.0f))
+			TotalWeight += GroupInfluences[r].Weight;
+		}
+		if (TotalWeight != 1.0f)
+		{
+			float OneOverTotalWeight = 1.f / TotalWeight;
+			for (int32 r = 0; r < InfluenceCount; r++)
 			{
-				float OneOverTotalWeight = 1.f / TotalWeight;
-				for (int r = 0; r < InfluenceCount; r++)
-				{
-					Influences[i - r].Weight *= OneOverTotalWeight;
-				}
+				GroupInfluences[r].Weight *= OneOverTotalWeight;
 			}
+		}
 
-			if (MaxVertexInfluence < InfluenceCount)
+		// Move the kept influences to the front of the group
+		int32 NumKept = 0;
+		TotalWeight = 0.f;
+		for (int32 r = 0; r < InfluenceCount; r++)
+		{
+			// if less than min weight, or it's more than 8, then we clear it to use weight
+			if (GroupInfluences[r].Weight > MINWEIGHT && NumKept < MAX_TOTAL_INFLUENCES)
 			{
-				MaxVertexInfluence = InfluenceCount;
+				GroupInfluences[NumKept++] = GroupInfluences[r];
+				TotalWeight += GroupInfluences[r].Weight;
 			}
-
-			// clear to count next one
-			InfluenceCount = 0;
-			TotalWeight = 0.f;
 		}
-
-		if (InfluenceCount > MAX_TOTAL_INFLUENCES &&  Influences[i].Weight > MaxIgnoredWeight)
+		if (GroupIndex + 1 < NumGroups && NumKept && (TotalWeight != 1.0f))
 		{
-			MaxIgnoredWeight = Influences[i].Weight;
+			float OneOverTotalWeight = 1.f / TotalWeight;
+			for (int32 r = 0; r < NumKept; r++)
+			{
+				GroupInfluences[r].Weight *= OneOverTotalWeight;
+			}
 		}
+		GroupNumKept[GroupIndex] = NumKept;
+	}, !GParallelMeshBuild);
+
+	int MaxVertexInfluence = 0;
+	for (int32 GroupIndex = 0; GroupIndex < NumGroups; GroupIndex++)
+	{
+		MaxVertexInfluence = FMath::Max(MaxVertexInfluence, GroupStarts[GroupIndex + 1] - GroupStarts[GroupIndex]);
 	}
 
 	if (MaxVertexInfluence > MAX_TOTAL_INFLUENCES)
@@ -999,51 +1090,36 @@ void ProcessImportMeshInfluences(FSkeletalMeshImportData& ImportData)
 		assert(false);
 	}
 
-	for (uint32 i = 0; i < Influences.size(); i++)
+	// Vertices between two influenced ones get a single influence of the root bone ahead of the next group
+	std::vector<int32> GroupNewStarts(NumGroups + 1, 0);
+	for (int32 GroupIndex = 0; GroupIndex < NumGroups; GroupIndex++)
 	{
-		// we found next verts, normalize it now
-		if (LastVertexIndex != Influences[i].VertexIndex)
+		int32 NumMissing = 0;
+		if (GroupIndex > 0)
 		{
-			// Normalize the last set of influences.
-			if (InfluenceCount && (TotalWeight != 1.0f))
-			{
-				float OneOverTotalWeight = 1.f / TotalWeight;
-				for (int r = 0; r < InfluenceCount; r++)
-				{
-					NewInfluences[LastNewInfluenceIndex - r].Weight *= OneOverTotalWeight;
-				}
-			}
-
-			// now we insert missing verts
-			if (LastVertexIndex != INDEX_NONE)
-			{
-				int32 CurrentVertexIndex = Influences[i].VertexIndex;
-				for (int32 j = LastVertexIndex + 1; j < CurrentVertexIndex; j++)
-				{
-					// Add a 0-bone weight if none other present (known to happen with certain MAX skeletal setups).
-					LastNewInfluenceIndex = (int32)NewInfluences.size();
-					NewInfluences.push_back(VRawBoneInfluence());
-					NewInfluences[LastNewInfluenceIndex].VertexIndex = j;
-					NewInfluences[LastNewInfluenceIndex].BoneIndex = 0;
-					NewInfluences[LastNewInfluenceIndex].Weight = 1.f;
-				}
-			}
-
-			// clear to count next one
-			InfluenceCount = 0;
-			TotalWeight = 0.f;
-			LastVertexIndex = Influences[i].VertexIndex;
+			NumMissing = Influences[GroupStarts[GroupIndex]].VertexIndex - Influences[GroupStarts[GroupIndex - 1]].VertexIndex - 1;
 		}
+		GroupNewStarts[GroupIndex + 1] = GroupNewStarts[GroupIndex] + NumMissing + GroupNumKept[GroupIndex];
+	}
 
-		// if less than min weight, or it's more than 8, then we clear it to use weight
-		if (Influences[i].Weight > MINWEIGHT && InfluenceCount < MAX_TOTAL_INFLUENCES)
+	std::vector<VRawBoneInfluence> NewInfluences(GroupNewStarts[NumGroups]);
+	ParallelFor(NumGroups, [&](int32 GroupIndex)
+	{
+		const VRawBoneInfluence* GroupInfluences = Influences.data() + GroupStarts[GroupIndex];
+		const int32 NumKept = GroupNumKept[GroupIndex];
+		const int32 NumMissing = GroupNewStarts[GroupIndex + 1] - GroupNewStarts[GroupIndex] - NumKept;
+
+		VRawBoneInfluence* Dest = NewInfluences.data() + GroupNewStarts[GroupIndex];
+		for (int32 j = 0; j < NumMissing; j++)
 		{
-			LastNewInfluenceIndex = (int32)NewInfluences.size();
-			NewInfluences.push_back(Influences[i]);
-			InfluenceCount++;
-			TotalWeight += Influences[i].Weight;
+			// Add a 0-bone weight if none other present (known to happen with certain MAX skeletal setups).
+			Dest->VertexIndex = GroupInfluences[0].VertexIndex - NumMissing + j;
+			Dest->BoneIndex = 0;
+			Dest->Weight = 1.f;
+			Dest++;
 		}
-	}
+		std::copy(GroupInfluences, GroupInfluences + NumKept, Dest);
+	}, !GParallelMeshBuild);
 
 	Influences = NewInfluences;
 
@@ -1080,7 +1156,7 @@ void ProcessImportMeshInfluences(FSkeletalMeshImportData& ImportData)
 	}
 }
 
-USkeletalMesh* FBXImporter::ImportSkeletalMesh(class AActor* InOwner, const char* pFileName)
+USkeletalMesh* FBXImporter::ImportSkeletalMesh(class AActor* InOwner, const char* pFileName, const std::vector<float>& BoneReductionLODScreenSizes)
 {
 	ImportOptions = new FBXImportOptions();
 	ImportOptions->bImportScene = false;
@@ -1226,6 +1302,12 @@ USkeletalMesh* FBXImporter::ImportSkeletalMesh(class AActor* InOwner, const char
 
 	}
 
+	// bone reduction LODs share the LOD 0 geometry, they only skin fewer bones once the mesh gets small on screen
+	if (BoneReductionLODScreenSizes.size() > 0)
+	{
+		NewSekeletalMesh->AddLeafBoneReductionLODs(BoneReductionLODScreenSizes);
+	}
+
 	NewSekeletalMesh->PostLoad();
 
 	return NewSekeletalMesh;
@@ -2745,7 +2827,11 @@ void FBXImporter::SkinControlPointsToPose(FSkeletalMeshImportData &ImportData, F
 			}
 		}
 
-		for (i = 0; i < VertexCount; i++)
+		int32 ExistPointNum = ImportData.Points.size();
+		int32 StartPointIndex = ExistPointNum - VertexCount;
+
+		// Deform every vertex by its own summed deformations and change its position, in parallel
+		ParallelFor(VertexCount, [&](int32 i)
 		{
 			FbxVector4 lSrcVertex = VertexArray[i];
 			FbxVector4& lDstVertex = VertexArray[i];
@@ -2768,15 +2854,9 @@ void FBXImporter::SkinControlPointsToPose(FSkeletalMeshImportData &ImportData, F
 					lDstVertex += lSrcVertex;
 				}
 			}
-		}
 
-		// change the vertex position
-		int32 ExistPointNum = ImportData.Points.size();
-		int32 StartPointIndex = ExistPointNum - VertexCount;
-		for (int32 ControlPointsIndex = 0; ControlPointsIndex < VertexCount; ControlPointsIndex++)
-		{
-			ImportData.Points[ControlPointsIndex + StartPointIndex] = ConvertPos(MeshMatrix.MultT(VertexArray[ControlPointsIndex]));
-		}
+			ImportData.Points[i + StartPointIndex] = ConvertPos(MeshMatrix.MultT(lDstVertex));
+		}, !GParallelMeshBuild);
 
 	}
 
@@ -3190,11 +3270,6 @@ inline bool PointsEqual(const FVector& V1, const FVector& V2, float ComparisonTh
 	}
 	return true;
 }
-inline bool PointsEqual(const FVector& V1, const FVector& V2, const FOverlappingThresholds& OverlappingThreshold)
-{
-	const float Epsilon = OverlappingThreshold.ThresholdPosition;
-	return FMath::Abs(V1.X - V2.X) <= Epsilon && FMath::Abs(V1.Y - V2.Y) <= Epsilon && FMath::Abs(V1.Z - V2.Z) <= Epsilon;
-}
 /**
 * Returns true if the specified points are about equal
 */
@@ -3203,24 +3278,11 @@ inline bool PointsEqual(const FVector& V1, const FVector& V2, bool bUseEpsilonCo
 	const float Epsilon = bUseEpsilonCompare ? THRESH_POINTS_ARE_SAME : 0.0f;
 	return FMath::Abs(V1.X - V2.X) <= Epsilon && FMath::Abs(V1.Y - V2.Y) <= Epsilon && FMath::Abs(V1.Z - V2.Z) <= Epsilon;
 }
-inline bool NormalsEqual(const FVector& V1, const FVector& V2, const FOverlappingThresholds& OverlappingThreshold)
-{
-	const float Epsilon = OverlappingThreshold.ThresholdTangentNormal;
-	return FMath::Abs(V1.X - V2.X) <= Epsilon && FMath::Abs(V1.Y - V2.Y) <= Epsilon && FMath::Abs(V1.Z - V2.Z) <= Epsilon;
-}
-
 inline bool UVsEqual(const Vector2& V1, const Vector2& V2)
 {
 	const float Epsilon = 1.0f / 1024.0f;
 	return FMath::Abs(V1.X - V2.X) <= Epsilon && FMath::Abs(V1.Y - V2.Y) <= Epsilon;
 }
-inline bool UVsEqual(const Vector2& V1, const Vector2& V2, const FOverlappingThresholds& OverlappingThreshold)
-{
-	const float Epsilon = OverlappingThreshold.ThresholdUV;
-	return FMath::Abs(V1.X - V2.X) <= Epsilon && FMath::Abs(V1.Y - V2.Y) <= Epsilon;
-}
-
-
 /** Helper struct for building acceleration structures. */
 struct FIndexAndZ
 {
@@ -4028,23 +4090,30 @@ public:
 
 		// Find wedge influences.
 		std::vector<int32>	WedgeInfluenceIndices;
-		std::map<uint32, uint32> VertexIndexToInfluenceIndexMap;
+		// First influence of every vertex, influences are sorted by vertex
+		std::vector<int32> VertexIndexToInfluenceIndexMap(BuildData.Points.size(), INDEX_NONE);
 
 		for (uint32 LookIdx = 0; LookIdx < (uint32)BuildData.Influences.size(); LookIdx++)
 		{
+			const uint32 VertIndex = (uint32)BuildData.Influences[LookIdx].VertIndex;
+			if (VertIndex >= VertexIndexToInfluenceIndexMap.size())
+			{
+				VertexIndexToInfluenceIndexMap.resize(VertIndex + 1, INDEX_NONE);
+			}
 			// Order matters do not allow the map to overwrite an existing value.
-			if (VertexIndexToInfluenceIndexMap.find(BuildData.Influences[LookIdx].VertIndex) == VertexIndexToInfluenceIndexMap.end())
+			if (VertexIndexToInfluenceIndexMap[VertIndex] == INDEX_NONE)
 			{
-				VertexIndexToInfluenceIndexMap.insert(std::make_pair(BuildData.Influences[LookIdx].VertIndex, LookIdx) );
+				VertexIndexToInfluenceIndexMap[VertIndex] = LookIdx;
 			}
 		}
 
+		WedgeInfluenceIndices.reserve(BuildData.Wedges.size());
 		for (uint32 WedgeIndex = 0; WedgeIndex < BuildData.Wedges.size(); WedgeIndex++)
 		{
-			auto it = VertexIndexToInfluenceIndexMap.find(BuildData.Wedges[WedgeIndex].iVertex);
-			if (it != VertexIndexToInfluenceIndexMap.end())
+			const uint32 VertIndex = BuildData.Wedges[WedgeIndex].iVertex;
+			if (VertIndex < VertexIndexToInfluenceIndexMap.size() && VertexIndexToInfluenceIndexMap[VertIndex] != INDEX_NONE)
 			{
-				WedgeInfluenceIndices.push_back(it->second);
+				WedgeInfluenceIndices.push_back(VertexIndexToInfluenceIndexMap[VertIndex]);
 			}
 			else
 			{
@@ -4067,19 +4136,16 @@ public:
 
 		assert(BuildData.Wedges.size() == WedgeInfluenceIndices.size());
 
-		std::vector<FSkeletalMeshVertIndexAndZ> VertIndexAndZ;
-		std::vector<FSoftSkinBuildVertex> RawVertices;
+		// Every face corner becomes a raw vertex of its own, welded by BuildSkeletalMeshChunks
+		std::vector<FSoftSkinBuildVertex> RawVertices(BuildData.Faces.size() * 3);
 
-		VertIndexAndZ.clear();
-		RawVertices.reserve(BuildData.Points.size());
-
-		for (uint32 FaceIndex = 0; FaceIndex < BuildData.Faces.size(); FaceIndex++)
+		ParallelFor((int32)BuildData.Faces.size(), [&](int32 FaceIndex)
 		{
 			const FMeshFace& Face = BuildData.Faces[FaceIndex];
 
 			for (int32 VertexIndex = 0; VertexIndex < 3; VertexIndex++)
 			{
-				FSoftSkinBuildVertex Vertex;
+				FSoftSkinBuildVertex& Vertex = RawVertices[FaceIndex * 3 + VertexIndex];
 				const uint32 WedgeIndex = BuildData.GetWedgeIndex(FaceIndex, VertexIndex);
 				const FMeshWedge& Wedge = BuildData.Wedges[WedgeIndex];
 
@@ -4139,21 +4205,11 @@ public:
 
 				// Add the vertex as well as its original index in the points array
 				Vertex.PointWedgeIdx = Wedge.iVertex;
-
-				RawVertices.push_back(Vertex);
-				int32 RawIndex = RawVertices.size() - 1;
-
-				// Add an efficient way to find dupes of this vertex later for fast combining of vertices
-				FSkeletalMeshVertIndexAndZ IAndZ;
-				IAndZ.Index = RawIndex;
-				IAndZ.Z = Vertex.Position.Z;
-
-				VertIndexAndZ.push_back(IAndZ);
 			}
-		}
+		}, !GParallelMeshBuild);
 
 		// Generate chunks and their vertices and indices
-		SkeletalMeshTools::BuildSkeletalMeshChunks(BuildData.Faces, RawVertices, VertIndexAndZ, BuildData.BuildOptions.OverlappingThresholds, BuildData.Chunks, BuildData.bTooManyVerts);
+		SkeletalMeshTools::BuildSkeletalMeshChunks(BuildData.Faces, RawVertices, BuildData.BuildOptions.OverlappingThresholds, BuildData.Chunks, BuildData.bTooManyVerts);
 
 		// Chunk vertices to satisfy the requested limit.
 		const uint32 MaxGPUSkinBones = 256 /*FGPUBaseSkinVertexFactory::GetMaxGPUSkinBones()*/;
@@ -4267,60 +4323,6 @@ void FOverlappingCorners::FinishAdding()
 }
 
 
-bool SkeletalMeshTools::AreSkelMeshVerticesEqual(const FSoftSkinBuildVertex& V1, const FSoftSkinBuildVertex& V2, const FOverlappingThresholds& OverlappingThresholds)
-{
-	if (!PointsEqual(V1.Position, V2.Position, OverlappingThresholds))
-	{
-		return false;
-	}
-
-	for (int32 UVIdx = 0; UVIdx < 4/*MAX_TEXCOORDS*/; ++UVIdx)
-	{
-		if (!UVsEqual(V1.UVs[UVIdx], V2.UVs[UVIdx], OverlappingThresholds))
-		{
-			return false;
-		}
-	}
-
-	if (!NormalsEqual(V1.TangentX, V2.TangentX, OverlappingThresholds))
-	{
-		return false;
-	}
-
-	if (!NormalsEqual(V1.TangentY, V2.TangentY, OverlappingThresholds))
-	{
-		return false;
-	}
-
-	if (!NormalsEqual(V1.TangentZ, V2.TangentZ, OverlappingThresholds))
-	{
-		return false;
-	}
-
-	bool	InfluencesMatch = 1;
-	for (uint32 InfluenceIndex = 0; InfluenceIndex < MAX_TOTAL_INFLUENCES; InfluenceIndex++)
-	{
-		if (V1.InfluenceBones[InfluenceIndex] != V2.InfluenceBones[InfluenceIndex] ||
-			V1.InfluenceWeights[InfluenceIndex] != V2.InfluenceWeights[InfluenceIndex])
-		{
-			InfluencesMatch = 0;
-			break;
-		}
-	}
-
-	if (V1.Color != V2.Color)
-	{
-		return false;
-	}
-
-	if (!InfluencesMatch)
-	{
-		return false;
-	}
-
-	return true;
-}
-
 // uint32 FOverlappingCorners::GetAllocatedSize(void) const
 // {
 // 	uint32 BaseMemoryAllocated = IndexBelongsTo.GetAllocatedSize() + Arrays.GetAllocatedSize() + Sets.GetAllocatedSize();
@@ -4340,249 +4342,6 @@ bool SkeletalMeshTools::AreSkelMeshVerticesEqual(const FSoftSkinBuildVertex& V1,
 // 	return BaseMemoryAllocated + ArraysMemory + SetsMemory;
 // }
 
-void SkeletalMeshTools::BuildSkeletalMeshChunks(const std::vector<FMeshFace>& Faces, const std::vector<FSoftSkinBuildVertex>& RawVertices, std::vector<FSkeletalMeshVertIndexAndZ>& RawVertIndexAndZ, const FOverlappingThresholds &OverlappingThresholds, std::vector<FSkinnedMeshChunk*>& OutChunks, bool& bOutTooManyVerts)
-{
-	std::vector<int32> DupVerts;
-
-	std::multimap<int32, int32> RawVerts2Dupes;
-	{
-
-		// Sorting function for vertex Z/index pairs
-		struct FCompareFSkeletalMeshVertIndexAndZ
-		{
-			FORCEINLINE bool operator()(const FSkeletalMeshVertIndexAndZ& A, const FSkeletalMeshVertIndexAndZ& B) const
-			{
-				return A.Z < B.Z;
-			}
-		};
-
-		// Sort the vertices by z value
-		//RawVertIndexAndZ.Sort(FCompareFSkeletalMeshVertIndexAndZ());
-		std::sort(RawVertIndexAndZ.begin(), RawVertIndexAndZ.end(), FCompareFSkeletalMeshVertIndexAndZ());
-
-		// Search for duplicates, quickly!
-		for (uint32 i = 0; i < RawVertIndexAndZ.size(); i++)
-		{
-			// only need to search forward, since we add pairs both ways
-			for (uint32 j = i + 1; j < RawVertIndexAndZ.size(); j++)
-			{
-				if (FMath::Abs(RawVertIndexAndZ[j].Z - RawVertIndexAndZ[i].Z) > OverlappingThresholds.ThresholdPosition)
-				{
-					// our list is sorted, so there can't be any more dupes
-					break;
-				}
-
-				// check to see if the points are really overlapping
-				if (PointsEqual(
-					RawVertices[RawVertIndexAndZ[i].Index].Position,
-					RawVertices[RawVertIndexAndZ[j].Index].Position, OverlappingThresholds))
-				{
-					RawVerts2Dupes.insert(std::make_pair(RawVertIndexAndZ[i].Index, RawVertIndexAndZ[j].Index) );
-					RawVerts2Dupes.insert(std::make_pair(RawVertIndexAndZ[j].Index, RawVertIndexAndZ[i].Index));
-				}
-			}
-		}
-	}
-
-	std::map<FSkinnedMeshChunk*, std::map<int32, int32> > ChunkToFinalVerts;
-
-
-	uint32 TriangleIndices[3];
-	for (uint32 FaceIndex = 0; FaceIndex < Faces.size(); FaceIndex++)
-	{
-		const FMeshFace& Face = Faces[FaceIndex];
-
-		// Find a chunk which matches this triangle.
-		FSkinnedMeshChunk* Chunk = NULL;
-		for (uint32 i = 0; i < OutChunks.size(); ++i)
-		{
-			if (OutChunks[i]->MaterialIndex == Face.MeshMaterialIndex)
-			{
-				Chunk = OutChunks[i];
-				break;
-			}
-		}
-		if (Chunk == NULL)
-		{
-			Chunk = new FSkinnedMeshChunk();
-			Chunk->MaterialIndex = Face.MeshMaterialIndex;
-			Chunk->OriginalSectionIndex = (int32)OutChunks.size();
-			OutChunks.push_back(Chunk);
-		}
-
-		std::map<int32, int32>& FinalVerts = ChunkToFinalVerts[Chunk];
-
-		for (int32 VertexIndex = 0; VertexIndex < 3; ++VertexIndex)
-		{
-			int32 WedgeIndex = FaceIndex * 3 + VertexIndex;
-			const FSoftSkinBuildVertex& Vertex = RawVertices[WedgeIndex];
-
-			int32 FinalVertIndex = -1;
-			DupVerts.clear();
-			//RawVerts2Dupes.MultiFind(WedgeIndex, DupVerts);
-			auto range = RawVerts2Dupes.equal_range(WedgeIndex);
-			for (auto i=range.first;i!=range.second;++i)
-			{
-				DupVerts.push_back(i->second);
-			}
-			//DupVerts.insert(DupVerts.begin(), range.first, range.second);
-			std::sort(DupVerts.begin(),DupVerts.end());
-
-
-			for (uint32 k = 0; k < DupVerts.size(); k++)
-			{
-				if (DupVerts[k] >= WedgeIndex)
-				{
-					// the verts beyond me haven't been placed yet, so these duplicates are not relevant
-					break;
-				}
-
-				//int32 *Location = FinalVerts.Find(DupVerts[k]);
-				auto it = FinalVerts.find(DupVerts[k]);
-				if (it != FinalVerts.end())
-				{
-					if (SkeletalMeshTools::AreSkelMeshVerticesEqual(Vertex, Chunk->Vertices[it->second], OverlappingThresholds))
-					{
-						FinalVertIndex = it->second;
-						break;
-					}
-				}
-			}
-			if (FinalVertIndex == -1)
-			{
-				Chunk->Vertices.push_back(Vertex);
-				FinalVertIndex = (int32)Chunk->Vertices.size() - 1;
-				FinalVerts.insert(std::make_pair(WedgeIndex, FinalVertIndex));
-			}
-
-			// set the index entry for the newly added vertex
-			// TArray internally has int32 for capacity, so no need to test for uint32 as it's larger than int32
-			TriangleIndices[VertexIndex] = (uint32)FinalVertIndex;
-		}
-
-		if (TriangleIndices[0] != TriangleIndices[1] && TriangleIndices[0] != TriangleIndices[2] && TriangleIndices[1] != TriangleIndices[2])
-		{
-			for (uint32 VertexIndex = 0; VertexIndex < 3; VertexIndex++)
-			{
-				Chunk->Indices.push_back(TriangleIndices[VertexIndex]);
-			}
-		}
-	}
-}
-
-void SkeletalMeshTools::ChunkSkinnedVertices(std::vector<FSkinnedMeshChunk*>& Chunks, int32 MaxBonesPerChunk)
-{
-	// Copy over the old chunks (this is just copying pointers).
-	std::vector<FSkinnedMeshChunk*> SrcChunks;
-	Exchange(Chunks, SrcChunks);
-
-	// Sort the chunks by material index.
-	struct FCompareSkinnedMeshChunk
-	{
-		FORCEINLINE bool operator()(const FSkinnedMeshChunk* A, const FSkinnedMeshChunk* B) const
-		{
-			return A->MaterialIndex < B->MaterialIndex;
-		}
-	};
-	std::sort(SrcChunks.begin(), SrcChunks.end(), FCompareSkinnedMeshChunk());
-	//SrcChunks.Sort(FCompareSkinnedMeshChunk());
-
-	// Now split chunks to respect the desired bone limit.
-	std::vector<std::vector<int32>* > IndexMaps;
-	std::vector<FBoneIndexType> UniqueBones;
-	for (uint32 SrcChunkIndex = 0; SrcChunkIndex < SrcChunks.size(); ++SrcChunkIndex)
-	{
-		FSkinnedMeshChunk* SrcChunk = SrcChunks[SrcChunkIndex];
-		uint32 FirstChunkIndex = Chunks.size();
-
-		for (uint32 i = 0; i < SrcChunk->Indices.size(); i += 3)
-		{
-			// Find all bones needed by this triangle.
-			UniqueBones.clear();
-			for (int32 Corner = 0; Corner < 3; Corner++)
-			{
-				int32 VertexIndex = SrcChunk->Indices[i + Corner];
-				FSoftSkinBuildVertex& V = SrcChunk->Vertices[VertexIndex];
-				for (int32 InfluenceIndex = 0; InfluenceIndex < MAX_TOTAL_INFLUENCES; InfluenceIndex++)
-				{
-					if (V.InfluenceWeights[InfluenceIndex] > 0)
-					{
-						//UniqueBones.AddUnique(V.InfluenceBones[InfluenceIndex]);
-						AddUnique(UniqueBones, V.InfluenceBones[InfluenceIndex]);
-					}
-				}
-			}
-
-			// Now find a chunk for them.
-			FSkinnedMeshChunk* DestChunk = NULL;
-			uint32 DestChunkIndex = FirstChunkIndex;
-			for (; DestChunkIndex < Chunks.size(); ++DestChunkIndex)
-			{
-				std::vector<FBoneIndexType>& BoneMap = Chunks[DestChunkIndex]->BoneMap;
-				int32 NumUniqueBones = 0;
-				for (uint32 j = 0; j < UniqueBones.size(); ++j)
-				{
-					NumUniqueBones += (Contains(BoneMap,UniqueBones[j]) ? 0 : 1);
-				}
-				if (NumUniqueBones + (int32)BoneMap.size() <= MaxBonesPerChunk)
-				{
-					DestChunk = Chunks[DestChunkIndex];
-					break;
-				}
-			}
-
-			// If no chunk was found, create one!
-			if (DestChunk == NULL)
-			{
-				DestChunk = new FSkinnedMeshChunk();
-				Chunks.push_back(DestChunk);
-				DestChunk->MaterialIndex = SrcChunk->MaterialIndex;
-				DestChunk->OriginalSectionIndex = SrcChunk->OriginalSectionIndex;
-				std::vector<int32>* pIndexMap = new std::vector<int32>();
-				IndexMaps.push_back(pIndexMap);
-				std::vector<int32>& IndexMap = *pIndexMap;
-				IndexMap.resize(SrcChunk->Vertices.size());
-				memset(IndexMap.data(), 0xff, sizeof(std::vector<int32>::value_type) * IndexMap.size());
-			}
-			std::vector<int32>& IndexMap = *IndexMaps[DestChunkIndex];
-
-			// Add the unique bones to this chunk's bone map.
-			for (uint32 j = 0; j < UniqueBones.size(); ++j)
-			{
-				AddUnique(DestChunk->BoneMap,UniqueBones[j]);
-			}
-
-			// For each vertex, add it to the chunk's arrays of vertices and indices.
-			for (int32 Corner = 0; Corner < 3; Corner++)
-			{
-				int32 VertexIndex = SrcChunk->Indices[i + Corner];
-				int32 DestIndex = IndexMap[VertexIndex];
-				if (DestIndex == -1)
-				{
-					DestChunk->Vertices.push_back(SrcChunk->Vertices[VertexIndex]);
-					DestIndex = (int32)DestChunk->Vertices.size() - 1;
-					FSoftSkinBuildVertex& V = DestChunk->Vertices[DestIndex];
-					for (int32 InfluenceIndex = 0; InfluenceIndex < MAX_TOTAL_INFLUENCES; InfluenceIndex++)
-					{
-						if (V.InfluenceWeights[InfluenceIndex] > 0)
-						{
-							int32 MappedIndex = Find(DestChunk->BoneMap, V.InfluenceBones[InfluenceIndex]);
-							assert(IsValidIndex(DestChunk->BoneMap,MappedIndex));
-							V.InfluenceBones[InfluenceIndex] = MappedIndex;
-						}
-					}
-					IndexMap[VertexIndex] = DestIndex;
-				}
-				DestChunk->Indices.push_back(DestIndex);
-			}
-		}
-
-		// Source chunks are no longer needed.
-		delete SrcChunks[SrcChunkIndex];
-		SrcChunks[SrcChunkIndex] = NULL;
-	}
-}
-
 bool FBXImporter::BuildSkeletalMesh(FSkeletalMeshLODModel& LODModel, const FReferenceSkeleton& RefSkeleton, const std::vector<FVertInfluence>& Influences, const std::vector<FMeshWedge>& Wedges, const std::vector<FMeshFace>& Faces, const std::vector<FVector>& Points, const std::vector<int32>& PointToOriginalMap, const MeshBuildOptions& BuildOptions /*= MeshBuildOptions()*/, std::vector<std::string> * OutWarningMessages /*= NULL*/, std::vector<std::string> * OutWarningNames /*= NULL*/)
 {
 	auto UpdateOverlappingVertices = [](FSkeletalMeshLODModel& InLODModel)
@@ -4931,53 +4690,92 @@ void FBXImporter::CacheOptimizeIndexBuffer(std::vector<uint32>& Indices)
 	ForsythHelper::CacheOptimizeIndexBuffer(Indices);
 }
 
-bool FBXImporter::BuildStaticMesh(FStaticMeshRenderData& OutRenderData, UStaticMesh* Mesh/*, const FStaticMeshLODGroup& LODGroup */)
+/**
+ * Reorders every section's triangles for the post-transform cache and then for less overdraw, and lays the vertex
+ * streams out in the order the index buffer first uses them. Logs the simulated cache efficiency before and after.
+ */
+static void OptimizeStaticMeshBuffers(FStaticMeshLODResources& LODResource)
 {
+	std::vector<uint32>& Indices = LODResource.Indices;
+	FStaticMeshVertexBuffers& VertexBuffers = LODResource.VertexBuffers;
+	const uint32 NumVertices = (uint32)VertexBuffers.PositionVertexBuffer.size();
 
-	OutRenderData.AllocateLODResources(1);
+	FVertexCacheStatistics Before;
+	FVertexCacheStatistics After;
+	for (const FStaticMeshSection& Section : LODResource.Sections)
+	{
+		if (Section.NumTriangles == 0)
+		{
+			continue;
+		}
+		uint32* SectionIndices = &Indices[Section.FirstIndex];
+		const uint32 NumSectionIndices = Section.NumTriangles * 3;
 
-	MeshDescription MD2;
-	Mesh->GetRenderMeshDescription(Mesh->GetMeshDescription(), MD2);
+		Before += MeshOptimization::AnalyzeVertexCache(SectionIndices, NumSectionIndices, NumVertices);
+		MeshOptimization::OptimizeVertexCache(SectionIndices, NumSectionIndices, NumVertices);
+		MeshOptimization::OptimizeOverdraw(SectionIndices, NumSectionIndices, VertexBuffers.PositionVertexBuffer.data(), NumVertices);
+		After += MeshOptimization::AnalyzeVertexCache(SectionIndices, NumSectionIndices, NumVertices);
+	}
 
-	std::vector<std::vector<uint32> > OutPerSectionIndices;
-	OutPerSectionIndices.resize(Mesh->GetMeshDescription().PolygonGroups().Num());
-	std::vector<StaticMeshBuildVertex> StaticMeshBuildVertices;
-	FStaticMeshLODResources& LODResource = *OutRenderData.LODResources[0];
-	std::vector<int32> RemapVerts;
-	BuildVertexBuffer(MD2, LODResource, OutPerSectionIndices, StaticMeshBuildVertices,Mesh->GetOverlappingCorners(), THRESH_POINTS_ARE_SAME, RemapVerts);
+	std::vector<int32> Remap;
+	const uint32 NumNewVertices = MeshOptimization::OptimizeVertexFetchRemap(Indices.data(), (uint32)Indices.size(), NumVertices, Remap);
+	MeshOptimization::RemapVertexStream(VertexBuffers.PositionVertexBuffer, 1, Remap, NumNewVertices);
+	MeshOptimization::RemapVertexStream(VertexBuffers.TangentsVertexBuffer, 2, Remap, NumNewVertices);
+	MeshOptimization::RemapVertexStream(VertexBuffers.TexCoordVertexBuffer, 2, Remap, NumNewVertices);
+	MeshOptimization::RemapVertexStream(VertexBuffers.ColorVertexBuffer, 1, Remap, NumNewVertices);
+
+	X_LOG("Static mesh buffers: %u triangles, %u vertices, ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n",
+		After.NumTriangles, NumNewVertices, Before.GetACMR(), After.GetACMR(), Before.GetATVR(), After.GetATVR());
+}
+
+/** Optimizes the buffers of a built LOD, finds the vertex range of every section and packs the streams */
+static void FinishStaticMeshLOD(FStaticMeshLODResources& LODResource)
+{
+	OptimizeStaticMeshBuffers(LODResource);
 
-	std::vector<uint32> CombinedIndices;
 	for (uint32 i = 0; i < LODResource.Sections.size(); ++i)
 	{
 		FStaticMeshSection& Section = LODResource.Sections[i];
-		std::vector<uint32> const& SectionIndices = OutPerSectionIndices[i];
-		Section.FirstIndex = 0;
-		Section.NumTriangles = 0;
 		Section.MinVertexIndex = 0;
 		Section.MaxVertexIndex = 0;
 
-		if (SectionIndices.size())
+		if (Section.NumTriangles > 0)
 		{
-			Section.FirstIndex = CombinedIndices.size();
-			Section.NumTriangles = SectionIndices.size() / 3;
-
-			CombinedIndices.resize(CombinedIndices.size() + SectionIndices.size(), 0);
-			uint32* DestPtr = &CombinedIndices[Section.FirstIndex];
-			uint32 const* SrcPtr = SectionIndices.data();
+			uint32 const* SrcPtr = &LODResource.Indices[Section.FirstIndex];
+			const uint32 NumSectionIndices = Section.NumTriangles * 3;
 
 			Section.MinVertexIndex = *SrcPtr;
-			Section.MaxVertexIndex = *DestPtr;
 			Section.bCastShadow = true;
-			for (uint32 Index = 0; Index < SectionIndices.size(); Index++)
+			for (uint32 Index = 0; Index < NumSectionIndices; Index++)
 			{
 				uint32 VertIndex = *SrcPtr++;
 				Section.MinVertexIndex = Section.MinVertexIndex > VertIndex ? VertIndex : Section.MinVertexIndex;
 				Section.MaxVertexIndex = Section.MaxVertexIndex < VertIndex ? VertIndex : Section.MaxVertexIndex;
-				*DestPtr++ = VertIndex;
 			}
 		}
 	}
-	LODResource.Indices = std::move(CombinedIndices);
+
+	if (GCompactMeshVertexFormats)
+	{
+		LODResource.VertexBuffers.PackTangents();
+		LODResource.VertexBuffers.PackTexCoords();
+	}
+	LODResource.LogMemorySavings();
+}
+
+bool FBXImporter::BuildStaticMesh(FStaticMeshRenderData& OutRenderData, UStaticMesh* Mesh/*, const FStaticMeshLODGroup& LODGroup */)
+{
+	const int32 MaxLODs = FMath::Max((int32)GStaticMeshLODPercentTriangles.size(), 1);
+	OutRenderData.AllocateLODResources(1);
+	OutRenderData.LODMaxDeviation.assign(1, 0.0f);
+
+	MeshDescription MD2;
+	Mesh->GetRenderMeshDescription(Mesh->GetMeshDescription(), MD2);
+
+	std::vector<StaticMeshBuildVertex> StaticMeshBuildVertices;
+	std::vector<int32> RemapVerts;
+	BuildVertexBuffer(MD2, *OutRenderData.LODResources[0], StaticMeshBuildVertices,Mesh->GetOverlappingCorners(), THRESH_POINTS_ARE_SAME, RemapVerts);
+	FinishStaticMeshLOD(*OutRenderData.LODResources[0]);
 
 	// Calculate the bounding box.
 	FBox BoundingBox(FVector(0), FVector(0));
@@ -4998,6 +4796,35 @@ bool FBXImporter::BuildStaticMesh(FStaticMeshRenderData& OutRenderData, UStaticM
 		);
 	}
 
+	// Every further LOD reduces the render mesh description of LOD 0, so their errors all measure against the source
+	uint32 PreviousNumTriangles = MAX_uint32;
+	for (int32 LODIndex = 1; LODIndex < MaxLODs; ++LODIndex)
+	{
+		FMeshReductionSettings ReductionSettings;
+		ReductionSettings.PercentTriangles = GStaticMeshLODPercentTriangles[LODIndex];
+		MeshDescription LODMeshDescription;
+		FMeshReductionStatistics ReductionStatistics;
+		MeshReduction::ReduceMeshDescription(LODMeshDescription, ReductionStatistics, MD2, ReductionSettings);
+		X_LOG("Static mesh LOD %d: %u -> %u triangles (%.1f%%), max deviation %f\n", LODIndex, ReductionStatistics.NumSourceTriangles,
+			ReductionStatistics.NumTriangles, GStaticMeshLODPercentTriangles[LODIndex] * 100.f, ReductionStatistics.MaxDeviation);
+		// a mesh the reducer cannot take any further gets no more LODs
+		if (ReductionStatistics.NumTriangles == 0 || ReductionStatistics.NumTriangles >= FMath::Min(PreviousNumTriangles, ReductionStatistics.NumSourceTriangles))
+		{
+			break;
+		}
+		PreviousNumTriangles = ReductionStatistics.NumTriangles;
+
+		FOverlappingCornerAdjacency LODOverlappingCorners;
+		MeshDescriptionOperations::FindOverlappingCorners(LODOverlappingCorners, LODMeshDescription, THRESH_POINTS_ARE_SAME);
+
+		OutRenderData.AllocateLODResources(LODIndex + 1);
+		StaticMeshBuildVertices.clear();
+		BuildVertexBuffer(LODMeshDescription, *OutRenderData.LODResources[LODIndex], StaticMeshBuildVertices, LODOverlappingCorners, THRESH_POINTS_ARE_SAME, RemapVerts);
+		FinishStaticMeshLOD(*OutRenderData.LODResources[LODIndex]);
+
+		OutRenderData.LODMaxDeviation.push_back(ReductionStatistics.MaxDeviation);
+	}
+
 	return true;
 }
 bool AreVerticesEqual(StaticMeshBuildVertex const& A, StaticMeshBuildVertex const& B, float ComparisonThreshold)
@@ -5020,9 +4847,144 @@ bool AreVerticesEqual(StaticMeshBuildVertex const& A, StaticMeshBuildVertex cons
 	{
 		return false;
 	}
-	return true;
+	return true;
 }
-void FBXImporter::BuildVertexBuffer(const MeshDescription& MD2, FStaticMeshLODResources& StaticMeshLOD, std::vector<std::vector<uint32> >& OutPerSectionIndices, std::vector<StaticMeshBuildVertex>& StaticMeshBuildVertices, const std::multimap<int32, int32>& OverlappingCorners, float VertexComparisonThreshold, std::vector<int32>& RemapVerts)
+
+/**
+* Open addressing table of the vertices built so far, keyed on their position and normal quantized into cells several
+* times wider than the thresholds AreVerticesEqual compares them with. A vertex within the thresholds of V sits in V's cell
+* or, on the axes where V lies close to a cell boundary, in the cell across it, so probing those few cells answers whether
+* any built vertex is equal to V. Most wedges have no equal vertex yet and skip the walk over their overlapping corners.
+*/
+class FStaticMeshVertexHashTable
+{
+public:
+	FStaticMeshVertexHashTable(const std::vector<StaticMeshBuildVertex>& InVertices, int32 MaxVertices, float ComparisonThreshold)
+		: Vertices(InVertices)
+		, PositionThreshold(ComparisonThreshold)
+	{
+		// wide cells keep V away from their boundaries most of the time, a vertex in there still only costs AreVerticesEqual
+		PositionCellSize = FMath::Max(ComparisonThreshold, SMALL_NUMBER) * 16.f;
+		NormalCellSize = THRESH_NORMALS_ARE_SAME * 16.f;
+
+		uint32 NumSlots = 16;
+		while (NumSlots < (uint32)MaxVertices * 2)
+		{
+			NumSlots *= 2;
+		}
+		Slots.assign(NumSlots, FSlot());
+	}
+
+	/** @return true if a vertex added so far passes AreVerticesEqual against V */
+	bool ContainsEqual(const StaticMeshBuildVertex& V) const
+	{
+		int64 Cell[NumAxes];
+		int64 NeighbourCell[NumAxes];
+		uint32 NeighbourMask = 0;
+		const float Values[NumAxes] = { V.Position.X, V.Position.Y, V.Position.Z, V.TangentZ.X, V.TangentZ.Y, V.TangentZ.Z };
+		for (int32 Axis = 0; Axis < NumAxes; ++Axis)
+		{
+			const bool bPosition = Axis < 3;
+			const double CellSize = bPosition ? PositionCellSize : NormalCellSize;
+			// twice the threshold so rounding can't hide a neighbour, the cells are wide enough for that to stay one cell
+			const double Margin = 2.0 * (bPosition ? PositionThreshold : THRESH_NORMALS_ARE_SAME);
+			Cell[Axis] = QuantizeValue(Values[Axis], CellSize);
+			NeighbourCell[Axis] = Cell[Axis];
+			if (QuantizeValue(Values[Axis] - Margin, CellSize) != Cell[Axis])
+			{
+				NeighbourCell[Axis] = Cell[Axis] - 1;
+				NeighbourMask |= 1u << Axis;
+			}
+			else if (QuantizeValue(Values[Axis] + Margin, CellSize) != Cell[Axis])
+			{
+				NeighbourCell[Axis] = Cell[Axis] + 1;
+				NeighbourMask |= 1u << Axis;
+			}
+		}
+
+		// every combination of own and neighbour cell on the axes that have a neighbour
+		const uint32 Mask = (uint32)Slots.size() - 1;
+		for (uint32 Subset = NeighbourMask;; Subset = (Subset - 1) & NeighbourMask)
+		{
+			int64 ProbeCell[NumAxes];
+			for (int32 Axis = 0; Axis < NumAxes; ++Axis)
+			{
+				ProbeCell[Axis] = (Subset & (1u << Axis)) ? NeighbourCell[Axis] : Cell[Axis];
+			}
+			const uint32 Hash = HashCell(ProbeCell);
+			for (uint32 Slot = Hash & Mask; Slots[Slot].VertexIndex != INDEX_NONE; Slot = (Slot + 1) & Mask)
+			{
+				if (Slots[Slot].Hash == Hash && AreVerticesEqual(V, Vertices[Slots[Slot].VertexIndex], PositionThreshold))
+				{
+					return true;
+				}
+			}
+			if (Subset == 0)
+			{
+				break;
+			}
+		}
+		return false;
+	}
+
+	/** Adds Vertices[VertexIndex] to the cell it falls in */
+	void Add(int32 VertexIndex)
+	{
+		const StaticMeshBuildVertex& V = Vertices[VertexIndex];
+		const float Values[NumAxes] = { V.Position.X, V.Position.Y, V.Position.Z, V.TangentZ.X, V.TangentZ.Y, V.TangentZ.Z };
+		int64 Cell[NumAxes];
+		for (int32 Axis = 0; Axis < NumAxes; ++Axis)
+		{
+			Cell[Axis] = QuantizeValue(Values[Axis], Axis < 3 ? PositionCellSize : NormalCellSize);
+		}
+		const uint32 Hash = HashCell(Cell);
+
+		const uint32 Mask = (uint32)Slots.size() - 1;
+		uint32 Slot = Hash & Mask;
+		while (Slots[Slot].VertexIndex != INDEX_NONE)
+		{
+			Slot = (Slot + 1) & Mask;
+		}
+		Slots[Slot].Hash = Hash;
+		Slots[Slot].VertexIndex = VertexIndex;
+	}
+
+private:
+	/** Three position and three normal components */
+	static const int32 NumAxes = 6;
+
+	struct FSlot
+	{
+		uint32 Hash = 0;
+		int32 VertexIndex = INDEX_NONE;
+	};
+
+	static int64 QuantizeValue(double Value, double CellSize)
+	{
+		return (int64)std::floor(Value / CellSize);
+	}
+
+	static uint32 HashCell(const int64* Cell)
+	{
+		// FNV-1a over the cell coordinates
+		uint32 Hash = 2166136261u;
+		for (int32 Axis = 0; Axis < NumAxes; ++Axis)
+		{
+			const uint64 Bits = (uint64)Cell[Axis];
+			Hash = (Hash ^ (uint32)Bits) * 16777619u;
+			Hash = (Hash ^ (uint32)(Bits >> 32)) * 16777619u;
+		}
+		return Hash ^ (Hash >> 16);
+	}
+
+	const std::vector<StaticMeshBuildVertex>& Vertices;
+	float PositionThreshold;
+	double PositionCellSize;
+	double NormalCellSize;
+	std::vector<FSlot> Slots;
+};
+
+void FBXImporter::BuildVertexBuffer(const MeshDescription& MD2, FStaticMeshLODResources& StaticMeshLOD, std::vector<StaticMeshBuildVertex>& StaticMeshBuildVertices, const FOverlappingCornerAdjacency& OverlappingCorners, float VertexComparisonThreshold, std::vector<int32>& RemapVerts)
 {
 	const TMeshElementArray<MeshVertex>& Vertices = MD2.Vertices();
 	const TMeshElementArray<MeshVertexInstance>& VertexInstances = MD2.VertexInstances();
@@ -5032,20 +4994,19 @@ void FBXImporter::BuildVertexBuffer(const MeshDescription& MD2, FStaticMeshLODRe
 	RemapVerts.resize(VertexInstances.Num());
 	for (int32& RemapIndex : RemapVerts)
 	{
-		RemapIndex = INDEX_NONE;
-	}
-	std::vector<int32> DupVerts;
+		RemapIndex = INDEX_NONE;
+	}
 
-	const std::vector<std::string>& PolygonGroupImportedMaterialSlotNames = MD2.PolygonGroupAttributes().GetAttributes<std::string>(MeshAttribute::PolygonGroup::ImportedMaterialSlotName);
+	TMeshAttributesConstRef<std::string> PolygonGroupImportedMaterialSlotNames = MD2.PolygonGroupAttributes().GetAttributesRef<std::string>(MeshAttribute::PolygonGroup::ImportedMaterialSlotName);
 
-	const std::vector<FVector>& VertexPositions = MD2.VertexAttributes().GetAttributes<FVector>(MeshAttribute::Vertex::Position);
-	const std::vector<FVector>& VertexInstanceNormals = MD2.VertexInstanceAttributes().GetAttributes<FVector>(MeshAttribute::VertexInstance::Normal);
-	const std::vector<FVector>& VertexInstanceTangents = MD2.VertexInstanceAttributes().GetAttributes<FVector>(MeshAttribute::VertexInstance::Tangent);
-	const std::vector<float>& VertexInstanceBinormalSigns = MD2.VertexInstanceAttributes().GetAttributes<float>(MeshAttribute::VertexInstance::BinormalSign);
-	const std::vector<Vector4>& VertexInstanceColors = MD2.VertexInstanceAttributes().GetAttributes<Vector4>(MeshAttribute::VertexInstance::Color);
-	const std::vector<std::vector<Vector2>>& VertexInstanceUVs = MD2.VertexInstanceAttributes().GetAttributesSet<Vector2>(MeshAttribute::VertexInstance::TextureCoordinate);
+	TMeshAttributesConstRef<FVector> VertexPositions = MD2.VertexAttributes().GetAttributesRef<FVector>(MeshAttribute::Vertex::Position);
+	TMeshAttributesConstRef<FVector> VertexInstanceNormals = MD2.VertexInstanceAttributes().GetAttributesRef<FVector>(MeshAttribute::VertexInstance::Normal);
+	TMeshAttributesConstRef<FVector> VertexInstanceTangents = MD2.VertexInstanceAttributes().GetAttributesRef<FVector>(MeshAttribute::VertexInstance::Tangent);
+	TMeshAttributesConstRef<float> VertexInstanceBinormalSigns = MD2.VertexInstanceAttributes().GetAttributesRef<float>(MeshAttribute::VertexInstance::BinormalSign);
+	TMeshAttributesConstRef<Vector4> VertexInstanceColors = MD2.VertexInstanceAttributes().GetAttributesRef<Vector4>(MeshAttribute::VertexInstance::Color);
+	TMeshAttributesConstRef<Vector2> VertexInstanceUVs = MD2.VertexInstanceAttributes().GetAttributesRef<Vector2>(MeshAttribute::VertexInstance::TextureCoordinate);
 
-	std::map<int, int> PolygonGroupToSectionIndex;
+	std::vector<int> PolygonGroupToSectionIndex(MD2.PolygonGroups().GetArraySize(), INDEX_NONE);
 	for (const int PolgyonGroupID : MD2.PolygonGroups().GetElementIDs())
 	{
 		int& SectionIndex = PolygonGroupToSectionIndex[PolgyonGroupID];
@@ -5056,24 +5017,43 @@ void FBXImporter::BuildVertexBuffer(const MeshDescription& MD2, FStaticMeshLODRe
 		{
 			Section.MaterialIndex = PolgyonGroupID;
 		}
+		Section.FirstIndex = 0;
+		Section.NumTriangles = 0;
 	}
 
-	int ReserveIndicesCount = 0;
-	for (const int PolygonID : MD2.Polygons().GetElementIDs())
+	// Count the triangles of every section so all indices go straight to their place in one buffer
+	const std::vector<int> PolygonIDs = MD2.Polygons().GetElementIDs();
+	for (const int PolygonID : PolygonIDs)
 	{
-		const std::vector<MeshTriangle>& PolygonTriangles = MD2.GetPolygonTriangles(PolygonID);
-		ReserveIndicesCount += PolygonTriangles.size() * 3;
+		const int SectionIndex = PolygonGroupToSectionIndex[MD2.GetPolygonPolygonGroup(PolygonID)];
+		StaticMeshLOD.Sections[SectionIndex].NumTriangles += (uint32)MD2.GetPolygonTriangles(PolygonID).size();
+	}
+	uint32 NumIndices = 0;
+	for (FStaticMeshSection& Section : StaticMeshLOD.Sections)
+	{
+		if (Section.NumTriangles > 0)
+		{
+			Section.FirstIndex = NumIndices;
+			NumIndices += Section.NumTriangles * 3;
+		}
 	}
-	StaticMeshLOD.Indices.reserve(ReserveIndicesCount);
+	StaticMeshLOD.Indices.clear();
+	StaticMeshLOD.Indices.resize(NumIndices);
+	std::vector<uint32> SectionWritePos(StaticMeshLOD.Sections.size());
+	for (uint32 SectionIndex = 0; SectionIndex < StaticMeshLOD.Sections.size(); ++SectionIndex)
+	{
+		SectionWritePos[SectionIndex] = StaticMeshLOD.Sections[SectionIndex].FirstIndex;
+	}
+
+	StaticMeshBuildVertices.reserve(NumIndices);
+	FStaticMeshVertexHashTable VertexHashTable(StaticMeshBuildVertices, NumIndices, VertexComparisonThreshold);
 
-	for (const int PolygonID : MD2.Polygons().GetElementIDs())
+	for (const int PolygonID : PolygonIDs)
 	{
 		const int PolygonGroupID = MD2.GetPolygonPolygonGroup(PolygonID);
 		const int SectionIndex = PolygonGroupToSectionIndex[PolygonGroupID];
-		std::vector<uint32>& SectionIndices = OutPerSectionIndices[SectionIndex];
+		uint32& SectionWriteIndex = SectionWritePos[SectionIndex];
 		const std::vector<MeshTriangle>& PolygonTriangles = MD2.GetPolygonTriangles(PolygonID);
-		uint32 MinIndex = 0;
-		uint32 MaxIndex = 0xFFFFFFFF;
 		for (int TriangleIndex = 0; TriangleIndex < (int)PolygonTriangles.size(); ++TriangleIndex)
 		{
 			const MeshTriangle& Triangle = PolygonTriangles[TriangleIndex];
@@ -5093,8 +5073,8 @@ void FBXImporter::BuildVertexBuffer(const MeshDescription& MD2, FStaticMeshLODRe
 				const FVector& VertexNormal = VertexInstanceNormals[VertexInstanceID];
 				const FVector& VertexTangent = VertexInstanceTangents[VertexInstanceID];
 				const float VertexInstanceBinormalSign = VertexInstanceBinormalSigns[VertexInstanceID];
-				Vector2 UVs = VertexInstanceUVs[0][VertexInstanceID];
-				Vector2 LightMapCoordinate = VertexInstanceUVs[1][VertexInstanceID];
+				Vector2 UVs = VertexInstanceUVs.Get(VertexInstanceID, 0);
+				Vector2 LightMapCoordinate = VertexInstanceUVs.Get(VertexInstanceID, 1);
 
 				StaticMeshBuildVertex StaticMeshVertex;
 				StaticMeshVertex.Position = VertexPosition;
@@ -5104,15 +5084,13 @@ void FBXImporter::BuildVertexBuffer(const MeshDescription& MD2, FStaticMeshLODRe
 				StaticMeshVertex.UVs = UVs;
 				StaticMeshVertex.LightMapCoordinate = LightMapCoordinate;
 
-				DupVerts.clear();
-				auto RangePair = OverlappingCorners.equal_range(VertexInstanceValue);
-				for (auto i = RangePair.first; i != RangePair.second; ++i)
-				{
-					DupVerts.push_back(i->second);
-				}
-				std::sort(DupVerts.begin(),DupVerts.end());
-				int32 Index = INDEX_NONE;
-				for (uint32 k = 0; k < DupVerts.size(); k++)
+				// the first equal vertex in corner order, as before, but only looked for when there is one at all
+				int32 Index = INDEX_NONE;
+				const FOverlappingCornerAdjacency::FRange DupVerts = VertexHashTable.ContainsEqual(StaticMeshVertex)
+					? OverlappingCorners.FindIfOverlapping(VertexInstanceValue)
+					: FOverlappingCornerAdjacency::FRange{ nullptr, nullptr };
+				// already sorted
+				for (int32 k = 0; k < DupVerts.size(); k++)
 				{
 					if (DupVerts[k] >= VertexInstanceValue)
 					{
@@ -5129,12 +5107,13 @@ void FBXImporter::BuildVertexBuffer(const MeshDescription& MD2, FStaticMeshLODRe
 				{
 					Index = (int32)StaticMeshBuildVertices.size();
 					StaticMeshBuildVertices.push_back(StaticMeshVertex);
+					VertexHashTable.Add(Index);
 				}
 				RemapVerts[VertexInstanceValue] = Index;
-				const uint32 RenderingVertexIndex = RemapVerts[VertexInstanceValue];
-				//IndexBuffer.Add(RenderingVertexIndex);
+				const uint32 RenderingVertexIndex = RemapVerts[VertexInstanceValue];
+				//IndexBuffer.Add(RenderingVertexIndex);
 				//OutWedgeMap[VertexInstanceValue] = RenderingVertexIndex;
-				SectionIndices.push_back(RenderingVertexIndex);
+				StaticMeshLOD.Indices[SectionWriteIndex++] = RenderingVertexIndex;
 			}
 		}
 
@@ -5572,6 +5551,7 @@ UAnimSequence* FBXImporter::ImportAnimations(USkeleton* Skeleton, std::vector<Fb
 
 		UAnimSequence * DestSeq = new UAnimSequence();
 		DestSeq->SetSkeleton(Skeleton);
+		DestSeq->SequenceName = Name + "/" + CurAnimStack->GetName();
 
 		ImportAnimation(Skeleton, DestSeq, Name, SortedLinks, NodeArray, CurAnimStack, ResampleRate, AnimTimeSpan);
 
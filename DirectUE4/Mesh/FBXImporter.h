@@ -6,13 +6,14 @@
 #include "fbxsdk.h"
 #include "UnrealMath.h"
 #include "Transform.h"
+#include "MeshDescriptionOperations.h"
+#include "SkeletalMeshTools.h"
 
 #include <vector>
 #include <string>
 #include <set>
 #include <map>
 
-typedef uint16 FBoneIndexType;
 
 void FillFbxArray(FbxNode* pNode, std::vector<FbxNode*>& pOutMeshArray);
 
@@ -35,24 +36,6 @@ FVector ConvertScale(FbxDouble3 V);
 class UStaticMesh;
 class USkeletalMesh;
 
-struct FMeshWedge
-{
-	uint32			iVertex;			// Vertex index.
-	Vector2			UVs[4];				// UVs.
-	FColor			Color;				// Vertex color.
-};
-struct FMeshFace
-{
-	// Textured Vertex indices.
-	uint32		iWedge[3];
-	// Source Material (= texture plus unique flags) index.
-	uint16		MeshMaterialIndex;
-	FVector	TangentX[3];
-	FVector	TangentY[3];
-	FVector	TangentZ[3];
-	// 32-bit flag for smoothing groups.
-	uint32   SmoothingGroups;
-};
 // A bone: an orientation, and a position, all relative to their parent.
 struct VJointPos
 {
@@ -229,24 +212,6 @@ namespace EFBXNormalGenerationMethod
 		MikkTSpace,
 	};
 }
-struct FOverlappingThresholds
-{
-public:
-	FOverlappingThresholds()
-		: ThresholdPosition(THRESH_POINTS_ARE_SAME)
-		, ThresholdTangentNormal(THRESH_NORMALS_ARE_SAME)
-		, ThresholdUV(THRESH_UVS_ARE_SAME)
-	{}
-
-	/** Threshold use to decide if two vertex position are equal. */
-	float ThresholdPosition;
-
-	/** Threshold use to decide if two normal, tangents or bi-normals are equal. */
-	float ThresholdTangentNormal;
-
-	/** Threshold use to decide if two UVs are equal. */
-	float ThresholdUV;
-};
 
 struct FBXImportOptions
 {
@@ -372,83 +337,6 @@ struct FReferenceSkeleton;
 // 	/** The number of valid texture coordinates. */
 // 	int32 NumTexCoords;
 // };
-#define MAX_TOTAL_INFLUENCES 8
-typedef FVector FPackedNormal;
-struct FSoftSkinBuildVertex
-{
-	FVector			Position;
-	FPackedNormal	TangentX,	// Tangent, U-direction
-		TangentY,	// Binormal, V-direction
-		TangentZ;	// Normal
-	Vector2			UVs[4]; // UVs
-	FColor			Color;		// VertexColor
-	FBoneIndexType	InfluenceBones[MAX_TOTAL_INFLUENCES];
-	uint8			InfluenceWeights[MAX_TOTAL_INFLUENCES];
-	uint32 PointWedgeIdx;
-};
-// this is used for a sub-quadratic routine to find "equal" verts
-struct FSkeletalMeshVertIndexAndZ
-{
-	int32 Index;
-	float Z;
-};
-/**
-* A chunk of skinned mesh vertices used as intermediate data to build a renderable
-* skinned mesh.
-*/
-struct FSkinnedMeshChunk
-{
-	/** The material index with which this chunk should be rendered. */
-	int32 MaterialIndex;
-	/** The original section index for which this chunk was generated. */
-	int32 OriginalSectionIndex;
-	/** The vertices associated with this chunk. */
-	std::vector<FSoftSkinBuildVertex> Vertices;
-	/** The indices of the triangles in this chunk. */
-	std::vector<uint32> Indices;
-	/** If not empty, contains a map from bones referenced in this chunk to the skeleton. */
-	std::vector<FBoneIndexType> BoneMap;
-};
-
-namespace SkeletalMeshTools
-{
-	inline bool SkeletalMesh_UVsEqual(const FMeshWedge& V1, const FMeshWedge& V2, const FOverlappingThresholds& OverlappingThresholds, const int32 UVIndex = 0)
-	{
-		const Vector2& UV1 = V1.UVs[UVIndex];
-		const Vector2& UV2 = V2.UVs[UVIndex];
-
-		if (FMath::Abs(UV1.X - UV2.X) > OverlappingThresholds.ThresholdUV)
-			return 0;
-
-		if (FMath::Abs(UV1.Y - UV2.Y) > OverlappingThresholds.ThresholdUV)
-			return 0;
-
-		return 1;
-	}
-
-	/** @return true if V1 and V2 are equal */
-	bool AreSkelMeshVerticesEqual(const FSoftSkinBuildVertex& V1, const FSoftSkinBuildVertex& V2, const FOverlappingThresholds& OverlappingThresholds);
-
-	/**
-	* Creates chunks and populates the vertex and index arrays inside each chunk
-	*
-	* @param Faces						List of raw faces
-	* @param RawVertices				List of raw created, unordered, unwelded vertices
-	* @param RawVertIndexAndZ			List of indices into the RawVertices array and each raw vertex Z position.  This is used for fast lookup of overlapping vertices
-	* @param OverlappingThresholds		The thresholds to use to compute overlap vertex instance
-	* @param OutChunks					Created array of chunks
-	*/
-	void BuildSkeletalMeshChunks(const std::vector<FMeshFace>& Faces, const std::vector<FSoftSkinBuildVertex>& RawVertices, std::vector<FSkeletalMeshVertIndexAndZ>& RawVertIndexAndZ, const FOverlappingThresholds &OverlappingThresholds, std::vector<FSkinnedMeshChunk*>& OutChunks, bool& bOutTooManyVerts);
-
-	/**
-	* Splits chunks to satisfy the requested maximum number of bones per chunk
-	* @param Chunks			Chunks to split. Upon return contains the results of splitting chunks.
-	* @param MaxBonesPerChunk	The maximum number of bones a chunk may reference.
-	*/
-	void ChunkSkinnedVertices(std::vector<FSkinnedMeshChunk*>& Chunks, int32 MaxBonesPerChunk);
-
-	//void CalcBoneVertInfos(USkeletalMesh* SkeletalMesh, std::vector<FBoneVertInfo>& Infos, bool bOnlyDominant);
-};
 
 class FFbxDataConverter
 {
@@ -504,9 +392,16 @@ class FBXImporter
 {
 public:
 	UStaticMesh* ImportStaticMesh(class AActor* InOwner, const char* filename);
-	USkeletalMesh* ImportSkeletalMesh(class AActor* InOwner, const char* filename);
+	/**
+	* @param BoneReductionLODScreenSizes - one bone reduction LOD per entry, each one drops another level of leaf bones
+	*	and shares the LOD 0 geometry. Empty for a mesh with LOD 0 only.
+	*/
+	USkeletalMesh* ImportSkeletalMesh(class AActor* InOwner, const char* filename, const std::vector<float>& BoneReductionLODScreenSizes = std::vector<float>());
 	UAnimSequence* ImportFbxAnimation(USkeleton* Skeleton, const char* InFilename, const char* AnimName, bool bImportMorphTracks);
 
+	/** Hashes the whole file in one read, returns false if it can't be read */
+	static bool HashSourceFile(const char* pFileName, class FSHAHash& OutHash);
+
 	bool FillSkeletalMeshImportData(std::vector<FbxNode*>& NodeArray, std::vector<FbxShape*> *FbxShapeArray, FSkeletalMeshImportData* OutData);
 	bool ImportBone(std::vector<FbxNode*>& NodeArray, FSkeletalMeshImportData &ImportData, std::vector<FbxNode*> &OutSortedLinks, bool& bUseTime0AsRefPose, FbxNode *SkeletalMeshNode);
 	bool FillSkelMeshImporterFromFbx(FSkeletalMeshImportData& ImportData, FbxMesh*& Mesh, FbxSkin* Skin, FbxShape* Shape, std::vector<FbxNode*> &SortedLinks, const std::vector<FbxSurfaceMaterial*>& FbxMaterials, FbxNode *RootNode);
@@ -525,7 +420,8 @@ public:
 	void CacheOptimizeIndexBuffer(std::vector<uint32>& Indices);
 
 	bool BuildStaticMesh(FStaticMeshRenderData& OutRenderData, UStaticMesh* Mesh/*, const FStaticMeshLODGroup& LODGroup */);
-	void BuildVertexBuffer(const MeshDescription& MD2, FStaticMeshLODResources& StaticMeshLOD, std::vector<std::vector<uint32> >& OutPerSectionIndices, std::vector<StaticMeshBuildVertex>& StaticMeshBuildVertices, const std::multimap<int32, int32>& OverlappingCorners, float VertexComparisonThreshold, std::vector<int32>& RemapVerts);
+	/** Welds the vertex instances of MD2 into StaticMeshBuildVertices and writes the indices of all sections, one after the other, to StaticMeshLOD.Indices */
+	void BuildVertexBuffer(const MeshDescription& MD2, FStaticMeshLODResources& StaticMeshLOD, std::vector<StaticMeshBuildVertex>& StaticMeshBuildVertices, const FOverlappingCornerAdjacency& OverlappingCorners, float VertexComparisonThreshold, std::vector<int32>& RemapVerts);
 
 	FbxNode* FindFBXMeshesByBone(const std::string& RootBoneName, bool bExpandLOD, std::vector<FbxNode*>& OutFBXMeshNodeArray);
 	void FillFbxSkelMeshArrayInScene(FbxNode* Node, std::vector<std::vector<FbxNode*>*>& outSkelMeshArray, bool ExpandLOD, bool bForceFindRigid = false);
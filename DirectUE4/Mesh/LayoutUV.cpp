@@ -1,25 +1,26 @@
 #include "LayoutUV.h"
 #include "DisjoinSet.h"
+#include "ParallelFor.h"
 #include <algorithm>
 #include <unordered_map>
+#include <chrono>
 
 #define CHART_JOINING	1
 namespace MeshDescriptionOp
 {
 	FLayoutUV::FLayoutUV(MeshDescription& InMesh, uint32 InSrcChannel, uint32 InDstChannel, uint32 InTextureResolution)
 		: MD(InMesh)
+		, VertexPositions(InMesh.VertexAttributes().GetAttributesRef<FVector>(MeshAttribute::Vertex::Position))
+		, VertexNormals(InMesh.VertexInstanceAttributes().GetAttributesRef<FVector>(MeshAttribute::VertexInstance::Normal))
+		, VertexUVs(InMesh.VertexInstanceAttributes().GetAttributesRef<Vector2>(MeshAttribute::VertexInstance::TextureCoordinate))
 		, SrcChannel(InSrcChannel)
 		, DstChannel(InDstChannel)
 		, TextureResolution(InTextureResolution)
 		, TotalUVArea(0.0f)
-		, LayoutRaster(TextureResolution, TextureResolution)
-		, ChartRaster(TextureResolution, TextureResolution)
-		, BestChartRaster(TextureResolution, TextureResolution)
-		, ChartShader(&ChartRaster)
 		, LayoutVersion(MeshDescriptionOperations::ELightmapUVVersion::Latest)
 	{}
 
-	void FLayoutUV::FindCharts(const std::multimap<int32, int32>& OverlappingCorners)
+	void FLayoutUV::FindCharts(const FOverlappingCornerAdjacency& OverlappingCorners)
 	{
 		const float ThreshUVsAreSame = GetUVEqualityThreshold();
 		//double Begin = FPlatformTime::Seconds();
@@ -37,7 +38,7 @@ namespace MeshDescriptionOp
 		int32 WedgeIndex = 0;
 		RemapVerts.resize(NumIndexes);
 
-		const std::vector<Vector2>& VertexUVs = MD.VertexInstanceAttributes().GetAttributes<Vector2>(MeshAttribute::VertexInstance::TextureCoordinate, SrcChannel);
+		const std::vector<Vector2>& SrcUVs = VertexUVs.GetRawArray(SrcChannel);
 
 		for (const int PolygonID : MD.Polygons().GetElementIDs())
 		{
@@ -49,7 +50,7 @@ namespace MeshDescriptionOp
 					const int VertexInstanceID = MTri.GetVertexInstanceID(Corner);
 
 					TranslatedMatches[WedgeIndex] = -1;
-					TexCoords[WedgeIndex] = VertexUVs[VertexInstanceID];
+					TexCoords[WedgeIndex] = SrcUVs[VertexInstanceID];
 					RemapVerts[WedgeIndex] = VertexInstanceID;
 					++WedgeIndex;
 				}
@@ -61,10 +62,9 @@ namespace MeshDescriptionOp
 		for (uint32 i = 0; i < NumIndexes; i++)
 		{
 			//for (auto It = OverlappingCorners.CreateConstKeyIterator(i); It; ++It)
-			auto range = OverlappingCorners.equal_range(i);
-			for (auto It = range.first; It != range.second; ++It)
+			for (const int32 Overlapping : OverlappingCorners.FindIfOverlapping(i))
 			{
-				uint32 j = It->second;
+				uint32 j = Overlapping;
 
 				if (j > i)
 				{
@@ -176,8 +176,6 @@ namespace MeshDescriptionOp
 
 		std::map< uint32, int32 > DisjointSetToChartMap;
 
-		const std::vector<FVector>& VertexPositions = MD.VertexAttributes().GetAttributes<FVector>(MeshAttribute::Vertex::Position);
-
 		// Build Charts
 		for (uint32 Tri = 0; Tri < NumTris; )
 		{
@@ -583,12 +581,48 @@ namespace MeshDescriptionOp
 
 	bool FLayoutUV::FindBestPacking()
 	{
+		PackingStatistics = MeshDescriptionOperations::FLightmapUVPackingStatistics();
+		PackingStatistics.NumCharts = (uint32)Charts.size();
+
 		if ((uint32)Charts.size() > TextureResolution * TextureResolution || TotalUVArea == 0.f)
 		{
 			// More charts than texels
 			return false;
 		}
 
+		const auto StartTime = std::chrono::high_resolution_clock::now();
+
+		std::vector< FChartPacking > Packings;
+		int32 BestPacking = 0;
+		if (GFastLightmapUVPacking)
+		{
+			Packings.reserve(4);
+			for (int32 i = 0; i < 4; i++)
+			{
+				Packings.emplace_back(TextureResolution);
+			}
+			FindBestPackingFast(Packings, BestPacking);
+		}
+		else
+		{
+			Packings.emplace_back(TextureResolution);
+			FindBestPackingLinear(Packings[0]);
+		}
+
+		const FChartPacking& Packing = Packings[BestPacking];
+		PackingStatistics.bSuccess = true;
+		PackingStatistics.UVScale = Packing.UVScale;
+		PackingStatistics.TexelUtilization = (float)Packing.LayoutRaster.CountUsedBits() / (float)(TextureResolution * TextureResolution);
+		Charts = std::move(Packings[BestPacking].Charts);
+
+		const std::chrono::duration<double, std::milli> Elapsed = std::chrono::high_resolution_clock::now() - StartTime;
+		PackingStatistics.PackingMilliseconds = Elapsed.count();
+
+		return true;
+	}
+
+	bool FLayoutUV::FindBestPackingLinear(FChartPacking& Packing)
+	{
 		const float LinearSearchStart = 0.5f;
 		const float LinearSearchStep = 0.5f;
 		const int32 BinarySearchSteps = 6;
@@ -599,9 +633,8 @@ namespace MeshDescriptionOp
 		// Linear search for first fit
 		while (1)
 		{
-			ScaleCharts(UVScalePass);
-
-			bool bFit = PackCharts();
+			bool bFit = PackCharts(Packing, UVScalePass);
+			PackingStatistics.NumRasterPackings++;
 			if (bFit)
 			{
 				break;
@@ -615,9 +648,9 @@ namespace MeshDescriptionOp
 		for (int32 i = 0; i < BinarySearchSteps; i++)
 		{
 			float UVScale = 0.5f * (UVScaleFail + UVScalePass);
-			ScaleCharts(UVScale);
 
-			bool bFit = PackCharts();
+			bool bFit = PackCharts(Packing, UVScale);
+			PackingStatistics.NumRasterPackings++;
 			if (bFit)
 			{
 				UVScalePass = UVScale;
@@ -629,17 +662,146 @@ namespace MeshDescriptionOp
 		}
 
 		// TODO store packing scale/bias separate so this isn't necessary
-		ScaleCharts(UVScalePass);
-		PackCharts();
+		if (Packing.UVScale != UVScalePass)
+		{
+			PackCharts(Packing, UVScalePass);
+			PackingStatistics.NumRasterPackings++;
+		}
 
 		return true;
 	}
 
-	void FLayoutUV::ScaleCharts(float UVScale)
+	bool FLayoutUV::FindBestPackingFast(std::vector< FChartPacking >& Packings, int32& BestPacking)
 	{
-		for (size_t i = 0; i < Charts.size(); i++)
+		const float LinearSearchStart = 0.5f;
+		const float LinearSearchStep = 0.5f;
+		const int32 RectSearchSteps = 8;
+		const int32 NumProbes = (int32)Packings.size() - 1;
+		const int32 RasterSearchRounds = 3;
+		const float RasterSearchRange = 1.25f;
+
+		// The charts can't cover more texels than there are, whatever the packing
+		const float UVScaleMax = TextureResolution * FMath::Sqrt(1.0f / TotalUVArea);
+
+		// Rects first: a skyline finds the largest scale at which the chart bounding rects fit for a fraction of the cost of
+		// a raster packing. That scale is only an estimate for the rasters: they are usually smaller than their rects, but the
+		// greedy raster packing is a different packer and may not fit at it, so the raster search below starts there unverified.
+		std::vector< FMeshChart > RectCharts;
+		FSkylineAllocator2D Skyline(TextureResolution, TextureResolution);
+		auto RectsFit = [&](float UVScale)
 		{
-			FMeshChart& Chart = Charts[i];
+			RectCharts = Charts;
+			ScaleCharts(RectCharts, UVScale);
+			Skyline.Clear();
+			PackingStatistics.NumRectPackings++;
+			return PackChartRects(RectCharts, Skyline);
+		};
+
+		float UVScaleFail = UVScaleMax;
+		float UVScalePass = TextureResolution * FMath::Sqrt(LinearSearchStart / TotalUVArea);
+		bool bRectsFit = false;
+		for (int32 i = 0; i < 32 && !bRectsFit; i++)
+		{
+			bRectsFit = RectsFit(UVScalePass);
+			if (!bRectsFit)
+			{
+				UVScaleFail = UVScalePass;
+				UVScalePass *= LinearSearchStep;
+			}
+		}
+		if (bRectsFit)
+		{
+			for (int32 i = 0; i < RectSearchSteps; i++)
+			{
+				float UVScale = 0.5f * (UVScaleFail + UVScalePass);
+				if (RectsFit(UVScale))
+				{
+					UVScalePass = UVScale;
+				}
+				else
+				{
+					UVScaleFail = UVScale;
+				}
+			}
+		}
+
+		// Then rasters. Rasters are usually smaller than their rects but the greedy raster packing doesn't always fit where the
+		// skyline did, so the search starts at the rect scale, unverified, up to RasterSearchRange times that and grows the range
+		// while its top fits. Each round packs NumProbes evenly spaced scales in parallel and narrows the range to the one
+		// around the largest that fit. The probes don't depend on the number of threads, so neither does the layout.
+		UVScaleFail = FMath::Min(UVScaleMax, UVScalePass * RasterSearchRange);
+		bool bFailEstimated = true;
+		BestPacking = -1;
+		for (int32 Round = 0; Round < RasterSearchRounds || BestPacking < 0;)
+		{
+			std::vector< int32 > ProbePackings;
+			for (int32 i = 0; i < (int32)Packings.size(); i++)
+			{
+				if (i != BestPacking)
+				{
+					ProbePackings.push_back(i);
+				}
+			}
+			ProbePackings.resize(NumProbes);
+
+			// Until something fit the pass scale is only an estimate, so probe it too
+			const int32 FirstProbe = BestPacking < 0 ? 0 : 1;
+			const float ProbeStep = (UVScaleFail - UVScalePass) / (NumProbes + FirstProbe);
+			ParallelFor(NumProbes, [&](int32 Probe)
+			{
+				PackCharts(Packings[ProbePackings[Probe]], UVScalePass + ProbeStep * (Probe + FirstProbe));
+			}, !GParallelMeshBuild);
+			PackingStatistics.NumRasterPackings += NumProbes;
+
+			int32 BestProbe = -1;
+			for (int32 Probe = 0; Probe < NumProbes; Probe++)
+			{
+				if (Packings[ProbePackings[Probe]].bFit)
+				{
+					BestProbe = Probe;
+				}
+			}
+
+			if (BestProbe >= 0)
+			{
+				BestPacking = ProbePackings[BestProbe];
+				UVScalePass = Packings[BestPacking].UVScale;
+				if (BestProbe + 1 < NumProbes)
+				{
+					UVScaleFail = Packings[ProbePackings[BestProbe + 1]].UVScale;
+					bFailEstimated = false;
+				}
+				else if (bFailEstimated && UVScaleFail < UVScaleMax)
+				{
+					// The top fit and nothing ever failed above, move the range up instead of narrowing it
+					UVScaleFail = FMath::Min(UVScaleMax, UVScalePass * RasterSearchRange);
+					continue;
+				}
+				Round++;
+			}
+			else if (BestPacking < 0)
+			{
+				// Not even the pass estimate fit, search below it
+				UVScaleFail = UVScalePass;
+				UVScalePass *= LinearSearchStep;
+				bFailEstimated = false;
+			}
+			else
+			{
+				UVScaleFail = Packings[ProbePackings[0]].UVScale;
+				bFailEstimated = false;
+				Round++;
+			}
+		}
+
+		return true;
+	}
+
+	void FLayoutUV::ScaleCharts(std::vector< FMeshChart >& ScaledCharts, float UVScale) const
+	{
+		for (size_t i = 0; i < ScaledCharts.size(); i++)
+		{
+			FMeshChart& Chart = ScaledCharts[i];
 			Chart.UVScale = Chart.WorldScale * UVScale;
 		}
 
@@ -650,9 +812,9 @@ namespace MeshDescriptionOp
 		{
 			uint32 NumMaxedOut = 0;
 			float ScaledUVArea = 0.0f;
-			for (size_t ChartIndex = 0; ChartIndex < Charts.size(); ChartIndex++)
+			for (size_t ChartIndex = 0; ChartIndex < ScaledCharts.size(); ChartIndex++)
 			{
-				FMeshChart& Chart = Charts[ChartIndex];
+				FMeshChart& Chart = ScaledCharts[ChartIndex];
 
 				Vector2 ChartSize = Chart.MaxUV - Chart.MinUV;
 				Vector2 ChartSizeScaled = ChartSize * Chart.UVScale * UniformScale;
@@ -683,7 +845,7 @@ namespace MeshDescriptionOp
 				break;
 			}
 
-			if (NumMaxedOut == Charts.size())
+			if (NumMaxedOut == ScaledCharts.size())
 			{
 				// All charts are maxed out
 				break;
@@ -707,9 +869,9 @@ namespace MeshDescriptionOp
 		{
 			uint32 NumMaxedOut = 0;
 			float ScaledUVArea = 0.0f;
-			for (size_t ChartIndex = 0; ChartIndex < Charts.size(); ChartIndex++)
+			for (size_t ChartIndex = 0; ChartIndex < ScaledCharts.size(); ChartIndex++)
 			{
-				FMeshChart& Chart = Charts[ChartIndex];
+				FMeshChart& Chart = ScaledCharts[ChartIndex];
 
 				for (int k = 0; k < 2; k++)
 				{
@@ -739,7 +901,7 @@ namespace MeshDescriptionOp
 				break;
 			}
 
-			if (NumMaxedOut == Charts.size() * 2)
+			if (NumMaxedOut == ScaledCharts.size() * 2)
 			{
 				// All charts are maxed out in both dimensions
 				break;
@@ -768,22 +930,77 @@ namespace MeshDescriptionOp
 				return ChartRectA.X * ChartRectA.Y > ChartRectB.X * ChartRectB.Y;
 			}
 		};
-		std::sort(Charts.begin(), Charts.end(), FCompareCharts());
+		std::sort(ScaledCharts.begin(), ScaledCharts.end(), FCompareCharts());
 		//Algo::IntroSort(Charts, FCompareCharts());
 	}
 
-	bool FLayoutUV::PackCharts()
+	bool FLayoutUV::PackChartRects(std::vector< FMeshChart >& ScaledCharts, FSkylineAllocator2D& Skyline) const
+	{
+		for (FMeshChart& Chart : ScaledCharts)
+		{
+			// The other orientations only mirror these two rects
+			FAllocator2D::FRect	BestRect = { ~0u, ~0u, ~0u, ~0u };
+			for (int32 Orientation = 0; Orientation < 4; Orientation += 2)
+			{
+				OrientChart(Chart, Orientation);
+
+				FAllocator2D::FRect	Rect = GetChartRect(Chart);
+				if (Skyline.Find(Rect) && Rect.X + Rect.Y * TextureResolution < BestRect.X + BestRect.Y * TextureResolution)
+				{
+					BestRect = Rect;
+				}
+			}
+
+			if (BestRect.W == ~0u)
+			{
+				return false;
+			}
+			Skyline.Alloc(BestRect);
+		}
+
+		return true;
+	}
+
+	FAllocator2D::FRect FLayoutUV::GetChartRect(const FMeshChart& Chart) const
+	{
+		Vector2 ChartSize = Chart.MaxUV - Chart.MinUV;
+		ChartSize = ChartSize.X * Chart.PackingScaleU + ChartSize.Y * Chart.PackingScaleV;
+
+		// Only need half pixel dilate for rects
+		FAllocator2D::FRect	Rect;
+		Rect.X = 0;
+		Rect.Y = 0;
+		Rect.W = FMath::CeilToInt(FMath::Abs(ChartSize.X) + 1.0f);
+		Rect.H = FMath::CeilToInt(FMath::Abs(ChartSize.Y) + 1.0f);
+
+		// Just in case lack of precision pushes it over
+		Rect.W = FMath::Min(TextureResolution, Rect.W);
+		Rect.H = FMath::Min(TextureResolution, Rect.H);
+
+		return Rect;
+	}
+
+	bool FLayoutUV::PackCharts(FChartPacking& Packing, float UVScale) const
 	{
 		uint32 RasterizeCycles = 0;
 		uint32 FindCycles = 0;
 
 		//double BeginPackCharts = FPlatformTime::Seconds();
 
+		Packing.Charts = Charts;
+		Packing.UVScale = UVScale;
+		Packing.bFit = false;
+		ScaleCharts(Packing.Charts, UVScale);
+
+		FAllocator2D& LayoutRaster = Packing.LayoutRaster;
+		FAllocator2D& ChartRaster = Packing.ChartRaster;
+		FAllocator2D& BestChartRaster = Packing.BestChartRaster;
+
 		LayoutRaster.Clear();
 
-		for (size_t i = 0; i < Charts.size(); i++)
+		for (size_t i = 0; i < Packing.Charts.size(); i++)
 		{
-			FMeshChart& Chart = Charts[i];
+			FMeshChart& Chart = Packing.Charts[i];
 
 			// Try different orientations and pick best
 			int32				BestOrientation = -1;
@@ -795,19 +1012,7 @@ namespace MeshDescriptionOp
 
 				OrientChart(Chart, Orientation);
 
-				Vector2 ChartSize = Chart.MaxUV - Chart.MinUV;
-				ChartSize = ChartSize.X * Chart.PackingScaleU + ChartSize.Y * Chart.PackingScaleV;
-
-				// Only need half pixel dilate for rects
-				FAllocator2D::FRect	Rect;
-				Rect.X = 0;
-				Rect.Y = 0;
-				Rect.W = FMath::CeilToInt(FMath::Abs(ChartSize.X) + 1.0f);
-				Rect.H = FMath::CeilToInt(FMath::Abs(ChartSize.Y) + 1.0f);
-
-				// Just in case lack of precision pushes it over
-				Rect.W = FMath::Min(TextureResolution, Rect.W);
-				Rect.H = FMath::Min(TextureResolution, Rect.H);
+				FAllocator2D::FRect	Rect = GetChartRect(Chart);
 
 				const bool bRectPack = false;
 
@@ -840,7 +1045,7 @@ namespace MeshDescriptionOp
 					else
 					{
 						//int32 BeginRasterize = FPlatformTime::Cycles();
-						RasterizeChart(Chart, Rect.W, Rect.H);
+						RasterizeChart(Chart, Rect.W, Rect.H, ChartRaster);
 						//RasterizeCycles += FPlatformTime::Cycles() - BeginRasterize;
 					}
 
@@ -904,10 +1109,11 @@ namespace MeshDescriptionOp
 		//UE_LOG(LogMeshDescriptionLayoutUV, Display, TEXT("  Rasterize: %u"), RasterizeCycles);
 		//UE_LOG(LogMeshDescriptionLayoutUV, Display, TEXT("  Find: %u"), FindCycles);
 
+		Packing.bFit = true;
 		return true;
 	}
 
-	void FLayoutUV::OrientChart(FMeshChart& Chart, int32 Orientation)
+	void FLayoutUV::OrientChart(FMeshChart& Chart, int32 Orientation) const
 	{
 		switch (Orientation)
 		{
@@ -1043,7 +1249,7 @@ namespace MeshDescriptionOp
 		}
 	}
 
-	void FLayoutUV::RasterizeChart(const FMeshChart& Chart, uint32 RectW, uint32 RectH)
+	void FLayoutUV::RasterizeChart(const FMeshChart& Chart, uint32 RectW, uint32 RectH, FAllocator2D& ChartRaster) const
 	{
 		// Bilinear footprint is -1 to 1 pixels. If packed geometrically, only a half pixel dilation
 		// would be needed to guarantee all charts were at least 1 pixel away, safe for bilinear filtering.
@@ -1051,6 +1257,7 @@ namespace MeshDescriptionOp
 		// align with pixel centers.
 
 		ChartRaster.Clear();
+		FAllocator2DShader ChartShader(&ChartRaster);
 
 		for (uint32 Tri = Chart.FirstTri; Tri < Chart.LastTri; Tri++)
 		{
@@ -1073,14 +1280,15 @@ namespace MeshDescriptionOp
 	void FLayoutUV::CommitPackedUVs()
 	{
 		// If current DstChannel is out of range of the number of UVs defined by the mesh description, change the index count accordingly
-		const uint32 NumUVs = MD.VertexInstanceAttributes().GetAttributeIndexCount<Vector2>(MeshAttribute::VertexInstance::TextureCoordinate);
+		TMeshAttributesRef<Vector2> VertexInstanceUVs = MD.VertexInstanceAttributes().GetAttributesRef<Vector2>(MeshAttribute::VertexInstance::TextureCoordinate);
+		const uint32 NumUVs = VertexInstanceUVs.GetNumIndices();
 		if (DstChannel >= NumUVs)
 		{
-			MD.VertexInstanceAttributes().SetAttributeIndexCount<Vector2>(MeshAttribute::VertexInstance::TextureCoordinate, DstChannel + 1);
+			VertexInstanceUVs.SetNumIndices(DstChannel + 1);
 			//ensure(false);	// not expecting it to get here
 		}
 
-		std::vector<Vector2>& VertexUVs = MD.VertexInstanceAttributes().GetAttributes<Vector2>(MeshAttribute::VertexInstance::TextureCoordinate, DstChannel);
+		std::vector<Vector2>& DstUVs = VertexInstanceUVs.GetRawArray(DstChannel);
 
 		// Commit chart UVs
 		for (size_t i = 0; i < Charts.size(); i++)
@@ -1098,7 +1306,7 @@ namespace MeshDescriptionOp
 					uint32 Index = 3 * SortedTris[Tri] + k;
 					const Vector2& UV = TexCoords[Index];
 					const int VertexInstanceID(RemapVerts[Index]);
-					VertexUVs[VertexInstanceID] = UV.X * Chart.PackingScaleU + UV.Y * Chart.PackingScaleV + Chart.PackingBias;
+					DstUVs[VertexInstanceID] = UV.X * Chart.PackingScaleU + UV.Y * Chart.PackingScaleV + Chart.PackingBias;
 				}
 			}
 		}
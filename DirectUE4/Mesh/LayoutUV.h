@@ -45,17 +45,37 @@ namespace MeshDescriptionOp
 		}
 	};
 
+	/** Charts laid out at one UV scale and the rasters packing them needs, so several scales can be tried at once */
+	struct FChartPacking
+	{
+		FChartPacking(uint32 TextureResolution)
+			: LayoutRaster(TextureResolution, TextureResolution)
+			, ChartRaster(TextureResolution, TextureResolution)
+			, BestChartRaster(TextureResolution, TextureResolution)
+		{}
+
+		std::vector< FMeshChart >	Charts;
+		float				UVScale = 0.f;
+		bool				bFit = false;
+
+		FAllocator2D		LayoutRaster;
+		FAllocator2D		ChartRaster;
+		FAllocator2D		BestChartRaster;
+	};
+
 	class FLayoutUV
 	{
 	public:
 		FLayoutUV(MeshDescription& InMesh, uint32 InSrcChannel, uint32 InDstChannel, uint32 InTextureResolution);
 
-		void		FindCharts(const std::multimap<int32, int32>& OverlappingCorners);
+		void		FindCharts(const FOverlappingCornerAdjacency& OverlappingCorners);
 		bool		FindBestPacking();
 		void		CommitPackedUVs();
 
 		void		SetVersion(MeshDescriptionOperations::ELightmapUVVersion Version) { LayoutVersion = Version; }
 
+		const MeshDescriptionOperations::FLightmapUVPackingStatistics& GetPackingStatistics() const { return PackingStatistics; }
+
 	private:
 		bool		PositionsMatch(uint32 a, uint32 b) const;
 		bool		NormalsMatch(uint32 a, uint32 b) const;
@@ -64,14 +84,22 @@ namespace MeshDescriptionOp
 		float		TriangleUVArea(uint32 Tri) const;
 		void		DisconnectChart(FMeshChart& Chart, uint32 Side);
 
-		void		ScaleCharts(float UVScale);
-		bool		PackCharts();
-		void		OrientChart(FMeshChart& Chart, int32 Orientation);
-		void		RasterizeChart(const FMeshChart& Chart, uint32 RectW, uint32 RectH);
+		bool		FindBestPackingFast(std::vector< FChartPacking >& Packings, int32& BestPacking);
+		bool		FindBestPackingLinear(FChartPacking& Packing);
+
+		void		ScaleCharts(std::vector< FMeshChart >& ScaledCharts, float UVScale) const;
+		bool		PackChartRects(std::vector< FMeshChart >& ScaledCharts, FSkylineAllocator2D& Skyline) const;
+		bool		PackCharts(FChartPacking& Packing, float UVScale) const;
+		void		OrientChart(FMeshChart& Chart, int32 Orientation) const;
+		FAllocator2D::FRect GetChartRect(const FMeshChart& Chart) const;
+		void		RasterizeChart(const FMeshChart& Chart, uint32 RectW, uint32 RectH, FAllocator2D& ChartRaster) const;
 
 		float		GetUVEqualityThreshold() const { return LayoutVersion >= MeshDescriptionOperations::ELightmapUVVersion::SmallChartPacking ? NEW_UVS_ARE_SAME : LEGACY_UVS_ARE_SAME; }
 
 		MeshDescription&	MD;
+		TMeshAttributesConstRef<FVector>	VertexPositions;
+		TMeshAttributesConstRef<FVector>	VertexNormals;
+		TMeshAttributesConstRef<Vector2>	VertexUVs;
 		uint32				SrcChannel;
 		uint32				DstChannel;
 		uint32				TextureResolution;
@@ -83,12 +111,8 @@ namespace MeshDescriptionOp
 		float					MaxChartSize;
 		std::vector< int32 >	RemapVerts;
 
-		FAllocator2D		LayoutRaster;
-		FAllocator2D		ChartRaster;
-		FAllocator2D		BestChartRaster;
-		FAllocator2DShader	ChartShader;
-
 		MeshDescriptionOperations::ELightmapUVVersion LayoutVersion;
+		MeshDescriptionOperations::FLightmapUVPackingStatistics PackingStatistics;
 	};
 
 
@@ -99,7 +123,6 @@ namespace MeshDescriptionOp
 		const int VertexIDA = MD.GetVertexInstanceVertex(VertexInstanceIDA);
 		const int VertexIDB = MD.GetVertexInstanceVertex(VertexInstanceIDB);
 
-		const std::vector<FVector>& VertexPositions = MD.VertexAttributes().GetAttributes<FVector>(MeshAttribute::Vertex::Position);
 		return VertexPositions[VertexIDA].Equals(VertexPositions[VertexIDB], THRESH_POINTS_ARE_SAME);
 	}
 
@@ -107,7 +130,7 @@ namespace MeshDescriptionOp
 	{
 		// If current SrcChannel is out of range of the number of UVs defined by the mesh description, just return true
 		// @todo: hopefully remove this check entirely and just ensure that the mesh description matches the inputs
-		const uint32 NumUVs = MD.VertexInstanceAttributes().GetAttributeIndexCount<Vector2>(MeshAttribute::VertexInstance::TextureCoordinate);
+		const uint32 NumUVs = VertexUVs.GetNumIndices();
 		if (SrcChannel >= NumUVs)
 		{
 			//ensure(false);	// not expecting it to get here
@@ -117,14 +140,13 @@ namespace MeshDescriptionOp
 		const int VertexInstanceIDA(RemapVerts[a]);
 		const int VertexInstanceIDB(RemapVerts[b]);
 
-		const std::vector<FVector>& VertexNormals = MD.VertexInstanceAttributes().GetAttributes<FVector>(MeshAttribute::VertexInstance::Normal);
 		return VertexNormals[VertexInstanceIDA].Equals(VertexNormals[VertexInstanceIDB], THRESH_NORMALS_ARE_SAME);
 	}
 
 	inline bool FLayoutUV::UVsMatch(uint32 a, uint32 b) const
 	{
 		// If current SrcChannel is out of range of the number of UVs defined by the mesh description, just return true
-		const uint32 NumUVs = MD.VertexInstanceAttributes().GetAttributeIndexCount<Vector2>(MeshAttribute::VertexInstance::TextureCoordinate);
+		const uint32 NumUVs = VertexUVs.GetNumIndices();
 		if (SrcChannel >= NumUVs)
 		{
 			//ensure(false);	// not expecting it to get here
@@ -134,8 +156,7 @@ namespace MeshDescriptionOp
 		const int VertexInstanceIDA(RemapVerts[a]);
 		const int VertexInstanceIDB(RemapVerts[b]);
 
-		const std::vector<Vector2>& VertexUVs = MD.VertexInstanceAttributes().GetAttributes<Vector2>(MeshAttribute::VertexInstance::TextureCoordinate, SrcChannel);
-		return VertexUVs[VertexInstanceIDA].Equals(VertexUVs[VertexInstanceIDB], GetUVEqualityThreshold());
+		return VertexUVs.Get(VertexInstanceIDA, SrcChannel).Equals(VertexUVs.Get(VertexInstanceIDB, SrcChannel), GetUVEqualityThreshold());
 	}
 
 	inline bool FLayoutUV::VertsMatch(uint32 a, uint32 b) const
@@ -146,12 +167,10 @@ namespace MeshDescriptionOp
 	// Signed UV area
 	inline float FLayoutUV::TriangleUVArea(uint32 Tri) const
 	{
-		const std::vector<Vector2>& VertexUVs = MD.VertexInstanceAttributes().GetAttributes<Vector2>(MeshAttribute::VertexInstance::TextureCoordinate, SrcChannel);
-
 		Vector2 UVs[3];
 		for (int k = 0; k < 3; k++)
 		{
-			UVs[k] = VertexUVs[int(RemapVerts[(3 * Tri) + k])];
+			UVs[k] = VertexUVs.Get(int(RemapVerts[(3 * Tri) + k]), SrcChannel);
 		}
 
 		Vector2 EdgeUV1 = UVs[1] - UVs[0];
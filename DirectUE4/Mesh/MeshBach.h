@@ -17,6 +17,8 @@ struct FMeshBatchElement
 
 	//const FIndexBuffer* IndexBuffer;
 	const ID3D11Buffer* IndexBuffer;
+	/** R16_UINT or R32_UINT, what IndexBuffer holds */
+	DXGI_FORMAT IndexBufferFormat;
 // 	union
 // 	{
 // 		/** If bIsSplineProxy, Instance runs, where number of runs is specified by NumInstances.  Run structure is [StartInstanceIndex, EndInstanceIndex]. */
@@ -56,6 +58,7 @@ struct FMeshBatchElement
 	FMeshBatchElement()
 		: PrimitiveUniformBufferResource(nullptr)
 		, IndexBuffer(nullptr)
+		, IndexBufferFormat(DXGI_FORMAT_R32_UINT)
 		//, InstanceRuns(nullptr)
 		, UserData(nullptr)
 		, NumInstances(1)
@@ -86,7 +89,7 @@ struct FMeshBatch
 	std::vector<FMeshBatchElement> Elements;
 
 	/** LOD index of the mesh, used for fading LOD transitions. */
-	//int8 LODIndex;
+	int8 LODIndex;
 
 // #if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
 // 	/** Conceptual LOD index used for the LOD Coloration visualization. */
@@ -210,12 +213,12 @@ struct FMeshBatch
 
 	/** Default constructor. */
 	FMeshBatch()
-		//: LODIndex(INDEX_NONE)
+		: LODIndex(INDEX_NONE)
 // #if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
 // 		, VisualizeLODIndex(INDEX_NONE)
 // #endif
 		//, VisualizeHLODIndex(INDEX_NONE)
-		: ReverseCulling(false)
+		, ReverseCulling(false)
 		, bDisableBackfaceCulling(false)
 		, CastShadow(true)
 		, bUseForMaterial(true)
@@ -7,6 +7,9 @@
 #include "SkeletalRenderGPUSkin.h"
 #include "SkeletalMesh.h"
 #include "AnimSingleNodeInstance.h"
+#include "AnimationRuntime.h"
+#include "Camera.h"
+#include "BakedAnimation.h"
 
 UMeshComponent::UMeshComponent(AActor* InOwner)
 	: UPrimitiveComponent(InOwner)
@@ -110,9 +113,13 @@ void USkinnedMeshComponent::TickPose(float DeltaTime, bool bNeedsValidRootMotion
 
 void USkinnedMeshComponent::TickComponent(float DeltaTime/*, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction*/)
 {
-	//if (ShouldTickPose())
-	{
-		TickPose(DeltaTime, false);
+	UpdateMaxDistanceFactor();
+	UpdateLODStatus();
+	TickUpdateRate(DeltaTime);
+
+	if (ShouldTickPose())
+	{
+		TickPose(DeltaTime, false);
 	}
 
 	//if (ShouldUpdateTransform(bLODHasChanged))
@@ -129,8 +136,70 @@ void USkinnedMeshComponent::TickComponent(float DeltaTime/*, enum ELevelTick Tic
 	}
 }
 
+bool USkinnedMeshComponent::ShouldTickPose() const
+{
+	return true;
+}
+
+bool USkinnedMeshComponent::ShouldUseUpdateRateOptimizations() const
+{
+	return GEnableAnimUpdateRateOptimizations && bEnableUpdateRateOptimizations;
+}
+
+void USkinnedMeshComponent::TickUpdateRate(float DeltaTime)
+{
+	if (!ShouldUseUpdateRateOptimizations())
+	{
+		return;
+	}
+
+	AnimUpdateRateParams.SetScreenSize(DeltaTime, MaxDistanceFactor);
+}
+
+void USkinnedMeshComponent::UpdateMaxDistanceFactor()
+{
+	const std::vector<Camera*>& Cameras = GetWorld()->GetCameras();
+	if (Cameras.size() == 0)
+	{
+		// nothing looks at us, stay at full detail
+		MaxDistanceFactor = 1.f;
+		return;
+	}
+
+	// skinned components have no mesh bounds, the last posed bones are close enough to size the character on screen
+	const std::vector<FTransform>& SpaceBases = GetComponentSpaceTransforms();
+	if (SpaceBases.size() == 0)
+	{
+		return;
+	}
+	FBox BoneBox;
+	BoneBox.Init();
+	for (const FTransform& SpaceBase : SpaceBases)
+	{
+		BoneBox += SpaceBase.GetLocation();
+	}
+	FVector LocalCenter, LocalExtent;
+	BoneBox.GetCenterAndExtents(LocalCenter, LocalExtent);
+
+	const FTransform& LocalToWorld = GetComponentTransform();
+	const FVector Origin = LocalToWorld.TransformPosition(LocalCenter);
+	const float SphereRadius = LocalExtent.Size() * LocalToWorld.GetMaximumAxisScale();
+
+	MaxDistanceFactor = 0.f;
+	for (Camera* C : Cameras)
+	{
+		// the projection the camera's scene views get, so update rates and skeletal LODs agree with static mesh LODs
+		const FMatrix ProjectionMatrix = C->GetProjectionMatrix((float)WindowWidth / (float)WindowHeight);
+		MaxDistanceFactor = FMath::Max(MaxDistanceFactor, ComputeBoundsScreenSize(Origin, SphereRadius, C->GetViewOrigin(), ProjectionMatrix));
+	}
+}
+
 void USkinnedMeshComponent::OnRegister()
 {
+	// spread components that end up at the same rate over different frames
+	static uint8 NextUpdateRateShift = 0;
+	AnimUpdateRateParams.UpdateRateShift = NextUpdateRateShift++;
+
 	if (!MasterPoseComponent.expired())
 	{
 		// we have to make sure it updates the mastesr pose
@@ -201,7 +270,7 @@ void USkinnedMeshComponent::SendRenderDynamicData_Concurrent()
 	if (MeshObject && SkeletalMesh)
 	{
 
-		const int32 UseLOD = 0;// PredictedLODLevel;
+		const int32 UseLOD = PredictedLODLevel;
 
 		//const bool bMorphTargetsAllowed = CVarEnableMorphTargets.GetValueOnAnyThread(true) != 0;
 
@@ -211,7 +280,7 @@ void USkinnedMeshComponent::SendRenderDynamicData_Concurrent()
 // 			ActiveMorphTargets.Empty();
 // 		}
 
-		//check(UseLOD < MeshObject->GetSkeletalMeshRenderData().LODRenderData.Num());
+		assert(UseLOD < (int32)SkeletalMesh->GetResourceForRendering()->LODRenderData.size());
 		MeshObject->Update(UseLOD, this, /*ActiveMorphTargets, MorphTargetWeights,*/ false);  // send to rendering thread
 		//MeshObject->bHasBeenUpdatedAtLeastOnce = true;
 
@@ -243,8 +312,27 @@ void USkinnedMeshComponent::DestroyRenderState_Concurrent()
 
 bool USkinnedMeshComponent::UpdateLODStatus()
 {
-	PredictedLODLevel = 0;
-	return true;
+	const int32 OldLODLevel = PredictedLODLevel;
+
+	int32 NewLODLevel = 0;
+	FSkeletalMeshRenderData* SkelMeshRenderData = GetSkeletalMeshRenderData();
+	if (SkeletalMesh && SkelMeshRenderData)
+	{
+		const int32 MaxLODIndex = FMath::Min((int32)SkeletalMesh->GetLODNum(), (int32)SkelMeshRenderData->LODRenderData.size()) - 1;
+
+		// Look for a lower LOD if the screen size is below its threshold, starting from the lowest one.
+		for (int32 LODIndex = MaxLODIndex; LODIndex > 0; LODIndex--)
+		{
+			if (MaxDistanceFactor < SkeletalMesh->GetLODInfo(LODIndex)->ScreenSize)
+			{
+				NewLODLevel = LODIndex;
+				break;
+			}
+		}
+	}
+
+	PredictedLODLevel = NewLODLevel;
+	return OldLODLevel != PredictedLODLevel;
 }
 
 void USkinnedMeshComponent::UpdateMasterBoneMap()
@@ -453,9 +541,9 @@ void USkeletalMeshComponent::TickPose(float DeltaTime, bool bNeedsValidRootMotio
 		// Don't care about roll over, just care about uniqueness (and 32-bits should give plenty).
 		//LastPoseTickFrame = static_cast<uint32>(GFrameCounter);
 
-		//const bool bUseUpdateRateOptimizations = ShouldUseUpdateRateOptimizations();
-		//float TimeAdjustment = bUseUpdateRateOptimizations ? AnimUpdateRateParams->GetTimeAdjustment() : 0.0f;
-		TickAnimation(DeltaTime /*+ TimeAdjustment*/, bNeedsValidRootMotion);
+		const bool bUseUpdateRateOptimizations = ShouldUseUpdateRateOptimizations();
+		float TimeAdjustment = bUseUpdateRateOptimizations ? AnimUpdateRateParams.GetTimeAdjustment() : 0.0f;
+		TickAnimation(DeltaTime + TimeAdjustment, bNeedsValidRootMotion);
 	}
 }
 
@@ -464,6 +552,13 @@ void USkeletalMeshComponent::TickComponent(float DeltaTime/*, enum ELevelTick Ti
 	USkinnedMeshComponent::TickComponent(DeltaTime);
 }
 
+bool USkeletalMeshComponent::ShouldTickPose() const
+{
+	// skipped updates are not lost, their time is added to the next update through GetTimeAdjustment
+	const bool bSkipUpdate = ShouldUseUpdateRateOptimizations() && AnimUpdateRateParams.ShouldSkipUpdate();
+	return USkinnedMeshComponent::ShouldTickPose() && !bSkipUpdate;
+}
+
 void USkeletalMeshComponent::PerformAnimationEvaluation(const USkeletalMesh* InSkeletalMesh, UAnimInstance* InAnimInstance, std::vector<FTransform>& OutSpaceBases, std::vector<FTransform>& OutBoneSpaceTransforms, FVector& OutRootBoneTranslation, FBlendedHeapCurve& OutCurve) const
 {
 	PerformAnimationProcessing(InSkeletalMesh, InAnimInstance, true, OutSpaceBases, OutBoneSpaceTransforms, OutRootBoneTranslation, OutCurve);
@@ -650,7 +745,20 @@ void USkeletalMeshComponent::RefreshBoneTransforms(/*FActorComponentTickFunction
 		RecalcRequiredBones(PredictedLODLevel);
 	}
 
-	const bool bShouldDoEvaluation = true;
+	const bool bDoEvaluationRateOptimization = ShouldUseUpdateRateOptimizations() && AnimUpdateRateParams.DoEvaluationRateOptimizations();
+	if (!bDoEvaluationRateOptimization)
+	{
+		// the cache goes stale while we evaluate every frame, drop it so the next throttled frame refills it first
+		CachedComponentSpaceTransforms.clear();
+	}
+
+	// a cache that doesn't match the skeleton has nothing to interpolate towards, evaluate this frame and fill it
+	const bool bInvalidCachedBones = bDoEvaluationRateOptimization && (CachedComponentSpaceTransforms.size() != GetNumComponentSpaceTransforms());
+
+	const bool bShouldDoEvaluation = !bDoEvaluationRateOptimization || bInvalidCachedBones || !AnimUpdateRateParams.ShouldSkipEvaluation();
+
+	bDoInterpolation = bDoEvaluationRateOptimization && !bInvalidCachedBones && AnimUpdateRateParams.ShouldInterpolateSkippedFrames();
+	bDuplicateToCacheBones = bInvalidCachedBones || (bDoEvaluationRateOptimization && bShouldDoEvaluation && !bDoInterpolation);
 
 	if (bShouldDoEvaluation)
 	{
@@ -669,12 +777,46 @@ void USkeletalMeshComponent::RefreshBoneTransforms(/*FActorComponentTickFunction
 // 			PostProcessAnimInstance->PreEvaluateAnimation();
 // 		}
 
-		PerformAnimationEvaluation(SkeletalMesh, AnimScriptInstance, GetEditableComponentSpaceTransforms(), BoneSpaceTransforms, RootBoneTranslation, AnimCurves);
-		bNeedToFlipSpaceBaseBuffers = true;
-		FlipEditableSpaceBases();
-		MarkRenderDynamicDataDirty();
+		// the world runs every queued evaluation on worker threads once all actors have ticked
+		if (!GetWorld() || !GetWorld()->QueueParallelAnimationEvaluation(this))
+		{
+			ParallelAnimationEvaluation();
+			CompleteParallelAnimationEvaluation();
+		}
 	}
+	else if (bDoInterpolation)
+	{
+		// skipped frame, keep trailing the last evaluated pose; without interpolation the current pose is simply held
+		CompleteParallelAnimationEvaluation();
+	}
+
+}
 
+void USkeletalMeshComponent::ParallelAnimationEvaluation()
+{
+	std::vector<FTransform>& OutSpaceBases = bDoInterpolation ? CachedComponentSpaceTransforms : GetEditableComponentSpaceTransforms();
+	PerformAnimationEvaluation(SkeletalMesh, AnimScriptInstance, OutSpaceBases, BoneSpaceTransforms, RootBoneTranslation, AnimCurves);
+}
+
+void USkeletalMeshComponent::CompleteParallelAnimationEvaluation()
+{
+	if (bDuplicateToCacheBones)
+	{
+		CachedComponentSpaceTransforms = GetEditableComponentSpaceTransforms();
+	}
+
+	if (bDoInterpolation)
+	{
+		// move the displayed pose part of the way towards the last evaluated one
+		const float Alpha = AnimUpdateRateParams.GetInterpolationAlpha();
+		std::vector<FTransform>& EditableSpaceBases = GetEditableComponentSpaceTransforms();
+		EditableSpaceBases = GetComponentSpaceTransforms();
+		FAnimationRuntime::LerpBoneTransforms(EditableSpaceBases, CachedComponentSpaceTransforms, Alpha, FillComponentSpaceTransformsRequiredBones);
+	}
+
+	bNeedToFlipSpaceBaseBuffers = true;
+	FlipEditableSpaceBases();
+	MarkRenderDynamicDataDirty();
 }
 
 void USkeletalMeshComponent::RecalcRequiredBones(int32 LODIndex)
@@ -688,6 +830,16 @@ void USkeletalMeshComponent::RecalcRequiredBones(int32 LODIndex)
 
 	BoneSpaceTransforms = SkeletalMesh->RefSkeleton.GetRefBonePose();
 
+	// bones the new LOD doesn't evaluate are stale in the cache, refill it before interpolating again
+	CachedComponentSpaceTransforms.clear();
+
+	if (AnimScriptInstance)
+	{
+		AnimScriptInstance->RecalcRequiredBones();
+	}
+
+	bRequiredBonesUpToDate = true;
+
 }
 
 void USkeletalMeshComponent::ComputeRequiredBones(std::vector<FBoneIndexType>& OutRequiredBones, std::vector<FBoneIndexType>& OutFillComponentSpaceTransformsRequiredBones, int32 LODIndex, bool bIgnorePhysicsAsset) const
@@ -712,6 +864,16 @@ void USkeletalMeshComponent::ComputeRequiredBones(std::vector<FBoneIndexType>& O
 	OutFillComponentSpaceTransformsRequiredBones = OutRequiredBones;
 }
 
+bool USkeletalMeshComponent::UpdateLODStatus()
+{
+	const bool bLODChanged = USkinnedMeshComponent::UpdateLODStatus();
+	if (bLODChanged)
+	{
+		bRequiredBonesUpToDate = false;
+	}
+	return bLODChanged;
+}
+
 void USkeletalMeshComponent::OnRegister()
 {
 	USkinnedMeshComponent::OnRegister();
@@ -765,4 +927,70 @@ void USkeletalMeshComponent::FillComponentSpaceTransforms(const USkeletalMesh* I
 		SpaceBase->NormalizeRotation();
 	}
 
-}
+}
+
+void UBakedSkeletalMeshComponent::SetBakedAnimation(std::shared_ptr<const FBakedAnimationData> InBakedAnimation, int32 InSequenceIndex, float InTimeOffset)
+{
+	assert(!InBakedAnimation || !SkeletalMesh || InBakedAnimation->GetNumBones() == SkeletalMesh->RefSkeleton.GetNum());
+
+	BakedAnimation = InBakedAnimation;
+	SequenceIndex = InSequenceIndex;
+	TimeOffset = InTimeOffset;
+	CurrentTime = 0.f;
+	ReferenceToLocal.clear();
+	PreviousReferenceToLocal.clear();
+}
+
+void UBakedSkeletalMeshComponent::OnRegister()
+{
+	// decoding is cheap enough to do every frame, only the LOD follows the screen size
+	bEnableUpdateRateOptimizations = false;
+
+	USkinnedMeshComponent::OnRegister();
+
+	// the bones never move in component space, the bind pose is what sizes the mesh on screen
+	if (SkeletalMesh)
+	{
+		const FReferenceSkeleton& RefSkeleton = SkeletalMesh->RefSkeleton;
+		const std::vector<FTransform>& RefBonePose = RefSkeleton.GetRefBonePose();
+		// fill both buffers, nothing flips them afterwards
+		for (int32 BufferIndex = 0; BufferIndex < 2; ++BufferIndex)
+		{
+			std::vector<FTransform>& SpaceBases = GetEditableComponentSpaceTransforms();
+			for (uint32 BoneIndex = 0; BoneIndex < SpaceBases.size(); ++BoneIndex)
+			{
+				const int32 ParentIndex = RefSkeleton.GetParentIndex(BoneIndex);
+				SpaceBases[BoneIndex] = (ParentIndex == INDEX_NONE) ? RefBonePose[BoneIndex] : RefBonePose[BoneIndex] * SpaceBases[ParentIndex];
+			}
+			bNeedToFlipSpaceBaseBuffers = true;
+			FlipEditableSpaceBases();
+		}
+	}
+}
+
+void UBakedSkeletalMeshComponent::TickPose(float DeltaTime, bool bNeedsValidRootMotion)
+{
+	CurrentTime += DeltaTime * PlayRate;
+}
+
+void UBakedSkeletalMeshComponent::RefreshBoneTransforms(/*FActorComponentTickFunction* TickFunction = NULL*/)
+{
+	if (!BakedAnimation || !SkeletalMesh || SequenceIndex < 0 || SequenceIndex >= BakedAnimation->GetNumSequences())
+	{
+		return;
+	}
+
+	std::swap(ReferenceToLocal, PreviousReferenceToLocal);
+	BakedAnimation->SampleReferenceToLocal(SequenceIndex, CurrentTime + TimeOffset, bLooping, ReferenceToLocal);
+	MarkRenderDynamicDataDirty();
+}
+
+const std::vector<FMatrix>* UBakedSkeletalMeshComponent::GetPrecomputedReferenceToLocal(bool bPrevious) const
+{
+	if (ReferenceToLocal.size() == 0)
+	{
+		return nullptr;
+	}
+	// the first frame has nothing to blur from
+	return (bPrevious && PreviousReferenceToLocal.size() == ReferenceToLocal.size()) ? &PreviousReferenceToLocal : &ReferenceToLocal;
+}
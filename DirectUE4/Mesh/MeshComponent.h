@@ -4,11 +4,13 @@
 #include "SingleAnimationPlayData.h"
 #include "AnimationAsset.h"
 #include "AnimCurveTypes.h"
+#include "AnimUpdateRateParameters.h"
 
 class AActor;
 class UMaterial;
 class FSkinWeightVertexBuffer;
 class FSkeletalMeshRenderData;
+class FBakedAnimationData;
 
 class UMeshComponent : public UPrimitiveComponent
 {
@@ -80,6 +82,9 @@ public:
 		CurrentEditableComponentTransforms = 0;
 		CurrentReadComponentTransforms = 1;
 		bNeedToFlipSpaceBaseBuffers = false;
+		bEnableUpdateRateOptimizations = false;
+		PredictedLODLevel = 0;
+		MaxDistanceFactor = 1.f;
 
 		CurrentBoneTransformRevisionNumber = 0;
 	}
@@ -90,6 +95,9 @@ public:
 	
 	int32 PredictedLODLevel;
 
+	/** Largest screen size of the component over all cameras, refreshed every tick by UpdateMaxDistanceFactor */
+	float MaxDistanceFactor;
+
 	std::weak_ptr<class USkinnedMeshComponent> MasterPoseComponent;
 
 	std::vector<uint8> BoneVisibilityStates;
@@ -109,6 +117,29 @@ public:
 	virtual void TickComponent(float DeltaTime/*, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction*/) override;
 
 	virtual void RefreshBoneTransforms(/*FActorComponentTickFunction* TickFunction = NULL*/) = 0;
+
+	/** Return true if this component should tick its pose this frame */
+	virtual bool ShouldTickPose() const;
+
+	/** Whether animation update and evaluation are throttled by screen size while GEnableAnimUpdateRateOptimizations is set, see FAnimUpdateRateParameters */
+	uint8 bEnableUpdateRateOptimizations : 1;
+
+	/** Update and evaluation rates of this frame, refreshed by TickUpdateRate */
+	FAnimUpdateRateParameters AnimUpdateRateParams;
+
+	bool ShouldUseUpdateRateOptimizations() const;
+
+	/**
+	* ReferenceToLocal matrices the component already has for this frame, e.g. from a baked animation.
+	* When this returns non null the renderer uses them instead of computing them from the component space transforms.
+	*/
+	virtual const std::vector<FMatrix>* GetPrecomputedReferenceToLocal(bool bPrevious) const { return nullptr; }
+
+	/** Works out this frame's animation update and evaluation rate from MaxDistanceFactor */
+	void TickUpdateRate(float DeltaTime);
+
+	/** Computes the screen size of the component in every camera and keeps the largest in MaxDistanceFactor */
+	void UpdateMaxDistanceFactor();
 protected:
 	virtual void OnRegister() override;
 	virtual void OnUnregister() override;
@@ -195,6 +226,9 @@ public:
 		, bForceRefpose(false)
 	{
 		GlobalAnimRateScale = 1.0f;
+		bRequiredBonesUpToDate = false;
+		bDoInterpolation = false;
+		bDuplicateToCacheBones = false;
 	}
 
 	virtual void SetSkeletalMesh(class USkeletalMesh* NewMesh, bool bReinitPose = true) override;
@@ -205,6 +239,7 @@ public:
 
 	virtual void TickPose(float DeltaTime, bool bNeedsValidRootMotion) override;
 	virtual void TickComponent(float DeltaTime/*, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction*/) override;
+	virtual bool ShouldTickPose() const override;
 
 	void PerformAnimationEvaluation(const USkeletalMesh* InSkeletalMesh, UAnimInstance* InAnimInstance, std::vector<FTransform>& OutSpaceBases, std::vector<FTransform>& OutBoneSpaceTransforms, FVector& OutRootBoneTranslation, FBlendedHeapCurve& OutCurve) const;
 	void PerformAnimationProcessing(const USkeletalMesh* InSkeletalMesh, UAnimInstance* InAnimInstance, bool bInDoEvaluation, std::vector<FTransform>& OutSpaceBases, std::vector<FTransform>& OutBoneSpaceTransforms, FVector& OutRootBoneTranslation, FBlendedHeapCurve& OutCurve) const;
@@ -231,14 +266,25 @@ public:
 	bool IsPlaying() const;
 
 	virtual void RefreshBoneTransforms(/*FActorComponentTickFunction* TickFunction = NULL*/) override;
+
+	/** Worker thread half of RefreshBoneTransforms: updates and evaluates the anim instance and fills the editable space bases */
+	void ParallelAnimationEvaluation();
+	/** Game thread half of RefreshBoneTransforms, run once ParallelAnimationEvaluation has finished */
+	void CompleteParallelAnimationEvaluation();
+
 	void RecalcRequiredBones(int32 LODIndex);
 
+	virtual bool UpdateLODStatus() override;
+
 	void ComputeRequiredBones(std::vector<FBoneIndexType>& OutRequiredBones, std::vector<FBoneIndexType>& OutFillComponentSpaceTransformsRequiredBones, int32 LODIndex, bool bIgnorePhysicsAsset) const;
 	
 	std::vector<FBoneIndexType> RequiredBones;
 
 	std::vector<FTransform> BoneSpaceTransforms;
 
+	/** Component space pose of the last evaluation while update rate optimizations interpolate skipped frames towards it */
+	std::vector<FTransform> CachedComponentSpaceTransforms;
+
 	std::vector<FBoneIndexType> FillComponentSpaceTransformsRequiredBones;
 
 	float GlobalAnimRateScale;
@@ -249,6 +295,11 @@ public:
 
 	uint8 bForceRefpose : 1;
 
+	/** This frame's evaluation goes to CachedComponentSpaceTransforms and the displayed pose is blended towards it */
+	uint8 bDoInterpolation : 1;
+	/** This frame's evaluation is copied to CachedComponentSpaceTransforms so later skipped frames can interpolate from it */
+	uint8 bDuplicateToCacheBones : 1;
+
 	FBlendedHeapCurve AnimCurves;
 protected:
 	virtual void OnRegister() override;
@@ -259,4 +310,42 @@ private:
 	void ClearAnimScriptInstance();
 
 	void FillComponentSpaceTransforms(const USkeletalMesh* InSkeletalMesh, const std::vector<FTransform>& InBoneSpaceTransforms, std::vector<FTransform>& OutComponentSpaceTransforms) const;
+};
+
+/**
+* Plays back a baked animation (see FBakedAnimationData) instead of evaluating one.
+* There is no anim instance and no pose: every tick decodes the ReferenceToLocal matrices of the current time and hands
+* them to the renderer directly, the only per instance state is the playback time.
+*/
+class UBakedSkeletalMeshComponent : public USkinnedMeshComponent
+{
+public:
+	UBakedSkeletalMeshComponent(AActor* InOwner)
+		: USkinnedMeshComponent(InOwner)
+		, SequenceIndex(0)
+		, TimeOffset(0.f)
+		, PlayRate(1.f)
+		, CurrentTime(0.f)
+		, bLooping(true)
+	{
+	}
+
+	/** Starts playing sequence InSequenceIndex of InBakedAnimation, InTimeOffset desynchronizes instances sharing it */
+	void SetBakedAnimation(std::shared_ptr<const FBakedAnimationData> InBakedAnimation, int32 InSequenceIndex, float InTimeOffset);
+
+	virtual void TickPose(float DeltaTime, bool bNeedsValidRootMotion) override;
+	virtual void RefreshBoneTransforms(/*FActorComponentTickFunction* TickFunction = NULL*/) override;
+	virtual const std::vector<FMatrix>* GetPrecomputedReferenceToLocal(bool bPrevious) const override;
+
+	std::shared_ptr<const FBakedAnimationData> BakedAnimation;
+	int32 SequenceIndex;
+	float TimeOffset;
+	float PlayRate;
+	float CurrentTime;
+	bool bLooping;
+protected:
+	virtual void OnRegister() override;
+
+	std::vector<FMatrix> ReferenceToLocal;
+	std::vector<FMatrix> PreviousReferenceToLocal;
 };
\ No newline at end of file
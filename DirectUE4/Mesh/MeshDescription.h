@@ -131,7 +131,7 @@ public:
 		Container.reserve(Elements);
 	}
 
-	inline void Reserve(const int32 Elements) { /*Container.Reserve(Elements);*/ }
+	inline void Reserve(const int32 Elements) { Container.reserve(Container.size() + Elements); }
 
 	inline int Add()
 	{
@@ -237,6 +237,72 @@ struct TTupleIndex<T, std::tuple<U, Types...>> {
 	static const std::size_t Value = 1U + TTupleIndex<T, std::tuple<Types...>>::Value;
 };
 
+/**
+ * Typed handle to one attribute of an AttributeSet. The name is resolved once when the handle is made, element access
+ * then indexes the attribute's contiguous per-index arrays directly.
+ * Stays valid while elements are created or removed and while the index count changes, until the attribute is unregistered.
+ */
+template <typename AttributeType>
+class TMeshAttributesRef
+{
+public:
+	typedef std::vector<AttributeType> ArrayType;
+
+	TMeshAttributesRef() : Arrays(nullptr) {}
+	explicit TMeshAttributesRef(std::vector<ArrayType>* InArrays) : Arrays(InArrays) {}
+
+	bool IsValid() const { return Arrays != nullptr; }
+
+	int GetNumIndices() const { return (int)Arrays->size(); }
+	int GetNumElements() const { return Arrays->empty() ? 0 : (int)(*Arrays)[0].size(); }
+
+	/** Element of the first index, the one almost every attribute has */
+	typename ArrayType::reference operator[](const int ElementID) const { return (*Arrays)[0][ElementID]; }
+
+	typename ArrayType::reference Get(const int ElementID, const int AttributeIndex = 0) const { return (*Arrays)[AttributeIndex][ElementID]; }
+	void Set(const int ElementID, const int AttributeIndex, const AttributeType& Value) const { (*Arrays)[AttributeIndex][ElementID] = Value; }
+
+	/** The whole array of one index, indexed by element ID. Changing the index count moves these arrays. */
+	ArrayType& GetRawArray(const int AttributeIndex = 0) const { return (*Arrays)[AttributeIndex]; }
+
+	/** New indices get as many default values as the existing ones have elements */
+	void SetNumIndices(const int NumIndices) const
+	{
+		const size_t NumElements = Arrays->empty() ? 0 : (*Arrays)[0].size();
+		Arrays->resize(NumIndices, ArrayType(NumElements, AttributeType()));
+	}
+
+private:
+	template <typename> friend class TMeshAttributesConstRef;
+
+	std::vector<ArrayType>* Arrays;
+};
+
+template <typename AttributeType>
+class TMeshAttributesConstRef
+{
+public:
+	typedef std::vector<AttributeType> ArrayType;
+
+	TMeshAttributesConstRef() : Arrays(nullptr) {}
+	explicit TMeshAttributesConstRef(const std::vector<ArrayType>* InArrays) : Arrays(InArrays) {}
+	TMeshAttributesConstRef(const TMeshAttributesRef<AttributeType>& Other) : Arrays(Other.Arrays) {}
+
+	bool IsValid() const { return Arrays != nullptr; }
+
+	int GetNumIndices() const { return (int)Arrays->size(); }
+	int GetNumElements() const { return Arrays->empty() ? 0 : (int)(*Arrays)[0].size(); }
+
+	typename ArrayType::const_reference operator[](const int ElementID) const { return (*Arrays)[0][ElementID]; }
+
+	typename ArrayType::const_reference Get(const int ElementID, const int AttributeIndex = 0) const { return (*Arrays)[AttributeIndex][ElementID]; }
+
+	const ArrayType& GetRawArray(const int AttributeIndex = 0) const { return (*Arrays)[AttributeIndex]; }
+
+private:
+	const std::vector<ArrayType>* Arrays;
+};
+
 class AttributeSet
 {
 	std::tuple
@@ -305,6 +371,23 @@ public:
 		return Map.at(AttributeName);
 	}
 
+	/** Resolves the attribute once, use the handle instead of the name based accessors inside loops */
+	template <typename AttributeType>
+	TMeshAttributesRef<AttributeType> GetAttributesRef(const std::string& AttributeName)
+	{
+		auto& Map = std::get<TTupleIndex<AttributeType, AttributeTypes>::Value>(Containers);
+		auto It = Map.find(AttributeName);
+		return It != Map.end() ? TMeshAttributesRef<AttributeType>(&It->second) : TMeshAttributesRef<AttributeType>();
+	}
+
+	template <typename AttributeType>
+	TMeshAttributesConstRef<AttributeType> GetAttributesRef(const std::string& AttributeName) const
+	{
+		auto& Map = std::get<TTupleIndex<AttributeType, AttributeTypes>::Value>(Containers);
+		auto It = Map.find(AttributeName);
+		return It != Map.end() ? TMeshAttributesConstRef<AttributeType>(&It->second) : TMeshAttributesConstRef<AttributeType>();
+	}
+
 	template <typename AttributeType>
 	int GetAttributeIndexCount(const std::string& AttributeName) const
 	{
@@ -316,7 +399,12 @@ public:
 	template <typename AttributeType>
 	void SetAttributeIndexCount(const std::string& AttributeName, int NumIndices)
 	{
-
+		const TMeshAttributesRef<AttributeType> Attributes = GetAttributesRef<AttributeType>(AttributeName);
+		assert(Attributes.IsValid() && "SetAttributeIndexCount of an attribute that is not registered");
+		if (Attributes.IsValid())
+		{
+			Attributes.SetNumIndices(NumIndices);
+		}
 	}
 
 	template <typename AttributeType>
@@ -413,7 +501,7 @@ public:
 		{
 			for (std::vector<Vector4>& Attributes : Pair.second)
 			{
-				if (ElementID >= (int)Attributes.size())
+				if (ElementID < (int)Attributes.size())
 				{
 					Attributes[ElementID] = Vector4();
 				}
@@ -423,7 +511,7 @@ public:
 		{
 			for (std::vector<FVector>& Attributes : Pair.second)
 			{
-				if (ElementID >= (int)Attributes.size())
+				if (ElementID < (int)Attributes.size())
 				{
 					Attributes[ElementID] = FVector();
 				}
@@ -433,7 +521,7 @@ public:
 		{
 			for (std::vector<Vector2>& Attributes : Pair.second)
 			{
-				if (ElementID >= (int)Attributes.size())
+				if (ElementID < (int)Attributes.size())
 				{
 					Attributes[ElementID] = Vector2();
 				}
@@ -443,7 +531,7 @@ public:
 		{
 			for (std::vector<float>& Attributes : Pair.second)
 			{
-				if (ElementID >= (int)Attributes.size())
+				if (ElementID < (int)Attributes.size())
 				{
 					Attributes[ElementID] = 0.0f;
 				}
@@ -453,7 +541,7 @@ public:
 		{
 			for (std::vector<int>& Attributes : Pair.second)
 			{
-				if (ElementID >= (int)Attributes.size())
+				if (ElementID < (int)Attributes.size())
 				{
 					Attributes[ElementID] = 0;
 				}
@@ -463,7 +551,7 @@ public:
 		{
 			for (std::vector<bool>& Attributes : Pair.second)
 			{
-				if (ElementID >= (int)Attributes.size())
+				if (ElementID < (int)Attributes.size())
 				{
 					Attributes[ElementID] = false;
 				}
@@ -473,7 +561,7 @@ public:
 		{
 			for (std::vector<std::string>& Attributes : Pair.second)
 			{
-				if (ElementID >= (int)Attributes.size())
+				if (ElementID < (int)Attributes.size())
 				{
 					Attributes[ElementID] = std::string();
 				}
@@ -481,6 +569,18 @@ public:
 		}
 	}
 
+	/** Reserves every attribute array for NumElements elements so creating them one by one never reallocates */
+	void Reserve(const int NumElements)
+	{
+		ReserveAttributeArrays(std::get<0>(Containers), NumElements);
+		ReserveAttributeArrays(std::get<1>(Containers), NumElements);
+		ReserveAttributeArrays(std::get<2>(Containers), NumElements);
+		ReserveAttributeArrays(std::get<3>(Containers), NumElements);
+		ReserveAttributeArrays(std::get<4>(Containers), NumElements);
+		ReserveAttributeArrays(std::get<5>(Containers), NumElements);
+		ReserveAttributeArrays(std::get<6>(Containers), NumElements);
+	}
+
 	void Initialize(const int NumElements)
 	{
 		for (auto& Pair : std::get<0>(Containers))
@@ -533,7 +633,44 @@ public:
 			}
 		}
 
-		Insert(NumElements - 1);
+		Insert(NumElements - 1);
+	}
+
+	/** Registers every attribute of Other this set does not have yet, with as many indices but no elements */
+	void RegisterAttributesOf(const AttributeSet& Other)
+	{
+		RegisterAttributeArrays(std::get<0>(Containers), std::get<0>(Other.Containers));
+		RegisterAttributeArrays(std::get<1>(Containers), std::get<1>(Other.Containers));
+		RegisterAttributeArrays(std::get<2>(Containers), std::get<2>(Other.Containers));
+		RegisterAttributeArrays(std::get<3>(Containers), std::get<3>(Other.Containers));
+		RegisterAttributeArrays(std::get<4>(Containers), std::get<4>(Other.Containers));
+		RegisterAttributeArrays(std::get<5>(Containers), std::get<5>(Other.Containers));
+		RegisterAttributeArrays(std::get<6>(Containers), std::get<6>(Other.Containers));
+	}
+
+private:
+	template <typename AttributeType>
+	static void RegisterAttributeArrays(std::map<std::string, std::vector<std::vector<AttributeType>>>& Map, const std::map<std::string, std::vector<std::vector<AttributeType>>>& OtherMap)
+	{
+		for (const auto& Pair : OtherMap)
+		{
+			if (Map.find(Pair.first) == Map.end())
+			{
+				Map.emplace(Pair.first, std::vector<std::vector<AttributeType>>(Pair.second.size()));
+			}
+		}
+	}
+
+	template <typename AttributeType>
+	static void ReserveAttributeArrays(std::map<std::string, std::vector<std::vector<AttributeType>>>& Map, const int NumElements)
+	{
+		for (auto& Pair : Map)
+		{
+			for (std::vector<AttributeType>& Attributes : Pair.second)
+			{
+				Attributes.reserve(NumElements);
+			}
+		}
 	}
 };
 
@@ -586,6 +723,41 @@ public:
 	AttributeSet& PolygonGroupAttributes() { return PolygonGroupAttributesSet; }
 	const AttributeSet& PolygonGroupAttributes() const { return PolygonGroupAttributesSet; }
 
+	/** Registers every attribute Other has, on the same kind of element and with as many indices, without copying any elements */
+	void RegisterAttributesOf(const MeshDescription& Other)
+	{
+		VertexAttributesSet.RegisterAttributesOf(Other.VertexAttributesSet);
+		VertexInstanceAttributesSet.RegisterAttributesOf(Other.VertexInstanceAttributesSet);
+		EdgeAttributesSet.RegisterAttributesOf(Other.EdgeAttributesSet);
+		PolygonAttributesSet.RegisterAttributesOf(Other.PolygonAttributesSet);
+		PolygonGroupAttributesSet.RegisterAttributesOf(Other.PolygonGroupAttributesSet);
+	}
+
+	/** Reserve room for this many more elements of a kind, and for their attributes, before creating them one by one */
+	void ReserveNewVertices(const int NumVertices)
+	{
+		VertexArray.Reserve(NumVertices);
+		VertexAttributesSet.Reserve(VertexArray.GetArraySize() + NumVertices);
+	}
+
+	void ReserveNewVertexInstances(const int NumVertexInstances)
+	{
+		VertexInstanceArray.Reserve(NumVertexInstances);
+		VertexInstanceAttributesSet.Reserve(VertexInstanceArray.GetArraySize() + NumVertexInstances);
+	}
+
+	void ReserveNewEdges(const int NumEdges)
+	{
+		EdgeArray.Reserve(NumEdges);
+		EdgeAttributesSet.Reserve(EdgeArray.GetArraySize() + NumEdges);
+	}
+
+	void ReserveNewPolygons(const int NumPolygons)
+	{
+		PolygonArray.Reserve(NumPolygons);
+		PolygonAttributesSet.Reserve(PolygonArray.GetArraySize() + NumPolygons);
+	}
+
 	const std::set<int32>& GetVertexConnectedEdges(const int32 VertexID) const
 	{
 		return VertexArray[VertexID].ConnectedEdgeIDs;
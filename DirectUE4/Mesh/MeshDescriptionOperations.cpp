@@ -5,6 +5,7 @@
 #include "mikktspace.h"
 #include "LayoutUV.h"
 #include "Allocator2D.h"
+#include "ParallelFor.h"
 
 #include <vector>
 #include <algorithm>
@@ -13,27 +14,44 @@
 /** Helper struct for building acceleration structures. */
 namespace MeshDescriptionOperationNamespace
 {
-	struct FIndexAndZ
+	/** Grid cell of a vertex instance position, sorting by cell puts each column of cells (same X and Y) in one run. */
+	struct FGridCorner
 	{
-		float Z;
+		int32 CellX;
+		int32 CellY;
+		int32 CellZ;
 		int32 Index;
-		const FVector *OriginalVector;
+		const FVector* Position;
 
-		/** Default constructor. */
-		FIndexAndZ() {}
-
-		/** Initialization constructor. */
-		FIndexAndZ(int32 InIndex, const FVector& V)
+		FGridCorner() {}
+		FGridCorner(int32 InIndex, const FVector& V, float InvCellSize)
 		{
-			Z = 0.30f * V.X + 0.33f * V.Y + 0.37f * V.Z;
+			// clamp so far away positions can't overflow, they only end up sharing cells
+			CellX = FMath::FloorToInt(FMath::Clamp(V.X * InvCellSize, -1.0e9f, 1.0e9f));
+			CellY = FMath::FloorToInt(FMath::Clamp(V.Y * InvCellSize, -1.0e9f, 1.0e9f));
+			CellZ = FMath::FloorToInt(FMath::Clamp(V.Z * InvCellSize, -1.0e9f, 1.0e9f));
 			Index = InIndex;
-			OriginalVector = &V;
+			Position = &V;
 		}
 	};
-	/** Sorting function for vertex Z/index pairs. */
-	struct FCompareIndexAndZ
+
+	inline bool CellLess(int32 AX, int32 AY, int32 AZ, int32 BX, int32 BY, int32 BZ)
+	{
+		if (AX != BX) return AX < BX;
+		if (AY != BY) return AY < BY;
+		return AZ < BZ;
+	}
+
+	struct FCompareGridCorner
 	{
-		inline bool operator()(FIndexAndZ const& A, FIndexAndZ const& B) const { return A.Z < B.Z; }
+		inline bool operator()(FGridCorner const& A, FGridCorner const& B) const
+		{
+			if (A.CellX != B.CellX || A.CellY != B.CellY || A.CellZ != B.CellZ)
+			{
+				return CellLess(A.CellX, A.CellY, A.CellZ, B.CellX, B.CellY, B.CellZ);
+			}
+			return A.Index < B.Index;
+		}
 	};
 }
 struct FVertexInfo
@@ -52,26 +70,31 @@ struct FVertexInfo
 	std::vector<int32> EdgeIDs;
 };
 
+bool GParallelMeshBuild = true;
+bool GFastLightmapUVPacking = true;
+
 void MeshDescriptionOperations::CreatePolygonNTB(MeshDescription& MD, float ComparisonThreshold)
 {
-	const std::vector<FVector>& VertexPositions = MD.VertexAttributes().GetAttributes<FVector>(MeshAttribute::Vertex::Position);
-	std::vector<Vector2>& VertexUVs = MD.VertexInstanceAttributes().GetAttributes<Vector2>(MeshAttribute::VertexInstance::TextureCoordinate, 0);
-	std::vector<FVector>& PolygonNormals = MD.PolygonAttributes().GetAttributes<FVector>(MeshAttribute::Polygon::Normal);
-	std::vector<FVector>& PolygonTangents = MD.PolygonAttributes().GetAttributes<FVector>(MeshAttribute::Polygon::Tangent);
-	std::vector<FVector>& PolygonBinormals = MD.PolygonAttributes().GetAttributes<FVector>(MeshAttribute::Polygon::Binormal);
+	// only const lookups from here on, the element containers are hash maps and must not be touched by concurrent operator[]
+	const MeshDescription& ConstMD = MD;
+	// no element is created while the NTBs are built, so the attribute arrays can be indexed directly
+	const std::vector<FVector>& VertexPositions = MD.VertexAttributes().GetAttributesRef<FVector>(MeshAttribute::Vertex::Position).GetRawArray();
+	const std::vector<Vector2>& VertexUVs = MD.VertexInstanceAttributes().GetAttributesRef<Vector2>(MeshAttribute::VertexInstance::TextureCoordinate).GetRawArray();
+	std::vector<FVector>& PolygonNormals = MD.PolygonAttributes().GetAttributesRef<FVector>(MeshAttribute::Polygon::Normal).GetRawArray();
+	std::vector<FVector>& PolygonTangents = MD.PolygonAttributes().GetAttributesRef<FVector>(MeshAttribute::Polygon::Tangent).GetRawArray();
+	std::vector<FVector>& PolygonBinormals = MD.PolygonAttributes().GetAttributesRef<FVector>(MeshAttribute::Polygon::Binormal).GetRawArray();
 
-	TMeshElementArray<MeshVertexInstance>& VertexInstanceArray = MD.VertexInstances();
-	TMeshElementArray<MeshVertex>& VertexArray = MD.Vertices();
-	TMeshElementArray<MeshPolygon>& PolygonArray = MD.Polygons();
-
-	for (const int PolygonID : MD.Polygons().GetElementIDs())
+	// every polygon only writes its own NTB
+	const std::vector<int> PolygonIDs = MD.Polygons().GetElementIDs();
+	ParallelFor((int)PolygonIDs.size(), [&](int PolygonIndex)
 	{
+		const int PolygonID = PolygonIDs[PolygonIndex];
 		if (!PolygonNormals[PolygonID].IsNearlyZero())
 		{
-			continue;
+			return;
 		}
 
-		const std::vector<MeshTriangle> MeshTriangles = MD.GetPolygonTriangles(PolygonID);
+		const std::vector<MeshTriangle>& MeshTriangles = ConstMD.GetPolygonTriangles(PolygonID);
 		FVector TangentX(0.0f);
 		FVector TangentY(0.0f);
 		FVector TangentZ(0.0f);
@@ -87,7 +110,7 @@ void MeshDescriptionOperations::CreatePolygonNTB(MeshDescription& MD, float Comp
 			{
 				const int VertexInstanceID = MT.GetVertexInstanceID(i);
 				UVs[i] = VertexUVs[VertexInstanceID];
-				P[i] = VertexPositions[MD.GetVertexInstanceVertex(VertexInstanceID)];
+				P[i] = VertexPositions[ConstMD.GetVertexInstanceVertex(VertexInstanceID)];
 			}
 
 			const FVector Normal = ((P[1] - P[2]) ^ (P[0] - P[2])).GetSafeNormal(ComparisonThreshold);
@@ -132,13 +155,30 @@ void MeshDescriptionOperations::CreatePolygonNTB(MeshDescription& MD, float Comp
 			TangentX.Normalize();
 			TangentY.Normalize();
 			TangentZ.Normalize();
-			PolygonTangents[PolygonID] = TangentX;
-			PolygonBinormals[PolygonID] = TangentY;
+			PolygonTangents[PolygonID] = TangentX;
+			PolygonBinormals[PolygonID] = TangentY;
 			PolygonNormals[PolygonID] = TangentZ;
 		}
-	}
+	}, !GParallelMeshBuild);
 }
 
+void MeshDescriptionOperations::ComputePolygonTriangulations(MeshDescription& MD)
+{
+	// resolve the polygons up front, operator[] of the element hash map must not run concurrently
+	const std::vector<int> PolygonIDs = MD.Polygons().GetElementIDs();
+	std::vector<MeshPolygon*> Polygons;
+	Polygons.reserve(PolygonIDs.size());
+	for (const int PolygonID : PolygonIDs)
+	{
+		Polygons.push_back(&MD.GetPolygon(PolygonID));
+	}
+
+	ParallelFor((int)PolygonIDs.size(), [&](int PolygonIndex)
+	{
+		MD.ComputePolygonTriangulation(PolygonIDs[PolygonIndex], Polygons[PolygonIndex]->Triangles);
+	}, !GParallelMeshBuild);
+}
+
 void MeshDescriptionOperations::CreateNormals(MeshDescription& MD, ETangentOptions TangentOptions, bool bComputeTangent)
 {
 	//For each vertex compute the normals for every connected edges that are smooth betwween hard edges
@@ -159,26 +199,34 @@ void MeshDescriptionOperations::CreateNormals(MeshDescription& MD, ETangentOptio
 // the angle it makes with the vertex being calculated. This means that triangulated faces whose
 // internal edge meets the vertex doesn't get undue extra weight.
 
-	const std::vector<Vector2>& VertexUVs = MD.VertexInstanceAttributes().GetAttributes<Vector2>(MeshAttribute::VertexInstance::TextureCoordinate, 0);
-	std::vector<FVector>& VertexNormals = MD.VertexInstanceAttributes().GetAttributes<FVector>(MeshAttribute::VertexInstance::Normal, 0);
-	std::vector<FVector>& VertexTangents = MD.VertexInstanceAttributes().GetAttributes<FVector>(MeshAttribute::VertexInstance::Tangent, 0);
-	std::vector<float>& VertexBinormalSigns = MD.VertexInstanceAttributes().GetAttributes<float>(MeshAttribute::VertexInstance::BinormalSign, 0);
+	// no element is created while the normals are built, so the attribute arrays can be indexed directly
+	const std::vector<Vector2>& VertexUVs = MD.VertexInstanceAttributes().GetAttributesRef<Vector2>(MeshAttribute::VertexInstance::TextureCoordinate).GetRawArray();
+	std::vector<FVector>& VertexNormals = MD.VertexInstanceAttributes().GetAttributesRef<FVector>(MeshAttribute::VertexInstance::Normal).GetRawArray();
+	std::vector<FVector>& VertexTangents = MD.VertexInstanceAttributes().GetAttributesRef<FVector>(MeshAttribute::VertexInstance::Tangent).GetRawArray();
+	std::vector<float>& VertexBinormalSigns = MD.VertexInstanceAttributes().GetAttributesRef<float>(MeshAttribute::VertexInstance::BinormalSign).GetRawArray();
+
+	std::vector<FVector>& PolygonNormals = MD.PolygonAttributes().GetAttributesRef<FVector>(MeshAttribute::Polygon::Normal).GetRawArray();
+	std::vector<FVector>& PolygonTangents = MD.PolygonAttributes().GetAttributesRef<FVector>(MeshAttribute::Polygon::Tangent).GetRawArray();
+	std::vector<FVector>& PolygonBinormals = MD.PolygonAttributes().GetAttributesRef<FVector>(MeshAttribute::Polygon::Binormal).GetRawArray();
 
-	std::vector<FVector>& PolygonNormals = MD.PolygonAttributes().GetAttributes<FVector>(MeshAttribute::Polygon::Normal);
-	std::vector<FVector>& PolygonTangents = MD.PolygonAttributes().GetAttributes<FVector>(MeshAttribute::Polygon::Tangent);
-	std::vector<FVector>& PolygonBinormals = MD.PolygonAttributes().GetAttributes<FVector>(MeshAttribute::Polygon::Binormal);
+	const std::vector<bool>& EdgeHardnesses = MD.EdgeAttributes().GetAttributesRef<bool>(MeshAttribute::Edge::IsHard).GetRawArray();
+
+	// A vertex only writes the NTB of its own vertex instances, so vertices are independent. Only const lookups in the
+	// body, the element containers are hash maps and must not be touched by concurrent operator[].
+	const MeshDescription& ConstMD = MD;
+	const std::vector<int32> VertexIDs = MD.Vertices().GetElementIDs();
 
-	std::map<int32, FVertexInfo> VertexInfoMap;
 	//Iterate all vertex to compute normals for all vertex instance
-	for (const int32 VertexID : MD.Vertices().GetElementIDs())
+	ParallelFor((int32)VertexIDs.size(), [&](int32 VertexIndex)
 	{
-		VertexInfoMap.clear();
+		const int32 VertexID = VertexIDs[VertexIndex];
+		std::map<int32, FVertexInfo> VertexInfoMap;
 
 		bool bPointHasAllTangents = true;
 		//Fill the VertexInfoMap
-		for (const int32 EdgeID : MD.GetVertexConnectedEdges(VertexID))
+		for (const int32 EdgeID : ConstMD.GetVertexConnectedEdges(VertexID))
 		{
-			for (const int32 PolygonID : MD.GetEdgeConnectedPolygons(EdgeID))
+			for (const int32 PolygonID : ConstMD.GetEdgeConnectedPolygons(EdgeID))
 			{
 				FVertexInfo& VertexInfo = VertexInfoMap[PolygonID];
 				int32 EdgeIndex = VertexInfo.EdgeIDs.size();
@@ -186,9 +234,9 @@ void MeshDescriptionOperations::CreateNormals(MeshDescription& MD, ETangentOptio
 				if (VertexInfo.PolygonID == -1)
 				{
 					VertexInfo.PolygonID = PolygonID;
-					for (const int32 VertexInstanceID : MD.GetPolygonPerimeterVertexInstances(PolygonID))
+					for (const int32 VertexInstanceID : ConstMD.GetPolygonPerimeterVertexInstances(PolygonID))
 					{
-						if (MD.GetVertexInstanceVertex(VertexInstanceID) == VertexID)
+						if (ConstMD.GetVertexInstanceVertex(VertexInstanceID) == VertexID)
 						{
 							VertexInfo.VertexInstanceID = VertexInstanceID;
 							VertexInfo.UVs = VertexUVs[VertexInstanceID];
@@ -214,7 +262,7 @@ void MeshDescriptionOperations::CreateNormals(MeshDescription& MD, ETangentOptio
 
 		if (bPointHasAllTangents)
 		{
-			continue;
+			return;
 		}
 
 		//Build all group by recursively traverse all polygon connected to the vertex
@@ -239,7 +287,6 @@ void MeshDescriptionOperations::CreateNormals(MeshDescription& MD, ETangentOptio
 				FVertexInfo& CurrentVertexInfo = VertexInfoMap[CurrentPolygonID];
 				AddUnique(CurrentGroup, CurrentVertexInfo.PolygonID);
 				AddUnique(ConsumedPolygon,CurrentVertexInfo.PolygonID);
-				const std::vector<bool>& EdgeHardnesses = MD.EdgeAttributes().GetAttributes<bool>(MeshAttribute::Edge::IsHard);
 				for (const int32 EdgeID : CurrentVertexInfo.EdgeIDs)
 				{
 					if (EdgeHardnesses[EdgeID])
@@ -247,7 +294,7 @@ void MeshDescriptionOperations::CreateNormals(MeshDescription& MD, ETangentOptio
 						//End of the group
 						continue;
 					}
-					for (const int32 PolygonID : MD.GetEdgeConnectedPolygons(EdgeID))
+					for (const int32 PolygonID : ConstMD.GetEdgeConnectedPolygons(EdgeID))
 					{
 						if (PolygonID == CurrentVertexInfo.PolygonID)
 						{
@@ -370,11 +417,39 @@ void MeshDescriptionOperations::CreateNormals(MeshDescription& MD, ETangentOptio
 				}
 			}
 		}
-	}
+	}, !GParallelMeshBuild);
 }
 
 namespace MeshDescriptionMikktSpaceInterface
 {
+	/**
+	* Everything the MikkTSpace callbacks touch, resolved once instead of looking attributes up by name on every call.
+	* Shared by all contexts of one mesh, each context sees only its own polygons (FMikkTSpaceFaces).
+	*/
+	struct FMikkTSpaceMeshData
+	{
+		std::vector<const std::vector<int>*> PolygonPerimeters;
+		std::vector<int32> VertexInstanceVertices;
+		const FVector* VertexPositions;
+		const FVector* VertexInstanceNormals;
+		const Vector2* VertexInstanceUVs;
+		FVector* VertexInstanceTangents;
+		float* VertexInstanceBinormalSigns;
+	};
+
+	/** User data of one MikkTSpace context, face i is polygon PolygonIDs[i] */
+	struct FMikkTSpaceFaces
+	{
+		const FMikkTSpaceMeshData* MeshData;
+		const int32* PolygonIDs;
+		int32 NumFaces;
+
+		int32 GetVertexInstanceID(const int FaceIdx, const int VertIdx) const
+		{
+			return (*MeshData->PolygonPerimeters[PolygonIDs[FaceIdx]])[VertIdx];
+		}
+	};
+
 	//Mikk t spce static function
 	int MikkGetNumFaces(const SMikkTSpaceContext* Context);
 	int MikkGetNumVertsOfFace(const SMikkTSpaceContext* Context, const int FaceIdx);
@@ -382,12 +457,103 @@ namespace MeshDescriptionMikktSpaceInterface
 	void MikkGetNormal(const SMikkTSpaceContext* Context, float Normal[3], const int FaceIdx, const int VertIdx);
 	void MikkSetTSpaceBasic(const SMikkTSpaceContext* Context, const float Tangent[3], const float BitangentSign, const int FaceIdx, const int VertIdx);
 	void MikkGetTexCoord(const SMikkTSpaceContext* Context, float UV[2], const int FaceIdx, const int VertIdx);
+
+	/**
+	* MikkTSpace only shares data between corners at exactly the same position, so polygons that are not connected through
+	* such a corner get the same tangents whether they are processed together or apart. Splits the polygons into batches
+	* of whole components of at least MinBatchSize polygons, keeping the polygon order within every component.
+	*/
+	void SplitIntoIndependentBatches(const FMikkTSpaceMeshData& MeshData, const std::vector<int32>& PolygonIDs, int32 MinBatchSize, std::vector<std::vector<int32>>& OutBatches)
+	{
+		const int32 NumPolygons = (int32)PolygonIDs.size();
+
+		struct FCornerKey
+		{
+			uint32 Bits[3];
+			int32 PolygonIndex;
+		};
+		std::vector<FCornerKey> Corners;
+		for (int32 PolygonIndex = 0; PolygonIndex < NumPolygons; ++PolygonIndex)
+		{
+			for (const int VertexInstanceID : *MeshData.PolygonPerimeters[PolygonIDs[PolygonIndex]])
+			{
+				FVector Position = MeshData.VertexPositions[MeshData.VertexInstanceVertices[VertexInstanceID]];
+				// MikkTSpace compares with ==, so -0 and +0 are the same position
+				Position.X = Position.X == 0.f ? 0.f : Position.X;
+				Position.Y = Position.Y == 0.f ? 0.f : Position.Y;
+				Position.Z = Position.Z == 0.f ? 0.f : Position.Z;
+
+				FCornerKey Key;
+				memcpy(Key.Bits, &Position.X, sizeof(Key.Bits));
+				Key.PolygonIndex = PolygonIndex;
+				Corners.push_back(Key);
+			}
+		}
+		std::sort(Corners.begin(), Corners.end(), [](const FCornerKey& A, const FCornerKey& B)
+		{
+			return memcmp(A.Bits, B.Bits, sizeof(A.Bits)) < 0;
+		});
+
+		// union find, the root of a component is its smallest polygon index
+		std::vector<int32> Parents(NumPolygons);
+		for (int32 PolygonIndex = 0; PolygonIndex < NumPolygons; ++PolygonIndex)
+		{
+			Parents[PolygonIndex] = PolygonIndex;
+		}
+		auto FindRoot = [&Parents](int32 Index)
+		{
+			while (Parents[Index] != Index)
+			{
+				Parents[Index] = Parents[Parents[Index]];
+				Index = Parents[Index];
+			}
+			return Index;
+		};
+		for (size_t i = 1; i < Corners.size(); ++i)
+		{
+			if (memcmp(Corners[i - 1].Bits, Corners[i].Bits, sizeof(Corners[i].Bits)) == 0)
+			{
+				const int32 RootA = FindRoot(Corners[i - 1].PolygonIndex);
+				const int32 RootB = FindRoot(Corners[i].PolygonIndex);
+				if (RootA != RootB)
+				{
+					Parents[FMath::Max(RootA, RootB)] = FMath::Min(RootA, RootB);
+				}
+			}
+		}
+
+		// components in the order of their first polygon
+		std::vector<int32> RootComponents(NumPolygons, INDEX_NONE);
+		std::vector<std::vector<int32>> Components;
+		for (int32 PolygonIndex = 0; PolygonIndex < NumPolygons; ++PolygonIndex)
+		{
+			const int32 Root = FindRoot(PolygonIndex);
+			if (RootComponents[Root] == INDEX_NONE)
+			{
+				RootComponents[Root] = (int32)Components.size();
+				Components.push_back(std::vector<int32>());
+			}
+			Components[RootComponents[Root]].push_back(PolygonIDs[PolygonIndex]);
+		}
+
+		OutBatches.clear();
+		for (const std::vector<int32>& Component : Components)
+		{
+			if (OutBatches.empty() || (int32)OutBatches.back().size() >= MinBatchSize)
+			{
+				OutBatches.push_back(std::vector<int32>());
+			}
+			OutBatches.back().insert(OutBatches.back().end(), Component.begin(), Component.end());
+		}
+	}
 }
-
-
-void MeshDescriptionOperations::CreateMikktTangents(MeshDescription& MD, ETangentOptions TangentOptions)
-{
-	bool bIgnoreDegenerateTriangles = (TangentOptions & MeshDescriptionOperations::ETangentOptions::IgnoreDegenerateTriangles) != 0;
+
+
+void MeshDescriptionOperations::CreateMikktTangents(MeshDescription& MD, ETangentOptions TangentOptions)
+{
+	using namespace MeshDescriptionMikktSpaceInterface;
+
+	bool bIgnoreDegenerateTriangles = (TangentOptions & MeshDescriptionOperations::ETangentOptions::IgnoreDegenerateTriangles) != 0;
 	SMikkTSpaceInterface MikkTInterface;
 	MikkTInterface.m_getNormal = MeshDescriptionMikktSpaceInterface::MikkGetNormal;
 	MikkTInterface.m_getNumFaces = MeshDescriptionMikktSpaceInterface::MikkGetNumFaces;
@@ -395,85 +561,192 @@ void MeshDescriptionOperations::CreateMikktTangents(MeshDescription& MD, ETangen
 	MikkTInterface.m_getPosition = MeshDescriptionMikktSpaceInterface::MikkGetPosition;
 	MikkTInterface.m_getTexCoord = MeshDescriptionMikktSpaceInterface::MikkGetTexCoord;
 	MikkTInterface.m_setTSpaceBasic = MeshDescriptionMikktSpaceInterface::MikkSetTSpaceBasic;
-	MikkTInterface.m_setTSpace = nullptr;
-
-	SMikkTSpaceContext MikkTContext;
-	MikkTContext.m_pInterface = &MikkTInterface;
-	MikkTContext.m_pUserData = (void*)(&MD);
-	MikkTContext.m_bIgnoreDegenerates = bIgnoreDegenerateTriangles;
-	genTangSpaceDefault(&MikkTContext);
-}
-
-void MeshDescriptionOperations::FindOverlappingCorners(std::multimap<int, int>& OverlappingCorners, const MeshDescription& MD, float ComparisonThreshold)
+	MikkTInterface.m_setTSpace = nullptr;
+
+	const MeshDescription& ConstMD = MD;
+	const std::vector<int32> PolygonIDs = MD.Polygons().GetElementIDs();
+
+	FMikkTSpaceMeshData MeshData;
+	MeshData.PolygonPerimeters.resize(MD.Polygons().GetArraySize(), nullptr);
+	for (const int32 PolygonID : PolygonIDs)
+	{
+		MeshData.PolygonPerimeters[PolygonID] = &ConstMD.GetPolygonPerimeterVertexInstances(PolygonID);
+	}
+	MeshData.VertexInstanceVertices.resize(MD.VertexInstances().GetArraySize(), INDEX_NONE);
+	for (const int32 VertexInstanceID : MD.VertexInstances().GetElementIDs())
+	{
+		MeshData.VertexInstanceVertices[VertexInstanceID] = ConstMD.GetVertexInstanceVertex(VertexInstanceID);
+	}
+	MeshData.VertexPositions = MD.VertexAttributes().GetAttributesRef<FVector>(MeshAttribute::Vertex::Position).GetRawArray().data();
+	MeshData.VertexInstanceNormals = MD.VertexInstanceAttributes().GetAttributesRef<FVector>(MeshAttribute::VertexInstance::Normal).GetRawArray().data();
+	MeshData.VertexInstanceUVs = MD.VertexInstanceAttributes().GetAttributesRef<Vector2>(MeshAttribute::VertexInstance::TextureCoordinate).GetRawArray().data();
+	MeshData.VertexInstanceTangents = MD.VertexInstanceAttributes().GetAttributesRef<FVector>(MeshAttribute::VertexInstance::Tangent).GetRawArray().data();
+	MeshData.VertexInstanceBinormalSigns = MD.VertexInstanceAttributes().GetAttributesRef<float>(MeshAttribute::VertexInstance::BinormalSign).GetRawArray().data();
+
+	std::vector<std::vector<int32>> Batches;
+	if (GParallelMeshBuild)
+	{
+		SplitIntoIndependentBatches(MeshData, PolygonIDs, 4096, Batches);
+	}
+	else
+	{
+		Batches.push_back(PolygonIDs);
+	}
+
+	ParallelFor((int32)Batches.size(), [&](int32 BatchIndex)
+	{
+		FMikkTSpaceFaces Faces;
+		Faces.MeshData = &MeshData;
+		Faces.PolygonIDs = Batches[BatchIndex].data();
+		Faces.NumFaces = (int32)Batches[BatchIndex].size();
+
+		SMikkTSpaceContext MikkTContext;
+		MikkTContext.m_pInterface = &MikkTInterface;
+		MikkTContext.m_pUserData = (void*)(&Faces);
+		MikkTContext.m_bIgnoreDegenerates = bIgnoreDegenerateTriangles;
+		genTangSpaceDefault(&MikkTContext);
+	}, !GParallelMeshBuild);
+}
+
+void MeshDescriptionOperations::FindOverlappingCorners(FOverlappingCornerAdjacency& OverlappingCorners, const MeshDescription& MD, float ComparisonThreshold)
 {
+	using namespace MeshDescriptionOperationNamespace;
+
 	//Empty the old data
-	OverlappingCorners.clear();
+	OverlappingCorners.Reset();
 
 	const TMeshElementArray<MeshVertexInstance>& VertexInstanceArray = MD.VertexInstances();
-	const TMeshElementArray<MeshVertex>& VertexArray = MD.Vertices();
 
 	const int32 NumWedges = VertexInstanceArray.Num();
+	const int32 NumCornerSlots = VertexInstanceArray.GetArraySize();
 
-	// Create a list of vertex Z/index pairs
-	std::vector<MeshDescriptionOperationNamespace::FIndexAndZ> VertIndexAndZ;
-	VertIndexAndZ.reserve(NumWedges);
+	TMeshAttributesConstRef<FVector> VertexPositions = MD.VertexAttributes().GetAttributesRef<FVector>(MeshAttribute::Vertex::Position);
 
-	const std::vector<FVector>& VertexPositions = MD.VertexAttributes().GetAttributes<FVector>(MeshAttribute::Vertex::Position);
+	// Cells twice the threshold wide keep float rounding from splitting an overlapping pair more than one cell apart,
+	// so every pair is found comparing a cell with itself and its direct neighbours.
+	const float CellSize = FMath::Max(ComparisonThreshold * 2.f, KINDA_SMALL_NUMBER);
+	const float InvCellSize = 1.f / CellSize;
 
+	std::vector<FGridCorner> Corners;
+	Corners.reserve(NumWedges);
 	for (const int VertexInstanceID : VertexInstanceArray.GetElementIDs())
 	{
-		VertIndexAndZ.push_back(MeshDescriptionOperationNamespace::FIndexAndZ(VertexInstanceID, VertexPositions[MD.GetVertexInstanceVertex(VertexInstanceID)]));
-		//new(VertIndexAndZ)MeshDescriptionOperationNamespace::FIndexAndZ(VertexInstanceID, VertexPositions[MD.GetVertexInstanceVertex(VertexInstanceID)]);
+		Corners.push_back(FGridCorner(VertexInstanceID, VertexPositions[MD.GetVertexInstanceVertex(VertexInstanceID)], InvCellSize));
 	}
+	std::sort(Corners.begin(), Corners.end(), FCompareGridCorner());
 
-	// Sort the vertices by z value
-	std::sort(VertIndexAndZ.begin(), VertIndexAndZ.end(), MeshDescriptionOperationNamespace::FCompareIndexAndZ());
-	//VertIndexAndZ.Sort(MeshDescriptionOperationNamespace::FCompareIndexAndZ());
+	// First corner of every occupied cell, plus an end marker
+	std::vector<int32> CellStarts;
+	for (int32 i = 0; i < (int32)Corners.size(); ++i)
+	{
+		if (i == 0 || Corners[i].CellX != Corners[i - 1].CellX || Corners[i].CellY != Corners[i - 1].CellY || Corners[i].CellZ != Corners[i - 1].CellZ)
+		{
+			CellStarts.push_back(i);
+		}
+	}
+	const int32 NumCells = (int32)CellStarts.size();
+	CellStarts.push_back((int32)Corners.size());
 
-	// Search for duplicates, quickly!
-	for (size_t i = 0; i < VertIndexAndZ.size(); i++)
+	// Every pair is found once, from the cell that comes first in sort order
+	std::vector<std::pair<int32, int32>> Pairs;
+	auto TestCells = [&](int32 CellA, int32 CellB)
 	{
-		// only need to search forward, since we add pairs both ways
-		for (size_t j = i + 1; j < VertIndexAndZ.size(); j++)
+		for (int32 i = CellStarts[CellA]; i < CellStarts[CellA + 1]; ++i)
 		{
-			if (FMath::Abs(VertIndexAndZ[j].Z - VertIndexAndZ[i].Z) > ComparisonThreshold)
-				break; // can't be any more dups
+			const int32 FirstJ = CellA == CellB ? i + 1 : CellStarts[CellB];
+			for (int32 j = FirstJ; j < CellStarts[CellB + 1]; ++j)
+			{
+				if (Corners[i].Position->Equals(*Corners[j].Position, ComparisonThreshold))
+				{
+					Pairs.push_back(std::make_pair(Corners[i].Index, Corners[j].Index));
+				}
+			}
+		}
+	};
 
-			const FVector& PositionA = *(VertIndexAndZ[i].OriginalVector);
-			const FVector& PositionB = *(VertIndexAndZ[j].OriginalVector);
+	// Neighbouring columns that come after a column in sort order, each is searched from Z - 1 to Z + 1
+	const int32 ForwardColumns[4][2] = { { 0, 1 }, { 1, -1 }, { 1, 0 }, { 1, 1 } };
+	for (int32 Cell = 0; Cell < NumCells; ++Cell)
+	{
+		const FGridCorner& C = Corners[CellStarts[Cell]];
 
-			if (PositionA.Equals(PositionB, ComparisonThreshold))
+		TestCells(Cell, Cell);
+		if (Cell + 1 < NumCells)
+		{
+			const FGridCorner& Next = Corners[CellStarts[Cell + 1]];
+			if (Next.CellX == C.CellX && Next.CellY == C.CellY && Next.CellZ == C.CellZ + 1)
 			{
-				OverlappingCorners.insert(std::make_pair(VertIndexAndZ[i].Index, VertIndexAndZ[j].Index));
-				OverlappingCorners.insert(std::make_pair(VertIndexAndZ[j].Index, VertIndexAndZ[i].Index));
+				TestCells(Cell, Cell + 1);
 			}
 		}
-	}
+
+		for (const int32* Column : ForwardColumns)
+		{
+			const int32 X = C.CellX + Column[0];
+			const int32 Y = C.CellY + Column[1];
+			// binary search for the first cell at or after (X, Y, Z - 1), all candidates follow it
+			auto It = std::lower_bound(CellStarts.begin() + Cell + 1, CellStarts.begin() + NumCells, 0, [&](int32 Start, int32)
+			{
+				const FGridCorner& S = Corners[Start];
+				return CellLess(S.CellX, S.CellY, S.CellZ, X, Y, C.CellZ - 1);
+			});
+			for (int32 Other = (int32)(It - CellStarts.begin()); Other < NumCells; ++Other)
+			{
+				const FGridCorner& O = Corners[CellStarts[Other]];
+				if (O.CellX != X || O.CellY != Y || O.CellZ > C.CellZ + 1)
+				{
+					break;
+				}
+				TestCells(Cell, Other);
+			}
+		}
+	}
+
+	// Counting sort of both directions of every pair into the flat lists
+	OverlappingCorners.Offsets.assign(NumCornerSlots + 1, 0);
+	for (const std::pair<int32, int32>& Pair : Pairs)
+	{
+		++OverlappingCorners.Offsets[Pair.first + 1];
+		++OverlappingCorners.Offsets[Pair.second + 1];
+	}
+	for (int32 i = 0; i < NumCornerSlots; ++i)
+	{
+		OverlappingCorners.Offsets[i + 1] += OverlappingCorners.Offsets[i];
+	}
+	OverlappingCorners.Indices.resize(Pairs.size() * 2);
+	std::vector<int32> WritePos(OverlappingCorners.Offsets.begin(), OverlappingCorners.Offsets.end() - 1);
+	for (const std::pair<int32, int32>& Pair : Pairs)
+	{
+		OverlappingCorners.Indices[WritePos[Pair.first]++] = Pair.second;
+		OverlappingCorners.Indices[WritePos[Pair.second]++] = Pair.first;
+	}
+	for (int32 i = 0; i < NumCornerSlots; ++i)
+	{
+		std::sort(OverlappingCorners.Indices.begin() + OverlappingCorners.Offsets[i], OverlappingCorners.Indices.begin() + OverlappingCorners.Offsets[i + 1]);
+	}
 }
 
 namespace MeshDescriptionMikktSpaceInterface
 {
 	int MikkGetNumFaces(const SMikkTSpaceContext* Context)
 	{
-		MeshDescription* MD = (MeshDescription*)(Context->m_pUserData);
-		return MD->Polygons().Num();
+		const FMikkTSpaceFaces* Faces = (const FMikkTSpaceFaces*)(Context->m_pUserData);
+		return Faces->NumFaces;
 	}
 
 	int MikkGetNumVertsOfFace(const SMikkTSpaceContext* Context, const int FaceIdx)
 	{
 		// All of our meshes are triangles.
-		MeshDescription* MD = (MeshDescription*)(Context->m_pUserData);
-		const MeshPolygon& Polygon = MD->GetPolygon(FaceIdx);
-		return Polygon.PerimeterContour.VertexInstanceIDs.size();
+		const FMikkTSpaceFaces* Faces = (const FMikkTSpaceFaces*)(Context->m_pUserData);
+		return (int)Faces->MeshData->PolygonPerimeters[Faces->PolygonIDs[FaceIdx]]->size();
 	}
 
 	void MikkGetPosition(const SMikkTSpaceContext* Context, float Position[3], const int FaceIdx, const int VertIdx)
 	{
-		MeshDescription* MD = (MeshDescription*)(Context->m_pUserData);
-		const MeshPolygon& Polygon = MD->GetPolygon(FaceIdx);
-		const int VertexInstanceID = Polygon.PerimeterContour.VertexInstanceIDs[VertIdx];
-		const int VertexID = MD->GetVertexInstanceVertex(VertexInstanceID);
-		const FVector& VertexPosition = MD->VertexAttributes().GetAttribute<FVector>(VertexID, MeshAttribute::Vertex::Position);
+		const FMikkTSpaceFaces* Faces = (const FMikkTSpaceFaces*)(Context->m_pUserData);
+		const int VertexInstanceID = Faces->GetVertexInstanceID(FaceIdx, VertIdx);
+		const int VertexID = Faces->MeshData->VertexInstanceVertices[VertexInstanceID];
+		const FVector& VertexPosition = Faces->MeshData->VertexPositions[VertexID];
 		Position[0] = VertexPosition.X;
 		Position[1] = VertexPosition.Y;
 		Position[2] = VertexPosition.Z;
@@ -481,10 +754,9 @@ namespace MeshDescriptionMikktSpaceInterface
 
 	void MikkGetNormal(const SMikkTSpaceContext* Context, float Normal[3], const int FaceIdx, const int VertIdx)
 	{
-		MeshDescription* MD = (MeshDescription*)(Context->m_pUserData);
-		const MeshPolygon& Polygon = MD->GetPolygon(FaceIdx);
-		const int VertexInstanceID = Polygon.PerimeterContour.VertexInstanceIDs[VertIdx];
-		const FVector& VertexNormal = MD->VertexInstanceAttributes().GetAttribute<FVector>(VertexInstanceID, MeshAttribute::VertexInstance::Normal);
+		const FMikkTSpaceFaces* Faces = (const FMikkTSpaceFaces*)(Context->m_pUserData);
+		const int VertexInstanceID = Faces->GetVertexInstanceID(FaceIdx, VertIdx);
+		const FVector& VertexNormal = Faces->MeshData->VertexInstanceNormals[VertexInstanceID];
 		Normal[0] = VertexNormal.X;
 		Normal[1] = VertexNormal.Y;
 		Normal[2] = VertexNormal.Z;
@@ -492,26 +764,23 @@ namespace MeshDescriptionMikktSpaceInterface
 
 	void MikkSetTSpaceBasic(const SMikkTSpaceContext* Context, const float Tangent[3], const float BitangentSign, const int FaceIdx, const int VertIdx)
 	{
-		MeshDescription* MD = (MeshDescription*)(Context->m_pUserData);
-		const MeshPolygon& Polygon = MD->GetPolygon(FaceIdx);
-		const int VertexInstanceID = Polygon.PerimeterContour.VertexInstanceIDs[VertIdx];
-		const FVector VertexTangent(Tangent[0], Tangent[1], Tangent[2]);
-		MD->VertexInstanceAttributes().SetAttribute<FVector>(VertexInstanceID, MeshAttribute::VertexInstance::Tangent, 0, VertexTangent);
-		MD->VertexInstanceAttributes().SetAttribute<float>(VertexInstanceID, MeshAttribute::VertexInstance::BinormalSign, 0, -BitangentSign);
+		const FMikkTSpaceFaces* Faces = (const FMikkTSpaceFaces*)(Context->m_pUserData);
+		const int VertexInstanceID = Faces->GetVertexInstanceID(FaceIdx, VertIdx);
+		Faces->MeshData->VertexInstanceTangents[VertexInstanceID] = FVector(Tangent[0], Tangent[1], Tangent[2]);
+		Faces->MeshData->VertexInstanceBinormalSigns[VertexInstanceID] = -BitangentSign;
 	}
 
 	void MikkGetTexCoord(const SMikkTSpaceContext* Context, float UV[2], const int FaceIdx, const int VertIdx)
 	{
-		MeshDescription* MD = (MeshDescription*)(Context->m_pUserData);
-		const MeshPolygon& Polygon = MD->GetPolygon(FaceIdx);
-		const int VertexInstanceID = Polygon.PerimeterContour.VertexInstanceIDs[VertIdx];
-		const Vector2& TexCoord = MD->VertexInstanceAttributes().GetAttribute<Vector2>(VertexInstanceID, MeshAttribute::VertexInstance::TextureCoordinate, 0);
+		const FMikkTSpaceFaces* Faces = (const FMikkTSpaceFaces*)(Context->m_pUserData);
+		const int VertexInstanceID = Faces->GetVertexInstanceID(FaceIdx, VertIdx);
+		const Vector2& TexCoord = Faces->MeshData->VertexInstanceUVs[VertexInstanceID];
 		UV[0] = TexCoord.X;
 		UV[1] = TexCoord.Y;
 	}
-}
-
-void MeshDescriptionOperations::CreateLightMapUVLayout(MeshDescription& MD, int SrcLightmapIndex, int DstLightmapIndex, int MinLightmapResolution, ELightmapUVVersion LightmapUVVersion, const std::multimap<int, int>& OverlappingCorners)
+}
+
+MeshDescriptionOperations::FLightmapUVPackingStatistics MeshDescriptionOperations::CreateLightMapUVLayout(MeshDescription& MD, int SrcLightmapIndex, int DstLightmapIndex, int MinLightmapResolution, ELightmapUVVersion LightmapUVVersion, const FOverlappingCornerAdjacency& OverlappingCorners)
 {
 	MeshDescriptionOp::FLayoutUV Packer(MD, SrcLightmapIndex, DstLightmapIndex, MinLightmapResolution);
 	Packer.SetVersion(LightmapUVVersion);
@@ -522,5 +791,6 @@ void MeshDescriptionOperations::CreateLightMapUVLayout(MeshDescription& MD, int
 	{
 		Packer.CommitPackedUVs();
 	}
+	return Packer.GetPackingStatistics();
 }
 
@@ -1,10 +1,66 @@
 #pragma once
 
+#include "UnrealMath.h"
 #include <map>
 #include <unordered_map>
+#include <vector>
 
 class MeshDescription;
 
+/**
+* Build polygon NTBs, normals, MikkTSpace tangents and triangulations on all cores. The parallel results are identical
+* to the serial ones: work is split by polygon or vertex where each only writes its own data, and MikkTSpace by groups of
+* polygons that share no corner position. Skeletal mesh influences, vertex welding and bone chunking run by vertex and by
+* material section the same way.
+*/
+extern bool GParallelMeshBuild;
+
+/**
+* Search lightmap UV packing scales with a skyline of chart bounding rects first and try the exact raster packings of
+* several scales at once on worker threads. Off, scales are tried one after the other with raster packings only.
+*/
+extern bool GFastLightmapUVPacking;
+
+/**
+* Overlapping corners of a mesh in one flat array: the corners overlapping corner i are Indices[Offsets[i]] up to
+* Indices[Offsets[i + 1]], sorted and not including i itself. Corners are vertex instance IDs.
+*/
+struct FOverlappingCornerAdjacency
+{
+	struct FRange
+	{
+		const int* First;
+		const int* Last;
+
+		const int* begin() const { return First; }
+		const int* end() const { return Last; }
+		int size() const { return (int)(Last - First); }
+		int operator[](int Index) const { return First[Index]; }
+	};
+
+	std::vector<int> Offsets;
+	std::vector<int> Indices;
+
+	void Reset()
+	{
+		Offsets.clear();
+		Indices.clear();
+	}
+
+	int Num() const { return Offsets.empty() ? 0 : (int)Offsets.size() - 1; }
+
+	/** @return the corners overlapping Corner, empty if there are none */
+	FRange FindIfOverlapping(int Corner) const
+	{
+		if (Corner < 0 || Corner >= Num())
+		{
+			return FRange{ nullptr, nullptr };
+		}
+		const int* Data = Indices.data();
+		return FRange{ Data + Offsets[Corner], Data + Offsets[Corner + 1] };
+	}
+};
+
 class MeshDescriptionOperations
 {
 public:
@@ -24,16 +80,39 @@ public:
 		Latest = SmallChartPacking
 	};
 
+	/** How CreateLightMapUVLayout packed the charts */
+	struct FLightmapUVPackingStatistics
+	{
+		bool bSuccess = false;
+		uint32 NumCharts = 0;
+		/** Packings of chart bounding rects into a skyline tried while searching the scale */
+		uint32 NumRectPackings = 0;
+		/** Packings of chart rasters tried while searching the scale, the expensive part */
+		uint32 NumRasterPackings = 0;
+		/** Lightmap texels per unit of chart UV space in the packing used */
+		float UVScale = 0.f;
+		/** Fraction of the lightmap texels covered by the dilated charts */
+		float TexelUtilization = 0.f;
+		double PackingMilliseconds = 0.0;
+	};
+
 	static void CreatePolygonNTB(MeshDescription& MD, float ComparisonThreshold);
 	static void CreateNormals(MeshDescription& MD, ETangentOptions TangentOptions, bool bComputeTangent);
 	static void CreateMikktTangents(MeshDescription& MD, ETangentOptions TangentOptions);
 
-	static void FindOverlappingCorners(std::multimap<int, int>& OverlappingCorners, const MeshDescription& MD, float ComparisonThreshold);
+	/** Triangulates every polygon of MD into its Triangles */
+	static void ComputePolygonTriangulations(MeshDescription& MD);
+
+	/**
+	* Finds all pairs of vertex instances whose positions are within ComparisonThreshold of each other. Positions are
+	* bucketed into a uniform grid with cells at least ComparisonThreshold wide so only neighbouring cells are compared.
+	*/
+	static void FindOverlappingCorners(FOverlappingCornerAdjacency& OverlappingCorners, const MeshDescription& MD, float ComparisonThreshold);
 
-	static void CreateLightMapUVLayout(MeshDescription& MD,
+	static FLightmapUVPackingStatistics CreateLightMapUVLayout(MeshDescription& MD,
 		int SrcLightmapIndex,
 		int DstLightmapIndex,
 		int MinLightmapResolution,
 		ELightmapUVVersion LightmapUVVersion,
-		const std::multimap<int, int>& OverlappingCorners);
+		const FOverlappingCornerAdjacency& OverlappingCorners);
 };
\ No newline at end of file
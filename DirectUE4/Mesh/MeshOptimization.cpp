@@ -0,0 +1,220 @@
+#include "MeshOptimization.h"
+#include "forsythtriangleorderoptimizer.h"
+
+#include <algorithm>
+
+namespace MeshOptimizationNamespace
+{
+	/**
+	 * FIFO post-transform cache. A vertex is cached while fewer than CacheSize misses happened since it was transformed,
+	 * which is exactly what a FIFO of CacheSize entries keeps, without shifting any entries around.
+	 */
+	struct FFifoCacheSimulator
+	{
+		FFifoCacheSimulator(uint32 NumVertices, uint32 InCacheSize)
+			: CacheSize(InCacheSize)
+		{
+			Timestamps.resize(NumVertices, 0);
+			Reset();
+		}
+
+		/** Empties the cache without touching every vertex */
+		void Reset()
+		{
+			Time += CacheSize;
+		}
+
+		/** @return true if the vertex had to be transformed */
+		bool Access(uint32 VertexIndex)
+		{
+			if (Time - Timestamps[VertexIndex] >= CacheSize)
+			{
+				Timestamps[VertexIndex] = ++Time;
+				return true;
+			}
+			return false;
+		}
+
+		uint32 AccessTriangle(const uint32* TriangleIndices)
+		{
+			return (uint32)Access(TriangleIndices[0]) + (uint32)Access(TriangleIndices[1]) + (uint32)Access(TriangleIndices[2]);
+		}
+
+		std::vector<uint32> Timestamps;
+		uint32 CacheSize;
+		uint32 Time = 0;
+	};
+
+	struct FTriangleCluster
+	{
+		uint32 FirstTriangle;
+		uint32 NumTriangles;
+		float SortKey;
+	};
+}
+
+FVertexCacheStatistics MeshOptimization::AnalyzeVertexCache(const uint32* Indices, uint32 NumIndices, uint32 NumVertices, uint32 CacheSize)
+{
+	using namespace MeshOptimizationNamespace;
+
+	FVertexCacheStatistics Statistics;
+	Statistics.NumTriangles = NumIndices / 3;
+
+	FFifoCacheSimulator Cache(NumVertices, CacheSize);
+	std::vector<bool> Used(NumVertices, false);
+	for (uint32 Index = 0; Index < Statistics.NumTriangles * 3; ++Index)
+	{
+		const uint32 VertexIndex = Indices[Index];
+		Statistics.NumTransformedVertices += Cache.Access(VertexIndex) ? 1 : 0;
+		if (!Used[VertexIndex])
+		{
+			Used[VertexIndex] = true;
+			Statistics.NumVerticesUsed++;
+		}
+	}
+	return Statistics;
+}
+
+void MeshOptimization::OptimizeVertexCache(uint32* Indices, uint32 NumIndices, uint32 NumVertices)
+{
+	if (NumIndices < 6)
+	{
+		return;
+	}
+	// same cache size the skeletal mesh chunks are optimized for
+	const uint16 LRUCacheSize = 32;
+	std::vector<uint32> OptimizedIndices(NumIndices);
+	Forsyth::OptimizeFaces(Indices, NumIndices, NumVertices, OptimizedIndices.data(), LRUCacheSize);
+	std::copy(OptimizedIndices.begin(), OptimizedIndices.end(), Indices);
+}
+
+void MeshOptimization::OptimizeOverdraw(uint32* Indices, uint32 NumIndices, const FVector* Positions, uint32 NumVertices, float Threshold)
+{
+	using namespace MeshOptimizationNamespace;
+
+	const uint32 NumTriangles = NumIndices / 3;
+	if (NumTriangles < 2)
+	{
+		return;
+	}
+
+	// Hard boundaries, the triangles all of whose vertices miss the cache. Starting a cluster there costs nothing.
+	std::vector<uint32> HardBoundaries;
+	{
+		FFifoCacheSimulator Cache(NumVertices, SimulatedCacheSize);
+		for (uint32 Triangle = 0; Triangle < NumTriangles; ++Triangle)
+		{
+			if (Cache.AccessTriangle(&Indices[Triangle * 3]) == 3)
+			{
+				HardBoundaries.push_back(Triangle);
+			}
+		}
+	}
+	HardBoundaries.push_back(NumTriangles);
+
+	// Soft boundaries, cut a hard cluster again as soon as the part so far, replayed on an empty cache,
+	// is within Threshold of the miss ratio of the whole hard cluster
+	std::vector<FTriangleCluster> Clusters;
+	{
+		FFifoCacheSimulator Cache(NumVertices, SimulatedCacheSize);
+		for (size_t HardIndex = 0; HardIndex + 1 < HardBoundaries.size(); ++HardIndex)
+		{
+			const uint32 Start = HardBoundaries[HardIndex];
+			const uint32 End = HardBoundaries[HardIndex + 1];
+
+			Cache.Reset();
+			uint32 ClusterMisses = 0;
+			for (uint32 Triangle = Start; Triangle < End; ++Triangle)
+			{
+				ClusterMisses += Cache.AccessTriangle(&Indices[Triangle * 3]);
+			}
+			const float MaxACMR = (float)ClusterMisses / (float)(End - Start) * Threshold;
+
+			Cache.Reset();
+			uint32 SubStart = Start;
+			uint32 SubMisses = 0;
+			for (uint32 Triangle = Start; Triangle < End; ++Triangle)
+			{
+				SubMisses += Cache.AccessTriangle(&Indices[Triangle * 3]);
+				if ((float)SubMisses <= MaxACMR * (float)(Triangle + 1 - SubStart) || Triangle + 1 == End)
+				{
+					FTriangleCluster Cluster;
+					Cluster.FirstTriangle = SubStart;
+					Cluster.NumTriangles = Triangle + 1 - SubStart;
+					Cluster.SortKey = 0.f;
+					Clusters.push_back(Cluster);
+
+					Cache.Reset();
+					SubStart = Triangle + 1;
+					SubMisses = 0;
+				}
+			}
+		}
+	}
+	if (Clusters.size() < 2)
+	{
+		return;
+	}
+
+	// Outward facing clusters far from the middle of the mesh are likely to hide the rest, draw them first
+	FVector MeshCentroid(0.f);
+	float MeshArea = 0.f;
+	std::vector<FVector> ClusterCentroids(Clusters.size(), FVector(0.f));
+	std::vector<FVector> ClusterNormals(Clusters.size(), FVector(0.f));
+	for (size_t ClusterIndex = 0; ClusterIndex < Clusters.size(); ++ClusterIndex)
+	{
+		const FTriangleCluster& Cluster = Clusters[ClusterIndex];
+		float ClusterArea = 0.f;
+		for (uint32 Triangle = Cluster.FirstTriangle; Triangle < Cluster.FirstTriangle + Cluster.NumTriangles; ++Triangle)
+		{
+			const FVector& P0 = Positions[Indices[Triangle * 3 + 0]];
+			const FVector& P1 = Positions[Indices[Triangle * 3 + 1]];
+			const FVector& P2 = Positions[Indices[Triangle * 3 + 2]];
+			// same cross product CreatePolygonNTB takes the outward polygon normal from
+			const FVector AreaNormal = (P1 - P2) ^ (P0 - P2);
+			const float Area = AreaNormal.Size();
+			ClusterNormals[ClusterIndex] += AreaNormal;
+			ClusterCentroids[ClusterIndex] += (P0 + P1 + P2) * (Area / 3.f);
+			ClusterArea += Area;
+		}
+		MeshCentroid += ClusterCentroids[ClusterIndex];
+		MeshArea += ClusterArea;
+		ClusterCentroids[ClusterIndex] = ClusterArea > 0.f ? ClusterCentroids[ClusterIndex] / ClusterArea : Positions[Indices[Cluster.FirstTriangle * 3]];
+	}
+	MeshCentroid = MeshArea > 0.f ? MeshCentroid / MeshArea : FVector(0.f);
+
+	for (size_t ClusterIndex = 0; ClusterIndex < Clusters.size(); ++ClusterIndex)
+	{
+		Clusters[ClusterIndex].SortKey = (ClusterCentroids[ClusterIndex] - MeshCentroid) | ClusterNormals[ClusterIndex].GetSafeNormal();
+	}
+	std::stable_sort(Clusters.begin(), Clusters.end(), [](const FTriangleCluster& A, const FTriangleCluster& B)
+	{
+		return A.SortKey > B.SortKey;
+	});
+
+	std::vector<uint32> SortedIndices;
+	SortedIndices.reserve(NumTriangles * 3);
+	for (const FTriangleCluster& Cluster : Clusters)
+	{
+		SortedIndices.insert(SortedIndices.end(), Indices + Cluster.FirstTriangle * 3, Indices + (Cluster.FirstTriangle + Cluster.NumTriangles) * 3);
+	}
+	std::copy(SortedIndices.begin(), SortedIndices.end(), Indices);
+}
+
+uint32 MeshOptimization::OptimizeVertexFetchRemap(uint32* Indices, uint32 NumIndices, uint32 NumVertices, std::vector<int32>& OutRemap)
+{
+	OutRemap.clear();
+	OutRemap.resize(NumVertices, INDEX_NONE);
+
+	uint32 NumNewVertices = 0;
+	for (uint32 Index = 0; Index < NumIndices; ++Index)
+	{
+		int32& NewIndex = OutRemap[Indices[Index]];
+		if (NewIndex == INDEX_NONE)
+		{
+			NewIndex = (int32)NumNewVertices++;
+		}
+		Indices[Index] = (uint32)NewIndex;
+	}
+	return NumNewVertices;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "UnrealMath.h"
+#include <vector>
+
+/** Post-transform vertex cache behaviour of an index buffer, as measured by MeshOptimization::AnalyzeVertexCache */
+struct FVertexCacheStatistics
+{
+	uint32 NumTriangles = 0;
+	/** Distinct vertices the index buffer references */
+	uint32 NumVerticesUsed = 0;
+	/** Cache misses, every one of them runs the vertex shader */
+	uint32 NumTransformedVertices = 0;
+
+	/** Average cache miss ratio, transformed vertices per triangle. 3 is the worst, about 0.5 is the best a regular grid gets. */
+	float GetACMR() const { return NumTriangles ? (float)NumTransformedVertices / (float)NumTriangles : 0.f; }
+	/** Average transform to vertex ratio, transformed vertices per used vertex. 1 is ideal. */
+	float GetATVR() const { return NumVerticesUsed ? (float)NumTransformedVertices / (float)NumVerticesUsed : 0.f; }
+
+	FVertexCacheStatistics& operator+=(const FVertexCacheStatistics& Other)
+	{
+		NumTriangles += Other.NumTriangles;
+		NumVerticesUsed += Other.NumVerticesUsed;
+		NumTransformedVertices += Other.NumTransformedVertices;
+		return *this;
+	}
+};
+
+/**
+ * Offline index and vertex buffer optimizations for static geometry. Everything works on plain triangle lists
+ * and runs without a GPU, the cache simulator stands in for the post-transform cache.
+ */
+namespace MeshOptimization
+{
+	/** FIFO entries of the simulated post-transform cache, what most desktop GPUs behave like */
+	const uint32 SimulatedCacheSize = 16;
+
+	/** Runs the index buffer through a FIFO post-transform cache simulation. Indices must be below NumVertices. */
+	FVertexCacheStatistics AnalyzeVertexCache(const uint32* Indices, uint32 NumIndices, uint32 NumVertices, uint32 CacheSize = SimulatedCacheSize);
+
+	/** Reorders the triangles for post-transform cache reuse (Forsyth's linear-speed optimizer) */
+	void OptimizeVertexCache(uint32* Indices, uint32 NumIndices, uint32 NumVertices);
+
+	/**
+	 * Reorders clusters of an already cache-optimized index buffer so that outward facing geometry tends to be drawn first,
+	 * which lowers overdraw from most view directions (Sander et al., "Fast triangle reordering for vertex locality and
+	 * reduced overdraw"). Clusters are cut where the cache starts over anyway, or where cutting costs the cache at most
+	 * Threshold times the cluster's miss ratio, so the vertex cache efficiency stays within that factor.
+	 */
+	void OptimizeOverdraw(uint32* Indices, uint32 NumIndices, const FVector* Positions, uint32 NumVertices, float Threshold = 1.05f);
+
+	/**
+	 * Numbers the vertices in the order the index buffer first uses them and rewrites the indices accordingly,
+	 * so vertex fetch walks the streams front to back. Unused vertices are dropped.
+	 * @param OutRemap - new index of every old vertex, INDEX_NONE for unused ones; pass to RemapVertexStream for every stream
+	 * @return number of vertices left
+	 */
+	uint32 OptimizeVertexFetchRemap(uint32* Indices, uint32 NumIndices, uint32 NumVertices, std::vector<int32>& OutRemap);
+
+	/** Moves the vertices of one stream to the order computed by OptimizeVertexFetchRemap */
+	template <typename ElementType>
+	void RemapVertexStream(std::vector<ElementType>& Stream, uint32 ElementsPerVertex, const std::vector<int32>& Remap, uint32 NumNewVertices)
+	{
+		if (Stream.empty())
+		{
+			return;
+		}
+		std::vector<ElementType> NewStream(NumNewVertices * ElementsPerVertex);
+		for (uint32 OldIndex = 0; OldIndex < Remap.size(); ++OldIndex)
+		{
+			if (Remap[OldIndex] != INDEX_NONE)
+			{
+				for (uint32 Element = 0; Element < ElementsPerVertex; ++Element)
+				{
+					NewStream[Remap[OldIndex] * ElementsPerVertex + Element] = Stream[OldIndex * ElementsPerVertex + Element];
+				}
+			}
+		}
+		Stream.swap(NewStream);
+	}
+}
@@ -0,0 +1,720 @@
+#include "MeshReduction.h"
+#include "MeshDescription.h"
+#include "MeshDescriptionOperations.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <queue>
+#include <assert.h>
+
+namespace MeshReductionNamespace
+{
+	/** Quadrics of open borders, UV seams and material boundaries count this many times the edge length squared */
+	const double BoundaryWeight = 10.0;
+
+	/** A collapse may turn no remaining triangle further than about 75 degrees, cosine squared of that */
+	const float MinCosSquaredNormalChange = 0.0625f;
+
+	/** Weighted sum of squared distances to planes, the symmetric 4x4 matrix of the quadric error metric */
+	struct FQuadric
+	{
+		double A00 = 0.0, A01 = 0.0, A02 = 0.0, A11 = 0.0, A12 = 0.0, A22 = 0.0;
+		double B0 = 0.0, B1 = 0.0, B2 = 0.0;
+		double C = 0.0;
+		double Weight = 0.0;
+
+		/** Plane through Point with unit length Normal */
+		void AddPlane(const FVector& Normal, const FVector& Point, double PlaneWeight)
+		{
+			const double NX = Normal.X, NY = Normal.Y, NZ = Normal.Z;
+			const double D = -(NX * Point.X + NY * Point.Y + NZ * Point.Z);
+			A00 += PlaneWeight * NX * NX;
+			A01 += PlaneWeight * NX * NY;
+			A02 += PlaneWeight * NX * NZ;
+			A11 += PlaneWeight * NY * NY;
+			A12 += PlaneWeight * NY * NZ;
+			A22 += PlaneWeight * NZ * NZ;
+			B0 += PlaneWeight * NX * D;
+			B1 += PlaneWeight * NY * D;
+			B2 += PlaneWeight * NZ * D;
+			C += PlaneWeight * D * D;
+			Weight += PlaneWeight;
+		}
+
+		FQuadric& operator+=(const FQuadric& Other)
+		{
+			A00 += Other.A00; A01 += Other.A01; A02 += Other.A02;
+			A11 += Other.A11; A12 += Other.A12; A22 += Other.A22;
+			B0 += Other.B0; B1 += Other.B1; B2 += Other.B2;
+			C += Other.C;
+			Weight += Other.Weight;
+			return *this;
+		}
+
+		/** Weighted mean squared distance of Point to the planes */
+		double GetError(const FVector& Point) const
+		{
+			const double X = Point.X, Y = Point.Y, Z = Point.Z;
+			const double Sum =
+				X * (A00 * X + A01 * Y + A02 * Z) +
+				Y * (A01 * X + A11 * Y + A12 * Z) +
+				Z * (A02 * X + A12 * Y + A22 * Z) +
+				2.0 * (B0 * X + B1 * Y + B2 * Z) + C;
+			return Weight > 0.0 ? std::max(Sum, 0.0) / Weight : 0.0;
+		}
+	};
+
+	/** Moving Vertex onto Target, ordered so the priority queue pops the smallest error first */
+	struct FCollapse
+	{
+		double Error;
+		uint32 Vertex;
+		uint32 Target;
+		/** Stamp of Vertex when the collapse was queued, the entry is stale once the vertex got a newer one */
+		uint32 Stamp;
+
+		bool operator<(const FCollapse& Other) const
+		{
+			return Error != Other.Error ? Error > Other.Error : Vertex > Other.Vertex;
+		}
+	};
+
+	/**
+	 * Half edge collapses on an indexed triangle list. A wedge is a corner type of a vertex, the vertex instances of a vertex
+	 * that share attributes and polygon group. Triangles reference wedges, so a vertex with more than one wedge lies on a
+	 * UV seam, hard edge or material boundary.
+	 */
+	class FEdgeCollapser
+	{
+	public:
+		std::vector<FVector> Positions;
+		/** Vertex of every wedge */
+		std::vector<uint32> WedgeVertices;
+		/** Three wedges per triangle */
+		std::vector<uint32> Corners;
+		std::vector<bool> TriangleAlive;
+		uint32 NumAliveTriangles = 0;
+
+		/** Builds the quadrics and adjacency, call once Positions, WedgeVertices and Corners are filled */
+		void Init()
+		{
+			const uint32 NumVertices = (uint32)Positions.size();
+			const uint32 NumTriangles = (uint32)Corners.size() / 3;
+			VertexTriangles.resize(NumVertices);
+			Quadrics.resize(NumVertices);
+			Stamps.resize(NumVertices, 0);
+			VertexCollapsed.resize(NumVertices, false);
+			TriangleAlive.resize(NumTriangles, true);
+			NumAliveTriangles = NumTriangles;
+
+			// edges by their vertex pair, to find the ones with one triangle or different wedges on either side
+			struct FEdgeSide
+			{
+				uint64 Key;
+				uint32 Triangle;
+				uint32 Corner;
+			};
+			std::vector<FEdgeSide> EdgeSides;
+			EdgeSides.reserve(NumTriangles * 3);
+
+			std::vector<FVector> TriangleNormals(NumTriangles);
+			for (uint32 Triangle = 0; Triangle < NumTriangles; ++Triangle)
+			{
+				const FVector& P0 = Positions[GetVertex(Triangle, 0)];
+				const FVector& P1 = Positions[GetVertex(Triangle, 1)];
+				const FVector& P2 = Positions[GetVertex(Triangle, 2)];
+				const FVector AreaNormal = (P1 - P0) ^ (P2 - P0);
+				const float DoubleArea = AreaNormal.Size();
+				TriangleNormals[Triangle] = DoubleArea > 0.f ? AreaNormal / DoubleArea : FVector(0.f);
+				for (uint32 Corner = 0; Corner < 3; ++Corner)
+				{
+					const uint32 Vertex = GetVertex(Triangle, Corner);
+					VertexTriangles[Vertex].push_back(Triangle);
+					if (DoubleArea > 0.f)
+					{
+						Quadrics[Vertex].AddPlane(TriangleNormals[Triangle], P0, 0.5 * DoubleArea);
+					}
+
+					const uint32 EdgeVertex0 = Vertex;
+					const uint32 EdgeVertex1 = GetVertex(Triangle, (Corner + 1) % 3);
+					FEdgeSide Side;
+					Side.Key = ((uint64)std::min(EdgeVertex0, EdgeVertex1) << 32) | (uint64)std::max(EdgeVertex0, EdgeVertex1);
+					Side.Triangle = Triangle;
+					Side.Corner = Corner;
+					EdgeSides.push_back(Side);
+				}
+			}
+
+			std::sort(EdgeSides.begin(), EdgeSides.end(), [](const FEdgeSide& A, const FEdgeSide& B)
+			{
+				return A.Key != B.Key ? A.Key < B.Key : A.Triangle < B.Triangle;
+			});
+			for (size_t First = 0; First < EdgeSides.size();)
+			{
+				size_t Last = First + 1;
+				while (Last < EdgeSides.size() && EdgeSides[Last].Key == EdgeSides[First].Key)
+				{
+					++Last;
+				}
+
+				bool bBoundary = Last - First != 2;
+				if (!bBoundary)
+				{
+					// the two sides run the edge in opposite directions, the same wedges meet at either end on a smooth edge
+					const FEdgeSide& A = EdgeSides[First];
+					const FEdgeSide& B = EdgeSides[First + 1];
+					bBoundary = GetWedge(A.Triangle, A.Corner) != GetWedge(B.Triangle, (B.Corner + 1) % 3)
+						|| GetWedge(A.Triangle, (A.Corner + 1) % 3) != GetWedge(B.Triangle, B.Corner);
+				}
+				if (bBoundary)
+				{
+					for (size_t SideIndex = First; SideIndex < Last; ++SideIndex)
+					{
+						const FEdgeSide& Side = EdgeSides[SideIndex];
+						const uint32 Vertex0 = GetVertex(Side.Triangle, Side.Corner);
+						const uint32 Vertex1 = GetVertex(Side.Triangle, (Side.Corner + 1) % 3);
+						const FVector Edge = Positions[Vertex1] - Positions[Vertex0];
+						// plane through the edge, perpendicular to the triangle, moving along the boundary costs nothing
+						const FVector PlaneNormal = (Edge ^ TriangleNormals[Side.Triangle]).GetSafeNormal();
+						if (!PlaneNormal.IsZero())
+						{
+							const double EdgeWeight = BoundaryWeight * Edge.SizeSquared();
+							Quadrics[Vertex0].AddPlane(PlaneNormal, Positions[Vertex0], EdgeWeight);
+							Quadrics[Vertex1].AddPlane(PlaneNormal, Positions[Vertex0], EdgeWeight);
+						}
+					}
+				}
+				First = Last;
+			}
+		}
+
+		/**
+		 * Collapses the cheapest edges until at most TargetTriangles are left, or the cheapest collapse costs more than MaxError.
+		 * @return the largest error of a collapse done, a mean squared distance
+		 */
+		double Simplify(uint32 TargetTriangles, double MaxError)
+		{
+			for (uint32 Vertex = 0; Vertex < (uint32)Positions.size(); ++Vertex)
+			{
+				FindBestCollapse(Vertex);
+			}
+
+			double MaxCollapseError = 0.0;
+			while (NumAliveTriangles > TargetTriangles && !Queue.empty())
+			{
+				const FCollapse Collapse = Queue.top();
+				Queue.pop();
+				if (VertexCollapsed[Collapse.Vertex] || Collapse.Stamp != Stamps[Collapse.Vertex])
+				{
+					continue;
+				}
+
+				// collapses around the vertex may have made this one invalid since it was queued
+				GatherNeighbors(Collapse.Vertex, VertexNeighbors);
+				if (VertexCollapsed[Collapse.Target] || !IsCollapseValid(Collapse.Vertex, VertexNeighbors, Collapse.Target))
+				{
+					FindBestCollapse(Collapse.Vertex);
+					continue;
+				}
+				if (Collapse.Error > MaxError)
+				{
+					break;
+				}
+
+				DoCollapse(Collapse.Vertex, Collapse.Target);
+				MaxCollapseError = std::max(MaxCollapseError, Collapse.Error);
+			}
+			return MaxCollapseError;
+		}
+
+		uint32 GetWedge(uint32 Triangle, uint32 Corner) const { return Corners[Triangle * 3 + Corner]; }
+		uint32 GetVertex(uint32 Triangle, uint32 Corner) const { return WedgeVertices[Corners[Triangle * 3 + Corner]]; }
+
+	private:
+		struct FNeighbor
+		{
+			uint32 Vertex;
+			/** Triangles on the edge to the neighbour, 1 on an open border */
+			uint32 NumTriangles;
+		};
+
+		/**
+		 * Drops the removed triangles from the vertex's list and counts the triangles it shares with every neighbour.
+		 * Neighbours come out sorted by vertex, sorting keeps high valence vertices such as the poles of a sphere cheap.
+		 */
+		void GatherNeighbors(uint32 Vertex, std::vector<FNeighbor>& OutNeighbors)
+		{
+			std::vector<uint32>& Triangles = VertexTriangles[Vertex];
+			Triangles.erase(std::remove_if(Triangles.begin(), Triangles.end(), [this](uint32 Triangle) { return !TriangleAlive[Triangle]; }), Triangles.end());
+
+			NeighborScratch.clear();
+			for (const uint32 Triangle : Triangles)
+			{
+				for (uint32 Corner = 0; Corner < 3; ++Corner)
+				{
+					const uint32 Neighbor = GetVertex(Triangle, Corner);
+					if (Neighbor != Vertex)
+					{
+						NeighborScratch.push_back(Neighbor);
+					}
+				}
+			}
+			std::sort(NeighborScratch.begin(), NeighborScratch.end());
+
+			OutNeighbors.clear();
+			for (const uint32 Neighbor : NeighborScratch)
+			{
+				if (!OutNeighbors.empty() && OutNeighbors.back().Vertex == Neighbor)
+				{
+					OutNeighbors.back().NumTriangles++;
+				}
+				else
+				{
+					OutNeighbors.push_back(FNeighbor{ Neighbor, 1 });
+				}
+			}
+		}
+
+		/**
+		 * Checks that moving Vertex onto Target keeps the mesh manifold, maps every wedge of Vertex onto a wedge of Target
+		 * and flips no triangle. Leaves the wedge mapping in WedgeRemap for DoCollapse.
+		 * @param Neighbors - what GatherNeighbors returns for Vertex
+		 */
+		bool IsCollapseValid(uint32 Vertex, const std::vector<FNeighbor>& Neighbors, uint32 Target)
+		{
+			GatherNeighbors(Target, TargetNeighbors);
+
+			uint32 NumEdgeTriangles = 0;
+			bool bVertexOnBorder = false;
+			for (const FNeighbor& Neighbor : Neighbors)
+			{
+				if (Neighbor.NumTriangles > 2)
+				{
+					return false;
+				}
+				bVertexOnBorder |= Neighbor.NumTriangles == 1;
+				NumEdgeTriangles = Neighbor.Vertex == Target ? Neighbor.NumTriangles : NumEdgeTriangles;
+			}
+			bool bTargetOnBorder = false;
+			for (const FNeighbor& Neighbor : TargetNeighbors)
+			{
+				if (Neighbor.NumTriangles > 2)
+				{
+					return false;
+				}
+				bTargetOnBorder |= Neighbor.NumTriangles == 1;
+			}
+			// an inner edge between two border vertices would pinch the mesh, a tetrahedron or a lone triangle would fold up
+			if (NumEdgeTriangles == 0 || (bVertexOnBorder && bTargetOnBorder && NumEdgeTriangles != 1) ||
+				(Neighbors.size() <= 3 && TargetNeighbors.size() <= 3))
+			{
+				return false;
+			}
+			// link condition, the only shared neighbours are the opposite vertices of the triangles on the edge
+			uint32 NumSharedNeighbors = 0;
+			for (size_t A = 0, B = 0; A < Neighbors.size() && B < TargetNeighbors.size();)
+			{
+				if (Neighbors[A].Vertex == TargetNeighbors[B].Vertex)
+				{
+					NumSharedNeighbors++;
+					++A;
+					++B;
+				}
+				else if (Neighbors[A].Vertex < TargetNeighbors[B].Vertex)
+				{
+					++A;
+				}
+				else
+				{
+					++B;
+				}
+			}
+			if (NumSharedNeighbors != NumEdgeTriangles)
+			{
+				return false;
+			}
+
+			// the triangles on the edge pair the wedges of the two vertices up
+			WedgeRemap.clear();
+			for (const uint32 Triangle : VertexTriangles[Vertex])
+			{
+				uint32 VertexCorner = 0;
+				uint32 TargetCorner = 3;
+				for (uint32 Corner = 0; Corner < 3; ++Corner)
+				{
+					const uint32 CornerVertex = GetVertex(Triangle, Corner);
+					VertexCorner = CornerVertex == Vertex ? Corner : VertexCorner;
+					TargetCorner = CornerVertex == Target ? Corner : TargetCorner;
+				}
+				if (TargetCorner == 3)
+				{
+					continue;
+				}
+				const uint32 FromWedge = GetWedge(Triangle, VertexCorner);
+				const uint32 ToWedge = GetWedge(Triangle, TargetCorner);
+				auto It = std::find_if(WedgeRemap.begin(), WedgeRemap.end(), [FromWedge](const std::pair<uint32, uint32>& Pair) { return Pair.first == FromWedge; });
+				if (It == WedgeRemap.end())
+				{
+					WedgeRemap.push_back(std::make_pair(FromWedge, ToWedge));
+				}
+				else if (It->second != ToWedge)
+				{
+					// the target has a seam across the edge the vertex does not have
+					return false;
+				}
+			}
+
+			const FVector& TargetPosition = Positions[Target];
+			for (const uint32 Triangle : VertexTriangles[Vertex])
+			{
+				FVector OldPositions[3];
+				FVector NewPositions[3];
+				bool bHasTarget = false;
+				for (uint32 Corner = 0; Corner < 3; ++Corner)
+				{
+					const uint32 CornerVertex = GetVertex(Triangle, Corner);
+					bHasTarget |= CornerVertex == Target;
+					OldPositions[Corner] = Positions[CornerVertex];
+					NewPositions[Corner] = CornerVertex == Vertex ? TargetPosition : OldPositions[Corner];
+					if (CornerVertex == Vertex)
+					{
+						// a wedge no triangle on the edge pairs up, a seam would tear open
+						const uint32 FromWedge = GetWedge(Triangle, Corner);
+						if (std::find_if(WedgeRemap.begin(), WedgeRemap.end(), [FromWedge](const std::pair<uint32, uint32>& Pair) { return Pair.first == FromWedge; }) == WedgeRemap.end())
+						{
+							return false;
+						}
+					}
+				}
+				if (bHasTarget)
+				{
+					continue;
+				}
+				const FVector OldNormal = (OldPositions[1] - OldPositions[0]) ^ (OldPositions[2] - OldPositions[0]);
+				const FVector NewNormal = (NewPositions[1] - NewPositions[0]) ^ (NewPositions[2] - NewPositions[0]);
+				const float Dot = OldNormal | NewNormal;
+				if (Dot <= 0.f || Dot * Dot < MinCosSquaredNormalChange * OldNormal.SizeSquared() * NewNormal.SizeSquared())
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		/** Queues the cheapest valid collapse of Vertex onto a neighbour, superseding what was queued for it before */
+		void FindBestCollapse(uint32 Vertex)
+		{
+			if (VertexCollapsed[Vertex])
+			{
+				return;
+			}
+			++Stamps[Vertex];
+
+			// the error is cheap, the validity check is not, so only check candidates until the cheapest valid one
+			GatherNeighbors(Vertex, CandidateNeighbors);
+			Candidates.clear();
+			for (const FNeighbor& Candidate : CandidateNeighbors)
+			{
+				Candidates.push_back(std::make_pair(Quadrics[Vertex].GetError(Positions[Candidate.Vertex]), Candidate.Vertex));
+			}
+			std::sort(Candidates.begin(), Candidates.end());
+			for (const std::pair<double, uint32>& Candidate : Candidates)
+			{
+				if (IsCollapseValid(Vertex, CandidateNeighbors, Candidate.second))
+				{
+					FCollapse Collapse;
+					Collapse.Error = Candidate.first;
+					Collapse.Vertex = Vertex;
+					Collapse.Target = Candidate.second;
+					Collapse.Stamp = Stamps[Vertex];
+					Queue.push(Collapse);
+					return;
+				}
+			}
+		}
+
+		/** Moves Vertex onto Target with the WedgeRemap the last IsCollapseValid of the pair left */
+		void DoCollapse(uint32 Vertex, uint32 Target)
+		{
+			GatherNeighbors(Vertex, RefreshNeighbors);
+			for (const uint32 Triangle : VertexTriangles[Vertex])
+			{
+				bool bHasTarget = false;
+				for (uint32 Corner = 0; Corner < 3; ++Corner)
+				{
+					bHasTarget |= GetVertex(Triangle, Corner) == Target;
+				}
+				if (bHasTarget)
+				{
+					TriangleAlive[Triangle] = false;
+					NumAliveTriangles--;
+					continue;
+				}
+				for (uint32 Corner = 0; Corner < 3; ++Corner)
+				{
+					uint32& Wedge = Corners[Triangle * 3 + Corner];
+					if (WedgeVertices[Wedge] == Vertex)
+					{
+						Wedge = std::find_if(WedgeRemap.begin(), WedgeRemap.end(), [Wedge](const std::pair<uint32, uint32>& Pair) { return Pair.first == Wedge; })->second;
+					}
+				}
+				VertexTriangles[Target].push_back(Triangle);
+			}
+			std::vector<uint32>().swap(VertexTriangles[Vertex]);
+			VertexCollapsed[Vertex] = true;
+			Quadrics[Target] += Quadrics[Vertex];
+
+			// The target's quadric and the one-rings of the vertex's neighbours changed. Positions never move, so the other
+			// neighbours of the target keep their errors, their queued collapses are checked again when they come up.
+			FindBestCollapse(Target);
+			for (const FNeighbor& Neighbor : RefreshNeighbors)
+			{
+				FindBestCollapse(Neighbor.Vertex);
+			}
+		}
+
+		std::vector<std::vector<uint32>> VertexTriangles;
+		std::vector<FQuadric> Quadrics;
+		std::vector<uint32> Stamps;
+		std::vector<bool> VertexCollapsed;
+		std::priority_queue<FCollapse> Queue;
+
+		std::vector<FNeighbor> VertexNeighbors;
+		std::vector<FNeighbor> TargetNeighbors;
+		std::vector<FNeighbor> CandidateNeighbors;
+		std::vector<FNeighbor> RefreshNeighbors;
+		std::vector<uint32> NeighborScratch;
+		std::vector<std::pair<double, uint32>> Candidates;
+		std::vector<std::pair<uint32, uint32>> WedgeRemap;
+	};
+
+	/** Per vertex instance attributes of a mesh, two instances with the same ones are one wedge */
+	struct FVertexInstanceAttributes
+	{
+		TMeshAttributesConstRef<FVector> Normals;
+		TMeshAttributesConstRef<FVector> Tangents;
+		TMeshAttributesConstRef<float> BinormalSigns;
+		TMeshAttributesConstRef<Vector4> Colors;
+		TMeshAttributesConstRef<Vector2> UVs;
+
+		explicit FVertexInstanceAttributes(const MeshDescription& MD)
+			: Normals(MD.VertexInstanceAttributes().GetAttributesRef<FVector>(MeshAttribute::VertexInstance::Normal))
+			, Tangents(MD.VertexInstanceAttributes().GetAttributesRef<FVector>(MeshAttribute::VertexInstance::Tangent))
+			, BinormalSigns(MD.VertexInstanceAttributes().GetAttributesRef<float>(MeshAttribute::VertexInstance::BinormalSign))
+			, Colors(MD.VertexInstanceAttributes().GetAttributesRef<Vector4>(MeshAttribute::VertexInstance::Color))
+			, UVs(MD.VertexInstanceAttributes().GetAttributesRef<Vector2>(MeshAttribute::VertexInstance::TextureCoordinate))
+		{
+		}
+
+		/** Same thresholds BuildVertexBuffer welds render vertices with */
+		bool AreEqual(int VertexInstanceA, int VertexInstanceB) const
+		{
+			if (VertexInstanceA == VertexInstanceB)
+			{
+				return true;
+			}
+			if (!Normals[VertexInstanceA].Equals(Normals[VertexInstanceB], THRESH_NORMALS_ARE_SAME) ||
+				!Tangents[VertexInstanceA].Equals(Tangents[VertexInstanceB], THRESH_NORMALS_ARE_SAME) ||
+				BinormalSigns[VertexInstanceA] != BinormalSigns[VertexInstanceB] ||
+				!(Colors[VertexInstanceA] == Colors[VertexInstanceB]))
+			{
+				return false;
+			}
+			for (int UVIndex = 0; UVIndex < UVs.GetNumIndices(); ++UVIndex)
+			{
+				if (!UVs.Get(VertexInstanceA, UVIndex).Equals(UVs.Get(VertexInstanceB, UVIndex), THRESH_UVS_ARE_SAME))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+	};
+
+	/** Copies one vertex instance attribute across meshes, looked up by name once rather than for every instance */
+	template <typename AttributeType>
+	struct TVertexInstanceAttributeCopy
+	{
+		TMeshAttributesRef<AttributeType> OutAttribute;
+		TMeshAttributesConstRef<AttributeType> InAttribute;
+		int NumIndices = 0;
+
+		TVertexInstanceAttributeCopy(MeshDescription& OutMesh, const MeshDescription& InMesh, const std::string& AttributeName)
+			: OutAttribute(OutMesh.VertexInstanceAttributes().GetAttributesRef<AttributeType>(AttributeName))
+			, InAttribute(InMesh.VertexInstanceAttributes().GetAttributesRef<AttributeType>(AttributeName))
+		{
+			if (OutAttribute.IsValid() && InAttribute.IsValid())
+			{
+				NumIndices = std::min(OutAttribute.GetNumIndices(), InAttribute.GetNumIndices());
+			}
+		}
+
+		void Copy(int OutVertexInstanceID, int InVertexInstanceID)
+		{
+			for (int Index = 0; Index < NumIndices; ++Index)
+			{
+				OutAttribute.Set(OutVertexInstanceID, Index, InAttribute.Get(InVertexInstanceID, Index));
+			}
+		}
+	};
+}
+
+void MeshReduction::ReduceMeshDescription(MeshDescription& OutReducedMesh, FMeshReductionStatistics& OutStatistics, const MeshDescription& InMesh, const FMeshReductionSettings& Settings)
+{
+	using namespace MeshReductionNamespace;
+
+	const FVertexInstanceAttributes Attributes(InMesh);
+	TMeshAttributesConstRef<FVector> VertexPositions = InMesh.VertexAttributes().GetAttributesRef<FVector>(MeshAttribute::Vertex::Position);
+
+	FEdgeCollapser Collapser;
+	std::vector<int> VertexIndices(InMesh.Vertices().GetArraySize(), INDEX_NONE);
+	std::vector<int> VertexIDs;
+	for (const int VertexID : InMesh.Vertices().GetElementIDs())
+	{
+		VertexIndices[VertexID] = (int)VertexIDs.size();
+		VertexIDs.push_back(VertexID);
+		Collapser.Positions.push_back(VertexPositions[VertexID]);
+	}
+
+	// weld the corners of every vertex into wedges, the polygon group is part of a wedge so material boundaries are seams
+	std::vector<int> WedgeVertexInstances;
+	std::vector<int> WedgePolygonGroups;
+	std::vector<std::vector<uint32>> VertexWedges(VertexIDs.size());
+	uint32 NumSourceTriangles = 0;
+	for (const int PolygonID : InMesh.Polygons().GetElementIDs())
+	{
+		const int PolygonGroupID = InMesh.GetPolygonPolygonGroup(PolygonID);
+		for (const MeshTriangle& Triangle : InMesh.GetPolygonTriangles(PolygonID))
+		{
+			NumSourceTriangles++;
+			uint32 TriangleWedges[3];
+			for (int Corner = 0; Corner < 3; ++Corner)
+			{
+				const int VertexInstanceID = Triangle.GetVertexInstanceID(Corner);
+				const int VertexIndex = VertexIndices[InMesh.GetVertexInstanceVertex(VertexInstanceID)];
+				std::vector<uint32>& Wedges = VertexWedges[VertexIndex];
+				auto It = std::find_if(Wedges.begin(), Wedges.end(), [&](uint32 Wedge)
+				{
+					return WedgePolygonGroups[Wedge] == PolygonGroupID && Attributes.AreEqual(WedgeVertexInstances[Wedge], VertexInstanceID);
+				});
+				if (It != Wedges.end())
+				{
+					TriangleWedges[Corner] = *It;
+				}
+				else
+				{
+					TriangleWedges[Corner] = (uint32)WedgeVertexInstances.size();
+					Wedges.push_back(TriangleWedges[Corner]);
+					WedgeVertexInstances.push_back(VertexInstanceID);
+					WedgePolygonGroups.push_back(PolygonGroupID);
+					Collapser.WedgeVertices.push_back((uint32)VertexIndex);
+				}
+			}
+			// triangles with a repeated vertex have no area and no edges to collapse, they are dropped
+			if (Collapser.WedgeVertices[TriangleWedges[0]] != Collapser.WedgeVertices[TriangleWedges[1]] &&
+				Collapser.WedgeVertices[TriangleWedges[1]] != Collapser.WedgeVertices[TriangleWedges[2]] &&
+				Collapser.WedgeVertices[TriangleWedges[2]] != Collapser.WedgeVertices[TriangleWedges[0]])
+			{
+				Collapser.Corners.insert(Collapser.Corners.end(), TriangleWedges, TriangleWedges + 3);
+			}
+		}
+	}
+
+	Collapser.Init();
+	const float PercentTriangles = FMath::Clamp(Settings.PercentTriangles, 0.f, 1.f);
+	const uint32 TargetTriangles = (uint32)FMath::CeilToInt(NumSourceTriangles * PercentTriangles);
+	double MaxError = 0.0;
+	if (Collapser.NumAliveTriangles > TargetTriangles)
+	{
+		const double MaxAllowedError = Settings.MaxDeviation < FLT_MAX ? (double)Settings.MaxDeviation * Settings.MaxDeviation : DBL_MAX;
+		MaxError = Collapser.Simplify(TargetTriangles, MaxAllowedError);
+	}
+
+	// write the triangles that are left, with only the vertices and vertex instances they still use
+	OutReducedMesh = MeshDescription();
+	OutReducedMesh.RegisterAttributesOf(InMesh);
+	OutReducedMesh.ReserveNewVertices((int)VertexIDs.size());
+	OutReducedMesh.ReserveNewVertexInstances((int)WedgeVertexInstances.size());
+	OutReducedMesh.ReserveNewPolygons((int)Collapser.NumAliveTriangles);
+
+	// polygon groups become sections with their ID as material index, keep every one even if it lost all its triangles
+	TMeshAttributesRef<std::string> OutSlotNames = OutReducedMesh.PolygonGroupAttributes().GetAttributesRef<std::string>(MeshAttribute::PolygonGroup::ImportedMaterialSlotName);
+	TMeshAttributesConstRef<std::string> InSlotNames = InMesh.PolygonGroupAttributes().GetAttributesRef<std::string>(MeshAttribute::PolygonGroup::ImportedMaterialSlotName);
+	std::vector<int> PolygonGroupIDs(InMesh.PolygonGroups().GetArraySize(), INDEX_NONE);
+	for (const int PolygonGroupID : InMesh.PolygonGroups().GetElementIDs())
+	{
+		PolygonGroupIDs[PolygonGroupID] = OutReducedMesh.CreatePolygonGroup();
+		if (OutSlotNames.IsValid() && InSlotNames.IsValid())
+		{
+			OutSlotNames[PolygonGroupIDs[PolygonGroupID]] = InSlotNames[PolygonGroupID];
+		}
+	}
+
+	TMeshAttributesRef<FVector> OutVertexPositions = OutReducedMesh.VertexAttributes().GetAttributesRef<FVector>(MeshAttribute::Vertex::Position);
+	TVertexInstanceAttributeCopy<FVector> NormalCopy(OutReducedMesh, InMesh, MeshAttribute::VertexInstance::Normal);
+	TVertexInstanceAttributeCopy<FVector> TangentCopy(OutReducedMesh, InMesh, MeshAttribute::VertexInstance::Tangent);
+	TVertexInstanceAttributeCopy<float> BinormalSignCopy(OutReducedMesh, InMesh, MeshAttribute::VertexInstance::BinormalSign);
+	TVertexInstanceAttributeCopy<Vector4> ColorCopy(OutReducedMesh, InMesh, MeshAttribute::VertexInstance::Color);
+	TVertexInstanceAttributeCopy<Vector2> UVCopy(OutReducedMesh, InMesh, MeshAttribute::VertexInstance::TextureCoordinate);
+	std::vector<MeshDescription::ContourPoint> Contour(3);
+	std::vector<int> OutVertexIDs(VertexIDs.size(), INDEX_NONE);
+	std::vector<int> OutVertexInstanceIDs(WedgeVertexInstances.size(), INDEX_NONE);
+	uint32 NumVertices = 0;
+	for (uint32 Triangle = 0; Triangle < (uint32)Collapser.TriangleAlive.size(); ++Triangle)
+	{
+		if (!Collapser.TriangleAlive[Triangle])
+		{
+			continue;
+		}
+
+		int CornerVertexIDs[3];
+		int CornerVertexInstanceIDs[3];
+		for (uint32 Corner = 0; Corner < 3; ++Corner)
+		{
+			const uint32 Wedge = Collapser.GetWedge(Triangle, Corner);
+			const uint32 VertexIndex = Collapser.WedgeVertices[Wedge];
+			if (OutVertexIDs[VertexIndex] == INDEX_NONE)
+			{
+				OutVertexIDs[VertexIndex] = OutReducedMesh.CreateVertex();
+				OutVertexPositions[OutVertexIDs[VertexIndex]] = Collapser.Positions[VertexIndex];
+				NumVertices++;
+			}
+			if (OutVertexInstanceIDs[Wedge] == INDEX_NONE)
+			{
+				const int VertexInstanceID = OutReducedMesh.CreateVertexInstance(OutVertexIDs[VertexIndex]);
+				const int SourceVertexInstanceID = WedgeVertexInstances[Wedge];
+				NormalCopy.Copy(VertexInstanceID, SourceVertexInstanceID);
+				TangentCopy.Copy(VertexInstanceID, SourceVertexInstanceID);
+				BinormalSignCopy.Copy(VertexInstanceID, SourceVertexInstanceID);
+				ColorCopy.Copy(VertexInstanceID, SourceVertexInstanceID);
+				UVCopy.Copy(VertexInstanceID, SourceVertexInstanceID);
+				OutVertexInstanceIDs[Wedge] = VertexInstanceID;
+			}
+			CornerVertexIDs[Corner] = OutVertexIDs[VertexIndex];
+			CornerVertexInstanceIDs[Corner] = OutVertexInstanceIDs[Wedge];
+		}
+
+		for (uint32 Corner = 0; Corner < 3; ++Corner)
+		{
+			const int VertexID0 = CornerVertexIDs[Corner];
+			const int VertexID1 = CornerVertexIDs[(Corner + 1) % 3];
+			int EdgeID = OutReducedMesh.GetVertexPairEdge(VertexID0, VertexID1);
+			if (EdgeID == -1)
+			{
+				EdgeID = OutReducedMesh.CreateEdge(VertexID0, VertexID1);
+			}
+			Contour[Corner].VertexInstanceID = CornerVertexInstanceIDs[Corner];
+			Contour[Corner].EdgeID = EdgeID;
+		}
+		const int PolygonGroupID = WedgePolygonGroups[Collapser.GetWedge(Triangle, 0)];
+		OutReducedMesh.CreatePolygon(PolygonGroupIDs[PolygonGroupID], Contour);
+	}
+	MeshDescriptionOperations::ComputePolygonTriangulations(OutReducedMesh);
+
+	OutStatistics.NumSourceTriangles = NumSourceTriangles;
+	OutStatistics.NumTriangles = Collapser.NumAliveTriangles;
+	OutStatistics.NumSourceVertices = (uint32)VertexIDs.size();
+	OutStatistics.NumVertices = NumVertices;
+	OutStatistics.MaxDeviation = (float)FMath::Sqrt((float)MaxError);
+}
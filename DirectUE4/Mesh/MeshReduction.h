@@ -0,0 +1,46 @@
+#pragma once
+
+#include "UnrealMath.h"
+
+class MeshDescription;
+
+/** How far ReduceMeshDescription simplifies a mesh */
+struct FMeshReductionSettings
+{
+	/** Fraction of the source triangles to keep, 1 keeps the mesh as it is */
+	float PercentTriangles = 1.f;
+	/** Collapses that would move the surface further than this, in mesh units, are not done even if more triangles should go */
+	float MaxDeviation = FLT_MAX;
+};
+
+/** What ReduceMeshDescription did */
+struct FMeshReductionStatistics
+{
+	uint32 NumSourceTriangles = 0;
+	uint32 NumTriangles = 0;
+	uint32 NumSourceVertices = 0;
+	uint32 NumVertices = 0;
+	/**
+	 * Largest quadric error of a collapse as a distance in mesh units: the root of the area weighted mean squared distance
+	 * of the moved vertex to the planes of the source triangles it stands for.
+	 */
+	float MaxDeviation = 0.f;
+};
+
+/**
+ * Quadric error metric edge collapse simplification (Garland and Heckbert, "Surface Simplification Using Quadric Error
+ * Metrics") of the triangles of a MeshDescription, used to generate static mesh LODs.
+ */
+namespace MeshReduction
+{
+	/**
+	 * Collapses edges of InMesh, cheapest first, until Settings.PercentTriangles of its triangles are left.
+	 * Vertices only ever move onto a neighbour (half edge collapses), so the vertex instances that are left keep their normals,
+	 * tangents, colors and texture coordinates as they are. Corners of a vertex whose attributes or polygon group differ,
+	 * UV seams, hard edges and material boundaries, may only collapse along that boundary onto the matching corners of the
+	 * neighbour, and open borders and those boundaries carry extra quadrics against moving off them.
+	 * @param OutReducedMesh - replaced by the reduced mesh, with the attributes InMesh registers, the polygon groups of InMesh and triangulated polygons
+	 * @param InMesh - triangulated source mesh
+	 */
+	void ReduceMeshDescription(MeshDescription& OutReducedMesh, FMeshReductionStatistics& OutStatistics, const MeshDescription& InMesh, const FMeshReductionSettings& Settings);
+}
@@ -2,7 +2,7 @@
 
 void FMultiSizeIndexContainer::InitResources()
 {
-	IndexBufferRHI = CreateIndexBuffer(IndexBuffer.data(), IndexBuffer.size() * sizeof(uint32));
+	IndexBufferRHI = CreateIndexBuffer(IndexBuffer.data(), IndexBuffer.size());
 }
 
 void FMultiSizeIndexContainer::ReleaseResources()
@@ -12,6 +12,6 @@ void FMultiSizeIndexContainer::ReleaseResources()
 
 void FMultiSizeIndexContainer::RebuildIndexBuffer(uint8 InDataTypeSize, const std::vector<uint32>& NewArray)
 {
-	IndexBuffer = NewArray;
-}
-
+	DataTypeSize = InDataTypeSize;
+	PackIndices(DataTypeSize, NewArray, IndexBuffer);
+}
\ No newline at end of file
@@ -1,17 +1,44 @@
 #pragma once
 
 #include "D3D11RHI.h"
+#include "PackedIndexBuffer.h"
 
 #include <vector>
 
 class FMultiSizeIndexContainer
 {
 public:
+	FMultiSizeIndexContainer()
+		: DataTypeSize(sizeof(uint32))
+	{}
+
 	void InitResources();
 	void ReleaseResources();
 
+	/**
+	 * Stores NewArray with InDataTypeSize bytes per index.
+	 * @param InDataTypeSize - sizeof(uint16) or sizeof(uint32), every index has to fit the former
+	 */
 	void RebuildIndexBuffer(uint8 InDataTypeSize, const std::vector<uint32>& NewArray);
 
+	uint8 GetDataTypeSize() const
+	{
+		return DataTypeSize;
+	}
+	DXGI_FORMAT GetIndexFormat() const
+	{
+		return DataTypeSize == sizeof(uint16) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+	}
+	uint32 GetNumIndices() const
+	{
+		return (uint32)IndexBuffer.size() / DataTypeSize;
+	}
+	/** Bytes the indices take on the GPU */
+	uint32 GetAllocatedSize() const
+	{
+		return (uint32)IndexBuffer.size();
+	}
+
 	ID3D11Buffer* GetIndexBuffer()
 	{
 		assert(IndexBufferRHI.Get() != NULL);
@@ -23,6 +50,8 @@ public:
 		return IndexBufferRHI.Get();
 	}
 private:
-	std::vector<uint32> IndexBuffer;
+	/** Indices as the GPU reads them, DataTypeSize bytes each */
+	std::vector<uint8> IndexBuffer;
+	uint8 DataTypeSize;
 	ComPtr<ID3D11Buffer> IndexBufferRHI;
 };
\ No newline at end of file
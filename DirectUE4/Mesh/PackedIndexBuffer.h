@@ -0,0 +1,45 @@
+#pragma once
+
+#include "UnrealMath.h"
+
+#include <vector>
+#include <string.h>
+#include <assert.h>
+
+/**
+ * Bytes per index of a buffer addressing NumVertices vertices: sizeof(uint16) when compact formats are asked for and
+ * every vertex index fits, sizeof(uint32) otherwise.
+ */
+inline uint8 ChooseIndexDataTypeSize(size_t NumVertices, bool bCompact)
+{
+	return (bCompact && NumVertices <= (size_t)MAX_uint16 + 1) ? sizeof(uint16) : sizeof(uint32);
+}
+
+/**
+ * Stores Indices as the GPU reads them, DataTypeSize bytes each.
+ * @param DataTypeSize - sizeof(uint16) or sizeof(uint32), every index has to fit the former
+ */
+inline void PackIndices(uint8 DataTypeSize, const std::vector<uint32>& Indices, std::vector<uint8>& OutBuffer)
+{
+	assert(DataTypeSize == sizeof(uint16) || DataTypeSize == sizeof(uint32));
+	OutBuffer.resize(Indices.size() * DataTypeSize);
+	if (DataTypeSize == sizeof(uint16))
+	{
+		uint16* Indices16 = (uint16*)OutBuffer.data();
+		for (size_t Index = 0; Index < Indices.size(); ++Index)
+		{
+			assert(Indices[Index] <= MAX_uint16);
+			Indices16[Index] = (uint16)Indices[Index];
+		}
+	}
+	else if (!Indices.empty())
+	{
+		memcpy(OutBuffer.data(), Indices.data(), Indices.size() * sizeof(uint32));
+	}
+}
+
+/** @return index Index of a buffer PackIndices wrote with DataTypeSize */
+inline uint32 GetPackedIndex(uint8 DataTypeSize, const std::vector<uint8>& Buffer, size_t Index)
+{
+	return DataTypeSize == sizeof(uint16) ? ((const uint16*)Buffer.data())[Index] : ((const uint32*)Buffer.data())[Index];
+}
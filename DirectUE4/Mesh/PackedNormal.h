@@ -0,0 +1,57 @@
+#pragma once
+
+#include "UnrealMath.h"
+
+/**
+ * A tangent frame axis quantized to 8-bit SNORM, read back by the GPU as DXGI_FORMAT_R8G8B8A8_SNORM.
+ * W carries the basis determinant sign for TangentZ, it is exactly -1 or 1 after a round trip.
+ */
+struct FPackedTangent
+{
+	int8 X;
+	int8 Y;
+	int8 Z;
+	int8 W;
+
+	/** Largest error of a component in [-1,1] after a round trip, half a quantization step */
+	static constexpr float MaxComponentError = 0.5f / 127.f;
+
+	FPackedTangent() : X(0), Y(0), Z(0), W(0) {}
+	FPackedTangent(const Vector4& V) : X(Quantize(V.X)), Y(Quantize(V.Y)), Z(Quantize(V.Z)), W(Quantize(V.W)) {}
+
+	/** Same decode as the GPU, -128 never occurs so every value maps back to c / 127 */
+	Vector4 ToVector4() const
+	{
+		return Vector4(X / 127.f, Y / 127.f, Z / 127.f, W / 127.f);
+	}
+
+private:
+	static int8 Quantize(float Value)
+	{
+		return (int8)FMath::RoundToInt(FMath::Clamp(Value, -1.f, 1.f) * 127.f);
+	}
+};
+
+/** A texture coordinate stored as two halfs, read back by the GPU as DXGI_FORMAT_R16G16_FLOAT */
+struct FVector2DHalf
+{
+	FFloat16 X;
+	FFloat16 Y;
+
+	FVector2DHalf() {}
+	FVector2DHalf(const Vector2& V) : X(V.X), Y(V.Y) {}
+
+	Vector2 ToVector2() const
+	{
+		return Vector2(X.GetFloat(), Y.GetFloat());
+	}
+
+	/**
+	 * Largest error of a coordinate after a round trip. FFloat16::Set truncates the mantissa to 10 bits, so the relative
+	 * error stays below 2^-10, and values too small for a half end up as denormals or zero. Holds up to 65504.
+	 */
+	static float GetMaxError(float Value)
+	{
+		return FMath::Abs(Value) / 1024.f + 1.f / 16384.f;
+	}
+};
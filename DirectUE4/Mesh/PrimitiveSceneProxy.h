@@ -17,6 +17,7 @@ class AActor;
 class FSceneView;
 class FSceneViewFamily;
 class FMeshElementCollector;
+class FOccluderElementsCollector;
 
 
 class FPrimitiveComponentId
@@ -105,11 +106,20 @@ public:
 	inline const bool ReceivesDecals() const { return bReceivesDecals; }
 
 	virtual void DrawStaticElements(FPrimitiveSceneInfo* PrimitiveSceneInfo/*FStaticPrimitiveDrawInterface* PDI*/) {};
+
+	/** LOD of the static meshes to draw in View, INDEX_NONE draws all of them */
+	virtual int32 GetLOD(const FSceneView* View) const { return INDEX_NONE; }
 	
 	virtual void GetDynamicMeshElements(const std::vector<const FSceneView*>& Views, const FSceneViewFamily& ViewFamily, uint32 VisibilityMap, class FMeshElementCollector& Collector) const {}
 
 	virtual FPrimitiveViewRelevance GetViewRelevance(const FSceneView* View) const;
 
+	/**
+	 * Adds the triangles the primitive hides what is behind it with to Collector, for software occlusion culling.
+	 * @return the number of triangles added, primitives that add none are never occluders
+	 */
+	virtual int32 CollectOccluderElements(FOccluderElementsCollector& Collector) const { return 0; }
+
 	virtual void GetLightRelevance(const FLightSceneProxy* LightSceneProxy, bool& bDynamic, bool& bRelevant, bool& bLightMapped, bool& bShadowMapped) const
 	{
 		// Determine the lights relevance to the primitive.
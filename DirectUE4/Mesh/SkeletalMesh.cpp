@@ -135,6 +135,113 @@ void USkeletalMesh::ResetLODInfo()
 	LODInfo.clear();
 }
 
+void USkeletalMesh::AddBoneReductionLOD(const FSkeletalMeshLODInfo& InLODInfo)
+{
+	SkeletalMeshModel* Model = GetImportedModel();
+	assert(Model->LODModels.size() > 0);
+	assert(RenderdData == nullptr);
+
+	const int32 NumBones = RefSkeleton.GetRawBoneNum();
+
+	// parents always come before their children, so a single pass marks whole sub trees
+	std::vector<bool> BoneRemoved(NumBones, false);
+	for (const std::string& BoneName : InLODInfo.BonesToRemove)
+	{
+		const int32 BoneIndex = RefSkeleton.FindBoneIndex(BoneName);
+		if (BoneIndex > 0)
+		{
+			BoneRemoved[BoneIndex] = true;
+		}
+		else if (BoneIndex == INDEX_NONE)
+		{
+			X_LOG("AddBoneReductionLOD: bone (%s) not found\n", BoneName.c_str());
+		}
+	}
+
+	std::map<FBoneIndexType, FBoneIndexType> BonesToRemove;
+	for (int32 BoneIndex = 1; BoneIndex < NumBones; BoneIndex++)
+	{
+		const int32 ParentIndex = RefSkeleton.GetParentIndex(BoneIndex);
+		BoneRemoved[BoneIndex] = BoneRemoved[BoneIndex] || BoneRemoved[ParentIndex];
+		if (BoneRemoved[BoneIndex])
+		{
+			// weld to the closest parent that is kept
+			auto ParentIt = BonesToRemove.find((FBoneIndexType)ParentIndex);
+			BonesToRemove[(FBoneIndexType)BoneIndex] = ParentIt != BonesToRemove.end() ? ParentIt->second : (FBoneIndexType)ParentIndex;
+		}
+	}
+
+	// vertices of removed bones now follow the kept parent, no vertex data has to change:
+	// the LOD draws the buffers of LOD 0 and only carries its own sections with remapped bone maps
+	const FSkeletalMeshLODModel& BaseLODModel = *Model->LODModels[0];
+	FSkeletalMeshLODModel* NewLODModel = new FSkeletalMeshLODModel();
+	NewLODModel->SharedGeometryLODIndex = 0;
+	NewLODModel->NumVertices = BaseLODModel.NumVertices;
+	NewLODModel->NumTexCoords = BaseLODModel.NumTexCoords;
+	NewLODModel->MaxImportVertex = BaseLODModel.MaxImportVertex;
+	NewLODModel->Sections.resize(BaseLODModel.Sections.size());
+	for (uint32 SectionIndex = 0; SectionIndex < BaseLODModel.Sections.size(); SectionIndex++)
+	{
+		const FSkeletalMeshSection& BaseSection = BaseLODModel.Sections[SectionIndex];
+		FSkeletalMeshSection& Section = NewLODModel->Sections[SectionIndex];
+		Section.MaterialIndex = BaseSection.MaterialIndex;
+		Section.BaseIndex = BaseSection.BaseIndex;
+		Section.NumTriangles = BaseSection.NumTriangles;
+		Section.BaseVertexIndex = BaseSection.BaseVertexIndex;
+		Section.bCastShadow = BaseSection.bCastShadow;
+		Section.BoneMap = BaseSection.BoneMap;
+		Section.NumVertices = BaseSection.NumVertices;
+		Section.MaxBoneInfluences = BaseSection.MaxBoneInfluences;
+	}
+
+	NewLODModel->ActiveBoneIndices.clear();
+	for (FSkeletalMeshSection& Section : NewLODModel->Sections)
+	{
+		for (FBoneIndexType& BoneIndex : Section.BoneMap)
+		{
+			auto It = BonesToRemove.find(BoneIndex);
+			if (It != BonesToRemove.end())
+			{
+				BoneIndex = It->second;
+			}
+			AddUnique(NewLODModel->ActiveBoneIndices, BoneIndex);
+		}
+	}
+	RefSkeleton.EnsureParentsExistAndSort(NewLODModel->ActiveBoneIndices);
+
+	CalculateRequiredBones(*NewLODModel, RefSkeleton, &BonesToRemove);
+
+	Model->LODModels.push_back(NewLODModel);
+	AddLODInfo(InLODInfo);
+}
+
+void USkeletalMesh::AddLeafBoneReductionLODs(const std::vector<float>& ScreenSizes)
+{
+	const int32 NumBones = RefSkeleton.GetRawBoneNum();
+
+	// height of a bone is the length of the longest chain below it, leaves are 0
+	std::vector<int32> BoneHeights(NumBones, 0);
+	for (int32 BoneIndex = NumBones - 1; BoneIndex > 0; BoneIndex--)
+	{
+		const int32 ParentIndex = RefSkeleton.GetParentIndex(BoneIndex);
+		BoneHeights[ParentIndex] = FMath::Max(BoneHeights[ParentIndex], BoneHeights[BoneIndex] + 1);
+	}
+
+	for (uint32 Index = 0; Index < ScreenSizes.size(); Index++)
+	{
+		FSkeletalMeshLODInfo NewLODInfo;
+		NewLODInfo.ScreenSize = ScreenSizes[Index];
+		for (int32 BoneIndex = 1; BoneIndex < NumBones; BoneIndex++)
+		{
+			if (BoneHeights[BoneIndex] <= (int32)Index)
+			{
+				NewLODInfo.BonesToRemove.push_back(RefSkeleton.GetBoneName(BoneIndex));
+			}
+		}
+		AddBoneReductionLOD(NewLODInfo);
+	}
+}
+
 void USkeletalMesh::CacheDerivedData()
 {
 	AllocateResourceForRendering();
@@ -299,7 +406,8 @@ void FSkeletalMeshSceneProxy::GetDynamicElementsSection(
 			Mesh.bSelectable = bInSelectable;
 			BatchElement.FirstIndex = Section.BaseIndex;
 
-			BatchElement.IndexBuffer = LODData.MultiSizeIndexContainer.GetIndexBuffer();
+			BatchElement.IndexBuffer = LODData.GetGeometry().MultiSizeIndexContainer.GetIndexBuffer();
+			BatchElement.IndexBufferFormat = LODData.GetGeometry().MultiSizeIndexContainer.GetIndexFormat();
 			BatchElement.MaxVertexIndex = LODData.GetNumVertices() - 1;
 			//BatchElement.VertexFactoryUserData = FGPUSkinCache::GetFactoryUserData(MeshObject->SkinCacheEntry, SectionIndex);
 
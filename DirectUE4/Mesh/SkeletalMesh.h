@@ -10,8 +10,22 @@
 
 class Skeleton;
 
-struct FSkeletalMeshLODInfo
+struct FSkeletalMeshLODInfo
 {
+	/**
+	* ScreenSize to display this LOD.
+	* The screen size is based around the projected diameter of the bounding
+	* sphere of the model. i.e. 0.5 means half the screen's maximum dimension.
+	*/
+	float ScreenSize;
+
+	/** Bones which should be removed from the skeleton for this LOD, together with all of their children */
+	std::vector<std::string> BonesToRemove;
+
+	FSkeletalMeshLODInfo()
+		: ScreenSize(1.0f)
+	{
+	}
 };
 
 struct FSkeletalMaterial
@@ -68,9 +82,22 @@ public:
 	std::vector<FSkeletalMeshLODInfo>& GetLODInfoArray() { return LODInfo; }
 	FSkeletalMeshLODInfo* GetLODInfo(int32 Index) { return IsValidIndex(LODInfo,Index) ? &LODInfo[Index] : nullptr; }
 	const FSkeletalMeshLODInfo* GetLODInfo(int32 Index) const { return IsValidIndex(LODInfo,Index) ? &LODInfo[Index] : nullptr; }
-	bool IsValidLODIndex(int32 Index) const { return IsValidIndex(LODInfo, Index); }
+	bool IsValidLODIndex(int32 Index) const { return IsValidIndex(LODInfo, Index); }
 	uint32 GetLODNum() const { return LODInfo.size(); }
 
+	/**
+	* Adds a LOD that reuses the LOD 0 geometry but skins the bones in InLODInfo.BonesToRemove, and their children, with their
+	* closest kept parent. Those bones are dropped from the LOD's required bones so they are neither evaluated nor
+	* uploaded. Has to be called before PostLoad builds the render data.
+	*/
+	void AddBoneReductionLOD(const FSkeletalMeshLODInfo& InLODInfo);
+
+	/**
+	* Adds one bone reduction LOD per entry of ScreenSizes, each one removing one more layer of leaf bones than the
+	* previous (finger tips first, then the next finger joints, twist and IK bones, ...). The root is never removed.
+	*/
+	void AddLeafBoneReductionLODs(const std::vector<float>& ScreenSizes);
+
 	std::vector<FMatrix> RefBasesInvMatrix;
 
 	std::vector<FSkeletalMaterial> Materials;
@@ -88,6 +88,12 @@ public:
 	std::vector<int32>			MeshToImportVertexMap;
 	int32						MaxImportVertex;
 
+	/**
+	* Bone reduction LODs keep no vertices or indices of their own and draw the geometry of this LOD,
+	* only their sections' BoneMap, ActiveBoneIndices and RequiredBones differ. INDEX_NONE if the LOD owns its geometry.
+	*/
+	int32						SharedGeometryLODIndex = INDEX_NONE;
+
 	void GetVertices(std::vector<FSoftSkinVertex>& Vertices) const;
 
 	bool DoSectionsNeedExtraBoneInfluences() const;
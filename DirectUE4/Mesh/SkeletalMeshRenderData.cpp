@@ -1,6 +1,7 @@
 #include "SkeletalMeshRenderData.h"
 #include "SkeletalMeshModel.h"
 #include "SkeletalMesh.h"
+#include "log.h"
 
 struct ESkeletalMeshVertexFlags
 {
@@ -17,19 +18,15 @@ struct ESkeletalMeshVertexFlags
 void FSkeletalMeshLODRenderData::InitResources()
 {
 	StaticVertexBuffers.PositionVertexBufferRHI = CreateVertexBuffer(false, StaticVertexBuffers.PositionVertexBuffer.size() * sizeof(FVector), StaticVertexBuffers.PositionVertexBuffer.data());
-	StaticVertexBuffers.TangentsVertexBufferRHI = CreateVertexBuffer(false, StaticVertexBuffers.TangentsVertexBuffer.size() * sizeof(Vector4), StaticVertexBuffers.TangentsVertexBuffer.data());
-	StaticVertexBuffers.TexCoordVertexBufferRHI = CreateVertexBuffer(false, StaticVertexBuffers.TexCoordVertexBuffer.size() * sizeof(Vector2), StaticVertexBuffers.TexCoordVertexBuffer.data());
+	StaticVertexBuffers.TangentsVertexBufferRHI = CreateVertexBuffer(false, StaticVertexBuffers.GetTangentDataSize(), const_cast<void*>(StaticVertexBuffers.GetTangentData()));
+	StaticVertexBuffers.TexCoordVertexBufferRHI = CreateVertexBuffer(false, StaticVertexBuffers.GetTexCoordDataSize(), const_cast<void*>(StaticVertexBuffers.GetTexCoordData()));
 
 	SkinWeightVertexBuffer.InitResources();
 	MultiSizeIndexContainer.InitResources();
 }
 
-void FSkeletalMeshLODRenderData::BuildFromLODModel(const FSkeletalMeshLODModel* ImportedModel,uint32 BuildFlags)
+void FSkeletalMeshLODRenderData::BuildRenderSections(const FSkeletalMeshLODModel* ImportedModel)
 {
-	bool bUseFullPrecisionUVs = (BuildFlags & ESkeletalMeshVertexFlags::UseFullPrecisionUVs) != 0;
-	bool bUseHighPrecisionTangentBasis = (BuildFlags & ESkeletalMeshVertexFlags::UseHighPrecisionTangentBasis) != 0;
-	bool bHasVertexColors = (BuildFlags & ESkeletalMeshVertexFlags::HasVertexColors) != 0;
-
 	// Copy required info from source sections
 	RenderSections.clear();
 	for (uint32 SectionIndex = 0; SectionIndex < ImportedModel->Sections.size(); SectionIndex++)
@@ -53,6 +50,15 @@ void FSkeletalMeshLODRenderData::BuildFromLODModel(const FSkeletalMeshLODModel*
 		//NewRenderSection.bDisabled = ModelSection.bDisabled;
 		RenderSections.push_back(NewRenderSection);
 	}
+}
+
+void FSkeletalMeshLODRenderData::BuildFromLODModel(const FSkeletalMeshLODModel* ImportedModel,uint32 BuildFlags)
+{
+	bool bUseFullPrecisionUVs = (BuildFlags & ESkeletalMeshVertexFlags::UseFullPrecisionUVs) != 0;
+	bool bUseHighPrecisionTangentBasis = (BuildFlags & ESkeletalMeshVertexFlags::UseHighPrecisionTangentBasis) != 0;
+	bool bHasVertexColors = (BuildFlags & ESkeletalMeshVertexFlags::HasVertexColors) != 0;
+
+	BuildRenderSections(ImportedModel);
 
 	std::vector<FSoftSkinVertex> Vertices;
 	ImportedModel->GetVertices(Vertices);
@@ -78,6 +84,14 @@ void FSkeletalMeshLODRenderData::BuildFromLODModel(const FSkeletalMeshLODModel*
 			StaticVertexBuffers.TexCoordVertexBuffer[i*ImportedModel->NumTexCoords+j] = Vertices[i].UVs[j];
 		}
 	}
+	if (!bUseHighPrecisionTangentBasis)
+	{
+		StaticVertexBuffers.PackTangents();
+	}
+	if (!bUseFullPrecisionUVs)
+	{
+		StaticVertexBuffers.PackTexCoords();
+	}
 
 	// Init skin weight buffer
 	//SkinWeightVertexBuffer.SetNeedsCPUAccess(true);
@@ -103,9 +117,9 @@ void FSkeletalMeshLODRenderData::BuildFromLODModel(const FSkeletalMeshLODModel*
 // 		ClothVertexBuffer.Init(MappingData, ClothIndexMapping);
 // 	}
 
-	//const uint8 DataTypeSize = (ImportedModel->NumVertices < MAX_uint16) ? sizeof(uint16) : sizeof(uint32);
+	const uint8 DataTypeSize = ChooseIndexDataTypeSize(Vertices.size(), GCompactMeshVertexFormats);
 
-	MultiSizeIndexContainer.RebuildIndexBuffer(sizeof(uint32), ImportedModel->IndexBuffer);
+	MultiSizeIndexContainer.RebuildIndexBuffer(DataTypeSize, ImportedModel->IndexBuffer);
 
 	//TArray<uint32> BuiltAdjacencyIndices;
 	//IMeshUtilities& MeshUtilities = FModuleManager::Get().LoadModuleChecked<IMeshUtilities>("MeshUtilities");
@@ -116,6 +130,23 @@ void FSkeletalMeshLODRenderData::BuildFromLODModel(const FSkeletalMeshLODModel*
 
 	ActiveBoneIndices = ImportedModel->ActiveBoneIndices;
 	RequiredBones = ImportedModel->RequiredBones;
+
+	const uint32 NumIndices = MultiSizeIndexContainer.GetNumIndices();
+	const uint32 FullSize = StaticVertexBuffers.GetAllocatedSize(true) + NumIndices * sizeof(uint32);
+	const uint32 CompactSize = StaticVertexBuffers.GetAllocatedSize() + MultiSizeIndexContainer.GetAllocatedSize();
+	X_LOG("Skeletal mesh LOD: %u vertices, %u indices, GPU buffers %u -> %u bytes (%.1f%% saved), skin weights %u bytes\n", GetNumVertices(), NumIndices,
+		FullSize, CompactSize, FullSize ? 100.f * (float)(FullSize - CompactSize) / (float)FullSize : 0.f, SkinWeightVertexBuffer.GetAllocatedSize());
+}
+
+void FSkeletalMeshLODRenderData::BuildFromSharedLODModel(const FSkeletalMeshLODModel* ImportedModel, FSkeletalMeshLODRenderData* InSharedGeometry)
+{
+	assert(InSharedGeometry && !InSharedGeometry->SharedGeometry);
+	SharedGeometry = InSharedGeometry;
+
+	BuildRenderSections(ImportedModel);
+
+	ActiveBoneIndices = ImportedModel->ActiveBoneIndices;
+	RequiredBones = ImportedModel->RequiredBones;
 }
 
 void FSkeletalMeshRenderData::InitResources(/*bool bNeedsVertexColors, TArray<UMorphTarget*>& InMorphTargets*/)
@@ -124,7 +155,8 @@ void FSkeletalMeshRenderData::InitResources(/*bool bNeedsVertexColors, TArray<UM
 	{
 		FSkeletalMeshLODRenderData& RenderData = *LODRenderData[LODIndex];
 
-		if (RenderData.GetNumVertices() > 0)
+		// shared buffers are created once, by the LOD that owns them
+		if (!RenderData.SharedGeometry && RenderData.GetNumVertices() > 0)
 		{
 			RenderData.InitResources(/*bNeedsVertexColors, LODIndex, InMorphTargets*/);
 		}
@@ -137,12 +169,24 @@ void FSkeletalMeshRenderData::Cache(USkeletalMesh* Owner)
 
 	//uint32 VertexBufferBuildFlags = Owner->GetVertexBufferFlags();
 	uint32 VertexBufferBuildFlags = 0;
+	if (!GCompactMeshVertexFormats)
+	{
+		VertexBufferBuildFlags |= ESkeletalMeshVertexFlags::UseFullPrecisionUVs | ESkeletalMeshVertexFlags::UseHighPrecisionTangentBasis;
+	}
 	for (uint32 LODIndex = 0; LODIndex < SkelMeshModel->LODModels.size(); LODIndex++)
 	{
 		FSkeletalMeshLODModel& LODModel = *SkelMeshModel->LODModels[LODIndex];
 		FSkeletalMeshLODRenderData* LODData = new FSkeletalMeshLODRenderData();
 		LODRenderData.push_back(LODData);
-		LODData->BuildFromLODModel(&LODModel, VertexBufferBuildFlags);
+		if (LODModel.SharedGeometryLODIndex != INDEX_NONE)
+		{
+			assert(LODModel.SharedGeometryLODIndex < (int32)LODIndex);
+			LODData->BuildFromSharedLODModel(&LODModel, LODRenderData[LODModel.SharedGeometryLODIndex]);
+		}
+		else
+		{
+			LODData->BuildFromLODModel(&LODModel, VertexBufferBuildFlags);
+		}
 	}
 }
 
@@ -41,13 +41,25 @@ public:
 
 	void BuildFromLODModel(const FSkeletalMeshLODModel* LODModel,uint32 BuildFlags);
 
+	/** Builds a LOD that draws the buffers of InSharedGeometry, only the sections and bone lists come from LODModel */
+	void BuildFromSharedLODModel(const FSkeletalMeshLODModel* LODModel, FSkeletalMeshLODRenderData* InSharedGeometry);
+
+	/** The LOD whose vertex and index buffers this LOD draws, itself unless it is a bone reduction LOD */
+	FSkeletalMeshLODRenderData& GetGeometry() { return SharedGeometry ? *SharedGeometry : *this; }
+	const FSkeletalMeshLODRenderData& GetGeometry() const { return SharedGeometry ? *SharedGeometry : *this; }
+
 	uint32 GetNumVertices() const
 	{
-		return StaticVertexBuffers.PositionVertexBuffer.size();
+		return GetGeometry().StaticVertexBuffers.PositionVertexBuffer.size();
 	}
 
 	std::vector<FBoneIndexType> ActiveBoneIndices;
 	std::vector<FBoneIndexType> RequiredBones;
+
+	FSkeletalMeshLODRenderData* SharedGeometry = nullptr;
+
+private:
+	void BuildRenderSections(const FSkeletalMeshLODModel* LODModel);
 };
 
 class FSkeletalMeshRenderData
@@ -0,0 +1,441 @@
+#include "SkeletalMeshTools.h"
+#include "UnrealTemplates.h"
+#include "MeshDescriptionOperations.h"
+#include "ParallelFor.h"
+
+#include <algorithm>
+
+bool SkeletalMeshTools::AreSkelMeshVerticesEqual(const FSoftSkinBuildVertex& V1, const FSoftSkinBuildVertex& V2, const FOverlappingThresholds& OverlappingThresholds)
+{
+	if (!PointsEqual(V1.Position, V2.Position, OverlappingThresholds))
+	{
+		return false;
+	}
+
+	for (int32 UVIdx = 0; UVIdx < 4/*MAX_TEXCOORDS*/; ++UVIdx)
+	{
+		if (!UVsEqual(V1.UVs[UVIdx], V2.UVs[UVIdx], OverlappingThresholds))
+		{
+			return false;
+		}
+	}
+
+	if (!NormalsEqual(V1.TangentX, V2.TangentX, OverlappingThresholds))
+	{
+		return false;
+	}
+
+	if (!NormalsEqual(V1.TangentY, V2.TangentY, OverlappingThresholds))
+	{
+		return false;
+	}
+
+	if (!NormalsEqual(V1.TangentZ, V2.TangentZ, OverlappingThresholds))
+	{
+		return false;
+	}
+
+	bool	InfluencesMatch = 1;
+	for (uint32 InfluenceIndex = 0; InfluenceIndex < MAX_TOTAL_INFLUENCES; InfluenceIndex++)
+	{
+		if (V1.InfluenceBones[InfluenceIndex] != V2.InfluenceBones[InfluenceIndex] ||
+			V1.InfluenceWeights[InfluenceIndex] != V2.InfluenceWeights[InfluenceIndex])
+		{
+			InfluencesMatch = 0;
+			break;
+		}
+	}
+
+	if (V1.Color != V2.Color)
+	{
+		return false;
+	}
+
+	if (!InfluencesMatch)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+/**
+* Raw skeletal mesh vertices bucketed by chunk and by a grid of cells twice the position threshold wide, so every vertex
+* of the same chunk within the threshold of a position is in the cell of that position or one of the 26 around it.
+* Only read once built, so any number of threads can search it.
+*/
+class FSkeletalMeshVertexGrid
+{
+public:
+	FSkeletalMeshVertexGrid(const std::vector<FSoftSkinBuildVertex>& RawVertices, const std::vector<int32>& VertexChunks, float ThresholdPosition)
+		: InvCellSize(1.f / FMath::Max(ThresholdPosition * 2.f, KINDA_SMALL_NUMBER))
+	{
+		const int32 NumVertices = (int32)RawVertices.size();
+		std::vector<FCellKey> VertexKeys(NumVertices);
+		ParallelFor(NumVertices, [&](int32 VertexIndex)
+		{
+			VertexKeys[VertexIndex] = MakeKey(VertexChunks[VertexIndex], RawVertices[VertexIndex].Position, 0, 0, 0);
+		}, !GParallelMeshBuild);
+
+		uint32 NumSlots = 16;
+		while (NumSlots < (uint32)NumVertices * 2)
+		{
+			NumSlots *= 2;
+		}
+		Slots.assign(NumSlots, INDEX_NONE);
+
+		// cells numbered in order of their first vertex, vertices listed per cell in ascending order
+		std::vector<int32> VertexCells(NumVertices);
+		for (int32 VertexIndex = 0; VertexIndex < NumVertices; ++VertexIndex)
+		{
+			const FCellKey& Key = VertexKeys[VertexIndex];
+			const uint32 Mask = NumSlots - 1;
+			uint32 Slot = HashKey(Key) & Mask;
+			while (Slots[Slot] != INDEX_NONE && !(CellKeys[Slots[Slot]] == Key))
+			{
+				Slot = (Slot + 1) & Mask;
+			}
+			if (Slots[Slot] == INDEX_NONE)
+			{
+				Slots[Slot] = (int32)CellKeys.size();
+				CellKeys.push_back(Key);
+				CellStarts.push_back(0);
+			}
+			VertexCells[VertexIndex] = Slots[Slot];
+			CellStarts[Slots[Slot]]++;
+		}
+		int32 NumCellVertices = 0;
+		for (int32& CellStart : CellStarts)
+		{
+			const int32 NumInCell = CellStart;
+			CellStart = NumCellVertices;
+			NumCellVertices += NumInCell;
+		}
+		CellStarts.push_back(NumCellVertices);
+		CellVertices.resize(NumCellVertices);
+		std::vector<int32> CellEnds(CellStarts.begin(), CellStarts.end() - 1);
+		for (int32 VertexIndex = 0; VertexIndex < NumVertices; ++VertexIndex)
+		{
+			CellVertices[CellEnds[VertexCells[VertexIndex]]++] = VertexIndex;
+		}
+	}
+
+	/**
+	* Calls Visitor(VertexIndex) for the vertices of Chunk in the 27 cells around Position, ascending within each cell.
+	* Visitor returning false skips the rest of the current cell only, every other cell is still visited: the cells aren't
+	* in vertex order, so a search for the lowest index stops early within a cell but has to look at all of them.
+	*/
+	template<typename TVisitor>
+	void ForEachNearbyVertex(int32 Chunk, const FVector& Position, TVisitor Visitor) const
+	{
+		const uint32 Mask = (uint32)Slots.size() - 1;
+		for (int32 DX = -1; DX <= 1; ++DX)
+		{
+			for (int32 DY = -1; DY <= 1; ++DY)
+			{
+				for (int32 DZ = -1; DZ <= 1; ++DZ)
+				{
+					const FCellKey Key = MakeKey(Chunk, Position, DX, DY, DZ);
+					for (uint32 Slot = HashKey(Key) & Mask; Slots[Slot] != INDEX_NONE; Slot = (Slot + 1) & Mask)
+					{
+						const int32 Cell = Slots[Slot];
+						if (CellKeys[Cell] == Key)
+						{
+							for (int32 i = CellStarts[Cell]; i < CellStarts[Cell + 1]; ++i)
+							{
+								if (!Visitor(CellVertices[i]))
+								{
+									break;
+								}
+							}
+							break;
+						}
+					}
+				}
+			}
+		}
+	}
+
+private:
+	struct FCellKey
+	{
+		int32 Chunk;
+		int32 X;
+		int32 Y;
+		int32 Z;
+
+		bool operator==(const FCellKey& Other) const { return Chunk == Other.Chunk && X == Other.X && Y == Other.Y && Z == Other.Z; }
+	};
+
+	FCellKey MakeKey(int32 Chunk, const FVector& Position, int32 DX, int32 DY, int32 DZ) const
+	{
+		// clamp so far away positions can't overflow, they only end up sharing cells
+		FCellKey Key;
+		Key.Chunk = Chunk;
+		Key.X = FMath::FloorToInt(FMath::Clamp(Position.X * InvCellSize, -1.0e9f, 1.0e9f)) + DX;
+		Key.Y = FMath::FloorToInt(FMath::Clamp(Position.Y * InvCellSize, -1.0e9f, 1.0e9f)) + DY;
+		Key.Z = FMath::FloorToInt(FMath::Clamp(Position.Z * InvCellSize, -1.0e9f, 1.0e9f)) + DZ;
+		return Key;
+	}
+
+	static uint32 HashKey(const FCellKey& Key)
+	{
+		uint32 Hash = (uint32)Key.Chunk * 0x9E3779B1u;
+		Hash = (Hash ^ (uint32)Key.X) * 0x85EBCA77u;
+		Hash = (Hash ^ (uint32)Key.Y) * 0xC2B2AE3Du;
+		Hash = (Hash ^ (uint32)Key.Z) * 0x27D4EB2Fu;
+		return Hash ^ (Hash >> 15);
+	}
+
+	float InvCellSize;
+	std::vector<int32> Slots;
+	std::vector<FCellKey> CellKeys;
+	std::vector<int32> CellStarts;
+	std::vector<int32> CellVertices;
+};
+
+void SkeletalMeshTools::BuildSkeletalMeshChunks(const std::vector<FMeshFace>& Faces, const std::vector<FSoftSkinBuildVertex>& RawVertices, const FOverlappingThresholds &OverlappingThresholds, std::vector<FSkinnedMeshChunk*>& OutChunks, bool& bOutTooManyVerts)
+{
+	const int32 NumFaces = (int32)Faces.size();
+	const int32 NumRawVertices = NumFaces * 3;
+	assert((int32)RawVertices.size() == NumRawVertices);
+
+	// One chunk per material, in the order the materials first appear, and the faces of every chunk in order
+	std::vector<int32> FaceChunks(NumFaces);
+	std::vector<std::vector<int32>> ChunkFaces;
+	for (int32 FaceIndex = 0; FaceIndex < NumFaces; ++FaceIndex)
+	{
+		const FMeshFace& Face = Faces[FaceIndex];
+
+		int32 ChunkIndex = INDEX_NONE;
+		for (int32 i = 0; i < (int32)OutChunks.size(); ++i)
+		{
+			if (OutChunks[i]->MaterialIndex == Face.MeshMaterialIndex)
+			{
+				ChunkIndex = i;
+				break;
+			}
+		}
+		if (ChunkIndex == INDEX_NONE)
+		{
+			FSkinnedMeshChunk* Chunk = new FSkinnedMeshChunk();
+			Chunk->MaterialIndex = Face.MeshMaterialIndex;
+			Chunk->OriginalSectionIndex = (int32)OutChunks.size();
+			ChunkIndex = (int32)OutChunks.size();
+			OutChunks.push_back(Chunk);
+			ChunkFaces.push_back(std::vector<int32>());
+		}
+		FaceChunks[FaceIndex] = ChunkIndex;
+		ChunkFaces[ChunkIndex].push_back(FaceIndex);
+	}
+
+	std::vector<int32> VertexChunks(NumRawVertices);
+	for (int32 VertexIndex = 0; VertexIndex < NumRawVertices; ++VertexIndex)
+	{
+		VertexChunks[VertexIndex] = FaceChunks[VertexIndex / 3];
+	}
+	const FSkeletalMeshVertexGrid Grid(RawVertices, VertexChunks, OverlappingThresholds.ThresholdPosition);
+
+	// A vertex is welded to the first earlier vertex of its chunk it equals that was itself kept. Almost always that's simply
+	// the first earlier vertex it equals, which is found for all vertices in parallel; equality within thresholds isn't
+	// transitive though, so when that one was welded away the earlier vertices are searched again in order.
+	auto IsEarlierEqualVertex = [&](int32 VertexIndex, int32 OtherIndex)
+	{
+		return OtherIndex < VertexIndex && AreSkelMeshVerticesEqual(RawVertices[VertexIndex], RawVertices[OtherIndex], OverlappingThresholds);
+	};
+	std::vector<int32> FirstEqualVertex(NumRawVertices, INDEX_NONE);
+	ParallelFor(NumRawVertices, [&](int32 VertexIndex)
+	{
+		int32& FirstEqual = FirstEqualVertex[VertexIndex];
+		Grid.ForEachNearbyVertex(VertexChunks[VertexIndex], RawVertices[VertexIndex].Position, [&](int32 OtherIndex)
+		{
+			if (OtherIndex >= VertexIndex || (FirstEqual != INDEX_NONE && OtherIndex >= FirstEqual))
+			{
+				return false;
+			}
+			if (IsEarlierEqualVertex(VertexIndex, OtherIndex))
+			{
+				FirstEqual = OtherIndex;
+				return false;
+			}
+			return true;
+		});
+	}, !GParallelMeshBuild);
+
+	// Chunks weld and index their own vertices only
+	std::vector<int32> FinalVertices(NumRawVertices, INDEX_NONE);
+	ParallelFor((int32)OutChunks.size(), [&](int32 ChunkIndex)
+	{
+		FSkinnedMeshChunk* Chunk = OutChunks[ChunkIndex];
+		std::vector<int32> EqualVertices;
+
+		for (const int32 FaceIndex : ChunkFaces[ChunkIndex])
+		{
+			uint32 TriangleIndices[3];
+			for (int32 Corner = 0; Corner < 3; ++Corner)
+			{
+				const int32 VertexIndex = FaceIndex * 3 + Corner;
+
+				int32 FinalVertIndex = INDEX_NONE;
+				const int32 FirstEqual = FirstEqualVertex[VertexIndex];
+				if (FirstEqual != INDEX_NONE && FinalVertices[FirstEqual] != INDEX_NONE)
+				{
+					FinalVertIndex = FinalVertices[FirstEqual];
+				}
+				else if (FirstEqual != INDEX_NONE)
+				{
+					EqualVertices.clear();
+					Grid.ForEachNearbyVertex(ChunkIndex, RawVertices[VertexIndex].Position, [&](int32 OtherIndex)
+					{
+						if (OtherIndex >= VertexIndex)
+						{
+							return false;
+						}
+						if (FinalVertices[OtherIndex] != INDEX_NONE && IsEarlierEqualVertex(VertexIndex, OtherIndex))
+						{
+							EqualVertices.push_back(OtherIndex);
+						}
+						return true;
+					});
+					if (!EqualVertices.empty())
+					{
+						FinalVertIndex = FinalVertices[*std::min_element(EqualVertices.begin(), EqualVertices.end())];
+					}
+				}
+
+				if (FinalVertIndex == INDEX_NONE)
+				{
+					Chunk->Vertices.push_back(RawVertices[VertexIndex]);
+					FinalVertIndex = (int32)Chunk->Vertices.size() - 1;
+					FinalVertices[VertexIndex] = FinalVertIndex;
+				}
+
+				TriangleIndices[Corner] = (uint32)FinalVertIndex;
+			}
+
+			if (TriangleIndices[0] != TriangleIndices[1] && TriangleIndices[0] != TriangleIndices[2] && TriangleIndices[1] != TriangleIndices[2])
+			{
+				for (int32 Corner = 0; Corner < 3; Corner++)
+				{
+					Chunk->Indices.push_back(TriangleIndices[Corner]);
+				}
+			}
+		}
+	}, !GParallelMeshBuild);
+}
+
+void SkeletalMeshTools::ChunkSkinnedVertices(std::vector<FSkinnedMeshChunk*>& Chunks, int32 MaxBonesPerChunk)
+{
+	// Copy over the old chunks (this is just copying pointers).
+	std::vector<FSkinnedMeshChunk*> SrcChunks;
+	Exchange(Chunks, SrcChunks);
+
+	// Sort the chunks by material index.
+	struct FCompareSkinnedMeshChunk
+	{
+		bool operator()(const FSkinnedMeshChunk* A, const FSkinnedMeshChunk* B) const
+		{
+			return A->MaterialIndex < B->MaterialIndex;
+		}
+	};
+	std::sort(SrcChunks.begin(), SrcChunks.end(), FCompareSkinnedMeshChunk());
+	//SrcChunks.Sort(FCompareSkinnedMeshChunk());
+
+	// Now split chunks to respect the desired bone limit. Triangles only ever go to chunks split from their own source
+	// chunk, so every source chunk is split on its own thread and the results are appended in order.
+	std::vector<std::vector<FSkinnedMeshChunk*>> DestChunksPerSrcChunk(SrcChunks.size());
+	ParallelFor((int32)SrcChunks.size(), [&](int32 SrcChunkIndex)
+	{
+		FSkinnedMeshChunk* SrcChunk = SrcChunks[SrcChunkIndex];
+		std::vector<FSkinnedMeshChunk*>& DestChunks = DestChunksPerSrcChunk[SrcChunkIndex];
+		std::vector<std::vector<int32>> IndexMaps;
+		std::vector<FBoneIndexType> UniqueBones;
+
+		for (uint32 i = 0; i < SrcChunk->Indices.size(); i += 3)
+		{
+			// Find all bones needed by this triangle.
+			UniqueBones.clear();
+			for (int32 Corner = 0; Corner < 3; Corner++)
+			{
+				int32 VertexIndex = SrcChunk->Indices[i + Corner];
+				FSoftSkinBuildVertex& V = SrcChunk->Vertices[VertexIndex];
+				for (int32 InfluenceIndex = 0; InfluenceIndex < MAX_TOTAL_INFLUENCES; InfluenceIndex++)
+				{
+					if (V.InfluenceWeights[InfluenceIndex] > 0)
+					{
+						//UniqueBones.AddUnique(V.InfluenceBones[InfluenceIndex]);
+						AddUnique(UniqueBones, V.InfluenceBones[InfluenceIndex]);
+					}
+				}
+			}
+
+			// Now find a chunk for them.
+			FSkinnedMeshChunk* DestChunk = NULL;
+			uint32 DestChunkIndex = 0;
+			for (; DestChunkIndex < DestChunks.size(); ++DestChunkIndex)
+			{
+				std::vector<FBoneIndexType>& BoneMap = DestChunks[DestChunkIndex]->BoneMap;
+				int32 NumUniqueBones = 0;
+				for (uint32 j = 0; j < UniqueBones.size(); ++j)
+				{
+					NumUniqueBones += (Contains(BoneMap,UniqueBones[j]) ? 0 : 1);
+				}
+				if (NumUniqueBones + (int32)BoneMap.size() <= MaxBonesPerChunk)
+				{
+					DestChunk = DestChunks[DestChunkIndex];
+					break;
+				}
+			}
+
+			// If no chunk was found, create one!
+			if (DestChunk == NULL)
+			{
+				DestChunk = new FSkinnedMeshChunk();
+				DestChunks.push_back(DestChunk);
+				DestChunk->MaterialIndex = SrcChunk->MaterialIndex;
+				DestChunk->OriginalSectionIndex = SrcChunk->OriginalSectionIndex;
+				IndexMaps.push_back(std::vector<int32>(SrcChunk->Vertices.size(), INDEX_NONE));
+			}
+			std::vector<int32>& IndexMap = IndexMaps[DestChunkIndex];
+
+			// Add the unique bones to this chunk's bone map.
+			for (uint32 j = 0; j < UniqueBones.size(); ++j)
+			{
+				AddUnique(DestChunk->BoneMap,UniqueBones[j]);
+			}
+
+			// For each vertex, add it to the chunk's arrays of vertices and indices.
+			for (int32 Corner = 0; Corner < 3; Corner++)
+			{
+				int32 VertexIndex = SrcChunk->Indices[i + Corner];
+				int32 DestIndex = IndexMap[VertexIndex];
+				if (DestIndex == -1)
+				{
+					DestChunk->Vertices.push_back(SrcChunk->Vertices[VertexIndex]);
+					DestIndex = (int32)DestChunk->Vertices.size() - 1;
+					FSoftSkinBuildVertex& V = DestChunk->Vertices[DestIndex];
+					for (int32 InfluenceIndex = 0; InfluenceIndex < MAX_TOTAL_INFLUENCES; InfluenceIndex++)
+					{
+						if (V.InfluenceWeights[InfluenceIndex] > 0)
+						{
+							int32 MappedIndex = Find(DestChunk->BoneMap, V.InfluenceBones[InfluenceIndex]);
+							assert(IsValidIndex(DestChunk->BoneMap,MappedIndex));
+							V.InfluenceBones[InfluenceIndex] = MappedIndex;
+						}
+					}
+					IndexMap[VertexIndex] = DestIndex;
+				}
+				DestChunk->Indices.push_back(DestIndex);
+			}
+		}
+
+		// Source chunks are no longer needed.
+		delete SrcChunks[SrcChunkIndex];
+		SrcChunks[SrcChunkIndex] = NULL;
+	}, !GParallelMeshBuild);
+
+	for (const std::vector<FSkinnedMeshChunk*>& DestChunks : DestChunksPerSrcChunk)
+	{
+		Chunks.insert(Chunks.end(), DestChunks.begin(), DestChunks.end());
+	}
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "UnrealMath.h"
+
+#include <vector>
+
+/**
+* Turning the triangles of a skeletal mesh import into welded, bone limited chunks, kept apart from the FBX import so it
+* builds on its own.
+*/
+
+typedef uint16 FBoneIndexType;
+
+struct FMeshWedge
+{
+	uint32			iVertex;			// Vertex index.
+	Vector2			UVs[4];				// UVs.
+	FColor			Color;				// Vertex color.
+};
+struct FMeshFace
+{
+	// Textured Vertex indices.
+	uint32		iWedge[3];
+	// Source Material (= texture plus unique flags) index.
+	uint16		MeshMaterialIndex;
+	FVector	TangentX[3];
+	FVector	TangentY[3];
+	FVector	TangentZ[3];
+	// 32-bit flag for smoothing groups.
+	uint32   SmoothingGroups;
+};
+
+struct FOverlappingThresholds
+{
+public:
+	FOverlappingThresholds()
+		: ThresholdPosition(THRESH_POINTS_ARE_SAME)
+		, ThresholdTangentNormal(THRESH_NORMALS_ARE_SAME)
+		, ThresholdUV(THRESH_UVS_ARE_SAME)
+	{}
+
+	/** Threshold use to decide if two vertex position are equal. */
+	float ThresholdPosition;
+
+	/** Threshold use to decide if two normal, tangents or bi-normals are equal. */
+	float ThresholdTangentNormal;
+
+	/** Threshold use to decide if two UVs are equal. */
+	float ThresholdUV;
+};
+
+inline bool PointsEqual(const FVector& V1, const FVector& V2, const FOverlappingThresholds& OverlappingThreshold)
+{
+	const float Epsilon = OverlappingThreshold.ThresholdPosition;
+	return FMath::Abs(V1.X - V2.X) <= Epsilon && FMath::Abs(V1.Y - V2.Y) <= Epsilon && FMath::Abs(V1.Z - V2.Z) <= Epsilon;
+}
+inline bool NormalsEqual(const FVector& V1, const FVector& V2, const FOverlappingThresholds& OverlappingThreshold)
+{
+	const float Epsilon = OverlappingThreshold.ThresholdTangentNormal;
+	return FMath::Abs(V1.X - V2.X) <= Epsilon && FMath::Abs(V1.Y - V2.Y) <= Epsilon && FMath::Abs(V1.Z - V2.Z) <= Epsilon;
+}
+inline bool UVsEqual(const Vector2& V1, const Vector2& V2, const FOverlappingThresholds& OverlappingThreshold)
+{
+	const float Epsilon = OverlappingThreshold.ThresholdUV;
+	return FMath::Abs(V1.X - V2.X) <= Epsilon && FMath::Abs(V1.Y - V2.Y) <= Epsilon;
+}
+
+#define MAX_TOTAL_INFLUENCES 8
+typedef FVector FPackedNormal;
+struct FSoftSkinBuildVertex
+{
+	FVector			Position;
+	FPackedNormal	TangentX,	// Tangent, U-direction
+		TangentY,	// Binormal, V-direction
+		TangentZ;	// Normal
+	Vector2			UVs[4]; // UVs
+	FColor			Color;		// VertexColor
+	FBoneIndexType	InfluenceBones[MAX_TOTAL_INFLUENCES];
+	uint8			InfluenceWeights[MAX_TOTAL_INFLUENCES];
+	uint32 PointWedgeIdx;
+};
+/**
+* A chunk of skinned mesh vertices used as intermediate data to build a renderable
+* skinned mesh.
+*/
+struct FSkinnedMeshChunk
+{
+	/** The material index with which this chunk should be rendered. */
+	int32 MaterialIndex;
+	/** The original section index for which this chunk was generated. */
+	int32 OriginalSectionIndex;
+	/** The vertices associated with this chunk. */
+	std::vector<FSoftSkinBuildVertex> Vertices;
+	/** The indices of the triangles in this chunk. */
+	std::vector<uint32> Indices;
+	/** If not empty, contains a map from bones referenced in this chunk to the skeleton. */
+	std::vector<FBoneIndexType> BoneMap;
+};
+
+namespace SkeletalMeshTools
+{
+	inline bool SkeletalMesh_UVsEqual(const FMeshWedge& V1, const FMeshWedge& V2, const FOverlappingThresholds& OverlappingThresholds, const int32 UVIndex = 0)
+	{
+		const Vector2& UV1 = V1.UVs[UVIndex];
+		const Vector2& UV2 = V2.UVs[UVIndex];
+
+		if (FMath::Abs(UV1.X - UV2.X) > OverlappingThresholds.ThresholdUV)
+			return 0;
+
+		if (FMath::Abs(UV1.Y - UV2.Y) > OverlappingThresholds.ThresholdUV)
+			return 0;
+
+		return 1;
+	}
+
+	/** @return true if V1 and V2 are equal */
+	bool AreSkelMeshVerticesEqual(const FSoftSkinBuildVertex& V1, const FSoftSkinBuildVertex& V2, const FOverlappingThresholds& OverlappingThresholds);
+
+	/**
+	* Creates chunks and populates the vertex and index arrays inside each chunk
+	*
+	* @param Faces						List of raw faces
+	* @param RawVertices				List of raw created, unordered, unwelded vertices, three per face
+	* @param OverlappingThresholds		The thresholds to use to compute overlap vertex instance
+	* @param OutChunks					Created array of chunks
+	*/
+	void BuildSkeletalMeshChunks(const std::vector<FMeshFace>& Faces, const std::vector<FSoftSkinBuildVertex>& RawVertices, const FOverlappingThresholds &OverlappingThresholds, std::vector<FSkinnedMeshChunk*>& OutChunks, bool& bOutTooManyVerts);
+
+	/**
+	* Splits chunks to satisfy the requested maximum number of bones per chunk
+	* @param Chunks			Chunks to split. Upon return contains the results of splitting chunks.
+	* @param MaxBonesPerChunk	The maximum number of bones a chunk may reference.
+	*/
+	void ChunkSkinnedVertices(std::vector<FSkinnedMeshChunk*>& Chunks, int32 MaxBonesPerChunk);
+
+
+	//void CalcBoneVertInfos(USkeletalMesh* SkeletalMesh, std::vector<FBoneVertInfo>& Infos, bool bOnlyDominant);
+};
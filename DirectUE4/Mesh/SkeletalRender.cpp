@@ -2,6 +2,9 @@
 #include "MeshComponent.h"
 #include "SkeletalMeshRenderData.h"
 #include "SkeletalMesh.h"
+#include "log.h"
+
+#include <chrono>
 
 FSkeletalMeshObject::FSkeletalMeshObject(USkinnedMeshComponent* InMeshComponent, FSkeletalMeshRenderData* InSkelMeshRenderData)
 	: MinDesiredLODLevel(0)
@@ -88,7 +91,7 @@ void UpdateRefToLocalMatricesInner(std::vector<FMatrix>& ReferenceToLocal, const
 						else
 						{
 							assert(ComponentTransform[MasterBoneIndex].IsRotationNormalized());
-							ReferenceToLocal[ThisBoneIndex] = ComponentTransform[MasterBoneIndex].ToMatrixWithScale();
+							ComponentTransform[MasterBoneIndex].ToMatrixWithScale(ReferenceToLocal[ThisBoneIndex]);
 						}
 					}
 					else
@@ -121,13 +124,13 @@ void UpdateRefToLocalMatricesInner(std::vector<FMatrix>& ReferenceToLocal, const
 							else
 							{
 								assert(ComponentTransform[ThisBoneIndex].IsRotationNormalized());
-								ReferenceToLocal[ThisBoneIndex] = ComponentTransform[ThisBoneIndex].ToMatrixWithScale();
+								ComponentTransform[ThisBoneIndex].ToMatrixWithScale(ReferenceToLocal[ThisBoneIndex]);
 							}
 						}
 						else
 						{
 							assert(ComponentTransform[ThisBoneIndex].IsRotationNormalized());
-							ReferenceToLocal[ThisBoneIndex] = ComponentTransform[ThisBoneIndex].ToMatrixWithScale();
+							ComponentTransform[ThisBoneIndex].ToMatrixWithScale(ReferenceToLocal[ThisBoneIndex]);
 						}
 					}
 				}
@@ -135,10 +138,72 @@ void UpdateRefToLocalMatricesInner(std::vector<FMatrix>& ReferenceToLocal, const
 		}
 	}
 
-	for (uint32 ThisBoneIndex = 0; ThisBoneIndex < ReferenceToLocal.size(); ++ThisBoneIndex)
+	// only the bones of this LOD are skinned with, bones removed by the LOD are never read
+	for (int32 RequiredBoneSetIndex = 0; RequiredBoneSets[RequiredBoneSetIndex] != NULL; RequiredBoneSetIndex++)
 	{
-		ReferenceToLocal[ThisBoneIndex] = (*RefBasesInvMatrix)[ThisBoneIndex] * ReferenceToLocal[ThisBoneIndex];
+		const std::vector<FBoneIndexType>& RequiredBoneIndices = *RequiredBoneSets[RequiredBoneSetIndex];
+
+		for (uint32 BoneIndex = 0; BoneIndex < RequiredBoneIndices.size(); BoneIndex++)
+		{
+			const int32 ThisBoneIndex = RequiredBoneIndices[BoneIndex];
+			if (IsValidIndex(*RefBasesInvMatrix, ThisBoneIndex))
+			{
+				VectorMatrixMultiply(&ReferenceToLocal[ThisBoneIndex], &(*RefBasesInvMatrix)[ThisBoneIndex], &ReferenceToLocal[ThisBoneIndex]);
+			}
+		}
+	}
+}
+
+void BenchmarkBoneTransformUpdate(int32 NumBones, int32 NumIterations)
+{
+	if (NumBones <= 1 || NumIterations <= 0)
+	{
+		return;
+	}
+
+	// a single chain, every bone slightly rotated, offset and scaled from its parent
+	std::vector<FTransform> BoneSpaceTransforms(NumBones);
+	std::vector<FMatrix> RefBasesInvMatrix(NumBones);
+	for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+	{
+		const float Angle = 0.1f * (float)(BoneIndex % 17);
+		const FQuat Rotation(FVector(0.3f, 0.5f, 0.8f).GetSafeNormal(), Angle);
+		BoneSpaceTransforms[BoneIndex] = FTransform(Rotation, FVector(1.f + Angle, -Angle, 0.5f), FVector(1.f + 0.01f * Angle));
+		RefBasesInvMatrix[BoneIndex] = BoneSpaceTransforms[BoneIndex].ToInverseMatrixWithScale();
 	}
+
+	std::vector<FTransform> ComponentSpaceTransforms(NumBones);
+	std::vector<FMatrix> ReferenceToLocal(NumBones);
+	double ComponentSpaceSeconds = 0.0;
+	double RefToLocalSeconds = 0.0;
+
+	for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+	{
+		// same work as USkeletalMeshComponent::FillComponentSpaceTransforms
+		auto Start = std::chrono::high_resolution_clock::now();
+		ComponentSpaceTransforms[0] = BoneSpaceTransforms[0];
+		for (int32 BoneIndex = 1; BoneIndex < NumBones; ++BoneIndex)
+		{
+			FTransform* SpaceBase = &ComponentSpaceTransforms[BoneIndex];
+			FTransform::Multiply(SpaceBase, &BoneSpaceTransforms[BoneIndex], &ComponentSpaceTransforms[BoneIndex - 1]);
+			SpaceBase->NormalizeRotation();
+		}
+		ComponentSpaceSeconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - Start).count();
+
+		// same work as UpdateRefToLocalMatricesInner for visible bones
+		Start = std::chrono::high_resolution_clock::now();
+		for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+		{
+			ComponentSpaceTransforms[BoneIndex].ToMatrixWithScale(ReferenceToLocal[BoneIndex]);
+			VectorMatrixMultiply(&ReferenceToLocal[BoneIndex], &RefBasesInvMatrix[BoneIndex], &ReferenceToLocal[BoneIndex]);
+		}
+		RefToLocalSeconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - Start).count();
+	}
+
+	const double NumBoneUpdates = (double)NumBones * (double)NumIterations;
+	X_LOG("BenchmarkBoneTransformUpdate (%s FTransform): %d bones x %d iterations, component space %.2f ns/bone, ref to local %.2f ns/bone\n",
+		ENABLE_VECTORIZED_TRANSFORM ? "vectorized" : "scalar", NumBones, NumIterations,
+		ComponentSpaceSeconds * 1.0e9 / NumBoneUpdates, RefToLocalSeconds * 1.0e9 / NumBoneUpdates);
 }
 
 void UpdateRefToLocalMatrices(std::vector<FMatrix>& ReferenceToLocal, const USkinnedMeshComponent* InMeshComponent, const FSkeletalMeshRenderData* InSkeletalMeshRenderData, int32 LODIndex, const std::vector<FBoneIndexType>* ExtraRequiredBoneIndices /*= NULL*/)
@@ -1,7 +1,7 @@
 
 #pragma once
 
-#include "UnrealMathFPU.h"
+#include "VectorRegister.h"
 
 #include <vector>
 
@@ -30,6 +30,13 @@ void UpdateRefToLocalMatrices(std::vector<FMatrix>& ReferenceToLocal, const USki
 */
 void UpdatePreviousRefToLocalMatrices(std::vector<FMatrix>& ReferenceToLocal, const USkinnedMeshComponent* InMeshComponent, const FSkeletalMeshRenderData* InSkeletalMeshRenderData, int32 LODIndex, const std::vector<FBoneIndexType>* ExtraRequiredBoneIndices = NULL);
 
+/**
+* Times the per bone transform math of an animated mesh on a synthetic NumBones long chain and logs the cost per bone:
+* the FillComponentSpaceTransforms step (FTransform::Multiply + NormalizeRotation) and the UpdateRefToLocalMatrices step
+* (ToMatrixWithScale + ref pose inverse multiply). Build with ENABLE_VECTORIZED_TRANSFORM=0 to get the scalar FTransform numbers.
+*/
+void BenchmarkBoneTransformUpdate(int32 NumBones, int32 NumIterations);
+
 
 extern const VectorRegister		VECTOR_0001;
 
@@ -33,6 +33,21 @@ void FDynamicSkelMeshObjectDataGPUSkin::InitDynamicSkelMeshObjectDataGPUSkin(
 {
 	LODIndex = InLODIndex;
 
+	// baked animations come with their matrices, there are no bones to turn into them
+	if (const std::vector<FMatrix>* PrecomputedReferenceToLocal = InMeshComponent->GetPrecomputedReferenceToLocal(false))
+	{
+		ReferenceToLocal = *PrecomputedReferenceToLocal;
+		if (bUpdatePreviousBoneTransform)
+		{
+			PreviousReferenceToLocal = *InMeshComponent->GetPrecomputedReferenceToLocal(true);
+		}
+		else
+		{
+			PreviousReferenceToLocal.clear();
+		}
+		return;
+	}
+
 	FSkeletalMeshSceneProxy* SkeletalMeshProxy = (FSkeletalMeshSceneProxy*)InMeshComponent->SceneProxy;
 	const std::vector<FBoneIndexType>* ExtraRequiredBoneIndices = /*SkeletalMeshProxy ? &SkeletalMeshProxy->GetSortedShadowBoneIndices() : */nullptr;
 
@@ -51,7 +66,7 @@ void FDynamicSkelMeshObjectDataGPUSkin::InitDynamicSkelMeshObjectDataGPUSkin(
 
 FSkeletalMeshObjectGPUSkin::FSkeletalMeshObjectGPUSkin(USkinnedMeshComponent* InMeshComponent, FSkeletalMeshRenderData* InSkelMeshRenderData)
 	: FSkeletalMeshObject(InMeshComponent, InSkelMeshRenderData)
-// 	, DynamicData(NULL)
+	, DynamicData(NULL)
 // 	, bNeedsUpdateDeferred(false)
 // 	, bMorphNeedsUpdateDeferred(false)
 // 	, bMorphResourcesInitialized(false)
@@ -189,11 +204,11 @@ const FVertexFactory* FSkeletalMeshObjectGPUSkin::GetSkinVertexFactory(const FSc
 
 int32 FSkeletalMeshObjectGPUSkin::GetLOD() const
 {
-// 	if (DynamicData)
-// 	{
-// 		return DynamicData->LODIndex;
-// 	}
-// 	else
+	if (DynamicData)
+	{
+		return DynamicData->LODIndex;
+	}
+	else
 	{
 		return 0;
 	}
@@ -217,25 +232,27 @@ void InitGPUSkinVertexFactoryComponents(typename VertexFactoryType::FDataType* V
 	// tangents
 	//VertexBuffers.StaticVertexBuffers->StaticMeshVertexBuffer.BindTangentVertexBuffer(VertexFactory, *VertexFactoryData);
 	//VertexBuffers.StaticVertexBuffers->StaticMeshVertexBuffer.BindTexCoordVertexBuffer(VertexFactory, *VertexFactoryData);
+	const uint32 TangentSize = VertexBuffers.StaticVertexBuffers->GetTangentSize();
+	const bool bPackedTangents = TangentSize != sizeof(Vector4);
 	VertexFactoryData->TangentBasisComponents[0] = FVertexStreamComponent(
 		VertexBuffers.StaticVertexBuffers->TangentsVertexBufferRHI.Get(),
 		0,
-		sizeof(Vector4)*2,
-		DXGI_FORMAT_R32G32B32_FLOAT,
+		TangentSize * 2,
+		bPackedTangents ? DXGI_FORMAT_R8G8B8A8_SNORM : DXGI_FORMAT_R32G32B32_FLOAT,
 		4
 	);
 	VertexFactoryData->TangentBasisComponents[1] = FVertexStreamComponent(
 		VertexBuffers.StaticVertexBuffers->TangentsVertexBufferRHI.Get(),
-		sizeof(Vector4),
-		sizeof(Vector4) * 2,
-		DXGI_FORMAT_R32G32B32A32_FLOAT,
+		TangentSize,
+		TangentSize * 2,
+		VertexBuffers.StaticVertexBuffers->GetTangentFormat(),
 		4
 	);
 	VertexFactoryData->TextureCoordinates = FVertexStreamComponent(
 		VertexBuffers.StaticVertexBuffers->TexCoordVertexBufferRHI.Get(),
 		0,
-		sizeof(Vector2),
-		DXGI_FORMAT_R32G32_FLOAT,
+		VertexBuffers.StaticVertexBuffers->GetTexCoordSize(),
+		VertexBuffers.StaticVertexBuffers->GetTexCoordFormat(),
 		4
 	);
 	// bone indices
@@ -349,7 +366,7 @@ void FSkeletalMeshObjectGPUSkin::FSkeletalMeshObjectLOD::InitResources(const FSk
 
 	FSkeletalMeshLODRenderData& LODData = *SkelMeshRenderData->LODRenderData[LODIndex];
 
-	MeshObjectWeightBuffer = &LODData.SkinWeightVertexBuffer;
+	MeshObjectWeightBuffer = &LODData.GetGeometry().SkinWeightVertexBuffer;
 
 	FVertexFactoryBuffers VertexBuffers;
 	GetVertexBuffers(VertexBuffers, LODData);
@@ -367,7 +384,7 @@ void FSkeletalMeshObjectGPUSkin::FSkeletalMeshObjectLOD::ReleaseResources()
 
 void FSkeletalMeshObjectGPUSkin::FSkeletalMeshObjectLOD::GetVertexBuffers(FVertexFactoryBuffers& OutVertexBuffers, FSkeletalMeshLODRenderData& LODData)
 {
-	OutVertexBuffers.StaticVertexBuffers = &LODData.StaticVertexBuffers;
+	OutVertexBuffers.StaticVertexBuffers = &LODData.GetGeometry().StaticVertexBuffers;
 	//OutVertexBuffers.ColorVertexBuffer = MeshObjectColorBuffer;
 	OutVertexBuffers.SkinWeightVertexBuffer = MeshObjectWeightBuffer;
 	//OutVertexBuffers.MorphVertexBuffer = &MorphVertexBuffer;
@@ -19,6 +19,12 @@ public:
 	void InitResources();
 	void ReleaseResources();
 
+	/** Bytes the bone indices and 8-bit weights take on the GPU */
+	uint32 GetAllocatedSize() const
+	{
+		return (uint32)WeightData.size();
+	}
+
 	ComPtr<ID3D11Buffer> WeightVertexBufferRHI = NULL;
 private:
 	std::vector<uint8> WeightData;
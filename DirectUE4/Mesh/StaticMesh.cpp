@@ -9,24 +9,55 @@
 #include "MeshComponent.h"
 #include "PrimitiveSceneInfo.h"
 #include "MapBuildDataRegistry.h"
+#include "DerivedDataCache.h"
+#include "SceneSoftwareOcclusion.h"
 
 #include <vector>
 #include <string>
 #include <algorithm>
 #include <assert.h>
 
-void FStaticMeshLODResources::InitResources()
-{
-	VertexBuffers.PositionVertexBufferRHI = RHICreateVertexBuffer(VertexBuffers.PositionVertexBuffer.size() * sizeof(FVector), D3D11_USAGE_DEFAULT, D3D11_BIND_SHADER_RESOURCE, 0, VertexBuffers.PositionVertexBuffer.data()); 
-	VertexBuffers.TangentsVertexBufferRHI = RHICreateVertexBuffer(VertexBuffers.TangentsVertexBuffer.size() * sizeof(Vector4), D3D11_USAGE_DEFAULT, D3D11_BIND_SHADER_RESOURCE, 0, VertexBuffers.TangentsVertexBuffer.data());
-	VertexBuffers.TexCoordVertexBufferRHI = RHICreateVertexBuffer(VertexBuffers.TexCoordVertexBuffer.size() * sizeof(Vector2), D3D11_USAGE_DEFAULT, D3D11_BIND_SHADER_RESOURCE, 0, VertexBuffers.TexCoordVertexBuffer.data());
+bool GCompactMeshVertexFormats = false;
+std::vector<float> GStaticMeshLODPercentTriangles = { 1.0f, 0.5f, 0.25f, 0.125f };
 
-	VertexBuffers.TangentsVertexBufferSRV = RHICreateShaderResourceView(VertexBuffers.TangentsVertexBufferRHI.Get(), sizeof(Vector4) , DXGI_FORMAT_R32G32B32A32_FLOAT);
-	VertexBuffers.TexCoordVertexBufferSRV = RHICreateShaderResourceView(VertexBuffers.TexCoordVertexBufferRHI.Get(), sizeof(Vector2) , DXGI_FORMAT_R32G32_FLOAT);
+extern float GNearClippingPlane;
 
-	IndexBuffer = CreateIndexBuffer(Indices.data(), sizeof(unsigned int) * Indices.size());
+void FStaticMeshVertexBuffers::PackTangents()
+{
+	PackedTangentsVertexBuffer.assign(TangentsVertexBuffer.begin(), TangentsVertexBuffer.end());
+	std::vector<Vector4>().swap(TangentsVertexBuffer);
+}
 
+void FStaticMeshVertexBuffers::PackTexCoords()
+{
+	HalfTexCoordVertexBuffer.assign(TexCoordVertexBuffer.begin(), TexCoordVertexBuffer.end());
+	std::vector<Vector2>().swap(TexCoordVertexBuffer);
+}
 
+uint32 FStaticMeshVertexBuffers::GetAllocatedSize(bool bAsFullPrecision) const
+{
+	const uint32 NumTangents = (uint32)(TangentsVertexBuffer.size() + PackedTangentsVertexBuffer.size());
+	const uint32 NumTexCoords = (uint32)(TexCoordVertexBuffer.size() + HalfTexCoordVertexBuffer.size());
+	const uint32 TangentSize = bAsFullPrecision ? sizeof(Vector4) : GetTangentSize();
+	const uint32 TexCoordSize = bAsFullPrecision ? sizeof(Vector2) : GetTexCoordSize();
+	return (uint32)(PositionVertexBuffer.size() * sizeof(FVector) + ColorVertexBuffer.size() * sizeof(FColor)) + NumTangents * TangentSize + NumTexCoords * TexCoordSize;
+}
+
+void FStaticMeshLODResources::InitResources()
+{
+	VertexBuffers.PositionVertexBufferRHI = RHICreateVertexBuffer(VertexBuffers.PositionVertexBuffer.size() * sizeof(FVector), D3D11_USAGE_DEFAULT, D3D11_BIND_SHADER_RESOURCE, 0, VertexBuffers.PositionVertexBuffer.data()); 
+	VertexBuffers.TangentsVertexBufferRHI = RHICreateVertexBuffer(VertexBuffers.GetTangentDataSize(), D3D11_USAGE_DEFAULT, D3D11_BIND_SHADER_RESOURCE, 0, VertexBuffers.GetTangentData());
+	VertexBuffers.TexCoordVertexBufferRHI = RHICreateVertexBuffer(VertexBuffers.GetTexCoordDataSize(), D3D11_USAGE_DEFAULT, D3D11_BIND_SHADER_RESOURCE, 0, VertexBuffers.GetTexCoordData());
+
+	// typed buffer loads convert SNORM and half elements to floats, the manual vertex fetch shaders read either layout
+	VertexBuffers.TangentsVertexBufferSRV = RHICreateShaderResourceView(VertexBuffers.TangentsVertexBufferRHI.Get(), VertexBuffers.GetTangentSize(), VertexBuffers.GetTangentFormat());
+	VertexBuffers.TexCoordVertexBufferSRV = RHICreateShaderResourceView(VertexBuffers.TexCoordVertexBufferRHI.Get(), VertexBuffers.GetTexCoordSize(), VertexBuffers.GetTexCoordFormat());
+
+	const uint8 DataTypeSize = GetIndexDataTypeSize();
+	std::vector<uint8> PackedIndices;
+	PackIndices(DataTypeSize, Indices, PackedIndices);
+	IndexBuffer = CreateIndexBuffer(PackedIndices.data(), PackedIndices.size());
+	IndexBufferFormat = DataTypeSize == sizeof(uint16) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
 }
 
 void FStaticMeshLODResources::ReleaseResources()
@@ -37,14 +68,25 @@ void FStaticMeshLODResources::ReleaseResources()
 	}
 }
 
+void FStaticMeshLODResources::LogMemorySavings() const
+{
+	const uint32 FullSize = VertexBuffers.GetAllocatedSize(true) + (uint32)(Indices.size() * sizeof(uint32));
+	const uint32 CompactSize = VertexBuffers.GetAllocatedSize() + (uint32)(Indices.size() * GetIndexDataTypeSize());
+	X_LOG("Static mesh LOD: %u vertices, %u indices, GPU buffers %u -> %u bytes (%.1f%% saved)\n", (uint32)VertexBuffers.PositionVertexBuffer.size(),
+		(uint32)Indices.size(), FullSize, CompactSize, FullSize ? 100.f * (float)(FullSize - CompactSize) / (float)FullSize : 0.f);
+}
+
 void FStaticMeshVertexFactories::InitResources(const FStaticMeshLODResources& LodResources, const UStaticMesh* Parent)
 {
 	FLocalVertexFactory::FDataType Data;
 	Data.PositionComponent = FVertexStreamComponent(LodResources.VertexBuffers.PositionVertexBufferRHI.Get(), 0, sizeof(FVector), DXGI_FORMAT_R32G32B32_FLOAT);
-	Data.TangentBasisComponents[0] = FVertexStreamComponent(LodResources.VertexBuffers.TangentsVertexBufferRHI.Get(), 0, sizeof(Vector4), DXGI_FORMAT_R32G32B32A32_FLOAT);
-	Data.TangentBasisComponents[1] = FVertexStreamComponent(LodResources.VertexBuffers.TangentsVertexBufferRHI.Get(), 12, sizeof(Vector4), DXGI_FORMAT_R32G32B32A32_FLOAT);
-	Data.TextureCoordinates = FVertexStreamComponent(LodResources.VertexBuffers.TexCoordVertexBufferRHI.Get(), 0, sizeof(Vector2), DXGI_FORMAT_R32G32_FLOAT);
-	Data.LightMapCoordinateComponent = FVertexStreamComponent(LodResources.VertexBuffers.TexCoordVertexBufferRHI.Get(), 8, sizeof(Vector2), DXGI_FORMAT_R32G32_FLOAT);
+	const FStaticMeshVertexBuffers& VertexBuffers = LodResources.VertexBuffers;
+	const uint32 TangentSize = VertexBuffers.GetTangentSize();
+	const uint32 TexCoordSize = VertexBuffers.GetTexCoordSize();
+	Data.TangentBasisComponents[0] = FVertexStreamComponent(VertexBuffers.TangentsVertexBufferRHI.Get(), 0, TangentSize * 2, VertexBuffers.GetTangentFormat());
+	Data.TangentBasisComponents[1] = FVertexStreamComponent(VertexBuffers.TangentsVertexBufferRHI.Get(), TangentSize, TangentSize * 2, VertexBuffers.GetTangentFormat());
+	Data.TextureCoordinates = FVertexStreamComponent(VertexBuffers.TexCoordVertexBufferRHI.Get(), 0, TexCoordSize * 2, VertexBuffers.GetTexCoordFormat());
+	Data.LightMapCoordinateComponent = FVertexStreamComponent(VertexBuffers.TexCoordVertexBufferRHI.Get(), TexCoordSize, TexCoordSize * 2, VertexBuffers.GetTexCoordFormat());
 	Data.TangentsSRV = LodResources.VertexBuffers.TangentsVertexBufferSRV;
 	Data.TextureCoordinatesSRV = LodResources.VertexBuffers.TexCoordVertexBufferSRV;
 	Data.NumTexCoords = 2;
@@ -60,6 +102,8 @@ void FStaticMeshVertexFactories::ReleaseResources()
 
 void FStaticMeshRenderData::InitResources(const UStaticMesh* Owner)
 {
+	ComputeScreenSizes();
+
 	for (uint32 LODIndex = 0; LODIndex < LODResources.size(); ++LODIndex)
 	{
 		LODResources[LODIndex]->InitResources();
@@ -76,6 +120,33 @@ void FStaticMeshRenderData::ReleaseResources()
 	}
 }
 
+/**
+ * Screen size, as ComputeBoundsScreenSize measures it, below which a LOD that deviates MaxDeviation from the source mesh
+ * may be drawn: the one of the bounds at the distance, already scaled by LODDistanceFactor, where that deviation projects
+ * to about a pixel of the window, with the projection Camera::CalcSceneView sets up for the world's 90 degree camera.
+ */
+static float ComputeLODScreenSize(float MaxDeviation, float SphereRadius)
+{
+	const float PixelError = 1.0f;
+	const float FOV = 90.0f;
+	const FMatrix ProjectionMatrix = FReversedZPerspectiveMatrix(FOV * (float)PI / 360.0f, (float)WindowWidth / (float)WindowHeight, 1.0f, GNearClippingPlane);
+	const float ScreenMultiple = FMath::Max(0.5f * ProjectionMatrix.M[0][0], 0.5f * ProjectionMatrix.M[1][1]);
+	// a length at Distance covers ScreenMultiple / Distance of the view along the axis ScreenMultiple was taken from
+	const float NumPixels = (float)(ProjectionMatrix.M[0][0] >= ProjectionMatrix.M[1][1] ? WindowWidth : WindowHeight);
+	const float Distance = ScreenMultiple * MaxDeviation * NumPixels / PixelError;
+	return 2.0f * ScreenMultiple * SphereRadius / FMath::Max(1.0f, Distance);
+}
+
+void FStaticMeshRenderData::ComputeScreenSizes()
+{
+	ScreenSize.assign(1, 1.0f);
+	for (uint32 LODIndex = 1; LODIndex < LODMaxDeviation.size(); ++LODIndex)
+	{
+		// never larger than the screen size of the LOD before, which would keep that one from ever being drawn
+		ScreenSize.push_back(FMath::Min(ComputeLODScreenSize(LODMaxDeviation[LODIndex], Bounds.SphereRadius), ScreenSize.back()));
+	}
+}
+
 void FStaticMeshRenderData::AllocateLODResources(int32 NumLODs)
 {
 	while ((int32)LODResources.size() < NumLODs)
@@ -89,6 +160,108 @@ void FStaticMeshRenderData::Cache(UStaticMesh* Owner/*, const FStaticMeshLODSett
 {
 	FBXImporter Importer;
 	Importer.BuildStaticMesh(*this, Owner);
+
+	if (Owner->HasSourceHash())
+	{
+		std::vector<uint8> DerivedData;
+		SaveToDerivedData(DerivedData);
+		GetDerivedDataCacheRef().Put(Owner->GetDerivedDataKey(), DerivedData);
+	}
+}
+
+template<typename T>
+static void WriteDerivedData(std::vector<uint8>& OutData, const T* Data, uint32 Num)
+{
+	const size_t Offset = OutData.size();
+	OutData.resize(Offset + sizeof(uint32) + Num * sizeof(T));
+	memcpy(&OutData[Offset], &Num, sizeof(uint32));
+	if (Num > 0)
+	{
+		memcpy(&OutData[Offset + sizeof(uint32)], Data, Num * sizeof(T));
+	}
+}
+
+template<typename T>
+static void WriteDerivedDataArray(std::vector<uint8>& OutData, const std::vector<T>& Array)
+{
+	WriteDerivedData(OutData, Array.data(), (uint32)Array.size());
+}
+
+template<typename T>
+static bool ReadDerivedDataArray(const std::vector<uint8>& Data, size_t& Offset, std::vector<T>& OutArray)
+{
+	uint32 Num = 0;
+	if (Offset + sizeof(uint32) > Data.size())
+	{
+		return false;
+	}
+	memcpy(&Num, &Data[Offset], sizeof(uint32));
+	Offset += sizeof(uint32);
+	if ((Data.size() - Offset) / sizeof(T) < Num)
+	{
+		return false;
+	}
+	OutArray.resize(Num);
+	if (Num > 0)
+	{
+		memcpy(OutArray.data(), &Data[Offset], Num * sizeof(T));
+	}
+	Offset += Num * sizeof(T);
+	return true;
+}
+
+void FStaticMeshRenderData::SaveToDerivedData(std::vector<uint8>& OutData) const
+{
+	OutData.clear();
+	WriteDerivedData(OutData, &Bounds, 1);
+	const uint32 NumLODs = (uint32)LODResources.size();
+	WriteDerivedData(OutData, &NumLODs, 1);
+	for (const FStaticMeshLODResources* LOD : LODResources)
+	{
+		WriteDerivedDataArray(OutData, LOD->VertexBuffers.TangentsVertexBuffer);
+		WriteDerivedDataArray(OutData, LOD->VertexBuffers.TexCoordVertexBuffer);
+		WriteDerivedDataArray(OutData, LOD->VertexBuffers.PackedTangentsVertexBuffer);
+		WriteDerivedDataArray(OutData, LOD->VertexBuffers.HalfTexCoordVertexBuffer);
+		WriteDerivedDataArray(OutData, LOD->VertexBuffers.PositionVertexBuffer);
+		WriteDerivedDataArray(OutData, LOD->VertexBuffers.ColorVertexBuffer);
+		WriteDerivedDataArray(OutData, LOD->Indices);
+		WriteDerivedDataArray(OutData, LOD->Sections);
+	}
+	WriteDerivedDataArray(OutData, LODMaxDeviation);
+}
+
+bool FStaticMeshRenderData::LoadFromDerivedData(const std::vector<uint8>& Data)
+{
+	size_t Offset = 0;
+	std::vector<FBoxSphereBounds> SavedBounds;
+	std::vector<uint32> NumLODs;
+	if (!ReadDerivedDataArray(Data, Offset, SavedBounds) || SavedBounds.size() != 1 ||
+		!ReadDerivedDataArray(Data, Offset, NumLODs) || NumLODs.size() != 1 || NumLODs[0] == 0)
+	{
+		return false;
+	}
+	Bounds = SavedBounds[0];
+
+	AllocateLODResources(NumLODs[0]);
+	for (FStaticMeshLODResources* LOD : LODResources)
+	{
+		if (!ReadDerivedDataArray(Data, Offset, LOD->VertexBuffers.TangentsVertexBuffer) ||
+			!ReadDerivedDataArray(Data, Offset, LOD->VertexBuffers.TexCoordVertexBuffer) ||
+			!ReadDerivedDataArray(Data, Offset, LOD->VertexBuffers.PackedTangentsVertexBuffer) ||
+			!ReadDerivedDataArray(Data, Offset, LOD->VertexBuffers.HalfTexCoordVertexBuffer) ||
+			!ReadDerivedDataArray(Data, Offset, LOD->VertexBuffers.PositionVertexBuffer) ||
+			!ReadDerivedDataArray(Data, Offset, LOD->VertexBuffers.ColorVertexBuffer) ||
+			!ReadDerivedDataArray(Data, Offset, LOD->Indices) ||
+			!ReadDerivedDataArray(Data, Offset, LOD->Sections))
+		{
+			return false;
+		}
+	}
+	if (!ReadDerivedDataArray(Data, Offset, LODMaxDeviation) || LODMaxDeviation.size() != LODResources.size())
+	{
+		return false;
+	}
+	return Offset == Data.size();
 }
 
 FStaticMeshSceneProxy::FStaticMeshSceneProxy(UStaticMeshComponent* InComponent, bool bForceLODsShareStaticLighting)
@@ -152,6 +325,7 @@ bool FStaticMeshSceneProxy::GetMeshElement(
 	Element.NumPrimitives = Section.NumTriangles;
 	//Element.MaterialIndex = Section.MaterialIndex;
 	Element.IndexBuffer = RenderData->LODResources[LODIndex]->IndexBuffer.Get();
+	Element.IndexBufferFormat = RenderData->LODResources[LODIndex]->IndexBufferFormat;
 	OutMeshBatch.VertexFactory = &VFs.VertexFactory;
 	OutMeshBatch.Elements[0] = Element;
 
@@ -175,24 +349,67 @@ void FStaticMeshSceneProxy::GetLCIs(std::vector<FLightCacheInterface *>& LCIs)
 
 void FStaticMeshSceneProxy::DrawStaticElements(FPrimitiveSceneInfo* PrimitiveSceneInfo)
 {
-	const FStaticMeshLODResources& LODModel = *RenderData->LODResources[0];
-	for (uint32 SectionIndex = 0; SectionIndex < LODModel.Sections.size(); SectionIndex++)
+	for (uint32 LODIndex = 0; LODIndex < RenderData->LODResources.size(); LODIndex++)
 	{
-		const int32 NumBatches = GetNumMeshBatches();
-
-		for (int32 BatchIndex = 0; BatchIndex < NumBatches; BatchIndex++)
+		const FStaticMeshLODResources& LODModel = *RenderData->LODResources[LODIndex];
+		for (uint32 SectionIndex = 0; SectionIndex < LODModel.Sections.size(); SectionIndex++)
 		{
-			FMeshBatch MeshBatch;
+			const int32 NumBatches = GetNumMeshBatches();
 
-			if (GetMeshElement(0, BatchIndex, SectionIndex, /*PrimitiveDPG*/0, false, false, true, MeshBatch))
+			for (int32 BatchIndex = 0; BatchIndex < NumBatches; BatchIndex++)
 			{
-				PrimitiveSceneInfo->StaticMeshes.push_back(new FStaticMesh(PrimitiveSceneInfo, MeshBatch));
-				//PDI->DrawMesh(MeshBatch, FLT_MAX);
+				FMeshBatch MeshBatch;
+
+				if (GetMeshElement(LODIndex, BatchIndex, SectionIndex, /*PrimitiveDPG*/0, false, false, true, MeshBatch))
+				{
+					MeshBatch.LODIndex = FMeshBatch::QuantizeLODIndex(LODIndex);
+					PrimitiveSceneInfo->StaticMeshes.push_back(new FStaticMesh(PrimitiveSceneInfo, MeshBatch));
+					//PDI->DrawMesh(MeshBatch, FLT_MAX);
+				}
 			}
 		}
 	}
 }
 
+int32 FStaticMeshSceneProxy::GetLOD(const FSceneView* View) const
+{
+	const int32 NumLODs = (int32)FMath::Min(RenderData->LODResources.size(), RenderData->ScreenSize.size());
+	const FBoxSphereBounds& ProxyBounds = GetBounds();
+	const float ScreenDiameter = ComputeBoundsScreenSize(ProxyBounds.Origin, ProxyBounds.SphereRadius, *View);
+
+	// the last LOD whose screen size the bounds are still below
+	for (int32 LODIndex = NumLODs - 1; LODIndex > 0; --LODIndex)
+	{
+		if (RenderData->ScreenSize[LODIndex] > ScreenDiameter)
+		{
+			return LODIndex;
+		}
+	}
+	return 0;
+}
+
+int32 FStaticMeshSceneProxy::CollectOccluderElements(FOccluderElementsCollector& Collector) const
+{
+	if (RenderData->LODResources.empty())
+	{
+		return 0;
+	}
+
+	// LOD 0, reduced LODs can reach past the mesh's silhouette and would hide primitives beside it
+	const int32 LODIndex = 0;
+	for (const FLODInfo::FSectionInfo& Section : LODs[LODIndex]->Sections)
+	{
+		if (Section.Material && Section.Material->GetMaterialResource()->GetBlendMode() != BLEND_Opaque)
+		{
+			return 0;
+		}
+	}
+
+	const FStaticMeshLODResources& LODModel = *RenderData->LODResources[LODIndex];
+	Collector.AddElements(LODModel.VertexBuffers.PositionVertexBuffer, LODModel.Indices, GetLocalToWorld());
+	return (int32)(LODModel.Indices.size() / 3);
+}
+
 void FStaticMeshSceneProxy::GetDynamicMeshElements(const std::vector<const FSceneView*>& Views, const FSceneViewFamily& ViewFamily, uint32 VisibilityMap, FMeshElementCollector& Collector) const
 {
 
@@ -287,6 +504,56 @@ void UStaticMesh::PostLoad()
 	CalculateExtendedBounds();
 }
 
+bool UStaticMesh::PostLoadFromDerivedData()
+{
+	if (!HasSourceHash())
+	{
+		return false;
+	}
+
+	std::vector<uint8> DerivedData;
+	if (!GetDerivedDataCacheRef().GetSynchronous(GetDerivedDataKey(), DerivedData))
+	{
+		return false;
+	}
+
+	RenderData = std::make_unique<FStaticMeshRenderData>();
+	if (!RenderData->LoadFromDerivedData(DerivedData))
+	{
+		X_LOG("Discarding malformed derived data %s\n", GetDerivedDataKey().c_str());
+		RenderData.reset();
+		return false;
+	}
+
+	InitResources();
+
+	CalculateExtendedBounds();
+	return true;
+}
+
+// Change this whenever the static mesh build or the layout of FStaticMeshRenderData changes, it invalidates every cached entry
+#define STATICMESH_DERIVEDDATA_VER "8B1D4E7F02A34C6B9E5F71D2C0A86B3D"
+
+std::string UStaticMesh::GetDerivedDataKey() const
+{
+	static const char HexDigits[] = "0123456789ABCDEF";
+	std::string HashString;
+	for (uint8 Byte : SourceHash.Hash)
+	{
+		HashString += HexDigits[Byte >> 4];
+		HashString += HexDigits[Byte & 15];
+	}
+	// the build settings GetRenderMeshDescription hardcodes: comparison threshold, min lightmap resolution, lightmap UV version,
+	// whether the vertex streams are compact and the triangles every LOD keeps. The LOD screen sizes depend on the window,
+	// so the cache keeps the deviation of every LOD instead and InitResources sizes them for the window it runs in
+	std::string LODString = "_LOD";
+	for (const float PercentTriangles : GStaticMeshLODPercentTriangles)
+	{
+		LODString += "_" + std::to_string(FMath::RoundToInt(PercentTriangles * 1000.f));
+	}
+	return FDerivedDataCache::BuildCacheKey("STATICMESH", STATICMESH_DERIVEDDATA_VER, HashString + "_T2E-05_LM64_UV4" + (GCompactMeshVertexFormats ? "_CVF" : "") + (GFastLightmapUVPacking ? "_FUVP" : "") + LODString);
+}
+
 void UStaticMesh::GetRenderMeshDescription(const MeshDescription& InOriginalMeshDescription, MeshDescription& OutRenderMeshDescription)
 {
 	OutRenderMeshDescription = InOriginalMeshDescription;
@@ -296,9 +563,9 @@ void UStaticMesh::GetRenderMeshDescription(const MeshDescription& InOriginalMesh
 	MeshDescriptionOperations::CreatePolygonNTB(OutRenderMeshDescription, 0.f);
 
 	TMeshElementArray<MeshVertexInstance>& VertexInstanceArray = OutRenderMeshDescription.VertexInstances();
-	std::vector<FVector>& Normals = OutRenderMeshDescription.VertexInstanceAttributes().GetAttributes<FVector>(MeshAttribute::VertexInstance::Normal);
-	std::vector<FVector>& Tangents = OutRenderMeshDescription.VertexInstanceAttributes().GetAttributes<FVector>(MeshAttribute::VertexInstance::Tangent);
-	std::vector<float>& BinormalSigns = OutRenderMeshDescription.VertexInstanceAttributes().GetAttributes<float>(MeshAttribute::VertexInstance::BinormalSign);
+	TMeshAttributesRef<FVector> Normals = OutRenderMeshDescription.VertexInstanceAttributes().GetAttributesRef<FVector>(MeshAttribute::VertexInstance::Normal);
+	TMeshAttributesRef<FVector> Tangents = OutRenderMeshDescription.VertexInstanceAttributes().GetAttributesRef<FVector>(MeshAttribute::VertexInstance::Tangent);
+	TMeshAttributesRef<float> BinormalSigns = OutRenderMeshDescription.VertexInstanceAttributes().GetAttributesRef<float>(MeshAttribute::VertexInstance::BinormalSign);
 
 	MeshDescriptionOperations::FindOverlappingCorners(OverlappingCorners, OutRenderMeshDescription, ComparisonThreshold);
 
@@ -332,8 +599,8 @@ void UStaticMesh::GetRenderMeshDescription(const MeshDescription& InOriginalMesh
 	MeshDescriptionOperations::CreateMikktTangents(OutRenderMeshDescription, (MeshDescriptionOperations::ETangentOptions)TangentOptions);
 
 	
-	std::vector<std::vector<Vector2>>& VertexInstanceUVs = OutRenderMeshDescription.VertexInstanceAttributes().GetAttributesSet<Vector2>(MeshAttribute::VertexInstance::TextureCoordinate);
-	int32 NumIndices = (int32)VertexInstanceUVs.size();
+	TMeshAttributesRef<Vector2> VertexInstanceUVs = OutRenderMeshDescription.VertexInstanceAttributes().GetAttributesRef<Vector2>(MeshAttribute::VertexInstance::TextureCoordinate);
+	int32 NumIndices = VertexInstanceUVs.GetNumIndices();
 	//Verify the src light map channel
 // 	if (BuildSettings->SrcLightmapIndex >= NumIndices)
 // 	{
@@ -352,14 +619,15 @@ void UStaticMesh::GetRenderMeshDescription(const MeshDescription& InOriginalMesh
 // 		VertexInstanceUVs.SetNumIndices(BuildSettings->DstLightmapIndex + 1);
 // 		BuildSettings->DstLightmapIndex = NumIndices;
 // 	}
-	VertexInstanceUVs.resize(2);
-	VertexInstanceUVs[1].resize(VertexInstanceUVs[0].size());
-	MeshDescriptionOperations::CreateLightMapUVLayout(OutRenderMeshDescription,
+	VertexInstanceUVs.SetNumIndices(2);
+	const MeshDescriptionOperations::FLightmapUVPackingStatistics Statistics = MeshDescriptionOperations::CreateLightMapUVLayout(OutRenderMeshDescription,
 		/*BuildSettings->SrcLightmapIndex,*/0,
 		/*BuildSettings->DstLightmapIndex,*/1,
 		/*BuildSettings->MinLightmapResolution,*/64,
 		/*(MeshDescriptionOperations::ELightmapUVVersion)(StaticMesh->LightmapUVVersion),*/(MeshDescriptionOperations::ELightmapUVVersion)4,
 		OverlappingCorners);
+	X_LOG("Lightmap UVs: %u charts %s, %u rect and %u raster packings, %.1f%% texels used, %.3f ms\n", Statistics.NumCharts, Statistics.bSuccess ? "packed" : "not packed",
+		Statistics.NumRectPackings, Statistics.NumRasterPackings, Statistics.TexelUtilization * 100.f, Statistics.PackingMilliseconds);
 }
 
 UMaterial* UStaticMesh::GetMaterial(int32 MaterialIndex) const
@@ -8,6 +8,7 @@
 #include "FBXImporter.h"
 #include "PrimitiveComponent.h"
 #include "StaticMeshResources.h"
+#include "SecureHash.h"
 #include <unordered_map>
 
 struct StaticMeshBuildVertex
@@ -48,6 +49,11 @@ public:
 	virtual void ReleaseResources();
 
 	void PostLoad();
+	/**
+	* Fills RenderData from the derived data cache instead of building it from the MeshDescription.
+	* @return false if there is no source hash or no cached entry for it, the mesh has to be imported and built then
+	*/
+	bool PostLoadFromDerivedData();
 	void GetRenderMeshDescription(const MeshDescription& InOriginalMeshDescription, MeshDescription& OutRenderMeshDescription);
 
 	UMaterial* GetMaterial(int32 MaterialIndex) const;
@@ -57,13 +63,21 @@ public:
 	FBoxSphereBounds GetBounds() const;
 	FBox GetBoundingBox() const;
 
-	const std::multimap<int32, int32>& GetOverlappingCorners() const { return OverlappingCorners; }
+	const FOverlappingCornerAdjacency& GetOverlappingCorners() const { return OverlappingCorners; }
+
+	/** Hash of the source file the mesh is imported from, part of the derived data key */
+	void SetSourceHash(const FSHAHash& InSourceHash) { SourceHash = InSourceHash; }
+	bool HasSourceHash() const { return SourceHash != FSHAHash(); }
+	/** Key of the built render data in the derived data cache, changes with the source file and the build settings */
+	std::string GetDerivedDataKey() const;
 private:
 	MeshDescription MD;
 
+	FSHAHash SourceHash;
+
 	std::unique_ptr<class FStaticMeshRenderData> RenderData;
 
-	std::multimap<int32, int32> OverlappingCorners;
+	FOverlappingCornerAdjacency OverlappingCorners;
 
 	class UMaterial* Material;
 
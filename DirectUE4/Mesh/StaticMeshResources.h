@@ -3,12 +3,30 @@
 #include "VertexFactory.h"
 #include "PrimitiveSceneProxy.h"
 #include "SceneManagement.h"
+#include "PackedNormal.h"
+#include "PackedIndexBuffer.h"
+
+/**
+ * When set, built meshes store 8-bit SNORM tangents, half texture coordinates and 16-bit indices whenever every vertex
+ * is addressable with them, instead of full floats and 32-bit indices. The tangents lose up to half an SNORM step per
+ * component and the texture coordinates the precision of a half, so it is off unless -compactvertices turns it on.
+ */
+extern bool GCompactMeshVertexFormats;
+
+/**
+ * Fraction of the source triangles every LOD a static mesh build generates keeps, the first entry is LOD 0 and is always
+ * the full mesh. A mesh gets fewer LODs when reducing it any further does not remove triangles.
+ */
+extern std::vector<float> GStaticMeshLODPercentTriangles;
 
 struct FStaticMeshVertexBuffers
 {
 	/** The buffer containing vertex data. */
 	std::vector<Vector4> TangentsVertexBuffer;
 	std::vector<Vector2> TexCoordVertexBuffer;
+	/** TangentsVertexBuffer and TexCoordVertexBuffer after PackTangents and PackTexCoords, only one of each pair is filled */
+	std::vector<FPackedTangent> PackedTangentsVertexBuffer;
+	std::vector<FVector2DHalf> HalfTexCoordVertexBuffer;
 	/** The buffer containing the position vertex data. */
 	std::vector<FVector> PositionVertexBuffer;
 	/** The buffer containing the vertex color data. */
@@ -23,6 +41,25 @@ struct FStaticMeshVertexBuffers
 	ComPtr<ID3D11Buffer> PositionVertexBufferRHI = NULL;
 	ComPtr<ID3D11Buffer> ColorVertexBufferRHI = NULL;
 
+	/** Quantizes TangentsVertexBuffer to 8-bit SNORM and frees it */
+	void PackTangents();
+	/** Converts TexCoordVertexBuffer to halfs and frees it */
+	void PackTexCoords();
+
+	/** Bytes of one tangent basis vector, two per vertex, and how the GPU reads it */
+	uint32 GetTangentSize() const { return PackedTangentsVertexBuffer.empty() ? sizeof(Vector4) : sizeof(FPackedTangent); }
+	DXGI_FORMAT GetTangentFormat() const { return PackedTangentsVertexBuffer.empty() ? DXGI_FORMAT_R32G32B32A32_FLOAT : DXGI_FORMAT_R8G8B8A8_SNORM; }
+	const void* GetTangentData() const { return PackedTangentsVertexBuffer.empty() ? (const void*)TangentsVertexBuffer.data() : (const void*)PackedTangentsVertexBuffer.data(); }
+	uint32 GetTangentDataSize() const { return (uint32)(TangentsVertexBuffer.size() * sizeof(Vector4) + PackedTangentsVertexBuffer.size() * sizeof(FPackedTangent)); }
+
+	/** Bytes of one texture coordinate and how the GPU reads it */
+	uint32 GetTexCoordSize() const { return HalfTexCoordVertexBuffer.empty() ? sizeof(Vector2) : sizeof(FVector2DHalf); }
+	DXGI_FORMAT GetTexCoordFormat() const { return HalfTexCoordVertexBuffer.empty() ? DXGI_FORMAT_R32G32_FLOAT : DXGI_FORMAT_R16G16_FLOAT; }
+	const void* GetTexCoordData() const { return HalfTexCoordVertexBuffer.empty() ? (const void*)TexCoordVertexBuffer.data() : (const void*)HalfTexCoordVertexBuffer.data(); }
+	uint32 GetTexCoordDataSize() const { return (uint32)(TexCoordVertexBuffer.size() * sizeof(Vector2) + HalfTexCoordVertexBuffer.size() * sizeof(FVector2DHalf)); }
+
+	/** Bytes all streams take on the GPU, or would take with full precision tangents and texture coordinates */
+	uint32 GetAllocatedSize(bool bAsFullPrecision = false) const;
 };
 
 class UStaticMesh;
@@ -45,6 +82,8 @@ struct FStaticMeshLODResources
 	
 	std::vector<uint32> Indices;
 	ComPtr<ID3D11Buffer> IndexBuffer = NULL;
+	/** Format InitResources created IndexBuffer with */
+	DXGI_FORMAT IndexBufferFormat = DXGI_FORMAT_R32_UINT;
 
 	//std::vector<LocalVertex> Vertices;
 	//std::vector<PositionOnlyLocalVertex> PositionOnlyVertices;
@@ -54,6 +93,14 @@ struct FStaticMeshLODResources
 	void InitResources();
 	void ReleaseResources();
 
+	/** sizeof(uint16) when GCompactMeshVertexFormats is set and the largest vertex index fits, sizeof(uint32) otherwise */
+	uint8 GetIndexDataTypeSize() const
+	{
+		return ChooseIndexDataTypeSize(VertexBuffers.PositionVertexBuffer.size(), GCompactMeshVertexFormats);
+	}
+
+	/** Logs the bytes the vertex and index buffers take on the GPU against full precision streams and 32-bit indices */
+	void LogMemorySavings() const;
 };
 
 struct FStaticMeshVertexFactories
@@ -72,10 +119,24 @@ public:
 	std::vector<FStaticMeshLODResources*> LODResources;
 	std::vector<FStaticMeshVertexFactories*> LODVertexFactories;
 
+	/** Screen size, the projected bounding sphere diameter over the view size, below which each LOD is drawn. LOD 0 has 1. */
+	std::vector<float> ScreenSize;
+
+	/** Largest distance of each LOD from the source mesh, LOD 0 has 0. Unlike ScreenSize it does not depend on the window */
+	std::vector<float> LODMaxDeviation;
+
 	void AllocateLODResources(int32 NumLODs);
 
 	void Cache(UStaticMesh* Owner/*, const FStaticMeshLODSettings& LODSettings*/);
 
+	/** Sizes ScreenSize for the current window from LODMaxDeviation and the bounds */
+	void ComputeScreenSizes();
+
+	/** Writes bounds, vertex and index buffers, sections and the deviation of every LOD to OutData */
+	void SaveToDerivedData(std::vector<uint8>& OutData) const;
+	/** Reads what SaveToDerivedData wrote, returns false if Data is truncated or malformed */
+	bool LoadFromDerivedData(const std::vector<uint8>& Data);
+
 	void InitResources(const UStaticMesh* Owner);
 	void ReleaseResources();
 };
@@ -111,10 +172,14 @@ public:
 
 	virtual void DrawStaticElements(FPrimitiveSceneInfo* PrimitiveSceneInfo) override;
 
+	virtual int32 GetLOD(const FSceneView* View) const override;
+
 	virtual void GetDynamicMeshElements(const std::vector<const FSceneView*>& Views, const FSceneViewFamily& ViewFamily, uint32 VisibilityMap, FMeshElementCollector& Collector) const override;
 
 	virtual FPrimitiveViewRelevance GetViewRelevance(const FSceneView* View) const override;
 
+	virtual int32 CollectOccluderElements(FOccluderElementsCollector& Collector) const override;
+
 	//virtual void GetLightRelevance(const FLightSceneProxy* LightSceneProxy, bool& bDynamic, bool& bRelevant, bool& bLightMapped, bool& bShadowMapped) const override;
 
 	virtual void GetLCIs(std::vector<FLightCacheInterface*>& LCIs) override;
@@ -598,7 +598,7 @@ bool FSceneRenderer::RenderBasePassStaticData(FViewInfo& View, const FDrawingPol
 bool FSceneRenderer::RenderBasePassStaticDataType(FViewInfo& View, const FDrawingPolicyRenderState& DrawRenderState, const EBasePassDrawListType DrawType)
 {
 	bool bDirty = false;
-	bDirty |= Scene->BasePassUniformLightMapPolicyDrawList[DrawType].DrawVisible(D3D11DeviceContext, View, DrawRenderState/*, View.StaticMeshVisibilityMap, View.StaticMeshBatchVisibility*/);
+	bDirty |= Scene->BasePassUniformLightMapPolicyDrawList[DrawType].DrawVisible(D3D11DeviceContext, View, DrawRenderState, View.StaticMeshVisibilityMap/*, View.StaticMeshBatchVisibility*/);
 	return bDirty;
 }
 
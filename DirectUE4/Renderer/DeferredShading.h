@@ -7,6 +7,8 @@
 #include "RenderTargets.h"
 #include "LightSceneInfo.h"
 #include "DepthOnlyRendering.h"
+#include "BitArray.h"
+#include "LightGridInjection.h"
 
 extern uint32 GFrameNumberRenderThread;
 extern uint32 GFrameNumber;
@@ -406,7 +408,7 @@ public:
 	FViewUniformShaderParameters* CachedViewUniformShaderParameters;
 
 	/** A map from primitive ID to a boolean visibility value. */
-	std::vector<bool> PrimitiveVisibilityMap;
+	FBitArray PrimitiveVisibilityMap;
 
 	/** Bit set when a primitive is known to be unoccluded. */
 	//FSceneBitArray PrimitiveDefinitelyUnoccludedMap;
@@ -469,6 +471,9 @@ public:
 	/** A map from light ID to a boolean visibility value. */
 	std::vector<FVisibleLightViewInfo> VisibleLightInfos;
 
+	/** Clustered light grid of the local lights without shadows, light functions or light profiles, built by RenderLights when GComputeLightGrid is set to cull the unshadowed lights. */
+	FForwardLightingViewResources ForwardLightingResources;
+
 	/** The view's batched elements. */
 	//FBatchedElements BatchedViewElements;
 
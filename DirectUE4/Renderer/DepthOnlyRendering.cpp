@@ -190,7 +190,7 @@ void FSceneRenderer::RenderPrePassView(FViewInfo& View, const FDrawingPolicyRend
 
 	{
 		SCOPED_DRAW_EVENT(PosOnlyOpaque);
-		Scene->PositionOnlyDepthDrawList.DrawVisible(D3D11DeviceContext, View, DrawRenderState);
+		Scene->PositionOnlyDepthDrawList.DrawVisible(D3D11DeviceContext, View, DrawRenderState, View.StaticMeshVisibilityMap);
 	}
 
 	{
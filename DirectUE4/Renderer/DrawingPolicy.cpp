@@ -35,7 +35,7 @@ void FMeshDrawingPolicy::DrawMesh(ID3D11DeviceContext* Context, const FSceneView
 	SetInstanceParameters(View, BatchElement.BaseVertexIndex, 0, InstanceCount);
 
 	CommitNonComputeShaderConstants();
-	Context->IASetIndexBuffer((ID3D11Buffer*)BatchElement.IndexBuffer,DXGI_FORMAT_R32_UINT,0);
+	Context->IASetIndexBuffer((ID3D11Buffer*)BatchElement.IndexBuffer,BatchElement.IndexBufferFormat,0);
 	Context->DrawIndexed(BatchElement.NumPrimitives*3, BatchElement.FirstIndex, BatchElement.BaseVertexIndex);
 	ClearRenderState();
 }
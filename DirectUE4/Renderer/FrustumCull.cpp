@@ -0,0 +1,205 @@
+#include "FrustumCull.h"
+#include "ConvexVolume.h"
+#include "BitArray.h"
+#include "VectorRegister.h"
+#include "ParallelFor.h"
+
+#include <algorithm>
+#include <cfloat>
+
+bool GVectorizedFrustumCull = true;
+
+/** Primitives culled by one FrustumCullPrimitives task, a whole number of visibility words */
+static const int32 GFrustumCullPrimitivesPerTask = 4096;
+
+template<bool UseCustomCulling, bool bAlsoUseSphereTest>
+static void FrustumCullScalar(const std::vector<FPrimitiveBounds>& PrimitiveBounds, const FConvexVolume& ViewFrustum, const FVector& ViewOriginForDistanceCulling, FBitArray& PrimitiveVisibilityMap)
+{
+	const uint32 NumPrimiteves = PrimitiveBounds.size();
+	PrimitiveVisibilityMap.Init(false, NumPrimiteves);
+
+	float FadeRadius = 0;// GDisableLODFade ? 0.0f : GDistanceFadeMaxTravel;
+
+	for (uint32 PrimitiveIndex = 0; PrimitiveIndex < NumPrimiteves; PrimitiveIndex++)
+	{
+		int32 Index = PrimitiveIndex /** NumBitsPerDWORD + BitSubIndex*/;
+		const FPrimitiveBounds& Bounds = PrimitiveBounds[Index];
+		float DistanceSquared = (Bounds.BoxSphereBounds.Origin - ViewOriginForDistanceCulling).SizeSquared();
+		int32 VisibilityId = INDEX_NONE;
+
+		float MaxDrawDistance = Bounds.MaxCullDistance < FLT_MAX ? Bounds.MaxCullDistance /** MaxDrawDistanceScale*/ : FLT_MAX;
+		float MinDrawDistanceSq = Bounds.MinDrawDistanceSq;
+
+		if (DistanceSquared > FMath::Square(MaxDrawDistance + FadeRadius) ||
+			(DistanceSquared < MinDrawDistanceSq) ||
+			//(UseCustomCulling && !View.CustomVisibilityQuery->IsVisible(VisibilityId, FBoxSphereBounds(Bounds.BoxSphereBounds.Origin, Bounds.BoxSphereBounds.BoxExtent, Bounds.BoxSphereBounds.SphereRadius))) ||
+			(bAlsoUseSphereTest && ViewFrustum.IntersectSphere(Bounds.BoxSphereBounds.Origin, Bounds.BoxSphereBounds.SphereRadius) == false) ||
+			ViewFrustum.IntersectBox(Bounds.BoxSphereBounds.Origin, Bounds.BoxSphereBounds.BoxExtent) == false
+			)
+		{
+
+		}
+		else
+		{
+			if (DistanceSquared > FMath::Square(MaxDrawDistance))
+			{
+				//FadingBits |= Mask;
+			}
+			else
+			{
+				PrimitiveVisibilityMap.SetBit(Index, true);
+			}
+		}
+	}
+}
+
+void FrustumCullPrimitivesScalar(const std::vector<FPrimitiveBounds>& PrimitiveBounds, const FConvexVolume& ViewFrustum, const FVector& ViewOrigin, FBitArray& OutVisibilityMap)
+{
+	FrustumCullScalar<true, true>(PrimitiveBounds, ViewFrustum, ViewOrigin, OutVisibilityMap);
+}
+
+void FrustumCullPrimitives(const FPrimitiveCullingBounds& CullingBounds, const FConvexVolume& ViewFrustum, const FVector& ViewOrigin, FBitArray& OutVisibilityMap, bool bForceSingleThread)
+{
+	const int32 NumPrimitives = CullingBounds.Num();
+	OutVisibilityMap.Init(false, NumPrimitives);
+
+	// Splat every plane once, the loop below tests four primitives against one plane at a time
+	struct FSplatPlane
+	{
+		VectorRegister X, Y, Z, W;
+		VectorRegister AbsX, AbsY, AbsZ;
+	};
+	std::vector<FSplatPlane> Planes(ViewFrustum.PermutedPlanes.size());
+	for (uint32 Group = 0; Group < ViewFrustum.PermutedPlanes.size(); Group += 4)
+	{
+		const VectorRegister PlanesX = VectorLoadAligned(&ViewFrustum.PermutedPlanes[Group + 0]);
+		const VectorRegister PlanesY = VectorLoadAligned(&ViewFrustum.PermutedPlanes[Group + 1]);
+		const VectorRegister PlanesZ = VectorLoadAligned(&ViewFrustum.PermutedPlanes[Group + 2]);
+		const VectorRegister PlanesW = VectorLoadAligned(&ViewFrustum.PermutedPlanes[Group + 3]);
+		const VectorRegister Splats[4][4] =
+		{
+			{ VectorReplicate(PlanesX, 0), VectorReplicate(PlanesY, 0), VectorReplicate(PlanesZ, 0), VectorReplicate(PlanesW, 0) },
+			{ VectorReplicate(PlanesX, 1), VectorReplicate(PlanesY, 1), VectorReplicate(PlanesZ, 1), VectorReplicate(PlanesW, 1) },
+			{ VectorReplicate(PlanesX, 2), VectorReplicate(PlanesY, 2), VectorReplicate(PlanesZ, 2), VectorReplicate(PlanesW, 2) },
+			{ VectorReplicate(PlanesX, 3), VectorReplicate(PlanesY, 3), VectorReplicate(PlanesZ, 3), VectorReplicate(PlanesW, 3) },
+		};
+		for (int32 Lane = 0; Lane < 4; ++Lane)
+		{
+			FSplatPlane& Plane = Planes[Group + Lane];
+			Plane.X = Splats[Lane][0];
+			Plane.Y = Splats[Lane][1];
+			Plane.Z = Splats[Lane][2];
+			Plane.W = Splats[Lane][3];
+			Plane.AbsX = VectorAbs(Plane.X);
+			Plane.AbsY = VectorAbs(Plane.Y);
+			Plane.AbsZ = VectorAbs(Plane.Z);
+		}
+	}
+
+	const VectorRegister ViewOriginX = VectorSetFloat1(ViewOrigin.X);
+	const VectorRegister ViewOriginY = VectorSetFloat1(ViewOrigin.Y);
+	const VectorRegister ViewOriginZ = VectorSetFloat1(ViewOrigin.Z);
+	const int32 NumPaddedPrimitives = (int32)CullingBounds.OriginX.size();
+	uint32* VisibilityWords = OutVisibilityMap.GetData();
+
+	const int32 NumTasks = (NumPrimitives + GFrustumCullPrimitivesPerTask - 1) / GFrustumCullPrimitivesPerTask;
+	ParallelFor(NumTasks, [&](int32 TaskIndex)
+	{
+		const int32 FirstWord = TaskIndex * (GFrustumCullPrimitivesPerTask / FBitArray::NumBitsPerWord);
+		const int32 EndWord = FMath::Min(FirstWord + GFrustumCullPrimitivesPerTask / FBitArray::NumBitsPerWord, OutVisibilityMap.NumWords());
+		for (int32 WordIndex = FirstWord; WordIndex < EndWord; ++WordIndex)
+		{
+			const int32 FirstPrimitive = WordIndex * FBitArray::NumBitsPerWord;
+			const int32 EndPrimitive = FMath::Min(FirstPrimitive + (int32)FBitArray::NumBitsPerWord, NumPaddedPrimitives);
+			uint32 VisibilityWord = 0;
+			for (int32 Index = FirstPrimitive; Index < EndPrimitive; Index += 4)
+			{
+				const VectorRegister OriginX = VectorLoad(&CullingBounds.OriginX[Index]);
+				const VectorRegister OriginY = VectorLoad(&CullingBounds.OriginY[Index]);
+				const VectorRegister OriginZ = VectorLoad(&CullingBounds.OriginZ[Index]);
+				const VectorRegister ExtentX = VectorLoad(&CullingBounds.ExtentX[Index]);
+				const VectorRegister ExtentY = VectorLoad(&CullingBounds.ExtentY[Index]);
+				const VectorRegister ExtentZ = VectorLoad(&CullingBounds.ExtentZ[Index]);
+				const VectorRegister Radius = VectorLoad(&CullingBounds.SphereRadius[Index]);
+
+				// Distance culling, with the same operations in the same order as FVector::SizeSquared
+				const VectorRegister DeltaX = VectorSubtract(OriginX, ViewOriginX);
+				const VectorRegister DeltaY = VectorSubtract(OriginY, ViewOriginY);
+				const VectorRegister DeltaZ = VectorSubtract(OriginZ, ViewOriginZ);
+				const VectorRegister DistanceSquared = VectorMultiplyAdd(DeltaZ, DeltaZ, VectorMultiplyAdd(DeltaY, DeltaY, VectorMultiply(DeltaX, DeltaX)));
+				VectorRegister Culled = VectorBitwiseOr(
+					VectorCompareGT(DistanceSquared, VectorLoad(&CullingBounds.MaxCullDistanceSq[Index])),
+					VectorCompareLT(DistanceSquared, VectorLoad(&CullingBounds.MinDrawDistanceSq[Index])));
+
+				// A primitive is outside once its sphere or box is entirely in front of any plane, as in FConvexVolume::IntersectSphere and IntersectBox
+				for (const FSplatPlane& Plane : Planes)
+				{
+					const VectorRegister DistX = VectorMultiply(OriginX, Plane.X);
+					const VectorRegister DistY = VectorMultiplyAdd(OriginY, Plane.Y, DistX);
+					const VectorRegister DistZ = VectorMultiplyAdd(OriginZ, Plane.Z, DistY);
+					const VectorRegister Distance = VectorSubtract(DistZ, Plane.W);
+					const VectorRegister PushX = VectorMultiply(ExtentX, Plane.AbsX);
+					const VectorRegister PushY = VectorMultiplyAdd(ExtentY, Plane.AbsY, PushX);
+					const VectorRegister PushOut = VectorMultiplyAdd(ExtentZ, Plane.AbsZ, PushY);
+					Culled = VectorBitwiseOr(Culled, VectorBitwiseOr(VectorCompareGT(Distance, Radius), VectorCompareGT(Distance, PushOut)));
+				}
+
+				VisibilityWord |= (~VectorMaskBits(Culled) & 0xf) << (Index - FirstPrimitive);
+			}
+
+			// The padding past the last primitive must not show up as visible
+			if (FirstPrimitive + (int32)FBitArray::NumBitsPerWord > NumPrimitives)
+			{
+				VisibilityWord &= (1u << (NumPrimitives - FirstPrimitive)) - 1;
+			}
+			VisibilityWords[WordIndex] = VisibilityWord;
+		}
+	}, bForceSingleThread);
+}
+
+void FPrimitiveCullingBounds::Add(const FPrimitiveBounds& Bounds)
+{
+	SetNum(NumPrimitives + 1);
+	Set(NumPrimitives - 1, Bounds);
+}
+
+void FPrimitiveCullingBounds::Set(int32 Index, const FPrimitiveBounds& Bounds)
+{
+	const FBoxSphereBounds& BoxSphereBounds = Bounds.BoxSphereBounds;
+	OriginX[Index] = BoxSphereBounds.Origin.X;
+	OriginY[Index] = BoxSphereBounds.Origin.Y;
+	OriginZ[Index] = BoxSphereBounds.Origin.Z;
+	ExtentX[Index] = FMath::Abs(BoxSphereBounds.BoxExtent.X);
+	ExtentY[Index] = FMath::Abs(BoxSphereBounds.BoxExtent.Y);
+	ExtentZ[Index] = FMath::Abs(BoxSphereBounds.BoxExtent.Z);
+	SphereRadius[Index] = BoxSphereBounds.SphereRadius;
+	MinDrawDistanceSq[Index] = Bounds.MinDrawDistanceSq;
+	MaxCullDistanceSq[Index] = FMath::Square(Bounds.MaxCullDistance < FLT_MAX ? Bounds.MaxCullDistance : FLT_MAX);
+}
+
+void FPrimitiveCullingBounds::RemoveAtSwap(int32 Index)
+{
+	const int32 LastIndex = NumPrimitives - 1;
+	if (Index != LastIndex)
+	{
+		std::vector<float>* Components[] = { &OriginX, &OriginY, &OriginZ, &ExtentX, &ExtentY, &ExtentZ, &SphereRadius, &MinDrawDistanceSq, &MaxCullDistanceSq };
+		for (std::vector<float>* Component : Components)
+		{
+			(*Component)[Index] = (*Component)[LastIndex];
+		}
+	}
+	SetNum(LastIndex);
+}
+
+void FPrimitiveCullingBounds::SetNum(int32 NewNum)
+{
+	// Slots past the last primitive are empty bounds at the origin, whatever they test is masked out
+	const int32 NumPadded = (NewNum + 3) & ~3;
+	std::vector<float>* Components[] = { &OriginX, &OriginY, &OriginZ, &ExtentX, &ExtentY, &ExtentZ, &SphereRadius, &MinDrawDistanceSq, &MaxCullDistanceSq };
+	for (std::vector<float>* Component : Components)
+	{
+		Component->resize(NumPadded, 0.f);
+		std::fill(Component->begin() + NewNum, Component->end(), 0.f);
+	}
+	NumPrimitives = NewNum;
+}
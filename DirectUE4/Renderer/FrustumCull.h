@@ -0,0 +1,74 @@
+#pragma once
+
+#include "UnrealMath.h"
+
+#include <vector>
+
+struct FConvexVolume;
+class FBitArray;
+
+/**
+* Bounding information used to cull primitives in the scene.
+*/
+struct FPrimitiveBounds
+{
+	FBoxSphereBounds BoxSphereBounds;
+	/** Square of the minimum draw distance for the primitive. */
+	float MinDrawDistanceSq;
+	/** Maximum draw distance for the primitive. */
+	float MaxDrawDistance;
+	/** Maximum cull distance for the primitive. This is only different from the MaxDrawDistance for HLOD.*/
+	float MaxCullDistance;
+};
+
+/**
+* FScene::PrimitiveBounds with one array per component, so four primitives at a time can be culled with vector registers.
+* The arrays are padded with empty bounds to a multiple of four primitives.
+*/
+struct FPrimitiveCullingBounds
+{
+	std::vector<float> OriginX;
+	std::vector<float> OriginY;
+	std::vector<float> OriginZ;
+	/** Absolute box extents */
+	std::vector<float> ExtentX;
+	std::vector<float> ExtentY;
+	std::vector<float> ExtentZ;
+	std::vector<float> SphereRadius;
+	std::vector<float> MinDrawDistanceSq;
+	/** Square of the maximum cull distance, infinite for primitives without one */
+	std::vector<float> MaxCullDistanceSq;
+
+	int32 Num() const { return NumPrimitives; }
+
+	void Add(const FPrimitiveBounds& Bounds);
+	void Set(int32 Index, const FPrimitiveBounds& Bounds);
+	/** Removes the primitive at Index, the last primitive moves into its place as it does in FScene's packed arrays */
+	void RemoveAtSwap(int32 Index);
+
+private:
+	void SetNum(int32 NewNum);
+
+	int32 NumPrimitives = 0;
+};
+
+/**
+* Whether views are frustum culled four primitives at a time from FScene::PrimitiveCullingBounds, on worker threads for
+* large scenes, instead of one primitive at a time from FScene::PrimitiveBounds.
+*/
+extern bool GVectorizedFrustumCull;
+
+/**
+* Sets the bits of the primitives within their draw distances of ViewOrigin whose bounding sphere and box intersect
+* ViewFrustum, one primitive at a time.
+* @param OutVisibilityMap - resized to the number of primitives
+*/
+void FrustumCullPrimitivesScalar(const std::vector<FPrimitiveBounds>& PrimitiveBounds, const FConvexVolume& ViewFrustum, const FVector& ViewOrigin, FBitArray& OutVisibilityMap);
+
+/**
+* Same results as FrustumCullPrimitivesScalar. Tests four primitives at a time against the frustum's permuted planes and
+* splits the primitives into word aligned ranges that workers fill a word of 32 visibility bits at a time.
+* @param OutVisibilityMap - resized to the number of primitives
+* @param bForceSingleThread - cull every range on the calling thread
+*/
+void FrustumCullPrimitives(const FPrimitiveCullingBounds& CullingBounds, const FConvexVolume& ViewFrustum, const FVector& ViewOrigin, FBitArray& OutVisibilityMap, bool bForceSingleThread = false);
@@ -0,0 +1,392 @@
+#include "LightGridInjection.h"
+#include "ParallelFor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+bool GComputeLightGrid = false;
+int32 GLightGridPixelSize = 64;
+int32 GLightGridSizeZ = 32;
+
+/** Light indices stored in CulledLightDataGrid are 16 bit */
+static const int32 GMaxCulledLocalLights = MAX_uint16 + 1;
+
+/** View space far edge of the last depth slice, which catches everything behind the furthest light */
+static const float GLightGridMaxSliceDepth = 2000000.0f;
+
+FVector GetLightGridZParams(float NearPlane, float FarPlane, int32 GridSizeZ)
+{
+	// Slice 0 ends a little after the near plane, as almost no surfaces are closer than that
+	const double NearOffset = .095 * 100;
+	// Space out the slices so they aren't all clustered at the near plane
+	const double S = 4.05;
+
+	const double N = NearPlane + NearOffset;
+	// Keep the slices ordered when every light is in front of the near offset
+	const double F = FMath::Max<double>(FarPlane, N + 1.0);
+
+	const double O = (F - N * std::exp2((GridSizeZ - 1) / S)) / (F - N);
+	const double B = (1 - O) / N;
+
+	return FVector((float)B, (float)O, (float)S);
+}
+
+int32 FForwardLightingViewResources::GetZSlice(float ViewDepth) const
+{
+	const float Value = ViewDepth * LightGridZParams.X + LightGridZParams.Y;
+	const int32 ZSlice = Value > 1.0f ? FMath::FloorToInt(FMath::Log2(Value) * LightGridZParams.Z) : 0;
+	return FMath::Clamp(ZSlice, 0, CulledGridSize.Z - 1);
+}
+
+/** A light prepared for culling, in the view space of the grid */
+struct FLightGridCullingLight
+{
+	FVector Center;
+	float Radius;
+	float RadiusSquared;
+	/** Whether the cone test applies, only spot lights narrower than a half space have one */
+	bool bCone;
+	FVector ConeAxis;
+	float ConeAngleCos;
+	float ConeAngleSin;
+};
+
+/** View space boxes of the cells of a grid, which are the product of a column interval, a row interval and a depth interval */
+struct FLightGridCellBounds
+{
+	std::vector<float> ColumnMin, ColumnMax;
+	std::vector<float> RowMin, RowMax;
+	float DepthMin, DepthMax;
+};
+
+/** Near view space depth of ZSlice, slice GridSizeZ being the far edge of the last one */
+static float GetZSliceDepth(const FForwardLightingViewResources& LightGrid, int32 ZSlice)
+{
+	if (ZSlice == 0)
+	{
+		return 0.0f;
+	}
+	if (ZSlice == LightGrid.CulledGridSize.Z)
+	{
+		return GLightGridMaxSliceDepth;
+	}
+	const FVector& ZParams = LightGrid.LightGridZParams;
+	return (std::exp2(ZSlice / ZParams.Z) - ZParams.Y) / ZParams.X;
+}
+
+/**
+ * View space interval a screen interval, given in NDC, covers between two depths. Positions along an axis are
+ * (NDC - ProjectionOffset) * Depth / ProjectionScale, linear in both, so the interval is spanned by the four corners.
+ */
+static void GetViewSpaceInterval(float NDCMin, float NDCMax, float ProjectionScale, float ProjectionOffset, float DepthMin, float DepthMax, float& OutMin, float& OutMax)
+{
+	const float A = (NDCMin - ProjectionOffset) * DepthMin / ProjectionScale;
+	const float B = (NDCMin - ProjectionOffset) * DepthMax / ProjectionScale;
+	const float C = (NDCMax - ProjectionOffset) * DepthMin / ProjectionScale;
+	const float D = (NDCMax - ProjectionOffset) * DepthMax / ProjectionScale;
+	OutMin = FMath::Min(FMath::Min(A, B), FMath::Min(C, D));
+	OutMax = FMath::Max(FMath::Max(A, B), FMath::Max(C, D));
+}
+
+static void GetCellBounds(const FLightGridView& View, const FForwardLightingViewResources& LightGrid, int32 ZSlice, FLightGridCellBounds& OutBounds)
+{
+	const FIntVector& GridSize = LightGrid.CulledGridSize;
+	const FMatrix& Projection = View.ProjectionMatrix;
+
+	OutBounds.DepthMin = GetZSliceDepth(LightGrid, ZSlice);
+	OutBounds.DepthMax = GetZSliceDepth(LightGrid, ZSlice + 1);
+
+	OutBounds.ColumnMin.resize(GridSize.X);
+	OutBounds.ColumnMax.resize(GridSize.X);
+	for (int32 X = 0; X < GridSize.X; X++)
+	{
+		const float NDCMin = (float)(X * LightGrid.LightGridPixelSize) / View.ViewSize.X * 2.0f - 1.0f;
+		const float NDCMax = (float)((X + 1) * LightGrid.LightGridPixelSize) / View.ViewSize.X * 2.0f - 1.0f;
+		GetViewSpaceInterval(NDCMin, NDCMax, Projection.M[0][0], Projection.M[2][0], OutBounds.DepthMin, OutBounds.DepthMax, OutBounds.ColumnMin[X], OutBounds.ColumnMax[X]);
+	}
+
+	// Rows go down the screen, NDC Y up
+	OutBounds.RowMin.resize(GridSize.Y);
+	OutBounds.RowMax.resize(GridSize.Y);
+	for (int32 Y = 0; Y < GridSize.Y; Y++)
+	{
+		const float NDCMin = 1.0f - (float)((Y + 1) * LightGrid.LightGridPixelSize) / View.ViewSize.Y * 2.0f;
+		const float NDCMax = 1.0f - (float)(Y * LightGrid.LightGridPixelSize) / View.ViewSize.Y * 2.0f;
+		GetViewSpaceInterval(NDCMin, NDCMax, Projection.M[1][1], Projection.M[2][1], OutBounds.DepthMin, OutBounds.DepthMax, OutBounds.RowMin[Y], OutBounds.RowMax[Y]);
+	}
+}
+
+/** Squared distance from Value to the interval, 0 inside it */
+static inline float IntervalDistanceSquared(float Value, float Min, float Max)
+{
+	const float Distance = FMath::Max(0.0f, FMath::Max(Min - Value, Value - Max));
+	return Distance * Distance;
+}
+
+/** Whether the sphere of Light overlaps a cell, given the squared distances from its center to the three intervals of the cell */
+static inline bool IsSphereInCell(const FLightGridCullingLight& Light, float DistanceSquaredX, float DistanceSquaredY, float DistanceSquaredZ)
+{
+	return (DistanceSquaredX + DistanceSquaredY) + DistanceSquaredZ <= Light.RadiusSquared;
+}
+
+/** Bounding sphere of the box of cell X, Y of the slice Bounds were set up for */
+static void GetCellBoundingSphere(const FLightGridCellBounds& Bounds, int32 X, int32 Y, FVector& OutCenter, float& OutRadius)
+{
+	const FVector BoxMin(Bounds.ColumnMin[X], Bounds.RowMin[Y], Bounds.DepthMin);
+	const FVector BoxMax(Bounds.ColumnMax[X], Bounds.RowMax[Y], Bounds.DepthMax);
+	OutCenter = (BoxMin + BoxMax) * 0.5f;
+	OutRadius = ((BoxMax - BoxMin) * 0.5f).Size();
+}
+
+/** Whether the cone of a spot light overlaps the bounding sphere of a cell, conservatively */
+static bool IsConeInCell(const FLightGridCullingLight& Light, const FVector& SphereCenter, float SphereRadius)
+{
+	if (!Light.bCone)
+	{
+		return true;
+	}
+	// Move the apex back so the cone grows by the sphere radius, the sphere center has to be inside that cone
+	const FVector ExpandedApex = Light.Center - Light.ConeAxis * (SphereRadius / Light.ConeAngleSin);
+	FVector D = SphereCenter - ExpandedApex;
+	float DistanceSquared = FVector::DotProduct(D, D);
+	float E = FVector::DotProduct(Light.ConeAxis, D);
+	if (E > 0.0f && E * E >= DistanceSquared * Light.ConeAngleCos * Light.ConeAngleCos)
+	{
+		// Behind the real apex only a sphere around it reaches into the cone
+		D = SphereCenter - Light.Center;
+		DistanceSquared = FVector::DotProduct(D, D);
+		E = -FVector::DotProduct(Light.ConeAxis, D);
+		if (E > 0.0f && E * E >= DistanceSquared * Light.ConeAngleSin * Light.ConeAngleSin)
+		{
+			return DistanceSquared <= SphereRadius * SphereRadius;
+		}
+		return true;
+	}
+	return false;
+}
+
+/** Fills everything of OutLightGrid but its cells, and the view space lights to cull */
+static void SetupLightGrid(const FLightGridView& View, const std::vector<FForwardLocalLight>& Lights, FForwardLightingViewResources& OutLightGrid, std::vector<FLightGridCullingLight>& OutCullingLights)
+{
+	const int32 NumLocalLights = FMath::Min((int32)Lights.size(), GMaxCulledLocalLights);
+
+	OutLightGrid.NumLocalLights = NumLocalLights;
+	OutLightGrid.LightGridPixelSize = GLightGridPixelSize;
+	OutLightGrid.CulledGridSize = FIntVector(
+		FMath::DivideAndRoundUp(View.ViewSize.X, GLightGridPixelSize),
+		FMath::DivideAndRoundUp(View.ViewSize.Y, GLightGridPixelSize),
+		GLightGridSizeZ);
+	OutLightGrid.ForwardLocalLightBuffer.resize(NumLocalLights * ForwardLocalLightDataStride);
+
+	OutCullingLights.resize(NumLocalLights);
+	float FurthestLight = 1.0f;
+	for (int32 LightIndex = 0; LightIndex < NumLocalLights; LightIndex++)
+	{
+		const FLightParameters& Parameters = Lights[LightIndex].Parameters;
+
+		Vector4* LightData = &OutLightGrid.ForwardLocalLightBuffer[LightIndex * ForwardLocalLightDataStride];
+		LightData[0] = Parameters.LightPositionAndInvRadius;
+		LightData[1] = Parameters.LightColorAndFalloffExponent;
+		LightData[2] = Vector4(Parameters.NormalizedLightDirection, Parameters.SpecularScale);
+		LightData[3] = Vector4(Parameters.SpotAngles.X, Parameters.SpotAngles.Y, Parameters.LightSourceRadius, Parameters.LightSourceLength);
+		LightData[4] = Vector4(Parameters.NormalizedLightTangent, Parameters.LightSoftSourceRadius);
+
+		const Vector4& PositionAndInvRadius = Parameters.LightPositionAndInvRadius;
+		const Vector4 ViewCenter = View.ViewMatrix.TransformPosition(FVector(PositionAndInvRadius.X, PositionAndInvRadius.Y, PositionAndInvRadius.Z));
+
+		FLightGridCullingLight& CullingLight = OutCullingLights[LightIndex];
+		CullingLight.Center = FVector(ViewCenter.X, ViewCenter.Y, ViewCenter.Z);
+		// A light without a radius reaches no cell
+		CullingLight.Radius = PositionAndInvRadius.W > 0.0f ? 1.0f / PositionAndInvRadius.W : 0.0f;
+		CullingLight.RadiusSquared = PositionAndInvRadius.W > 0.0f ? CullingLight.Radius * CullingLight.Radius : -1.0f;
+
+		// Cones of 90 degrees or more are not narrower than the sphere test
+		CullingLight.ConeAngleCos = Parameters.SpotAngles.X;
+		CullingLight.ConeAngleSin = FMath::Sqrt(FMath::Max(0.0f, 1.0f - CullingLight.ConeAngleCos * CullingLight.ConeAngleCos));
+		CullingLight.bCone = Lights[LightIndex].LightType == LightType_Spot && CullingLight.ConeAngleCos > 0.0f && CullingLight.ConeAngleSin > 0.0f;
+		if (CullingLight.bCone)
+		{
+			// NormalizedLightDirection points from the lit surfaces to the light
+			const Vector4 ViewAxis = View.ViewMatrix.TransformVector(-Parameters.NormalizedLightDirection);
+			CullingLight.ConeAxis = FVector(ViewAxis.X, ViewAxis.Y, ViewAxis.Z).GetSafeNormal();
+		}
+		else
+		{
+			CullingLight.ConeAxis = FVector(0.0f, 0.0f, 1.0f);
+		}
+
+		FurthestLight = FMath::Max(FurthestLight, CullingLight.Center.Z + CullingLight.Radius);
+	}
+
+	OutLightGrid.LightGridZParams = GetLightGridZParams(View.NearClippingDistance, FurthestLight + 10.0f, GLightGridSizeZ);
+}
+
+void ComputeLightGrid(const FLightGridView& View, const std::vector<FForwardLocalLight>& Lights, FForwardLightingViewResources& OutLightGrid, bool bForceSingleThread)
+{
+	std::vector<FLightGridCullingLight> CullingLights;
+	SetupLightGrid(View, Lights, OutLightGrid, CullingLights);
+
+	const FIntVector GridSize = OutLightGrid.CulledGridSize;
+	const int32 NumCellsPerSlice = GridSize.X * GridSize.Y;
+	const int32 NumLocalLights = OutLightGrid.NumLocalLights;
+
+	/** Cells of one depth slice, their light indices packed in the order of the cells */
+	struct FSliceLightLists
+	{
+		std::vector<uint32> NumLights;
+		std::vector<uint32> Offsets;
+		std::vector<uint16> LightIndices;
+	};
+	std::vector<FSliceLightLists> Slices(GridSize.Z);
+
+	// Every slice is culled on its own, so the result does not depend on how slices are spread over the workers
+	ParallelFor(GridSize.Z, [&](int32 ZSlice)
+	{
+		FLightGridCellBounds Bounds;
+		GetCellBounds(View, OutLightGrid, ZSlice, Bounds);
+
+		// The cone test of spot lights is against the bounding spheres of the cells
+		std::vector<FVector> CellSphereCenters(NumCellsPerSlice);
+		std::vector<float> CellSphereRadii(NumCellsPerSlice);
+		for (int32 Y = 0; Y < GridSize.Y; Y++)
+		{
+			for (int32 X = 0; X < GridSize.X; X++)
+			{
+				GetCellBoundingSphere(Bounds, X, Y, CellSphereCenters[Y * GridSize.X + X], CellSphereRadii[Y * GridSize.X + X]);
+			}
+		}
+
+		std::vector<float> ColumnDistanceSquared(GridSize.X);
+		std::vector<float> RowDistanceSquared(GridSize.Y);
+		// (cell of the slice, light) pairs, in increasing light order
+		std::vector<std::pair<int32, uint16>> Hits;
+
+		for (int32 LightIndex = 0; LightIndex < NumLocalLights; LightIndex++)
+		{
+			const FLightGridCullingLight& Light = CullingLights[LightIndex];
+
+			// Squared distances only grow as more of them are added, so a light too far along one axis is out of every cell that shares it
+			const float DepthDistanceSquared = IntervalDistanceSquared(Light.Center.Z, Bounds.DepthMin, Bounds.DepthMax);
+			if (DepthDistanceSquared > Light.RadiusSquared)
+			{
+				continue;
+			}
+			int32 MinX = GridSize.X;
+			int32 MaxX = -1;
+			for (int32 X = 0; X < GridSize.X; X++)
+			{
+				ColumnDistanceSquared[X] = IntervalDistanceSquared(Light.Center.X, Bounds.ColumnMin[X], Bounds.ColumnMax[X]);
+				if (ColumnDistanceSquared[X] + DepthDistanceSquared <= Light.RadiusSquared)
+				{
+					MinX = FMath::Min(MinX, X);
+					MaxX = X;
+				}
+			}
+			for (int32 Y = 0; Y < GridSize.Y && MinX <= MaxX; Y++)
+			{
+				RowDistanceSquared[Y] = IntervalDistanceSquared(Light.Center.Y, Bounds.RowMin[Y], Bounds.RowMax[Y]);
+				if (RowDistanceSquared[Y] + DepthDistanceSquared > Light.RadiusSquared)
+				{
+					continue;
+				}
+				for (int32 X = MinX; X <= MaxX; X++)
+				{
+					const int32 CellIndex = Y * GridSize.X + X;
+					if (IsSphereInCell(Light, ColumnDistanceSquared[X], RowDistanceSquared[Y], DepthDistanceSquared)
+						&& IsConeInCell(Light, CellSphereCenters[CellIndex], CellSphereRadii[CellIndex]))
+					{
+						Hits.push_back(std::make_pair(CellIndex, (uint16)LightIndex));
+					}
+				}
+			}
+		}
+
+		// Counting sort of the hits by cell keeps the light indices of every cell increasing
+		FSliceLightLists& Slice = Slices[ZSlice];
+		Slice.NumLights.assign(NumCellsPerSlice, 0);
+		Slice.Offsets.resize(NumCellsPerSlice);
+		for (const std::pair<int32, uint16>& Hit : Hits)
+		{
+			Slice.NumLights[Hit.first]++;
+		}
+		uint32 Offset = 0;
+		for (int32 CellIndex = 0; CellIndex < NumCellsPerSlice; CellIndex++)
+		{
+			Slice.Offsets[CellIndex] = Offset;
+			Offset += Slice.NumLights[CellIndex];
+		}
+		Slice.LightIndices.resize(Hits.size());
+		std::vector<uint32> Cursors(Slice.Offsets);
+		for (const std::pair<int32, uint16>& Hit : Hits)
+		{
+			Slice.LightIndices[Cursors[Hit.first]++] = Hit.second;
+		}
+	}, bForceSingleThread);
+
+	std::vector<uint32> SliceStarts(GridSize.Z);
+	uint32 NumCulledLights = 0;
+	for (int32 ZSlice = 0; ZSlice < GridSize.Z; ZSlice++)
+	{
+		SliceStarts[ZSlice] = NumCulledLights;
+		NumCulledLights += (uint32)Slices[ZSlice].LightIndices.size();
+	}
+
+	OutLightGrid.NumCulledLightsGrid.resize(OutLightGrid.GetNumCells() * 2);
+	OutLightGrid.CulledLightDataGrid.resize(NumCulledLights);
+
+	ParallelFor(GridSize.Z, [&](int32 ZSlice)
+	{
+		const FSliceLightLists& Slice = Slices[ZSlice];
+		for (int32 CellIndex = 0; CellIndex < NumCellsPerSlice; CellIndex++)
+		{
+			const int32 GridIndex = ZSlice * NumCellsPerSlice + CellIndex;
+			OutLightGrid.NumCulledLightsGrid[GridIndex * 2 + 0] = Slice.NumLights[CellIndex];
+			OutLightGrid.NumCulledLightsGrid[GridIndex * 2 + 1] = SliceStarts[ZSlice] + Slice.Offsets[CellIndex];
+		}
+		std::copy(Slice.LightIndices.begin(), Slice.LightIndices.end(), OutLightGrid.CulledLightDataGrid.begin() + SliceStarts[ZSlice]);
+	}, bForceSingleThread);
+}
+
+void ComputeLightGridBruteForce(const FLightGridView& View, const std::vector<FForwardLocalLight>& Lights, FForwardLightingViewResources& OutLightGrid)
+{
+	std::vector<FLightGridCullingLight> CullingLights;
+	SetupLightGrid(View, Lights, OutLightGrid, CullingLights);
+
+	const FIntVector GridSize = OutLightGrid.CulledGridSize;
+
+	OutLightGrid.NumCulledLightsGrid.resize(OutLightGrid.GetNumCells() * 2);
+	OutLightGrid.CulledLightDataGrid.clear();
+
+	FLightGridCellBounds Bounds;
+	for (int32 Z = 0; Z < GridSize.Z; Z++)
+	{
+		GetCellBounds(View, OutLightGrid, Z, Bounds);
+		for (int32 Y = 0; Y < GridSize.Y; Y++)
+		{
+			for (int32 X = 0; X < GridSize.X; X++)
+			{
+				const int32 GridIndex = OutLightGrid.GetCellIndex(X, Y, Z);
+				OutLightGrid.NumCulledLightsGrid[GridIndex * 2 + 1] = (uint32)OutLightGrid.CulledLightDataGrid.size();
+
+				FVector SphereCenter;
+				float SphereRadius;
+				GetCellBoundingSphere(Bounds, X, Y, SphereCenter, SphereRadius);
+
+				for (int32 LightIndex = 0; LightIndex < OutLightGrid.NumLocalLights; LightIndex++)
+				{
+					const FLightGridCullingLight& Light = CullingLights[LightIndex];
+					const float DistanceSquaredX = IntervalDistanceSquared(Light.Center.X, Bounds.ColumnMin[X], Bounds.ColumnMax[X]);
+					const float DistanceSquaredY = IntervalDistanceSquared(Light.Center.Y, Bounds.RowMin[Y], Bounds.RowMax[Y]);
+					const float DistanceSquaredZ = IntervalDistanceSquared(Light.Center.Z, Bounds.DepthMin, Bounds.DepthMax);
+					if (IsSphereInCell(Light, DistanceSquaredX, DistanceSquaredY, DistanceSquaredZ) && IsConeInCell(Light, SphereCenter, SphereRadius))
+					{
+						OutLightGrid.CulledLightDataGrid.push_back((uint16)LightIndex);
+					}
+				}
+
+				OutLightGrid.NumCulledLightsGrid[GridIndex * 2 + 0] = (uint32)OutLightGrid.CulledLightDataGrid.size() - OutLightGrid.NumCulledLightsGrid[GridIndex * 2 + 1];
+			}
+		}
+	}
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "UnrealMath.h"
+#include "EngineTypes.h"
+#include "LightParameters.h"
+
+#include <vector>
+
+/**
+ * When set, RenderLights builds the clustered light grid of every view from the lights it can render in one pass and skips
+ * drawing the ones no cell lists. Lights are still drawn one at a time, there is no clustered shading pass reading the grid.
+ */
+extern bool GComputeLightGrid;
+
+/** Size of a light grid cell on screen, in pixels */
+extern int32 GLightGridPixelSize;
+
+/** Number of exponentially distributed depth slices of the light grid */
+extern int32 GLightGridSizeZ;
+
+/** Float4s of ForwardLocalLightBuffer per light */
+enum { ForwardLocalLightDataStride = 5 };
+
+/** A point or spot light the light grid culls, described as the clustered pass shades it */
+struct FForwardLocalLight
+{
+	FLightParameters Parameters;
+	/** LightType_Point or LightType_Spot, spot lights are also culled by their cone */
+	uint8 LightType;
+};
+
+/** The perspective view a light grid is built for */
+struct FLightGridView
+{
+	FMatrix ViewMatrix;
+	FMatrix ProjectionMatrix;
+	FIntPoint ViewSize;
+	float NearClippingDistance;
+};
+
+/**
+ * The clustered light grid of one view: the view frustum is split into GLightGridPixelSize square cells on screen and
+ * GLightGridSizeZ exponential depth slices, and every cell lists the local lights whose bounds overlap it.
+ */
+struct FForwardLightingViewResources
+{
+	/** Cells along x, y and depth */
+	FIntVector CulledGridSize;
+	int32 LightGridPixelSize;
+	/** (B, O, S) of the depth slice of a view space depth: log2(Depth * B + O) * S */
+	FVector LightGridZParams;
+	int32 NumLocalLights;
+
+	/**
+	 * ForwardLocalLightDataStride float4s per light: position and inverse radius, color and falloff exponent,
+	 * direction and specular scale, spot angles with source radius and length, tangent and soft source radius.
+	 */
+	std::vector<Vector4> ForwardLocalLightBuffer;
+	/** Two per cell, x fastest then y then depth: the number of lights in the cell and the offset of their indices in CulledLightDataGrid */
+	std::vector<uint32> NumCulledLightsGrid;
+	/** Light indices of every cell, in increasing order */
+	std::vector<uint16> CulledLightDataGrid;
+
+	int32 GetNumCells() const { return CulledGridSize.X * CulledGridSize.Y * CulledGridSize.Z; }
+	int32 GetCellIndex(int32 X, int32 Y, int32 Z) const { return (Z * CulledGridSize.Y + Y) * CulledGridSize.X + X; }
+	uint32 GetNumLightsInCell(int32 CellIndex) const { return NumCulledLightsGrid[CellIndex * 2 + 0]; }
+	const uint16* GetCellLightIndices(int32 CellIndex) const { return CulledLightDataGrid.data() + NumCulledLightsGrid[CellIndex * 2 + 1]; }
+
+	/** Depth slice a view space depth falls in */
+	int32 GetZSlice(float ViewDepth) const;
+};
+
+/** LightGridZParams spreading GridSizeZ slices from a little in front of NearPlane to FarPlane */
+FVector GetLightGridZParams(float NearPlane, float FarPlane, int32 GridSizeZ);
+
+/**
+ * Builds the light grid of View for Lights, one parallel task per depth slice. A light is in a cell when its sphere
+ * overlaps the view space bounds of the cell and, for spot lights, its cone overlaps the bounding sphere of those bounds.
+ * Only the first MAX_uint16 + 1 lights are culled, as light indices are 16 bit.
+ */
+void ComputeLightGrid(const FLightGridView& View, const std::vector<FForwardLocalLight>& Lights, FForwardLightingViewResources& OutLightGrid, bool bForceSingleThread = false);
+
+/** Builds the same grid as ComputeLightGrid by testing every light against every cell, the reference it is checked against */
+void ComputeLightGridBruteForce(const FLightGridView& View, const std::vector<FForwardLocalLight>& Lights, FForwardLightingViewResources& OutLightGrid);
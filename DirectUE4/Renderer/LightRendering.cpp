@@ -4,6 +4,10 @@
 #include "DeferredShading.h"
 #include "GPUProfiler.h"
 #include "SystemTextures.h"
+#include "LightGridInjection.h"
+
+/** Defined with the camera, the distance from the view origin to the near plane */
+extern float GNearClippingPlane;
 
 FDeferredLightUniformStruct DeferredLightUniforms;
 
@@ -457,6 +461,42 @@ void FSceneRenderer::RenderLight(const FLightSceneInfo* LightSceneInfo, struct P
 	}
 }
 
+/**
+ * Builds View.ForwardLightingResources for the point and spot lights of SortedLights[0, LightEnd), OutSortedLightIndices
+ * gets the index in SortedLights of every light of the grid. Views without a perspective projection get no grid.
+ */
+static void ComputeViewLightGrid(const std::vector<FSortedLightSceneInfo>& SortedLights, uint32 LightEnd, FViewInfo& View, std::vector<uint32>& OutSortedLightIndices)
+{
+	OutSortedLightIndices.clear();
+	if (!View.IsPerspectiveProjection())
+	{
+		return;
+	}
+
+	std::vector<FForwardLocalLight> Lights;
+	for (uint32 LightIndex = 0; LightIndex < LightEnd; LightIndex++)
+	{
+		const FSortedLightSceneInfo& SortedLightInfo = SortedLights[LightIndex];
+		const uint32 LightType = SortedLightInfo.SortKey.Fields.LightType;
+		if (LightType == LightType_Point || LightType == LightType_Spot)
+		{
+			FForwardLocalLight Light;
+			SortedLightInfo.LightSceneInfo->Proxy->GetParameters(Light.Parameters);
+			Light.LightType = (uint8)LightType;
+			Lights.push_back(Light);
+			OutSortedLightIndices.push_back(LightIndex);
+		}
+	}
+
+	FLightGridView GridView;
+	GridView.ViewMatrix = View.ViewMatrices.GetViewMatrix();
+	GridView.ProjectionMatrix = View.ViewMatrices.GetProjectionMatrix();
+	GridView.ViewSize = View.ViewRect.Size();
+	GridView.NearClippingDistance = GNearClippingPlane;
+
+	ComputeLightGrid(GridView, Lights, View.ForwardLightingResources);
+}
+
 void FSceneRenderer::RenderLights()
 {
 	SCOPED_DRAW_EVENT_FORMAT(RenderLights, TEXT("Lights"));
@@ -540,6 +580,35 @@ void FSceneRenderer::RenderLights()
 			}
 		}
 
+		// Number of views whose light grid has the light but lists it in none of its cells, for the lights before SupportedByTiledDeferredLightEnd
+		std::vector<uint32> NumViewsLightMisses;
+		if (GComputeLightGrid && SupportedByTiledDeferredLightEnd > 0 && Views.size() > 0)
+		{
+			NumViewsLightMisses.assign(SupportedByTiledDeferredLightEnd, 0);
+
+			// Cull the point and spot lights before SupportedByTiledDeferredLightEnd, the ones without shadows, light functions or light profiles, into the clustered grid of every view
+			for (uint32 ViewIndex = 0; ViewIndex < Views.size(); ViewIndex++)
+			{
+				std::vector<uint32> SortedLightIndices;
+				ComputeViewLightGrid(SortedLights, SupportedByTiledDeferredLightEnd, Views[ViewIndex], SortedLightIndices);
+
+				const FForwardLightingViewResources& LightGrid = Views[ViewIndex].ForwardLightingResources;
+				const uint32 NumGridLights = FMath::Min((uint32)SortedLightIndices.size(), (uint32)LightGrid.NumLocalLights);
+				std::vector<bool> bInAnyCell(NumGridLights, false);
+				for (const uint16 GridLightIndex : LightGrid.CulledLightDataGrid)
+				{
+					bInAnyCell[GridLightIndex] = true;
+				}
+				for (uint32 GridLightIndex = 0; GridLightIndex < NumGridLights; GridLightIndex++)
+				{
+					if (!bInAnyCell[GridLightIndex])
+					{
+						NumViewsLightMisses[SortedLightIndices[GridLightIndex]]++;
+					}
+				}
+			}
+		}
+
 		int32 StandardDeferredStart = 0;
 
 		{
@@ -552,6 +621,12 @@ void FSceneRenderer::RenderLights()
 				const FSortedLightSceneInfo& SortedLightInfo = SortedLights[LightIndex];
 				const FLightSceneInfo* const LightSceneInfo = SortedLightInfo.LightSceneInfo;
 
+				// The grid cells bound the view frustum, so a light no cell of any view lists lights no pixel
+				if (LightIndex < NumViewsLightMisses.size() && NumViewsLightMisses[LightIndex] == Views.size())
+				{
+					continue;
+				}
+
 				// Render the light to the scene color buffer, using a 1x1 white texture as input 
 				RenderLight(LightSceneInfo, NULL, false, false);
 			}
@@ -1,9 +1,11 @@
 #include "LightSceneInfo.h"
-#include "UnrealMathFPU.h"
+#include "VectorRegister.h"
 #include "Scene.h"
 
 int32 GWholeSceneShadowUnbuiltInteractionThreshold = 500;
 
+bool GSpatialLightInteractions = true;
+
 void FLightSceneInfoCompact::Init(FLightSceneInfo* InLightSceneInfo)
 {
 	LightSceneInfo = InLightSceneInfo;
@@ -44,6 +46,14 @@ bool FLightSceneInfoCompact::AffectsPrimitive(const FBoxSphereBounds& PrimitiveB
 		return false;
 	}
 
+	// The light's sphere has to reach the primitive's box as well, this is the test the light octree queries of the scene
+	// find primitives by, so they find every primitive the light affects
+	const FSphere BoundingSphere = GetBoundingSphere();
+	if (ComputeSquaredDistanceFromBoxToPoint(PrimitiveBounds.Origin - PrimitiveBounds.BoxExtent, PrimitiveBounds.Origin + PrimitiveBounds.BoxExtent, BoundingSphere.Center) > FMath::Square(BoundingSphere.W))
+	{
+		return false;
+	}
+
 	// Cull based on information in the full scene infos.
 
 	if (!LightSceneInfo->Proxy->AffectsBounds(PrimitiveBounds))
@@ -64,10 +74,16 @@ bool FLightSceneInfoCompact::AffectsPrimitive(const FBoxSphereBounds& PrimitiveB
 	return true;
 }
 
+void FLightOctreeSemantics::SetElementId(const FLightSceneInfoCompact& Element, FOctreeElementId Id)
+{
+	Element.LightSceneInfo->OctreeId = Id;
+}
+
 FLightSceneInfo::FLightSceneInfo(FLightSceneProxy* InProxy)
 	:Proxy(InProxy)
 	, DynamicInteractionOftenMovingPrimitiveList(NULL)
 	, DynamicInteractionStaticPrimitiveList(NULL)
+	, LightInteractionStamp(0)
 {
 
 }
@@ -81,17 +97,26 @@ void FLightSceneInfo::AddToScene()
 {
 	const FLightSceneInfoCompact& LightSceneInfoCompact = Scene->Lights[Id];
 
-	if (Proxy->CastsDynamicShadow() || Proxy->CastsStaticShadow())
+	if (LightSceneInfoCompact.HasInteractions())
 	{
-		for (auto PrimitiveIt = Scene->PrimitiveOctree.begin(); PrimitiveIt != Scene->PrimitiveOctree.end(); ++PrimitiveIt)
+		if (LightSceneInfoCompact.LightType == LightType_Directional)
 		{
-			CreateLightPrimitiveInteraction(LightSceneInfoCompact, *PrimitiveIt);
+			// Directional lights have no finite extent and cannot meaningfully be in the light octree
+			Scene->DirectionalShadowCastingLightIDs.push_back(Id);
 		}
+		else
+		{
+			// Add the light to the scene's light octree.
+			Scene->LightOctree.AddElement(LightSceneInfoCompact);
+		}
+
+		CreateLightPrimitiveInteractions(false);
 	}
 }
 
 void FLightSceneInfo::CreateLightPrimitiveInteraction(const FLightSceneInfoCompact& LightSceneInfoCompact, const FPrimitiveSceneInfoCompact& PrimitiveSceneInfoCompact)
 {
+	++Scene->LightInteractionStats.NumCandidatesTested;
 	if (LightSceneInfoCompact.AffectsPrimitive(PrimitiveSceneInfoCompact.Bounds, PrimitiveSceneInfoCompact.Proxy))
 	{
 		// create light interaction and add to light/primitive lists
@@ -99,9 +124,84 @@ void FLightSceneInfo::CreateLightPrimitiveInteraction(const FLightSceneInfoCompa
 	}
 }
 
+void FLightSceneInfo::CreateLightPrimitiveInteractions(bool bOnlyMissing)
+{
+	const FLightSceneInfoCompact& LightSceneInfoCompact = Scene->Lights[Id];
+
+	auto CreateInteraction = [&](const FPrimitiveSceneInfoCompact& PrimitiveSceneInfoCompact)
+	{
+		if (!bOnlyMissing || PrimitiveSceneInfoCompact.PrimitiveSceneInfo->LightInteractionStamp != Scene->LightInteractionUpdateStamp)
+		{
+			CreateLightPrimitiveInteraction(LightSceneInfoCompact, PrimitiveSceneInfoCompact);
+		}
+	};
+
+	if (GSpatialLightInteractions && LightSceneInfoCompact.LightType != LightType_Directional)
+	{
+		// Find primitives that the light affects in the primitive octree.
+		const FSphere BoundingSphere = LightSceneInfoCompact.GetBoundingSphere();
+		Scene->PrimitiveOctree.FindElementsInSphere(BoundingSphere.Center, BoundingSphere.W, CreateInteraction);
+	}
+	else
+	{
+		Scene->PrimitiveOctree.ForEachElement(CreateInteraction);
+	}
+}
+
+void FLightSceneInfo::UpdateLightPrimitiveInteractions()
+{
+	if (!OctreeId.IsValidId())
+	{
+		// Directional lights and lights without interactions have nothing that depends on where they are
+		return;
+	}
+
+	const FLightSceneInfoCompact& LightSceneInfoCompact = Scene->Lights[Id];
+	Scene->LightOctree.RemoveElement(OctreeId);
+	Scene->LightOctree.AddElement(LightSceneInfoCompact);
+
+	// Destroy the interactions with the primitives the light has moved away from and stamp the primitives of the ones it
+	// keeps, so looking for missing interactions below doesn't have to walk the light list of every candidate
+	const uint32 Stamp = ++Scene->LightInteractionUpdateStamp;
+	FLightPrimitiveInteraction* const InteractionLists[] = { DynamicInteractionOftenMovingPrimitiveList, DynamicInteractionStaticPrimitiveList };
+	for (FLightPrimitiveInteraction* Interaction : InteractionLists)
+	{
+		while (Interaction)
+		{
+			FLightPrimitiveInteraction* NextInteraction = Interaction->GetNextPrimitive();
+			FPrimitiveSceneInfo* PrimitiveSceneInfo = Interaction->GetPrimitiveSceneInfo();
+			++Scene->LightInteractionStats.NumCandidatesTested;
+			if (!LightSceneInfoCompact.AffectsPrimitive(PrimitiveSceneInfo->Proxy->GetBounds(), PrimitiveSceneInfo->Proxy))
+			{
+				FLightPrimitiveInteraction::Destroy(Interaction);
+			}
+			else
+			{
+				PrimitiveSceneInfo->LightInteractionStamp = Stamp;
+			}
+			Interaction = NextInteraction;
+		}
+	}
+
+	CreateLightPrimitiveInteractions(true);
+}
+
 void FLightSceneInfo::RemoveFromScene()
 {
-	//Scene->LightOctree.RemoveElement(OctreeId);
+	if (OctreeId.IsValidId())
+	{
+		// Remove the light from the octree.
+		Scene->LightOctree.RemoveElement(OctreeId);
+		OctreeId = FOctreeElementId();
+	}
+	else
+	{
+		auto It = std::find(Scene->DirectionalShadowCastingLightIDs.begin(), Scene->DirectionalShadowCastingLightIDs.end(), Id);
+		if (It != Scene->DirectionalShadowCastingLightIDs.end())
+		{
+			Scene->DirectionalShadowCastingLightIDs.erase(It);
+		}
+	}
 
 	//Scene->CachedShadowMaps.Remove(Id);
 
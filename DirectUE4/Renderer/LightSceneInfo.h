@@ -1,6 +1,6 @@
 #pragma once
 
-#include "UnrealMathFPU.h"
+#include "VectorRegister.h"
 #include "LightComponent.h"
 #include "PrimitiveSceneInfo.h"
 
@@ -8,6 +8,21 @@ class ULightComponent;
 class FLightPrimitiveInteraction;
 class FPrimitiveSceneProxy;
 
+/**
+* Whether light-primitive interactions are found through the scene's octrees and updated incrementally when lights and
+* primitives move. When false every light is tested against every primitive and moving either rebuilds all its interactions.
+*/
+extern bool GSpatialLightInteractions;
+
+/** Light-primitive interaction work done by a scene, see FScene::LightInteractionStats */
+struct FLightInteractionStats
+{
+	/** Light-primitive pairs tested with FLightSceneInfoCompact::AffectsPrimitive */
+	uint32 NumCandidatesTested = 0;
+	uint32 NumCreated = 0;
+	uint32 NumDestroyed = 0;
+};
+
 class FLightSceneInfoCompact
 {
 public:
@@ -34,9 +49,41 @@ public:
 		Init(InLightSceneInfo);
 	}
 
+	/** @return the light's bounding sphere, with a radius of FLT_MAX for lights without bounds */
+	FSphere GetBoundingSphere() const
+	{
+		FSphere BoundingSphere;
+		memcpy(&BoundingSphere, &BoundingSphereVector, sizeof(BoundingSphere));
+		return BoundingSphere;
+	}
+
+	/** @return whether the light needs interactions with the primitives it affects, to shadow them or to be in their light maps */
+	bool HasInteractions() const
+	{
+		return bCastDynamicShadow || bCastStaticShadow || bStaticLighting;
+	}
+
 	bool AffectsPrimitive(const FBoxSphereBounds& PrimitiveBounds,  const FPrimitiveSceneProxy* PrimitiveSceneProxy) const;
 };
 
+/** Octree semantics for the scene's lights with bounds, keyed on the box around their bounding sphere. */
+struct FLightOctreeSemantics
+{
+	enum { MaxElementsPerLeaf = 16 };
+	enum { MinInclusiveElementsPerNode = 7 };
+	enum { MaxNodeDepth = 12 };
+
+	static FBoxSphereBounds GetBounds(const FLightSceneInfoCompact& Element)
+	{
+		return FBoxSphereBounds(Element.GetBoundingSphere());
+	}
+
+	static void SetElementId(const FLightSceneInfoCompact& Element, FOctreeElementId Id);
+};
+
+/** The scene's local lights, by bounds. Directional lights have none and are kept apart, see FScene::DirectionalShadowCastingLightIDs. */
+typedef TOctree<FLightSceneInfoCompact, FLightOctreeSemantics> FSceneLightOctree;
+
 /** Information for sorting lights. */
 struct FSortedLightSceneInfo
 {
@@ -84,7 +131,11 @@ public:
 
 	int32 Id;
 
-	int32 OctreeId;
+	/** The light's element in the scene's light octree, invalid for directional lights and lights that aren't in the scene. */
+	FOctreeElementId OctreeId;
+
+	/** Scene->LightInteractionUpdateStamp of the last primitive move that kept its interaction with the light. */
+	uint32 LightInteractionStamp;
 
 	int32 NumUnbuiltInteractions;
 
@@ -95,6 +146,19 @@ public:
 
 	void CreateLightPrimitiveInteraction(const FLightSceneInfoCompact& LightSceneInfoCompact, const FPrimitiveSceneInfoCompact& PrimitiveSceneInfoCompact);
 
+	/**
+	* Creates the interactions with the primitives the light affects.
+	* @param bOnlyMissing - skip primitives stamped with the current Scene->LightInteractionUpdateStamp, the ones that kept
+	*                       their interaction with the light
+	*/
+	void CreateLightPrimitiveInteractions(bool bOnlyMissing);
+
+	/**
+	* Moves the light to its new bounds in the light octree after Scene->Lights[Id] has been updated, then destroys the
+	* interactions with the primitives it no longer affects and creates the ones with the primitives it affects now.
+	*/
+	void UpdateLightPrimitiveInteractions();
+
 	void RemoveFromScene();
 
 	void Detach();
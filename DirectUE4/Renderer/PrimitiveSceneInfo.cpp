@@ -20,11 +20,17 @@ FPrimitiveSceneInfoCompact::FPrimitiveSceneInfoCompact(FPrimitiveSceneInfo* InPr
 	//VisibilityId = PrimitiveSceneInfo->Proxy->GetVisibilityId();
 }
 
+void FPrimitiveOctreeSemantics::SetElementId(const FPrimitiveSceneInfoCompact& Element, FOctreeElementId Id)
+{
+	Element.PrimitiveSceneInfo->OctreeId = Id;
+}
+
 FPrimitiveSceneInfo::FPrimitiveSceneInfo(UPrimitiveComponent* InComponent, FScene* InScene)
 	: Proxy(InComponent->SceneProxy)
 	,Scene(InScene)
 	, PackedIndex(INDEX_NONE)
 	,LightList(NULL)
+	, LightInteractionStamp(0)
 {
 
 }
@@ -45,28 +51,103 @@ void FPrimitiveSceneInfo::AddToScene(bool bUpdateStaticDrawLists, bool bAddToSta
 
 	FPrimitiveSceneInfoCompact CompactPrimitiveSceneInfo(this);
 
-	Scene->PrimitiveOctree.push_back(CompactPrimitiveSceneInfo);
+	// Add the primitive to the octree.
+	Scene->PrimitiveOctree.AddElement(CompactPrimitiveSceneInfo);
+
+	UpdatePackedBounds();
 
+	CreateLightInteractions(CompactPrimitiveSceneInfo, false);
+}
+
+void FPrimitiveSceneInfo::UpdatePackedBounds()
+{
 	FPrimitiveBounds& PrimitiveBounds = Scene->PrimitiveBounds[PackedIndex];
 	FBoxSphereBounds BoxSphereBounds = Proxy->GetBounds();
 	PrimitiveBounds.BoxSphereBounds = BoxSphereBounds;
 	PrimitiveBounds.MinDrawDistanceSq = FMath::Square(Proxy->GetMinDrawDistance());
 	PrimitiveBounds.MaxDrawDistance = Proxy->GetMaxDrawDistance();
 	PrimitiveBounds.MaxCullDistance = PrimitiveBounds.MaxDrawDistance;
+	Scene->PrimitiveCullingBounds.Set(PackedIndex, PrimitiveBounds);
+}
 
-	for (auto LightIt = Scene->Lights.begin(); LightIt != Scene->Lights.end();++LightIt)
+void FPrimitiveSceneInfo::CreateLightInteractions(const FPrimitiveSceneInfoCompact& CompactPrimitiveSceneInfo, bool bOnlyMissing)
+{
+	auto CreateInteraction = [&](const FLightSceneInfoCompact& LightSceneInfoCompact)
 	{
-		const FLightSceneInfoCompact& LightSceneInfoCompact = *LightIt;
-		if (LightSceneInfoCompact.AffectsPrimitive(CompactPrimitiveSceneInfo.Bounds, CompactPrimitiveSceneInfo.Proxy))
+		if (!bOnlyMissing || LightSceneInfoCompact.LightSceneInfo->LightInteractionStamp != Scene->LightInteractionUpdateStamp)
 		{
-			FLightPrimitiveInteraction::Create(LightSceneInfoCompact.LightSceneInfo, this);
+			LightSceneInfoCompact.LightSceneInfo->CreateLightPrimitiveInteraction(LightSceneInfoCompact, CompactPrimitiveSceneInfo);
 		}
-	}
+	};
+
+	// Create any light interactions for directional lights, they affect primitives wherever they are
+	for (int32 LightId : Scene->DirectionalShadowCastingLightIDs)
+	{
+		CreateInteraction(Scene->Lights[LightId]);
+	}
+
+	if (GSpatialLightInteractions)
+	{
+		// Find lights that affect the primitive in the light octree.
+		Scene->LightOctree.FindElementsWithBoundsTest(CompactPrimitiveSceneInfo.Bounds.GetBox(), CreateInteraction);
+	}
+	else
+	{
+		Scene->LightOctree.ForEachElement(CreateInteraction);
+	}
+}
+
+void FPrimitiveSceneInfo::UpdateBounds()
+{
+	MarkPrecomputedLightingBufferDirty();
+
+	// Move the primitive in the octree.
+	Scene->PrimitiveOctree.RemoveElement(OctreeId);
+	FPrimitiveSceneInfoCompact CompactPrimitiveSceneInfo(this);
+	Scene->PrimitiveOctree.AddElement(CompactPrimitiveSceneInfo);
+
+	UpdatePackedBounds();
+
+	// Destroy the interactions with the lights the primitive has moved away from and stamp the lights of the ones it keeps,
+	// so looking for missing interactions below doesn't have to walk the light list for every candidate
+	const uint32 Stamp = ++Scene->LightInteractionUpdateStamp;
+	FLightPrimitiveInteraction* Interaction = LightList;
+	while (Interaction)
+	{
+		FLightPrimitiveInteraction* NextInteraction = Interaction->GetNextLight();
+		++Scene->LightInteractionStats.NumCandidatesTested;
+		if (!Scene->Lights[Interaction->GetLightId()].AffectsPrimitive(CompactPrimitiveSceneInfo.Bounds, Proxy))
+		{
+			FLightPrimitiveInteraction::Destroy(Interaction);
+		}
+		else
+		{
+			Interaction->GetLight()->LightInteractionStamp = Stamp;
+		}
+		Interaction = NextInteraction;
+	}
+
+	CreateLightInteractions(CompactPrimitiveSceneInfo, true);
 }
 
 void FPrimitiveSceneInfo::RemoveFromScene(bool bUpdateStaticDrawLists)
 {
+	// remove the primitive from the octree
+	assert(OctreeId.IsValidId());
+	assert(Scene->PrimitiveOctree.GetElementById(OctreeId).PrimitiveSceneInfo == this);
+	Scene->PrimitiveOctree.RemoveElement(OctreeId);
+	OctreeId = FOctreeElementId();
+
+	// Remove light interactions
+	while (LightList)
+	{
+		FLightPrimitiveInteraction::Destroy(LightList);
+	}
 
+	if (bUpdateStaticDrawLists)
+	{
+		RemoveStaticMeshes();
+	}
 }
 
 void FPrimitiveSceneInfo::AddStaticMeshes(bool bAddToStaticDrawLists /*= true*/)
@@ -77,6 +158,10 @@ void FPrimitiveSceneInfo::AddStaticMeshes(bool bAddToStaticDrawLists /*= true*/)
 	{
 		FStaticMesh& Mesh = *StaticMeshes[MeshIndex];
 
+		// Add the static mesh to the scene's static mesh list, its Id indexes the views' StaticMeshVisibilityMap
+		Mesh.Id = (int32)Scene->StaticMeshes.size();
+		Scene->StaticMeshes.push_back(&Mesh);
+
 		if (bAddToStaticDrawLists)
 		{
 			// By this point, the index buffer render resource must be initialized
@@ -88,7 +173,22 @@ void FPrimitiveSceneInfo::AddStaticMeshes(bool bAddToStaticDrawLists /*= true*/)
 
 void FPrimitiveSceneInfo::RemoveStaticMeshes()
 {
-
+	for (FStaticMesh* Mesh : StaticMeshes)
+	{
+		Mesh->RemoveFromDrawLists();
+
+		// Keep the scene's static meshes packed, the last one takes the removed one's Id
+		const int32 LastId = (int32)Scene->StaticMeshes.size() - 1;
+		if (Mesh->Id != LastId)
+		{
+			Scene->StaticMeshes[Mesh->Id] = Scene->StaticMeshes[LastId];
+			Scene->StaticMeshes[Mesh->Id]->Id = Mesh->Id;
+		}
+		Scene->StaticMeshes.pop_back();
+
+		delete Mesh;
+	}
+	StaticMeshes.clear();
 }
 
 void FPrimitiveSceneInfo::UpdateStaticMeshes(bool bReAddToDrawLists /*= true*/)
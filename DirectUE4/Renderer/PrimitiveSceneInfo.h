@@ -2,11 +2,13 @@
 
 #include "UnrealMath.h"
 #include "PrimitiveSceneProxy.h"
+#include "GenericOctree.h"
 
 #include <vector>
 
 class FPrimitiveSceneInfo;
 class FPrimitiveSceneProxy;
+class FLightSceneInfo;
 class FScene;
 class FViewInfo;
 class UPrimitiveComponent;
@@ -43,6 +45,24 @@ public:
 	FPrimitiveSceneInfoCompact(FPrimitiveSceneInfo* InPrimitiveSceneInfo);
 };
 
+/** Defines how the primitive octree deals with primitives. */
+struct FPrimitiveOctreeSemantics
+{
+	enum { MaxElementsPerLeaf = 16 };
+	enum { MinInclusiveElementsPerNode = 7 };
+	enum { MaxNodeDepth = 12 };
+
+	static const FBoxSphereBounds& GetBounds(const FPrimitiveSceneInfoCompact& PrimitiveSceneInfoCompact)
+	{
+		return PrimitiveSceneInfoCompact.Bounds;
+	}
+
+	static void SetElementId(const FPrimitiveSceneInfoCompact& Element, FOctreeElementId Id);
+};
+
+/** The scene's primitives, by bounds. */
+typedef TOctree<FPrimitiveSceneInfoCompact, FPrimitiveOctreeSemantics> FScenePrimitiveOctree;
+
 class FPrimitiveSceneInfo
 {
 public:
@@ -65,6 +85,12 @@ public:
 
 	FScene* Scene;
 
+	/** The primitive's element in the scene's primitive octree, invalid while it isn't in the scene. */
+	FOctreeElementId OctreeId;
+
+	/** Scene->LightInteractionUpdateStamp of the last light move that kept its interaction with the primitive. */
+	uint32 LightInteractionStamp;
+
 	FPrimitiveSceneInfo(UPrimitiveComponent* InPrimitive, FScene* InScene);
 
 	/** Destructor. */
@@ -75,6 +101,12 @@ public:
 	/** Removes the primitive from the scene. */
 	void RemoveFromScene(bool bUpdateStaticDrawLists);
 
+	/**
+	* Moves the primitive to its proxy's new bounds in the octree and the packed bounds, then destroys the interactions with
+	* the lights that no longer affect it and creates the ones with the lights that affect it now.
+	*/
+	void UpdateBounds();
+
 	void AddStaticMeshes(bool bUpdateStaticDrawLists = true);
 	void RemoveStaticMeshes();
 
@@ -132,6 +164,15 @@ public:
 	}
 	int32 GetIndex() const { return PackedIndex; }
 private:
+	/** Copies the proxy's bounds and draw distances to Scene->PrimitiveBounds[PackedIndex] and Scene->PrimitiveCullingBounds */
+	void UpdatePackedBounds();
+
+	/**
+	* Creates the interactions with the lights that affect the primitive.
+	* @param bOnlyMissing - skip lights that already have an interaction with the primitive
+	*/
+	void CreateLightInteractions(const FPrimitiveSceneInfoCompact& CompactPrimitiveSceneInfo, bool bOnlyMissing);
+
 	bool bNeedsUniformBufferUpdate;
 	bool bPrecomputedLightingBufferDirty;
 	bool bNeedsStaticMeshUpdate;
@@ -0,0 +1,108 @@
+#include "SceneSoftwareOcclusion.h"
+#include "DeferredShading.h"
+#include "Scene.h"
+#include "PrimitiveSceneInfo.h"
+#include "PrimitiveSceneProxy.h"
+#include "SceneManagement.h"
+#include "ParallelFor.h"
+
+#include <algorithm>
+
+bool GSoftwareOcclusionCulling = false;
+float GSoftwareOcclusionMinOccluderScreenSize = 0.15f;
+int32 GSoftwareOcclusionMaxOccluderTriangles = 16384;
+
+/** Primitives tested by one CullOccludedPrimitives task, a whole number of visibility words */
+static const int32 GOccludeePrimitivesPerTask = 1024;
+
+int32 CullOccludedPrimitives(const FSoftwareOcclusionBuffer& OcclusionBuffer, const std::vector<FPrimitiveBounds>& PrimitiveBounds, const FBitArray& Occluders, FBitArray& VisibilityMap, bool bForceSingleThread)
+{
+	assert(VisibilityMap.Num() == (int32)PrimitiveBounds.size() && Occluders.Num() == VisibilityMap.Num());
+	const int32 WordsPerTask = GOccludeePrimitivesPerTask / FBitArray::NumBitsPerWord;
+	const int32 NumTasks = (VisibilityMap.NumWords() + WordsPerTask - 1) / WordsPerTask;
+	std::vector<int32> NumCulledPerTask(NumTasks, 0);
+	uint32* VisibilityWords = VisibilityMap.GetData();
+	const uint32* OccluderWords = Occluders.GetData();
+
+	ParallelFor(NumTasks, [&](int32 TaskIndex)
+	{
+		const int32 EndWord = FMath::Min((TaskIndex + 1) * WordsPerTask, VisibilityMap.NumWords());
+		for (int32 WordIndex = TaskIndex * WordsPerTask; WordIndex < EndWord; ++WordIndex)
+		{
+			uint32 Candidates = VisibilityWords[WordIndex] & ~OccluderWords[WordIndex];
+			while (Candidates)
+			{
+				const uint32 Bit = FMath::CountTrailingZeros(Candidates);
+				Candidates &= Candidates - 1;
+				const FBoxSphereBounds& Bounds = PrimitiveBounds[WordIndex * FBitArray::NumBitsPerWord + Bit].BoxSphereBounds;
+				if (OcclusionBuffer.IsBoxOccluded(Bounds.Origin, Bounds.BoxExtent))
+				{
+					VisibilityWords[WordIndex] &= ~(1u << Bit);
+					++NumCulledPerTask[TaskIndex];
+				}
+			}
+		}
+	}, bForceSingleThread);
+
+	int32 NumCulled = 0;
+	for (int32 TaskCulled : NumCulledPerTask)
+	{
+		NumCulled += TaskCulled;
+	}
+	return NumCulled;
+}
+
+int32 SoftwareOcclusionCull(const FScene* Scene, FViewInfo& View)
+{
+	if (!View.IsPerspectiveProjection())
+	{
+		return 0;
+	}
+
+	// The visible primitives that cover the most of the screen occlude first, ties go to the lower index so every run picks the same ones
+	struct FOccluderCandidate
+	{
+		float ScreenSize;
+		int32 PrimitiveIndex;
+	};
+	std::vector<FOccluderCandidate> Candidates;
+	for (FConstSetBitIterator BitIt(View.PrimitiveVisibilityMap); BitIt; ++BitIt)
+	{
+		const FBoxSphereBounds& Bounds = Scene->PrimitiveBounds[BitIt.GetIndex()].BoxSphereBounds;
+		const float ScreenSize = ComputeBoundsScreenSize(Bounds.Origin, Bounds.SphereRadius, View);
+		if (ScreenSize >= GSoftwareOcclusionMinOccluderScreenSize)
+		{
+			Candidates.push_back({ ScreenSize, BitIt.GetIndex() });
+		}
+	}
+	if (Candidates.empty())
+	{
+		return 0;
+	}
+	std::sort(Candidates.begin(), Candidates.end(), [](const FOccluderCandidate& A, const FOccluderCandidate& B)
+	{
+		return A.ScreenSize != B.ScreenSize ? A.ScreenSize > B.ScreenSize : A.PrimitiveIndex < B.PrimitiveIndex;
+	});
+
+	FOccluderElementsCollector Collector(View.ViewMatrices.GetViewProjectionMatrix());
+	FBitArray Occluders(false, View.PrimitiveVisibilityMap.Num());
+	for (const FOccluderCandidate& Candidate : Candidates)
+	{
+		if (Collector.NumTriangles() >= GSoftwareOcclusionMaxOccluderTriangles)
+		{
+			break;
+		}
+		if (Scene->Primitives[Candidate.PrimitiveIndex]->Proxy->CollectOccluderElements(Collector) > 0)
+		{
+			Occluders.SetBit(Candidate.PrimitiveIndex, true);
+		}
+	}
+	if (Collector.NumTriangles() == 0)
+	{
+		return 0;
+	}
+
+	FSoftwareOcclusionBuffer OcclusionBuffer;
+	OcclusionBuffer.Rasterize(Collector);
+	return CullOccludedPrimitives(OcclusionBuffer, Scene->PrimitiveBounds, Occluders, View.PrimitiveVisibilityMap);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "UnrealMath.h"
+#include "BitArray.h"
+#include "SoftwareOcclusionBuffer.h"
+
+#include <vector>
+
+struct FPrimitiveBounds;
+class FScene;
+class FViewInfo;
+
+/** When set, ComputeViewVisibility clears the bits of primitives hidden behind large static meshes after frustum culling, off by default */
+extern bool GSoftwareOcclusionCulling;
+
+/** Screen size, as ComputeBoundsScreenSize measures it, a visible primitive needs to be rasterized as an occluder */
+extern float GSoftwareOcclusionMinOccluderScreenSize;
+
+/** Occluders stop being added once this many triangles have been collected for a view */
+extern int32 GSoftwareOcclusionMaxOccluderTriangles;
+
+/**
+ * Clears the bits of VisibilityMap whose primitive boxes OcclusionBuffer occludes, except those of the occluders themselves.
+ * @return the number of bits cleared
+ */
+int32 CullOccludedPrimitives(const FSoftwareOcclusionBuffer& OcclusionBuffer, const std::vector<FPrimitiveBounds>& PrimitiveBounds, const FBitArray& Occluders, FBitArray& VisibilityMap, bool bForceSingleThread = false);
+
+/**
+ * Rasterizes the largest static meshes View sees as occluders and clears the bits of View.PrimitiveVisibilityMap
+ * whose bounds are hidden behind them. Runs after frustum culling, orthographic views are left as they are.
+ * @return the number of primitives culled
+ */
+int32 SoftwareOcclusionCull(const FScene* Scene, FViewInfo& View);
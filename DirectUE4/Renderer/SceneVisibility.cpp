@@ -1,50 +1,24 @@
+#include "FrustumCull.h"
 #include "DeferredShading.h"
 #include "Scene.h"
+#include "SceneSoftwareOcclusion.h"
+#include "ParallelFor.h"
 
 float GLightMaxDrawDistanceScale = 1.0f;
 float GMinScreenRadiusForLights = 0.03f;
 float GMinScreenRadiusForDepthPrepass = 0.03f;
 
-template<bool UseCustomCulling, bool bAlsoUseSphereTest>
-static int32 FrustumCull(const FScene* Scene, FViewInfo& View)
+static void FrustumCull(const FScene* Scene, FViewInfo& View)
 {
-	const uint32 NumPrimiteves = View.PrimitiveVisibilityMap.size();
-
-	FVector ViewOriginForDistanceCulling = View.ViewMatrices.GetViewOrigin();
-	float FadeRadius = 0;// GDisableLODFade ? 0.0f : GDistanceFadeMaxTravel;
-
-	for (uint32 PrimitiveIndex = 0; PrimitiveIndex < NumPrimiteves; PrimitiveIndex++)
+	const FVector ViewOriginForDistanceCulling = View.ViewMatrices.GetViewOrigin();
+	if (GVectorizedFrustumCull)
 	{
-		int32 Index = PrimitiveIndex /** NumBitsPerDWORD + BitSubIndex*/;
-		const FPrimitiveBounds& Bounds = Scene->PrimitiveBounds[Index];
-		float DistanceSquared = (Bounds.BoxSphereBounds.Origin - ViewOriginForDistanceCulling).SizeSquared();
-		int32 VisibilityId = INDEX_NONE;
-
-		float MaxDrawDistance = Bounds.MaxCullDistance < FLT_MAX ? Bounds.MaxCullDistance /** MaxDrawDistanceScale*/ : FLT_MAX;
-		float MinDrawDistanceSq = Bounds.MinDrawDistanceSq;
-
-		if (DistanceSquared > FMath::Square(MaxDrawDistance + FadeRadius) ||
-			(DistanceSquared < MinDrawDistanceSq) ||
-			//(UseCustomCulling && !View.CustomVisibilityQuery->IsVisible(VisibilityId, FBoxSphereBounds(Bounds.BoxSphereBounds.Origin, Bounds.BoxSphereBounds.BoxExtent, Bounds.BoxSphereBounds.SphereRadius))) ||
-			(bAlsoUseSphereTest && View.ViewFrustum.IntersectSphere(Bounds.BoxSphereBounds.Origin, Bounds.BoxSphereBounds.SphereRadius) == false) ||
-			View.ViewFrustum.IntersectBox(Bounds.BoxSphereBounds.Origin, Bounds.BoxSphereBounds.BoxExtent) == false
-			)
-		{
-
-		}
-		else
-		{
-			if (DistanceSquared > FMath::Square(MaxDrawDistance))
-			{
-				//FadingBits |= Mask;
-			}
-			else
-			{
-				View.PrimitiveVisibilityMap[Index] = true;
-			}
-		}
+		FrustumCullPrimitives(Scene->PrimitiveCullingBounds, View.ViewFrustum, ViewOriginForDistanceCulling, View.PrimitiveVisibilityMap);
+	}
+	else
+	{
+		FrustumCullPrimitivesScalar(Scene->PrimitiveBounds, View.ViewFrustum, ViewOriginForDistanceCulling, View.PrimitiveVisibilityMap);
 	}
-	return 0;
 }
 
 float Halton(int32 Index, int32 Base)
@@ -221,7 +195,12 @@ struct FRelevancePacket
 			const bool bTranslucentRelevance = ViewRelevance.HasTranslucency();
 
 
-			if (bDynamicRelevance)
+			if (bStaticRelevance && (bDrawRelevance || bShadowRelevance) && View.PrimitiveVisibilityMap[BitIndex])
+			{
+				RelevantStaticPrimitives.AddPrim(BitIndex);
+			}
+
+			if (bDynamicRelevance && View.PrimitiveVisibilityMap[BitIndex])
 			{
 				// Keep track of visible dynamic primitives.
 				VisibleDynamicPrimitives.AddPrim(PrimitiveSceneInfo);
@@ -232,6 +211,21 @@ struct FRelevancePacket
 
 	void MarkRelevant()
 	{
+		std::vector<bool>& StaticMeshVisibilityMap = const_cast<std::vector<bool>&>(View.StaticMeshVisibilityMap);
+		for (int32 StaticPrimIndex = 0; StaticPrimIndex < RelevantStaticPrimitives.NumPrims; ++StaticPrimIndex)
+		{
+			int32 PrimitiveIndex = RelevantStaticPrimitives.Prims[StaticPrimIndex];
+			const FPrimitiveSceneInfo* PrimitiveSceneInfo = Scene->Primitives[PrimitiveIndex];
+			const int32 LODToRender = PrimitiveSceneInfo->Proxy->GetLOD(&View);
+
+			for (const FStaticMesh* StaticMesh : PrimitiveSceneInfo->StaticMeshes)
+			{
+				if (LODToRender == INDEX_NONE || StaticMesh->LODIndex == LODToRender)
+				{
+					StaticMeshVisibilityMap[StaticMesh->Id] = true;
+				}
+			}
+		}
 	}
 
 };
@@ -246,26 +240,31 @@ static void ComputeAndMarkRelevanceForViewParallel(
 {
 	std::vector<FRelevancePacket*> Packets;
 
-	FRelevancePacket* Packet = new FRelevancePacket(
-		Scene,
-		View,
-		ViewBit,
-		/*ViewData,*/
-		OutHasDynamicMeshElementsMasks,
-		OutHasDynamicEditorMeshElementsMasks,
-		/*MarkMasks,*/
-		/*WillExecuteInParallel ? View.AllocateCustomDataMemStack() : View.GetCustomDataGlobalMemStack(),*/
-		HasViewCustomDataMasks);
-	Packets.push_back(Packet);
-
-	for (size_t i = 0; i < View.PrimitiveVisibilityMap.size(); ++i)
+	FRelevancePacket* Packet = nullptr;
+	for (int32 i = 0; i < View.PrimitiveVisibilityMap.Num(); ++i)
 	{
+		// a packet holds at most MaxInputPrims primitives
+		if (!Packet || Packet->Input.IsFull())
+		{
+			Packet = new FRelevancePacket(
+				Scene,
+				View,
+				ViewBit,
+				/*ViewData,*/
+				OutHasDynamicMeshElementsMasks,
+				OutHasDynamicEditorMeshElementsMasks,
+				/*MarkMasks,*/
+				/*WillExecuteInParallel ? View.AllocateCustomDataMemStack() : View.GetCustomDataGlobalMemStack(),*/
+				HasViewCustomDataMasks);
+			Packets.push_back(Packet);
+		}
 		Packet->Input.AddPrim(i);
 	}
 	
 	for (FRelevancePacket* Packet : Packets)
 	{
 		Packet->AnyThreadTask();
+		delete Packet;
 	}
 }
 
@@ -291,10 +290,10 @@ void FSceneRenderer::ComputeViewVisibility()
 	{
 		FViewInfo& View = Views[ViewIndex];
 
-		View.PrimitiveVisibilityMap.resize(Scene->Primitives.size(), false);
+		View.PrimitiveVisibilityMap.Init(false, Scene->Primitives.size());
 		View.DynamicMeshEndIndices.resize(Scene->Primitives.size(), 0);
 		View.PrimitiveFadeUniformBuffers.resize(Scene->Primitives.size(),0);
-		//View.StaticMeshVisibilityMap.resize(Scene->StaticMeshes.size(), false);
+		View.StaticMeshVisibilityMap.assign(Scene->StaticMeshes.size(), false);
 
 
 		View.VisibleLightInfos.reserve(Scene->Lights.size());
@@ -310,7 +309,12 @@ void FSceneRenderer::ComputeViewVisibility()
 
 		bool bNeedsFrustumCulling = true;
 
-		FrustumCull<true, true>(Scene, View);
+		FrustumCull(Scene, View);
+
+		if (GSoftwareOcclusionCulling)
+		{
+			SoftwareOcclusionCull(Scene, View);
+		}
 
 		ComputeAndMarkRelevanceForViewParallel(Scene, View, ViewBit, HasDynamicMeshElementsMasks, HasDynamicEditorMeshElementsMasks, HasViewCustomDataMasks);
 	}
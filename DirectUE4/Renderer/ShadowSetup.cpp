@@ -389,6 +389,8 @@ void FProjectedShadowInfo::AddSubjectPrimitive(FPrimitiveSceneInfo* PrimitiveSce
 
 		const FBoxSphereBounds& Bounds = Proxy->GetBounds();
 		bool bDrawingStaticMeshes = false;
+		// the finest LOD any of the views draws, so the shadow never misses geometry a view shows
+		int32 ShadowLOD = INDEX_NONE;
 
 		if (PrimitiveSceneInfo->StaticMeshes.size() > 0)
 		{
@@ -412,6 +414,8 @@ void FProjectedShadowInfo::AddSubjectPrimitive(FPrimitiveSceneInfo* PrimitiveSce
 				//if (!CurrentView.PrimitiveVisibilityMap[PrimitiveId] || CurrentView.PrimitiveViewRelevanceMap[PrimitiveId].bStaticRelevance)
 				{
 					bDrawingStaticMeshes |= true;// ShouldDrawStaticMeshes(CurrentView, bCustomDataRelevance, PrimitiveSceneInfo);
+					const int32 ViewLOD = Proxy->GetLOD(&CurrentView);
+					ShadowLOD = ShadowLOD == INDEX_NONE ? ViewLOD : FMath::Min(ShadowLOD, ViewLOD);
 				}
 			}
 		}
@@ -424,7 +428,7 @@ void FProjectedShadowInfo::AddSubjectPrimitive(FPrimitiveSceneInfo* PrimitiveSce
 				for (uint32 MeshIndex = 0; MeshIndex < PrimitiveSceneInfo->StaticMeshes.size(); MeshIndex++)
 				{
 					FStaticMesh& StaticMesh = *PrimitiveSceneInfo->StaticMeshes[MeshIndex];
-					if (StaticMesh.CastShadow)
+					if (StaticMesh.CastShadow && (ShadowLOD == INDEX_NONE || StaticMesh.LODIndex == ShadowLOD))
 					{
 						const FMaterialRenderProxy* MaterialRenderProxy = StaticMesh.MaterialRenderProxy;
 						const FMaterial* Material = MaterialRenderProxy->GetMaterial();
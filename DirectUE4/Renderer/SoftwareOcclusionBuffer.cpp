@@ -0,0 +1,301 @@
+#include "SoftwareOcclusionBuffer.h"
+#include "VectorRegister.h"
+#include "ParallelFor.h"
+
+#include <algorithm>
+
+/** Triangles are clipped against, and boxes with a corner in front of, W of this, to keep 1 / W finite */
+static const float GSoftwareOcclusionNearW = 1.0f;
+
+/**
+ * Clip space half spaces, Dot4(Plane, V) >= 0, occluder triangles are clipped to: the near plane, and a guard band twice
+ * the size of the screen that keeps the edge functions of triangles passing beside the camera precise.
+ */
+static const Vector4 GOccluderClipPlanes[5] =
+{
+	Vector4(0.f, 0.f, 0.f, 1.f),
+	Vector4(-1.f, 0.f, 0.f, 2.f),
+	Vector4(1.f, 0.f, 0.f, 2.f),
+	Vector4(0.f, -1.f, 0.f, 2.f),
+	Vector4(0.f, 1.f, 0.f, 2.f),
+};
+
+void FOccluderElementsCollector::AddElements(const std::vector<FVector>& Vertices, const std::vector<uint32>& Indices, const FMatrix& LocalToWorld)
+{
+	const FMatrix LocalToClip = LocalToWorld * ViewProjectionMatrix;
+	const uint32 FirstVertex = (uint32)ClipVertices.size();
+	ClipVertices.reserve(ClipVertices.size() + Vertices.size());
+	for (const FVector& Vertex : Vertices)
+	{
+		ClipVertices.push_back(LocalToClip.TransformPosition(Vertex));
+	}
+	this->Indices.reserve(this->Indices.size() + Indices.size());
+	for (uint32 Index : Indices)
+	{
+		this->Indices.push_back(FirstVertex + Index);
+	}
+}
+
+FSoftwareOcclusionBuffer::FSoftwareOcclusionBuffer()
+	: Depth(Width * Height, 0.f)
+	, BlockMinDepth(NumBlocksX * NumBlocksY, 0.f)
+	, TileBins(NumTilesX * NumTilesY)
+	, NumRasterizedTriangles(0)
+{
+}
+
+void FSoftwareOcclusionBuffer::Rasterize(const FOccluderElementsCollector& Collector, bool bForceSingleThread)
+{
+	ViewProjectionMatrix = Collector.GetViewProjectionMatrix();
+	std::fill(Depth.begin(), Depth.end(), 0.f);
+	Triangles.clear();
+	for (std::vector<int32>& Bin : TileBins)
+	{
+		Bin.clear();
+	}
+
+	// Clip every triangle to the near plane and the guard band, at most a fan of eight vertices is left, and bin the fan to the tiles
+	const std::vector<Vector4>& ClipVertices = Collector.GetClipVertices();
+	const std::vector<uint32>& Indices = Collector.GetIndices();
+	for (uint32 Index = 0; Index + 2 < Indices.size(); Index += 3)
+	{
+		Vector4 Polygon[8] = { ClipVertices[Indices[Index + 0]], ClipVertices[Indices[Index + 1]], ClipVertices[Indices[Index + 2]] };
+		int32 NumPolygonVertices = 3;
+		for (int32 PlaneIndex = 0; PlaneIndex < 5 && NumPolygonVertices >= 3; ++PlaneIndex)
+		{
+			const Vector4& Plane = GOccluderClipPlanes[PlaneIndex];
+			const float Offset = PlaneIndex == 0 ? GSoftwareOcclusionNearW : 0.f;
+			Vector4 Clipped[8];
+			int32 NumClippedVertices = 0;
+			for (int32 Vertex = 0; Vertex < NumPolygonVertices; ++Vertex)
+			{
+				const Vector4& Start = Polygon[Vertex];
+				const Vector4& End = Polygon[(Vertex + 1) % NumPolygonVertices];
+				const float StartDistance = Dot4(Plane, Start) - Offset;
+				const float EndDistance = Dot4(Plane, End) - Offset;
+				if (StartDistance >= 0.f)
+				{
+					Clipped[NumClippedVertices++] = Start;
+				}
+				if ((StartDistance >= 0.f) != (EndDistance >= 0.f))
+				{
+					Clipped[NumClippedVertices++] = Start + (End - Start) * (StartDistance / (StartDistance - EndDistance));
+				}
+			}
+			NumPolygonVertices = NumClippedVertices;
+			std::copy(Clipped, Clipped + NumClippedVertices, Polygon);
+		}
+		for (int32 FanIndex = 2; FanIndex < NumPolygonVertices; ++FanIndex)
+		{
+			SetupTriangle(ClipToPixel(Polygon[0]), ClipToPixel(Polygon[FanIndex - 1]), ClipToPixel(Polygon[FanIndex]));
+		}
+	}
+	NumRasterizedTriangles = (int32)Triangles.size();
+
+	ParallelFor(NumTilesX * NumTilesY, [this](int32 TileIndex)
+	{
+		RasterizeTile(TileIndex);
+	}, bForceSingleThread);
+}
+
+void FSoftwareOcclusionBuffer::SetupTriangle(const FVector& P0, const FVector& InP1, const FVector& InP2)
+{
+	// Wind every triangle the same way, both sides of an occluder are drawn
+	float Area = (InP1.X - P0.X) * (InP2.Y - P0.Y) - (InP2.X - P0.X) * (InP1.Y - P0.Y);
+	const bool bFlip = Area < 0.f;
+	const FVector& P1 = bFlip ? InP2 : InP1;
+	const FVector& P2 = bFlip ? InP1 : InP2;
+	Area = FMath::Abs(Area);
+	if (Area < SMALL_NUMBER)
+	{
+		return;
+	}
+
+	// Pixels the bounds of the triangle contain entirely
+	const int32 MinX = FMath::Max(FMath::CeilToInt(FMath::Min3(P0.X, P1.X, P2.X)), 0);
+	const int32 MaxX = FMath::Min(FMath::FloorToInt(FMath::Max3(P0.X, P1.X, P2.X)) - 1, (int32)Width - 1);
+	const int32 MinY = FMath::Max(FMath::CeilToInt(FMath::Min3(P0.Y, P1.Y, P2.Y)), 0);
+	const int32 MaxY = FMath::Min(FMath::FloorToInt(FMath::Max3(P0.Y, P1.Y, P2.Y)) - 1, (int32)Height - 1);
+	if (MinX > MaxX || MinY > MaxY)
+	{
+		return;
+	}
+
+	FTriangleSetup Setup;
+	Setup.MinX = MinX;
+	Setup.MinY = MinY;
+	Setup.MaxX = MaxX;
+	Setup.MaxY = MaxY;
+
+	// Edge I runs from vertex I to the next one, it is positive on the side of the vertex opposite to it
+	const FVector* Points[3] = { &P0, &P1, &P2 };
+	for (int32 Edge = 0; Edge < 3; ++Edge)
+	{
+		const FVector& Start = *Points[Edge];
+		const FVector& End = *Points[(Edge + 1) % 3];
+		Setup.EdgeA[Edge] = Start.Y - End.Y;
+		Setup.EdgeB[Edge] = End.X - Start.X;
+		Setup.EdgeC[Edge] = -(Setup.EdgeA[Edge] * Start.X + Setup.EdgeB[Edge] * Start.Y);
+	}
+
+	// The barycentric coordinate of a vertex is the edge opposite to it over the area
+	const float InvArea = 1.f / Area;
+	const float Weights[3] = { P0.Z * InvArea, P1.Z * InvArea, P2.Z * InvArea };
+	Setup.DepthA = Setup.EdgeA[1] * Weights[0] + Setup.EdgeA[2] * Weights[1] + Setup.EdgeA[0] * Weights[2];
+	Setup.DepthB = Setup.EdgeB[1] * Weights[0] + Setup.EdgeB[2] * Weights[1] + Setup.EdgeB[0] * Weights[2];
+	Setup.DepthC = Setup.EdgeC[1] * Weights[0] + Setup.EdgeC[2] * Weights[1] + Setup.EdgeC[0] * Weights[2];
+
+	// A plane is lowest over a pixel at one of its corners, half a pixel from the center along both axes. At the centers the
+	// edge functions then tell whether the whole pixel is inside, and the depth is the farthest the triangle has over the pixel.
+	for (int32 Edge = 0; Edge < 3; ++Edge)
+	{
+		Setup.EdgeC[Edge] -= 0.5f * (FMath::Abs(Setup.EdgeA[Edge]) + FMath::Abs(Setup.EdgeB[Edge]));
+	}
+	Setup.DepthC -= 0.5f * (FMath::Abs(Setup.DepthA) + FMath::Abs(Setup.DepthB));
+
+	const int32 TriangleIndex = (int32)Triangles.size();
+	Triangles.push_back(Setup);
+	for (int32 TileY = MinY / TileHeight; TileY <= MaxY / TileHeight; ++TileY)
+	{
+		for (int32 TileX = MinX / TileWidth; TileX <= MaxX / TileWidth; ++TileX)
+		{
+			TileBins[TileY * NumTilesX + TileX].push_back(TriangleIndex);
+		}
+	}
+}
+
+void FSoftwareOcclusionBuffer::RasterizeTile(int32 TileIndex)
+{
+	const int32 TileMinX = (TileIndex % NumTilesX) * TileWidth;
+	const int32 TileMinY = (TileIndex / NumTilesX) * TileHeight;
+	const VectorRegister PixelOffsets = MakeVectorRegister(0.5f, 1.5f, 2.5f, 3.5f);
+	const VectorRegister FourPixels = VectorSetFloat1(4.f);
+	const VectorRegister Zero = VectorZero();
+
+	for (int32 TriangleIndex : TileBins[TileIndex])
+	{
+		const FTriangleSetup& Setup = Triangles[TriangleIndex];
+		// Rows are walked in groups of four aligned pixels, the edge functions reject what is outside the triangle
+		const int32 MinX = FMath::Max(Setup.MinX, TileMinX) & ~3;
+		const int32 MaxX = FMath::Min(Setup.MaxX, TileMinX + (int32)TileWidth - 1);
+		const int32 MinY = FMath::Max(Setup.MinY, TileMinY);
+		const int32 MaxY = FMath::Min(Setup.MaxY, TileMinY + (int32)TileHeight - 1);
+
+		const VectorRegister EdgeA0 = VectorSetFloat1(Setup.EdgeA[0]);
+		const VectorRegister EdgeA1 = VectorSetFloat1(Setup.EdgeA[1]);
+		const VectorRegister EdgeA2 = VectorSetFloat1(Setup.EdgeA[2]);
+		const VectorRegister DepthA = VectorSetFloat1(Setup.DepthA);
+		const VectorRegister StartX = VectorAdd(VectorSetFloat1((float)MinX), PixelOffsets);
+
+		for (int32 Y = MinY; Y <= MaxY; ++Y)
+		{
+			const float CenterY = (float)Y + 0.5f;
+			const VectorRegister EdgeRow0 = VectorSetFloat1(Setup.EdgeB[0] * CenterY + Setup.EdgeC[0]);
+			const VectorRegister EdgeRow1 = VectorSetFloat1(Setup.EdgeB[1] * CenterY + Setup.EdgeC[1]);
+			const VectorRegister EdgeRow2 = VectorSetFloat1(Setup.EdgeB[2] * CenterY + Setup.EdgeC[2]);
+			const VectorRegister DepthRow = VectorSetFloat1(Setup.DepthB * CenterY + Setup.DepthC);
+
+			float* DepthRowData = &Depth[Y * Width];
+			VectorRegister CenterX = StartX;
+			for (int32 X = MinX; X <= MaxX; X += 4)
+			{
+				const VectorRegister Edge0 = VectorMultiplyAdd(EdgeA0, CenterX, EdgeRow0);
+				const VectorRegister Edge1 = VectorMultiplyAdd(EdgeA1, CenterX, EdgeRow1);
+				const VectorRegister Edge2 = VectorMultiplyAdd(EdgeA2, CenterX, EdgeRow2);
+				const VectorRegister Inside = VectorBitwiseAnd(VectorCompareGE(Edge0, Zero), VectorBitwiseAnd(VectorCompareGE(Edge1, Zero), VectorCompareGE(Edge2, Zero)));
+				if (VectorMaskBits(Inside))
+				{
+					const VectorRegister TriangleDepth = VectorMultiplyAdd(DepthA, CenterX, DepthRow);
+					const VectorRegister PixelDepth = VectorLoad(DepthRowData + X);
+					VectorStore(VectorSelect(Inside, VectorMax(PixelDepth, TriangleDepth), PixelDepth), DepthRowData + X);
+				}
+				CenterX = VectorAdd(CenterX, FourPixels);
+			}
+		}
+	}
+
+	// The farthest depth of every block of the tile
+	for (int32 BlockY = TileMinY / BlockSize; BlockY < (TileMinY + TileHeight) / BlockSize; ++BlockY)
+	{
+		for (int32 BlockX = TileMinX / BlockSize; BlockX < (TileMinX + TileWidth) / BlockSize; ++BlockX)
+		{
+			float MinDepth = MAX_flt;
+			for (int32 Y = BlockY * BlockSize; Y < (BlockY + 1) * BlockSize; ++Y)
+			{
+				for (int32 X = BlockX * BlockSize; X < (BlockX + 1) * BlockSize; ++X)
+				{
+					MinDepth = FMath::Min(MinDepth, Depth[Y * Width + X]);
+				}
+			}
+			BlockMinDepth[BlockY * NumBlocksX + BlockX] = MinDepth;
+		}
+	}
+}
+
+bool FSoftwareOcclusionBuffer::IsBoxOccluded(const FVector& Origin, const FVector& Extent) const
+{
+	// Corners are the clip space origin plus or minus the clip space axes scaled by the extent
+	const Vector4 ClipOrigin = ViewProjectionMatrix.TransformPosition(Origin);
+	const Vector4 ClipAxes[3] =
+	{
+		Vector4(ViewProjectionMatrix.M[0][0], ViewProjectionMatrix.M[0][1], ViewProjectionMatrix.M[0][2], ViewProjectionMatrix.M[0][3]) * Extent.X,
+		Vector4(ViewProjectionMatrix.M[1][0], ViewProjectionMatrix.M[1][1], ViewProjectionMatrix.M[1][2], ViewProjectionMatrix.M[1][3]) * Extent.Y,
+		Vector4(ViewProjectionMatrix.M[2][0], ViewProjectionMatrix.M[2][1], ViewProjectionMatrix.M[2][2], ViewProjectionMatrix.M[2][3]) * Extent.Z,
+	};
+
+	float MinX = MAX_flt, MinY = MAX_flt, MaxX = -MAX_flt, MaxY = -MAX_flt;
+	float NearestDepth = 0.f;
+	for (int32 Corner = 0; Corner < 8; ++Corner)
+	{
+		const Vector4 Clip = ClipOrigin
+			+ ((Corner & 1) ? ClipAxes[0] : -ClipAxes[0])
+			+ ((Corner & 2) ? ClipAxes[1] : -ClipAxes[1])
+			+ ((Corner & 4) ? ClipAxes[2] : -ClipAxes[2]);
+		if (Clip.W < GSoftwareOcclusionNearW)
+		{
+			// Boxes reaching the near plane are never occluded
+			return false;
+		}
+		const FVector Pixel = ClipToPixel(Clip);
+		MinX = FMath::Min(MinX, Pixel.X);
+		MinY = FMath::Min(MinY, Pixel.Y);
+		MaxX = FMath::Max(MaxX, Pixel.X);
+		MaxY = FMath::Max(MaxY, Pixel.Y);
+		NearestDepth = FMath::Max(NearestDepth, Pixel.Z);
+	}
+
+	// Every pixel the rectangle touches, not just those whose centers it contains
+	if (MaxX < 0.f || MaxY < 0.f || MinX >= (float)Width || MinY >= (float)Height)
+	{
+		return false;
+	}
+	const int32 X0 = FMath::Max(FMath::FloorToInt(MinX), 0);
+	const int32 Y0 = FMath::Max(FMath::FloorToInt(MinY), 0);
+	const int32 X1 = FMath::Min(FMath::FloorToInt(MaxX), (int32)Width - 1);
+	const int32 Y1 = FMath::Min(FMath::FloorToInt(MaxY), (int32)Height - 1);
+
+	// Blocks entirely nearer than the box are settled without looking at their pixels
+	for (int32 BlockY = Y0 / BlockSize; BlockY <= Y1 / BlockSize; ++BlockY)
+	{
+		for (int32 BlockX = X0 / BlockSize; BlockX <= X1 / BlockSize; ++BlockX)
+		{
+			if (BlockMinDepth[BlockY * NumBlocksX + BlockX] > NearestDepth)
+			{
+				continue;
+			}
+			const int32 BlockX1 = FMath::Min(X1, (BlockX + 1) * BlockSize - 1);
+			const int32 BlockY1 = FMath::Min(Y1, (BlockY + 1) * BlockSize - 1);
+			for (int32 Y = FMath::Max(Y0, BlockY * BlockSize); Y <= BlockY1; ++Y)
+			{
+				for (int32 X = FMath::Max(X0, BlockX * BlockSize); X <= BlockX1; ++X)
+				{
+					if (Depth[Y * Width + X] <= NearestDepth)
+					{
+						return false;
+					}
+				}
+			}
+		}
+	}
+	return true;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "UnrealMath.h"
+
+#include <vector>
+
+/**
+ * Triangles of the occluders of one view, transformed to clip space as FPrimitiveSceneProxy::CollectOccluderElements
+ * hands them over.
+ */
+class FOccluderElementsCollector
+{
+public:
+	FOccluderElementsCollector(const FMatrix& InViewProjectionMatrix)
+		: ViewProjectionMatrix(InViewProjectionMatrix)
+	{}
+
+	/** Adds the triangle list Indices into Vertices, in the space LocalToWorld transforms to world space */
+	void AddElements(const std::vector<FVector>& Vertices, const std::vector<uint32>& Indices, const FMatrix& LocalToWorld);
+
+	int32 NumTriangles() const { return (int32)(Indices.size() / 3); }
+
+	const FMatrix& GetViewProjectionMatrix() const { return ViewProjectionMatrix; }
+
+	const std::vector<Vector4>& GetClipVertices() const { return ClipVertices; }
+	const std::vector<uint32>& GetIndices() const { return Indices; }
+
+private:
+	FMatrix ViewProjectionMatrix;
+	std::vector<Vector4> ClipVertices;
+	std::vector<uint32> Indices;
+};
+
+/**
+ * A low resolution depth buffer of occluders, rasterized on the CPU, and the hierarchical-Z tests of bounding boxes against it.
+ * Depth is stored as 1 / W, which is linear in screen space for either Z convention of the projection, nearer is larger
+ * and 0 is nothing drawn. The buffer is split into tiles rasterized in parallel; every pixel keeps the largest depth any
+ * triangle writes to it, so the result does not depend on the order triangles land in or on the number of workers.
+ * Rasterization is conservative: a triangle only writes the pixels it covers entirely, with the farthest depth it has over
+ * the pixel, so no pixel is ever nearer than the occluders behind it. Pixels no single triangle covers stay open, along
+ * the silhouettes and along the edges shared by the triangles of a mesh, which costs some culling but hides nothing.
+ */
+class FSoftwareOcclusionBuffer
+{
+public:
+	enum
+	{
+		Width = 256,
+		Height = 128,
+		/** Tiles are the unit of parallel rasterization, rows of a tile are rasterized four pixels at a time */
+		TileWidth = 64,
+		TileHeight = 32,
+		NumTilesX = Width / TileWidth,
+		NumTilesY = Height / TileHeight,
+		/** Blocks of BlockSize x BlockSize pixels keep their farthest depth for the coarse level of the occludee tests */
+		BlockSize = 8,
+		NumBlocksX = Width / BlockSize,
+		NumBlocksY = Height / BlockSize,
+	};
+
+	FSoftwareOcclusionBuffer();
+
+	/** Clears the buffer and rasterizes the triangles of Collector, clipped against the near plane */
+	void Rasterize(const FOccluderElementsCollector& Collector, bool bForceSingleThread = false);
+
+	/** Whether every pixel the projection of the box touches holds an occluder nearer than the nearest corner of the box */
+	bool IsBoxOccluded(const FVector& Origin, const FVector& Extent) const;
+
+	float GetDepth(int32 X, int32 Y) const { return Depth[Y * Width + X]; }
+
+	int32 GetNumRasterizedTriangles() const { return NumRasterizedTriangles; }
+
+	/** Pixel coordinates of a clip space position in front of the near plane, and 1 / W as Z */
+	static FVector ClipToPixel(const Vector4& Clip)
+	{
+		const float InvW = 1.f / Clip.W;
+		return FVector((Clip.X * InvW * 0.5f + 0.5f) * Width, (0.5f - Clip.Y * InvW * 0.5f) * Height, InvW);
+	}
+
+private:
+	/**
+	 * Screen space edge functions and depth plane of a triangle, and the pixels its bounds cover. The constant terms are
+	 * offset by half a pixel along both axes, so their values at a pixel center are their minimum over the pixel.
+	 */
+	struct FTriangleSetup
+	{
+		float EdgeA[3];
+		float EdgeB[3];
+		float EdgeC[3];
+		float DepthA;
+		float DepthB;
+		float DepthC;
+		int32 MinX, MinY, MaxX, MaxY;
+	};
+
+	/** Sets up the triangle between three points in pixels, with 1 / W as their Z, and bins it to the tiles it overlaps */
+	void SetupTriangle(const FVector& P0, const FVector& P1, const FVector& P2);
+	void RasterizeTile(int32 TileIndex);
+
+	FMatrix ViewProjectionMatrix;
+	std::vector<float> Depth;
+	std::vector<float> BlockMinDepth;
+	std::vector<FTriangleSetup> Triangles;
+	/** Triangles overlapping each tile, in the order they were set up */
+	std::vector<std::vector<int32>> TileBins;
+	int32 NumRasterizedTriangles;
+};
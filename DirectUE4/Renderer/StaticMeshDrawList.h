@@ -3,6 +3,7 @@
 #include "DrawingPolicy.h"
 
 #include <vector>
+#include <algorithm>
 
 
 class FViewInfo;
@@ -98,16 +99,22 @@ public:
 		const ElementPolicyDataType& PolicyData,
 		const DrawingPolicyType& InDrawingPolicy//,
 	);
-	inline bool DrawVisible(ID3D11DeviceContext* Context, const FViewInfo& View, const FDrawingPolicyRenderState& DrawRenderState/*, const TBitArray<SceneRenderingBitArrayAllocator>& StaticMeshVisibilityMap, const TArray<uint64, SceneRenderingAllocator>& BatchVisibilityArray*/)
+	/** Removes every element drawing Mesh, and drawing policy links left without elements. */
+	void RemoveMesh(const FStaticMesh* Mesh);
+	/**
+	 * Draws only the meshes set in StaticMeshVisibilityMap, indexed by FStaticMesh::Id.
+	 * @return true if any static meshes were drawn
+	 */
+	inline bool DrawVisible(ID3D11DeviceContext* Context, const FViewInfo& View, const FDrawingPolicyRenderState& DrawRenderState, const std::vector<bool>& StaticMeshVisibilityMap/*, const TArray<uint64, SceneRenderingAllocator>& BatchVisibilityArray*/)
 	{
-		return DrawVisible(Context, View, typename DrawingPolicyType::ContextDataType(), DrawRenderState/*, StaticMeshVisibilityMap, BatchVisibilityArray*/);
+		return DrawVisible(Context, View, typename DrawingPolicyType::ContextDataType(), DrawRenderState, StaticMeshVisibilityMap/*, BatchVisibilityArray*/);
 	}
 	bool DrawVisible(
 		ID3D11DeviceContext* Context, 
 		const FViewInfo& View, 
 		const typename DrawingPolicyType::ContextDataType PolicyContext, 
-		const FDrawingPolicyRenderState& DrawRenderState//,
-		/*const TBitArray<SceneRenderingBitArrayAllocator>& StaticMeshVisibilityMap,*/ 
+		const FDrawingPolicyRenderState& DrawRenderState,
+		const std::vector<bool>& StaticMeshVisibilityMap//,
 		/*const TArray<uint64, SceneRenderingAllocator>& BatchVisibilityArray*/);
 
 private:
@@ -124,16 +131,35 @@ void TStaticMeshDrawList<DrawingPolicyType>::AddMesh(FStaticMesh* Mesh, const El
 	//FElement* Element = new(DrawingPolicyLink->Elements) FElement(Mesh, PolicyData, this, DrawingPolicyLink->SetId, ElementIndex);
 }
 
+template<typename DrawingPolicyType>
+void TStaticMeshDrawList<DrawingPolicyType>::RemoveMesh(const FStaticMesh* Mesh)
+{
+	for (uint32 Index = 0; Index < DrawingPolicySet.size();)
+	{
+		std::vector<FElement>& Elements = DrawingPolicySet[Index].Elements;
+		Elements.erase(std::remove_if(Elements.begin(), Elements.end(), [Mesh](const FElement& Element) { return Element.Mesh == Mesh; }), Elements.end());
+		if (Elements.empty())
+		{
+			DrawingPolicySet.erase(DrawingPolicySet.begin() + Index);
+		}
+		else
+		{
+			Index++;
+		}
+	}
+}
+
 template<typename DrawingPolicyType>
 bool TStaticMeshDrawList<DrawingPolicyType>::DrawVisible(
 	ID3D11DeviceContext* Context, 
 	const FViewInfo& View, 
 	const typename DrawingPolicyType::ContextDataType PolicyContext,  
-	const FDrawingPolicyRenderState& DrawRenderState//, 
-	/*const TBitArray<SceneRenderingBitArrayAllocator>& StaticMeshVisibilityMap,*/ 
+	const FDrawingPolicyRenderState& DrawRenderState,
+	const std::vector<bool>& StaticMeshVisibilityMap//,
 	/*const TArray<uint64, SceneRenderingAllocator>& BatchVisibilityArray*/)
 {
 	FDrawingPolicyRenderState DrawRenderStateLocal(DrawRenderState);
+	bool bDirty = false;
 
 	for (uint32 Index = 0; Index < DrawingPolicySet.size(); Index++)
 	{
@@ -144,12 +170,16 @@ bool TStaticMeshDrawList<DrawingPolicyType>::DrawVisible(
 		for (uint32 ElementIndex = 0; ElementIndex < NumElements; ElementIndex++)
 		{
 			const FElement& Element = DrawingPolicyLink->Elements[ElementIndex];
-			// Avoid the cache miss looking up batch visibility if there is only one element.
-			//uint64 BatchElementMask = Element.Mesh->bRequiresPerElementVisibility ? (*BatchVisibilityArray)[Element.Mesh->BatchVisibilityId] : ((1ull << SubCount) - 1);
-			Count += DrawElement(Context, View, PolicyContext, DrawRenderStateLocal, Element, /*BatchElementMask,*/ DrawingPolicyLink, bDrawnShared);
+			if (StaticMeshVisibilityMap[Element.Mesh->Id])
+			{
+				// Avoid the cache miss looking up batch visibility if there is only one element.
+				//uint64 BatchElementMask = Element.Mesh->bRequiresPerElementVisibility ? (*BatchVisibilityArray)[Element.Mesh->BatchVisibilityId] : ((1ull << SubCount) - 1);
+				Count += DrawElement(Context, View, PolicyContext, DrawRenderStateLocal, Element, /*BatchElementMask,*/ DrawingPolicyLink, bDrawnShared);
+				bDirty = true;
+			}
 		}
 	}
-	return true;
+	return bDirty;
 }
 
 
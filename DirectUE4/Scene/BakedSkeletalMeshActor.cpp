@@ -0,0 +1,95 @@
+#include "BakedSkeletalMeshActor.h"
+#include "FBXImporter.h"
+#include "SkeletalMesh.h"
+#include "MeshComponent.h"
+#include "AnimSequence.h"
+#include "BakedAnimation.h"
+#include "SecureHash.h"
+#include "log.h"
+#include <map>
+
+/** Frames per second animations are baked at */
+static const float BakedAnimationSampleRate = 30.f;
+
+static std::shared_ptr<const FBakedAnimationData> FindOrBakeAnimation(USkeletalMesh* Mesh, const char* ResourcePath, const char* AnimationPath)
+{
+	static std::map<std::string, std::shared_ptr<const FBakedAnimationData>> BakedAnimations;
+
+	const std::string Key = std::string(ResourcePath) + "|" + AnimationPath;
+	auto It = BakedAnimations.find(Key);
+	if (It != BakedAnimations.end())
+	{
+		return It->second;
+	}
+
+	// the blob next to the animation is reused as long as it was baked from the same mesh and animation files, at the same rate
+	FSHAHash SourceHash;
+	FSHAHash SourceFileHashes[2];
+	if (FBXImporter::HashSourceFile(ResourcePath, SourceFileHashes[0]) && FBXImporter::HashSourceFile(AnimationPath, SourceFileHashes[1]))
+	{
+		FSHA1::HashBuffer(SourceFileHashes, sizeof(SourceFileHashes), SourceHash.Hash);
+	}
+
+	std::shared_ptr<FBakedAnimationData> BakedAnimation = std::make_shared<FBakedAnimationData>();
+	const std::string BakedPath = std::string(AnimationPath) + ".baked";
+	const bool bUpToDate = BakedAnimation->LoadFromFile(BakedPath)
+		&& SourceHash != FSHAHash() && BakedAnimation->GetSourceHash() == SourceHash
+		&& BakedAnimation->GetSampleRate() == BakedAnimationSampleRate
+		&& BakedAnimation->GetNumBones() == Mesh->RefSkeleton.GetNum();
+	if (!bUpToDate)
+	{
+		FBXImporter Importer;
+		UAnimSequence* Sequence = Importer.ImportFbxAnimation(Mesh->Skeleton, AnimationPath, "Idle", false);
+		std::vector<UAnimSequence*> Sequences;
+		if (Sequence)
+		{
+			Sequences.push_back(Sequence);
+		}
+
+		// a failed import or bake is remembered too, the other instances don't retry it
+		FBakedAnimationReport Report;
+		if (Sequence && BakedAnimation->Bake(Mesh, Sequences, BakedAnimationSampleRate, &Report))
+		{
+			Report.Log();
+			BakedAnimation->SetSourceHash(SourceHash);
+			BakedAnimation->SaveToFile(BakedPath);
+		}
+		else
+		{
+			X_LOG("Failed to bake %s, the instances stay in the bind pose\n", AnimationPath);
+			BakedAnimation.reset();
+		}
+	}
+
+	BakedAnimations[Key] = BakedAnimation;
+	return BakedAnimation;
+}
+
+BakedSkeletalMeshActor::BakedSkeletalMeshActor(class UWorld* InOwner, const char* ResourcePath, const char* AnimationPath, float TimeOffset)
+	: AActor(InOwner)
+{
+	FBXImporter Importer;
+	USkeletalMesh* Mesh = Importer.ImportSkeletalMesh(this, ResourcePath);
+
+	MeshComponent = new UBakedSkeletalMeshComponent(this);
+	MeshComponent->SetSkeletalMesh(Mesh);
+	MeshComponent->Mobility = EComponentMobility::Movable;
+	MeshComponent->SetBakedAnimation(FindOrBakeAnimation(Mesh, ResourcePath, AnimationPath), 0, TimeOffset);
+
+	RootComponent = MeshComponent;
+}
+
+BakedSkeletalMeshActor::~BakedSkeletalMeshActor()
+{
+	MeshComponent->Unregister();
+}
+
+void BakedSkeletalMeshActor::PostLoad()
+{
+	MeshComponent->Register();
+}
+
+void BakedSkeletalMeshActor::Tick(float fDeltaTime)
+{
+	MeshComponent->TickComponent(fDeltaTime);
+}
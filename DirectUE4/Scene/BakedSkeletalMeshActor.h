@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Actor.h"
+
+class UBakedSkeletalMeshComponent;
+
+/**
+* Crowd character that plays a baked animation. The animation is baked once per mesh and animation file and shared by
+* every actor playing it, each one only adds its own time offset.
+*/
+class BakedSkeletalMeshActor : public AActor
+{
+public:
+	BakedSkeletalMeshActor(class UWorld* InOwner, const char* ResourcePath, const char* AnimationPath, float TimeOffset);
+	virtual ~BakedSkeletalMeshActor();
+
+	virtual void PostLoad() override;
+
+	virtual void Tick(float fDeltaTime) override;
+protected:
+	UBakedSkeletalMeshComponent* MeshComponent;
+};
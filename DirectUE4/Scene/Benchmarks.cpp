@@ -0,0 +1,1090 @@
+#include "Benchmarks.h"
+#include "World.h"
+#include "Scene.h"
+#include "StaticMeshActor.h"
+#include "SkeletalMeshActor.h"
+#include "BakedSkeletalMeshActor.h"
+#include "PointLightActor.h"
+#include "MeshComponent.h"
+#include "ParallelFor.h"
+#include "AnimPoseCache.h"
+#include "AnimEncoding.h"
+#include "AnimSequence.h"
+#include "DerivedDataCache.h"
+#include "FBXImporter.h"
+#include "StaticMesh.h"
+#include "MeshDescription.h"
+#include "MeshDescriptionOperations.h"
+#include "MeshOptimization.h"
+#include "MeshReduction.h"
+#include "GenericOctree.h"
+#include "FrustumCull.h"
+#include "SceneSoftwareOcclusion.h"
+#include "LightGridInjection.h"
+#include "log.h"
+#include <chrono>
+#include <array>
+#include <random>
+#include <algorithm>
+#include <thread>
+
+/** The sphere of the demo scene, movable so BenchmarkLightInteractions can move it every frame */
+class MovableSphereActor : public StaticMeshActor
+{
+public:
+	MovableSphereActor(class UWorld* InOwner, const char* ResourcePath)
+		: StaticMeshActor(InOwner, ResourcePath)
+	{
+		MeshComponent->Mobility = EComponentMobility::Movable;
+	}
+};
+
+void BenchmarkAnimationEvaluation(UWorld& World, int NumMannequins, int NumFrames)
+{
+	const int GridSize = FMath::CeilToInt(FMath::Sqrt((float)NumMannequins));
+	for (int Index = 0; Index < NumMannequins; ++Index)
+	{
+		SkeletalMeshActor* Mannequin = World.SpawnActor<SkeletalMeshActor>("Mannequin/SK_Mannequin.FBX", "Mannequin/ThirdPersonWalk.FBX");
+		Mannequin->SetActorLocation(FVector(200.f * (Index % GridSize), 200.f * (Index / GridSize), -45.f));
+	}
+
+	const bool bOldParallel = GParallelAnimationEvaluation;
+	const float DeltaSeconds = 1.f / 30.f;
+	double MillisecondsPerFrame[2];
+	for (int Pass = 0; Pass < 2; ++Pass)
+	{
+		GParallelAnimationEvaluation = (Pass == 1);
+		// one untimed frame so both passes start from warm caches
+		World.Tick(DeltaSeconds);
+		GAnimPoseCache.ResetStats();
+
+		const auto StartTime = std::chrono::high_resolution_clock::now();
+		for (int Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			World.Tick(DeltaSeconds);
+		}
+		const std::chrono::duration<double, std::milli> Elapsed = std::chrono::high_resolution_clock::now() - StartTime;
+		MillisecondsPerFrame[Pass] = Elapsed.count() / std::max(NumFrames, 1);
+	}
+	GParallelAnimationEvaluation = bOldParallel;
+
+	X_LOG("BenchmarkAnimationEvaluation: %d mannequins, %d frames, %u hardware threads\n", NumMannequins, NumFrames, std::thread::hardware_concurrency());
+	X_LOG("  serial   %.3f ms/frame\n", MillisecondsPerFrame[0]);
+	X_LOG("  parallel %.3f ms/frame (%.2fx)\n", MillisecondsPerFrame[1], MillisecondsPerFrame[0] / std::max(MillisecondsPerFrame[1], 1e-6));
+	GAnimPoseCache.LogStats();
+}
+
+void BenchmarkBakedAnimation(UWorld& World, int NumMannequins, int NumFrames)
+{
+	const int GridSize = FMath::CeilToInt(FMath::Sqrt((float)NumMannequins));
+	for (int Index = 0; Index < NumMannequins; ++Index)
+	{
+		// spread the instances over the walk cycle, the offset is all that differs between them
+		BakedSkeletalMeshActor* Mannequin = World.SpawnActor<BakedSkeletalMeshActor>("Mannequin/SK_Mannequin.FBX", "Mannequin/ThirdPersonWalk.FBX", 0.37f * Index);
+		Mannequin->SetActorLocation(FVector(200.f * (Index % GridSize), -200.f * (1 + Index / GridSize), -45.f));
+	}
+
+	const float DeltaSeconds = 1.f / 30.f;
+	World.Tick(DeltaSeconds);
+
+	const auto StartTime = std::chrono::high_resolution_clock::now();
+	for (int Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		World.Tick(DeltaSeconds);
+	}
+	const std::chrono::duration<double, std::milli> Elapsed = std::chrono::high_resolution_clock::now() - StartTime;
+
+	X_LOG("BenchmarkBakedAnimation: %d mannequins, %d frames, %.3f ms/frame\n", NumMannequins, NumFrames, Elapsed.count() / std::max(NumFrames, 1));
+}
+
+void BenchmarkPoseDecompression(UWorld& World, int NumSamples)
+{
+	SkeletalMeshActor* Mannequin = World.SpawnActor<SkeletalMeshActor>("Mannequin/SK_Mannequin.FBX", "Mannequin/ThirdPersonWalk.FBX");
+	if (UAnimSequence* Sequence = Mannequin->GetAnimSequence())
+	{
+		AnimationFormat_BenchmarkPoseDecompression(*Sequence, NumSamples);
+	}
+}
+
+void BenchmarkStaticMeshDerivedData(int NumIterations)
+{
+	const char* MeshFiles[] = { "Primitives/Floor.fbx", "Primitives/Sphere.fbx" };
+	NumIterations = std::max(NumIterations, 1);
+
+	auto LoadMeshes = [&]()
+	{
+		const auto StartTime = std::chrono::high_resolution_clock::now();
+		for (const char* MeshFile : MeshFiles)
+		{
+			FBXImporter Importer;
+			UStaticMesh* Mesh = Importer.ImportStaticMesh(nullptr, MeshFile);
+			if (Mesh)
+			{
+				Mesh->ReleaseResources();
+				delete Mesh;
+			}
+		}
+		const std::chrono::duration<double, std::milli> Elapsed = std::chrono::high_resolution_clock::now() - StartTime;
+		return Elapsed.count();
+	};
+
+	FDerivedDataCache& DDC = GetDerivedDataCacheRef();
+	const bool bUseDerivedDataCache = GUseDerivedDataCache;
+
+	GUseDerivedDataCache = false;
+	double ColdTime = 0.0;
+	for (int Iteration = 0; Iteration < NumIterations; ++Iteration)
+	{
+		ColdTime += LoadMeshes();
+	}
+
+	// InitWorld normally stored the entries already, one load makes sure they exist even if it ran with -noddc
+	GUseDerivedDataCache = true;
+	LoadMeshes();
+	DDC.ResetStats();
+	double WarmTime = 0.0;
+	for (int Iteration = 0; Iteration < NumIterations; ++Iteration)
+	{
+		WarmTime += LoadMeshes();
+	}
+	GUseDerivedDataCache = bUseDerivedDataCache;
+
+	X_LOG("BenchmarkStaticMeshDerivedData: %d meshes, cold %.3f ms, warm %.3f ms\n", (int)(sizeof(MeshFiles) / sizeof(MeshFiles[0])), ColdTime / NumIterations, WarmTime / NumIterations);
+	DDC.LogStats();
+}
+
+void BenchmarkOverlappingCorners(int NumWedges)
+{
+	// two triangles per quad, every triangle has its own three vertex instances
+	const int GridSize = std::max(FMath::FloorToInt(FMath::Sqrt(NumWedges / 6.f)), 1);
+
+	MeshDescription MD;
+	MD.VertexAttributes().RegisterAttribute<FVector>(MeshAttribute::Vertex::Position, 1, FVector());
+	TMeshAttributesRef<FVector> VertexPositions = MD.VertexAttributes().GetAttributesRef<FVector>(MeshAttribute::Vertex::Position);
+	MD.ReserveNewVertices((GridSize + 1) * (GridSize + 1));
+	for (int Y = 0; Y <= GridSize; ++Y)
+	{
+		for (int X = 0; X <= GridSize; ++X)
+		{
+			const int VertexID = MD.CreateVertex();
+			VertexPositions[VertexID] = FVector(10.f * X, 10.f * Y, 0.f);
+		}
+	}
+	for (int Y = 0; Y < GridSize; ++Y)
+	{
+		for (int X = 0; X < GridSize; ++X)
+		{
+			const int V00 = Y * (GridSize + 1) + X;
+			const int V10 = V00 + 1;
+			const int V01 = V00 + GridSize + 1;
+			const int V11 = V01 + 1;
+			const int Corners[6] = { V00, V10, V11, V00, V11, V01 };
+			for (int VertexID : Corners)
+			{
+				MD.CreateVertexInstance(VertexID);
+			}
+		}
+	}
+
+	FOverlappingCornerAdjacency OverlappingCorners;
+	const auto StartTime = std::chrono::high_resolution_clock::now();
+	MeshDescriptionOperations::FindOverlappingCorners(OverlappingCorners, MD, 0.00002f);
+	const std::chrono::duration<double, std::milli> Elapsed = std::chrono::high_resolution_clock::now() - StartTime;
+
+	X_LOG("BenchmarkOverlappingCorners: %d wedges, %d overlaps, %.3f ms\n", MD.VertexInstances().Num(), (int)OverlappingCorners.Indices.size(), Elapsed.count());
+}
+
+void BenchmarkVertexCache(int NumTriangles)
+{
+	// latitude-longitude sphere, two triangles per quad
+	const int NumRings = std::max(FMath::FloorToInt(FMath::Sqrt(NumTriangles / 4.f)), 2);
+	const int NumSegments = NumRings * 2;
+	std::vector<FVector> Positions;
+	for (int Ring = 0; Ring <= NumRings; ++Ring)
+	{
+		const float Theta = PI * Ring / NumRings;
+		for (int Segment = 0; Segment <= NumSegments; ++Segment)
+		{
+			const float Phi = 2.f * PI * Segment / NumSegments;
+			Positions.push_back(FVector(FMath::Sin(Theta) * FMath::Cos(Phi), FMath::Sin(Theta) * FMath::Sin(Phi), FMath::Cos(Theta)) * 100.f);
+		}
+	}
+	std::vector<std::array<uint32, 3>> Triangles;
+	for (int Ring = 0; Ring < NumRings; ++Ring)
+	{
+		for (int Segment = 0; Segment < NumSegments; ++Segment)
+		{
+			const uint32 V00 = Ring * (NumSegments + 1) + Segment;
+			const uint32 V01 = V00 + 1;
+			const uint32 V10 = V00 + NumSegments + 1;
+			const uint32 V11 = V10 + 1;
+			Triangles.push_back({ { V00, V01, V11 } });
+			Triangles.push_back({ { V00, V11, V10 } });
+		}
+	}
+	// an unordered import, the worst case for the cache
+	std::mt19937 Random(1234);
+	std::shuffle(Triangles.begin(), Triangles.end(), Random);
+	std::vector<uint32> Indices;
+	for (const std::array<uint32, 3>& Triangle : Triangles)
+	{
+		Indices.insert(Indices.end(), Triangle.begin(), Triangle.end());
+	}
+	const uint32 NumVertices = (uint32)Positions.size();
+
+	auto LogStep = [&](const char* Step, double Milliseconds)
+	{
+		const FVertexCacheStatistics Statistics = MeshOptimization::AnalyzeVertexCache(Indices.data(), (uint32)Indices.size(), NumVertices);
+		X_LOG("BenchmarkVertexCache: %-10s ACMR %.3f ATVR %.3f %.3f ms\n", Step, Statistics.GetACMR(), Statistics.GetATVR(), Milliseconds);
+	};
+	X_LOG("BenchmarkVertexCache: %d triangles, %u vertices, FIFO cache of %u\n", (int)Triangles.size(), NumVertices, MeshOptimization::SimulatedCacheSize);
+	LogStep("shuffled", 0.0);
+
+	auto StartTime = std::chrono::high_resolution_clock::now();
+	MeshOptimization::OptimizeVertexCache(Indices.data(), (uint32)Indices.size(), NumVertices);
+	std::chrono::duration<double, std::milli> Elapsed = std::chrono::high_resolution_clock::now() - StartTime;
+	LogStep("cache", Elapsed.count());
+
+	StartTime = std::chrono::high_resolution_clock::now();
+	MeshOptimization::OptimizeOverdraw(Indices.data(), (uint32)Indices.size(), Positions.data(), NumVertices);
+	Elapsed = std::chrono::high_resolution_clock::now() - StartTime;
+	LogStep("overdraw", Elapsed.count());
+
+	StartTime = std::chrono::high_resolution_clock::now();
+	std::vector<int32> Remap;
+	const uint32 NumNewVertices = MeshOptimization::OptimizeVertexFetchRemap(Indices.data(), (uint32)Indices.size(), NumVertices, Remap);
+	MeshOptimization::RemapVertexStream(Positions, 1, Remap, NumNewVertices);
+	Elapsed = std::chrono::high_resolution_clock::now() - StartTime;
+	LogStep("fetch", Elapsed.count());
+}
+
+/** The attributes an imported static mesh description has, for the benchmarks that build meshes by hand */
+static void RegisterBenchmarkMeshAttributes(MeshDescription& MD)
+{
+	MD.VertexAttributes().RegisterAttribute<FVector>(MeshAttribute::Vertex::Position, 1, FVector());
+	MD.VertexInstanceAttributes().RegisterAttribute<Vector2>(MeshAttribute::VertexInstance::TextureCoordinate, 2, Vector2());
+	MD.VertexInstanceAttributes().RegisterAttribute<FVector>(MeshAttribute::VertexInstance::Normal, 1, FVector());
+	MD.VertexInstanceAttributes().RegisterAttribute<FVector>(MeshAttribute::VertexInstance::Tangent, 1, FVector());
+	MD.VertexInstanceAttributes().RegisterAttribute<float>(MeshAttribute::VertexInstance::BinormalSign, 1, 0.0f);
+	MD.VertexInstanceAttributes().RegisterAttribute<Vector4>(MeshAttribute::VertexInstance::Color, 1, Vector4(1.0f));
+	MD.PolygonGroupAttributes().RegisterAttribute<std::string>(MeshAttribute::PolygonGroup::ImportedMaterialSlotName, 1, std::string());
+}
+
+void BenchmarkMeshReduction(int NumTriangles)
+{
+	// latitude-longitude sphere, an even number of rings so the material boundary runs along the equator
+	const int NumRings = std::max(FMath::FloorToInt(FMath::Sqrt(NumTriangles / 16.f)), 1) * 2;
+	const int NumSegments = NumRings * 2;
+	const float Radius = 100.f;
+
+	MeshDescription MD;
+	RegisterBenchmarkMeshAttributes(MD);
+	TMeshAttributesRef<FVector> VertexPositions = MD.VertexAttributes().GetAttributesRef<FVector>(MeshAttribute::Vertex::Position);
+	TMeshAttributesRef<Vector2> UVs = MD.VertexInstanceAttributes().GetAttributesRef<Vector2>(MeshAttribute::VertexInstance::TextureCoordinate);
+	TMeshAttributesRef<FVector> Normals = MD.VertexInstanceAttributes().GetAttributesRef<FVector>(MeshAttribute::VertexInstance::Normal);
+	const int PolygonGroups[2] = { MD.CreatePolygonGroup(), MD.CreatePolygonGroup() };
+
+	// the poles are one vertex each, the seam column shares the vertices of the first column but not their UVs
+	std::vector<int> GridVertexIDs((NumRings + 1) * (NumSegments + 1));
+	for (int Ring = 0; Ring <= NumRings; ++Ring)
+	{
+		const float Theta = PI * Ring / NumRings;
+		for (int Segment = 0; Segment <= NumSegments; ++Segment)
+		{
+			int& VertexID = GridVertexIDs[Ring * (NumSegments + 1) + Segment];
+			if (Segment == NumSegments || ((Ring == 0 || Ring == NumRings) && Segment > 0))
+			{
+				VertexID = GridVertexIDs[Ring * (NumSegments + 1)];
+				continue;
+			}
+			const float Phi = 2.f * PI * Segment / NumSegments;
+			VertexID = MD.CreateVertex();
+			VertexPositions[VertexID] = FVector(FMath::Sin(Theta) * FMath::Cos(Phi), FMath::Sin(Theta) * FMath::Sin(Phi), FMath::Cos(Theta)) * Radius;
+		}
+	}
+	auto CreateCorner = [&](int Ring, int Segment)
+	{
+		const int VertexID = GridVertexIDs[Ring * (NumSegments + 1) + Segment];
+		const int VertexInstanceID = MD.CreateVertexInstance(VertexID);
+		UVs.Set(VertexInstanceID, 0, Vector2((float)Segment / NumSegments, (float)Ring / NumRings));
+		UVs.Set(VertexInstanceID, 1, Vector2(0.5f, 0.5f));
+		Normals[VertexInstanceID] = VertexPositions[VertexID].GetSafeNormal();
+		return VertexInstanceID;
+	};
+	auto CreateTriangle = [&](int PolygonGroupID, int VertexInstanceID0, int VertexInstanceID1, int VertexInstanceID2)
+	{
+		const int VertexInstanceIDs[3] = { VertexInstanceID0, VertexInstanceID1, VertexInstanceID2 };
+		int VertexIDs[3];
+		for (int Corner = 0; Corner < 3; ++Corner)
+		{
+			VertexIDs[Corner] = MD.GetVertexInstanceVertex(VertexInstanceIDs[Corner]);
+		}
+		std::vector<MeshDescription::ContourPoint> Contour(3);
+		for (int Corner = 0; Corner < 3; ++Corner)
+		{
+			int EdgeID = MD.GetVertexPairEdge(VertexIDs[Corner], VertexIDs[(Corner + 1) % 3]);
+			if (EdgeID == -1)
+			{
+				EdgeID = MD.CreateEdge(VertexIDs[Corner], VertexIDs[(Corner + 1) % 3]);
+			}
+			Contour[Corner].VertexInstanceID = VertexInstanceIDs[Corner];
+			Contour[Corner].EdgeID = EdgeID;
+		}
+		MD.CreatePolygon(PolygonGroupID, Contour);
+	};
+	for (int Ring = 0; Ring < NumRings; ++Ring)
+	{
+		const int PolygonGroupID = PolygonGroups[Ring < NumRings / 2 ? 0 : 1];
+		for (int Segment = 0; Segment < NumSegments; ++Segment)
+		{
+			// the quads at the poles lose their degenerate half
+			if (Ring > 0)
+			{
+				CreateTriangle(PolygonGroupID, CreateCorner(Ring, Segment), CreateCorner(Ring + 1, Segment + 1), CreateCorner(Ring, Segment + 1));
+			}
+			if (Ring < NumRings - 1)
+			{
+				CreateTriangle(PolygonGroupID, CreateCorner(Ring, Segment), CreateCorner(Ring + 1, Segment), CreateCorner(Ring + 1, Segment + 1));
+			}
+		}
+	}
+	MeshDescriptionOperations::ComputePolygonTriangulations(MD);
+
+	X_LOG("BenchmarkMeshReduction: %d rings, %d segments, %d triangles\n", NumRings, NumSegments, MD.Polygons().Num());
+	for (const float PercentTriangles : GStaticMeshLODPercentTriangles)
+	{
+		FMeshReductionSettings Settings;
+		Settings.PercentTriangles = PercentTriangles;
+		MeshDescription ReducedMD;
+		FMeshReductionStatistics Statistics;
+		const auto StartTime = std::chrono::high_resolution_clock::now();
+		MeshReduction::ReduceMeshDescription(ReducedMD, Statistics, MD, Settings);
+		const std::chrono::duration<double, std::milli> Elapsed = std::chrono::high_resolution_clock::now() - StartTime;
+
+		// The distance to the sphere of the centroid and edge midpoints of every triangle left. Every vertex is a source vertex
+		// and the source triangles deviate from the sphere by far less, so this is about the error the reduction added.
+		TMeshAttributesConstRef<FVector> ReducedPositions = ReducedMD.VertexAttributes().GetAttributesRef<FVector>(MeshAttribute::Vertex::Position);
+		TMeshAttributesConstRef<Vector2> ReducedUVs = ReducedMD.VertexInstanceAttributes().GetAttributesRef<Vector2>(MeshAttribute::VertexInstance::TextureCoordinate);
+		float MaxDeviation = 0.f;
+		double SumDeviation = 0.0;
+		int NumSamples = 0;
+		int NumSeamTriangles = 0;
+		int NumWrongMaterialCorners = 0;
+		for (const int PolygonID : ReducedMD.Polygons().GetElementIDs())
+		{
+			const bool bUpperHemisphere = ReducedMD.GetPolygonPolygonGroup(PolygonID) == PolygonGroups[0];
+			for (const MeshTriangle& Triangle : ReducedMD.GetPolygonTriangles(PolygonID))
+			{
+				FVector Corners[3];
+				float MinU = FLT_MAX;
+				float MaxU = -FLT_MAX;
+				for (int Corner = 0; Corner < 3; ++Corner)
+				{
+					const int VertexInstanceID = Triangle.GetVertexInstanceID(Corner);
+					Corners[Corner] = ReducedPositions[ReducedMD.GetVertexInstanceVertex(VertexInstanceID)];
+					MinU = FMath::Min(MinU, ReducedUVs.Get(VertexInstanceID, 0).X);
+					MaxU = FMath::Max(MaxU, ReducedUVs.Get(VertexInstanceID, 0).X);
+					NumWrongMaterialCorners += (bUpperHemisphere ? Corners[Corner].Z < -KINDA_SMALL_NUMBER : Corners[Corner].Z > KINDA_SMALL_NUMBER) ? 1 : 0;
+				}
+				NumSeamTriangles += MaxU - MinU > 0.5f ? 1 : 0;
+				const FVector Samples[4] = { (Corners[0] + Corners[1] + Corners[2]) / 3.f, (Corners[0] + Corners[1]) * 0.5f, (Corners[1] + Corners[2]) * 0.5f, (Corners[2] + Corners[0]) * 0.5f };
+				for (const FVector& Sample : Samples)
+				{
+					const float Deviation = Radius - Sample.Size();
+					MaxDeviation = FMath::Max(MaxDeviation, Deviation);
+					SumDeviation += Deviation;
+					NumSamples++;
+				}
+			}
+		}
+
+		X_LOG("BenchmarkMeshReduction: %5.1f%% %6u triangles %6u vertices, deviation reported %.4f measured max %.4f mean %.4f, seam triangles %d, wrong material corners %d, %.3f ms\n",
+			PercentTriangles * 100.f, Statistics.NumTriangles, Statistics.NumVertices, Statistics.MaxDeviation, MaxDeviation, NumSamples ? SumDeviation / NumSamples : 0.0,
+			NumSeamTriangles, NumWrongMaterialCorners, Elapsed.count());
+	}
+}
+
+void BenchmarkLightmapUVPacking(int NumCharts)
+{
+	// every chart a single right triangle of random size and UV orientation, so its raster fills about half its rect
+	MeshDescription MD;
+	RegisterBenchmarkMeshAttributes(MD);
+	TMeshAttributesRef<FVector> VertexPositions = MD.VertexAttributes().GetAttributesRef<FVector>(MeshAttribute::Vertex::Position);
+	TMeshAttributesRef<Vector2> UVs = MD.VertexInstanceAttributes().GetAttributesRef<Vector2>(MeshAttribute::VertexInstance::TextureCoordinate);
+	TMeshAttributesRef<FVector> Normals = MD.VertexInstanceAttributes().GetAttributesRef<FVector>(MeshAttribute::VertexInstance::Normal);
+	const int PolygonGroupID = MD.CreatePolygonGroup();
+	std::mt19937 Random(1234);
+	std::uniform_real_distribution<float> Unit(0.f, 1.f);
+	for (int Chart = 0; Chart < NumCharts; ++Chart)
+	{
+		const float Size = 1.f + 15.f * Unit(Random) * Unit(Random);
+		const float Angle = 2.f * PI * Unit(Random);
+		const FVector Origin(Chart * 32.f, 0.f, 0.f);
+		const Vector2 Corners[3] = { Vector2(0.f, 0.f), Vector2(Size, 0.f), Vector2(0.f, Size) };
+		std::vector<MeshDescription::ContourPoint> Contour(3);
+		int VertexIDs[3];
+		for (int Corner = 0; Corner < 3; ++Corner)
+		{
+			VertexIDs[Corner] = MD.CreateVertex();
+			VertexPositions[VertexIDs[Corner]] = Origin + FVector(Corners[Corner].X, Corners[Corner].Y, 0.f);
+			Contour[Corner].VertexInstanceID = MD.CreateVertexInstance(VertexIDs[Corner]);
+			const Vector2 UV(Corners[Corner].X * FMath::Cos(Angle) - Corners[Corner].Y * FMath::Sin(Angle), Corners[Corner].X * FMath::Sin(Angle) + Corners[Corner].Y * FMath::Cos(Angle));
+			UVs.Set(Contour[Corner].VertexInstanceID, 0, UV * 0.1f);
+			Normals[Contour[Corner].VertexInstanceID] = FVector(0.f, 0.f, 1.f);
+		}
+		for (int Corner = 0; Corner < 3; ++Corner)
+		{
+			Contour[Corner].EdgeID = MD.CreateEdge(VertexIDs[Corner], VertexIDs[(Corner + 1) % 3]);
+		}
+		MD.CreatePolygon(PolygonGroupID, Contour);
+	}
+	MeshDescriptionOperations::ComputePolygonTriangulations(MD);
+	FOverlappingCornerAdjacency OverlappingCorners;
+	MeshDescriptionOperations::FindOverlappingCorners(OverlappingCorners, MD, THRESH_POINTS_ARE_SAME);
+
+	// about 16x16 texels a chart
+	int Resolution = 64;
+	while (Resolution < 2048 && Resolution * Resolution < NumCharts * 256)
+	{
+		Resolution *= 2;
+	}
+
+	X_LOG("BenchmarkLightmapUVPacking: %d charts into %dx%d\n", NumCharts, Resolution, Resolution);
+	const bool bFastLightmapUVPacking = GFastLightmapUVPacking;
+	for (const bool bFast : { false, true })
+	{
+		GFastLightmapUVPacking = bFast;
+		MeshDescription PackedMD = MD;
+		const MeshDescriptionOperations::FLightmapUVPackingStatistics Statistics = MeshDescriptionOperations::CreateLightMapUVLayout(PackedMD, 0, 1, Resolution,
+			MeshDescriptionOperations::ELightmapUVVersion::Latest, OverlappingCorners);
+		X_LOG("BenchmarkLightmapUVPacking: %-6s %s, %u rect and %u raster packings, %.4f texels per UV, %.1f%% texels used, %.3f ms\n",
+			bFast ? "fast" : "linear", Statistics.bSuccess ? "packed" : "failed", Statistics.NumRectPackings, Statistics.NumRasterPackings,
+			Statistics.UVScale, Statistics.TexelUtilization * 100.f, Statistics.PackingMilliseconds);
+	}
+	GFastLightmapUVPacking = bFastLightmapUVPacking;
+}
+
+/** Stand-in for FPrimitiveSceneInfoCompact in BenchmarkPrimitiveOctree, the ids live in an array next to the octree */
+struct FBenchmarkOctreePrimitive
+{
+	FBoxSphereBounds Bounds;
+	int32 Index;
+	FOctreeElementId* Ids;
+};
+
+struct FBenchmarkOctreeSemantics
+{
+	enum { MaxElementsPerLeaf = FPrimitiveOctreeSemantics::MaxElementsPerLeaf };
+	enum { MinInclusiveElementsPerNode = FPrimitiveOctreeSemantics::MinInclusiveElementsPerNode };
+	enum { MaxNodeDepth = FPrimitiveOctreeSemantics::MaxNodeDepth };
+
+	static const FBoxSphereBounds& GetBounds(const FBenchmarkOctreePrimitive& Element)
+	{
+		return Element.Bounds;
+	}
+
+	static void SetElementId(const FBenchmarkOctreePrimitive& Element, FOctreeElementId Id)
+	{
+		Element.Ids[Element.Index] = Id;
+	}
+};
+
+void BenchmarkPrimitiveOctree(int MaxPrimitives)
+{
+	typedef TOctree<FBenchmarkOctreePrimitive, FBenchmarkOctreeSemantics> FBenchmarkOctree;
+	typedef std::chrono::duration<double, std::milli> FMilliseconds;
+	const int NumQueries = 1000;
+	// queries also answered by walking all primitives, to check the results and for comparison
+	const int NumLinearQueries = 32;
+
+	std::vector<int> Sizes;
+	for (int NumPrimitives = 10000; NumPrimitives < MaxPrimitives; NumPrimitives *= 10)
+	{
+		Sizes.push_back(NumPrimitives);
+	}
+	Sizes.push_back(MaxPrimitives);
+
+	for (const int NumPrimitives : Sizes)
+	{
+		// about one primitive per 10m cube, most of them props, a few of them buildings
+		std::mt19937 Random(1234);
+		std::uniform_real_distribution<float> Unit(0.f, 1.f);
+		const float WorldExtent = 500.f * FMath::Pow((float)NumPrimitives, 1.f / 3.f);
+		auto RandomPosition = [&]()
+		{
+			return FVector(Unit(Random) * 2.f - 1.f, Unit(Random) * 2.f - 1.f, Unit(Random) * 2.f - 1.f) * WorldExtent;
+		};
+		auto RandomBounds = [&](const FVector& Origin)
+		{
+			const float Radius = Unit(Random) < 0.01f ? 2000.f + 8000.f * Unit(Random) : 10.f * FMath::Pow(20.f, Unit(Random));
+			const FVector Extent = FVector(0.3f + 0.7f * Unit(Random), 0.3f + 0.7f * Unit(Random), 0.3f + 0.7f * Unit(Random)) * Radius;
+			return FBoxSphereBounds(Origin, Extent, Extent.Size());
+		};
+
+		std::vector<FOctreeElementId> Ids(NumPrimitives);
+		std::vector<FBenchmarkOctreePrimitive> Primitives(NumPrimitives);
+		for (int Index = 0; Index < NumPrimitives; ++Index)
+		{
+			Primitives[Index].Bounds = RandomBounds(RandomPosition());
+			Primitives[Index].Index = Index;
+			Primitives[Index].Ids = Ids.data();
+		}
+
+		FBenchmarkOctree Octree(FVector::ZeroVector, HALF_WORLD_MAX);
+		auto StartTime = std::chrono::high_resolution_clock::now();
+		for (const FBenchmarkOctreePrimitive& Primitive : Primitives)
+		{
+			Octree.AddElement(Primitive);
+		}
+		const double AddMilliseconds = FMilliseconds(std::chrono::high_resolution_clock::now() - StartTime).count();
+
+		// every primitive has to be found through its id, with its current bounds
+		auto CheckIds = [&]()
+		{
+			bool bValid = Octree.GetNumElements() == NumPrimitives;
+			for (int Index = 0; Index < NumPrimitives && bValid; ++Index)
+			{
+				const FBenchmarkOctreePrimitive& Element = Octree.GetElementById(Ids[Index]);
+				bValid = Element.Index == Index && Element.Bounds == Primitives[Index].Bounds;
+			}
+			return bValid;
+		};
+		bool bValid = CheckIds();
+
+		// 10% of the primitives move every frame, for 10 frames
+		const int NumMoves = FMath::Max(NumPrimitives / 10, 1);
+		StartTime = std::chrono::high_resolution_clock::now();
+		for (int Frame = 0; Frame < 10; ++Frame)
+		{
+			for (int Move = 0; Move < NumMoves; ++Move)
+			{
+				const int Index = Random() % NumPrimitives;
+				Octree.RemoveElement(Ids[Index]);
+				FBoxSphereBounds& Bounds = Primitives[Index].Bounds;
+				Bounds.Origin += FVector(Unit(Random) * 2.f - 1.f, Unit(Random) * 2.f - 1.f, Unit(Random) * 2.f - 1.f) * 200.f;
+				Octree.AddElement(Primitives[Index]);
+			}
+		}
+		const double MoveMilliseconds = FMilliseconds(std::chrono::high_resolution_clock::now() - StartTime).count();
+		bValid &= CheckIds();
+
+		// half the primitives go and come back somewhere else
+		std::vector<int> Order(NumPrimitives);
+		for (int Index = 0; Index < NumPrimitives; ++Index)
+		{
+			Order[Index] = Index;
+		}
+		std::shuffle(Order.begin(), Order.end(), Random);
+		Order.resize(NumPrimitives / 2);
+		StartTime = std::chrono::high_resolution_clock::now();
+		for (const int Index : Order)
+		{
+			Octree.RemoveElement(Ids[Index]);
+		}
+		const double RemoveMilliseconds = FMilliseconds(std::chrono::high_resolution_clock::now() - StartTime).count();
+		bValid &= Octree.GetNumElements() == NumPrimitives - (int)Order.size();
+		for (const int Index : Order)
+		{
+			Primitives[Index].Bounds = RandomBounds(RandomPosition());
+			Octree.AddElement(Primitives[Index]);
+		}
+		bValid &= CheckIds();
+
+		// a room, a neighbourhood and a view
+		double QueryMilliseconds[3] = { 0.0, 0.0, 0.0 };
+		double LinearMilliseconds[3] = { 0.0, 0.0, 0.0 };
+		int64 NumFound[3] = { 0, 0, 0 };
+		for (int Query = 0; Query < NumQueries; ++Query)
+		{
+			const FVector Center = RandomPosition();
+			const FBox Box = FBox(Center, Center).ExpandBy(500.f + 1500.f * Unit(Random));
+			const float SphereRadius = 2000.f + 3000.f * Unit(Random);
+			FConvexVolume Frustum;
+			GetViewFrustumBounds(Frustum, FLookAtMatrix(Center, Center + RandomPosition(), FVector(0.f, 0.f, 1.f)) * FPerspectiveMatrix(PI / 4.f, 16.f, 9.f, 10.f, 20000.f), true);
+
+			const FVector BoxCenter = Box.GetCenter();
+			const FVector BoxExtent = Box.GetExtent();
+			auto BoxTest = [&](const FBoxSphereBounds& Bounds)
+			{
+				return FMath::Abs(Bounds.Origin.X - BoxCenter.X) <= Bounds.BoxExtent.X + BoxExtent.X
+					&& FMath::Abs(Bounds.Origin.Y - BoxCenter.Y) <= Bounds.BoxExtent.Y + BoxExtent.Y
+					&& FMath::Abs(Bounds.Origin.Z - BoxCenter.Z) <= Bounds.BoxExtent.Z + BoxExtent.Z;
+			};
+			auto SphereTest = [&](const FBoxSphereBounds& Bounds)
+			{
+				return ComputeSquaredDistanceFromBoxToPoint(Bounds.Origin - Bounds.BoxExtent, Bounds.Origin + Bounds.BoxExtent, Center) <= FMath::Square(SphereRadius);
+			};
+			auto FrustumTest = [&](const FBoxSphereBounds& Bounds)
+			{
+				return Frustum.IntersectBox(Bounds.Origin, Bounds.BoxExtent);
+			};
+
+			int Found[3] = { 0, 0, 0 };
+			auto Count = [&](int QueryType)
+			{
+				return [&Found, QueryType](const FBenchmarkOctreePrimitive&) { Found[QueryType]++; };
+			};
+			StartTime = std::chrono::high_resolution_clock::now();
+			Octree.FindElementsWithBoundsTest(Box, Count(0));
+			auto EndTime = std::chrono::high_resolution_clock::now();
+			QueryMilliseconds[0] += FMilliseconds(EndTime - StartTime).count();
+			Octree.FindElementsInSphere(Center, SphereRadius, Count(1));
+			StartTime = std::chrono::high_resolution_clock::now();
+			QueryMilliseconds[1] += FMilliseconds(StartTime - EndTime).count();
+			Octree.FindElementsInConvexVolume(Frustum, Count(2));
+			QueryMilliseconds[2] += FMilliseconds(std::chrono::high_resolution_clock::now() - StartTime).count();
+			for (int QueryType = 0; QueryType < 3; ++QueryType)
+			{
+				NumFound[QueryType] += Found[QueryType];
+			}
+
+			if (Query < NumLinearQueries)
+			{
+				int LinearFound[3] = { 0, 0, 0 };
+				StartTime = std::chrono::high_resolution_clock::now();
+				for (const FBenchmarkOctreePrimitive& Primitive : Primitives)
+				{
+					LinearFound[0] += BoxTest(Primitive.Bounds) ? 1 : 0;
+				}
+				EndTime = std::chrono::high_resolution_clock::now();
+				LinearMilliseconds[0] += FMilliseconds(EndTime - StartTime).count();
+				for (const FBenchmarkOctreePrimitive& Primitive : Primitives)
+				{
+					LinearFound[1] += SphereTest(Primitive.Bounds) ? 1 : 0;
+				}
+				StartTime = std::chrono::high_resolution_clock::now();
+				LinearMilliseconds[1] += FMilliseconds(StartTime - EndTime).count();
+				for (const FBenchmarkOctreePrimitive& Primitive : Primitives)
+				{
+					LinearFound[2] += FrustumTest(Primitive.Bounds) ? 1 : 0;
+				}
+				LinearMilliseconds[2] += FMilliseconds(std::chrono::high_resolution_clock::now() - StartTime).count();
+				for (int QueryType = 0; QueryType < 3; ++QueryType)
+				{
+					bValid &= LinearFound[QueryType] == Found[QueryType];
+				}
+			}
+		}
+
+		X_LOG("BenchmarkPrimitiveOctree: %d primitives, results %s\n", NumPrimitives, bValid ? "match" : "MISMATCH");
+		X_LOG("  add %.3f us, move %.3f us, remove %.3f us per primitive\n",
+			AddMilliseconds * 1000.0 / NumPrimitives, MoveMilliseconds * 1000.0 / (NumMoves * 10), RemoveMilliseconds * 1000.0 / FMath::Max((int)Order.size(), 1));
+		const char* QueryNames[3] = { "box", "sphere", "frustum" };
+		for (int QueryType = 0; QueryType < 3; ++QueryType)
+		{
+			const double Milliseconds = QueryMilliseconds[QueryType] / NumQueries;
+			const double LinearQueryMilliseconds = LinearMilliseconds[QueryType] / NumLinearQueries;
+			X_LOG("  %-7s %.4f ms per query, %.0f found, linear %.4f ms (%.1fx)\n", QueryNames[QueryType],
+				Milliseconds, (double)NumFound[QueryType] / NumQueries, LinearQueryMilliseconds, LinearQueryMilliseconds / FMath::Max(Milliseconds, 1e-6));
+		}
+	}
+}
+
+void BenchmarkLightInteractions(UWorld& World, int NumPrimitives, int NumFrames)
+{
+	// a field of spheres 200 apart, one point light for every ten of them circling above it
+	const int NumLights = FMath::Max(NumPrimitives / 10, 1);
+	const int GridSize = FMath::CeilToInt(FMath::Sqrt((float)NumPrimitives));
+	const int LightGridSize = FMath::CeilToInt(FMath::Sqrt((float)NumLights));
+	const float FieldSize = 200.f * GridSize;
+	auto SpherePosition = [&](int Index, int Frame)
+	{
+		// every tenth sphere bobs up and down
+		const float Height = Index % 10 == 0 ? 300.f * FMath::Sin(0.2f * Frame + Index) : 0.f;
+		return FVector(200.f * (Index % GridSize), 200.f * (Index / GridSize), 100.f + Height);
+	};
+	auto LightPosition = [&](int Index, int Frame)
+	{
+		const float Angle = 0.1f * Frame + Index;
+		const FVector Center(FieldSize * (Index % LightGridSize + 0.5f) / LightGridSize, FieldSize * (Index / LightGridSize + 0.5f) / LightGridSize, 400.f);
+		return Center + FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.f) * 600.f;
+	};
+
+	std::vector<AActor*> Spheres(NumPrimitives);
+	for (int Index = 0; Index < NumPrimitives; ++Index)
+	{
+		Spheres[Index] = World.SpawnActor<MovableSphereActor>("Primitives/Sphere.fbx");
+		Spheres[Index]->SetActorLocation(SpherePosition(Index, 0));
+	}
+	std::vector<AActor*> Lights(NumLights);
+	for (int Index = 0; Index < NumLights; ++Index)
+	{
+		Lights[Index] = World.SpawnActor<PointLightActor>();
+		Lights[Index]->SetActorLocation(LightPosition(Index, 0));
+	}
+
+	// every light-primitive pair with an interaction, to check both modes end up with the same ones
+	auto GatherInteractions = [&World]()
+	{
+		std::vector<std::pair<const FLightSceneInfo*, const FPrimitiveSceneInfo*>> Pairs;
+		for (const FPrimitiveSceneInfo* PrimitiveSceneInfo : World.Scene->Primitives)
+		{
+			for (const FLightPrimitiveInteraction* Interaction = PrimitiveSceneInfo->LightList; Interaction; Interaction = Interaction->GetNextLight())
+			{
+				Pairs.push_back(std::make_pair(Interaction->GetLight(), PrimitiveSceneInfo));
+			}
+		}
+		std::sort(Pairs.begin(), Pairs.end());
+		return Pairs;
+	};
+
+	const bool bOldSpatial = GSpatialLightInteractions;
+	std::vector<std::pair<const FLightSceneInfo*, const FPrimitiveSceneInfo*>> Interactions[2];
+	for (int Pass = 0; Pass < 2; ++Pass)
+	{
+		GSpatialLightInteractions = (Pass == 1);
+		World.Scene->IncrementFrameNumber();
+
+		uint64 NumCandidatesTested = 0;
+		uint64 NumCreated = 0;
+		uint64 NumDestroyed = 0;
+		const auto StartTime = std::chrono::high_resolution_clock::now();
+		for (int Frame = 1; Frame <= NumFrames; ++Frame)
+		{
+			for (int Index = 0; Index < NumLights; ++Index)
+			{
+				Lights[Index]->SetActorLocation(LightPosition(Index, Frame));
+			}
+			for (int Index = 0; Index < NumPrimitives; Index += 10)
+			{
+				Spheres[Index]->SetActorLocation(SpherePosition(Index, Frame));
+			}
+
+			World.Scene->IncrementFrameNumber();
+			NumCandidatesTested += World.Scene->LastFrameLightInteractionStats.NumCandidatesTested;
+			NumCreated += World.Scene->LastFrameLightInteractionStats.NumCreated;
+			NumDestroyed += World.Scene->LastFrameLightInteractionStats.NumDestroyed;
+		}
+		const std::chrono::duration<double, std::milli> Elapsed = std::chrono::high_resolution_clock::now() - StartTime;
+		Interactions[Pass] = GatherInteractions();
+
+		// both passes play the same frames, so they end where the other one starts
+		for (int Index = 0; Index < NumLights; ++Index)
+		{
+			Lights[Index]->SetActorLocation(LightPosition(Index, 0));
+		}
+		for (int Index = 0; Index < NumPrimitives; Index += 10)
+		{
+			Spheres[Index]->SetActorLocation(SpherePosition(Index, 0));
+		}
+
+		const int Frames = FMath::Max(NumFrames, 1);
+		X_LOG("BenchmarkLightInteractions: %s, %d primitives, %d lights, %.3f ms/frame\n", Pass == 0 ? "brute force" : "spatial", NumPrimitives, NumLights, Elapsed.count() / Frames);
+		X_LOG("  per frame %llu candidates tested, %llu interactions created, %llu destroyed, %d interactions at the end\n",
+			NumCandidatesTested / Frames, NumCreated / Frames, NumDestroyed / Frames, (int)Interactions[Pass].size());
+	}
+	GSpatialLightInteractions = bOldSpatial;
+
+	X_LOG("BenchmarkLightInteractions: interactions %s\n", Interactions[0] == Interactions[1] ? "match" : "MISMATCH");
+}
+
+void BenchmarkFrustumCull(int NumPrimitives)
+{
+	typedef std::chrono::duration<double, std::milli> FMilliseconds;
+	const int NumViews = 64;
+
+	// the primitive distribution of BenchmarkPrimitiveOctree, some of them with draw distances
+	std::mt19937 Random(1234);
+	std::uniform_real_distribution<float> Unit(0.f, 1.f);
+	const float WorldExtent = 500.f * FMath::Pow((float)NumPrimitives, 1.f / 3.f);
+	auto RandomPosition = [&]()
+	{
+		return FVector(Unit(Random) * 2.f - 1.f, Unit(Random) * 2.f - 1.f, Unit(Random) * 2.f - 1.f) * WorldExtent;
+	};
+	std::vector<FPrimitiveBounds> PrimitiveBounds(NumPrimitives);
+	FPrimitiveCullingBounds CullingBounds;
+	for (FPrimitiveBounds& Bounds : PrimitiveBounds)
+	{
+		const float Radius = Unit(Random) < 0.01f ? 2000.f + 8000.f * Unit(Random) : 10.f * FMath::Pow(20.f, Unit(Random));
+		const FVector Extent = FVector(0.3f + 0.7f * Unit(Random), 0.3f + 0.7f * Unit(Random), 0.3f + 0.7f * Unit(Random)) * Radius;
+		Bounds.BoxSphereBounds = FBoxSphereBounds(RandomPosition(), Extent, Extent.Size());
+		Bounds.MinDrawDistanceSq = Unit(Random) < 0.05f ? FMath::Square(1000.f) : 0.f;
+		Bounds.MaxDrawDistance = Unit(Random) < 0.2f ? 5000.f + 20000.f * Unit(Random) : FLT_MAX;
+		Bounds.MaxCullDistance = Bounds.MaxDrawDistance;
+		CullingBounds.Add(Bounds);
+	}
+
+	std::vector<FConvexVolume> Frustums(NumViews);
+	std::vector<FVector> ViewOrigins(NumViews);
+	for (int View = 0; View < NumViews; ++View)
+	{
+		ViewOrigins[View] = RandomPosition();
+		GetViewFrustumBounds(Frustums[View], FLookAtMatrix(ViewOrigins[View], ViewOrigins[View] + RandomPosition(), FVector(0.f, 0.f, 1.f)) * FPerspectiveMatrix(PI / 4.f, 16.f, 9.f, 10.f, 50000.f), true);
+	}
+
+	// the per primitive loop, then four at a time on the calling thread, then four at a time on the workers
+	const char* PassNames[3] = { "scalar", "vectorized", "parallel" };
+	double Milliseconds[3] = { 0.0, 0.0, 0.0 };
+	int64 NumVisible[3] = { 0, 0, 0 };
+	bool bMatch = true;
+	std::vector<FBitArray> ScalarVisibility(NumViews);
+	for (int Pass = 0; Pass < 3; ++Pass)
+	{
+		FBitArray VisibilityMap;
+		for (int View = 0; View < NumViews; ++View)
+		{
+			const auto StartTime = std::chrono::high_resolution_clock::now();
+			if (Pass == 0)
+			{
+				FrustumCullPrimitivesScalar(PrimitiveBounds, Frustums[View], ViewOrigins[View], VisibilityMap);
+			}
+			else
+			{
+				FrustumCullPrimitives(CullingBounds, Frustums[View], ViewOrigins[View], VisibilityMap, Pass == 1);
+			}
+			Milliseconds[Pass] += FMilliseconds(std::chrono::high_resolution_clock::now() - StartTime).count();
+
+			for (FConstSetBitIterator BitIt(VisibilityMap); BitIt; ++BitIt)
+			{
+				++NumVisible[Pass];
+			}
+			if (Pass == 0)
+			{
+				ScalarVisibility[View] = VisibilityMap;
+			}
+			else
+			{
+				bMatch &= VisibilityMap == ScalarVisibility[View] && VisibilityMap.CountSetBits() == ScalarVisibility[View].CountSetBits();
+			}
+		}
+	}
+
+	X_LOG("BenchmarkFrustumCull: %d primitives, %d views, %u hardware threads, results %s\n", NumPrimitives, NumViews, std::thread::hardware_concurrency(), bMatch ? "match" : "MISMATCH");
+	for (int Pass = 0; Pass < 3; ++Pass)
+	{
+		const double MillisecondsPerView = Milliseconds[Pass] / NumViews;
+		X_LOG("  %-10s %.4f ms per view, %.0f primitives culled per ms (%.2fx), %.0f visible\n", PassNames[Pass], MillisecondsPerView,
+			NumPrimitives / FMath::Max(MillisecondsPerView, 1e-6), Milliseconds[0] / FMath::Max(Milliseconds[Pass], 1e-6), (double)NumVisible[Pass] / NumViews);
+	}
+}
+
+void BenchmarkSoftwareOcclusion(int NumPrimitives)
+{
+	typedef std::chrono::duration<double, std::milli> FMilliseconds;
+	const int NumViews = 32;
+	const int MaxVerifiedPerView = 200;
+	const float BlockSize = 4000.f;
+
+	// a city of one building per block, streets between them, and NumPrimitives props scattered over it
+	std::mt19937 Random(1234);
+	std::uniform_real_distribution<float> Unit(0.f, 1.f);
+	const int NumBlocks = FMath::Max(4, (int)FMath::Sqrt((float)NumPrimitives) / 8);
+	std::vector<FBox> Buildings;
+	std::vector<FPrimitiveBounds> PrimitiveBounds;
+	auto AddPrimitive = [&](const FVector& Center, const FVector& Extent)
+	{
+		FPrimitiveBounds Bounds;
+		Bounds.BoxSphereBounds = FBoxSphereBounds(Center, Extent, Extent.Size());
+		Bounds.MinDrawDistanceSq = 0.f;
+		Bounds.MaxDrawDistance = FLT_MAX;
+		Bounds.MaxCullDistance = FLT_MAX;
+		PrimitiveBounds.push_back(Bounds);
+	};
+	for (int BlockY = 0; BlockY < NumBlocks; ++BlockY)
+	{
+		for (int BlockX = 0; BlockX < NumBlocks; ++BlockX)
+		{
+			const FVector Extent = FVector(0.2f + 0.15f * Unit(Random), 0.2f + 0.15f * Unit(Random), 0.25f + 0.75f * Unit(Random)) * BlockSize;
+			const FVector Center((BlockX + 0.5f) * BlockSize, (BlockY + 0.5f) * BlockSize, Extent.Z);
+			Buildings.push_back(FBox(Center - Extent, Center + Extent));
+			AddPrimitive(Center, Extent);
+		}
+	}
+	for (int Prop = 0; Prop < NumPrimitives; ++Prop)
+	{
+		const FVector Extent(20.f + 130.f * Unit(Random), 20.f + 130.f * Unit(Random), 20.f + 130.f * Unit(Random));
+		AddPrimitive(FVector(Unit(Random) * NumBlocks * BlockSize, Unit(Random) * NumBlocks * BlockSize, Extent.Z), Extent);
+	}
+	const int NumAllPrimitives = (int)PrimitiveBounds.size();
+
+	// every building is the unit cube scaled to its box, as LOD 0 of a box static mesh would be
+	std::vector<FVector> CubeVertices;
+	for (int Corner = 0; Corner < 8; ++Corner)
+	{
+		CubeVertices.push_back(FVector((Corner & 1) ? 1.f : -1.f, (Corner & 2) ? 1.f : -1.f, (Corner & 4) ? 1.f : -1.f));
+	}
+	const std::vector<uint32> CubeIndices = { 0, 2, 6, 0, 6, 4, 1, 5, 7, 1, 7, 3, 0, 4, 5, 0, 5, 1, 2, 3, 7, 2, 7, 6, 0, 1, 3, 0, 3, 2, 4, 6, 7, 4, 7, 5 };
+
+	double RasterizeMilliseconds[2] = { 0.0, 0.0 };
+	double CullMilliseconds[2] = { 0.0, 0.0 };
+	int64 NumOccluderTriangles = 0, NumRasterizedTriangles = 0, NumFrustumVisible = 0, NumCulled = 0, NumVerified = 0, NumSeenThrough = 0;
+	bool bDeterministic = true;
+	for (int View = 0; View < NumViews; ++View)
+	{
+		// eye height at a street crossing, looking along the street level
+		const FVector ViewOrigin(FMath::Max(1, (int)(Unit(Random) * NumBlocks)) * BlockSize, FMath::Max(1, (int)(Unit(Random) * NumBlocks)) * BlockSize, 170.f);
+		const float Yaw = Unit(Random) * 2.f * PI;
+		const FMatrix ViewProjectionMatrix = FLookAtMatrix(ViewOrigin, ViewOrigin + FVector(FMath::Cos(Yaw), FMath::Sin(Yaw), 0.f), FVector(0.f, 0.f, 1.f)) * FPerspectiveMatrix(PI / 4.f, 16.f, 9.f, 10.f, 100000.f);
+		FConvexVolume Frustum;
+		GetViewFrustumBounds(Frustum, ViewProjectionMatrix, true);
+
+		FBitArray FrustumVisibility;
+		FrustumCullPrimitivesScalar(PrimitiveBounds, Frustum, ViewOrigin, FrustumVisibility);
+		NumFrustumVisible += FrustumVisibility.CountSetBits();
+
+		FOccluderElementsCollector Collector(ViewProjectionMatrix);
+		FBitArray Occluders(false, NumAllPrimitives);
+		for (int Building = 0; Building < (int)Buildings.size() && Collector.NumTriangles() < GSoftwareOcclusionMaxOccluderTriangles; ++Building)
+		{
+			if (FrustumVisibility[Building])
+			{
+				Collector.AddElements(CubeVertices, CubeIndices, FScaleMatrix(Buildings[Building].GetExtent()) * FTranslationMatrix(Buildings[Building].GetCenter()));
+				Occluders.SetBit(Building, true);
+			}
+		}
+		NumOccluderTriangles += Collector.NumTriangles();
+
+		// the same view on the workers and on the calling thread, which must agree to the bit
+		FSoftwareOcclusionBuffer OcclusionBuffers[2];
+		FBitArray Visibility[2] = { FrustumVisibility, FrustumVisibility };
+		int32 NumCulledInView[2];
+		for (int Pass = 0; Pass < 2; ++Pass)
+		{
+			auto StartTime = std::chrono::high_resolution_clock::now();
+			OcclusionBuffers[Pass].Rasterize(Collector, Pass == 1);
+			RasterizeMilliseconds[Pass] += FMilliseconds(std::chrono::high_resolution_clock::now() - StartTime).count();
+			StartTime = std::chrono::high_resolution_clock::now();
+			NumCulledInView[Pass] = CullOccludedPrimitives(OcclusionBuffers[Pass], PrimitiveBounds, Occluders, Visibility[Pass], Pass == 1);
+			CullMilliseconds[Pass] += FMilliseconds(std::chrono::high_resolution_clock::now() - StartTime).count();
+		}
+		NumRasterizedTriangles += OcclusionBuffers[0].GetNumRasterizedTriangles();
+		NumCulled += NumCulledInView[0];
+		bDeterministic &= Visibility[0] == Visibility[1] && NumCulledInView[0] == NumCulledInView[1];
+		for (int Y = 0; Y < FSoftwareOcclusionBuffer::Height; ++Y)
+		{
+			for (int X = 0; X < FSoftwareOcclusionBuffer::Width; ++X)
+			{
+				bDeterministic &= OcclusionBuffers[0].GetDepth(X, Y) == OcclusionBuffers[1].GetDepth(X, Y);
+			}
+		}
+
+		// a culled primitive with a clear line from the eye to its center or a corner is visible, the conservative buffer never culls one
+		int NumVerifiedInView = 0;
+		for (int PrimitiveIndex = 0; PrimitiveIndex < NumAllPrimitives && NumVerifiedInView < MaxVerifiedPerView; ++PrimitiveIndex)
+		{
+			if (!FrustumVisibility[PrimitiveIndex] || Visibility[0][PrimitiveIndex])
+			{
+				continue;
+			}
+			++NumVerifiedInView;
+			const FBoxSphereBounds& Bounds = PrimitiveBounds[PrimitiveIndex].BoxSphereBounds;
+			bool bSeenThrough = false;
+			for (int Point = 0; Point < 9 && !bSeenThrough; ++Point)
+			{
+				const FVector Target = Point == 8 ? Bounds.Origin : Bounds.Origin + Bounds.BoxExtent * FVector((Point & 1) ? 1.f : -1.f, (Point & 2) ? 1.f : -1.f, (Point & 4) ? 1.f : -1.f);
+				if (!Frustum.IntersectSphere(Target, 0.f))
+				{
+					continue;
+				}
+				bool bBlocked = false;
+				for (int Building = 0; Building < (int)Buildings.size() && !bBlocked; ++Building)
+				{
+					bBlocked = FMath::LineBoxIntersection(Buildings[Building], ViewOrigin, Target, Target - ViewOrigin);
+				}
+				bSeenThrough = !bBlocked;
+			}
+			NumSeenThrough += bSeenThrough ? 1 : 0;
+		}
+		NumVerified += NumVerifiedInView;
+	}
+
+	X_LOG("BenchmarkSoftwareOcclusion: %d buildings, %d props, %d views, %dx%d buffer, %u hardware threads, results %s\n", (int)Buildings.size(), NumPrimitives, NumViews,
+		(int)FSoftwareOcclusionBuffer::Width, (int)FSoftwareOcclusionBuffer::Height, std::thread::hardware_concurrency(), bDeterministic ? "deterministic" : "NOT DETERMINISTIC");
+	X_LOG("  per view: %.0f occluder triangles, %.0f rasterized after clipping, %.0f in frustum, %.0f occluded (%.1f%%)\n", (double)NumOccluderTriangles / NumViews,
+		(double)NumRasterizedTriangles / NumViews, (double)NumFrustumVisible / NumViews, (double)NumCulled / NumViews, NumFrustumVisible ? 100.0 * NumCulled / NumFrustumVisible : 0.0);
+	X_LOG("  rasterize %.4f ms parallel, %.4f ms single thread; occludee tests %.4f ms parallel, %.4f ms single thread\n",
+		RasterizeMilliseconds[0] / NumViews, RasterizeMilliseconds[1] / NumViews, CullMilliseconds[0] / NumViews, CullMilliseconds[1] / NumViews);
+	X_LOG("  %lld of %lld sampled culled primitives have a clear line of sight to a corner or their center\n", (long long)NumSeenThrough, (long long)NumVerified);
+}
+
+void BenchmarkLightGrid(int NumLights)
+{
+	typedef std::chrono::duration<double, std::milli> FMilliseconds;
+	const int NumIterations = 16;
+
+	// looking down +X, so world X is view depth, Y is right and Z up
+	FLightGridView View;
+	View.ViewMatrix = FLookAtMatrix(FVector(0.f, 0.f, 0.f), FVector(1.f, 0.f, 0.f), FVector(0.f, 0.f, 1.f));
+	View.ProjectionMatrix = FPerspectiveMatrix(PI / 4.f, 16.f, 9.f, 10.f, 50000.f);
+	View.ViewSize = FIntPoint(1920, 1080);
+	View.NearClippingDistance = 10.f;
+
+	auto MakeLight = [](const FVector& Position, float Radius, uint8 LightType, const FVector& Direction, float OuterConeAngle)
+	{
+		FForwardLocalLight Light;
+		FLightParameters& Parameters = Light.Parameters;
+		Parameters.LightPositionAndInvRadius = Vector4(Position, 1.f / Radius);
+		Parameters.LightColorAndFalloffExponent = Vector4(1.f, 1.f, 1.f, 0.f);
+		Parameters.NormalizedLightDirection = -Direction;
+		Parameters.NormalizedLightTangent = FVector(0.f, 0.f, 1.f);
+		Parameters.SpotAngles = LightType == LightType_Spot ? Vector2(FMath::Cos(OuterConeAngle), 1.f) : Vector2(-2.f, 1.f);
+		Parameters.SpecularScale = 1.f;
+		Parameters.LightSourceRadius = 0.f;
+		Parameters.LightSoftSourceRadius = 0.f;
+		Parameters.LightSourceLength = 0.f;
+		Parameters.SourceTexture = nullptr;
+		Light.LightType = LightType;
+		return Light;
+	};
+
+	// lights spread through the frustum up to 20000 ahead, a third of them spot lights
+	std::mt19937 Random(1234);
+	std::uniform_real_distribution<float> Unit(0.f, 1.f);
+	std::vector<FForwardLocalLight> Lights;
+	for (int LightIndex = 0; LightIndex < NumLights; ++LightIndex)
+	{
+		const float Depth = 50.f + 20000.f * Unit(Random) * Unit(Random);
+		const FVector Position(Depth, (Unit(Random) * 2.f - 1.f) * Depth, (Unit(Random) * 2.f - 1.f) * Depth * 9.f / 16.f);
+		const float Radius = 100.f + 900.f * Unit(Random);
+		const FVector Direction = FVector(Unit(Random) * 2.f - 1.f, Unit(Random) * 2.f - 1.f, Unit(Random) * 2.f - 1.f).GetSafeNormal();
+		const uint8 LightType = LightIndex % 3 == 2 ? LightType_Spot : LightType_Point;
+		Lights.push_back(MakeLight(Position, Radius, LightType, Direction, PI / 18.f + PI / 3.f * Unit(Random)));
+	}
+
+	// on the workers, then on the calling thread, then every light against every cell
+	const char* PassNames[3] = { "parallel", "single thread", "brute force" };
+	double Milliseconds[3] = { 0.0, 0.0, 0.0 };
+	FForwardLightingViewResources LightGrids[3];
+	for (int Pass = 0; Pass < 3; ++Pass)
+	{
+		const int NumPassIterations = Pass == 2 ? 1 : NumIterations;
+		for (int Iteration = 0; Iteration < NumPassIterations; ++Iteration)
+		{
+			const auto StartTime = std::chrono::high_resolution_clock::now();
+			if (Pass == 2)
+			{
+				ComputeLightGridBruteForce(View, Lights, LightGrids[Pass]);
+			}
+			else
+			{
+				ComputeLightGrid(View, Lights, LightGrids[Pass], Pass == 1);
+			}
+			Milliseconds[Pass] += FMilliseconds(std::chrono::high_resolution_clock::now() - StartTime).count();
+		}
+		Milliseconds[Pass] /= NumPassIterations;
+	}
+	bool bMatch = true;
+	for (int Pass = 1; Pass < 3; ++Pass)
+	{
+		bMatch &= LightGrids[Pass].NumCulledLightsGrid == LightGrids[0].NumCulledLightsGrid && LightGrids[Pass].CulledLightDataGrid == LightGrids[0].CulledLightDataGrid;
+	}
+
+	const FForwardLightingViewResources& LightGrid = LightGrids[0];
+	const int32 NumCells = LightGrid.GetNumCells();
+	int32 NumOccupiedCells = 0;
+	uint32 MaxLightsPerCell = 0;
+	for (int32 CellIndex = 0; CellIndex < NumCells; ++CellIndex)
+	{
+		NumOccupiedCells += LightGrid.GetNumLightsInCell(CellIndex) > 0 ? 1 : 0;
+		MaxLightsPerCell = FMath::Max(MaxLightsPerCell, LightGrid.GetNumLightsInCell(CellIndex));
+	}
+
+	X_LOG("BenchmarkLightGrid: %d lights, %dx%dx%d cells, %u hardware threads, results %s\n", NumLights, LightGrid.CulledGridSize.X, LightGrid.CulledGridSize.Y,
+		LightGrid.CulledGridSize.Z, std::thread::hardware_concurrency(), bMatch ? "match" : "MISMATCH");
+	X_LOG("  %d light indices, %.2f lights per cell, %.2f per occupied cell (%d occupied), %u at most\n", (int)LightGrid.CulledLightDataGrid.size(),
+		(double)LightGrid.CulledLightDataGrid.size() / NumCells, NumOccupiedCells ? (double)LightGrid.CulledLightDataGrid.size() / NumOccupiedCells : 0.0, NumOccupiedCells, MaxLightsPerCell);
+	for (int Pass = 0; Pass < 3; ++Pass)
+	{
+		X_LOG("  %-14s %.4f ms per build (%.2fx)\n", PassNames[Pass], Milliseconds[Pass], Milliseconds[2] / FMath::Max(Milliseconds[Pass], 1e-6));
+	}
+}
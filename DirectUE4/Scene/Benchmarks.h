@@ -0,0 +1,79 @@
+#pragma once
+
+class UWorld;
+
+/**
+* Timing harnesses the command line switches of main.cpp run instead of the demo, each logs its results and returns.
+* The first ones create render resources and run once the device and the world are up, the ones taking a world spawn
+* actors into it and tick it. The others only need the CPU and run before any window, device or world exists.
+*/
+
+/**
+* Spawns NumMannequins animated mannequins into World and ticks it NumFrames times without drawing, once with serial and
+* once with parallel animation evaluation, logging the average animation cost per frame of both.
+*/
+void BenchmarkAnimationEvaluation(UWorld& World, int NumMannequins, int NumFrames);
+/**
+* Spawns NumMannequins mannequins playing the baked walk (baking it first if there is no blob yet) into World and ticks
+* it NumFrames times without drawing, logging the playback cost per frame.
+*/
+void BenchmarkBakedAnimation(UWorld& World, int NumMannequins, int NumFrames);
+/**
+* Imports the mannequin walk into World and decodes all its tracks at NumSamples times with the batched and with the
+* track by track pose decompression, logging both timings and the largest difference between them.
+*/
+void BenchmarkPoseDecompression(UWorld& World, int NumSamples);
+/**
+* Spawns NumPrimitives spheres into World and a point light for every ten of them, then moves every light and a tenth of
+* the spheres for NumFrames frames, first testing every light against every primitive and then through the scene's
+* octrees. Logs the time, the per frame interaction counters of both and whether they end up with the same interactions.
+*/
+void BenchmarkLightInteractions(UWorld& World, int NumPrimitives, int NumFrames);
+/**
+* Loads the world's static meshes NumIterations times with the derived data cache off (a full FBX import and build each
+* time, what every launch used to cost) and then with it on, logging the average load time of both and the cache stats.
+*/
+void BenchmarkStaticMeshDerivedData(int NumIterations);
+
+/**
+* Builds a flat, regularly tessellated plane with about NumWedges vertex instances, the worst case for sorting corners
+* along one axis, and logs how long finding its overlapping corners takes.
+*/
+void BenchmarkOverlappingCorners(int NumWedges);
+/**
+* Builds a sphere of about NumTriangles triangles in shuffled order and runs the static mesh index and vertex buffer
+* optimizations on it, logging the simulated ACMR/ATVR after every step and how long each step takes.
+*/
+void BenchmarkVertexCache(int NumTriangles);
+/**
+* Builds a sphere of about NumTriangles triangles with a UV seam and one material per hemisphere and reduces it to
+* every GStaticMeshLODPercentTriangles, logging triangles, vertices, the reported and the measured deviation from the
+* sphere, triangles across the seam or corners on the wrong hemisphere (both should stay 0) and how long it took.
+*/
+void BenchmarkMeshReduction(int NumTriangles);
+/**
+* Lays out lightmap UVs for NumCharts separate triangles with the linear and then the fast (skyline estimate, parallel
+* probes) scale search and logs packings tried, texel utilization and time of both.
+*/
+void BenchmarkLightmapUVPacking(int NumCharts);
+/**
+* Fills a primitive octree with 10k, 100k, ... up to MaxPrimitives random bounds and logs the cost of adding, moving and
+* removing them and of box, sphere and frustum queries, checking the query results against walking all primitives.
+*/
+void BenchmarkPrimitiveOctree(int MaxPrimitives);
+/**
+* Frustum culls NumPrimitives random bounds for 64 random views one primitive at a time, then four at a time on the
+* calling thread and on the workers, and logs primitives culled per millisecond of each and whether they agree.
+*/
+void BenchmarkFrustumCull(int NumPrimitives);
+/**
+* Rasterizes the buildings of a generated city as occluders for 32 street level views and occlusion culls NumPrimitives
+* props behind them, on the workers and on one thread, and logs the timings, how many props were culled, whether both
+* runs agree exactly and how many culled props a sample of line of sight tests can still see.
+*/
+void BenchmarkSoftwareOcclusion(int NumPrimitives);
+/**
+* Builds the clustered light grid of a 1920x1080 view for NumLights random point and spot lights on the workers, on one
+* thread and by testing every light against every cell, and logs whether the three agree, the lights per cell and the build times.
+*/
+void BenchmarkLightGrid(int NumLights);
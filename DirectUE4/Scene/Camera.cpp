@@ -53,11 +53,7 @@ FSceneView* Camera::CalcSceneView(FSceneViewFamily& ViewFamily, FViewport& VP)
 		FPlane(0, 0, 0, 1));
 
 	float AspectRatio = (float)VP.GetSizeXY().X / (float)VP.GetSizeXY().Y;
-	InitOptions.ProjectionMatrix = FReversedZPerspectiveMatrix(
-		FMath::Max(0.001f, FOV) * (float)PI / 360.0f,
-		AspectRatio,
-		1.0f,
-		GNearClippingPlane);
+	InitOptions.ProjectionMatrix = GetProjectionMatrix(AspectRatio);
 
 	InitOptions.ViewActor = this;
 
@@ -74,6 +70,15 @@ FSceneView* Camera::CalcSceneView(FSceneViewFamily& ViewFamily, FViewport& VP)
 	return View;
 }
 
+FMatrix Camera::GetProjectionMatrix(float AspectRatio) const
+{
+	return FReversedZPerspectiveMatrix(
+		FMath::Max(0.001f, FOV) * (float)PI / 360.0f,
+		AspectRatio,
+		1.0f,
+		GNearClippingPlane);
+}
+
 void Camera::Tick(float fDeltaSeconds)
 {
 
@@ -16,8 +16,14 @@ public:
 	void LookAt(FVector Target);
 	void SetLen(float fNear, float fFar);
 
+	/** Origin the scene views of this camera are rendered from */
+	const FVector& GetViewOrigin() const { return Position; }
+
 	FSceneView* CalcSceneView(FSceneViewFamily& ViewFamily, FViewport& VP);
 
+	/** Projection of the scene views of this camera into a viewport of AspectRatio, its width over its height */
+	FMatrix GetProjectionMatrix(float AspectRatio) const;
+
 	virtual void PostLoad() override {}
 	virtual void Tick(float fDeltaSeconds) override;
 public:
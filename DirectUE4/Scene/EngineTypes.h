@@ -65,6 +65,16 @@ enum EOcclusionCombineMode
 	OCM_MAX,
 };
 
+enum ELightComponentType
+{
+	LightType_Directional = 0,
+	LightType_Point,
+	LightType_Spot,
+	LightType_Rect,
+	LightType_MAX,
+	LightType_NumBits = 2
+};
+
 enum class ELightUnits : unsigned char
 {
 	Unitless,
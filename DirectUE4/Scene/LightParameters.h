@@ -0,0 +1,20 @@
+#pragma once
+
+#include "UnrealMath.h"
+
+struct ID3D11ShaderResourceView;
+
+/** The shader parameters of a light, as FLightSceneProxy::GetParameters fills them */
+struct FLightParameters
+{
+	Vector4		LightPositionAndInvRadius;
+	Vector4		LightColorAndFalloffExponent;
+	FVector		NormalizedLightDirection;
+	FVector		NormalizedLightTangent;
+	Vector2		SpotAngles;
+	float		SpecularScale;
+	float		LightSourceRadius;
+	float		LightSoftSourceRadius;
+	float		LightSourceLength;
+	ID3D11ShaderResourceView*	SourceTexture;
+};
@@ -48,6 +48,9 @@ FScene::FScene(UWorld* InWorld)
 : World(InWorld)
 , SkyLight(NULL)
 , SunLight(NULL)
+, LightOctree(FVector::ZeroVector, HALF_WORLD_MAX)
+, PrimitiveOctree(FVector::ZeroVector, HALF_WORLD_MAX)
+, LightInteractionUpdateStamp(0)
 , AtmosphericFog(NULL)
 , SceneFrameNumber(0)
 {
@@ -78,7 +81,17 @@ void FScene::AddPrimitive(UPrimitiveComponent* Primitive)
 
 void FScene::RemovePrimitive(UPrimitiveComponent* Primitive)
 {
+	FPrimitiveSceneProxy* PrimitiveSceneProxy = Primitive->SceneProxy;
 
+	if (PrimitiveSceneProxy)
+	{
+		FPrimitiveSceneInfo* PrimitiveSceneInfo = PrimitiveSceneProxy->PrimitiveSceneInfo;
+
+		// Disassociate the primitive's scene proxy.
+		Primitive->SceneProxy = NULL;
+
+		RemovePrimitiveSceneInfo_RenderThread(PrimitiveSceneInfo);
+	}
 }
 
 void FScene::UpdatePrimitiveTransform(UPrimitiveComponent* Primitive)
@@ -188,6 +201,7 @@ void FScene::AddPrimitiveSceneInfo_RenderThread(FPrimitiveSceneInfo* PrimitiveSc
 	Primitives.push_back(PrimitiveSceneInfo);
 	PrimitiveSceneProxies.push_back(PrimitiveSceneInfo->Proxy);
 	PrimitiveBounds.push_back(FPrimitiveBounds());
+	PrimitiveCullingBounds.Add(FPrimitiveBounds());
 	//PrimitiveFlagsCompact.AddUninitialized();
 	//PrimitiveVisibilityIds.AddUninitialized();
 	//PrimitiveOcclusionFlags.AddUninitialized();
@@ -200,12 +214,38 @@ void FScene::AddPrimitiveSceneInfo_RenderThread(FPrimitiveSceneInfo* PrimitiveSc
 	PrimitiveSceneInfo->AddToScene(true, true);
 }
 
+void FScene::RemovePrimitiveSceneInfo_RenderThread(FPrimitiveSceneInfo* PrimitiveSceneInfo)
+{
+	// Unlink the primitive from the octree, its light interactions and the static draw lists.
+	PrimitiveSceneInfo->RemoveFromScene(true);
+
+	// Keep the packed arrays dense, the last primitive moves into the removed one's slot.
+	const int32 PackedIndex = PrimitiveSceneInfo->PackedIndex;
+	const int32 LastIndex = (int32)Primitives.size() - 1;
+	if (PackedIndex != LastIndex)
+	{
+		Primitives[PackedIndex] = Primitives[LastIndex];
+		PrimitiveSceneProxies[PackedIndex] = PrimitiveSceneProxies[LastIndex];
+		PrimitiveBounds[PackedIndex] = PrimitiveBounds[LastIndex];
+		Primitives[PackedIndex]->PackedIndex = PackedIndex;
+	}
+	Primitives.pop_back();
+	PrimitiveSceneProxies.pop_back();
+	PrimitiveBounds.pop_back();
+	PrimitiveCullingBounds.RemoveAtSwap(PackedIndex);
+	PrimitiveSceneInfo->PackedIndex = INDEX_NONE;
+
+	// Delete the primitive scene proxy.
+	delete PrimitiveSceneInfo->Proxy;
+	delete PrimitiveSceneInfo;
+}
+
 void FScene::UpdateLightTransform_RenderThread(FLightSceneInfo* LightSceneInfo, const struct FUpdateLightTransformParameters& Parameters)
 {
 	if (LightSceneInfo)
 	{
 		// Don't remove directional lights when their transform changes as nothing in RemoveFromScene() depends on their transform
-		if (!(LightSceneInfo->Proxy->GetLightType() == LightType_Directional))
+		if (!(LightSceneInfo->Proxy->GetLightType() == LightType_Directional) && !GSpatialLightInteractions)
 		{
 			// Remove the light from the scene.
 			LightSceneInfo->RemoveFromScene();
@@ -222,8 +262,16 @@ void FScene::UpdateLightTransform_RenderThread(FLightSceneInfo* LightSceneInfo,
 			// Don't re-add directional lights when their transform changes as nothing in AddToScene() depends on their transform
 			if (!(LightSceneInfo->Proxy->GetLightType() == LightType_Directional))
 			{
-				// Add the light to the scene at its new location.
-				LightSceneInfo->AddToScene();
+				if (GSpatialLightInteractions)
+				{
+					// Move the light in the light octree, only the interactions that changed are destroyed and created.
+					LightSceneInfo->UpdateLightPrimitiveInteractions();
+				}
+				else
+				{
+					// Add the light to the scene at its new location.
+					LightSceneInfo->AddToScene();
+				}
 			}
 		}
 	}
@@ -232,7 +280,26 @@ void FScene::UpdateLightTransform_RenderThread(FLightSceneInfo* LightSceneInfo,
 
 void FScene::UpdatePrimitiveTransform_RenderThread(FPrimitiveSceneProxy* PrimitiveSceneProxy, const FBoxSphereBounds& WorldBounds, const FBoxSphereBounds& LocalBounds, const FMatrix& LocalToWorld, const FVector& OwnerPosition)
 {
+	FPrimitiveSceneInfo* PrimitiveSceneInfo = PrimitiveSceneProxy->GetPrimitiveSceneInfo();
+
+	if (GSpatialLightInteractions)
+	{
+		// Update the primitive transform.
+		PrimitiveSceneProxy->SetTransform(LocalToWorld, WorldBounds, LocalBounds, OwnerPosition);
+
+		// Move the primitive in the octree, only the light interactions that changed are destroyed and created.
+		PrimitiveSceneInfo->UpdateBounds();
+		return;
+	}
+
+	// Remove the primitive from the scene at its old location.
+	PrimitiveSceneInfo->RemoveFromScene(false);
+
+	// Update the primitive transform.
 	PrimitiveSceneProxy->SetTransform(LocalToWorld, WorldBounds, LocalBounds, OwnerPosition);
+
+	// Re-add the primitive to the scene with the new transform.
+	PrimitiveSceneInfo->AddToScene(false);
 }
 
 void FScene::AddPrecomputedVolumetricLightmap(const class FPrecomputedVolumetricLightmap* Volume)
@@ -10,6 +10,8 @@
 #include "DeferredShading.h"
 #include "ShadowRendering.h"
 #include "BasePassRendering.h"
+#include "PrimitiveSceneInfo.h"
+#include "FrustumCull.h"
 
 #include <memory>
 
@@ -68,20 +70,6 @@ class FIndirectLightingCache
 public:
 	void UpdateCache(FScene* Scene, FSceneRenderer& Renderer, bool bAllowUnbuiltPreview);
 };
-/**
-* Bounding information used to cull primitives in the scene.
-*/
-struct FPrimitiveBounds
-{
-	FBoxSphereBounds BoxSphereBounds;
-	/** Square of the minimum draw distance for the primitive. */
-	float MinDrawDistanceSq;
-	/** Maximum draw distance for the primitive. */
-	float MaxDrawDistance;
-	/** Maximum cull distance for the primitive. This is only different from the MaxDrawDistance for HLOD.*/
-	float MaxCullDistance;
-};
-
 struct FUpdateLightTransformParameters
 {
 	FMatrix LightToWorld;
@@ -301,6 +289,8 @@ public:
 	void DisableSkyLight(FSkyLightSceneProxy* Light);
 	void AddLightSceneInfo(FLightSceneInfo* LightSceneInfo);
 	void AddPrimitiveSceneInfo_RenderThread(FPrimitiveSceneInfo* PrimitiveSceneInfo);
+	/** Removes the primitive from the scene and deletes its scene info and proxy, the last primitive takes its PackedIndex */
+	void RemovePrimitiveSceneInfo_RenderThread(FPrimitiveSceneInfo* PrimitiveSceneInfo);
 
 	void UpdateLightTransform_RenderThread(FLightSceneInfo* LightSceneInfo, const struct FUpdateLightTransformParameters& Parameters);
 	void UpdatePrimitiveTransform_RenderThread(FPrimitiveSceneProxy* PrimitiveSceneProxy, const FBoxSphereBounds& WorldBounds, const FBoxSphereBounds& LocalBounds, const FMatrix& LocalToWorld, const FVector& OwnerPosition);
@@ -349,12 +339,29 @@ public:
 	std::vector<FPrimitiveSceneInfo*> Primitives;
 	std::vector<FPrimitiveSceneProxy*> PrimitiveSceneProxies;
 	std::vector<FPrimitiveBounds> PrimitiveBounds;
+	/** PrimitiveBounds laid out for FrustumCullPrimitives, kept in step with it */
+	FPrimitiveCullingBounds PrimitiveCullingBounds;
 	std::vector<FPrimitiveComponentId> PrimitiveComponentIds;
 
 	std::vector<FLightSceneInfoCompact> Lights;
 
+	/** Ids of the directional lights that have interactions with primitives, they can't be kept in LightOctree. */
+	std::vector<int32> DirectionalShadowCastingLightIDs;
+
+	/** An octree containing the lights with bounds that have interactions with primitives. */
+	FSceneLightOctree LightOctree;
+
+	/** An octree containing the primitives in the scene. */
+	FScenePrimitiveOctree PrimitiveOctree;
+
+	/** Light-primitive interaction work of the frame being built, IncrementFrameNumber moves it to LastFrameLightInteractionStats. */
+	FLightInteractionStats LightInteractionStats;
+
+	/** Light-primitive interaction work of the last frame. */
+	FLightInteractionStats LastFrameLightInteractionStats;
 
-	std::vector<FPrimitiveSceneInfoCompact> PrimitiveOctree;
+	/** Advanced by every light or primitive move, the move stamps the other end of every interaction it keeps with it. */
+	uint32 LightInteractionUpdateStamp;
 
 	class FAtmosphericFogSceneInfo* AtmosphericFog;
 
@@ -414,6 +421,8 @@ public:
 	void IncrementFrameNumber()
 	{
 		++SceneFrameNumber;
+		LastFrameLightInteractionStats = LightInteractionStats;
+		LightInteractionStats = FLightInteractionStats();
 	}
 	UWorld* GetWorld() const { return World; }
 private:
@@ -4,6 +4,7 @@
 #include "DepthOnlyRendering.h"
 #include "ShadowRendering.h"
 #include "BasePassRendering.h"
+#include "Scene.h"
 
 void FLightPrimitiveInteraction::Create(FLightSceneInfo* LightSceneInfo, FPrimitiveSceneInfo* PrimitiveSceneInfo)
 {
@@ -32,12 +33,14 @@ void FLightPrimitiveInteraction::Create(FLightSceneInfo* LightSceneInfo, FPrimit
 		{
 			// Create the light interaction.
 			FLightPrimitiveInteraction* Interaction = new FLightPrimitiveInteraction(LightSceneInfo, PrimitiveSceneInfo, bDynamic, bIsLightMapped, bShadowMapped, bTranslucentObjectShadow, bInsetObjectShadow);
+			++LightSceneInfo->Scene->LightInteractionStats.NumCreated;
 		} //-V773
 	}
 }
 
 void FLightPrimitiveInteraction::Destroy(FLightPrimitiveInteraction* LightPrimitiveInteraction)
 {
+	++LightPrimitiveInteraction->LightSceneInfo->Scene->LightInteractionStats.NumDestroyed;
 	delete LightPrimitiveInteraction;
 }
 
@@ -145,5 +148,15 @@ void FStaticMesh::AddToDrawLists(/*FRHICommandListImmediate& RHICmdList,*/ FScen
 
 void FStaticMesh::RemoveFromDrawLists()
 {
-
+	// The mesh keeps no links to its draw list elements, so every draw list it can be in is searched
+	FScene* Scene = PrimitiveSceneInfo->Scene;
+	Scene->PositionOnlyDepthDrawList.RemoveMesh(this);
+	Scene->DepthDrawList.RemoveMesh(this);
+	Scene->MaskedDepthDrawList.RemoveMesh(this);
+	for (int32 DrawType = 0; DrawType < EBasePass_MAX; DrawType++)
+	{
+		Scene->BasePassUniformLightMapPolicyDrawList[DrawType].RemoveMesh(this);
+	}
+	Scene->WholeSceneShadowDepthDrawList.RemoveMesh(this);
+	Scene->WholeSceneReflectiveShadowMapDrawList.RemoveMesh(this);
 }
\ No newline at end of file
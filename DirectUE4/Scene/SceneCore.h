@@ -144,7 +144,7 @@ public:
 		FMeshBatch(InMesh),
 		//ScreenSize(InScreenSize),
 		PrimitiveSceneInfo(InPrimitiveSceneInfo),
-		//Id(INDEX_NONE),
+		Id(INDEX_NONE),
 		BatchVisibilityId(-1)
 	{
 		//BatchHitProxyId = InHitProxyId;
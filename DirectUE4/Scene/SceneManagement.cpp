@@ -1,4 +1,5 @@
 #include "SceneManagement.h"
+#include "SceneView.h"
 #include "LightComponent.h"
 #include "LightMap.h"
 #include "ShadowMap.h"
@@ -174,3 +175,17 @@ void FMeshElementCollector::AddMesh(int32 ViewIndex, FMeshBatch& MeshBatch)
 	ViewMeshBatches.push_back(FMeshBatchAndRelevance(MeshBatch, PrimitiveSceneProxy)) ;
 }
 
+float ComputeBoundsScreenSize(const FVector& Origin, const float SphereRadius, const FSceneView& View)
+{
+	const float Distance = (Origin - View.ViewMatrices.GetViewOrigin()).Size() * View.LODDistanceFactor;
+	const FMatrix& ProjectionMatrix = View.ViewMatrices.GetProjectionMatrix();
+	const float ScreenMultiple = FMath::Max(0.5f * ProjectionMatrix.M[0][0], 0.5f * ProjectionMatrix.M[1][1]);
+	return 2.0f * ScreenMultiple * SphereRadius / FMath::Max(1.0f, Distance);
+}
+
+float ComputeBoundsScreenSize(const FVector& Origin, const float SphereRadius, const FVector& ViewOrigin, const FMatrix& ProjectionMatrix)
+{
+	const float Distance = (Origin - ViewOrigin).Size();
+	const float ScreenMultiple = FMath::Max(0.5f * ProjectionMatrix.M[0][0], 0.5f * ProjectionMatrix.M[1][1]);
+	return 2.0f * ScreenMultiple * SphereRadius / FMath::Max(1.0f, Distance);
+}
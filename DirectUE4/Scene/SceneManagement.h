@@ -5,6 +5,7 @@
 #include "MeshBach.h"
 #include "PrimitiveSceneProxy.h"
 #include "SHMath.h"
+#include "LightParameters.h"
 
 #define WORLD_MAX					2097152.0				/* Maximum size of the world */
 #define HALF_WORLD_MAX				(WORLD_MAX * 0.5)		/* Half the maximum size of the world */
@@ -626,20 +627,6 @@ public:
 	EOcclusionCombineMode OcclusionCombineMode;
 };
 
-struct FLightParameters
-{
-	Vector4		LightPositionAndInvRadius;
-	Vector4		LightColorAndFalloffExponent;
-	FVector		NormalizedLightDirection;
-	FVector		NormalizedLightTangent;
-	Vector2		SpotAngles;
-	float		SpecularScale;
-	float		LightSourceRadius;
-	float		LightSoftSourceRadius;
-	float		LightSourceLength;
-	ID3D11ShaderResourceView*	SourceTexture;
-};
-
 class FLightSceneProxy
 {
 public:
@@ -905,4 +892,13 @@ private:
 	friend class FSceneRenderer;
 	friend class FProjectedShadowInfo;
 	friend class FUniformMeshConverter;
-};
\ No newline at end of file
+};
+
+/**
+ * Diameter of the bounding sphere projected by View, over the view's size along its larger projection scale.
+ * View.LODDistanceFactor scales the distance as it does for every other screen size test.
+ */
+float ComputeBoundsScreenSize(const FVector& Origin, const float SphereRadius, const FSceneView& View);
+
+/** ComputeBoundsScreenSize of a view given by its origin and projection matrix, for code that runs before the scene views are set up */
+float ComputeBoundsScreenSize(const FVector& Origin, const float SphereRadius, const FVector& ViewOrigin, const FMatrix& ProjectionMatrix);
@@ -5,21 +5,23 @@
 #include "MeshComponent.h"
 #include "AnimSequence.h"
 
-SkeletalMeshActor::SkeletalMeshActor(class UWorld* InOwner, const char* ResourcePath)
+SkeletalMeshActor::SkeletalMeshActor(class UWorld* InOwner, const char* ResourcePath, const std::vector<float>& BoneReductionLODScreenSizes)
  : AActor(InOwner)
 {
 	FBXImporter Importer;
-	USkeletalMesh* Mesh = Importer.ImportSkeletalMesh(this,ResourcePath);
+	USkeletalMesh* Mesh = Importer.ImportSkeletalMesh(this,ResourcePath,BoneReductionLODScreenSizes);
 
 	MeshComponent = new USkeletalMeshComponent(this);
 	MeshComponent->SetSkeletalMesh(Mesh);
 	MeshComponent->Mobility = EComponentMobility::Movable;
+	// crowds of these are what update rate optimizations are for, they still only apply with -animupdaterate
+	MeshComponent->bEnableUpdateRateOptimizations = true;
 
 	RootComponent = MeshComponent;
 }
 
-SkeletalMeshActor::SkeletalMeshActor(class UWorld* InOwner, const char* ResourcePath, const char* AnimationPath)
-	:SkeletalMeshActor(InOwner, ResourcePath)
+SkeletalMeshActor::SkeletalMeshActor(class UWorld* InOwner, const char* ResourcePath, const char* AnimationPath, const std::vector<float>& BoneReductionLODScreenSizes)
+	:SkeletalMeshActor(InOwner, ResourcePath, BoneReductionLODScreenSizes)
 {
 	FBXImporter Importer;
 	AnimSequence = Importer.ImportFbxAnimation(MeshComponent->SkeletalMesh->Skeleton, AnimationPath,"Idle",false);
@@ -8,13 +8,16 @@ class UAnimSequence;
 class SkeletalMeshActor : public AActor
 {
 public:
-	SkeletalMeshActor(class UWorld* InOwner, const char* ResourcePath);
-	SkeletalMeshActor(class UWorld* InOwner, const char* ResourcePath, const char* AnimationPath);
+	/** @param BoneReductionLODScreenSizes - see FBXImporter::ImportSkeletalMesh, the mesh has no bone reduction LODs unless asked for */
+	SkeletalMeshActor(class UWorld* InOwner, const char* ResourcePath, const std::vector<float>& BoneReductionLODScreenSizes = std::vector<float>());
+	SkeletalMeshActor(class UWorld* InOwner, const char* ResourcePath, const char* AnimationPath, const std::vector<float>& BoneReductionLODScreenSizes = std::vector<float>());
 	virtual ~SkeletalMeshActor();
 
 	virtual void PostLoad() override;
 
 	virtual void Tick(float fDeltaTime) override;
+
+	UAnimSequence* GetAnimSequence() const { return AnimSequence; }
 protected:
 	USkeletalMeshComponent* MeshComponent;
 	UAnimSequence* AnimSequence;
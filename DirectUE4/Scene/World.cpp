@@ -11,6 +11,12 @@
 #include "AtmosphereFog.h"
 #include "SkyLight.h"
 #include "PrecomputedVolumetricLightmap.h"
+#include "ParallelFor.h"
+#include "AnimPoseCache.h"
+#include <algorithm>
+
+bool GParallelAnimationEvaluation = true;
+uint32 GFrameCounter = 0;
 
 class FloorActor : public StaticMeshActor
 {
@@ -76,10 +82,48 @@ void UWorld::InitWorld()
 
 void UWorld::Tick(float fDeltaSeconds)
 {
+	GAnimPoseCache.BeginFrame();
+
+	// skeletal components queue their animation work while ticking, it is run below before any render data is sent
+	bCollectingAnimationEvaluations = GParallelAnimationEvaluation;
 	for (AActor* actor : mAllActors)
 	{
 		actor->Tick(fDeltaSeconds);
 	}
+	bCollectingAnimationEvaluations = false;
+
+	RunParallelAnimationEvaluation();
+
+	++GFrameCounter;
+}
+
+bool UWorld::QueueParallelAnimationEvaluation(USkeletalMeshComponent* InComponent)
+{
+	if (!bCollectingAnimationEvaluations)
+	{
+		return false;
+	}
+	PendingAnimationEvaluations.push_back(InComponent);
+	return true;
+}
+
+void UWorld::RunParallelAnimationEvaluation()
+{
+	if (PendingAnimationEvaluations.empty())
+	{
+		return;
+	}
+
+	ParallelFor((int)PendingAnimationEvaluations.size(), [this](int Index)
+	{
+		PendingAnimationEvaluations[Index]->ParallelAnimationEvaluation();
+	});
+
+	for (USkeletalMeshComponent* Component : PendingAnimationEvaluations)
+	{
+		Component->CompleteParallelAnimationEvaluation();
+	}
+	PendingAnimationEvaluations.clear();
 }
 
 void UWorld::DestroyActor(AActor* InActor)
@@ -1,11 +1,22 @@
 #pragma once
 
 #include <vector>
+#include "UnrealMath.h"
 
 class AActor;
 class Camera;
 class FScene;
 class UActorComponent;
+class USkeletalMeshComponent;
+
+/**
+* When true, skeletal mesh components don't evaluate their animation inside their own tick, they queue it on the world
+* which updates and evaluates all of them on worker threads once every actor has ticked.
+*/
+extern bool GParallelAnimationEvaluation;
+
+/** Number of world ticks so far */
+extern uint32 GFrameCounter;
 
 class UWorld
 {
@@ -28,7 +39,19 @@ public:
 
 	void RegisterComponent(class UActorComponent* InComponent);
 	void UnregisterComponent(class UActorComponent* InComponent);
+
+	/**
+	* Defers the animation update and evaluation of InComponent to the parallel animation phase of the current Tick.
+	* @return false if no phase is collecting right now, the caller has to evaluate inline
+	*/
+	bool QueueParallelAnimationEvaluation(USkeletalMeshComponent* InComponent);
 private:
+	/** Runs every queued animation evaluation on the worker threads, then completes them on the calling thread */
+	void RunParallelAnimationEvaluation();
+
+	bool bCollectingAnimationEvaluations = false;
+	std::vector<USkeletalMeshComponent*> PendingAnimationEvaluations;
+
 	std::vector<Camera*> mCameras;
 	std::vector<AActor*> mAllActors;
 	std::vector<UActorComponent*> ActorComponents;
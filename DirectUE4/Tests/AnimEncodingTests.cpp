@@ -0,0 +1,121 @@
+#include "TestHarness.h"
+#include "UnrealMath.h"
+#include "AnimEnums.h"
+#include "AnimationCompression.h"
+
+/**
+* Key formats of the compressed animation tracks against the quantization step each one documents. The NoW rotation
+* formats drop W and rebuild it from X, Y and Z, so W is only as exact as sqrt(1 - |XYZ|^2) allows: with every
+* component off by at most Step, |XYZ|^2 moves by up to 2 * sqrt(3) * Step + 3 * Step^2, which bounds W's error.
+*/
+
+static FQuat MakeTestRotation(int32 Index)
+{
+	// covers every octant, angles up to a full turn and W from 1 down to 0
+	const FVector Axis = FVector(FMath::Sin(Index * 1.7f), FMath::Cos(Index * 2.3f), FMath::Sin(Index * 0.9f + 1.f)).GetSafeNormal();
+	return FQuat(Axis, (Index % 64) * (2.f * PI / 63.f));
+}
+
+static float GetRebuiltWTolerance(float Step)
+{
+	return FMath::Sqrt(2.f * FMath::Sqrt(3.f) * Step + 3.f * Step * Step);
+}
+
+template <int32 FORMAT, typename KeyType>
+static void CheckRotationFormat(float StepX, float StepY, float StepZ)
+{
+	const float MaxStep = FMath::Max(StepX, FMath::Max(StepY, StepZ));
+	for (int32 Index = 0; Index < 500; ++Index)
+	{
+		FQuat Source = MakeTestRotation(Index);
+		// the formats store the hemisphere with a positive W
+		if (Source.W < 0.f)
+		{
+			Source = FQuat(-Source.X, -Source.Y, -Source.Z, -Source.W);
+		}
+
+		const KeyType Key(Source);
+		FQuat Decoded;
+		DecompressRotation<FORMAT>(Decoded, nullptr, (const uint8*)&Key);
+
+		TEST_CHECK_NEAR(Decoded.X, Source.X, StepX + 1e-6f);
+		TEST_CHECK_NEAR(Decoded.Y, Source.Y, StepY + 1e-6f);
+		TEST_CHECK_NEAR(Decoded.Z, Source.Z, StepZ + 1e-6f);
+		TEST_CHECK_NEAR(Decoded.W, Source.W, GetRebuiltWTolerance(MaxStep) + 1e-6f);
+	}
+}
+
+IMPLEMENT_TEST(AnimEncoding_RotationFormats)
+{
+	// truncated to 16 bits over [-1, 1]
+	CheckRotationFormat<ACF_Fixed48NoW, FQuatFixed48NoW>(1.f / 32767.f, 1.f / 32767.f, 1.f / 32767.f);
+	// 11, 11 and 10 bits over [-1, 1]
+	CheckRotationFormat<ACF_Fixed32NoW, FQuatFixed32NoW>(1.f / 1023.f, 1.f / 1023.f, 1.f / 511.f);
+	// floats, only W is rebuilt
+	CheckRotationFormat<ACF_Float96NoW, FQuatFloat96NoW>(1e-6f, 1e-6f, 1e-6f);
+}
+
+IMPLEMENT_TEST(AnimEncoding_IntervalRotationFormat)
+{
+	// the track's range is stored in front of its keys: three mins, then three ranges
+	float MinsAndRanges[6] = { MAX_flt, MAX_flt, MAX_flt, 0.f, 0.f, 0.f };
+	std::vector<FQuat> Sources;
+	for (int32 Index = 0; Index < 64; ++Index)
+	{
+		FQuat Source(FVector(0.2f, 1.f, 0.1f * Index).GetSafeNormal(), 0.3f + 0.01f * Index);
+		Sources.push_back(Source);
+		MinsAndRanges[0] = FMath::Min(MinsAndRanges[0], Source.X);
+		MinsAndRanges[1] = FMath::Min(MinsAndRanges[1], Source.Y);
+		MinsAndRanges[2] = FMath::Min(MinsAndRanges[2], Source.Z);
+	}
+	for (const FQuat& Source : Sources)
+	{
+		MinsAndRanges[3] = FMath::Max(MinsAndRanges[3], Source.X - MinsAndRanges[0]);
+		MinsAndRanges[4] = FMath::Max(MinsAndRanges[4], Source.Y - MinsAndRanges[1]);
+		MinsAndRanges[5] = FMath::Max(MinsAndRanges[5], Source.Z - MinsAndRanges[2]);
+	}
+
+	const float StepX = MinsAndRanges[3] / 1023.f;
+	const float StepY = MinsAndRanges[4] / 1023.f;
+	const float StepZ = MinsAndRanges[5] / 511.f;
+	for (const FQuat& Source : Sources)
+	{
+		const FQuatIntervalFixed32NoW Key(Source, MinsAndRanges, MinsAndRanges + 3);
+		FQuat Decoded;
+		DecompressRotation<ACF_IntervalFixed32NoW>(Decoded, (const uint8*)MinsAndRanges, (const uint8*)&Key);
+
+		TEST_CHECK_NEAR(Decoded.X, Source.X, StepX + 1e-6f);
+		TEST_CHECK_NEAR(Decoded.Y, Source.Y, StepY + 1e-6f);
+		TEST_CHECK_NEAR(Decoded.Z, Source.Z, StepZ + 1e-6f);
+		TEST_CHECK_NEAR(Decoded.W, Source.W, GetRebuiltWTolerance(FMath::Max(StepX, FMath::Max(StepY, StepZ))) + 1e-6f);
+	}
+}
+
+IMPLEMENT_TEST(AnimEncoding_TranslationFormats)
+{
+	float MinsAndRanges[6] = { -50.f, -20.f, 0.f, 100.f, 40.f, 200.f };
+	for (int32 Index = 0; Index < 500; ++Index)
+	{
+		const float Alpha = Index / 499.f;
+		const FVector Source(-50.f + 100.f * Alpha, -20.f + 40.f * FMath::Fractional(Alpha * 7.f), 200.f * FMath::Fractional(Alpha * 13.f));
+
+		// 10, 11 and 11 bits over the track's range
+		const FVectorIntervalFixed32NoW IntervalKey(Source, MinsAndRanges, MinsAndRanges + 3);
+		FVector Decoded;
+		DecompressTranslation<ACF_IntervalFixed32NoW>(Decoded, (const uint8*)MinsAndRanges, (const uint8*)&IntervalKey);
+		TEST_CHECK_NEAR(Decoded.X, Source.X, MinsAndRanges[3] / 511.f + 1e-4f);
+		TEST_CHECK_NEAR(Decoded.Y, Source.Y, MinsAndRanges[4] / 1023.f + 1e-4f);
+		TEST_CHECK_NEAR(Decoded.Z, Source.Z, MinsAndRanges[5] / 1023.f + 1e-4f);
+
+		// 16 bits over [-128, 128]
+		const FVector SmallSource = Source * (127.f / 200.f);
+		const FVectorFixed48 FixedKey(SmallSource);
+		DecompressTranslation<ACF_Fixed48NoW>(Decoded, nullptr, (const uint8*)&FixedKey);
+		TEST_CHECK_NEAR(Decoded.X, SmallSource.X, 128.f / 32767.f + 1e-5f);
+		TEST_CHECK_NEAR(Decoded.Y, SmallSource.Y, 128.f / 32767.f + 1e-5f);
+		TEST_CHECK_NEAR(Decoded.Z, SmallSource.Z, 128.f / 32767.f + 1e-5f);
+
+		DecompressTranslation<ACF_Float96NoW>(Decoded, nullptr, (const uint8*)&Source);
+		TEST_CHECK(Decoded == Source);
+	}
+}
@@ -0,0 +1,240 @@
+#include "TestHarness.h"
+#include "BakedAnimation.h"
+#include "Transform.h"
+#include <cstdio>
+#include <fstream>
+
+/**
+* The bake quantizes every matrix element to 16 bit against the range of its bone, so an element is never off by more
+* than half a quantization step of that range, and playback at a baked frame has to return exactly that frame.
+*/
+
+static const int32 TestNumBones = 6;
+static const float TestSampleRate = 30.f;
+
+/** A swinging chain: every bone turns about its own axis and moves a little, the root also scales */
+static FMatrix MakeTestReferenceToLocal(int32 BoneIndex, float Time)
+{
+	const FVector Axis = FVector(1.f, 0.5f * BoneIndex, 0.25f).GetSafeNormal();
+	const FQuat Rotation(Axis, FMath::Sin(Time * 3.f + BoneIndex) * (0.5f + 0.2f * BoneIndex));
+	const FVector Translation(10.f * BoneIndex, 3.f * FMath::Cos(Time * 2.f), 25.f * FMath::Sin(Time + 0.1f * BoneIndex));
+	const FVector Scale = BoneIndex == 0 ? FVector(1.f + 0.1f * FMath::Sin(Time), 1.f, 1.f) : FVector(1.f, 1.f, 1.f);
+	return FTransform(Rotation, Translation, Scale).ToMatrixWithScale();
+}
+
+struct FTestBake
+{
+	std::vector<float> SequenceLengths;
+	std::vector<FMatrix> ReferenceToLocal;
+	std::vector<FVector> BindPoseBonePositions;
+
+	FTestBake()
+	{
+		// the second length is no multiple of the frame time, so its last interval is a short one
+		SequenceLengths.push_back(1.f);
+		SequenceLengths.push_back(0.45f);
+		for (const float SequenceLength : SequenceLengths)
+		{
+			const int32 NumFrames = FBakedAnimationData::GetNumFrames(SequenceLength, TestSampleRate);
+			for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+			{
+				const float Time = FMath::Min(Frame / TestSampleRate, SequenceLength);
+				for (int32 BoneIndex = 0; BoneIndex < TestNumBones; ++BoneIndex)
+				{
+					ReferenceToLocal.push_back(MakeTestReferenceToLocal(BoneIndex, Time));
+				}
+			}
+		}
+		for (int32 BoneIndex = 0; BoneIndex < TestNumBones; ++BoneIndex)
+		{
+			BindPoseBonePositions.push_back(FVector(0.f, 10.f * BoneIndex, 100.f + 5.f * BoneIndex));
+		}
+	}
+
+	/** Half a quantization step of Element of BoneIndex over all frames, the most rounding can move it */
+	float GetElementTolerance(int32 BoneIndex, int32 Row, int32 Column) const
+	{
+		float MinValue = MAX_flt;
+		float MaxValue = -MAX_flt;
+		for (uint32 MatrixIndex = BoneIndex; MatrixIndex < ReferenceToLocal.size(); MatrixIndex += TestNumBones)
+		{
+			MinValue = FMath::Min(MinValue, ReferenceToLocal[MatrixIndex].M[Row][Column]);
+			MaxValue = FMath::Max(MaxValue, ReferenceToLocal[MatrixIndex].M[Row][Column]);
+		}
+		// plus the float error of Min + Quantized * Scale
+		return 0.5f * (MaxValue - MinValue) / (float)MAX_uint16 + 1e-6f * FMath::Max(FMath::Abs(MinValue), FMath::Abs(MaxValue));
+	}
+};
+
+IMPLEMENT_TEST(BakedAnimation_QuantizationErrorBound)
+{
+	const FTestBake TestBake;
+	FBakedAnimationData BakedAnimation;
+	FBakedAnimationReport Report;
+	TEST_CHECK(BakedAnimation.BakeFromReferenceToLocal(TestNumBones, TestSampleRate, TestBake.SequenceLengths, TestBake.ReferenceToLocal, TestBake.BindPoseBonePositions, &Report));
+
+	const int32 NumFrames = (int32)TestBake.ReferenceToLocal.size() / TestNumBones;
+	TEST_CHECK(Report.NumBones == TestNumBones);
+	TEST_CHECK(Report.NumFrames == NumFrames);
+	// 16 instead of 32 bits an element, plus the ranges and the sequences
+	TEST_CHECK(Report.BakedSize == Report.RawSize / 2 + TestNumBones * sizeof(FBakedBoneRange) + 2 * sizeof(FBakedAnimSequence));
+
+	float MaxError = 0.f;
+	std::vector<FMatrix> DecodedFrame;
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		BakedAnimation.DecodeFrame(Frame, DecodedFrame);
+		for (int32 BoneIndex = 0; BoneIndex < TestNumBones; ++BoneIndex)
+		{
+			const FMatrix& Source = TestBake.ReferenceToLocal[Frame * TestNumBones + BoneIndex];
+			for (int32 Row = 0; Row < 4; ++Row)
+			{
+				for (int32 Column = 0; Column < 3; ++Column)
+				{
+					TEST_CHECK_NEAR(DecodedFrame[BoneIndex].M[Row][Column], Source.M[Row][Column], TestBake.GetElementTolerance(BoneIndex, Row, Column));
+					MaxError = FMath::Max(MaxError, FMath::Abs(DecodedFrame[BoneIndex].M[Row][Column] - Source.M[Row][Column]));
+				}
+				TEST_CHECK(DecodedFrame[BoneIndex].M[Row][3] == (Row == 3 ? 1.f : 0.f));
+			}
+		}
+	}
+
+	// the report measures the same error the decoder produces
+	TEST_CHECK_NEAR(Report.MaxMatrixError, MaxError, 1e-6f);
+	TEST_CHECK(Report.AverageMatrixError <= Report.MaxMatrixError);
+	// a position is moved by at most the element errors of its row sums
+	float MaxBonePositionSum = 0.f;
+	for (const FVector& Position : TestBake.BindPoseBonePositions)
+	{
+		MaxBonePositionSum = FMath::Max(MaxBonePositionSum, FMath::Abs(Position.X) + FMath::Abs(Position.Y) + FMath::Abs(Position.Z) + 1.f);
+	}
+	TEST_CHECK(Report.MaxPositionError <= FMath::Sqrt(3.f) * MaxBonePositionSum * Report.MaxMatrixError + 1e-5f);
+}
+
+IMPLEMENT_TEST(BakedAnimation_SamplePlayback)
+{
+	const FTestBake TestBake;
+	FBakedAnimationData BakedAnimation;
+	TEST_CHECK(BakedAnimation.BakeFromReferenceToLocal(TestNumBones, TestSampleRate, TestBake.SequenceLengths, TestBake.ReferenceToLocal, TestBake.BindPoseBonePositions));
+	TEST_CHECK(BakedAnimation.GetNumSequences() == 2);
+
+	std::vector<FMatrix> Sampled, Decoded0, Decoded1;
+	for (int32 SequenceIndex = 0; SequenceIndex < BakedAnimation.GetNumSequences(); ++SequenceIndex)
+	{
+		const FBakedAnimSequence& Sequence = BakedAnimation.GetSequence(SequenceIndex);
+		TEST_CHECK(Sequence.NumFrames == FBakedAnimationData::GetNumFrames(TestBake.SequenceLengths[SequenceIndex], TestSampleRate));
+
+		// on a baked frame playback is that frame
+		for (int32 Frame = 0; Frame < Sequence.NumFrames; ++Frame)
+		{
+			const float Time = FMath::Min(Frame / TestSampleRate, Sequence.SequenceLength);
+			BakedAnimation.SampleReferenceToLocal(SequenceIndex, Time, false, Sampled);
+			BakedAnimation.DecodeFrame(Sequence.FirstFrame + Frame, Decoded0);
+			for (int32 BoneIndex = 0; BoneIndex < TestNumBones; ++BoneIndex)
+			{
+				for (int32 Row = 0; Row < 4; ++Row)
+				{
+					for (int32 Column = 0; Column < 3; ++Column)
+					{
+						TEST_CHECK_NEAR(Sampled[BoneIndex].M[Row][Column], Decoded0[BoneIndex].M[Row][Column], 1e-4f);
+					}
+				}
+			}
+		}
+
+		// half way between two frames playback is their average
+		BakedAnimation.SampleReferenceToLocal(SequenceIndex, 2.5f / TestSampleRate, false, Sampled);
+		BakedAnimation.DecodeFrame(Sequence.FirstFrame + 2, Decoded0);
+		BakedAnimation.DecodeFrame(Sequence.FirstFrame + 3, Decoded1);
+		TEST_CHECK_NEAR(Sampled[3].M[3][2], 0.5f * (Decoded0[3].M[3][2] + Decoded1[3].M[3][2]), 1e-3f);
+
+		// looping wraps around, clamping holds the last frame
+		BakedAnimation.SampleReferenceToLocal(SequenceIndex, Sequence.SequenceLength + 1.f / TestSampleRate, true, Sampled);
+		BakedAnimation.DecodeFrame(Sequence.FirstFrame + 1, Decoded0);
+		TEST_CHECK_NEAR(Sampled[5].M[3][1], Decoded0[5].M[3][1], 1e-3f);
+		BakedAnimation.SampleReferenceToLocal(SequenceIndex, Sequence.SequenceLength + 1.f, false, Sampled);
+		BakedAnimation.DecodeFrame(Sequence.FirstFrame + Sequence.NumFrames - 1, Decoded0);
+		TEST_CHECK_NEAR(Sampled[5].M[3][1], Decoded0[5].M[3][1], 1e-4f);
+	}
+}
+
+static std::vector<char> ReadTestFile(const char* Filename)
+{
+	std::ifstream In(Filename, std::ios::in | std::ios::binary);
+	return std::vector<char>((std::istreambuf_iterator<char>(In)), std::istreambuf_iterator<char>());
+}
+
+static void WriteTestFile(const char* Filename, const std::vector<char>& Data)
+{
+	std::ofstream Out(Filename, std::ios::out | std::ios::binary | std::ios::trunc);
+	Out.write(Data.data(), Data.size());
+}
+
+IMPLEMENT_TEST(BakedAnimation_SaveLoad)
+{
+	const char* Filename = "BakedAnimationTest.baked";
+	const FTestBake TestBake;
+	FBakedAnimationData BakedAnimation;
+	TEST_CHECK(BakedAnimation.BakeFromReferenceToLocal(TestNumBones, TestSampleRate, TestBake.SequenceLengths, TestBake.ReferenceToLocal, TestBake.BindPoseBonePositions));
+	FSHAHash SourceHash;
+	SourceHash.Hash[0] = 0x12;
+	SourceHash.Hash[19] = 0x34;
+	BakedAnimation.SetSourceHash(SourceHash);
+	TEST_CHECK(BakedAnimation.SaveToFile(Filename));
+
+	FBakedAnimationData Loaded;
+	TEST_CHECK(Loaded.LoadFromFile(Filename));
+	TEST_CHECK(Loaded.GetSourceHash() == SourceHash);
+	TEST_CHECK(Loaded.GetSampleRate() == TestSampleRate);
+	TEST_CHECK(Loaded.GetNumBones() == TestNumBones);
+	TEST_CHECK(Loaded.GetNumSequences() == BakedAnimation.GetNumSequences());
+	TEST_CHECK(Loaded.GetDataSize() == BakedAnimation.GetDataSize());
+
+	std::vector<FMatrix> Original, Reloaded;
+	BakedAnimation.SampleReferenceToLocal(1, 0.2f, true, Original);
+	Loaded.SampleReferenceToLocal(1, 0.2f, true, Reloaded);
+	for (int32 BoneIndex = 0; BoneIndex < TestNumBones; ++BoneIndex)
+	{
+		TEST_CHECK(Original[BoneIndex] == Reloaded[BoneIndex]);
+	}
+
+	// offsets of the header fields and the first sequence, as SaveToFile writes them
+	const size_t NumBonesOffset = 4 + 4 + 20 + 4;
+	const size_t NumElementsOffset = NumBonesOffset + 4 + 4;
+	const size_t FirstSequenceOffset = NumElementsOffset + 4;
+	const std::vector<char> Valid = ReadTestFile(Filename);
+
+	// anything that does not add up is rejected and leaves the data empty
+	std::vector<char> Corrupt = Valid;
+	Corrupt.resize(Corrupt.size() - 2);
+	WriteTestFile(Filename, Corrupt);
+	TEST_CHECK(!Loaded.LoadFromFile(Filename));
+	TEST_CHECK(Loaded.GetNumBones() == 0 && Loaded.GetNumSequences() == 0);
+
+	Corrupt = Valid;
+	const int32 TooManyBones = TestNumBones + 1;
+	memcpy(&Corrupt[NumBonesOffset], &TooManyBones, sizeof(TooManyBones));
+	WriteTestFile(Filename, Corrupt);
+	TEST_CHECK(!Loaded.LoadFromFile(Filename));
+
+	Corrupt = Valid;
+	const uint32 HugeNumElements = 0xFFFFFFF0u;
+	memcpy(&Corrupt[NumElementsOffset], &HugeNumElements, sizeof(HugeNumElements));
+	WriteTestFile(Filename, Corrupt);
+	TEST_CHECK(!Loaded.LoadFromFile(Filename));
+
+	Corrupt = Valid;
+	FBakedAnimSequence OutOfRange = BakedAnimation.GetSequence(0);
+	OutOfRange.FirstFrame = 1000;
+	memcpy(&Corrupt[FirstSequenceOffset], &OutOfRange, sizeof(OutOfRange));
+	WriteTestFile(Filename, Corrupt);
+	TEST_CHECK(!Loaded.LoadFromFile(Filename));
+	TEST_CHECK(Loaded.GetNumSequences() == 0);
+
+	Corrupt = Valid;
+	Corrupt[4] = 1;
+	WriteTestFile(Filename, Corrupt);
+	TEST_CHECK(!Loaded.LoadFromFile(Filename));
+
+	std::remove(Filename);
+}
@@ -0,0 +1,107 @@
+#include "TestHarness.h"
+#include "UnrealMath.h"
+#include "ConvexVolume.h"
+#include "BitArray.h"
+#include "FrustumCull.h"
+
+#include <cfloat>
+#include <random>
+
+/**
+* FrustumCullPrimitives against FrustumCullPrimitivesScalar for random bounds and views, on the calling thread and on the
+* workers, including primitive counts that leave a partial group of four and span several tasks, and after removals.
+*/
+
+static FPrimitiveBounds MakeRandomPrimitiveBounds(std::mt19937& Random, float WorldExtent)
+{
+	std::uniform_real_distribution<float> Unit(0.f, 1.f);
+	const float Radius = Unit(Random) < 0.01f ? 2000.f + 8000.f * Unit(Random) : 10.f * FMath::Pow(20.f, Unit(Random));
+	const FVector Extent = FVector(0.3f + 0.7f * Unit(Random), 0.3f + 0.7f * Unit(Random), 0.3f + 0.7f * Unit(Random)) * Radius;
+	const FVector Origin = FVector(Unit(Random) * 2.f - 1.f, Unit(Random) * 2.f - 1.f, Unit(Random) * 2.f - 1.f) * WorldExtent;
+
+	FPrimitiveBounds Bounds;
+	Bounds.BoxSphereBounds = FBoxSphereBounds(Origin, Extent, Extent.Size());
+	Bounds.MinDrawDistanceSq = Unit(Random) < 0.05f ? FMath::Square(1000.f) : 0.f;
+	Bounds.MaxDrawDistance = Unit(Random) < 0.2f ? 5000.f + 20000.f * Unit(Random) : FLT_MAX;
+	Bounds.MaxCullDistance = Bounds.MaxDrawDistance;
+	return Bounds;
+}
+
+/** Culls PrimitiveBounds and CullingBounds from random views and checks the vectorized results match the scalar ones */
+static void CheckFrustumCullMatchesScalar(const std::vector<FPrimitiveBounds>& PrimitiveBounds, const FPrimitiveCullingBounds& CullingBounds, std::mt19937& Random, float WorldExtent)
+{
+	std::uniform_real_distribution<float> Unit(0.f, 1.f);
+	auto RandomPosition = [&]()
+	{
+		return FVector(Unit(Random) * 2.f - 1.f, Unit(Random) * 2.f - 1.f, Unit(Random) * 2.f - 1.f) * WorldExtent;
+	};
+
+	TEST_CHECK(CullingBounds.Num() == (int32)PrimitiveBounds.size());
+	for (int32 View = 0; View < 16; ++View)
+	{
+		const FVector ViewOrigin = RandomPosition();
+		FConvexVolume Frustum;
+		GetViewFrustumBounds(Frustum, FLookAtMatrix(ViewOrigin, ViewOrigin + RandomPosition(), FVector(0.f, 0.f, 1.f)) * FPerspectiveMatrix(PI / 4.f, 16.f, 9.f, 10.f, 50000.f), true);
+
+		FBitArray ScalarVisibility;
+		FrustumCullPrimitivesScalar(PrimitiveBounds, Frustum, ViewOrigin, ScalarVisibility);
+		FBitArray SingleThreadVisibility;
+		FrustumCullPrimitives(CullingBounds, Frustum, ViewOrigin, SingleThreadVisibility, true);
+		FBitArray ParallelVisibility;
+		FrustumCullPrimitives(CullingBounds, Frustum, ViewOrigin, ParallelVisibility);
+
+		TEST_CHECK(SingleThreadVisibility.Num() == ScalarVisibility.Num());
+		TEST_CHECK(SingleThreadVisibility == ScalarVisibility);
+		TEST_CHECK(ParallelVisibility == ScalarVisibility);
+		// the padding past the last primitive never shows up as visible
+		TEST_CHECK(ParallelVisibility.CountSetBits() == ScalarVisibility.CountSetBits());
+	}
+}
+
+IMPLEMENT_TEST(FrustumCull_MatchesScalar)
+{
+	std::mt19937 Random(1234);
+	const int32 PrimitiveCounts[] = { 0, 1, 3, 37, 4096, 10003 };
+	for (const int32 NumPrimitives : PrimitiveCounts)
+	{
+		const float WorldExtent = 500.f * FMath::Pow((float)FMath::Max(NumPrimitives, 1), 1.f / 3.f);
+		std::vector<FPrimitiveBounds> PrimitiveBounds;
+		FPrimitiveCullingBounds CullingBounds;
+		for (int32 Index = 0; Index < NumPrimitives; ++Index)
+		{
+			PrimitiveBounds.push_back(MakeRandomPrimitiveBounds(Random, WorldExtent));
+			CullingBounds.Add(PrimitiveBounds.back());
+		}
+		CheckFrustumCullMatchesScalar(PrimitiveBounds, CullingBounds, Random, WorldExtent);
+	}
+}
+
+IMPLEMENT_TEST(FrustumCull_MatchesScalarAfterRemovals)
+{
+	std::mt19937 Random(1234);
+	const int32 NumPrimitives = 5000;
+	const float WorldExtent = 500.f * FMath::Pow((float)NumPrimitives, 1.f / 3.f);
+	std::vector<FPrimitiveBounds> PrimitiveBounds;
+	FPrimitiveCullingBounds CullingBounds;
+	for (int32 Index = 0; Index < NumPrimitives; ++Index)
+	{
+		PrimitiveBounds.push_back(MakeRandomPrimitiveBounds(Random, WorldExtent));
+		CullingBounds.Add(PrimitiveBounds.back());
+	}
+
+	// removed as FScene removes primitives, the last one moving into the hole, and some bounds updated in place
+	for (int32 Removal = 0; Removal < 1001; ++Removal)
+	{
+		const int32 Index = (int32)(Random() % PrimitiveBounds.size());
+		PrimitiveBounds[Index] = PrimitiveBounds.back();
+		PrimitiveBounds.pop_back();
+		CullingBounds.RemoveAtSwap(Index);
+	}
+	for (int32 Update = 0; Update < 500; ++Update)
+	{
+		const int32 Index = (int32)(Random() % PrimitiveBounds.size());
+		PrimitiveBounds[Index] = MakeRandomPrimitiveBounds(Random, WorldExtent);
+		CullingBounds.Set(Index, PrimitiveBounds[Index]);
+	}
+	CheckFrustumCullMatchesScalar(PrimitiveBounds, CullingBounds, Random, WorldExtent);
+}
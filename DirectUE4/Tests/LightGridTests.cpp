@@ -0,0 +1,109 @@
+#include "TestHarness.h"
+#include "UnrealMath.h"
+#include "LightGridInjection.h"
+
+#include <algorithm>
+#include <random>
+
+/**
+* The clustered light grid of a 1920x1080 view looking down +X against cells whose lights are known, and the parallel,
+* single thread and brute force builds against each other for random point and spot lights.
+*/
+
+static FLightGridView MakeTestLightGridView()
+{
+	// looking down +X, so world X is view depth, Y is right and Z up
+	FLightGridView View;
+	View.ViewMatrix = FLookAtMatrix(FVector(0.f, 0.f, 0.f), FVector(1.f, 0.f, 0.f), FVector(0.f, 0.f, 1.f));
+	View.ProjectionMatrix = FPerspectiveMatrix(PI / 4.f, 16.f, 9.f, 10.f, 50000.f);
+	View.ViewSize = FIntPoint(1920, 1080);
+	View.NearClippingDistance = 10.f;
+	return View;
+}
+
+static FForwardLocalLight MakeTestLight(const FVector& Position, float Radius, uint8 LightType, const FVector& Direction, float OuterConeAngle)
+{
+	FForwardLocalLight Light;
+	FLightParameters& Parameters = Light.Parameters;
+	Parameters.LightPositionAndInvRadius = Vector4(Position, 1.f / Radius);
+	Parameters.LightColorAndFalloffExponent = Vector4(1.f, 1.f, 1.f, 0.f);
+	Parameters.NormalizedLightDirection = -Direction;
+	Parameters.NormalizedLightTangent = FVector(0.f, 0.f, 1.f);
+	Parameters.SpotAngles = LightType == LightType_Spot ? Vector2(FMath::Cos(OuterConeAngle), 1.f) : Vector2(-2.f, 1.f);
+	Parameters.SpecularScale = 1.f;
+	Parameters.LightSourceRadius = 0.f;
+	Parameters.LightSoftSourceRadius = 0.f;
+	Parameters.LightSourceLength = 0.f;
+	Parameters.SourceTexture = nullptr;
+	Light.LightType = LightType;
+	return Light;
+}
+
+static bool IsLightInCell(const FForwardLightingViewResources& LightGrid, int32 X, int32 Y, int32 Z, uint16 LightIndex)
+{
+	const int32 CellIndex = LightGrid.GetCellIndex(X, Y, Z);
+	const uint16* LightIndices = LightGrid.GetCellLightIndices(CellIndex);
+	return std::find(LightIndices, LightIndices + LightGrid.GetNumLightsInCell(CellIndex), LightIndex) != LightIndices + LightGrid.GetNumLightsInCell(CellIndex);
+}
+
+IMPLEMENT_TEST(LightGrid_KnownCells)
+{
+	const FLightGridView View = MakeTestLightGridView();
+
+	// a small point light straight ahead at 1000, and a narrow spot light at 500 pointing away from the camera
+	std::vector<FForwardLocalLight> Lights;
+	Lights.push_back(MakeTestLight(FVector(1000.f, 0.f, 0.f), 50.f, LightType_Point, FVector(1.f, 0.f, 0.f), 0.f));
+	Lights.push_back(MakeTestLight(FVector(500.f, 0.f, 0.f), 2000.f, LightType_Spot, FVector(1.f, 0.f, 0.f), PI / 9.f));
+	FForwardLightingViewResources LightGrid;
+	ComputeLightGrid(View, Lights, LightGrid);
+
+	const FIntVector GridSize = LightGrid.CulledGridSize;
+	TEST_CHECK(LightGrid.NumLocalLights == 2);
+	TEST_CHECK(GridSize.X == 30 && GridSize.Y == 17 && GridSize.Z == GLightGridSizeZ);
+
+	// the point light is in the cells right of and below the screen center at its depth, in no corner cell or other slice
+	const int32 CenterX = View.ViewSize.X / 2 / LightGrid.LightGridPixelSize;
+	const int32 CenterY = View.ViewSize.Y / 2 / LightGrid.LightGridPixelSize;
+	const int32 PointSlice = LightGrid.GetZSlice(1000.f);
+	TEST_CHECK(IsLightInCell(LightGrid, CenterX, CenterY, PointSlice, 0));
+	TEST_CHECK(!IsLightInCell(LightGrid, 0, 0, PointSlice, 0));
+	TEST_CHECK(!IsLightInCell(LightGrid, GridSize.X - 1, GridSize.Y - 1, PointSlice, 0));
+	TEST_CHECK(!IsLightInCell(LightGrid, CenterX, CenterY, PointSlice - 2, 0));
+	TEST_CHECK(!IsLightInCell(LightGrid, CenterX, CenterY, PointSlice + 2, 0));
+
+	// the spot light reaches the center at 1500 but not the left edge, which its sphere would still overlap, nor the near slice behind it
+	const int32 SpotSlice = LightGrid.GetZSlice(1500.f);
+	TEST_CHECK(IsLightInCell(LightGrid, CenterX, CenterY, SpotSlice, 1));
+	TEST_CHECK(!IsLightInCell(LightGrid, 0, CenterY, SpotSlice, 1));
+	TEST_CHECK(!IsLightInCell(LightGrid, CenterX, CenterY, 0, 1));
+}
+
+IMPLEMENT_TEST(LightGrid_MatchesBruteForce)
+{
+	const FLightGridView View = MakeTestLightGridView();
+
+	// lights spread through the frustum up to 20000 ahead, a third of them spot lights, as BenchmarkLightGrid places them
+	std::mt19937 Random(1234);
+	std::uniform_real_distribution<float> Unit(0.f, 1.f);
+	std::vector<FForwardLocalLight> Lights;
+	for (int32 LightIndex = 0; LightIndex < 500; ++LightIndex)
+	{
+		const float Depth = 50.f + 20000.f * Unit(Random) * Unit(Random);
+		const FVector Position(Depth, (Unit(Random) * 2.f - 1.f) * Depth, (Unit(Random) * 2.f - 1.f) * Depth * 9.f / 16.f);
+		const float Radius = 100.f + 900.f * Unit(Random);
+		const FVector Direction = FVector(Unit(Random) * 2.f - 1.f, Unit(Random) * 2.f - 1.f, Unit(Random) * 2.f - 1.f).GetSafeNormal();
+		const uint8 LightType = LightIndex % 3 == 2 ? LightType_Spot : LightType_Point;
+		Lights.push_back(MakeTestLight(Position, Radius, LightType, Direction, PI / 18.f + PI / 3.f * Unit(Random)));
+	}
+
+	FForwardLightingViewResources LightGrids[3];
+	ComputeLightGrid(View, Lights, LightGrids[0]);
+	ComputeLightGrid(View, Lights, LightGrids[1], true);
+	ComputeLightGridBruteForce(View, Lights, LightGrids[2]);
+	TEST_CHECK(!LightGrids[0].CulledLightDataGrid.empty());
+	for (int32 Pass = 1; Pass < 3; ++Pass)
+	{
+		TEST_CHECK(LightGrids[Pass].NumCulledLightsGrid == LightGrids[0].NumCulledLightsGrid);
+		TEST_CHECK(LightGrids[Pass].CulledLightDataGrid == LightGrids[0].CulledLightDataGrid);
+	}
+}
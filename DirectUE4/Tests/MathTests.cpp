@@ -0,0 +1,69 @@
+#include "TestHarness.h"
+#include "UnrealMath.h"
+#include "Transform.h"
+
+/**
+* The parts of the math library animation and skinning lean on, against plain matrix math: FTransform (whichever
+* implementation Transform.h picks) has to compose and convert like the matrices it stands for.
+*/
+
+static FTransform MakeTestTransform(int32 Index)
+{
+	const FVector Axis = FVector(FMath::Cos(Index * 0.7f), 0.5f, FMath::Sin(Index * 1.3f)).GetSafeNormal();
+	const FQuat Rotation(Axis, 0.4f * Index - 1.5f);
+	const FVector Translation(15.f * Index - 40.f, 3.f * Index, -7.f * Index);
+	const FVector Scale(1.f + 0.05f * Index, 1.f + 0.05f * Index, 1.f + 0.05f * Index);
+	return FTransform(Rotation, Translation, Scale);
+}
+
+static void CheckMatricesNear(const FMatrix& A, const FMatrix& B, float Tolerance)
+{
+	for (int32 Row = 0; Row < 4; ++Row)
+	{
+		for (int32 Column = 0; Column < 4; ++Column)
+		{
+			TEST_CHECK_NEAR(A.M[Row][Column], B.M[Row][Column], Tolerance);
+		}
+	}
+}
+
+IMPLEMENT_TEST(Math_TransformComposition)
+{
+	// uniform scale, FTransform only composes exactly like matrices for that
+	for (int32 Index = 0; Index < 16; ++Index)
+	{
+		const FTransform A = MakeTestTransform(Index);
+		const FTransform B = MakeTestTransform(Index + 5);
+		CheckMatricesNear((A * B).ToMatrixWithScale(), A.ToMatrixWithScale() * B.ToMatrixWithScale(), 1e-3f);
+
+		const FVector Position(12.f, -30.f, 7.5f);
+		const FVector Transformed = A.TransformPosition(Position);
+		const Vector4 MatrixTransformed = A.ToMatrixWithScale().TransformPosition(Position);
+		TEST_CHECK_NEAR(Transformed.X, MatrixTransformed.X, 1e-3f);
+		TEST_CHECK_NEAR(Transformed.Y, MatrixTransformed.Y, 1e-3f);
+		TEST_CHECK_NEAR(Transformed.Z, MatrixTransformed.Z, 1e-3f);
+
+		// a transform times its inverse is the identity
+		CheckMatricesNear((A * A.Inverse()).ToMatrixWithScale(), FMatrix::Identity, 1e-4f);
+	}
+}
+
+IMPLEMENT_TEST(Math_QuatMatrixRoundTrip)
+{
+	for (int32 Index = 0; Index < 64; ++Index)
+	{
+		const FQuat Source = MakeTestTransform(Index).GetRotation();
+		const FQuat RoundTrip(FTransform(Source).ToMatrixWithScale());
+
+		// q and -q are the same rotation
+		const float Dot = Source.X * RoundTrip.X + Source.Y * RoundTrip.Y + Source.Z * RoundTrip.Z + Source.W * RoundTrip.W;
+		TEST_CHECK_NEAR(FMath::Abs(Dot), 1.f, 1e-5f);
+
+		const FVector Vector(1.f, 2.f, 3.f);
+		const FVector Rotated = Source.RotateVector(Vector);
+		const FVector RoundTripRotated = RoundTrip.RotateVector(Vector);
+		TEST_CHECK_NEAR(Rotated.X, RoundTripRotated.X, 1e-4f);
+		TEST_CHECK_NEAR(Rotated.Y, RoundTripRotated.Y, 1e-4f);
+		TEST_CHECK_NEAR(Rotated.Z, RoundTripRotated.Z, 1e-4f);
+	}
+}
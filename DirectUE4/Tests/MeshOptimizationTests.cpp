@@ -0,0 +1,179 @@
+#include "TestHarness.h"
+#include "UnrealMath.h"
+#include "MeshOptimization.h"
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+/**
+* The FIFO cache simulation against a hand counted index buffer, and the index and vertex buffer optimizations of a
+* shuffled grid: the cache order lowers its miss ratio, the overdraw order only moves whole triangles and keeps the miss
+* ratio within its threshold, and the fetch remap numbers vertices by first use and drops the unused ones.
+*/
+
+/** A grid of NumQuads x NumQuads quads in the XY plane facing +Z, its triangles in random order */
+static void MakeShuffledGrid(int32 NumQuads, std::vector<FVector>& OutPositions, std::vector<uint32>& OutIndices)
+{
+	OutPositions.clear();
+	for (int32 Y = 0; Y <= NumQuads; ++Y)
+	{
+		for (int32 X = 0; X <= NumQuads; ++X)
+		{
+			OutPositions.push_back(FVector((float)X, (float)Y, 0.f) * 10.f);
+		}
+	}
+	std::vector<std::array<uint32, 3>> Triangles;
+	for (int32 Y = 0; Y < NumQuads; ++Y)
+	{
+		for (int32 X = 0; X < NumQuads; ++X)
+		{
+			const uint32 V00 = Y * (NumQuads + 1) + X;
+			const uint32 V01 = V00 + 1;
+			const uint32 V10 = V00 + NumQuads + 1;
+			const uint32 V11 = V10 + 1;
+			Triangles.push_back({ { V00, V01, V11 } });
+			Triangles.push_back({ { V00, V11, V10 } });
+		}
+	}
+	std::mt19937 Random(1234);
+	std::shuffle(Triangles.begin(), Triangles.end(), Random);
+	OutIndices.clear();
+	for (const std::array<uint32, 3>& Triangle : Triangles)
+	{
+		OutIndices.insert(OutIndices.end(), Triangle.begin(), Triangle.end());
+	}
+}
+
+/** The triangles of Indices, sorted, to compare index buffers as multisets of triangles with their winding */
+static std::vector<std::array<uint32, 3>> GetSortedTriangles(const std::vector<uint32>& Indices)
+{
+	std::vector<std::array<uint32, 3>> Triangles;
+	for (size_t Index = 0; Index + 2 < Indices.size(); Index += 3)
+	{
+		Triangles.push_back({ { Indices[Index], Indices[Index + 1], Indices[Index + 2] } });
+	}
+	std::sort(Triangles.begin(), Triangles.end());
+	return Triangles;
+}
+
+static float GetACMR(const std::vector<uint32>& Indices, uint32 NumVertices)
+{
+	return MeshOptimization::AnalyzeVertexCache(Indices.data(), (uint32)Indices.size(), NumVertices).GetACMR();
+}
+
+IMPLEMENT_TEST(MeshOptimization_AnalyzeVertexCache)
+{
+	// with 4 entries: 0 1 2 miss, 2 1 hit and 3 misses, 0 3 hit and 4 pushes 0 out, 5 6 push 1 and 2 out, so 0 misses again
+	const uint32 Indices[] = { 0, 1, 2, 2, 1, 3, 0, 3, 4, 5, 6, 0 };
+	const FVertexCacheStatistics Statistics = MeshOptimization::AnalyzeVertexCache(Indices, 12, 8, 4);
+	TEST_CHECK(Statistics.NumTriangles == 4);
+	TEST_CHECK(Statistics.NumVerticesUsed == 7);
+	TEST_CHECK(Statistics.NumTransformedVertices == 8);
+	TEST_CHECK_NEAR(Statistics.GetACMR(), 2.0, 1e-6);
+	TEST_CHECK_NEAR(Statistics.GetATVR(), 8.0 / 7.0, 1e-6);
+
+	// a cache as large as the mesh transforms every vertex once
+	const FVertexCacheStatistics LargeCache = MeshOptimization::AnalyzeVertexCache(Indices, 12, 8, 8);
+	TEST_CHECK(LargeCache.NumTransformedVertices == 7);
+}
+
+IMPLEMENT_TEST(MeshOptimization_OptimizeVertexCache)
+{
+	std::vector<FVector> Positions;
+	std::vector<uint32> Indices;
+	MakeShuffledGrid(32, Positions, Indices);
+	const uint32 NumVertices = (uint32)Positions.size();
+	const std::vector<std::array<uint32, 3>> SourceTriangles = GetSortedTriangles(Indices);
+
+	const float ShuffledACMR = GetACMR(Indices, NumVertices);
+	MeshOptimization::OptimizeVertexCache(Indices.data(), (uint32)Indices.size(), NumVertices);
+	const float OptimizedACMR = GetACMR(Indices, NumVertices);
+
+	// a shuffled grid misses almost every vertex, a cache friendly order of a grid gets well under one miss per triangle
+	TEST_CHECK(ShuffledACMR > 2.f);
+	TEST_CHECK(OptimizedACMR < 0.8f);
+	TEST_CHECK(GetSortedTriangles(Indices) == SourceTriangles);
+}
+
+IMPLEMENT_TEST(MeshOptimization_OptimizeOverdraw)
+{
+	std::vector<FVector> Positions;
+	std::vector<uint32> Indices;
+	MakeShuffledGrid(32, Positions, Indices);
+	const uint32 NumVertices = (uint32)Positions.size();
+	// a second grid folded up the X axis, so the clusters face different ways and the reorder has something to sort
+	const uint32 NumGridIndices = (uint32)Indices.size();
+	for (uint32 Index = 0; Index < NumGridIndices; Index += 3)
+	{
+		Indices.push_back(Indices[Index] + NumVertices);
+		Indices.push_back(Indices[Index + 2] + NumVertices);
+		Indices.push_back(Indices[Index + 1] + NumVertices);
+	}
+	for (uint32 Vertex = 0; Vertex < NumVertices; ++Vertex)
+	{
+		Positions.push_back(FVector(Positions[Vertex].X, 0.f, Positions[Vertex].Y));
+	}
+	const uint32 NumAllVertices = (uint32)Positions.size();
+
+	MeshOptimization::OptimizeVertexCache(Indices.data(), (uint32)Indices.size(), NumAllVertices);
+	const std::vector<std::array<uint32, 3>> SourceTriangles = GetSortedTriangles(Indices);
+	const float CacheACMR = GetACMR(Indices, NumAllVertices);
+
+	const float Threshold = 1.05f;
+	MeshOptimization::OptimizeOverdraw(Indices.data(), (uint32)Indices.size(), Positions.data(), NumAllVertices, Threshold);
+
+	// clusters move as a whole, so every triangle is still there with its winding, and each cluster keeps its miss ratio
+	TEST_CHECK(GetSortedTriangles(Indices) == SourceTriangles);
+	TEST_CHECK(GetACMR(Indices, NumAllVertices) <= CacheACMR * Threshold + 1e-4f);
+}
+
+IMPLEMENT_TEST(MeshOptimization_OptimizeVertexFetchRemap)
+{
+	std::vector<FVector> Positions;
+	std::vector<uint32> Indices;
+	MakeShuffledGrid(16, Positions, Indices);
+
+	// every third vertex of a larger stream is never referenced
+	std::vector<FVector> SparsePositions;
+	std::vector<uint32> SparseIndexOf;
+	for (const FVector& Position : Positions)
+	{
+		if (SparsePositions.size() % 3 == 2)
+		{
+			SparsePositions.push_back(FVector(-1.f));
+		}
+		SparseIndexOf.push_back((uint32)SparsePositions.size());
+		SparsePositions.push_back(Position);
+	}
+	for (uint32& Index : Indices)
+	{
+		Index = SparseIndexOf[Index];
+	}
+	const std::vector<uint32> SourceIndices = Indices;
+	const uint32 NumSparseVertices = (uint32)SparsePositions.size();
+	const std::vector<FVector> SourcePositions = SparsePositions;
+
+	std::vector<int32> Remap;
+	const uint32 NumNewVertices = MeshOptimization::OptimizeVertexFetchRemap(Indices.data(), (uint32)Indices.size(), NumSparseVertices, Remap);
+	MeshOptimization::RemapVertexStream(SparsePositions, 1, Remap, NumNewVertices);
+
+	TEST_CHECK(NumNewVertices == (uint32)Positions.size());
+	TEST_CHECK(SparsePositions.size() == Positions.size());
+	TEST_CHECK(Remap.size() == NumSparseVertices);
+	for (uint32 Vertex = 0; Vertex < NumSparseVertices; ++Vertex)
+	{
+		TEST_CHECK((Remap[Vertex] == INDEX_NONE) == (SourcePositions[Vertex] == FVector(-1.f)));
+	}
+
+	// the indices still name the same positions, and every new vertex first shows up right after the ones before it
+	uint32 NextNewVertex = 0;
+	for (size_t Index = 0; Index < Indices.size(); ++Index)
+	{
+		TEST_CHECK(Indices[Index] < NumNewVertices);
+		TEST_CHECK(Indices[Index] <= NextNewVertex);
+		NextNewVertex = FMath::Max(NextNewVertex, Indices[Index] + 1);
+		TEST_CHECK(SparsePositions[Indices[Index]] == SourcePositions[SourceIndices[Index]]);
+	}
+	TEST_CHECK(NextNewVertex == NumNewVertices);
+}
@@ -0,0 +1,162 @@
+#include "TestHarness.h"
+#include "UnrealMath.h"
+#include "ConvexVolume.h"
+#include "GenericOctree.h"
+
+#include <algorithm>
+#include <random>
+
+/**
+* TOctree with the scene's leaf, merge and depth limits against walking every element: ids have to keep finding their
+* elements through add, move and remove churn, and box, sphere and frustum queries have to find exactly the elements
+* whose bounds pass the same test.
+*/
+
+struct FTestOctreeElement
+{
+	FBoxSphereBounds Bounds;
+	int32 Index;
+	FOctreeElementId* Ids;
+};
+
+struct FTestOctreeSemantics
+{
+	// FPrimitiveOctreeSemantics
+	enum { MaxElementsPerLeaf = 16 };
+	enum { MinInclusiveElementsPerNode = 7 };
+	enum { MaxNodeDepth = 12 };
+
+	static const FBoxSphereBounds& GetBounds(const FTestOctreeElement& Element)
+	{
+		return Element.Bounds;
+	}
+
+	static void SetElementId(const FTestOctreeElement& Element, FOctreeElementId Id)
+	{
+		Element.Ids[Element.Index] = Id;
+	}
+};
+
+typedef TOctree<FTestOctreeElement, FTestOctreeSemantics> FTestOctree;
+
+IMPLEMENT_TEST(Octree_ChurnAndQueries)
+{
+	const int32 NumElements = 5000;
+	std::mt19937 Random(1234);
+	std::uniform_real_distribution<float> Unit(0.f, 1.f);
+	const float WorldExtent = 500.f * FMath::Pow((float)NumElements, 1.f / 3.f);
+	auto RandomPosition = [&]()
+	{
+		return FVector(Unit(Random) * 2.f - 1.f, Unit(Random) * 2.f - 1.f, Unit(Random) * 2.f - 1.f) * WorldExtent;
+	};
+	auto RandomBounds = [&]()
+	{
+		// mostly props, a few buildings large enough to stay in the upper nodes
+		const float Radius = Unit(Random) < 0.01f ? 2000.f + 8000.f * Unit(Random) : 10.f * FMath::Pow(20.f, Unit(Random));
+		const FVector Extent = FVector(0.3f + 0.7f * Unit(Random), 0.3f + 0.7f * Unit(Random), 0.3f + 0.7f * Unit(Random)) * Radius;
+		return FBoxSphereBounds(RandomPosition(), Extent, Extent.Size());
+	};
+
+	std::vector<FOctreeElementId> Ids(NumElements);
+	std::vector<FTestOctreeElement> Elements(NumElements);
+	// HALF_WORLD_MAX, the root cell of the scene's octree
+	FTestOctree Octree(FVector::ZeroVector, 1048576.f);
+	for (int32 Index = 0; Index < NumElements; ++Index)
+	{
+		Elements[Index] = { RandomBounds(), Index, Ids.data() };
+		Octree.AddElement(Elements[Index]);
+	}
+
+	auto CheckIds = [&](int32 ExpectedNumElements)
+	{
+		TEST_CHECK(Octree.GetNumElements() == ExpectedNumElements);
+		int32 NumWrong = 0;
+		for (int32 Index = 0; Index < NumElements; ++Index)
+		{
+			if (Ids[Index].IsValidId())
+			{
+				const FTestOctreeElement& Element = Octree.GetElementById(Ids[Index]);
+				NumWrong += Element.Index == Index && Element.Bounds == Elements[Index].Bounds ? 0 : 1;
+			}
+		}
+		TEST_CHECK(NumWrong == 0);
+	};
+	CheckIds(NumElements);
+
+	// moves are a remove and an add, as UpdatePrimitiveTransform_RenderThread does them
+	for (int32 Move = 0; Move < NumElements; ++Move)
+	{
+		const int32 Index = Random() % NumElements;
+		Octree.RemoveElement(Ids[Index]);
+		Elements[Index].Bounds.Origin += FVector(Unit(Random) * 2.f - 1.f, Unit(Random) * 2.f - 1.f, Unit(Random) * 2.f - 1.f) * 200.f;
+		Octree.AddElement(Elements[Index]);
+	}
+	CheckIds(NumElements);
+
+	// removing most elements merges the nodes they split
+	std::vector<int32> Order(NumElements);
+	for (int32 Index = 0; Index < NumElements; ++Index)
+	{
+		Order[Index] = Index;
+	}
+	std::shuffle(Order.begin(), Order.end(), Random);
+	Order.resize(NumElements * 9 / 10);
+	for (const int32 Index : Order)
+	{
+		Octree.RemoveElement(Ids[Index]);
+		Ids[Index] = FOctreeElementId();
+	}
+	CheckIds(NumElements - (int32)Order.size());
+	for (const int32 Index : Order)
+	{
+		Elements[Index].Bounds = RandomBounds();
+		Octree.AddElement(Elements[Index]);
+	}
+	CheckIds(NumElements);
+
+	for (int32 Query = 0; Query < 64; ++Query)
+	{
+		const FVector Center = RandomPosition();
+		const FBox Box = FBox(Center, Center).ExpandBy(500.f + 1500.f * Unit(Random));
+		const float SphereRadius = 2000.f + 3000.f * Unit(Random);
+		FConvexVolume Frustum;
+		GetViewFrustumBounds(Frustum, FLookAtMatrix(Center, Center + RandomPosition(), FVector(0.f, 0.f, 1.f)) * FPerspectiveMatrix(PI / 4.f, 16.f, 9.f, 10.f, 20000.f), true);
+
+		std::vector<int32> Found[3];
+		auto Collect = [&Found](int32 QueryType)
+		{
+			return [&Found, QueryType](const FTestOctreeElement& Element) { Found[QueryType].push_back(Element.Index); };
+		};
+		Octree.FindElementsWithBoundsTest(Box, Collect(0));
+		Octree.FindElementsInSphere(Center, SphereRadius, Collect(1));
+		Octree.FindElementsInConvexVolume(Frustum, Collect(2));
+
+		const FVector BoxCenter = Box.GetCenter();
+		const FVector BoxExtent = Box.GetExtent();
+		std::vector<int32> Expected[3];
+		for (const FTestOctreeElement& Element : Elements)
+		{
+			const FBoxSphereBounds& Bounds = Element.Bounds;
+			if (FMath::Abs(Bounds.Origin.X - BoxCenter.X) <= Bounds.BoxExtent.X + BoxExtent.X
+				&& FMath::Abs(Bounds.Origin.Y - BoxCenter.Y) <= Bounds.BoxExtent.Y + BoxExtent.Y
+				&& FMath::Abs(Bounds.Origin.Z - BoxCenter.Z) <= Bounds.BoxExtent.Z + BoxExtent.Z)
+			{
+				Expected[0].push_back(Element.Index);
+			}
+			if (ComputeSquaredDistanceFromBoxToPoint(Bounds.Origin - Bounds.BoxExtent, Bounds.Origin + Bounds.BoxExtent, Center) <= FMath::Square(SphereRadius))
+			{
+				Expected[1].push_back(Element.Index);
+			}
+			if (Frustum.IntersectBox(Bounds.Origin, Bounds.BoxExtent))
+			{
+				Expected[2].push_back(Element.Index);
+			}
+		}
+
+		for (int32 QueryType = 0; QueryType < 3; ++QueryType)
+		{
+			std::sort(Found[QueryType].begin(), Found[QueryType].end());
+			TEST_CHECK(Found[QueryType] == Expected[QueryType]);
+		}
+	}
+}
@@ -0,0 +1,60 @@
+#include "TestHarness.h"
+#include "ParallelFor.h"
+
+IMPLEMENT_TEST(ParallelFor_EveryIndexOnce)
+{
+	for (int Num : { 1, 2, 7, 100, 10007 })
+	{
+		std::vector<std::atomic<int>> Calls(Num);
+		ParallelFor(Num, [&](int Index)
+		{
+			Calls[Index].fetch_add(1);
+		});
+
+		int NumWrong = 0;
+		for (int Index = 0; Index < Num; ++Index)
+		{
+			NumWrong += Calls[Index].load() == 1 ? 0 : 1;
+		}
+		TEST_CHECK(NumWrong == 0);
+	}
+}
+
+IMPLEMENT_TEST(ParallelFor_RepeatedCalls)
+{
+	// the pool is reused across calls, none of them may lose or repeat work
+	std::atomic<int> Sum(0);
+	for (int Call = 0; Call < 2000; ++Call)
+	{
+		ParallelFor(16, [&](int Index)
+		{
+			Sum.fetch_add(Index);
+		});
+	}
+	TEST_CHECK(Sum.load() == 2000 * (15 * 16 / 2));
+}
+
+IMPLEMENT_TEST(ParallelFor_Nested)
+{
+	// every outer body waits on an inner ParallelFor while the workers are busy with the outer one
+	std::atomic<int> NumInnerCalls(0);
+	ParallelFor(64, [&](int)
+	{
+		ParallelFor(64, [&](int)
+		{
+			NumInnerCalls.fetch_add(1);
+		});
+	});
+	TEST_CHECK(NumInnerCalls.load() == 64 * 64);
+}
+
+IMPLEMENT_TEST(ParallelFor_ForceSingleThread)
+{
+	const std::thread::id CallingThread = std::this_thread::get_id();
+	int NumOtherThreads = 0;
+	ParallelFor(1000, [&](int)
+	{
+		NumOtherThreads += std::this_thread::get_id() == CallingThread ? 0 : 1;
+	}, true);
+	TEST_CHECK(NumOtherThreads == 0);
+}
@@ -0,0 +1,332 @@
+#include "TestHarness.h"
+#include "UnrealMath.h"
+#include "UnrealTemplates.h"
+#include "SkeletalMeshTools.h"
+#include "MeshDescriptionOperations.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+
+/**
+* The chunks BuildSkeletalMeshChunks and ChunkSkinnedVertices build go straight into the sections, vertices and indices of
+* FSkeletalMeshLODModel, so they have to stay identical to what the original serial build made of the same wedges. That
+* build, a Z sorted overlap search and one pass over the faces, is kept below as the reference.
+*/
+
+// MeshDescriptionOperations.cpp isn't linked into the tests
+bool GParallelMeshBuild = true;
+
+static void BuildSkeletalMeshChunksReference(const std::vector<FMeshFace>& Faces, const std::vector<FSoftSkinBuildVertex>& RawVertices, const FOverlappingThresholds& OverlappingThresholds, std::vector<FSkinnedMeshChunk*>& OutChunks)
+{
+	std::vector<std::pair<float, int32>> ZAndIndex;
+	for (int32 Index = 0; Index < (int32)RawVertices.size(); ++Index)
+	{
+		ZAndIndex.push_back(std::make_pair(RawVertices[Index].Position.Z, Index));
+	}
+	std::sort(ZAndIndex.begin(), ZAndIndex.end(), [](const std::pair<float, int32>& A, const std::pair<float, int32>& B) { return A.first < B.first; });
+
+	std::multimap<int32, int32> RawVerts2Dupes;
+	for (size_t i = 0; i < ZAndIndex.size(); i++)
+	{
+		for (size_t j = i + 1; j < ZAndIndex.size(); j++)
+		{
+			if (FMath::Abs(ZAndIndex[j].first - ZAndIndex[i].first) > OverlappingThresholds.ThresholdPosition)
+			{
+				break;
+			}
+			if (PointsEqual(RawVertices[ZAndIndex[i].second].Position, RawVertices[ZAndIndex[j].second].Position, OverlappingThresholds))
+			{
+				RawVerts2Dupes.insert(std::make_pair(ZAndIndex[i].second, ZAndIndex[j].second));
+				RawVerts2Dupes.insert(std::make_pair(ZAndIndex[j].second, ZAndIndex[i].second));
+			}
+		}
+	}
+
+	std::map<FSkinnedMeshChunk*, std::map<int32, int32>> ChunkToFinalVerts;
+	std::vector<int32> DupVerts;
+	for (uint32 FaceIndex = 0; FaceIndex < Faces.size(); FaceIndex++)
+	{
+		FSkinnedMeshChunk* Chunk = nullptr;
+		for (FSkinnedMeshChunk* OutChunk : OutChunks)
+		{
+			if (OutChunk->MaterialIndex == Faces[FaceIndex].MeshMaterialIndex)
+			{
+				Chunk = OutChunk;
+				break;
+			}
+		}
+		if (Chunk == nullptr)
+		{
+			Chunk = new FSkinnedMeshChunk();
+			Chunk->MaterialIndex = Faces[FaceIndex].MeshMaterialIndex;
+			Chunk->OriginalSectionIndex = (int32)OutChunks.size();
+			OutChunks.push_back(Chunk);
+		}
+		std::map<int32, int32>& FinalVerts = ChunkToFinalVerts[Chunk];
+
+		uint32 TriangleIndices[3];
+		for (int32 Corner = 0; Corner < 3; ++Corner)
+		{
+			const int32 WedgeIndex = FaceIndex * 3 + Corner;
+			const FSoftSkinBuildVertex& Vertex = RawVertices[WedgeIndex];
+
+			DupVerts.clear();
+			auto Range = RawVerts2Dupes.equal_range(WedgeIndex);
+			for (auto It = Range.first; It != Range.second; ++It)
+			{
+				DupVerts.push_back(It->second);
+			}
+			std::sort(DupVerts.begin(), DupVerts.end());
+
+			int32 FinalVertIndex = -1;
+			for (size_t k = 0; k < DupVerts.size() && DupVerts[k] < WedgeIndex; k++)
+			{
+				auto It = FinalVerts.find(DupVerts[k]);
+				if (It != FinalVerts.end() && SkeletalMeshTools::AreSkelMeshVerticesEqual(Vertex, Chunk->Vertices[It->second], OverlappingThresholds))
+				{
+					FinalVertIndex = It->second;
+					break;
+				}
+			}
+			if (FinalVertIndex == -1)
+			{
+				Chunk->Vertices.push_back(Vertex);
+				FinalVertIndex = (int32)Chunk->Vertices.size() - 1;
+				FinalVerts.insert(std::make_pair(WedgeIndex, FinalVertIndex));
+			}
+			TriangleIndices[Corner] = (uint32)FinalVertIndex;
+		}
+
+		if (TriangleIndices[0] != TriangleIndices[1] && TriangleIndices[0] != TriangleIndices[2] && TriangleIndices[1] != TriangleIndices[2])
+		{
+			Chunk->Indices.insert(Chunk->Indices.end(), TriangleIndices, TriangleIndices + 3);
+		}
+	}
+}
+
+static void ChunkSkinnedVerticesReference(std::vector<FSkinnedMeshChunk*>& Chunks, int32 MaxBonesPerChunk)
+{
+	std::vector<FSkinnedMeshChunk*> SrcChunks;
+	Exchange(Chunks, SrcChunks);
+	std::sort(SrcChunks.begin(), SrcChunks.end(), [](const FSkinnedMeshChunk* A, const FSkinnedMeshChunk* B) { return A->MaterialIndex < B->MaterialIndex; });
+
+	std::vector<std::vector<int32>> IndexMaps;
+	std::vector<FBoneIndexType> UniqueBones;
+	for (FSkinnedMeshChunk* SrcChunk : SrcChunks)
+	{
+		const uint32 FirstChunkIndex = (uint32)Chunks.size();
+		for (uint32 i = 0; i < SrcChunk->Indices.size(); i += 3)
+		{
+			UniqueBones.clear();
+			for (int32 Corner = 0; Corner < 3; Corner++)
+			{
+				const FSoftSkinBuildVertex& V = SrcChunk->Vertices[SrcChunk->Indices[i + Corner]];
+				for (int32 InfluenceIndex = 0; InfluenceIndex < MAX_TOTAL_INFLUENCES; InfluenceIndex++)
+				{
+					if (V.InfluenceWeights[InfluenceIndex] > 0)
+					{
+						AddUnique(UniqueBones, V.InfluenceBones[InfluenceIndex]);
+					}
+				}
+			}
+
+			FSkinnedMeshChunk* DestChunk = nullptr;
+			uint32 DestChunkIndex = FirstChunkIndex;
+			for (; DestChunkIndex < Chunks.size(); ++DestChunkIndex)
+			{
+				const std::vector<FBoneIndexType>& BoneMap = Chunks[DestChunkIndex]->BoneMap;
+				int32 NumUniqueBones = 0;
+				for (FBoneIndexType Bone : UniqueBones)
+				{
+					NumUniqueBones += Contains(BoneMap, Bone) ? 0 : 1;
+				}
+				if (NumUniqueBones + (int32)BoneMap.size() <= MaxBonesPerChunk)
+				{
+					DestChunk = Chunks[DestChunkIndex];
+					break;
+				}
+			}
+			if (DestChunk == nullptr)
+			{
+				DestChunk = new FSkinnedMeshChunk();
+				Chunks.push_back(DestChunk);
+				DestChunk->MaterialIndex = SrcChunk->MaterialIndex;
+				DestChunk->OriginalSectionIndex = SrcChunk->OriginalSectionIndex;
+				IndexMaps.push_back(std::vector<int32>(SrcChunk->Vertices.size(), INDEX_NONE));
+			}
+			std::vector<int32>& IndexMap = IndexMaps[DestChunkIndex];
+
+			for (FBoneIndexType Bone : UniqueBones)
+			{
+				AddUnique(DestChunk->BoneMap, Bone);
+			}
+			for (int32 Corner = 0; Corner < 3; Corner++)
+			{
+				const int32 VertexIndex = SrcChunk->Indices[i + Corner];
+				int32 DestIndex = IndexMap[VertexIndex];
+				if (DestIndex == INDEX_NONE)
+				{
+					DestChunk->Vertices.push_back(SrcChunk->Vertices[VertexIndex]);
+					DestIndex = (int32)DestChunk->Vertices.size() - 1;
+					FSoftSkinBuildVertex& V = DestChunk->Vertices[DestIndex];
+					for (int32 InfluenceIndex = 0; InfluenceIndex < MAX_TOTAL_INFLUENCES; InfluenceIndex++)
+					{
+						if (V.InfluenceWeights[InfluenceIndex] > 0)
+						{
+							V.InfluenceBones[InfluenceIndex] = (FBoneIndexType)Find(DestChunk->BoneMap, V.InfluenceBones[InfluenceIndex]);
+						}
+					}
+					IndexMap[VertexIndex] = DestIndex;
+				}
+				DestChunk->Indices.push_back(DestIndex);
+			}
+		}
+		delete SrcChunk;
+	}
+}
+
+/**
+* A bumpy grid of quads over three materials. Neighbouring corners share positions, some only within the threshold so
+* equality isn't transitive, hard edges split normals, UV seams split UVs and the influences vary across the grid so the
+* bone limit splits chunks. Every corner is a raw vertex of its own, as the FBX import makes them.
+*/
+static void MakeTestMesh(int32 GridSize, uint32 Seed, std::vector<FMeshFace>& OutFaces, std::vector<FSoftSkinBuildVertex>& OutRawVertices)
+{
+	std::mt19937 Random(Seed);
+	std::uniform_int_distribution<int32> Percent(0, 99);
+	std::uniform_real_distribution<float> Jitter(-0.95f, 0.95f);
+	const float Threshold = THRESH_POINTS_ARE_SAME;
+
+	auto MakeCorner = [&](int32 X, int32 Y, int32 FaceIndex)
+	{
+		FSoftSkinBuildVertex Vertex;
+		memset(&Vertex, 0, sizeof(Vertex));
+		Vertex.Position = FVector(X * 10.f, Y * 10.f, FMath::Sin(X * 0.3f) * FMath::Cos(Y * 0.2f) * 25.f);
+		// within the threshold of the exact position, so two jittered copies may still be apart
+		if (Percent(Random) < 70)
+		{
+			Vertex.Position += FVector(Jitter(Random), Jitter(Random), Jitter(Random)) * Threshold;
+		}
+		Vertex.TangentZ = FVector(0.f, 0.f, 1.f);
+		if (Percent(Random) < 10)
+		{
+			Vertex.TangentZ = FVector(0.f, FaceIndex & 1 ? 1.f : -1.f, 0.f);
+		}
+		Vertex.TangentX = FVector(1.f, 0.f, 0.f);
+		Vertex.TangentY = FVector(0.f, 1.f, 0.f);
+		Vertex.UVs[0] = Vector2(X / (float)GridSize, Y / (float)GridSize);
+		if (X == GridSize / 2 && (FaceIndex & 1))
+		{
+			Vertex.UVs[0].X += 0.25f;
+		}
+		Vertex.Color = FColor(255, 255, 255, 255);
+		Vertex.InfluenceBones[0] = (FBoneIndexType)((X / 3) * 7 + Y / 3) % 90;
+		Vertex.InfluenceBones[1] = (FBoneIndexType)(Vertex.InfluenceBones[0] + 1);
+		Vertex.InfluenceWeights[0] = (uint8)(128 + (X + Y) % 100);
+		Vertex.InfluenceWeights[1] = (uint8)(255 - Vertex.InfluenceWeights[0]);
+		Vertex.PointWedgeIdx = (uint32)OutRawVertices.size();
+		return Vertex;
+	};
+
+	for (int32 Y = 0; Y < GridSize; ++Y)
+	{
+		for (int32 X = 0; X < GridSize; ++X)
+		{
+			const int32 Corners[2][3][2] = { { { X, Y }, { X + 1, Y }, { X + 1, Y + 1 } }, { { X, Y }, { X + 1, Y + 1 }, { X, Y + 1 } } };
+			for (int32 Triangle = 0; Triangle < 2; ++Triangle)
+			{
+				FMeshFace Face;
+				memset(&Face, 0, sizeof(Face));
+				Face.MeshMaterialIndex = (uint16)(X * 3 / GridSize);
+				const int32 FaceIndex = (int32)OutFaces.size();
+				for (int32 Corner = 0; Corner < 3; ++Corner)
+				{
+					Face.iWedge[Corner] = (uint32)OutRawVertices.size();
+					OutRawVertices.push_back(MakeCorner(Corners[Triangle][Corner][0], Corners[Triangle][Corner][1], FaceIndex));
+				}
+				// now and then a sliver that welds down to a line and is dropped
+				if (Percent(Random) < 2)
+				{
+					OutRawVertices.back() = OutRawVertices[OutRawVertices.size() - 2];
+				}
+				OutFaces.push_back(Face);
+			}
+		}
+	}
+}
+
+static bool AreChunksIdentical(const std::vector<FSkinnedMeshChunk*>& A, const std::vector<FSkinnedMeshChunk*>& B)
+{
+	if (A.size() != B.size())
+	{
+		return false;
+	}
+	for (size_t ChunkIndex = 0; ChunkIndex < A.size(); ++ChunkIndex)
+	{
+		const FSkinnedMeshChunk& ChunkA = *A[ChunkIndex];
+		const FSkinnedMeshChunk& ChunkB = *B[ChunkIndex];
+		if (ChunkA.MaterialIndex != ChunkB.MaterialIndex || ChunkA.OriginalSectionIndex != ChunkB.OriginalSectionIndex
+			|| ChunkA.Indices != ChunkB.Indices || ChunkA.BoneMap != ChunkB.BoneMap || ChunkA.Vertices.size() != ChunkB.Vertices.size())
+		{
+			return false;
+		}
+		for (size_t VertexIndex = 0; VertexIndex < ChunkA.Vertices.size(); ++VertexIndex)
+		{
+			const FSoftSkinBuildVertex& VA = ChunkA.Vertices[VertexIndex];
+			const FSoftSkinBuildVertex& VB = ChunkB.Vertices[VertexIndex];
+			if (VA.PointWedgeIdx != VB.PointWedgeIdx || memcmp(&VA.Position, &VB.Position, sizeof(FVector)) != 0
+				|| memcmp(VA.InfluenceBones, VB.InfluenceBones, sizeof(VA.InfluenceBones)) != 0
+				|| memcmp(VA.InfluenceWeights, VB.InfluenceWeights, sizeof(VA.InfluenceWeights)) != 0)
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static void DeleteChunks(std::vector<FSkinnedMeshChunk*>& Chunks)
+{
+	for (FSkinnedMeshChunk* Chunk : Chunks)
+	{
+		delete Chunk;
+	}
+	Chunks.clear();
+}
+
+IMPLEMENT_TEST(SkeletalMeshChunks_MatchReferenceBuild)
+{
+	const FOverlappingThresholds Thresholds;
+	for (uint32 Seed = 1; Seed <= 4; ++Seed)
+	{
+		std::vector<FMeshFace> Faces;
+		std::vector<FSoftSkinBuildVertex> RawVertices;
+		MakeTestMesh(40, Seed, Faces, RawVertices);
+
+		std::vector<FSkinnedMeshChunk*> ReferenceSplitChunks;
+		BuildSkeletalMeshChunksReference(Faces, RawVertices, Thresholds, ReferenceSplitChunks);
+		ChunkSkinnedVerticesReference(ReferenceSplitChunks, 12);
+
+		for (bool bParallel : { true, false })
+		{
+			GParallelMeshBuild = bParallel;
+			std::vector<FSkinnedMeshChunk*> Chunks;
+			bool bTooManyVerts = false;
+			SkeletalMeshTools::BuildSkeletalMeshChunks(Faces, RawVertices, Thresholds, Chunks, bTooManyVerts);
+
+			// ChunkSkinnedVertices consumes its input, so compare before splitting against a fresh reference
+			std::vector<FSkinnedMeshChunk*> UnsplitReference;
+			BuildSkeletalMeshChunksReference(Faces, RawVertices, Thresholds, UnsplitReference);
+			TEST_CHECK(AreChunksIdentical(Chunks, UnsplitReference));
+			DeleteChunks(UnsplitReference);
+
+			SkeletalMeshTools::ChunkSkinnedVertices(Chunks, 12);
+			TEST_CHECK(Chunks.size() > 3);
+			TEST_CHECK(AreChunksIdentical(Chunks, ReferenceSplitChunks));
+			DeleteChunks(Chunks);
+		}
+		GParallelMeshBuild = true;
+		DeleteChunks(ReferenceSplitChunks);
+	}
+}
@@ -0,0 +1,191 @@
+#include "TestHarness.h"
+#include "UnrealMath.h"
+#include "ConvexVolume.h"
+#include "SoftwareOcclusionBuffer.h"
+
+#include <random>
+
+/**
+ * The software occlusion buffer has to be conservative: a pixel may only hold depth where occluders cover all of it, no
+ * nearer than the farthest occluder over it, so a box it reports occluded cannot have any point in sight of the eye.
+ */
+
+static FMatrix MakeTestViewProjection(const FVector& ViewOrigin, float Yaw)
+{
+	return FLookAtMatrix(ViewOrigin, ViewOrigin + FVector(FMath::Cos(Yaw), FMath::Sin(Yaw), 0.f), FVector(0.f, 0.f, 1.f)) * FPerspectiveMatrix(PI / 4.f, 16.f, 9.f, 10.f, 100000.f);
+}
+
+IMPLEMENT_TEST(SoftwareOcclusion_ConservativeDepth)
+{
+	std::mt19937 Random(1234);
+	std::uniform_real_distribution<float> Unit(0.f, 1.f);
+	const FMatrix ViewProjectionMatrix = MakeTestViewProjection(FVector::ZeroVector, 0.f);
+
+	for (int32 Scene = 0; Scene < 8; ++Scene)
+	{
+		// triangles in front of the eye, some of them reaching past the edges of the screen
+		std::vector<FVector> Vertices;
+		std::vector<uint32> Indices;
+		for (int32 Vertex = 0; Vertex < 3 * 24; ++Vertex)
+		{
+			const float Distance = 300.f + 3000.f * Unit(Random);
+			Vertices.push_back(FVector(Distance, (Unit(Random) * 3.f - 1.5f) * Distance, (Unit(Random) * 1.4f - 0.7f) * Distance));
+			Indices.push_back(Vertex);
+		}
+
+		FOccluderElementsCollector Collector(ViewProjectionMatrix);
+		Collector.AddElements(Vertices, Indices, FMatrix::Identity);
+		FSoftwareOcclusionBuffer OcclusionBuffer;
+		OcclusionBuffer.Rasterize(Collector);
+
+		std::vector<FVector> Pixels;
+		for (const FVector& Vertex : Vertices)
+		{
+			Pixels.push_back(FSoftwareOcclusionBuffer::ClipToPixel(ViewProjectionMatrix.TransformPosition(Vertex)));
+		}
+
+		// the nearest depth of the triangles covering a point in pixels, 0 where none does
+		auto GetNearestDepth = [&](double X, double Y)
+		{
+			double NearestDepth = 0.0;
+			for (size_t Index = 0; Index < Pixels.size(); Index += 3)
+			{
+				const FVector& P0 = Pixels[Index];
+				const FVector& P1 = Pixels[Index + 1];
+				const FVector& P2 = Pixels[Index + 2];
+				const double Area = ((double)P1.X - P0.X) * ((double)P2.Y - P0.Y) - ((double)P2.X - P0.X) * ((double)P1.Y - P0.Y);
+				if (FMath::Abs(Area) < 1e-6)
+				{
+					continue;
+				}
+				const double B1 = (((double)P2.X - P0.X) * (Y - P0.Y) - ((double)P2.Y - P0.Y) * (X - P0.X)) / -Area;
+				const double B2 = (((double)P1.X - P0.X) * (Y - P0.Y) - ((double)P1.Y - P0.Y) * (X - P0.X)) / Area;
+				const double B0 = 1.0 - B1 - B2;
+				const double Tolerance = 1e-4;
+				if (B0 >= -Tolerance && B1 >= -Tolerance && B2 >= -Tolerance)
+				{
+					NearestDepth = FMath::Max(NearestDepth, B0 * P0.Z + B1 * P1.Z + B2 * P2.Z);
+				}
+			}
+			return NearestDepth;
+		};
+
+		// every point of a pixel with depth has to be covered at least that near
+		int32 NumWritten = 0;
+		int32 NumWrong = 0;
+		for (int32 Y = 0; Y < FSoftwareOcclusionBuffer::Height; ++Y)
+		{
+			for (int32 X = 0; X < FSoftwareOcclusionBuffer::Width; ++X)
+			{
+				const float Depth = OcclusionBuffer.GetDepth(X, Y);
+				if (Depth <= 0.f)
+				{
+					continue;
+				}
+				++NumWritten;
+				for (int32 Sample = 0; Sample < 25; ++Sample)
+				{
+					const double NearestDepth = GetNearestDepth(X + (Sample % 5) * 0.25, Y + (Sample / 5) * 0.25);
+					NumWrong += Depth <= NearestDepth * (1.0 + 1e-4) ? 0 : 1;
+				}
+			}
+		}
+		TEST_CHECK(NumWritten > 1000);
+		TEST_CHECK(NumWrong == 0);
+	}
+}
+
+IMPLEMENT_TEST(SoftwareOcclusion_NothingVisibleIsCulled)
+{
+	std::mt19937 Random(1234);
+	std::uniform_real_distribution<float> Unit(0.f, 1.f);
+	const int32 NumBlocks = 8;
+	const float BlockSize = 4000.f;
+
+	// the city of BenchmarkSoftwareOcclusion, one building per block and props scattered over the streets and blocks
+	std::vector<FBox> Buildings;
+	for (int32 BlockY = 0; BlockY < NumBlocks; ++BlockY)
+	{
+		for (int32 BlockX = 0; BlockX < NumBlocks; ++BlockX)
+		{
+			const FVector Extent = FVector(0.2f + 0.15f * Unit(Random), 0.2f + 0.15f * Unit(Random), 0.25f + 0.75f * Unit(Random)) * BlockSize;
+			const FVector Center((BlockX + 0.5f) * BlockSize, (BlockY + 0.5f) * BlockSize, Extent.Z);
+			Buildings.push_back(FBox(Center - Extent, Center + Extent));
+		}
+	}
+	std::vector<FBox> Props;
+	for (int32 Prop = 0; Prop < 4000; ++Prop)
+	{
+		const FVector Extent(20.f + 130.f * Unit(Random), 20.f + 130.f * Unit(Random), 20.f + 130.f * Unit(Random));
+		const FVector Center(Unit(Random) * NumBlocks * BlockSize, Unit(Random) * NumBlocks * BlockSize, Extent.Z);
+		Props.push_back(FBox(Center - Extent, Center + Extent));
+	}
+
+	std::vector<FVector> CubeVertices;
+	for (int32 Corner = 0; Corner < 8; ++Corner)
+	{
+		CubeVertices.push_back(FVector((Corner & 1) ? 1.f : -1.f, (Corner & 2) ? 1.f : -1.f, (Corner & 4) ? 1.f : -1.f));
+	}
+	const std::vector<uint32> CubeIndices = { 0, 2, 6, 0, 6, 4, 1, 5, 7, 1, 7, 3, 0, 4, 5, 0, 5, 1, 2, 3, 7, 2, 7, 6, 0, 1, 3, 0, 3, 2, 4, 6, 7, 4, 7, 5 };
+
+	int32 NumCulled = 0;
+	int32 NumSeen = 0;
+	for (int32 View = 0; View < 16; ++View)
+	{
+		// eye height at a street crossing
+		const FVector ViewOrigin((1 + Random() % (NumBlocks - 1)) * BlockSize, (1 + Random() % (NumBlocks - 1)) * BlockSize, 170.f);
+		const FMatrix ViewProjectionMatrix = MakeTestViewProjection(ViewOrigin, Unit(Random) * 2.f * PI);
+		FConvexVolume Frustum;
+		GetViewFrustumBounds(Frustum, ViewProjectionMatrix, true);
+
+		FOccluderElementsCollector Collector(ViewProjectionMatrix);
+		for (const FBox& Building : Buildings)
+		{
+			Collector.AddElements(CubeVertices, CubeIndices, FScaleMatrix(Building.GetExtent()) * FTranslationMatrix(Building.GetCenter()));
+		}
+
+		// the workers and the calling thread have to rasterize the same buffer
+		FSoftwareOcclusionBuffer OcclusionBuffers[2];
+		OcclusionBuffers[0].Rasterize(Collector);
+		OcclusionBuffers[1].Rasterize(Collector, true);
+		int32 NumDifferent = 0;
+		for (int32 Y = 0; Y < FSoftwareOcclusionBuffer::Height; ++Y)
+		{
+			for (int32 X = 0; X < FSoftwareOcclusionBuffer::Width; ++X)
+			{
+				NumDifferent += OcclusionBuffers[0].GetDepth(X, Y) == OcclusionBuffers[1].GetDepth(X, Y) ? 0 : 1;
+			}
+		}
+		TEST_CHECK(NumDifferent == 0);
+
+		// no point of an occluded prop, on a 3x3x3 grid over its box, may have a clear line from the eye
+		for (const FBox& Prop : Props)
+		{
+			if (!Frustum.IntersectBox(Prop.GetCenter(), Prop.GetExtent()) || !OcclusionBuffers[0].IsBoxOccluded(Prop.GetCenter(), Prop.GetExtent()))
+			{
+				continue;
+			}
+			++NumCulled;
+			for (int32 Point = 0; Point < 27; ++Point)
+			{
+				const FVector Target = Prop.GetCenter() + Prop.GetExtent() * FVector((float)(Point % 3 - 1), (float)(Point / 3 % 3 - 1), (float)(Point / 9 - 1));
+				if (!Frustum.IntersectSphere(Target, 0.f))
+				{
+					continue;
+				}
+				bool bBlocked = false;
+				for (int32 Building = 0; Building < (int32)Buildings.size() && !bBlocked; ++Building)
+				{
+					bBlocked = FMath::LineBoxIntersection(Buildings[Building], ViewOrigin, Target, Target - ViewOrigin);
+				}
+				if (!bBlocked)
+				{
+					++NumSeen;
+					break;
+				}
+			}
+		}
+	}
+	TEST_CHECK(NumCulled > 100);
+	TEST_CHECK(NumSeen == 0);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+
+/**
+* Headless checks of the engine code that runs on the CPU alone, built into the DirectUE4Tests executable
+* without D3D, the FBX SDK or a window. A test is a function registered with IMPLEMENT_TEST, its TEST_CHECKs
+* report failures and let it run on, and the executable exits non zero when any check failed.
+*/
+struct FTestCase
+{
+	const char* Name;
+	void (*Function)();
+};
+
+std::vector<FTestCase>& GetRegisteredTests();
+
+/** Logs a failed check, counted for the exit code of the executable */
+void ReportTestFailure(const char* File, int Line, const char* Expression);
+
+struct FTestRegistration
+{
+	FTestRegistration(const char* Name, void (*Function)())
+	{
+		GetRegisteredTests().push_back({ Name, Function });
+	}
+};
+
+#define IMPLEMENT_TEST(Name) \
+	static void Name(); \
+	static FTestRegistration Name##Registration(#Name, Name); \
+	static void Name()
+
+#define TEST_CHECK(Expression) \
+	do { if (!(Expression)) { ReportTestFailure(__FILE__, __LINE__, #Expression); } } while (0)
+
+/** Checks that A and B are within Tolerance of each other */
+#define TEST_CHECK_NEAR(A, B, Tolerance) \
+	do { if (!(std::fabs((double)(A) - (double)(B)) <= (double)(Tolerance))) { ReportTestFailure(__FILE__, __LINE__, #A " near " #B); } } while (0)
@@ -0,0 +1,50 @@
+#include "TestHarness.h"
+#include <cstdio>
+#include <cstring>
+
+/** log.h sends X_LOG here, the game prints it to the debugger */
+void OutputDebug(const char* Format)
+{
+	fputs(Format, stdout);
+}
+
+static int GNumFailedChecks = 0;
+
+std::vector<FTestCase>& GetRegisteredTests()
+{
+	static std::vector<FTestCase> Tests;
+	return Tests;
+}
+
+void ReportTestFailure(const char* File, int Line, const char* Expression)
+{
+	printf("%s(%d): check failed: %s\n", File, Line, Expression);
+	++GNumFailedChecks;
+}
+
+/** Runs every registered test, or the ones whose name contains the first argument */
+int main(int argc, char** argv)
+{
+	const char* Filter = argc > 1 ? argv[1] : nullptr;
+
+	int NumFailedTests = 0;
+	int NumRunTests = 0;
+	for (const FTestCase& Test : GetRegisteredTests())
+	{
+		if (Filter && !strstr(Test.Name, Filter))
+		{
+			continue;
+		}
+
+		const int NumFailedBefore = GNumFailedChecks;
+		Test.Function();
+		const bool bPassed = GNumFailedChecks == NumFailedBefore;
+		printf("%s %s\n", bPassed ? "[ OK ]" : "[FAIL]", Test.Name);
+
+		NumFailedTests += bPassed ? 0 : 1;
+		++NumRunTests;
+	}
+
+	printf("%d tests, %d failed\n", NumRunTests, NumFailedTests);
+	return NumFailedTests == 0 ? 0 : 1;
+}
@@ -0,0 +1,171 @@
+#include "TestHarness.h"
+#include "UnrealMath.h"
+#include "VectorRegister.h"
+
+/**
+* The VectorRegister backend compiled in (SSE with or without SSE4.1, or the FPU fallback in DirectUE4TestsFPU)
+* against plain scalar math, so every backend is held to the same results.
+*/
+
+static void StoreVector(const VectorRegister& Vec, float* Out)
+{
+	alignas(16) float Aligned[4];
+	VectorRegister Temp = Vec;
+	VectorStoreAligned(Temp, Aligned);
+	for (int32 Index = 0; Index < 4; ++Index)
+	{
+		Out[Index] = Aligned[Index];
+	}
+}
+
+static void StoreVectorInt(const VectorRegisterInt& Vec, int32* Out)
+{
+	VectorIntStore(Vec, Out);
+}
+
+static const float RoundingInputs[] =
+{
+	0.0f, 0.25f, 0.5f, 0.75f, 1.0f, 1.5f, 2.5f, 3.999f, -0.25f, -0.5f, -1.0f, -1.5f, -2.5f, -3.999f,
+	1000000.5f, -1000000.5f, 8388607.5f, -8388607.5f, 8388608.0f, 16777216.0f, -33554432.0f, 3.0e9f, -3.0e9f, 1.0e30f
+};
+
+IMPLEMENT_TEST(VectorRegister_Rounding)
+{
+	const int32 NumInputs = sizeof(RoundingInputs) / sizeof(RoundingInputs[0]);
+	for (int32 Index = 0; Index + 4 <= NumInputs; Index += 4)
+	{
+		const float* In = RoundingInputs + Index;
+		const VectorRegister Vec = MakeVectorRegister(In[0], In[1], In[2], In[3]);
+
+		float Floor[4], Ceil[4], Truncate[4];
+		StoreVector(VectorFloor(Vec), Floor);
+		StoreVector(VectorCeil(Vec), Ceil);
+		StoreVector(VectorTruncate(Vec), Truncate);
+		for (int32 Component = 0; Component < 4; ++Component)
+		{
+			TEST_CHECK(Floor[Component] == std::floor(In[Component]));
+			TEST_CHECK(Ceil[Component] == std::ceil(In[Component]));
+			TEST_CHECK(Truncate[Component] == std::trunc(In[Component]));
+		}
+	}
+}
+
+IMPLEMENT_TEST(VectorRegister_DotProducts)
+{
+	const float A[4] = { 1.5f, -2.0f, 3.25f, 4.0f };
+	const float B[4] = { -0.5f, 6.0f, 2.0f, -3.0f };
+	const VectorRegister VecA = MakeVectorRegister(A[0], A[1], A[2], A[3]);
+	const VectorRegister VecB = MakeVectorRegister(B[0], B[1], B[2], B[3]);
+
+	const float Dot3 = A[0] * B[0] + A[1] * B[1] + A[2] * B[2];
+	const float Dot4 = Dot3 + A[3] * B[3];
+
+	float Result3[4], Result4[4];
+	StoreVector(VectorDot3(VecA, VecB), Result3);
+	StoreVector(VectorDot4(VecA, VecB), Result4);
+	for (int32 Component = 0; Component < 4; ++Component)
+	{
+		TEST_CHECK_NEAR(Result3[Component], Dot3, 1e-5f);
+		TEST_CHECK_NEAR(Result4[Component], Dot4, 1e-5f);
+	}
+}
+
+IMPLEMENT_TEST(VectorRegister_Merges)
+{
+	const VectorRegister XYZ = MakeVectorRegister(1.0f, 2.0f, 3.0f, 4.0f);
+	const VectorRegister W = MakeVectorRegister(5.0f, 6.0f, 7.0f, 8.0f);
+
+	float Merged[4], SetW1[4];
+	StoreVector(VectorMergeVecXYZ_VecW(XYZ, W), Merged);
+	StoreVector(VectorSet_W1(XYZ), SetW1);
+
+	TEST_CHECK(Merged[0] == 1.0f && Merged[1] == 2.0f && Merged[2] == 3.0f && Merged[3] == 8.0f);
+	TEST_CHECK(SetW1[0] == 1.0f && SetW1[1] == 2.0f && SetW1[2] == 3.0f && SetW1[3] == 1.0f);
+}
+
+IMPLEMENT_TEST(VectorRegister_ByteLoads)
+{
+	for (int32 Value = 0; Value < 256; Value += 4)
+	{
+		const uint8 Bytes[4] = { (uint8)Value, (uint8)(Value + 1), (uint8)(Value + 2), (uint8)(Value + 3) };
+
+		float Unsigned[4], Signed[4];
+		StoreVector(VectorLoadByte4(Bytes), Unsigned);
+		StoreVector(VectorLoadSignedByte4(Bytes), Signed);
+		for (int32 Component = 0; Component < 4; ++Component)
+		{
+			TEST_CHECK(Unsigned[Component] == (float)Bytes[Component]);
+			TEST_CHECK(Signed[Component] == (float)(int8)Bytes[Component]);
+		}
+	}
+}
+
+IMPLEMENT_TEST(VectorRegister_RGBA16)
+{
+	uint16 Unsigned[4] = { 0, 1, 32768, 65535 };
+	int16 Signed[4] = { -32767, -1, 1, 32767 };
+
+	float LoadedUnsigned[4], LoadedSigned[4];
+	StoreVector(VectorLoadURGBA16N(Unsigned), LoadedUnsigned);
+	StoreVector(VectorLoadSRGBA16N(Signed), LoadedSigned);
+	for (int32 Component = 0; Component < 4; ++Component)
+	{
+		TEST_CHECK_NEAR(LoadedUnsigned[Component], Unsigned[Component] / 65535.0f, 1e-6f);
+		TEST_CHECK_NEAR(LoadedSigned[Component], Signed[Component] / 32767.0f, 1e-6f);
+	}
+
+	// out of range components clamp to [0, 1]
+	uint16 Stored[4];
+	VectorStoreURGBA16N(MakeVectorRegister(-1.0f, 0.25f, 0.75f, 2.0f), Stored);
+	TEST_CHECK(Stored[0] == 0);
+	TEST_CHECK(Stored[1] == 16384);
+	TEST_CHECK(Stored[2] == 49151);
+	TEST_CHECK(Stored[3] == 65535);
+}
+
+IMPLEMENT_TEST(VectorRegister_IntegerOps)
+{
+	const int32 A[4] = { 3, -7, 65537, -2147483647 };
+	const int32 B[4] = { -5, -9, 65539, 2 };
+	const VectorRegisterInt VecA = MakeVectorRegisterInt(A[0], A[1], A[2], A[3]);
+	const VectorRegisterInt VecB = MakeVectorRegisterInt(B[0], B[1], B[2], B[3]);
+
+	int32 Product[4], Min[4], Max[4], Abs[4];
+	StoreVectorInt(VectorIntMultiply(VecA, VecB), Product);
+	StoreVectorInt(VectorIntMin(VecA, VecB), Min);
+	StoreVectorInt(VectorIntMax(VecA, VecB), Max);
+	StoreVectorInt(VectorIntAbs(VecA), Abs);
+	for (int32 Component = 0; Component < 4; ++Component)
+	{
+		// the low 32 bits of the product, as the hardware multiply wraps
+		TEST_CHECK(Product[Component] == (int32)((uint32)A[Component] * (uint32)B[Component]));
+		TEST_CHECK(Min[Component] == FMath::Min(A[Component], B[Component]));
+		TEST_CHECK(Max[Component] == FMath::Max(A[Component], B[Component]));
+		TEST_CHECK(Abs[Component] == FMath::Abs(A[Component]));
+	}
+}
+
+IMPLEMENT_TEST(VectorRegister_MatrixInverse)
+{
+	const FMatrix Matrix(
+		FPlane(2.0f, 0.5f, 0.0f, 0.0f),
+		FPlane(-1.0f, 3.0f, 0.25f, 0.0f),
+		FPlane(0.0f, 1.0f, 4.0f, 0.0f),
+		FPlane(10.0f, -20.0f, 30.0f, 1.0f));
+
+	FMatrix Inverse;
+	VectorMatrixInverse(&Inverse, &Matrix);
+
+	for (int32 Row = 0; Row < 4; ++Row)
+	{
+		for (int32 Column = 0; Column < 4; ++Column)
+		{
+			float Sum = 0.0f;
+			for (int32 Index = 0; Index < 4; ++Index)
+			{
+				Sum += Matrix.M[Row][Index] * Inverse.M[Index][Column];
+			}
+			TEST_CHECK_NEAR(Sum, Row == Column ? 1.0f : 0.0f, 1e-4f);
+		}
+	}
+}
@@ -0,0 +1,93 @@
+#include "TestHarness.h"
+#include "UnrealMath.h"
+#include "PackedNormal.h"
+#include "PackedIndexBuffer.h"
+
+#include <random>
+
+/**
+* The compact formats built meshes store with GCompactMeshVertexFormats against the round trip errors they document:
+* half an SNORM step per tangent component with exact basis signs, FVector2DHalf::GetMaxError per texture coordinate
+* and 16-bit indices that read back unchanged.
+*/
+
+IMPLEMENT_TEST(VertexFormat_PackedTangents)
+{
+	std::mt19937 Random(1234);
+	std::uniform_real_distribution<float> Unit(-1.f, 1.f);
+	for (int32 Index = 0; Index < 10000; ++Index)
+	{
+		FVector Axis;
+		do
+		{
+			Axis = FVector(Unit(Random), Unit(Random), Unit(Random));
+		} while (Axis.SizeSquared() < 0.01f || Axis.SizeSquared() > 1.f);
+		Axis = Axis.GetUnsafeNormal();
+
+		// TangentZ carries the basis sign in W, TangentX a 0
+		const Vector4 Source(Axis, (Index & 1) ? -1.f : ((Index & 2) ? 1.f : 0.f));
+		const Vector4 Decoded = FPackedTangent(Source).ToVector4();
+		TEST_CHECK_NEAR(Decoded.X, Source.X, FPackedTangent::MaxComponentError + 1e-6f);
+		TEST_CHECK_NEAR(Decoded.Y, Source.Y, FPackedTangent::MaxComponentError + 1e-6f);
+		TEST_CHECK_NEAR(Decoded.Z, Source.Z, FPackedTangent::MaxComponentError + 1e-6f);
+		TEST_CHECK(Decoded.W == Source.W);
+	}
+
+	// the ends of the range are exact, anything past them clamps
+	const Vector4 Extremes = FPackedTangent(Vector4(1.f, -1.f, 0.f, 2.f)).ToVector4();
+	TEST_CHECK(Extremes.X == 1.f && Extremes.Y == -1.f && Extremes.Z == 0.f && Extremes.W == 1.f);
+}
+
+IMPLEMENT_TEST(VertexFormat_HalfTexCoords)
+{
+	std::mt19937 Random(1234);
+	std::uniform_real_distribution<float> Tiling(-16.f, 16.f);
+	std::uniform_real_distribution<float> Unit(0.f, 1.f);
+	std::vector<Vector2> Sources;
+	for (int32 Index = 0; Index < 10000; ++Index)
+	{
+		// tiled material UVs, lightmap UVs in [0, 1] and ones small enough to end up as half denormals
+		Sources.push_back(Vector2(Tiling(Random), Tiling(Random)));
+		Sources.push_back(Vector2(Unit(Random), Unit(Random)));
+		Sources.push_back(Vector2(Unit(Random) * 1e-4f, -Unit(Random) * 1e-6f));
+	}
+	Sources.push_back(Vector2(65504.f, -65504.f));
+	Sources.push_back(Vector2(0.f, 1.f));
+
+	for (const Vector2& Source : Sources)
+	{
+		const Vector2 Decoded = FVector2DHalf(Source).ToVector2();
+		TEST_CHECK_NEAR(Decoded.X, Source.X, FVector2DHalf::GetMaxError(Source.X));
+		TEST_CHECK_NEAR(Decoded.Y, Source.Y, FVector2DHalf::GetMaxError(Source.Y));
+	}
+}
+
+IMPLEMENT_TEST(VertexFormat_16BitIndices)
+{
+	// 16-bit indices only while every vertex is addressable with them, and only when asked for
+	TEST_CHECK(ChooseIndexDataTypeSize(3, true) == sizeof(uint16));
+	TEST_CHECK(ChooseIndexDataTypeSize(65536, true) == sizeof(uint16));
+	TEST_CHECK(ChooseIndexDataTypeSize(65537, true) == sizeof(uint32));
+	TEST_CHECK(ChooseIndexDataTypeSize(3, false) == sizeof(uint32));
+
+	std::vector<uint32> Indices;
+	for (uint32 Index = 0; Index < 3 * 10000; ++Index)
+	{
+		Indices.push_back((Index * 7919u) % 65536u);
+	}
+	Indices.push_back(MAX_uint16);
+
+	for (uint8 DataTypeSize : { (uint8)sizeof(uint16), (uint8)sizeof(uint32) })
+	{
+		std::vector<uint8> Buffer;
+		PackIndices(DataTypeSize, Indices, Buffer);
+		TEST_CHECK(Buffer.size() == Indices.size() * DataTypeSize);
+
+		int32 NumWrong = 0;
+		for (size_t Index = 0; Index < Indices.size(); ++Index)
+		{
+			NumWrong += GetPackedIndex(DataTypeSize, Buffer, Index) == Indices[Index] ? 0 : 1;
+		}
+		TEST_CHECK(NumWrong == 0);
+	}
+}
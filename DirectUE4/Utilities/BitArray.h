@@ -0,0 +1,134 @@
+#pragma once
+
+#include "UnrealMath.h"
+
+#include <vector>
+
+/**
+* A packed array of bits, in the spirit of UE4's TBitArray.
+* Bit Index is bit Index % NumBitsPerWord of word Index / NumBitsPerWord, so whole words can be written at once, e.g. by
+* workers owning separate word ranges. Bits past Num() in the last word are always 0.
+*/
+class FBitArray
+{
+public:
+	enum { NumBitsPerWord = 32 };
+
+	FBitArray()
+		: NumBits(0)
+	{}
+
+	FBitArray(bool bValue, int32 InNumBits)
+	{
+		Init(bValue, InNumBits);
+	}
+
+	/** Resizes the array to InNumBits bits, all set to bValue */
+	void Init(bool bValue, int32 InNumBits)
+	{
+		NumBits = InNumBits;
+		Words.assign(GetNumWords(InNumBits), bValue ? ~0u : 0u);
+		ClearSlack();
+	}
+
+	int32 Num() const { return NumBits; }
+
+	bool operator[](int32 Index) const
+	{
+		return (Words[Index / NumBitsPerWord] & (1u << (Index % NumBitsPerWord))) != 0;
+	}
+
+	void SetBit(int32 Index, bool bValue)
+	{
+		const uint32 Mask = 1u << (Index % NumBitsPerWord);
+		if (bValue)
+		{
+			Words[Index / NumBitsPerWord] |= Mask;
+		}
+		else
+		{
+			Words[Index / NumBitsPerWord] &= ~Mask;
+		}
+	}
+
+	int32 NumWords() const { return (int32)Words.size(); }
+	uint32* GetData() { return Words.data(); }
+	const uint32* GetData() const { return Words.data(); }
+
+	int32 CountSetBits() const
+	{
+		int32 Count = 0;
+		for (uint32 Word : Words)
+		{
+			// SWAR population count
+			Word = Word - ((Word >> 1) & 0x55555555u);
+			Word = (Word & 0x33333333u) + ((Word >> 2) & 0x33333333u);
+			Count += (int32)((((Word + (Word >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24);
+		}
+		return Count;
+	}
+
+	bool operator==(const FBitArray& Other) const
+	{
+		return NumBits == Other.NumBits && Words == Other.Words;
+	}
+
+	static int32 GetNumWords(int32 InNumBits)
+	{
+		return (InNumBits + NumBitsPerWord - 1) / NumBitsPerWord;
+	}
+
+private:
+	void ClearSlack()
+	{
+		if (NumBits % NumBitsPerWord)
+		{
+			Words.back() &= (1u << (NumBits % NumBitsPerWord)) - 1;
+		}
+	}
+
+	std::vector<uint32> Words;
+	int32 NumBits;
+};
+
+/** Iterates the indices of the set bits of an FBitArray in increasing order, a word at a time. */
+class FConstSetBitIterator
+{
+public:
+	explicit FConstSetBitIterator(const FBitArray& InArray)
+		: Array(InArray)
+		, WordIndex(-1)
+		, RemainingBits(0)
+		, Index(0)
+	{
+		++(*this);
+	}
+
+	FConstSetBitIterator& operator++()
+	{
+		while (RemainingBits == 0)
+		{
+			if (++WordIndex >= Array.NumWords())
+			{
+				Index = Array.Num();
+				return *this;
+			}
+			RemainingBits = Array.GetData()[WordIndex];
+		}
+		Index = WordIndex * FBitArray::NumBitsPerWord + (int32)FMath::CountTrailingZeros(RemainingBits);
+		// clear the lowest set bit
+		RemainingBits &= RemainingBits - 1;
+		return *this;
+	}
+
+	explicit operator bool() const { return Index < Array.Num(); }
+
+	int32 GetIndex() const { return Index; }
+
+private:
+	const FBitArray& Array;
+	int32 WordIndex;
+	/** Bits of the current word not visited yet */
+	uint32 RemainingBits;
+	int32 Index;
+};
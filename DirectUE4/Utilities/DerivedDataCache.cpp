@@ -0,0 +1,123 @@
+#include "DerivedDataCache.h"
+#include "log.h"
+
+#include <filesystem>
+#include <fstream>
+
+bool GUseDerivedDataCache = true;
+
+FDerivedDataCache& GetDerivedDataCacheRef()
+{
+	static FDerivedDataCache Cache("./DerivedDataCache");
+	return Cache;
+}
+
+FDerivedDataCache::FDerivedDataCache(const std::string& InCacheDirectory)
+	: CacheDirectory(InCacheDirectory)
+	, NumHits(0)
+	, NumMisses(0)
+	, NumPuts(0)
+	, BytesRead(0)
+	, BytesWritten(0)
+{
+}
+
+std::string FDerivedDataCache::BuildCacheKey(const char* Prefix, const char* Version, const std::string& SourceKey)
+{
+	return std::string(Prefix) + "_" + Version + "_" + SourceKey;
+}
+
+std::string FDerivedDataCache::GetFilename(const std::string& CacheKey) const
+{
+	return CacheDirectory + "/" + CacheKey + ".udd";
+}
+
+bool FDerivedDataCache::GetSynchronous(const std::string& CacheKey, std::vector<uint8>& OutData)
+{
+	if (!GUseDerivedDataCache)
+	{
+		return false;
+	}
+
+	std::ifstream File(GetFilename(CacheKey), std::ios::in | std::ios::binary | std::ios::ate);
+	if (!File.is_open())
+	{
+		++NumMisses;
+		return false;
+	}
+
+	const std::streamoff FileSize = File.tellg();
+	OutData.resize((size_t)FileSize);
+	File.seekg(0, std::ios::beg);
+	File.read((char*)OutData.data(), FileSize);
+	if (!File.good())
+	{
+		OutData.clear();
+		++NumMisses;
+		return false;
+	}
+
+	++NumHits;
+	BytesRead += OutData.size();
+	return true;
+}
+
+void FDerivedDataCache::Put(const std::string& CacheKey, const std::vector<uint8>& Data)
+{
+	if (!GUseDerivedDataCache)
+	{
+		return;
+	}
+
+	std::error_code ErrorCode;
+	std::filesystem::create_directories(CacheDirectory, ErrorCode);
+
+	// write to a temporary and rename, a crash halfway must not leave a truncated entry behind
+	const std::string Filename = GetFilename(CacheKey);
+	const std::string TempFilename = Filename + ".tmp";
+	{
+		std::ofstream File(TempFilename, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!File.is_open())
+		{
+			X_LOG("DerivedDataCache: failed to write %s\n", TempFilename.c_str());
+			return;
+		}
+		File.write((const char*)Data.data(), Data.size());
+		if (!File.good())
+		{
+			X_LOG("DerivedDataCache: failed to write %s\n", TempFilename.c_str());
+			return;
+		}
+	}
+	std::filesystem::rename(TempFilename, Filename, ErrorCode);
+	if (ErrorCode)
+	{
+		X_LOG("DerivedDataCache: failed to store %s\n", Filename.c_str());
+		std::filesystem::remove(TempFilename, ErrorCode);
+		return;
+	}
+
+	++NumPuts;
+	BytesWritten += Data.size();
+}
+
+void FDerivedDataCache::Remove(const std::string& CacheKey)
+{
+	std::error_code ErrorCode;
+	std::filesystem::remove(GetFilename(CacheKey), ErrorCode);
+}
+
+void FDerivedDataCache::ResetStats()
+{
+	NumHits = 0;
+	NumMisses = 0;
+	NumPuts = 0;
+	BytesRead = 0;
+	BytesWritten = 0;
+}
+
+void FDerivedDataCache::LogStats() const
+{
+	X_LOG("DerivedDataCache: %u hits (%llu KB read), %u misses, %u puts (%llu KB written)\n",
+		(uint32)NumHits, (unsigned long long)(BytesRead / 1024), (uint32)NumMisses, (uint32)NumPuts, (unsigned long long)(BytesWritten / 1024));
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "UnrealMath.h"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+/**
+* Persistent cache for data derived from source assets, in the spirit of UE4's FDerivedDataCacheInterface.
+* Every entry is one file named after its key under the cache directory, so a lookup is a single read. Keys are built by
+* the asset types and have to change whenever the source or the way it is built changes; nothing is ever invalidated.
+*/
+class FDerivedDataCache
+{
+public:
+	explicit FDerivedDataCache(const std::string& InCacheDirectory);
+
+	/** Reads the entry for CacheKey into OutData, returns false if there is none */
+	bool GetSynchronous(const std::string& CacheKey, std::vector<uint8>& OutData);
+
+	/** Stores Data under CacheKey, replacing any existing entry */
+	void Put(const std::string& CacheKey, const std::vector<uint8>& Data);
+
+	/** Deletes the entry for CacheKey if there is one */
+	void Remove(const std::string& CacheKey);
+
+	/** Builds a key from the type of data, a version that changes with the build code and the hash of the source */
+	static std::string BuildCacheKey(const char* Prefix, const char* Version, const std::string& SourceKey);
+
+	uint32 GetNumHits() const { return NumHits; }
+	uint32 GetNumMisses() const { return NumMisses; }
+
+	void ResetStats();
+	void LogStats() const;
+
+private:
+	std::string GetFilename(const std::string& CacheKey) const;
+
+	std::string CacheDirectory;
+
+	std::atomic<uint32> NumHits;
+	std::atomic<uint32> NumMisses;
+	std::atomic<uint32> NumPuts;
+	std::atomic<uint64> BytesRead;
+	std::atomic<uint64> BytesWritten;
+};
+
+/** Master switch for using the derived data cache at all (-noddc) */
+extern bool GUseDerivedDataCache;
+
+FDerivedDataCache& GetDerivedDataCacheRef();
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+/**
+* One ParallelFor call shared by the calling thread and the pool workers helping it.
+* Indices are claimed in batches through NextIndex; the call is over once NumCompleted reaches Num.
+*/
+struct FParallelForJob
+{
+	const std::function<void(int)>* Body;
+	int Num;
+	int BatchSize;
+	std::atomic<int> NextIndex;
+	std::atomic<int> NumCompleted;
+
+	std::mutex CompletedMutex;
+	std::condition_variable CompletedEvent;
+
+	FParallelForJob(const std::function<void(int)>& InBody, int InNum, int InBatchSize)
+		: Body(&InBody), Num(InNum), BatchSize(InBatchSize), NextIndex(0), NumCompleted(0)
+	{
+	}
+
+	/** Runs batches until none is left. Body is only touched for claimed indices, so late helpers never see it dangle. */
+	void Work()
+	{
+		for (;;)
+		{
+			const int Start = NextIndex.fetch_add(BatchSize);
+			if (Start >= Num)
+			{
+				break;
+			}
+			const int End = std::min(Start + BatchSize, Num);
+			for (int Index = Start; Index < End; ++Index)
+			{
+				(*Body)(Index);
+			}
+			if (NumCompleted.fetch_add(End - Start) + (End - Start) == Num)
+			{
+				std::lock_guard<std::mutex> Lock(CompletedMutex);
+				CompletedEvent.notify_all();
+			}
+		}
+	}
+
+	/** Join barrier of the calling thread: returns once every index has run, whoever ran it */
+	void WaitForCompletion()
+	{
+		std::unique_lock<std::mutex> Lock(CompletedMutex);
+		CompletedEvent.wait(Lock, [this]() { return NumCompleted.load() == Num; });
+	}
+};
+
+/**
+* Worker threads created once, on the first ParallelFor, and kept until exit.
+* Each ParallelFor queues one help request per worker it wants; a worker that picks up a request
+* after the batches ran out returns straight away.
+*/
+class FParallelForThreadPool
+{
+public:
+	static FParallelForThreadPool& Get()
+	{
+		static FParallelForThreadPool Pool;
+		return Pool;
+	}
+
+	int GetNumWorkers() const
+	{
+		return (int)Workers.size();
+	}
+
+	void QueueHelpers(const std::shared_ptr<FParallelForJob>& Job, int NumHelpers)
+	{
+		{
+			std::lock_guard<std::mutex> Lock(QueueMutex);
+			for (int HelperIndex = 0; HelperIndex < NumHelpers; ++HelperIndex)
+			{
+				Queue.push_back(Job);
+			}
+		}
+		if (NumHelpers == 1)
+		{
+			QueueEvent.notify_one();
+		}
+		else
+		{
+			QueueEvent.notify_all();
+		}
+	}
+
+	~FParallelForThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> Lock(QueueMutex);
+			bStopping = true;
+		}
+		QueueEvent.notify_all();
+		for (std::thread& Worker : Workers)
+		{
+			Worker.join();
+		}
+	}
+
+private:
+	FParallelForThreadPool()
+		: bStopping(false)
+	{
+		// the thread calling ParallelFor works too, so one worker less than the hardware threads
+		const int NumHardwareThreads = (int)std::max(1u, std::thread::hardware_concurrency());
+		for (int WorkerIndex = 1; WorkerIndex < NumHardwareThreads; ++WorkerIndex)
+		{
+			Workers.emplace_back([this]() { WorkerLoop(); });
+		}
+	}
+
+	void WorkerLoop()
+	{
+		for (;;)
+		{
+			std::shared_ptr<FParallelForJob> Job;
+			{
+				std::unique_lock<std::mutex> Lock(QueueMutex);
+				QueueEvent.wait(Lock, [this]() { return bStopping || !Queue.empty(); });
+				if (Queue.empty())
+				{
+					return;
+				}
+				Job = std::move(Queue.front());
+				Queue.pop_front();
+			}
+			Job->Work();
+		}
+	}
+
+	std::vector<std::thread> Workers;
+	std::deque<std::shared_ptr<FParallelForJob>> Queue;
+	std::mutex QueueMutex;
+	std::condition_variable QueueEvent;
+	bool bStopping;
+};
+
+/**
+* General purpose parallel for, in the spirit of UE4's ParallelFor.
+* Body is called once for every index in [0, Num); indices are handed out to the workers of a persistent pool
+* in batches so tiny bodies don't pay an atomic per call. The calling thread takes part in the work and returns
+* once every index has run, so nested calls from inside a Body make progress even when all workers are busy.
+* @param Num - number of calls of Body; Body(0), Body(1), ..., Body(Num - 1)
+* @param Body - function to call from multiple threads, must be safe to call concurrently for different indices
+* @param bForceSingleThread - run everything on the calling thread (useful for debugging)
+*/
+inline void ParallelFor(int Num, const std::function<void(int)>& Body, bool bForceSingleThread = false)
+{
+	if (Num <= 0)
+	{
+		return;
+	}
+
+	FParallelForThreadPool* Pool = bForceSingleThread || Num == 1 ? nullptr : &FParallelForThreadPool::Get();
+	const int NumHelpers = Pool ? std::min(Pool->GetNumWorkers(), Num - 1) : 0;
+	if (NumHelpers <= 0)
+	{
+		for (int Index = 0; Index < Num; ++Index)
+		{
+			Body(Index);
+		}
+		return;
+	}
+
+	// a few batches per thread so an uneven workload still balances
+	const int BatchSize = std::max(1, Num / ((NumHelpers + 1) * 4));
+	std::shared_ptr<FParallelForJob> Job = std::make_shared<FParallelForJob>(Body, Num, BatchSize);
+
+	Pool->QueueHelpers(Job, NumHelpers);
+	Job->Work();
+	Job->WaitForCompletion();
+}
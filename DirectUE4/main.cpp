@@ -2,7 +2,19 @@
 #include "D3D11RHI.h"
 #include "Viewport.h"
 #include "World.h"
+#include "Benchmarks.h"
 #include "DeferredShading.h"
+#include "DerivedDataCache.h"
+#include "MeshDescriptionOperations.h"
+#include "StaticMeshResources.h"
+#include "FrustumCull.h"
+#include "SceneSoftwareOcclusion.h"
+#include "LightGridInjection.h"
+#include "AnimationUtils.h"
+#include "AnimCompress.h"
+#include "AnimPoseCache.h"
+#include "AnimUpdateRateParameters.h"
+#include "SkeletalRender.h"
 #include "log.h"
 
 void OutputDebug(const char* Format)
@@ -19,6 +31,133 @@ HWND g_hWind = NULL;
 
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow)
 {
+	// -noddc always imports and builds static meshes from source instead of loading them from ./DerivedDataCache
+	if (strstr(lpCmdLine, "-noddc"))
+	{
+		GUseDerivedDataCache = false;
+	}
+	// -serialmeshbuild builds normals, tangents, triangulations and skeletal mesh chunks of imported meshes on the calling thread only
+	if (strstr(lpCmdLine, "-serialmeshbuild"))
+	{
+		GParallelMeshBuild = false;
+	}
+	// -compactvertices builds meshes with 8-bit tangents, half texture coordinates and 16-bit indices where every vertex fits
+	if (strstr(lpCmdLine, "-compactvertices"))
+	{
+		GCompactMeshVertexFormats = true;
+	}
+	// -linearuvpacking searches lightmap UV packing scales one raster packing at a time, as before the skyline estimate
+	if (strstr(lpCmdLine, "-linearuvpacking"))
+	{
+		GFastLightmapUVPacking = false;
+	}
+	// -bruteforcelightinteractions tests every light against every primitive for interactions and rebuilds them all when either moves
+	if (strstr(lpCmdLine, "-bruteforcelightinteractions"))
+	{
+		GSpatialLightInteractions = false;
+	}
+	// -softwareocclusion also culls the primitives of every view hidden behind the largest static meshes it sees
+	if (strstr(lpCmdLine, "-softwareocclusion"))
+	{
+		GSoftwareOcclusionCulling = true;
+	}
+	// -computelightgrid culls the unshadowed point and spot lights of every view into a clustered light grid and skips the ones off screen
+	if (strstr(lpCmdLine, "-computelightgrid"))
+	{
+		GComputeLightGrid = true;
+	}
+	// -scalarfrustumcull culls views one primitive at a time on the render thread, as before the vectorized loop
+	if (strstr(lpCmdLine, "-scalarfrustumcull"))
+	{
+		GVectorizedFrustumCull = false;
+	}
+	// -nolinearkeyremoval compresses imported animations with the default bitwise compressor only
+	if (strstr(lpCmdLine, "-nolinearkeyremoval"))
+	{
+		GLinearKeyRemovalMaxError = 0.0f;
+	}
+	// -animcompressionreport logs the compression of every imported animation and writes it to AnimCompressionReport.csv
+	if (strstr(lpCmdLine, "-animcompressionreport"))
+	{
+		GAnimCompressionReport = true;
+	}
+	// -animupdaterate ticks and evaluates the animation of skeletal meshes small on screen less often, interpolating the frames in between
+	if (strstr(lpCmdLine, "-animupdaterate"))
+	{
+		GEnableAnimUpdateRateOptimizations = true;
+	}
+	// -noposecache decodes the pose of every single node animation instance, even when another one plays the same sequence at the same time
+	if (strstr(lpCmdLine, "-noposecache"))
+	{
+		GEnableAnimPoseCache = false;
+	}
+	// -posecachequantum=S lets animation instances less than S seconds apart share one cached pose, S = 0 shares exact times only
+	if (const char* PoseCacheQuantum = strstr(lpCmdLine, "-posecachequantum="))
+	{
+		GAnimPoseCacheTimeQuantum = (float)atof(PoseCacheQuantum + strlen("-posecachequantum="));
+	}
+	// -nomeshlods builds static meshes with LOD 0 only
+	if (strstr(lpCmdLine, "-nomeshlods"))
+	{
+		GStaticMeshLODPercentTriangles.resize(1);
+	}
+
+	// the benchmarks below only need the CPU, they run before any window, device or world exists
+	// -bonebench=N times the component space and reference to local updates of an N bone chain, logs ns per bone and exits
+	if (const char* BoneBench = strstr(lpCmdLine, "-bonebench="))
+	{
+		BenchmarkBoneTransformUpdate(atoi(BoneBench + strlen("-bonebench=")), 1000);
+		return 0;
+	}
+	// -cornerbench=N times the overlapping corner search on a flat N wedge plane and exits
+	if (const char* CornerBench = strstr(lpCmdLine, "-cornerbench="))
+	{
+		BenchmarkOverlappingCorners(atoi(CornerBench + strlen("-cornerbench=")));
+		return 0;
+	}
+	// -vcachebench=N runs the static mesh buffer optimizations on a shuffled N triangle sphere, logs ACMR/ATVR and exits
+	if (const char* VCacheBench = strstr(lpCmdLine, "-vcachebench="))
+	{
+		BenchmarkVertexCache(atoi(VCacheBench + strlen("-vcachebench=")));
+		return 0;
+	}
+	// -lodbench=N reduces an N triangle sphere with a UV seam and two materials to every static mesh LOD, logs the errors and exits
+	if (const char* LODBench = strstr(lpCmdLine, "-lodbench="))
+	{
+		BenchmarkMeshReduction(atoi(LODBench + strlen("-lodbench=")));
+		return 0;
+	}
+	// -uvpackbench=N lays out lightmap UVs for N charts with the linear and the fast scale search, logs both and exits
+	if (const char* UVPackBench = strstr(lpCmdLine, "-uvpackbench="))
+	{
+		BenchmarkLightmapUVPacking(atoi(UVPackBench + strlen("-uvpackbench=")));
+		return 0;
+	}
+	// -octreebench=N churns and queries primitive octrees of 10k up to N primitives, logs the timings and exits
+	if (const char* OctreeBench = strstr(lpCmdLine, "-octreebench="))
+	{
+		BenchmarkPrimitiveOctree(atoi(OctreeBench + strlen("-octreebench=")));
+		return 0;
+	}
+	// -cullbench=N frustum culls N primitives with the scalar, vectorized and parallel loops, logs primitives per ms and exits
+	if (const char* CullBench = strstr(lpCmdLine, "-cullbench="))
+	{
+		BenchmarkFrustumCull(atoi(CullBench + strlen("-cullbench=")));
+		return 0;
+	}
+	// -occlusionbench=N occlusion culls N props in a generated city on the CPU, logs timings and culled counts and exits
+	if (const char* OcclusionBench = strstr(lpCmdLine, "-occlusionbench="))
+	{
+		BenchmarkSoftwareOcclusion(atoi(OcclusionBench + strlen("-occlusionbench=")));
+		return 0;
+	}
+	// -lightgridbench=N builds the clustered light grid for N random lights, logs lights per cell and timings and exits
+	if (const char* LightGridBench = strstr(lpCmdLine, "-lightgridbench="))
+	{
+		BenchmarkLightGrid(atoi(LightGridBench + strlen("-lightgridbench=")));
+		return 0;
+	}
+
 	WNDCLASSEX wc;
 	ZeroMemory(&wc, sizeof(WNDCLASSEX));
 
@@ -60,7 +199,39 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 	}
 
 	InitShading();
+
 	GWorld.InitWorld();
+
+	// -animbench=N spawns N more mannequins, times serial against parallel animation evaluation and exits
+	if (const char* AnimBench = strstr(lpCmdLine, "-animbench="))
+	{
+		BenchmarkAnimationEvaluation(GWorld, atoi(AnimBench + strlen("-animbench=")), 300);
+		return 0;
+	}
+	// -animbake=N bakes the mannequin walk (logging size and error of the bake), plays it on N mannequins and exits
+	if (const char* AnimBake = strstr(lpCmdLine, "-animbake="))
+	{
+		BenchmarkBakedAnimation(GWorld, atoi(AnimBake + strlen("-animbake=")), 300);
+		return 0;
+	}
+	// -posebench=N decodes the walk at N times with the batched and the track by track pose decompression, logs both and exits
+	if (const char* PoseBench = strstr(lpCmdLine, "-posebench="))
+	{
+		BenchmarkPoseDecompression(GWorld, atoi(PoseBench + strlen("-posebench=")));
+		return 0;
+	}
+	// -ddcbench=N times N cold (import and build) against N warm (derived data cache) loads of the static meshes and exits
+	if (const char* DDCBench = strstr(lpCmdLine, "-ddcbench="))
+	{
+		BenchmarkStaticMeshDerivedData(atoi(DDCBench + strlen("-ddcbench=")));
+		return 0;
+	}
+	// -lightbench=N moves lights among N spheres with brute force and with spatial light interactions, logs both and exits
+	if (const char* LightBench = strstr(lpCmdLine, "-lightbench="))
+	{
+		BenchmarkLightInteractions(GWorld, atoi(LightBench + strlen("-lightbench=")), 100);
+		return 0;
+	}
 	GWindowViewport.SetSizeXY(WindowWidth, WindowHeight);
 
 	MSG msg;